@@ -0,0 +1,393 @@
+/*
+P32 ESP-NOW Mesh Network Coordinator
+Implements p32_mesh_coordinator.h on MeshCoordinator (config/components/templates/MeshCoordinator.hpp)
+
+- The ESP-NOW receive callback (WiFi task) validates each frame and copies it once
+  into the ring for its priority; it never blocks and never allocates
+- p32_mesh_process() runs from the component loop: EMERGENCY, COMMAND, STATUS,
+  HEARTBEAT order, callbacks get a pointer into the ring slot (no copy)
+- Sends go unicast to a peer once it has been heard from (MAC-level retries),
+  broadcast otherwise. Send from one task (the component loop)
+- WiFi must be started in STA mode before p32_mesh_init()
+- ESP-NOW keeps one receive callback: when GSM replicates over ESP-NOW the mesh
+  registers with SharedMemory's dispatcher (frames carrying P32_MESH_MAGIC)
+  instead of replacing GSM's callback
+*/
+
+#include "p32_mesh_coordinator.h"
+#include "config/components/templates/MeshCoordinator.hpp"
+#include "core/memory/SharedMemory.hpp"
+#include "esp_log.h"
+#include "esp_mac.h"
+#include "esp_timer.h"
+#include <string.h>
+
+static const char* TAG = "P32_MESH";
+
+static_assert(sizeof(p32_mesh_header_t) == sizeof(MeshHeader), "header layout");
+static_assert(sizeof(p32_mesh_message_t) == MESH_MAX_FRAME, "message layout");
+static_assert(P32_MESH_MAGIC == MESH_MAGIC, "magic");
+static_assert(P32_MESH_MAX_NODES == MESH_MAX_NODES, "node table");
+static_assert(P32_MSG_HEARTBEAT == MESH_MSG_HEARTBEAT && P32_MSG_COMMAND == MESH_MSG_COMMAND &&
+              P32_MSG_STATUS == MESH_MSG_STATUS && P32_MSG_EMERGENCY == MESH_MSG_EMERGENCY, "message types");
+
+// 8 frames per priority: ~7 KB of rings
+typedef MeshCoordinator<8> Mesh;
+
+static Mesh g_mesh;
+static p32_mesh_network_t g_network;
+static p32_mesh_receive_cb_t g_receive_cb = NULL;
+static p32_mesh_node_change_cb_t g_node_change_cb = NULL;
+static volatile bool g_running = false;
+static bool g_espnow_owned = false;     // We started ESP-NOW (GSM had not)
+static uint16_t g_heartbeat_count = 0;
+
+static const uint8_t BROADCAST_MAC[ESP_NOW_ETH_ALEN] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+static uint32_t mesh_now_ms(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+static esp_err_t mesh_result_to_err(Mesh::Result res)
+{
+    switch (res) {
+        case Mesh::OK:         return ESP_OK;
+        case Mesh::ERR_LENGTH: return ESP_ERR_INVALID_SIZE;
+        case Mesh::ERR_TYPE:   return ESP_ERR_INVALID_ARG;
+        default:               return ESP_FAIL;
+    }
+}
+
+static esp_err_t add_peer(const uint8_t* mac)
+{
+    if (esp_now_is_peer_exist(mac)) {
+        return ESP_OK;
+    }
+    esp_now_peer_info_t peer = {};
+    memcpy(peer.peer_addr, mac, ESP_NOW_ETH_ALEN);
+    peer.channel = 0;                   // Current WiFi channel
+    peer.ifidx = WIFI_IF_STA;
+    peer.encrypt = false;
+    return esp_now_add_peer(&peer);
+}
+
+// ---- Transport ----
+
+static bool espnow_send(void* ctx, uint8_t dest_role, const uint8_t* frame, uint16_t len)
+{
+    const uint8_t* mac = BROADCAST_MAC;
+    if (dest_role != MESH_BROADCAST) {
+        const Mesh::Node* node = g_mesh.node(dest_role);
+        if (node && node->online && esp_now_is_peer_exist(node->addr)) {
+            mac = node->addr;
+        }
+    }
+    return esp_now_send(mac, frame, len) == ESP_OK;
+}
+
+static void espnow_recv_cb(const esp_now_recv_info_t* recv_info, const uint8_t* data, int len)
+{
+    if (!g_running || len <= 0 || len > MESH_MAX_FRAME) {
+        return;
+    }
+    g_mesh.receive(data, (uint16_t)len, recv_info->src_addr);
+}
+
+// ---- Dispatch (component loop) ----
+
+static void on_message(void* ctx, const MeshHeader* header, const uint8_t* payload, const uint8_t* src_addr)
+{
+    if (header->msg_type == MESH_MSG_EMERGENCY) {
+        ESP_LOGW(TAG, "EMERGENCY 0x%02X from %s", payload[0],
+                 p32_mesh_role_to_string((p32_node_role_t)header->source_role));
+    }
+    if (g_receive_cb) {
+        // Ring slots are MESH_MAX_FRAME bytes, 4-byte aligned: the whole message is readable
+        g_receive_cb((const p32_mesh_message_t*)header, src_addr);
+    }
+}
+
+static p32_node_info_t* sync_node(uint8_t index)
+{
+    const Mesh::Node* node = g_mesh.nodeAt(index);
+    p32_node_info_t* info = &g_network.nodes[index];
+    memcpy(info->mac_addr, node->addr, 6);
+    info->role = (p32_node_role_t)node->role;
+    info->status = (p32_node_status_t)node->status;
+    info->last_seen = node->last_seen_ms;
+    info->message_count = (uint16_t)node->messages;
+    info->is_connected = node->online;
+    return info;
+}
+
+static void on_node_change(void* ctx, const Mesh::Node& node, bool online)
+{
+    if (online && add_peer(node.addr) != ESP_OK) {
+        ESP_LOGW(TAG, "Could not add peer for %s, using broadcast",
+                 p32_mesh_role_to_string((p32_node_role_t)node.role));
+    }
+    for (uint8_t i = 0; i < g_mesh.nodeCount(); i++) {
+        if (g_mesh.nodeAt(i)->role != node.role) {
+            continue;
+        }
+        p32_node_info_t* info = sync_node(i);
+        g_network.node_count = g_mesh.nodeCount();
+        ESP_LOGI(TAG, "%s %s", p32_mesh_role_to_string(info->role), online ? "online" : "offline");
+        if (g_node_change_cb) {
+            g_node_change_cb(info, online);
+        }
+        break;
+    }
+}
+
+// ---- Core ----
+
+esp_err_t p32_mesh_init(p32_node_role_t local_role, const char* mesh_key)
+{
+    if (g_network.is_initialized) {
+        return ESP_OK;
+    }
+
+    // GSM.init() may already have brought ESP-NOW up; then it stays up after us
+    uint32_t espnow_version = 0;
+    esp_err_t ret = ESP_OK;
+    g_espnow_owned = esp_now_get_version(&espnow_version) != ESP_OK;
+    if (g_espnow_owned) {
+        ret = esp_now_init();
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "ESP-NOW init failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    if (mesh_key && strlen(mesh_key) >= ESP_NOW_KEY_LEN) {
+        esp_now_set_pmk((const uint8_t*)mesh_key);
+    }
+    ret = add_peer(BROADCAST_MAC);
+    if (ret == ESP_OK) {
+#if defined(CONFIG_ESP_WIFI_ESPNOW)
+        ret = SharedMemory::espnow_add_frame_handler(P32_MESH_MAGIC, espnow_recv_cb);
+#else
+        ret = esp_now_register_recv_cb(espnow_recv_cb);     // GSM is not on ESP-NOW in this build
+#endif
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "ESP-NOW setup failed: %s", esp_err_to_name(ret));
+        if (g_espnow_owned) {
+            esp_now_deinit();
+        }
+        return ret;
+    }
+
+    Mesh::Transport radio = { espnow_send, NULL };
+    g_mesh.begin((uint8_t)local_role, radio, P32_MESH_NODE_TIMEOUT_MS);
+    g_mesh.onMessage(MESH_MSG_EMERGENCY, on_message, NULL);
+    g_mesh.onMessage(MESH_MSG_COMMAND, on_message, NULL);
+    g_mesh.onMessage(MESH_MSG_STATUS, on_message, NULL);
+    g_mesh.onMessage(MESH_MSG_HEARTBEAT, on_message, NULL);
+    g_mesh.onNodeChange(on_node_change, NULL);
+
+    memset(&g_network, 0, sizeof(g_network));
+    g_network.local_role = local_role;
+    g_network.network_start_time = mesh_now_ms();
+    g_network.is_initialized = true;
+
+    ESP_LOGI(TAG, "Mesh initialized as %s (%u bytes of receive rings)",
+             p32_mesh_role_to_string(local_role), (unsigned)sizeof(g_mesh));
+    return ESP_OK;
+}
+
+esp_err_t p32_mesh_deinit(void)
+{
+    if (!g_network.is_initialized) {
+        return ESP_OK;
+    }
+    g_running = false;
+#if defined(CONFIG_ESP_WIFI_ESPNOW)
+    SharedMemory::espnow_remove_frame_handler(P32_MESH_MAGIC);
+#else
+    esp_now_unregister_recv_cb();
+#endif
+    if (g_espnow_owned) {
+        esp_now_deinit();
+    }
+    g_network.is_initialized = false;
+    return ESP_OK;
+}
+
+esp_err_t p32_mesh_start(void)
+{
+    if (!g_network.is_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    g_running = true;
+    return ESP_OK;
+}
+
+esp_err_t p32_mesh_stop(void)
+{
+    g_running = false;
+    return ESP_OK;
+}
+
+uint16_t p32_mesh_process(uint16_t max_messages)
+{
+    if (!g_network.is_initialized) {
+        return 0;
+    }
+    uint16_t dispatched = g_mesh.poll(max_messages, mesh_now_ms());
+    for (uint8_t i = 0; i < g_mesh.nodeCount(); i++) {
+        sync_node(i);
+    }
+    g_network.node_count = g_mesh.nodeCount();
+    return dispatched;
+}
+
+// ---- Transmission ----
+
+static esp_err_t mesh_send(uint8_t msg_type, uint8_t dest_role, const void* payload, uint16_t len)
+{
+    if (!g_running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    esp_err_t ret = mesh_result_to_err(g_mesh.send(msg_type, dest_role, payload, len, mesh_now_ms()));
+    g_network.message_sequence = (uint16_t)g_mesh.statistics().sent;
+    return ret;
+}
+
+esp_err_t p32_mesh_send_command(p32_node_role_t dest_role, uint8_t command_id,
+                               const uint8_t* params, uint16_t param_len)
+{
+    uint8_t payload[P32_MESH_PAYLOAD_SIZE];
+    if (sizeof(p32_command_payload_t) + param_len > sizeof(payload)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    p32_command_payload_t cmd = {};
+    cmd.command_id = command_id;
+    cmd.priority = 128;
+    cmd.param_count = param_len;
+    memcpy(payload, &cmd, sizeof(cmd));
+    if (param_len) {
+        memcpy(payload + sizeof(cmd), params, param_len);
+    }
+    return mesh_send(MESH_MSG_COMMAND, (uint8_t)dest_role, payload, (uint16_t)(sizeof(cmd) + param_len));
+}
+
+esp_err_t p32_mesh_send_status(void)
+{
+    const Mesh::Stats& stats = g_mesh.statistics();
+    p32_status_payload_t status = {};
+    status.node_status = P32_STATUS_ACTIVE;
+    status.uptime_sec = (uint32_t)(esp_timer_get_time() / 1000000);
+    status.error_count = (uint16_t)(stats.rejected[Mesh::ERR_CRC] + stats.rejected[Mesh::ERR_MAGIC] +
+                                    stats.rejected[Mesh::ERR_LENGTH] + stats.rejected[Mesh::ERR_FULL] +
+                                    stats.send_errors);
+    uint8_t dest = g_network.local_role == P32_ROLE_MASTER ? MESH_BROADCAST : (uint8_t)P32_ROLE_MASTER;
+    return mesh_send(MESH_MSG_STATUS, dest, &status, sizeof(status));
+}
+
+esp_err_t p32_mesh_send_heartbeat(void)
+{
+    uint8_t mac[6] = {0};
+    esp_read_mac(mac, ESP_MAC_WIFI_STA);
+    p32_heartbeat_payload_t hb = {};
+    hb.node_id = (uint32_t)mac[2] << 24 | (uint32_t)mac[3] << 16 | (uint32_t)mac[4] << 8 | mac[5];
+    hb.firmware_version = 1;
+    hb.config_version = 1;
+    hb.loop_count = g_heartbeat_count++;
+    return mesh_send(MESH_MSG_HEARTBEAT, MESH_BROADCAST, &hb, sizeof(hb));
+}
+
+esp_err_t p32_mesh_broadcast_emergency(uint8_t emergency_code)
+{
+    p32_command_payload_t cmd = {};
+    cmd.command_id = emergency_code;
+    cmd.priority = 255;
+    return mesh_send(MESH_MSG_EMERGENCY, MESH_BROADCAST, &cmd, sizeof(cmd));
+}
+
+// ---- Node management ----
+
+const p32_mesh_network_t* p32_mesh_get_network_info(void)
+{
+    return &g_network;
+}
+
+const p32_node_info_t* p32_mesh_get_node_info(p32_node_role_t role)
+{
+    for (uint8_t i = 0; i < g_network.node_count; i++) {
+        if (g_network.nodes[i].role == role) {
+            return &g_network.nodes[i];
+        }
+    }
+    return NULL;
+}
+
+bool p32_mesh_is_node_online(p32_node_role_t role)
+{
+    const Mesh::Node* node = g_mesh.node((uint8_t)role);
+    return node && node->online;
+}
+
+uint8_t p32_mesh_get_online_node_count(void)
+{
+    return g_mesh.onlineCount();
+}
+
+// ---- Callbacks ----
+
+esp_err_t p32_mesh_register_receive_callback(p32_mesh_receive_cb_t callback)
+{
+    g_receive_cb = callback;
+    return ESP_OK;
+}
+
+esp_err_t p32_mesh_register_node_change_callback(p32_mesh_node_change_cb_t callback)
+{
+    g_node_change_cb = callback;
+    return ESP_OK;
+}
+
+// ---- Utility ----
+
+uint16_t p32_mesh_calculate_checksum(const uint8_t* data, uint16_t len)
+{
+    return MeshCrc16::update(MeshCrc16::INIT, data, len);
+}
+
+bool p32_mesh_validate_message(const p32_mesh_message_t* message)
+{
+    if (!message || message->header.payload_len > P32_MESH_PAYLOAD_SIZE) {
+        return false;
+    }
+    uint16_t len = (uint16_t)(sizeof(p32_mesh_header_t) + message->header.payload_len);
+    return Mesh::check((const uint8_t*)message, len) == Mesh::OK;
+}
+
+const char* p32_mesh_role_to_string(p32_node_role_t role)
+{
+    switch (role) {
+        case P32_ROLE_MASTER:           return "MASTER";
+        case P32_ROLE_SLAVE_HEAD:       return "HEAD";
+        case P32_ROLE_SLAVE_ARM_LEFT:   return "ARM_LEFT";
+        case P32_ROLE_SLAVE_ARM_RIGHT:  return "ARM_RIGHT";
+        case P32_ROLE_SLAVE_LEG_LEFT:   return "LEG_LEFT";
+        case P32_ROLE_SLAVE_LEG_RIGHT:  return "LEG_RIGHT";
+        case P32_ROLE_SLAVE_HAND_LEFT:  return "HAND_LEFT";
+        case P32_ROLE_SLAVE_HAND_RIGHT: return "HAND_RIGHT";
+        default:                        return "UNKNOWN";
+    }
+}
+
+const char* p32_mesh_status_to_string(p32_node_status_t status)
+{
+    switch (status) {
+        case P32_STATUS_OFFLINE:      return "OFFLINE";
+        case P32_STATUS_INITIALIZING: return "INITIALIZING";
+        case P32_STATUS_READY:        return "READY";
+        case P32_STATUS_ACTIVE:       return "ACTIVE";
+        case P32_STATUS_ERROR:        return "ERROR";
+        case P32_STATUS_EMERGENCY:    return "EMERGENCY";
+        default:                      return "UNKNOWN";
+    }
+}
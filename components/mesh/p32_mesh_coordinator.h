@@ -33,6 +33,8 @@ extern "C" {
 #define P32_MESH_PAYLOAD_SIZE 200
 #define P32_MESH_HEARTBEAT_INTERVAL_MS 1000
 #define P32_MESH_COMMAND_TIMEOUT_MS 500
+#define P32_MESH_NODE_TIMEOUT_MS (3 * P32_MESH_HEARTBEAT_INTERVAL_MS)
+#define P32_MESH_MAGIC 0x4D323350u        // "P32M" in wire (little endian) order
 
 // Message Types
 typedef enum {
@@ -66,14 +68,14 @@ typedef enum {
 
 // Message Header (16 bytes)
 typedef struct __attribute__((packed)) {
-    uint32_t magic;           // 0xP32MESH (validation)
+    uint32_t magic;           // P32_MESH_MAGIC (validation)
     uint8_t msg_type;         // p32_msg_type_t
     uint8_t source_role;      // sender node role
     uint8_t dest_role;        // destination role (0xFF for broadcast)
-    uint8_t sequence;         // message sequence number
+    uint8_t sequence;         // sequence number, per sender and message type
     uint32_t timestamp;       // sender timestamp
     uint16_t payload_len;     // payload length in bytes
-    uint16_t checksum;        // CRC16 of header + payload
+    uint16_t checksum;        // CRC-16/CCITT-FALSE of header (without checksum) + payload
 } p32_mesh_header_t;
 
 // Command Message Payload
@@ -143,6 +145,7 @@ esp_err_t p32_mesh_init(p32_node_role_t local_role, const char* mesh_key);
 esp_err_t p32_mesh_deinit(void);
 esp_err_t p32_mesh_start(void);
 esp_err_t p32_mesh_stop(void);
+uint16_t p32_mesh_process(uint16_t max_messages);    // Dispatch received messages, call from the loop
 
 // Message transmission
 esp_err_t p32_mesh_send_command(p32_node_role_t dest_role, uint8_t command_id, 
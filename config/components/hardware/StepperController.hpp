@@ -11,15 +11,28 @@
  * - Speed/torque tradeoff is preset per motor type
  * - Driver interface is controller-agnostic (GPIO + timing)
  * 
+ * - StepperController plans every move with StepperMotionPlanner once an
+ *   acceleration is set; the step ISR reloads its timer from nextIntervalUs()
+ * 
  * USAGE:
  *   const StepperSpec& motor = STEPPER_MOTORS[NEMA17_STANDARD];
  *   if (motor.steps_per_revolution == 200) { ... }
  *   delay_us = motor.min_step_interval_us;  // Timing for max speed
+ *
+ *   StepperController ctl(motor);
+ *   ctl.setSpeed(300);
+ *   ctl.setAcceleration(4000.0f, 150000.0f);     // S-curve; jerk 0 -> trapezoid
+ *   ctl.moveTo(800);
+ *   // Arm the step timer with ctl.nextIntervalUs(); on each alarm
+ *   // pulse STEP, ctl.step(), reload with ctl.nextIntervalUs() (0 = stop)
  */
 
 #pragma once
 
 #include <cstdint>
+#include <cstring>
+
+#include "config/components/templates/StepperMotionPlanner.hpp"
 
 // Step/direction control modes
 enum StepperMode {
@@ -43,8 +56,8 @@ struct StepperSpec {
     uint16_t nema_size;                  // 17, 23, 24, 34, 42 (motor frame height)
     uint16_t rated_voltage_mv;           // 12000, 24000 mV
     uint16_t rated_current_ma;           // Per coil, mA
-    uint16_t holding_torque_ncm;         // Holding torque in 0.01 N·cm units
-    uint16_t max_torque_ncm;             // Peak torque
+    uint32_t holding_torque_ncm;         // Holding torque in 0.01 N·cm units
+    uint32_t max_torque_ncm;             // Peak torque
     uint16_t base_steps_per_rev;         // Usually 200 (1.8°) or 48 (7.5°)
     uint16_t nominal_rpm_at_rated;       // Typical RPM at rated current
     uint16_t max_rpm_no_load;            // Max RPM with no load
@@ -397,7 +410,9 @@ public:
         : motor_spec(spec), current_position(0), 
           target_position(0), is_moving(false),
           step_interval_us(spec.recommended_step_interval_us),
-          step_callback(nullptr)
+          step_callback(nullptr),
+          accel_steps_s2(0.0f), jerk_steps_s3(0.0f),
+          pending_target(0), has_pending(false)
     {}
     
     // Configure GPIO pins for step/direction control
@@ -418,12 +433,35 @@ public:
         // steps_per_sec = (rpm * steps_per_rev) / 60
         uint32_t steps_per_sec = (rpm * motor_spec.base_steps_per_rev) / 60;
         step_interval_us = (steps_per_sec > 0) ? 1000000 / steps_per_sec : 1000;
+        planner.setMaxSpeed(steps_per_sec > 0 ? (float)steps_per_sec : 1.0f);
+    }
+    
+    /**
+     * Enable acceleration profiling for the following moves
+     * @param accel Steps/s^2, 0 returns to constant speed
+     * @param jerk Steps/s^3, 0 gives a trapezoid, otherwise an S-curve
+     */
+    void setAcceleration(float accel, float jerk = 0.0f) {
+        accel_steps_s2 = accel;
+        jerk_steps_s3 = jerk;
+        StepperMotionPlanner::Profile profile = accel <= 0.0f ? StepperMotionPlanner::CONSTANT :
+            (jerk > 0.0f ? StepperMotionPlanner::S_CURVE : StepperMotionPlanner::TRAPEZOID);
+        planner.configure(1000000, planner.maxSpeed(), accel, jerk, profile);
     }
     
     // Move to absolute position (steps)
+    // While a profiled move is running the motor first ramps down, then starts the new move
     void moveTo(int32_t position) {
-        target_position = position;
-        is_moving = (position != current_position);
+        if (is_moving && planner.profile() != StepperMotionPlanner::CONSTANT) {
+            if (position == getTarget()) return;
+            uint32_t left = planner.stop();     // Keeps an ongoing ramp-down as it is
+            target_position = (target_position > current_position) ?
+                current_position + (int32_t)left : current_position - (int32_t)left;
+            pending_target = position;
+            has_pending = position != target_position;  // Stop point is the target: just finish the ramp
+            return;
+        }
+        startMove(position);
     }
     
     // Move relative (steps)
@@ -434,6 +472,9 @@ public:
     // Get current position
     int32_t getPosition() const { return current_position; }
     
+    // Get where the motor is finally headed (the queued target during a ramp-down)
+    int32_t getTarget() const { return has_pending ? pending_target : target_position; }
+    
     // Check if moving
     bool isMoving() const { return is_moving; }
     
@@ -454,6 +495,27 @@ public:
         }
     }
     
+    /**
+     * Time until the next step, microseconds; 0 once the target is reached.
+     * Called by the step ISR right after step(), so it is a table read only.
+     */
+    uint32_t nextIntervalUs() {
+        if (planner.profile() == StepperMotionPlanner::CONSTANT) {
+            return (current_position != target_position) ? step_interval_us : 0;
+        }
+        uint32_t ticks = planner.nextInterval();
+        if (ticks == 0 && has_pending) {
+            // Ramp-down of the previous move is done: plan the queued one
+            has_pending = false;
+            startMove(pending_target);
+            ticks = planner.nextInterval();
+        }
+        if (ticks == 0) is_moving = false;
+        return ticks;
+    }
+    
+    const StepperMotionPlanner& getPlanner() const { return planner; }
+    
     // Get motor specification
     const StepperSpec& getSpec() const { return motor_spec; }
     
@@ -469,6 +531,19 @@ private:
     bool is_moving;
     uint32_t step_interval_us;
     StepCallback step_callback;
+    
+    StepperMotionPlanner planner;
+    float accel_steps_s2;
+    float jerk_steps_s3;
+    int32_t pending_target;
+    bool has_pending;
+    
+    void startMove(int32_t position) {
+        target_position = position;
+        is_moving = (position != current_position);
+        int32_t distance = position - current_position;
+        planner.plan((uint32_t)(distance < 0 ? -distance : distance));
+    }
 };
 
 // ============================================================================
@@ -521,5 +596,3 @@ inline const StepperSpec* selectMotor(uint16_t min_torque_ncm,
     
     return best;
 }
-
-#endif // STEPPER_MOTOR_LIBRARY_HPP
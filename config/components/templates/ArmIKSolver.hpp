@@ -0,0 +1,514 @@
+/**
+ * @file ArmIKSolver.hpp
+ * @brief Closed-form + damped-least-squares inverse kinematics, 7-DOF arm
+ *
+ * SUBSYSTEM: arm controllers (p32_arm_reach_target)
+ *
+ * ARCHITECTURE:
+ * - Chain (shoulder at the origin, x forward, y outward, z up; all zero =
+ *   arm hanging at the side):
+ *       0 shoulder flexion   about -y      (positive raises the arm forward)
+ *       1 shoulder abduction about +x      (positive raises it outward)
+ *       2 shoulder rotation  about the upper arm
+ *       3 elbow flexion      about -y      upper arm length L1
+ *       5 wrist rotation     about the forearm          forearm L2
+ *       4 wrist flexion      about -y
+ *       6 wrist abduction    about +x      hand length L3 to the reach point
+ *   Angles in and out are degrees, matching ARM_JOINT_MIN/MAX_ANGLES
+ * - The reach target fixes 3 of the 4 position joints (0-3); the wrist
+ *   joints (4-6) are an orientation request and are held as given
+ * - Fast reject: the target has to lie in the shell between the shortest
+ *   and longest shoulder-to-hand distance the elbow and wrist allow.
+ *   Squared distances only, no sqrt, before any trig is spent
+ * - Closed form when the wrist is straight (hand in line with the forearm):
+ *   the elbow angle follows from the target distance by the cosine rule,
+ *   and for a given shoulder rotation (the redundant swivel) abduction and
+ *   flexion each come from one atan2 (two abduction branches, the one
+ *   nearer the warm start wins). The warm start's swivel is tried first,
+ *   then a fixed fan of 0 / +-45 / +-90 deg until one lands inside every
+ *   joint limit. Exact, ~10 trig calls per swivel tried
+ * - Damped least squares otherwise (bent wrist, or no swivel gives an
+ *   in-limit closed form):
+ *       dq = J^T (J J^T + lambda^2 I)^-1 e
+ *   over joints 0-3 with a geometric Jacobian (a_i x (p_hand - p_i)), the
+ *   3x3 system solved by cofactors. Each step is clamped to the joint
+ *   limits; a joint pinned at a limit and pushed further is dropped from
+ *   the step so the others take up the error. lambda doubles when a step
+ *   makes things worse (and the step is undone) and relaxes toward its
+ *   base value when steps succeed. The minimum-norm step keeps the
+ *   redundant swivel close to the starting pose
+ * - DLS starts from whichever is closer to the target: the warm start or
+ *   the closed-form estimate (clamped; with a bent wrist it uses the
+ *   elbow-to-hand distance as the forearm). If that run stalls against a
+ *   limit, the other start gets a run too and the better answer is kept
+ * - Warm start: the caller passes the current pose in the same array the
+ *   solution comes back in, so tracking a moving target converges in 0-3
+ *   iterations
+ *
+ * MEMORY: ~60 bytes, no heap
+ *
+ * TIMING (ESP32-S3 FPU, float):
+ *   closed form:   ~10 trig calls per swivel, a few us
+ *   DLS iteration: one forward pass (7 sin/cos pairs) + ~150 flops,
+ *                  ~10 us; worst case two runs of 32 iterations stays
+ *                  under 1 ms, warm-started tracking needs 0-3
+ *
+ * USAGE:
+ *   ArmIKSolver ik;
+ *   ik.configure(250.0f, 200.0f, 80.0f);            // mm
+ *   for (j...) ik.setJointLimit(j, min_deg, max_deg);
+ *   float q[7]; copy of the present joint angles     // warm start + wrist
+ *   ArmIKSolver::Result r = ik.solve(x, y, z, q);
+ *   if (r.status != ArmIKSolver::IK_UNREACHABLE) drive the servos with q
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+
+class ArmIKSolver {
+public:
+    static constexpr uint8_t DOF = 7;
+    static constexpr uint8_t POSITION_DOF = 4;      // Joints 0-3 place the hand
+
+    enum Status : uint8_t {
+        IK_ANALYTIC = 0,    // Closed form, exact
+        IK_CONVERGED,       // DLS within tolerance
+        IK_BEST_EFFORT,     // Closest pose found (limits / iteration cap)
+        IK_UNREACHABLE      // Rejected before solving, q untouched
+    };
+
+    struct Result {
+        Status status;
+        float error_mm;     // Remaining hand position error
+        uint8_t iterations; // DLS iterations spent (0 for closed form)
+    };
+
+    struct Vec3 { float x, y, z; };
+
+    ArmIKSolver() {
+        for (uint8_t j = 0; j < DOF; j++) {
+            q_min[j] = -(float)M_PI;
+            q_max[j] = (float)M_PI;
+        }
+        configure(250.0f, 200.0f, 0.0f);
+    }
+
+    /** Link lengths, mm: shoulder-elbow, elbow-wrist, wrist-reach point */
+    void configure(float upper_arm_mm, float forearm_mm, float hand_mm) {
+        l1 = upper_arm_mm;
+        l2 = forearm_mm;
+        l3 = hand_mm > 0.0f ? hand_mm : 0.0f;
+        lambda_base = 0.02f * (l1 + l2 + l3);
+        tolerance = 0.5f;
+        max_iterations = 32;
+        max_step = 0.2f * (l1 + l2 + l3);
+    }
+
+    void setJointLimit(uint8_t joint, float min_deg, float max_deg) {
+        if (joint >= DOF || min_deg > max_deg) return;
+        q_min[joint] = min_deg * DEG2RAD;
+        q_max[joint] = max_deg * DEG2RAD;
+    }
+
+    /** @param mm Position error accepted as converged */
+    void setTolerance(float mm) { tolerance = mm > 0.0f ? mm : 0.5f; }
+
+    void setMaxIterations(uint8_t n) { max_iterations = n > 0 ? n : 1; }
+
+    /** @param mm Base DLS damping (larger = steadier near singularities) */
+    void setDamping(float mm) { lambda_base = mm > 0.0f ? mm : 1.0f; }
+
+    /** Longest shoulder-to-hand distance, mm */
+    float maxReach() const { return l1 + l2 + l3; }
+
+    /** Hand (reach point) position for a pose, mm */
+    void forward(const float* q_deg, Vec3& hand) const {
+        float q[DOF];
+        for (uint8_t j = 0; j < DOF; j++) q[j] = q_deg[j] * DEG2RAD;
+        Chain c;
+        chain(q, c);
+        hand = c.hand;
+    }
+
+    /**
+     * Cheap reachability test: inside the elbow / wrist shell
+     * @param q_deg Pose supplying the wrist angles (4-6)
+     */
+    bool inReach(float x, float y, float z, const float* q_deg) const {
+        float lo2, hi2;
+        shell(q_deg[4] * DEG2RAD, q_deg[6] * DEG2RAD, lo2, hi2);
+        float d2 = x * x + y * y + z * z;
+        return d2 <= hi2 && d2 >= lo2;
+    }
+
+    /**
+     * Solve for a hand position
+     * @param q_deg In: present pose (warm start, wrist request).
+     *              Out: solution, within the joint limits
+     */
+    Result solve(float x, float y, float z, float* q_deg) const {
+        Result r = {IK_UNREACHABLE, 0.0f, 0};
+        float q[DOF];
+        for (uint8_t j = 0; j < DOF; j++) q[j] = q_deg[j] * DEG2RAD;
+
+        float lo2, hi2;
+        shell(q[4], q[6], lo2, hi2);
+        float d2 = x * x + y * y + z * z;
+        if (d2 > hi2 || d2 < lo2) {
+            r.error_mm = sqrtf(d2) - (d2 > hi2 ? sqrtf(hi2) : sqrtf(lo2));
+            r.error_mm = fabsf(r.error_mm);
+            return r;
+        }
+
+        Vec3 t = {x, y, z};
+        bool straight = fabsf(q[4]) < 1e-6f && fabsf(q[6]) < 1e-6f;
+        float le = straight ? l2 + l3 : elbowToHand(q[4], q[6]);
+        float seed[POSITION_DOF];
+        float violation = 0.0f;
+        bool seeded = closedForm(t, d2, le, q, seed, violation);
+        if (straight && seeded && violation == 0.0f) {
+            for (uint8_t j = 0; j < POSITION_DOF; j++) q_deg[j] = seed[j] * RAD2DEG;
+            r.status = IK_ANALYTIC;
+            return r;
+        }
+
+        if (!seeded) {
+            dls(t, q, r);
+        } else {
+            // Start from whichever of the warm start and the closed-form
+            // seed is closer; if that stalls against a limit, try the other
+            float q_seed[DOF];
+            for (uint8_t j = 0; j < DOF; j++) q_seed[j] = j < POSITION_DOF ? clampJoint(j, seed[j]) : q[j];
+            float* first = q;
+            float* second = q_seed;
+            if (error2(t, q_seed) < error2(t, q)) {
+                first = q_seed;
+                second = q;
+            }
+            dls(t, first, r);
+            if (r.status == IK_BEST_EFFORT) {
+                Result r2;
+                dls(t, second, r2);
+                r2.iterations += r.iterations;
+                if (r2.error_mm < r.error_mm) {
+                    first = second;
+                    r = r2;
+                } else {
+                    r.iterations = r2.iterations;
+                }
+            }
+            if (first != q) {
+                for (uint8_t j = 0; j < POSITION_DOF; j++) q[j] = first[j];
+            }
+        }
+        for (uint8_t j = 0; j < POSITION_DOF; j++) q_deg[j] = q[j] * RAD2DEG;
+        return r;
+    }
+
+private:
+    static constexpr float DEG2RAD = (float)M_PI / 180.0f;
+    static constexpr float RAD2DEG = 180.0f / (float)M_PI;
+
+    float l1, l2, l3;
+    float q_min[DOF];
+    float q_max[DOF];
+    float lambda_base;
+    float tolerance;
+    float max_step;
+    uint8_t max_iterations;
+
+    // Frame as three column vectors (local x, y, z in world coordinates)
+    struct Frame { Vec3 c[3]; };
+
+    struct Chain {
+        Vec3 elbow;
+        Vec3 wrist;
+        Vec3 hand;
+        Vec3 axis[POSITION_DOF];    // World axes of joints 0-3
+    };
+
+    static float wrapPi(float a) {
+        while (a > (float)M_PI) a -= 2.0f * (float)M_PI;
+        while (a <= -(float)M_PI) a += 2.0f * (float)M_PI;
+        return a;
+    }
+
+    static Vec3 cross(const Vec3& a, const Vec3& b) {
+        return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+    }
+
+    static Vec3 neg(const Vec3& a) { return {-a.x, -a.y, -a.z}; }
+
+    // Post-multiply by a rotation about the local x / y / z axis
+    static void rotX(Frame& f, float a) {
+        float c = cosf(a), s = sinf(a);
+        Vec3 y = f.c[1], z = f.c[2];
+        f.c[1] = {c * y.x + s * z.x, c * y.y + s * z.y, c * y.z + s * z.z};
+        f.c[2] = {c * z.x - s * y.x, c * z.y - s * y.y, c * z.z - s * y.z};
+    }
+    static void rotY(Frame& f, float a) {
+        float c = cosf(a), s = sinf(a);
+        Vec3 x = f.c[0], z = f.c[2];
+        f.c[0] = {c * x.x - s * z.x, c * x.y - s * z.y, c * x.z - s * z.z};
+        f.c[2] = {s * x.x + c * z.x, s * x.y + c * z.y, s * x.z + c * z.z};
+    }
+    static void rotZ(Frame& f, float a) {
+        float c = cosf(a), s = sinf(a);
+        Vec3 x = f.c[0], y = f.c[1];
+        f.c[0] = {c * x.x + s * y.x, c * x.y + s * y.y, c * x.z + s * y.z};
+        f.c[1] = {c * y.x - s * x.x, c * y.y - s * x.y, c * y.z - s * x.z};
+    }
+
+    // Point plus a length along the frame's -z (every link hangs along -z)
+    static Vec3 along(const Vec3& p, const Frame& f, float len) {
+        return {p.x - len * f.c[2].x, p.y - len * f.c[2].y, p.z - len * f.c[2].z};
+    }
+
+    void chain(const float* q, Chain& out) const {
+        Frame f = {{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}};
+        out.axis[0] = neg(f.c[1]);
+        rotY(f, -q[0]);
+        out.axis[1] = f.c[0];
+        rotX(f, q[1]);
+        out.axis[2] = f.c[2];
+        rotZ(f, q[2]);
+        out.axis[3] = neg(f.c[1]);
+        Vec3 origin = {0, 0, 0};
+        out.elbow = along(origin, f, l1);
+        rotY(f, -q[3]);
+        out.wrist = along(out.elbow, f, l2);
+        if (l3 > 0.0f) {
+            rotZ(f, q[5]);
+            rotY(f, -q[4]);
+            rotX(f, q[6]);
+        }
+        out.hand = along(out.wrist, f, l3);
+    }
+
+    // Squared shortest / longest hand distance for this wrist pose
+    void shell(float wrist_flex, float wrist_abd, float& lo2, float& hi2) const {
+        float hi = 0.0f, lo = 0.0f;
+        if (l3 > 0.0f && (wrist_flex != 0.0f || wrist_abd != 0.0f)) {
+            // The elbow limit bound below is only exact for a straight
+            // wrist, so use the (looser) fully-folded bound here
+            float le = elbowToHand(wrist_flex, wrist_abd);
+            hi = l1 + le;
+            lo = fabsf(l1 - le);
+            lo2 = lo * lo;
+        } else {
+            float le = l2 + l3;
+            hi = l1 + le;
+            // Elbow range decides how close the hand can come
+            float c_max = cosf(q_max[3]), c_min = cosf(q_min[3]);
+            float c_lo = c_max < c_min ? c_max : c_min;
+            lo2 = l1 * l1 + le * le + 2.0f * l1 * le * c_lo;
+            lo2 *= 0.999f;              // Rounding margin at the limit itself
+        }
+        hi2 = hi * hi * 1.000001f;
+    }
+
+    // Elbow-to-hand distance with the wrist bent
+    float elbowToHand(float wrist_flex, float wrist_abd) const {
+        Frame f = {{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}};
+        rotY(f, -wrist_flex);
+        rotX(f, wrist_abd);
+        Vec3 h = {-l3 * f.c[2].x, -l3 * f.c[2].y, -l2 - l3 * f.c[2].z};
+        return sqrtf(h.x * h.x + h.y * h.y + h.z * h.z);
+    }
+
+    // How far a pose lies outside the joint limits, radians summed
+    float limitViolation(uint8_t j, float a) const {
+        return a < q_min[j] ? q_min[j] - a : (a > q_max[j] ? a - q_max[j] : 0.0f);
+    }
+
+    /**
+     * Elbow by the cosine rule, abduction / flexion by atan2 for a given
+     * swivel (shoulder rotation). Exact for a straight wrist (le = L2 + L3);
+     * with a bent wrist it is only a seed for DLS
+     * @return false if the target can't be met at this swivel
+     */
+    bool swivelSolve(const Vec3& t, float le, float q2, float q3,
+                     const float* warm, float* out, float& violation) const {
+        float s3 = sinf(q3), c3 = cosf(q3);
+
+        // Hand in the shoulder-rotation frame, then through the swivel
+        float hx = le * s3, hz = -l1 - le * c3;
+        float ux = hx * cosf(q2), uy = hx * sinf(q2), uz = hz;
+
+        // Abduction: uy cos(q1) - uz sin(q1) = t.y
+        float r = sqrtf(uy * uy + uz * uz);
+        if (r < 1e-6f || fabsf(t.y) > r) return false;
+        float delta = atan2f(uz, uy);
+        float spread = acosf(t.y / r);
+
+        bool found = false;
+        float best_cost = 0.0f;
+        for (int branch = -1; branch <= 1; branch += 2) {
+            float q1 = wrapPi(-delta + branch * spread);
+            // Flexion turns (wx, wz) onto (t.x, t.z)
+            float wx = ux;
+            float wz = uy * sinf(q1) + uz * cosf(q1);
+            float q0 = wrapPi(atan2f(t.z, t.x) - atan2f(wz, wx));
+            float v = limitViolation(0, q0) + limitViolation(1, q1) +
+                      limitViolation(2, q2) + limitViolation(3, q3);
+            float cost = v * 100.0f + fabsf(q0 - warm[0]) + fabsf(q1 - warm[1]);
+            if (!found || cost < best_cost) {
+                out[0] = q0;
+                out[1] = q1;
+                out[2] = q2;
+                out[3] = q3;
+                violation = v;
+                best_cost = cost;
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    /**
+     * Closed form over a handful of swivels: the warm start's first, then
+     * a fixed fan, stopping at the first one inside every limit
+     * @param violation Out: 0 if out[] respects the limits
+     */
+    bool closedForm(const Vec3& t, float d2, float le, const float* warm,
+                    float* out, float& violation) const {
+        float c3 = (d2 - l1 * l1 - le * le) / (2.0f * l1 * le);
+        if (c3 > 1.0f) c3 = 1.0f;
+        if (c3 < -1.0f) c3 = -1.0f;
+        float q3 = acosf(c3);
+
+        static const float FAN[] = {0.0f, -0.785398f, 0.785398f, -1.570796f, 1.570796f};
+        bool found = false;
+        for (int i = -1; i < (int)(sizeof(FAN) / sizeof(FAN[0])); i++) {
+            float q2 = i < 0 ? warm[2] : clampJoint(2, FAN[i]);
+            float cand[POSITION_DOF];
+            float v = 0.0f;
+            if (!swivelSolve(t, le, q2, q3, warm, cand, v)) continue;
+            if (!found || v < violation) {
+                for (uint8_t j = 0; j < POSITION_DOF; j++) out[j] = cand[j];
+                violation = v;
+                found = true;
+            }
+            if (violation == 0.0f) break;
+        }
+        return found;
+    }
+
+    float clampJoint(uint8_t j, float a) const {
+        return a < q_min[j] ? q_min[j] : (a > q_max[j] ? q_max[j] : a);
+    }
+
+    /** Hand position error for a pose (radians), squared mm */
+    float error2(const Vec3& t, const float* q) const {
+        Chain c;
+        chain(q, c);
+        float ex = t.x - c.hand.x, ey = t.y - c.hand.y, ez = t.z - c.hand.z;
+        return ex * ex + ey * ey + ez * ez;
+    }
+
+    /** Damped least squares over joints 0-3, q (radians) updated in place */
+    void dls(const Vec3& t, float* q, Result& r) const {
+        for (uint8_t j = 0; j < POSITION_DOF; j++) q[j] = clampJoint(j, q[j]);
+
+        Chain c;
+        chain(q, c);
+        Vec3 e = {t.x - c.hand.x, t.y - c.hand.y, t.z - c.hand.z};
+        float err2 = e.x * e.x + e.y * e.y + e.z * e.z;
+
+        float tol2 = tolerance * tolerance;
+        float lambda = lambda_base;
+        uint8_t it = 0;
+
+        while (err2 > tol2 && it < max_iterations) {
+            it++;
+
+            // Jacobian columns: a_i x (hand - p_i); joints 0-2 at the origin
+            Vec3 J[POSITION_DOF];
+            for (uint8_t j = 0; j < 3; j++) J[j] = cross(c.axis[j], c.hand);
+            Vec3 from_elbow = {c.hand.x - c.elbow.x, c.hand.y - c.elbow.y, c.hand.z - c.elbow.z};
+            J[3] = cross(c.axis[3], from_elbow);
+
+            // Limit the task-space step so linearisation holds
+            Vec3 es = e;
+            float emag = sqrtf(err2);
+            if (emag > max_step) {
+                float k = max_step / emag;
+                es = {e.x * k, e.y * k, e.z * k};
+            }
+
+            float dq[POSITION_DOF];
+            bool active[POSITION_DOF] = {true, true, true, true};
+            step(J, active, es, lambda, dq);
+
+            // Joints pinned at a limit and pushed outward sit the step out
+            bool pinned = false;
+            for (uint8_t j = 0; j < POSITION_DOF; j++) {
+                if ((q[j] <= q_min[j] && dq[j] < 0.0f) || (q[j] >= q_max[j] && dq[j] > 0.0f)) {
+                    active[j] = false;
+                    pinned = true;
+                }
+            }
+            if (pinned) step(J, active, es, lambda, dq);
+
+            float q_try[DOF];
+            for (uint8_t j = 0; j < DOF; j++) q_try[j] = q[j];
+            for (uint8_t j = 0; j < POSITION_DOF; j++) q_try[j] = clampJoint(j, q[j] + dq[j]);
+
+            Chain c_try;
+            chain(q_try, c_try);
+            Vec3 e_try = {t.x - c_try.hand.x, t.y - c_try.hand.y, t.z - c_try.hand.z};
+            float err2_try = e_try.x * e_try.x + e_try.y * e_try.y + e_try.z * e_try.z;
+
+            if (err2_try < err2) {
+                for (uint8_t j = 0; j < POSITION_DOF; j++) q[j] = q_try[j];
+                c = c_try;
+                e = e_try;
+                err2 = err2_try;
+                lambda *= 0.5f;
+                if (lambda < lambda_base) lambda = lambda_base;
+            } else {
+                // Worse: stay put and damp harder
+                lambda *= 2.0f;
+                if (lambda > 1024.0f * lambda_base) break;
+            }
+        }
+
+        r.iterations = it;
+        r.error_mm = sqrtf(err2);
+        r.status = err2 <= tol2 ? IK_CONVERGED : IK_BEST_EFFORT;
+    }
+
+    /** dq = J^T (J J^T + lambda^2 I)^-1 e over the active columns */
+    static void step(const Vec3* J, const bool* active, const Vec3& e, float lambda, float* dq) {
+        float a[3][3] = {{0}};
+        for (uint8_t j = 0; j < POSITION_DOF; j++) {
+            if (!active[j]) continue;
+            const float v[3] = {J[j].x, J[j].y, J[j].z};
+            for (uint8_t r = 0; r < 3; r++)
+                for (uint8_t k = r; k < 3; k++) a[r][k] += v[r] * v[k];
+        }
+        float l2 = lambda * lambda;
+        a[0][0] += l2; a[1][1] += l2; a[2][2] += l2;
+        a[1][0] = a[0][1]; a[2][0] = a[0][2]; a[2][1] = a[1][2];
+
+        // Symmetric 3x3 inverse by cofactors (positive definite thanks to
+        // the damping, so det > 0)
+        float c00 = a[1][1] * a[2][2] - a[1][2] * a[2][1];
+        float c01 = a[1][2] * a[2][0] - a[1][0] * a[2][2];
+        float c02 = a[1][0] * a[2][1] - a[1][1] * a[2][0];
+        float c11 = a[0][0] * a[2][2] - a[0][2] * a[2][0];
+        float c12 = a[0][1] * a[2][0] - a[0][0] * a[2][1];
+        float c22 = a[0][0] * a[1][1] - a[0][1] * a[1][0];
+        float det = a[0][0] * c00 + a[0][1] * c01 + a[0][2] * c02;
+        float inv = 1.0f / det;
+        float y0 = (c00 * e.x + c01 * e.y + c02 * e.z) * inv;
+        float y1 = (c01 * e.x + c11 * e.y + c12 * e.z) * inv;
+        float y2 = (c02 * e.x + c12 * e.y + c22 * e.z) * inv;
+
+        for (uint8_t j = 0; j < POSITION_DOF; j++) {
+            dq[j] = active[j] ? J[j].x * y0 + J[j].y * y1 + J[j].z * y2 : 0.0f;
+        }
+    }
+};
@@ -0,0 +1,270 @@
+/**
+ * @file AttitudeEstimator.hpp
+ * @brief Mahony quaternion attitude filter (gyro + accel, optional magnetometer)
+ *
+ * SUBSYSTEM: flying_dragon flight system (flying_dragon_sensor_fusion)
+ *
+ * ARCHITECTURE:
+ * - State is a unit quaternion q (body -> earth, earth z up) plus a gyro
+ *   bias estimate. Each update():
+ *     1. gravity direction predicted from q is crossed with the measured
+ *        accel direction -> rotation error e (body frame)
+ *     2. optional: same for the horizontal magnetic field -> yaw error
+ *     3. bias integrator  b -= ki * e * dt, corrected rate w = gyro - b + kp * e
+ *     4. q += 0.5 * q (x) w * dt, renormalise
+ * - Accel passes a one-pole low-pass first: normalising a vibrating
+ *   vector rectifies the vibration into a steady tilt error (wing beats
+ *   at ~20 Hz cost 1 deg unfiltered)
+ * - Accel correction is skipped while |a| is far from 1 g (thrust pulses,
+ *   bumps); the gyro carries the attitude through them
+ * - Start-up: initFromAccel() aligns roll/pitch in one step and a boosted
+ *   kp for the first BOOST_SECONDS pulls in any remaining error quickly
+ * - Yaw is unobservable from accel alone; it drifts with the residual
+ *   z-gyro bias unless updateMag() is used
+ *
+ * MEMORY: 72 bytes, no heap
+ *
+ * TIMING: ~100 float ops, two sqrt and two divides per update (one more
+ *   sqrt pair with the magnetometer) - sized for 1 kHz on an ESP32-S3 FPU
+ *
+ * USAGE:
+ *   AttitudeEstimator ahrs;
+ *   ahrs.initFromAccel(ax, ay, az);
+ *   ahrs.update(gx, gy, gz, ax, ay, az, dt);     // rad/s, any accel unit, s
+ *   float roll = ahrs.roll();
+ */
+
+#pragma once
+
+#include <cmath>
+
+class AttitudeEstimator {
+public:
+    static constexpr float BOOST_SECONDS = 2.0f;
+    static constexpr float BOOST_KP = 10.0f;
+
+    AttitudeEstimator() {
+        configure(1.0f, 0.2f, 0.25f, 10.0f);
+    }
+
+    /**
+     * @param kp Proportional gain (rad/s per unit error): crossover ~kp rad/s
+     * @param ki Integral gain for gyro bias estimation
+     * @param accel_tolerance Accel correction only while | |a|/1g - 1 | < tolerance
+     * @param accel_lpf_hz Accel low-pass corner, 0 = off
+     */
+    void configure(float kp, float ki, float accel_tolerance, float accel_lpf_hz) {
+        kp_gain = kp;
+        ki_gain = ki;
+        accel_tol = accel_tolerance;
+        lpf_tau = accel_lpf_hz > 0.0f ? 1.0f / (6.2831853f * accel_lpf_hz) : 0.0f;
+        reset();
+    }
+
+    void reset() {
+        q0 = 1.0f;
+        q1 = q2 = q3 = 0.0f;
+        bias_x = bias_y = bias_z = 0.0f;
+        rate_x = rate_y = rate_z = 0.0f;
+        elapsed = 0.0f;
+        g_ref = 0.0f;
+        fax = fay = faz = 0.0f;
+        rejected = 0;
+    }
+
+    /** Roll/pitch straight from a resting accel sample, yaw = 0 */
+    void initFromAccel(float ax, float ay, float az) {
+        float roll0 = atan2f(ay, az);
+        float pitch0 = atan2f(-ax, sqrtf(ay * ay + az * az));
+        float cr = cosf(roll0 * 0.5f), sr = sinf(roll0 * 0.5f);
+        float cp = cosf(pitch0 * 0.5f), sp = sinf(pitch0 * 0.5f);
+        q0 = cr * cp;
+        q1 = sr * cp;
+        q2 = cr * sp;
+        q3 = -sr * sp;
+        g_ref = sqrtf(ax * ax + ay * ay + az * az);
+        fax = ax;
+        fay = ay;
+        faz = az;
+    }
+
+    /**
+     * 6-axis update
+     * @param gx,gy,gz Body rates in rad/s
+     * @param ax,ay,az Specific force, any unit (only its direction and the
+     *                 ratio to the first seen magnitude matter)
+     * @param dt Seconds since the previous update
+     */
+    void update(float gx, float gy, float gz, float ax, float ay, float az, float dt) {
+        float ex = 0.0f, ey = 0.0f, ez = 0.0f;
+        accelError(ax, ay, az, dt, ex, ey, ez);
+        integrate(gx, gy, gz, ex, ey, ez, dt);
+    }
+
+    /** 9-axis update: magnetometer adds the yaw reference */
+    void updateMag(float gx, float gy, float gz, float ax, float ay, float az, float mx, float my, float mz,
+                   float dt) {
+        float ex = 0.0f, ey = 0.0f, ez = 0.0f;
+        accelError(ax, ay, az, dt, ex, ey, ez);
+
+        float norm = mx * mx + my * my + mz * mz;
+        if (norm > 0.0f) {
+            float inv = 1.0f / sqrtf(norm);
+            mx *= inv;
+            my *= inv;
+            mz *= inv;
+            // Field in earth frame, flattened onto north + down components
+            float hx = 2.0f * (mx * (0.5f - q2 * q2 - q3 * q3) + my * (q1 * q2 - q0 * q3) + mz * (q1 * q3 + q0 * q2));
+            float hy = 2.0f * (mx * (q1 * q2 + q0 * q3) + my * (0.5f - q1 * q1 - q3 * q3) + mz * (q2 * q3 - q0 * q1));
+            float bx = sqrtf(hx * hx + hy * hy);
+            float bz = 2.0f * (mx * (q1 * q3 - q0 * q2) + my * (q2 * q3 + q0 * q1) + mz * (0.5f - q1 * q1 - q2 * q2));
+            // Expected field direction in body frame
+            float wx = 2.0f * (bx * (0.5f - q2 * q2 - q3 * q3) + bz * (q1 * q3 - q0 * q2));
+            float wy = 2.0f * (bx * (q1 * q2 - q0 * q3) + bz * (q0 * q1 + q2 * q3));
+            float wz = 2.0f * (bx * (q0 * q2 + q1 * q3) + bz * (0.5f - q1 * q1 - q2 * q2));
+            ex += my * wz - mz * wy;
+            ey += mz * wx - mx * wz;
+            ez += mx * wy - my * wx;
+        }
+        integrate(gx, gy, gz, ex, ey, ez, dt);
+    }
+
+    // ---- Outputs ----
+
+    float roll() const { return atan2f(2.0f * (q0 * q1 + q2 * q3), 1.0f - 2.0f * (q1 * q1 + q2 * q2)); }
+
+    float pitch() const {
+        float s = 2.0f * (q0 * q2 - q3 * q1);
+        if (s > 1.0f) s = 1.0f;
+        if (s < -1.0f) s = -1.0f;
+        return asinf(s);
+    }
+
+    float yaw() const { return atan2f(2.0f * (q0 * q3 + q1 * q2), 1.0f - 2.0f * (q2 * q2 + q3 * q3)); }
+
+    void quaternion(float q[4]) const {
+        q[0] = q0;
+        q[1] = q1;
+        q[2] = q2;
+        q[3] = q3;
+    }
+
+    /** Bias-corrected body rates of the last update, rad/s */
+    float rateX() const { return rate_x; }
+    float rateY() const { return rate_y; }
+    float rateZ() const { return rate_z; }
+
+    /** Seed the bias from a resting calibration (the only yaw-bias source without a magnetometer) */
+    void setGyroBias(float bx, float by, float bz) {
+        bias_x = bx;
+        bias_y = by;
+        bias_z = bz;
+    }
+
+    /** Start-up gain boost finished: roll/pitch are trustworthy */
+    bool converged() const { return elapsed >= BOOST_SECONDS; }
+
+    float biasX() const { return bias_x; }
+    float biasY() const { return bias_y; }
+    float biasZ() const { return bias_z; }
+
+    /**
+     * Vertical (earth z, up) component of a body-frame specific force,
+     * gravity removed - the input for BaroAltitudeFilter
+     * @param g Gravity in the same unit as the accel sample
+     */
+    float verticalAccel(float ax, float ay, float az, float g) const {
+        float up = 2.0f * (q1 * q3 - q0 * q2) * ax + 2.0f * (q2 * q3 + q0 * q1) * ay +
+                   (1.0f - 2.0f * (q1 * q1 + q2 * q2)) * az;
+        return up - g;
+    }
+
+    /** Accel samples ignored because the craft was not in ~1 g flight */
+    unsigned long rejectedAccel() const { return rejected; }
+
+private:
+    float q0, q1, q2, q3;
+    float bias_x, bias_y, bias_z;
+    float rate_x, rate_y, rate_z;
+    float kp_gain, ki_gain, accel_tol;
+    float lpf_tau;
+    float fax, fay, faz;
+    float elapsed;
+    float g_ref;
+    unsigned long rejected;
+
+    void accelError(float ax, float ay, float az, float dt, float& ex, float& ey, float& ez) {
+        if (g_ref <= 0.0f) {
+            fax = ax;
+            fay = ay;
+            faz = az;
+        } else if (lpf_tau > 0.0f && dt > 0.0f) {
+            float k = dt / (dt + lpf_tau);
+            fax += (ax - fax) * k;
+            fay += (ay - fay) * k;
+            faz += (az - faz) * k;
+        } else {
+            fax = ax;
+            fay = ay;
+            faz = az;
+        }
+        ax = fax;
+        ay = fay;
+        az = faz;
+
+        float norm = ax * ax + ay * ay + az * az;
+        if (norm <= 0.0f) return;
+        float mag = sqrtf(norm);
+        if (g_ref <= 0.0f) g_ref = mag;
+        float ratio = mag / g_ref - 1.0f;
+        if (ratio > accel_tol || ratio < -accel_tol) {
+            rejected++;
+            return;
+        }
+        float inv = 1.0f / mag;
+        ax *= inv;
+        ay *= inv;
+        az *= inv;
+        // Gravity ("up" reaction) predicted in body frame
+        float vx = 2.0f * (q1 * q3 - q0 * q2);
+        float vy = 2.0f * (q0 * q1 + q2 * q3);
+        float vz = q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3;
+        ex = ay * vz - az * vy;
+        ey = az * vx - ax * vz;
+        ez = ax * vy - ay * vx;
+    }
+
+    void integrate(float gx, float gy, float gz, float ex, float ey, float ez, float dt) {
+        if (dt <= 0.0f) return;
+        float kp = kp_gain;
+        if (elapsed < BOOST_SECONDS) {
+            elapsed += dt;
+            kp = BOOST_KP;
+        } else {
+            // Bias only after the start-up transient, or it learns the initial error
+            bias_x -= ki_gain * ex * dt;
+            bias_y -= ki_gain * ey * dt;
+            bias_z -= ki_gain * ez * dt;
+        }
+
+        rate_x = gx - bias_x;
+        rate_y = gy - bias_y;
+        rate_z = gz - bias_z;
+        float wx = rate_x + kp * ex;
+        float wy = rate_y + kp * ey;
+        float wz = rate_z + kp * ez;
+
+        float h = 0.5f * dt;
+        float a = q0, b = q1, c = q2;
+        q0 += (-b * wx - c * wy - q3 * wz) * h;
+        q1 += (a * wx + c * wz - q3 * wy) * h;
+        q2 += (a * wy - b * wz + q3 * wx) * h;
+        q3 += (a * wz + b * wy - c * wx) * h;
+
+        float inv = 1.0f / sqrtf(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+        q0 *= inv;
+        q1 *= inv;
+        q2 *= inv;
+        q3 *= inv;
+    }
+};
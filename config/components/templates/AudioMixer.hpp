@@ -0,0 +1,413 @@
+/**
+ * @file AudioMixer.hpp
+ * @brief Fixed-voice priority mixer with ducking, fed by a lock-free command queue
+ *
+ * SUBSYSTEM: any subsystem with i2s_driver (goblin_head speaker first)
+ *
+ * ARCHITECTURE:
+ * - Requesters (speaker, nose, mood...) post Commands with play()/stop():
+ *   bounded multi-producer queue (per-cell sequence numbers), never blocks;
+ *   a full queue drops the request and counts it
+ * - The audio path calls mix() once per block. It drains at most QUEUE
+ *   commands, then renders VOICES sources - bounded work per block
+ * - Voice allocation: free slot, else steal the lowest-priority voice
+ *   (oldest on ties) if the request is at least as important; otherwise
+ *   the request is rejected
+ * - Retrigger dedupe: PLAY of a sound that started less than retrigger_ms
+ *   ago is ignored; an older instance is restarted in place
+ * - admits() previews that dedupe/reject decision on the producer side, from
+ *   a voice table mix() republishes every block (seqlock), so a requester
+ *   can skip expensive preparation (opening a clip file) for a request the
+ *   mixer would drop anyway
+ * - Ducking: voices below the highest active priority are scaled by
+ *   duck_gain. Gain changes ramp linearly across one block (Q8 gain, Q16
+ *   ramp) and new voices fade in from zero, so ducking and starts don't click
+ *
+ * VOICE CONCEPT (template parameter):
+ *   struct Voice {
+ *       struct Request { ... };                       // Trivially copyable payload
+ *       bool start(const Request& r);                  // Take over source, false = unplayable
+ *       size_t render(int16_t* out, size_t count);     // < count when finished
+ *       void stop();
+ *       static void discard(const Request& r);         // Request deduped/rejected, never started
+ *   };
+ *   A Request may own a resource the requester prepared (an open clip file):
+ *   start() takes it over, or releases it itself when it returns false;
+ *   discard() releases it for requests the mixer drops; when play() returns
+ *   false (queue full) the requester still owns it.
+ *
+ * MEMORY:
+ * - VOICES x (sizeof(Voice) + 28) + QUEUE x (sizeof(Request) + 12)
+ *   + MAX_BLOCK x 6 (voice scratch + int32 accumulator)
+ *
+ * TIMING:
+ * - O(QUEUE + VOICES x block) per mix(), one int32 MAC per voice sample
+ *
+ * USAGE:
+ *   static AudioMixer<SpeakerVoice> mixer;
+ *   mixer.play(AudioMixer<SpeakerVoice>::hashName("goblin_hiss"), 50, 256, request);
+ *   mixer.mix(block, 441, now_ms);
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <atomic>
+
+template <typename Voice, size_t VOICES = 4, size_t QUEUE = 16, size_t MAX_BLOCK = 512>
+class AudioMixer {
+    static_assert((QUEUE & (QUEUE - 1)) == 0, "QUEUE must be a power of two");
+
+public:
+    typedef typename Voice::Request Request;
+
+    enum CommandType : uint8_t {
+        CMD_PLAY = 0,
+        CMD_STOP,           // Stop every voice playing sound_id
+        CMD_STOP_ALL
+    };
+
+    struct Command {
+        CommandType type;
+        uint8_t priority;   // 0 = background ... 255 = critical
+        uint16_t gain_x256; // Voice gain before ducking, 256 = unity
+        uint32_t sound_id;  // hashName() of the sound, used for dedupe/stop
+        Request request;
+    };
+
+    struct Stats {
+        uint32_t started;
+        uint32_t deduped;       // Retriggers inside the window
+        uint32_t preempted;     // Voices stolen by a higher/equal priority
+        uint32_t rejected;      // All voices busy with more important sounds
+        uint32_t unplayable;    // Voice::start() refused the request
+        uint32_t max_commands;  // Most commands drained in one block
+    };
+
+    AudioMixer() {
+        for (size_t i = 0; i < QUEUE; i++) cells[i].seq.store((uint32_t)i, std::memory_order_relaxed);
+        memset(&stats, 0, sizeof(stats));
+        for (size_t v = 0; v < VOICES; v++) {
+            slots[v].active = false;
+            slots[v].priority = 0;
+            slots[v].gain = 0;
+            slots[v].current_gain = 0;
+            slots[v].sound_id = 0;
+            slots[v].started_ms = 0;
+            slots[v].serial = 0;
+        }
+    }
+
+    /**
+     * @param duck_gain_x256 Gain of voices below the top priority (256 = no ducking)
+     * @param retrigger_ms Same-sound PLAYs closer than this are ignored
+     */
+    void configure(uint16_t duck_gain_x256, uint16_t retrigger_ms) {
+        duck_gain = duck_gain_x256 > 256 ? 256 : duck_gain_x256;
+        retrigger_window = retrigger_ms;
+    }
+
+    // ---- Producer side (any task/ISR-free context, never blocks) ----
+
+    bool play(uint32_t sound_id, uint8_t priority, uint16_t gain_x256, const Request& request) {
+        Command cmd;
+        cmd.type = CMD_PLAY;
+        cmd.priority = priority;
+        cmd.gain_x256 = gain_x256;
+        cmd.sound_id = sound_id;
+        cmd.request = request;
+        return post(cmd);
+    }
+
+    bool stop(uint32_t sound_id) {
+        Command cmd;
+        memset(&cmd, 0, sizeof(cmd));
+        cmd.type = CMD_STOP;
+        cmd.sound_id = sound_id;
+        return post(cmd);
+    }
+
+    bool stopAll() {
+        Command cmd;
+        memset(&cmd, 0, sizeof(cmd));
+        cmd.type = CMD_STOP_ALL;
+        return post(cmd);
+    }
+
+    /**
+     * Would a PLAY be started if mix() ran now? Same answer as apply() gives
+     * for the voices as of the last block: false for a retrigger inside the
+     * window or when every voice outranks priority. Commands still queued
+     * are not seen, so true is only a hint; a torn read answers true.
+     */
+    bool admits(uint32_t sound_id, uint8_t priority, uint32_t now_ms) const {
+        for (int attempt = 0; attempt < 4; attempt++) {
+            uint32_t seq = view_seq.load(std::memory_order_acquire);
+            if (seq & 1) continue;      // mix() is republishing
+
+            bool free_voice = false;
+            bool dedupe = false;
+            bool outranked = true;
+            for (size_t v = 0; v < VOICES; v++) {
+                const View& w = view[v];
+                if (!w.active.load(std::memory_order_relaxed)) {
+                    free_voice = true;
+                    continue;
+                }
+                if (w.sound_id.load(std::memory_order_relaxed) == sound_id &&
+                    now_ms - w.started_ms.load(std::memory_order_relaxed) < retrigger_window) {
+                    dedupe = true;
+                }
+                if (w.priority.load(std::memory_order_relaxed) <= priority) outranked = false;
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (view_seq.load(std::memory_order_relaxed) != seq) continue;
+            return !dedupe && (free_voice || !outranked);
+        }
+        return true;
+    }
+
+    /** FNV-1a, so requesters can name sounds without sharing an id table */
+    static uint32_t hashName(const char* name) {
+        uint32_t h = 2166136261u;
+        while (name && *name) {
+            h ^= (uint8_t)*name++;
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    // ---- Consumer side (audio path only) ----
+
+    /**
+     * Apply queued commands and render one block (count <= MAX_BLOCK)
+     * @return Number of voices that contributed to the block
+     */
+    size_t mix(int16_t* out, size_t count, uint32_t now_ms) {
+        if (count > MAX_BLOCK) count = MAX_BLOCK;
+
+        Command cmd;
+        uint32_t drained = 0;
+        while (drained < QUEUE && take(cmd)) {
+            apply(cmd, now_ms);
+            drained++;
+        }
+        if (drained > stats.max_commands) stats.max_commands = drained;
+
+        uint8_t top = 0;
+        for (size_t v = 0; v < VOICES; v++) {
+            if (slots[v].active && slots[v].priority > top) top = slots[v].priority;
+        }
+
+        memset(acc, 0, count * sizeof(int32_t));
+        size_t contributing = 0;
+
+        for (size_t v = 0; v < VOICES; v++) {
+            Slot& s = slots[v];
+            if (!s.active) continue;
+
+            size_t got = s.voice.render(scratch, count);
+            uint32_t target = s.priority < top ? (uint32_t)s.gain * duck_gain >> 8 : s.gain;
+            int32_t gain_q16 = (int32_t)s.current_gain << 8;
+            int32_t step_q16 = ((int32_t)target - (int32_t)s.current_gain) * 256 / (int32_t)count;
+            for (size_t i = 0; i < got; i++) {
+                acc[i] += ((int32_t)scratch[i] * (gain_q16 >> 8)) >> 8;
+                gain_q16 += step_q16;
+            }
+            s.current_gain = (uint16_t)target;
+            contributing++;
+
+            if (got < count) {
+                s.voice.stop();
+                s.active = false;
+            }
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            int32_t x = acc[i];
+            out[i] = (int16_t)(x > 32767 ? 32767 : (x < -32768 ? -32768 : x));
+        }
+        publishView();
+        return contributing;
+    }
+
+    size_t activeVoices() const {
+        size_t n = 0;
+        for (size_t v = 0; v < VOICES; v++) n += slots[v].active ? 1 : 0;
+        return n;
+    }
+
+    bool isPlaying(uint32_t sound_id) const {
+        for (size_t v = 0; v < VOICES; v++) {
+            if (slots[v].active && slots[v].sound_id == sound_id) return true;
+        }
+        return false;
+    }
+
+    /** Effective gain after the last block (for tests/telemetry) */
+    uint16_t voiceGain(uint32_t sound_id) const {
+        for (size_t v = 0; v < VOICES; v++) {
+            if (slots[v].active && slots[v].sound_id == sound_id) return slots[v].current_gain;
+        }
+        return 0;
+    }
+
+    const Stats& getStats() const { return stats; }
+
+    /** Producer-side drops (queue full) */
+    uint32_t queueFullCount() const { return queue_full.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        Voice voice;
+        bool active;
+        uint8_t priority;
+        uint16_t gain;
+        uint16_t current_gain;
+        uint32_t sound_id;
+        uint32_t started_ms;
+        uint32_t serial;        // Start order, for oldest-first stealing
+    };
+
+    struct Cell {
+        std::atomic<uint32_t> seq;
+        Command cmd;
+    };
+
+    // Producer-readable copy of the voice table for admits()
+    struct View {
+        std::atomic<bool> active{false};
+        std::atomic<uint8_t> priority{0};
+        std::atomic<uint32_t> sound_id{0};
+        std::atomic<uint32_t> started_ms{0};
+    };
+
+    Slot slots[VOICES];
+    Cell cells[QUEUE];
+    View view[VOICES];
+    std::atomic<uint32_t> view_seq{0};  // Odd while mix() rewrites view
+    std::atomic<uint32_t> enqueue_pos{0};
+    std::atomic<uint32_t> queue_full{0};
+    uint32_t dequeue_pos = 0;
+    uint32_t next_serial = 0;
+    uint16_t duck_gain = 77;            // ~-10 dB
+    uint16_t retrigger_window = 250;
+    int16_t scratch[MAX_BLOCK];
+    int32_t acc[MAX_BLOCK];             // Member, not stack: the audio task stack stays small
+    Stats stats;
+
+    bool post(const Command& cmd) {
+        uint32_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & (QUEUE - 1)];
+            uint32_t seq = cell.seq.load(std::memory_order_acquire);
+            int32_t diff = (int32_t)(seq - pos);
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.cmd = cmd;
+                    cell.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                queue_full.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void publishView() {
+        uint32_t seq = view_seq.load(std::memory_order_relaxed);
+        view_seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t v = 0; v < VOICES; v++) {
+            view[v].active.store(slots[v].active, std::memory_order_relaxed);
+            view[v].priority.store(slots[v].priority, std::memory_order_relaxed);
+            view[v].sound_id.store(slots[v].sound_id, std::memory_order_relaxed);
+            view[v].started_ms.store(slots[v].started_ms, std::memory_order_relaxed);
+        }
+        view_seq.store(seq + 2, std::memory_order_release);
+    }
+
+    bool take(Command& cmd) {
+        Cell& cell = cells[dequeue_pos & (QUEUE - 1)];
+        uint32_t seq = cell.seq.load(std::memory_order_acquire);
+        if ((int32_t)(seq - (dequeue_pos + 1)) < 0) return false;
+        cmd = cell.cmd;
+        cell.seq.store(dequeue_pos + QUEUE, std::memory_order_release);
+        dequeue_pos++;
+        return true;
+    }
+
+    void apply(const Command& cmd, uint32_t now_ms) {
+        if (cmd.type == CMD_STOP_ALL || cmd.type == CMD_STOP) {
+            for (size_t v = 0; v < VOICES; v++) {
+                if (slots[v].active && (cmd.type == CMD_STOP_ALL || slots[v].sound_id == cmd.sound_id)) {
+                    slots[v].voice.stop();
+                    slots[v].active = false;
+                }
+            }
+            return;
+        }
+
+        Slot* target = nullptr;
+        for (size_t v = 0; v < VOICES; v++) {
+            Slot& s = slots[v];
+            if (s.active && s.sound_id == cmd.sound_id) {
+                if (now_ms - s.started_ms < retrigger_window) {
+                    stats.deduped++;
+                    if (cmd.priority > s.priority) s.priority = cmd.priority;
+                    Voice::discard(cmd.request);
+                    return;
+                }
+                target = &s;    // Restart the running instance in place
+                break;
+            }
+        }
+
+        if (!target) {
+            for (size_t v = 0; v < VOICES && !target; v++) {
+                if (!slots[v].active) target = &slots[v];
+            }
+        }
+
+        if (!target) {
+            Slot* victim = &slots[0];
+            for (size_t v = 1; v < VOICES; v++) {
+                Slot& s = slots[v];
+                if (s.priority < victim->priority ||
+                    (s.priority == victim->priority && (int32_t)(s.serial - victim->serial) < 0)) {
+                    victim = &s;
+                }
+            }
+            if (victim->priority > cmd.priority) {
+                stats.rejected++;
+                Voice::discard(cmd.request);
+                return;
+            }
+            stats.preempted++;
+            target = victim;
+        }
+
+        if (target->active) {
+            target->voice.stop();
+            target->active = false;
+        }
+        if (!target->voice.start(cmd.request)) {
+            stats.unplayable++;
+            return;
+        }
+        target->active = true;
+        target->priority = cmd.priority;
+        target->gain = cmd.gain_x256;
+        target->current_gain = 0;       // Fade in over the first block
+        target->sound_id = cmd.sound_id;
+        target->started_ms = now_ms;
+        target->serial = next_serial++;
+        stats.started++;
+    }
+};
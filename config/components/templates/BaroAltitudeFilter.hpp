@@ -0,0 +1,94 @@
+/**
+ * @file BaroAltitudeFilter.hpp
+ * @brief Third-order complementary filter: vertical accel + barometric altitude
+ *
+ * SUBSYSTEM: flying_dragon flight system (flying_dragon_sensor_fusion)
+ *
+ * ARCHITECTURE:
+ * - State: altitude, vertical speed, accel bias
+ * - predict() at IMU rate integrates earth-frame vertical accel (from
+ *   AttitudeEstimator::verticalAccel) minus the bias estimate
+ * - correct() at baro rate feeds the altitude error back with gains from
+ *   one time constant tau (k1 = 3/tau, k2 = 3/tau^2, k3 = 1/tau^3 - a
+ *   triple pole at -1/tau):
+ *     above ~1/tau the accelerometer dominates (no baro noise, no lag)
+ *     below it the barometer dominates (no accel drift)
+ * - Pressure -> altitude via the standard atmosphere, relative to the
+ *   reference pressure captured by setGround()
+ *
+ * MEMORY: 28 bytes, no heap
+ *
+ * TIMING: predict ~6 float ops; correct ~10 float ops + one powf (baro rate)
+ *
+ * USAGE:
+ *   BaroAltitudeFilter alt;
+ *   alt.setGround(pressure_pa);
+ *   alt.predict(az_up_m_s2, dt);                  // every IMU sample
+ *   alt.correct(BaroAltitudeFilter::pressureToAltitude(p, alt.ground()));   // every baro sample
+ */
+
+#pragma once
+
+#include <cmath>
+
+class BaroAltitudeFilter {
+public:
+    BaroAltitudeFilter() {
+        configure(1.5f);
+    }
+
+    /** @param tau_s Crossover time constant between accel and baro */
+    void configure(float tau_s) {
+        if (tau_s < 0.05f) tau_s = 0.05f;
+        k1 = 3.0f / tau_s;
+        k2 = 3.0f / (tau_s * tau_s);
+        k3 = 1.0f / (tau_s * tau_s * tau_s);
+        reset(0.0f);
+    }
+
+    void reset(float altitude_m) {
+        alt = altitude_m;
+        vel = 0.0f;
+        bias = 0.0f;
+        since_correct = 0.0f;
+    }
+
+    void setGround(float pressure_pa) { p0 = pressure_pa; }
+    float ground() const { return p0; }
+
+    /** @param accel_up Earth-frame vertical accel, gravity removed, m/s^2 */
+    void predict(float accel_up, float dt) {
+        if (dt <= 0.0f) return;
+        float a = accel_up - bias;
+        alt += (vel + 0.5f * a * dt) * dt;
+        vel += a * dt;
+        since_correct += dt;
+    }
+
+    /** @param baro_alt_m Barometric altitude; gains scale with the time since the last call */
+    void correct(float baro_alt_m) {
+        float dt = since_correct;
+        since_correct = 0.0f;
+        if (dt <= 0.0f) return;
+        if (dt > 0.1f) dt = 0.1f;   // After a gap, don't over-correct in one step
+        float err = baro_alt_m - alt;
+        alt += k1 * err * dt;
+        vel += k2 * err * dt;
+        bias -= k3 * err * dt;
+    }
+
+    float altitude() const { return alt; }
+    float verticalSpeed() const { return vel; }
+    float accelBias() const { return bias; }
+
+    /** International standard atmosphere, metres above the reference pressure */
+    static float pressureToAltitude(float pressure_pa, float reference_pa) {
+        return 44330.0f * (1.0f - powf(pressure_pa / reference_pa, 0.190295f));
+    }
+
+private:
+    float k1, k2, k3;
+    float alt, vel, bias;
+    float since_correct;
+    float p0 = 101325.0f;
+};
@@ -0,0 +1,174 @@
+/**
+ * @file BatteryEstimator.hpp
+ * @brief Oversampled ADC decimation plus LiPo voltage / current / state-of-charge estimation
+ *
+ * SUBSYSTEM: flying_dragon power system (flying_dragon_power_system)
+ *
+ * ARCHITECTURE:
+ * - AdcOversampler accumulates raw conversions from the continuous-mode
+ *   DMA frames and hands back their mean once per estimator step. N
+ *   samples of a signal with ~1 LSB of noise buy log4(N) extra bits: 100
+ *   samples per channel per 10 ms step turn the 12-bit ADC into ~15 bits
+ *   and take the white noise down by 10x before any filtering
+ * - BatteryEstimator runs at the step rate on calibrated pack volts and
+ *   amps:
+ *     first-order low-pass on both (tau ~0.5 s, rejects ESC ripple)
+ *     coulomb counting integrates the current into consumed mAh / SoC
+ *     open-circuit voltage = loaded voltage + I * R_internal; the LiPo
+ *     OCV curve turns it into a second SoC reading that pulls the coulomb
+ *     count back slowly. The pull is strongest at rest (where OCV is
+ *     trustworthy) and weak under load (where R_internal error dominates)
+ * - The first update() seeds SoC from the OCV curve, so a part-charged
+ *   pack starts at the right place
+ *
+ * MEMORY: ~48 bytes + 11-entry OCV table in flash, no heap
+ *
+ * TIMING: ~30 float ops per update(); add() is one add and one increment
+ *
+ * USAGE:
+ *   AdcOversampler v_raw;
+ *   v_raw.add(sample);                                  // every DMA sample
+ *   BatteryEstimator batt;
+ *   batt.configure(4, 5000.0f, 0.030f);
+ *   batt.update(pack_v, pack_a, 0.01f);                 // every 10 ms
+ *   float soc = batt.soc();
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+
+class AdcOversampler {
+public:
+    AdcOversampler() : sum(0), n(0) {}
+
+    void add(uint16_t raw) {
+        sum += raw;
+        n++;
+    }
+
+    uint32_t count() const { return n; }
+
+    /** Mean of the samples since the last take(), in raw counts with fractional bits; NaN if none */
+    float take() {
+        float mean = n ? (float)sum / (float)n : NAN;
+        sum = 0;
+        n = 0;
+        return mean;
+    }
+
+private:
+    uint32_t sum;
+    uint32_t n;
+};
+
+class BatteryEstimator {
+public:
+    static constexpr int OCV_POINTS = 11;
+
+    BatteryEstimator() {
+        configure(4, 5000.0f, 0.030f);
+    }
+
+    /**
+     * @param cells Series cell count
+     * @param capacity_mah Rated capacity
+     * @param r_internal_ohm Pack internal resistance (sag compensation)
+     * @param tau_s Low-pass time constant on volts and amps
+     * @param ocv_gain_per_s How fast the OCV reading corrects the coulomb count at rest
+     */
+    void configure(uint8_t cells, float capacity_mah, float r_internal_ohm, float tau_s = 0.5f, float ocv_gain_per_s = 0.05f) {
+        cell_count = cells ? cells : 1;
+        capacity = capacity_mah;
+        r_internal = r_internal_ohm;
+        tau = tau_s > 0.0f ? tau_s : 0.0f;
+        ocv_gain = ocv_gain_per_s;
+        reset();
+    }
+
+    void reset() {
+        v_filt = 0.0f;
+        i_filt = 0.0f;
+        soc_est = 1.0f;
+        consumed_mah = 0.0f;
+        seeded = false;
+    }
+
+    /**
+     * @param pack_v Calibrated pack voltage (NaN skips the step)
+     * @param current_a Calibrated pack current, positive = discharge
+     * @param dt Step period, seconds
+     */
+    void update(float pack_v, float current_a, float dt) {
+        if (!(pack_v == pack_v) || !(current_a == current_a) || dt <= 0.0f) return;
+
+        if (!seeded) {
+            v_filt = pack_v;
+            i_filt = current_a;
+            soc_est = socFromCellOcv(openCircuitPerCell());
+            seeded = true;
+            return;
+        }
+
+        float a = tau > 0.0f ? dt / (tau + dt) : 1.0f;
+        v_filt += a * (pack_v - v_filt);
+        i_filt += a * (current_a - i_filt);
+
+        // Coulomb count on the raw current: the filter must not lose charge
+        float mah = current_a * dt * (1000.0f / 3600.0f);
+        consumed_mah += mah;
+        soc_est -= mah / capacity;
+
+        // Pull towards the OCV reading, weighted by how much we trust it
+        float trust = 1.0f / (1.0f + fabsf(i_filt) / REST_CURRENT_A);
+        float k = ocv_gain * dt * trust;
+        if (k > 1.0f) k = 1.0f;
+        soc_est += k * (socFromCellOcv(openCircuitPerCell()) - soc_est);
+
+        if (soc_est < 0.0f) soc_est = 0.0f;
+        if (soc_est > 1.0f) soc_est = 1.0f;
+    }
+
+    bool valid() const { return seeded; }
+    float voltage() const { return v_filt; }
+    float current() const { return i_filt; }
+    float soc() const { return soc_est; }
+    float consumedMah() const { return consumed_mah; }
+    float cellVoltage() const { return v_filt / cell_count; }
+    float openCircuitPerCell() const { return (v_filt + i_filt * r_internal) / cell_count; }
+
+    /** Seconds to empty at the present draw (infinite when charging or idle) */
+    float remainingS() const {
+        if (i_filt <= 0.01f) return INFINITY;
+        return soc_est * capacity * 3.6f / i_filt;
+    }
+
+    /** Resting LiPo cell voltage -> state of charge 0..1 */
+    static float socFromCellOcv(float cell_v) {
+        static const float OCV[OCV_POINTS] = {
+            3.27f, 3.69f, 3.73f, 3.77f, 3.80f, 3.84f, 3.87f, 3.95f, 4.02f, 4.11f, 4.20f
+        };
+        if (cell_v <= OCV[0]) return 0.0f;
+        if (cell_v >= OCV[OCV_POINTS - 1]) return 1.0f;
+        int i = 1;
+        while (cell_v > OCV[i]) i++;
+        float f = (cell_v - OCV[i - 1]) / (OCV[i] - OCV[i - 1]);
+        return ((float)(i - 1) + f) / (float)(OCV_POINTS - 1);
+    }
+
+private:
+    static constexpr float REST_CURRENT_A = 0.5f;   // Below this the pack counts as resting
+
+    uint8_t cell_count;
+    float capacity;
+    float r_internal;
+    float tau;
+    float ocv_gain;
+
+    float v_filt;
+    float i_filt;
+    float soc_est;
+    float consumed_mah;
+    bool seeded;
+};
@@ -0,0 +1,196 @@
+/**
+ * @file BehaviorMachine.hpp
+ * @brief Table-driven behavior state machine over compiled transition tables
+ *
+ * SUBSYSTEM: flying_dragon (flying_dragon_behavior_sequencer), any component
+ *            with a "behavior" block in its JSON
+ *
+ * ARCHITECTURE:
+ * - Behaviors are authored in the component JSON ("behavior": facts,
+ *   outputs, states, transitions with "when" guards and hold_ms) and
+ *   compiled by tools/generate_tables.py into <component>_behavior.hpp:
+ *   dense const arrays of States, Transitions, Guards and per-state
+ *   outputs plus enums for state, fact and output indices. No names are
+ *   looked up at runtime
+ * - The caller samples shared state into one int16 fact array (mood
+ *   components, presence, power level, altitude in dm...) and calls tick()
+ *   at a fixed period
+ * - A state's transitions are one contiguous slice of the transition
+ *   array in authoring order; a transition's guards are one contiguous
+ *   slice of the guard array and are AND-ed (author OR as two rows).
+ *   tick() evaluates only the current state's slice
+ * - A transition fires once its guards have held continuously for hold_ms
+ *   (a guard-free row is a timeout measured from state entry). The first
+ *   row in table order whose hold has elapsed wins; at most one transition
+ *   per tick
+ * - Latency bookkeeping like SafetyMonitor: fired - onset - hold_ms is the
+ *   machine's own reaction delay, bounded by one tick period
+ *
+ * MEMORY: MAX_OUT x 4 bytes + 32, no heap. Tables live in flash
+ *
+ * TIMING: tick() = guards of the current state's transitions, one compare
+ *         each; no strings, no virtual calls, no allocation
+ *
+ * USAGE:
+ *   namespace fsm = flying_dragon_behavior_sequencer_behavior;  // generated
+ *   static BehaviorMachine machine;
+ *   machine.configure(&fsm::table, now_ms);
+ *   facts[fsm::FACT_PRESENCE] = fusion->presence;
+ *   BehaviorMachine::Result r = machine.tick(facts, now_ms);   // 50 Hz
+ *   if (r.changed) apply(machine.output(fsm::OUT_INTENSITY));
+ */
+
+#pragma once
+
+#include <cstdint>
+
+class BehaviorMachine {
+public:
+    static constexpr uint8_t MAX_OUT = 16;             // Transitions out of one state
+
+    enum Op : uint8_t { OP_LT = 0, OP_LE, OP_GT, OP_GE, OP_EQ, OP_NE };
+
+    struct Guard {
+        uint8_t fact;
+        uint8_t op;
+        int16_t value;
+    };
+
+    struct Transition {
+        uint16_t first_guard;
+        uint8_t guard_count;
+        uint8_t to;
+        uint16_t hold_ms;
+    };
+
+    struct State {
+        uint16_t first_transition;
+        uint8_t transition_count;
+    };
+
+    struct Table {
+        const State* states;
+        const Transition* transitions;
+        const Guard* guards;
+        const int16_t* outputs;         // state_count x output_count, row per state
+        const char* const* names;       // For logs only
+        uint8_t state_count;
+        uint8_t fact_count;
+        uint8_t output_count;
+        uint8_t initial;
+    };
+
+    struct Result {
+        bool changed;
+        uint8_t from;
+        uint8_t to;
+        uint32_t onset_ms;              // When the winning guards first held
+    };
+
+    BehaviorMachine() : table(nullptr) { configure(nullptr, 0); }
+
+    void configure(const Table* compiled, uint32_t now_ms) {
+        table = compiled;
+        transition_count = 0;
+        worst_delay_ms = 0;
+        reset(now_ms);
+    }
+
+    /** Back to the initial state (keeps the statistics) */
+    void reset(uint32_t now_ms) {
+        uint8_t initial = table ? table->initial : 0;
+        current = initial;
+        last = initial;
+        enter(now_ms);
+    }
+
+    /**
+     * @param facts One value per fact of the compiled table
+     * @param now_ms Monotonic time of this tick
+     */
+    Result tick(const int16_t* facts, uint32_t now_ms) {
+        Result res = {false, current, current, 0};
+        if (!table) return res;
+
+        const State& s = table->states[current];
+        const Transition* rows = table->transitions + s.first_transition;
+        uint8_t count = s.transition_count > MAX_OUT ? MAX_OUT : s.transition_count;
+        for (uint8_t i = 0; i < count; i++) {
+            const Transition& t = rows[i];
+            uint16_t bit = (uint16_t)(1u << i);
+            if (!guardsHold(t, facts)) {
+                holding &= (uint16_t)~bit;
+                continue;
+            }
+            if (!(holding & bit)) {
+                holding |= bit;
+                onset[i] = t.guard_count ? now_ms : entered_ms;
+            }
+            if (now_ms - onset[i] < t.hold_ms) continue;
+
+            uint32_t delay = now_ms - onset[i] - t.hold_ms;
+            if (delay > worst_delay_ms) worst_delay_ms = delay;
+            res.changed = true;
+            res.to = t.to;
+            res.onset_ms = onset[i];
+            last = current;
+            current = t.to;
+            transition_count++;
+            enter(now_ms);
+            break;
+        }
+        return res;
+    }
+
+    uint8_t state() const { return current; }
+    uint8_t previous() const { return last; }
+    uint32_t enteredAt() const { return entered_ms; }
+    uint32_t timeInState(uint32_t now_ms) const { return now_ms - entered_ms; }
+
+    /** Compiled per-state output k for the current state */
+    int16_t output(uint8_t k) const {
+        if (!table || k >= table->output_count) return 0;
+        return table->outputs[current * table->output_count + k];
+    }
+
+    const char* stateName(uint8_t s) const {
+        return table && table->names && s < table->state_count ? table->names[s] : "?";
+    }
+
+    uint32_t transitions() const { return transition_count; }
+    /** Worst observed fired - onset - hold, milliseconds */
+    uint32_t worstDelayMs() const { return worst_delay_ms; }
+
+private:
+    const Table* table;
+    uint8_t current;
+    uint8_t last;
+    uint16_t holding;                   // Bit i: row i's guards are true
+    uint32_t entered_ms;
+    uint32_t onset[MAX_OUT];
+    uint32_t transition_count;
+    uint32_t worst_delay_ms;
+
+    void enter(uint32_t now_ms) {
+        entered_ms = now_ms;
+        holding = 0;
+    }
+
+    bool guardsHold(const Transition& t, const int16_t* facts) const {
+        const Guard* g = table->guards + t.first_guard;
+        for (uint8_t k = 0; k < t.guard_count; k++) {
+            int16_t v = facts[g[k].fact];
+            bool ok;
+            switch (g[k].op) {
+                case OP_LT: ok = v < g[k].value; break;
+                case OP_LE: ok = v <= g[k].value; break;
+                case OP_GT: ok = v > g[k].value; break;
+                case OP_GE: ok = v >= g[k].value; break;
+                case OP_EQ: ok = v == g[k].value; break;
+                default: ok = v != g[k].value; break;
+            }
+            if (!ok) return false;
+        }
+        return true;
+    }
+};
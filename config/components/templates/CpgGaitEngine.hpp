@@ -0,0 +1,300 @@
+/**
+ * @file CpgGaitEngine.hpp
+ * @brief Phase-oscillator gait generator over precomputed spline tables
+ *
+ * SUBSYSTEM: legged locomotion (flying_dragon_leg_assembly)
+ *
+ * ARCHITECTURE:
+ * - One phase oscillator per leg (central pattern generator). Phases are
+ *   uint32 turns (2^32 = one cycle, wraps for free) and advance by
+ *       dphi_i = omega + K/L * sum_j sin(2 pi (phi_j - phi_i - (off_j - off_i)))
+ *   so the legs pull each other onto the gait's phase offsets (walking
+ *   anti-phase, jumping in phase) and re-lock smoothly after a gait change
+ *   or a disturbance instead of jumping. sin() is a 256-entry table
+ * - omega slews toward gait frequency x speed factor at a bounded rate, so
+ *   speed changes never step the phase velocity
+ * - Each gait is a periodic joint trajectory per joint, given as
+ *   SEGMENTS knots per cycle and turned once, at setGait(), into cubic
+ *   coefficients per segment (uniform periodic Catmull-Rom: passes through
+ *   every knot, C1 across segments). Coefficients are int16 in 1/64 deg,
+ *   512 bytes per gait for 4 joints
+ * - tick() per joint: top bits of the phase pick the segment, the next 15
+ *   bits are the in-segment fraction, one 3-multiply Horner pass gives the
+ *   angle. No float, no trig
+ * - Gait changes blend by offset decay: at the switch the engine records
+ *   (present output - new gait output) per joint and fades that offset out
+ *   over the blend time with a smoothstep, so the pose is continuous even
+ *   when a switch lands in the middle of another blend. While blending the
+ *   cost per joint is one extra multiply
+ * - Outputs are clamped to per-joint limits (spline overshoot near sharp
+ *   knots stays inside the servo range)
+ *
+ * MEMORY: GAITS x JOINTS x SEGMENTS x 8 bytes of tables (2 KB for
+ *         4 gaits x 4 joints x 16 segments) + ~40 bytes per leg
+ *
+ * TIMING:
+ *   tick(): LEGS x (LEGS-1) sine lookups + LEGS x JOINTS x (table read +
+ *   3 multiplies), integer only
+ *   setGait(): float, once per gait at init
+ *
+ * USAGE:
+ *   CpgGaitEngine<2, 4> gait;
+ *   gait.configure(50, 2.0f);                         // 50 Hz ticks, K = 2 Hz
+ *   gait.setGait(WALK, walk_knots, 0.833f, walk_phase_offsets);
+ *   gait.select(WALK, 1.0f, 0.5f);                    // blend in over 0.5 s
+ *   every tick: gait.tick(); servo(leg, j) = gait.angle(leg, j)
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+
+template<uint8_t LEGS, uint8_t JOINTS, uint8_t GAITS = 4>
+class CpgGaitEngine {
+public:
+    static constexpr uint8_t SEGMENTS = 16;             // Knots per cycle (power of 2)
+    static constexpr uint8_t SEGMENT_SHIFT = 28;        // 32 - log2(SEGMENTS)
+    static constexpr int32_t Q = 64;                    // Angle unit: 1/64 degree
+    static constexpr int32_t FRAC_ONE = 32768;          // In-segment fraction, Q15
+    static constexpr int32_t COEF_MAX = 16383;          // Keeps Horner partial sums in int32
+    static constexpr uint32_t PHASE_NUDGE = 1u << 26;   // 1/64 turn
+
+    CpgGaitEngine() { configure(50, 2.0f); }
+
+    /**
+     * @param tick_hz Rate tick() is called at
+     * @param coupling_hz Phase coupling strength K (higher = faster re-lock)
+     */
+    void configure(uint32_t tick_hz, float coupling_hz) {
+        hz = tick_hz > 0 ? (float)tick_hz : 1.0f;
+        k_q32 = (int64_t)(coupling_hz / hz / LEGS * 4294967296.0);
+        // Frequency slew: reach a new speed within about half a second
+        omega_slew_q32 = (uint32_t)(2.0f / (hz * hz) * 4294967296.0);
+        if (omega_slew_q32 == 0) omega_slew_q32 = 1;
+        for (uint16_t i = 0; i < 256; i++) {
+            sine[i] = (int16_t)lroundf(32767.0f * sinf(2.0f * (float)M_PI * i / 256.0f));
+        }
+        for (uint8_t j = 0; j < JOINTS; j++) {
+            lim_lo[j] = -32768;
+            lim_hi[j] = 32767;
+        }
+        for (uint8_t g = 0; g < GAITS; g++) {
+            gait_hz[g] = 0.0f;
+            defined[g] = false;
+            for (uint8_t l = 0; l < LEGS; l++) offset[g][l] = 0;
+        }
+        for (uint8_t l = 0; l < LEGS; l++) {
+            phi[l] = 0;
+            for (uint8_t j = 0; j < JOINTS; j++) out[l][j] = 0;
+        }
+        for (uint8_t j = 0; j < JOINTS; j++)
+            for (uint8_t l = 0; l < LEGS; l++) blend_offset[l][j] = 0;
+        active = 0;
+        omega = omega_target = 0;
+        blend_ticks = blend_total = 0;
+        speed = 1.0f;
+    }
+
+    /** Clamp a joint's output, degrees */
+    void setJointLimits(uint8_t joint, float min_deg, float max_deg) {
+        if (joint >= JOINTS) return;
+        lim_lo[joint] = toQ(min_deg);
+        lim_hi[joint] = toQ(max_deg);
+    }
+
+    /**
+     * Define a gait
+     * @param knots_deg  [JOINTS][SEGMENTS] angles at phase k / SEGMENTS
+     * @param cycle_hz   Cycles per second at speed factor 1
+     * @param phase_offset Per leg, cycles (0.5 = anti-phase)
+     * @return false if a coefficient exceeds COEF_MAX (+-256 deg) and was clipped
+     */
+    bool setGait(uint8_t gait, const float knots_deg[][SEGMENTS], float cycle_hz,
+                 const float* phase_offset) {
+        if (gait >= GAITS) return false;
+        bool fits = true;
+        for (uint8_t j = 0; j < JOINTS; j++) {
+            const float* p = knots_deg[j];
+            for (uint8_t s = 0; s < SEGMENTS; s++) {
+                // Catmull-Rom through p[s-1], p[s], p[s+1], p[s+2] (periodic)
+                float p0 = p[(s + SEGMENTS - 1) % SEGMENTS];
+                float p1 = p[s];
+                float p2 = p[(s + 1) % SEGMENTS];
+                float p3 = p[(s + 2) % SEGMENTS];
+                float c[4] = {
+                    p1,
+                    0.5f * (p2 - p0),
+                    p0 - 2.5f * p1 + 2.0f * p2 - 0.5f * p3,
+                    0.5f * (p3 - p0) + 1.5f * (p1 - p2)
+                };
+                for (uint8_t k = 0; k < 4; k++) {
+                    int32_t v = toQ(c[k]);
+                    if (v > COEF_MAX || v < -COEF_MAX) {
+                        fits = false;
+                        v = v > 0 ? COEF_MAX : -COEF_MAX;
+                    }
+                    coef[gait][j][s][k] = (int16_t)v;
+                }
+            }
+        }
+        gait_hz[gait] = cycle_hz > 0.0f ? cycle_hz : 0.0f;
+        for (uint8_t l = 0; l < LEGS; l++) {
+            float o = phase_offset ? phase_offset[l] : 0.0f;
+            o -= floorf(o);
+            offset[gait][l] = (uint32_t)(o * 4294967296.0);
+        }
+        defined[gait] = true;
+        return fits;
+    }
+
+    /**
+     * Switch gait and/or speed
+     * @param speed_factor Multiplies the gait's cycle frequency
+     * @param blend_s Time to fade from the present pose into the new gait
+     */
+    void select(uint8_t gait, float speed_factor, float blend_s) {
+        if (gait >= GAITS || !defined[gait]) return;
+        speed = speed_factor > 0.0f ? speed_factor : 0.0f;
+        omega_target = (uint32_t)(gait_hz[gait] * speed / hz * 4294967296.0);
+        if (gait == active && blend_ticks == 0) return;
+
+        // Legs exactly half a turn from their new spacing sit on the
+        // coupling's unstable point (walk -> jump): nudge the followers off it
+        for (uint8_t l = 1; l < LEGS; l++) {
+            if (offset[gait][l] - offset[gait][0] != offset[active][l] - offset[active][0])
+                phi[l] += PHASE_NUDGE;
+        }
+
+        // Whatever the legs are doing now is where the new gait starts from
+        active = gait;
+        for (uint8_t l = 0; l < LEGS; l++) {
+            for (uint8_t j = 0; j < JOINTS; j++) {
+                blend_offset[l][j] = out[l][j] - sample(active, j, phi[l]);
+            }
+        }
+        blend_total = (uint32_t)(blend_s * hz);
+        if (blend_total < 1) blend_total = 1;
+        blend_ticks = blend_total;
+    }
+
+    void setSpeed(float speed_factor) {
+        speed = speed_factor > 0.0f ? speed_factor : 0.0f;
+        omega_target = (uint32_t)(gait_hz[active] * speed / hz * 4294967296.0);
+    }
+
+    /** Jump to a gait with no blend and phases on their offsets (start-up) */
+    void reset(uint8_t gait, float speed_factor) {
+        if (gait >= GAITS) return;
+        active = gait;
+        speed = speed_factor > 0.0f ? speed_factor : 0.0f;
+        omega = omega_target = (uint32_t)(gait_hz[gait] * speed / hz * 4294967296.0);
+        blend_ticks = 0;
+        for (uint8_t l = 0; l < LEGS; l++) {
+            phi[l] = offset[gait][l];
+            for (uint8_t j = 0; j < JOINTS; j++) {
+                blend_offset[l][j] = 0;
+                out[l][j] = clampJoint(j, sample(gait, j, phi[l]));
+            }
+        }
+    }
+
+    /** Advance one tick */
+    void tick() {
+        // Frequency slews toward the target
+        if (omega < omega_target) {
+            omega = (omega_target - omega > omega_slew_q32) ? omega + omega_slew_q32 : omega_target;
+        } else if (omega > omega_target) {
+            omega = (omega - omega_target > omega_slew_q32) ? omega - omega_slew_q32 : omega_target;
+        }
+
+        // Coupled phase oscillators
+        uint32_t next[LEGS];
+        for (uint8_t i = 0; i < LEGS; i++) {
+            int64_t pull = 0;
+            for (uint8_t j = 0; j < LEGS; j++) {
+                if (j == i) continue;
+                uint32_t d = (phi[j] - phi[i]) - (offset[active][j] - offset[active][i]);
+                pull += sine[d >> 24];
+            }
+            next[i] = phi[i] + omega + (uint32_t)(int32_t)((pull * k_q32) >> 15);
+        }
+        for (uint8_t i = 0; i < LEGS; i++) phi[i] = next[i];
+
+        // Blend weight of the recorded offset: smoothstep from 1 to 0
+        int32_t keep = 0;                               // Q15
+        if (blend_ticks > 0) {
+            blend_ticks--;
+            int32_t u = (int32_t)(((uint64_t)blend_ticks << 15) / blend_total);
+            keep = (int32_t)(((int64_t)u * u >> 15) * (3 * FRAC_ONE - 2 * u) >> 15);
+        }
+
+        for (uint8_t l = 0; l < LEGS; l++) {
+            for (uint8_t j = 0; j < JOINTS; j++) {
+                int32_t v = sample(active, j, phi[l]);
+                if (keep) v += (blend_offset[l][j] * keep) >> 15;
+                out[l][j] = clampJoint(j, v);
+            }
+        }
+    }
+
+    /** Joint angle, 1/64 degree */
+    int32_t angleQ(uint8_t leg, uint8_t joint) const {
+        return (leg < LEGS && joint < JOINTS) ? out[leg][joint] : 0;
+    }
+
+    /** Joint angle, degrees */
+    float angle(uint8_t leg, uint8_t joint) const { return (float)angleQ(leg, joint) / Q; }
+
+    /** Leg phase, cycles 0..1 */
+    float phase(uint8_t leg) const { return leg < LEGS ? (float)phi[leg] / 4294967296.0f : 0.0f; }
+
+    /** Phase of a leg relative to leg 0, cycles 0..1 */
+    float relativePhase(uint8_t leg) const {
+        return leg < LEGS ? (float)(uint32_t)(phi[leg] - phi[0]) / 4294967296.0f : 0.0f;
+    }
+
+    /** Present cycle frequency, Hz */
+    float frequency() const { return (float)omega * hz / 4294967296.0f; }
+
+    uint8_t gait() const { return active; }
+    bool isBlending() const { return blend_ticks > 0; }
+
+private:
+    float hz;
+    float speed;
+    float gait_hz[GAITS];
+    bool defined[GAITS];
+    int16_t coef[GAITS][JOINTS][SEGMENTS][4];
+    uint32_t offset[GAITS][LEGS];
+    int16_t sine[256];
+    int32_t lim_lo[JOINTS];
+    int32_t lim_hi[JOINTS];
+    int64_t k_q32;
+    uint32_t omega;
+    uint32_t omega_target;
+    uint32_t omega_slew_q32;
+    uint32_t phi[LEGS];
+    int32_t out[LEGS][JOINTS];
+    int32_t blend_offset[LEGS][JOINTS];
+    uint32_t blend_ticks;
+    uint32_t blend_total;
+    uint8_t active;
+
+    static int32_t toQ(float deg) { return (int32_t)lroundf(deg * Q); }
+
+    int32_t clampJoint(uint8_t j, int32_t v) const {
+        return v < lim_lo[j] ? lim_lo[j] : (v > lim_hi[j] ? lim_hi[j] : v);
+    }
+
+    // Table lookup + Horner: segment from the top bits, Q15 fraction below
+    int32_t sample(uint8_t gait, uint8_t joint, uint32_t phase) const {
+        const int16_t* c = coef[gait][joint][phase >> SEGMENT_SHIFT];
+        int32_t t = (int32_t)((phase >> (SEGMENT_SHIFT - 15)) & (FRAC_ONE - 1));
+        int32_t v = c[3];
+        v = ((v * t) >> 15) + c[2];
+        v = ((v * t) >> 15) + c[1];
+        v = ((v * t) >> 15) + c[0];
+        return v;
+    }
+};
@@ -0,0 +1,304 @@
+/**
+ * @file EyeAnimLibrary.hpp
+ * @brief Compressed RGB565 eye animation library, decoded one display band at a time
+ *
+ * SUBSYSTEM: goblin_head (goblin_left_eye), any GC9A01 eye display
+ *
+ * ARCHITECTURE:
+ * - Library format "P32E" (written by tools/eye_anim_encode.py):
+ *     16-byte header: "P32E", u16 width, u16 height, u16 band_rows,
+ *                     u16 frame_count, u8 animation_count, u8 version (1),
+ *                     u16 reserved
+ *     animation table: per animation u16 first_frame, u16 frame_count,
+ *                      u16 delay_loops, u16 reserved
+ *     band index: per frame, per band u32 offset, u32 bytes (offsets into
+ *                 the band data that follows the index)
+ *     band data
+ * - A band is band_rows full rows (the chunk the SPI path sends). Each band
+ *   is an independent byte stream, so any band of any frame decodes
+ *   straight into the caller's band buffer with no reference frame
+ * - Inter-frame redundancy: eye frames mostly differ in a few bands (lids,
+ *   pupil), so the encoder stores identical bands once and the index of
+ *   every frame points at the shared copy
+ * - Intra-band ops, QOI-style on RGB565 (state reset per band: previous
+ *   pixel 0, 64-entry colour cache cleared):
+ *     00iiiiii            INDEX   cache[i]
+ *     01rrggbb            DIFF    previous + (r-2, g-2, b-2) channel steps
+ *     10nnnnnn            RUN     previous x (n + 1), 1..64
+ *     11hhhhhh llllllll   LONG    previous x (h << 8 | l) + 65, h < 0x3F
+ *     11111111 lo hi      LITERAL RGB565
+ *   Every non-run pixel is stored at cache[(r*3 + g*5 + b*7) & 63]
+ * - Data is memory-mapped (PSRAM copy of the file or esp_partition_mmap);
+ *   every read is bounds-checked and a band must decode to exactly its
+ *   pixel count
+ *
+ * MEMORY: ~40 bytes + the caller's band buffer (width x band_rows x 2)
+ *
+ * TIMING: one branch and one store per pixel, runs are a fill loop; well
+ *         ahead of the ~10 MB/s an 80 MHz SPI bus drains
+ *
+ * USAGE:
+ *   static EyeAnimLibrary eyes;
+ *   if (eyes.open(psram_copy, size) == EyeAnimLibrary::OK) {
+ *       for (uint16_t b = 0; b < eyes.bands(); b++) {
+ *           eyes.decodeBand(frame, b, band_buffer);   // then send the band
+ *       }
+ *   }
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+class EyeAnimLibrary {
+public:
+    static constexpr size_t HEADER_BYTES = 16;
+    static constexpr size_t ANIMATION_BYTES = 8;
+    static constexpr size_t INDEX_ENTRY_BYTES = 8;
+    static constexpr uint8_t FORMAT_VERSION = 1;
+
+    static constexpr uint8_t OP_INDEX = 0x00;
+    static constexpr uint8_t OP_DIFF = 0x40;
+    static constexpr uint8_t OP_RUN = 0x80;
+    static constexpr uint8_t OP_LONG_RUN = 0xC0;
+    static constexpr uint8_t OP_LITERAL = 0xFF;
+    static constexpr uint32_t MAX_LONG_RUN = (0x3E << 8 | 0xFF) + 65;
+
+    enum Result : uint8_t {
+        OK = 0,
+        ERR_FORMAT,         // Magic/version mismatch or header out of range
+        ERR_SIZE,           // Tables or band data past the end of the data
+        ERR_RANGE,          // Frame or band out of range
+        ERR_CORRUPT         // Band stream overruns or underfills its pixels
+    };
+
+    struct Animation {
+        uint16_t first_frame;
+        uint16_t frame_count;
+        uint16_t delay_loops;
+    };
+
+    EyeAnimLibrary() { close(); }
+
+    Result open(const uint8_t* library, size_t size) {
+        close();
+        if (!library || size < HEADER_BYTES) return ERR_SIZE;
+        if (library[0] != 'P' || library[1] != '3' || library[2] != '2' || library[3] != 'E' ||
+            library[13] != FORMAT_VERSION) {
+            return ERR_FORMAT;
+        }
+        uint16_t w = readU16(library + 4);
+        uint16_t h = readU16(library + 6);
+        uint16_t rows = readU16(library + 8);
+        uint16_t frames = readU16(library + 10);
+        uint8_t anims = library[12];
+        if (w == 0 || h == 0 || rows == 0 || rows > h || frames == 0) return ERR_FORMAT;
+
+        uint32_t band_count = (h + rows - 1u) / rows;
+        size_t tables = HEADER_BYTES + (size_t)anims * ANIMATION_BYTES +
+                        (size_t)frames * band_count * INDEX_ENTRY_BYTES;
+        if (tables > size) return ERR_SIZE;
+
+        for (uint8_t a = 0; a < anims; a++) {
+            const uint8_t* p = library + HEADER_BYTES + a * ANIMATION_BYTES;
+            if ((uint32_t)readU16(p) + readU16(p + 2) > frames) return ERR_FORMAT;
+        }
+
+        data = library;
+        data_size = size;
+        width_px = w;
+        height_px = h;
+        band_rows = rows;
+        band_count_ = (uint16_t)band_count;
+        frame_count_ = frames;
+        animation_count_ = anims;
+        index = library + HEADER_BYTES + anims * ANIMATION_BYTES;
+        bands_base = (uint32_t)tables;
+        return OK;
+    }
+
+    void close() {
+        data = nullptr;
+        data_size = 0;
+        index = nullptr;
+        bands_base = 0;
+        width_px = 0;
+        height_px = 0;
+        band_rows = 0;
+        band_count_ = 0;
+        frame_count_ = 0;
+        animation_count_ = 0;
+    }
+
+    bool isOpen() const { return data != nullptr; }
+    uint16_t width() const { return width_px; }
+    uint16_t height() const { return height_px; }
+    uint16_t bandRows() const { return band_rows; }
+    uint16_t bands() const { return band_count_; }
+    uint16_t frameCount() const { return frame_count_; }
+    uint8_t animationCount() const { return animation_count_; }
+
+    /** Rows in band b (the last band may be short) */
+    uint16_t rowsInBand(uint16_t b) const {
+        uint32_t start = (uint32_t)b * band_rows;
+        return (uint16_t)(start + band_rows > height_px ? height_px - start : band_rows);
+    }
+
+    Animation animation(uint8_t a) const {
+        Animation anim = {0, 0, 0};
+        if (!data || a >= animation_count_) return anim;
+        const uint8_t* p = data + HEADER_BYTES + a * ANIMATION_BYTES;
+        anim.first_frame = readU16(p);
+        anim.frame_count = readU16(p + 2);
+        anim.delay_loops = readU16(p + 4);
+        return anim;
+    }
+
+    /** Compressed bytes of one band (shared bands count for every frame) */
+    uint32_t bandBytes(uint16_t frame, uint16_t b) const {
+        if (!data || frame >= frame_count_ || b >= band_count_) return 0;
+        return readU32(index + ((uint32_t)frame * band_count_ + b) * INDEX_ENTRY_BYTES + 4);
+    }
+
+    /**
+     * Decode band b of frame into dst (width x rowsInBand(b) pixels)
+     */
+    Result decodeBand(uint16_t frame, uint16_t b, uint16_t* dst) const {
+        if (!data) return ERR_FORMAT;
+        if (frame >= frame_count_ || b >= band_count_) return ERR_RANGE;
+        const uint8_t* entry = index + ((uint32_t)frame * band_count_ + b) * INDEX_ENTRY_BYTES;
+        uint32_t offset = readU32(entry);
+        uint32_t bytes = readU32(entry + 4);
+        if (offset > data_size - bands_base || bytes > data_size - bands_base - offset) return ERR_SIZE;
+        uint32_t pixels = (uint32_t)width_px * rowsInBand(b);
+        return decodeStream(data + bands_base + offset, bytes, dst, pixels) ? OK : ERR_CORRUPT;
+    }
+
+    /** Decode a whole frame (width x height pixels) band by band */
+    Result decodeFrame(uint16_t frame, uint16_t* dst) const {
+        for (uint16_t b = 0; b < band_count_; b++) {
+            Result r = decodeBand(frame, b, dst + (uint32_t)b * band_rows * width_px);
+            if (r != OK) return r;
+        }
+        return data ? OK : ERR_FORMAT;
+    }
+
+    /**
+     * Decode one band stream; false unless it yields exactly pixels pixels
+     */
+    static bool decodeStream(const uint8_t* src, uint32_t len, uint16_t* dst, uint32_t pixels) {
+        uint16_t cache[64] = {0};
+        uint16_t prev = 0;
+        const uint8_t* end = src + len;
+        uint32_t n = 0;
+        while (n < pixels) {
+            if (src >= end) return false;
+            uint8_t op = *src++;
+            if (op < OP_DIFF) {
+                prev = cache[op];
+            } else if (op < OP_RUN) {
+                uint16_t r = (uint16_t)(((prev >> 11) + ((op >> 4) & 3) - 2) & 0x1F);
+                uint16_t g = (uint16_t)((((prev >> 5) & 0x3F) + ((op >> 2) & 3) - 2) & 0x3F);
+                uint16_t b = (uint16_t)(((prev & 0x1F) + (op & 3) - 2) & 0x1F);
+                prev = (uint16_t)((r << 11) | (g << 5) | b);
+                cache[hash(prev)] = prev;
+            } else if (op < OP_LONG_RUN) {
+                uint32_t run = (uint32_t)(op & 0x3F) + 1;
+                if (run > pixels - n) return false;
+                for (uint32_t i = 0; i < run; i++) dst[n++] = prev;
+                continue;
+            } else if (op != OP_LITERAL) {
+                if (src >= end) return false;
+                uint32_t run = ((uint32_t)(op & 0x3F) << 8 | *src++) + 65;
+                if (run > pixels - n) return false;
+                for (uint32_t i = 0; i < run; i++) dst[n++] = prev;
+                continue;
+            } else {
+                if (end - src < 2) return false;
+                prev = (uint16_t)(src[0] | (src[1] << 8));
+                src += 2;
+                cache[hash(prev)] = prev;
+            }
+            dst[n++] = prev;
+        }
+        return src == end;
+    }
+
+    /**
+     * Encode pixels into one band stream. Used by the host tests;
+     * tools/eye_anim_encode.py implements the same encoder.
+     * @param out Room for 3 x pixels bytes (the all-literal worst case)
+     * @return Bytes written
+     */
+    static uint32_t encodeBand(const uint16_t* px, uint32_t pixels, uint8_t* out) {
+        uint16_t cache[64] = {0};
+        uint16_t prev = 0;
+        uint32_t run = 0;
+        uint32_t o = 0;
+        for (uint32_t i = 0; i < pixels; i++) {
+            uint16_t p = px[i];
+            if (p == prev) {
+                run++;
+                if (run == MAX_LONG_RUN) { o = flushRun(out, o, run); run = 0; }
+                continue;
+            }
+            if (run) { o = flushRun(out, o, run); run = 0; }
+
+            uint8_t h = hash(p);
+            if (cache[h] == p) {
+                out[o++] = (uint8_t)(OP_INDEX | h);
+            } else {
+                int dr = (p >> 11) - (prev >> 11);
+                int dg = ((p >> 5) & 0x3F) - ((prev >> 5) & 0x3F);
+                int db = (p & 0x1F) - (prev & 0x1F);
+                if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                    out[o++] = (uint8_t)(OP_DIFF | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2));
+                } else {
+                    out[o++] = OP_LITERAL;
+                    out[o++] = (uint8_t)(p & 0xFF);
+                    out[o++] = (uint8_t)(p >> 8);
+                }
+                cache[h] = p;
+            }
+            prev = p;
+        }
+        if (run) o = flushRun(out, o, run);
+        return o;
+    }
+
+private:
+    const uint8_t* data;
+    size_t data_size;
+    const uint8_t* index;
+    uint32_t bands_base;
+    uint16_t width_px;
+    uint16_t height_px;
+    uint16_t band_rows;
+    uint16_t band_count_;
+    uint16_t frame_count_;
+    uint8_t animation_count_;
+
+    static uint8_t hash(uint16_t p) {
+        return (uint8_t)(((p >> 11) * 3 + ((p >> 5) & 0x3F) * 5 + (p & 0x1F) * 7) & 63);
+    }
+
+    static uint32_t flushRun(uint8_t* out, uint32_t o, uint32_t run) {
+        if (run <= 64) {
+            out[o++] = (uint8_t)(OP_RUN | (run - 1));
+        } else {
+            uint32_t v = run - 65;
+            out[o++] = (uint8_t)(OP_LONG_RUN | (v >> 8));
+            out[o++] = (uint8_t)(v & 0xFF);
+        }
+        return o;
+    }
+
+    static uint16_t readU16(const uint8_t* p) {
+        return (uint16_t)(p[0] | (p[1] << 8));
+    }
+
+    static uint32_t readU32(const uint8_t* p) {
+        return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    }
+};
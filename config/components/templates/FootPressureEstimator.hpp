@@ -0,0 +1,272 @@
+/**
+ * @file FootPressureEstimator.hpp
+ * @brief Integer center-of-pressure and support-polygon margin for FSR arrays
+ *
+ * SUBSYSTEM: foot controller (ESP32-C3 ankle board, no FPU)
+ *
+ * ARCHITECTURE:
+ * - update() takes one raw ADC scan of all N sensors and applies the stored
+ *   calibration per sensor: load = (raw - zero) * gain, Q16 gain, clamped
+ *   to 0..1000 per mille of full scale
+ * - Optional first-order smoothing per sensor (alpha = 1 / 2^shift, kept in
+ *   Q4 so small loads don't stall). shift 0 = raw, lowest latency
+ * - Running sums are updated by the change of each sensor only:
+ *       W  = sum load_i       Sx = sum load_i * x_i      Sy = sum load_i * y_i
+ *   plus per-zone (heel / midfoot / forefoot) and per-side sums. All
+ *   integer, so there is no drift; an unchanged sensor costs a compare
+ * - Contact per sensor with hysteresis -> contact bitmask. The support
+ *   polygon (convex hull of contacting sensors, Andrew's monotone chain over
+ *   positions pre-sorted at configure) and its inward edge normals (Q14) are
+ *   rebuilt only when the mask changes
+ * - Stability margin = min over hull edges of the signed distance from the
+ *   CoP (positive inside). One or two contacts: minus the distance to the
+ *   point / line, so the foot never reads stable on a point or an edge
+ * - CoP is 1/16 mm (two integer divides per scan)
+ *
+ * MEMORY: ~30 bytes per sensor, no heap
+ *
+ * TIMING: update() N x (sub, mul, shift, compare) + up to N edge dot
+ *         products; hull rebuild O(N) on contact changes only
+ *
+ * USAGE:
+ *   FootPressureEstimator<8> fsr;
+ *   fsr.configure(x_mm, y_mm, zone, 150, 50, 1);   // contact on/off per mille
+ *   fsr.setCalibration(i, raw_zero, raw_full);
+ *   fsr.update(raw);                               // once per scan
+ *   fsr.copX(), fsr.margin(), fsr.isStable(10)
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+
+template<uint8_t N>
+class FootPressureEstimator {
+public:
+    static constexpr int32_t FULL_SCALE = 1000;         // Per mille per sensor
+    static constexpr int32_t Q = 16;                    // CoP / margin unit: 1/16 mm
+    static constexpr int32_t NO_CONTACT_MARGIN = -32768 * Q;
+
+    enum Zone : uint8_t { ZONE_HEEL = 0, ZONE_MID, ZONE_FORE, ZONES };
+    enum Side : uint8_t { SIDE_LEFT = 0, SIDE_RIGHT, SIDES };
+
+    FootPressureEstimator() {
+        int16_t zero[N] = {};
+        uint8_t zone[N] = {};
+        configure(zero, zero, zone, 150, 50, 0);
+    }
+
+    /**
+     * @param x_mm, y_mm Sensor positions (x right, y forward)
+     * @param zone ZONE_* per sensor (side comes from the sign of x)
+     * @param contact_on, contact_off Contact hysteresis, per mille
+     * @param filter_shift Smoothing, alpha = 1 / 2^shift (0 = none)
+     */
+    void configure(const int16_t* x_mm, const int16_t* y_mm, const uint8_t* zone,
+                   uint16_t contact_on, uint16_t contact_off, uint8_t filter_shift) {
+        on = contact_on;
+        off = contact_off;
+        shift = filter_shift > 8 ? 8 : filter_shift;
+        for (uint8_t i = 0; i < N; i++) {
+            x[i] = x_mm[i];
+            y[i] = y_mm[i];
+            zone_of[i] = zone[i] < ZONES ? zone[i] : (uint8_t)ZONE_MID;
+            side_of[i] = x[i] < 0 ? SIDE_LEFT : SIDE_RIGHT;
+            setCalibration(i, 0, 1023);
+        }
+        for (uint8_t z = 0; z < ZONES; z++) zone_count[z] = 0;
+        for (uint8_t s = 0; s < SIDES; s++) side_count[s] = 0;
+        for (uint8_t i = 0; i < N; i++) {
+            zone_count[zone_of[i]]++;
+            side_count[side_of[i]]++;
+        }
+
+        // Sort once by (x, y); hull builds just filter this order
+        for (uint8_t i = 0; i < N; i++) order[i] = i;
+        for (uint8_t i = 1; i < N; i++) {
+            uint8_t k = order[i];
+            int8_t j = (int8_t)i - 1;
+            while (j >= 0 && (x[order[j]] > x[k] || (x[order[j]] == x[k] && y[order[j]] > y[k]))) {
+                order[j + 1] = order[j];
+                j--;
+            }
+            order[j + 1] = k;
+        }
+        reset();
+    }
+
+    /** Raw ADC at no load and at full scale load */
+    void setCalibration(uint8_t i, uint16_t raw_zero, uint16_t raw_full) {
+        if (i >= N) return;
+        int32_t span_counts = (int32_t)raw_full - raw_zero;
+        if (span_counts < 1) span_counts = 1;
+        zero[i] = raw_zero;
+        span[i] = span_counts;
+        gain_q16[i] = (FULL_SCALE << 16) / span_counts;
+    }
+
+    void reset() {
+        for (uint8_t i = 0; i < N; i++) load_q4[i] = 0;
+        w = sx = sy = 0;
+        for (uint8_t z = 0; z < ZONES; z++) zone_sum[z] = 0;
+        for (uint8_t s = 0; s < SIDES; s++) side_sum[s] = 0;
+        mask = 0;
+        hull_n = 0;
+        hull_builds = 0;
+        cop_x = cop_y = 0;
+        margin_q = NO_CONTACT_MARGIN;
+    }
+
+    /** One scan of all sensors, raw ADC counts */
+    void update(const uint16_t* raw) {
+        uint32_t new_mask = mask;
+        for (uint8_t i = 0; i < N; i++) {
+            int32_t l = (int32_t)raw[i] - zero[i];
+            l = l <= 0 ? 0 : (l >= span[i] ? FULL_SCALE : (l * gain_q16[i]) >> 16);
+            int32_t f = load_q4[i] + (((l << 4) - load_q4[i]) >> shift);
+            int32_t d = f - load_q4[i];
+            if (d != 0) {
+                load_q4[i] = f;
+                w += d;
+                sx += d * x[i];
+                sy += d * y[i];
+                zone_sum[zone_of[i]] += d;
+                side_sum[side_of[i]] += d;
+            }
+            int32_t pm = f >> 4;
+            if (pm >= on) new_mask |= 1u << i;
+            else if (pm < off) new_mask &= ~(1u << i);
+        }
+        if (new_mask != mask) {
+            mask = new_mask;
+            buildHull();
+        }
+
+        if (w >= 16) {                                  // At least 1 per mille in total
+            cop_x = (int32_t)((int64_t)sx * Q / w);
+            cop_y = (int32_t)((int64_t)sy * Q / w);
+        }
+        margin_q = marginAt(cop_x, cop_y);
+    }
+
+    /** Sensor load, per mille of full scale */
+    int32_t load(uint8_t i) const { return i < N ? load_q4[i] >> 4 : 0; }
+    /** Sum of all sensor loads, per mille */
+    int32_t totalLoad() const { return w >> 4; }
+    int32_t zoneLoad(uint8_t z) const { return z < ZONES ? zone_sum[z] >> 4 : 0; }
+    uint8_t zoneCount(uint8_t z) const { return z < ZONES ? zone_count[z] : 0; }
+    int32_t sideLoad(uint8_t s) const { return s < SIDES ? side_sum[s] >> 4 : 0; }
+    uint8_t sideCount(uint8_t s) const { return s < SIDES ? side_count[s] : 0; }
+
+    uint32_t contactMask() const { return mask; }
+    bool inContact() const { return mask != 0; }
+    uint8_t hullSize() const { return hull_n; }
+    uint32_t hullBuilds() const { return hull_builds; }
+
+    int32_t copXQ() const { return cop_x; }
+    int32_t copYQ() const { return cop_y; }
+    int32_t marginQ() const { return margin_q; }
+    float copX() const { return (float)cop_x / Q; }
+    float copY() const { return (float)cop_y / Q; }
+    float margin() const { return (float)margin_q / Q; }
+
+    /** In contact with the CoP at least min_margin_mm inside the support polygon */
+    bool isStable(int32_t min_margin_mm) const {
+        return hull_n >= 3 && margin_q >= min_margin_mm * Q;
+    }
+
+    /** Signed distance of a point (1/16 mm) from the present support polygon */
+    int32_t marginAt(int32_t px, int32_t py) const {
+        if (hull_n == 0) return NO_CONTACT_MARGIN;
+        if (hull_n == 1) {
+            // Point support: minus the larger axis distance
+            int32_t dx = px - x[hull[0]] * Q;
+            int32_t dy = py - y[hull[0]] * Q;
+            dx = dx < 0 ? -dx : dx;
+            dy = dy < 0 ? -dy : dy;
+            return -(dx > dy ? dx : dy);
+        }
+        int32_t best = INT32_MAX;
+        for (uint8_t e = 0; e < hull_n; e++) {
+            int32_t d = (int32_t)(((int64_t)nx[e] * px + (int64_t)ny[e] * py) >> 14) - c[e];
+            if (d < best) best = d;
+        }
+        // A line support has two opposite edges: best = -|distance|
+        return best;
+    }
+
+private:
+    int16_t x[N];
+    int16_t y[N];
+    uint8_t zone_of[N];
+    uint8_t side_of[N];
+    uint8_t zone_count[ZONES];
+    uint8_t side_count[SIDES];
+    uint8_t order[N];
+    uint16_t zero[N];
+    int32_t span[N];
+    int32_t gain_q16[N];
+    uint16_t on;
+    uint16_t off;
+    uint8_t shift;
+
+    int32_t load_q4[N];
+    int32_t w;
+    int32_t sx;
+    int32_t sy;
+    int32_t zone_sum[ZONES];
+    int32_t side_sum[SIDES];
+    uint32_t mask;
+    int32_t cop_x;
+    int32_t cop_y;
+    int32_t margin_q;
+
+    // Support polygon, counter-clockwise, inward unit normals in Q14
+    uint8_t hull[N];
+    uint8_t hull_n;
+    int16_t nx[N];
+    int16_t ny[N];
+    int32_t c[N];                                       // n . vertex, 1/16 mm
+    uint32_t hull_builds;
+
+    int32_t cross(uint8_t o, uint8_t a, uint8_t b) const {
+        return (int32_t)(x[a] - x[o]) * (y[b] - y[o]) - (int32_t)(y[a] - y[o]) * (x[b] - x[o]);
+    }
+
+    void buildHull() {
+        hull_builds++;
+        uint8_t pts[N];
+        uint8_t n = 0;
+        for (uint8_t k = 0; k < N; k++)
+            if ((mask >> order[k]) & 1) pts[n++] = order[k];
+
+        // Andrew's monotone chain (points already sorted)
+        uint8_t h[2 * N];
+        uint8_t m = 0;
+        for (uint8_t k = 0; k < n; k++) {
+            while (m >= 2 && cross(h[m - 2], h[m - 1], pts[k]) <= 0) m--;
+            h[m++] = pts[k];
+        }
+        for (int8_t k = (int8_t)n - 2, lower = m + 1; k >= 0; k--) {
+            while (m >= lower && cross(h[m - 2], h[m - 1], pts[k]) <= 0) m--;
+            h[m++] = pts[k];
+        }
+        hull_n = n <= 1 ? n : (uint8_t)(m - 1);
+        for (uint8_t e = 0; e < hull_n; e++) hull[e] = h[e];
+        if (hull_n < 2) return;
+
+        // Collinear contacts collapse to 2 vertices: edges a->b and b->a
+        for (uint8_t e = 0; e < hull_n; e++) {
+            uint8_t a = hull[e];
+            uint8_t b = hull[(e + 1) % hull_n];
+            float ex = (float)(x[b] - x[a]);
+            float ey = (float)(y[b] - y[a]);
+            float len = sqrtf(ex * ex + ey * ey);
+            if (len < 1e-3f) len = 1e-3f;
+            nx[e] = (int16_t)lroundf(-ey / len * 16384.0f);
+            ny[e] = (int16_t)lroundf(ex / len * 16384.0f);
+            c[e] = (int32_t)(((int64_t)nx[e] * x[a] * Q + (int64_t)ny[e] * y[a] * Q) >> 14);
+        }
+    }
+};
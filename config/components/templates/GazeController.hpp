@@ -0,0 +1,388 @@
+/**
+ * @file GazeController.hpp
+ * @brief Saccade / smooth pursuit / fixation gaze controller with neck offload
+ *
+ * SUBSYSTEM: goblin_head (eye pan/tilt steppers, GC9A01 pupils, neck)
+ *
+ * ARCHITECTURE:
+ * - Gaze = neck + eye-in-head. The controller steers gaze (head-body frame)
+ *   onto a target and outputs the eye angles that produce it for whatever
+ *   pose the neck is actually in, so the eyes counter-rotate while the neck
+ *   moves and gaze stays put (vestibulo-ocular style)
+ * - SACCADE: a gaze error above SACCADE_THRESHOLD_DEG triggers a ballistic
+ *   minimum-jerk jump (MinJerkTrajectory<2>). Its duration follows the
+ *   main sequence, peak velocity
+ *       Vp = MAIN_SEQ_VMAX * (1 - exp(-A / MAIN_SEQ_C))
+ *   so T = 1.875 A / Vp: small saccades are short and slow, large ones
+ *   saturate near 600 deg/s. For a moving target the end point leads by
+ *   target velocity x T (catch-up saccade)
+ * - PURSUIT: a target moving between PURSUIT_MIN and PURSUIT_MAX deg/s is
+ *   tracked by velocity: eye velocity = gain x target velocity plus a
+ *   small position term; errors the pursuit can't close fire a catch-up
+ *   saccade
+ * - FIXATE: gaze holds; every 0.5-1.5 s a microsaccade of 0.1-0.4 deg
+ *   re-aims at the target with a random offset (keeps the eyes alive and
+ *   bounds drift)
+ * - Neck offload: when the target is more than neck_offload_deg away from
+ *   the neck's requested pose, a new neck request is raised
+ *   (neck_request_seq bumps). The eyes get there first; the neck follows
+ *   and the eyes re-centre as it does
+ * - Targets are sparse samples (20 Hz sensor fusion); between samples the
+ *   target is extrapolated at its estimated velocity
+ * - Everything per tick is Q16 degrees in int32 (saccade shape int64);
+ *   floats only when a target sample arrives or a saccade is planned
+ *
+ * MEMORY: ~300 bytes, no heap
+ *
+ * TIMING:
+ *   tick(): a fixed handful of integer ops, plus one MinJerkTrajectory
+ *   tick (2 axes) while a saccade runs; planning a saccade adds one sqrt,
+ *   one exp and a 2-axis moveTo on that tick
+ *
+ * USAGE:
+ *   GazeController gaze;
+ *   gaze.configure(200, 45.0f, 30.0f, 15.0f);
+ *   gaze.setTarget(az_deg, el_deg, distance_cm);     // when sensors update
+ *   gaze.setNeckPose(neck_pan_deg, neck_tilt_deg);   // actual neck pose
+ *   every 5 ms: gaze.tick(); drive eyes/pupils from gaze.output()
+ *   if output().neck_request_seq changed: send neck_pan/tilt to the neck
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+#include "config/components/templates/MinJerkTrajectory.hpp"
+
+class GazeController {
+public:
+    static constexpr int32_t ONE = 65536;   // Q16 degree
+
+    // Oculomotor constants (human-like, scaled to the goblin's motors)
+    static constexpr float SACCADE_THRESHOLD_DEG = 1.0f;
+    static constexpr float MAIN_SEQ_VMAX = 600.0f;      // deg/s asymptote
+    static constexpr float MAIN_SEQ_C = 10.0f;          // deg, saturation amplitude
+    static constexpr float PURSUIT_MIN_DEG_S = 2.0f;
+    static constexpr float PURSUIT_MAX_DEG_S = 60.0f;
+    static constexpr float PURSUIT_GAIN = 0.95f;
+    static constexpr float PURSUIT_POS_TC_S = 0.15f;     // Position error time constant
+    static constexpr float MICRO_MIN_DEG = 0.1f;
+    static constexpr float MICRO_MAX_DEG = 0.4f;
+    static constexpr uint32_t MICRO_MIN_MS = 500;
+    static constexpr uint32_t MICRO_MAX_MS = 1500;
+    static constexpr uint32_t TARGET_STALE_MS = 400;     // No sample this long: stop extrapolating
+
+    enum Mode : uint8_t { FIXATE = 0, SACCADE = 1, PURSUIT = 2 };
+
+    struct Output {
+        int32_t eye_pan_q16;        // Conjugate eye-in-head angles
+        int32_t eye_tilt_q16;
+        int32_t left_pan_q16;       // Per eye, with vergence (positive = right)
+        int32_t right_pan_q16;
+        int32_t gaze_pan_q16;       // Gaze in head-body frame (neck + eye)
+        int32_t gaze_tilt_q16;
+        int32_t neck_pan_q16;       // Requested neck pose
+        int32_t neck_tilt_q16;
+        uint16_t neck_request_seq;  // Bumps when the neck request changes
+        uint16_t pupil_left_x;      // Display pixels
+        uint16_t pupil_left_y;
+        uint16_t pupil_right_x;
+        uint16_t pupil_right_y;
+        Mode mode;
+    };
+
+    struct Stats {
+        uint32_t ticks;
+        uint32_t saccades;
+        uint32_t microsaccades;
+        uint32_t neck_requests;
+    };
+
+    GazeController() { configure(200, 45.0f, 30.0f, 15.0f); }
+
+    /**
+     * @param tick_hz Rate tick() is called at
+     * @param eye_pan_limit Eye-in-head pan range, +-deg
+     * @param eye_tilt_limit Eye-in-head tilt range, +-deg
+     * @param neck_offload_deg Target eccentricity from the neck that recruits it
+     */
+    void configure(uint32_t tick_hz, float eye_pan_limit, float eye_tilt_limit, float neck_offload_deg) {
+        hz = tick_hz > 0 ? tick_hz : 1;
+        eye_pan_max = q16(eye_pan_limit);
+        eye_tilt_max = q16(eye_tilt_limit);
+        neck_offload = q16(neck_offload_deg);
+        setNeckLimits(60.0f, 30.0f);
+        setDisplay(240, 240, 1.5f, 53.0f);
+        pursuit_gain_q16 = q16(PURSUIT_GAIN);
+        pursuit_pos_q16 = q16(1.0f / (PURSUIT_POS_TC_S * hz));
+        pursuit_min = q16(PURSUIT_MIN_DEG_S / hz);
+        pursuit_max = q16(PURSUIT_MAX_DEG_S / hz);
+        saccade_threshold = q16(SACCADE_THRESHOLD_DEG);
+        stale_ticks = TARGET_STALE_MS * hz / 1000;
+        saccade.configure(hz);
+        rng = 0x2545F491u;
+        reset();
+    }
+
+    /** Neck range the controller may request, +-deg */
+    void setNeckLimits(float pan_deg, float tilt_deg) {
+        neck_pan_max = q16(pan_deg);
+        neck_tilt_max = q16(tilt_deg);
+    }
+
+    /**
+     * Pupil mapping for the eye displays
+     * @param px_per_deg Pupil travel per degree of eye rotation
+     * @param ipd_mm Eye spacing for vergence
+     */
+    void setDisplay(uint16_t w, uint16_t h, float px_per_deg, float ipd_mm) {
+        cx = w / 2;
+        cy = h / 2;
+        disp_w = w;
+        disp_h = h;
+        px_per_deg_q8 = (int32_t)lroundf(px_per_deg * 256.0f);
+        half_ipd_mm = ipd_mm * 0.5f;
+    }
+
+    /** Eyes and gaze to centre, no target */
+    void reset() {
+        eye_pan = eye_tilt = 0;
+        neck_pan = neck_tilt = 0;
+        gaze_cmd_pan = gaze_cmd_tilt = 0;
+        target_pan = target_tilt = 0;
+        sample_pan = sample_tilt = 0;
+        target_vpan = target_vtilt = 0;
+        vergence = 0;
+        have_target = false;
+        ticks_since_sample = 0;
+        mode = FIXATE;
+        micro_countdown = nextMicroTicks();
+        out = Output();
+        stats = Stats();
+        publish();
+    }
+
+    /**
+     * New target sample (head-body frame)
+     * @param az_deg Azimuth, positive = right
+     * @param el_deg Elevation, positive = up
+     * @param distance_cm Target distance for vergence, 0 = far
+     */
+    void setTarget(float az_deg, float el_deg, float distance_cm = 0.0f) {
+        int32_t pan = q16(az_deg);
+        int32_t tilt = q16(el_deg);
+        if (have_target && ticks_since_sample > 0 && ticks_since_sample < stale_ticks) {
+            // Velocity from consecutive samples, lightly smoothed
+            int32_t vpan = (pan - sample_pan) / (int32_t)ticks_since_sample;
+            int32_t vtilt = (tilt - sample_tilt) / (int32_t)ticks_since_sample;
+            target_vpan = (target_vpan + vpan) / 2;
+            target_vtilt = (target_vtilt + vtilt) / 2;
+            // A jump no target could make is a new target, not motion
+            if (abs32(vpan) > 2 * pursuit_max || abs32(vtilt) > 2 * pursuit_max) {
+                target_vpan = target_vtilt = 0;
+            }
+        } else {
+            target_vpan = target_vtilt = 0;
+        }
+        sample_pan = target_pan = pan;
+        sample_tilt = target_tilt = tilt;
+        ticks_since_sample = 0;
+        have_target = true;
+
+        float verg = distance_cm > 1.0f ? atanf(half_ipd_mm / (distance_cm * 10.0f)) * 57.29578f : 0.0f;
+        vergence = q16(verg);
+    }
+
+    /** Target lost: hold gaze where it is */
+    void clearTarget() {
+        have_target = false;
+        target_vpan = target_vtilt = 0;
+        vergence = 0;
+    }
+
+    /** Actual neck pose (deg), fed back every tick or whenever it changes */
+    void setNeckPose(float pan_deg, float tilt_deg) {
+        neck_pan = q16(pan_deg);
+        neck_tilt = q16(tilt_deg);
+    }
+
+    void setNeckPoseQ16(int32_t pan_q16, int32_t tilt_q16) {
+        neck_pan = pan_q16;
+        neck_tilt = tilt_q16;
+    }
+
+    /** Advance one tick */
+    const Output& tick() {
+        stats.ticks++;
+        if (have_target) {
+            ticks_since_sample++;
+            if (ticks_since_sample >= stale_ticks) {
+                target_vpan = target_vtilt = 0;
+            } else {
+                target_pan += target_vpan;
+                target_tilt += target_vtilt;
+            }
+        }
+
+        // Gaze is held in the body frame; neck motion since the last tick
+        // is taken up by the eyes below, not by gaze
+        int32_t gaze_pan = gaze_cmd_pan;
+        int32_t gaze_tilt = gaze_cmd_tilt;
+        // Aim only as far as the eyes reach from where the neck is now;
+        // the neck request below brings the rest into range
+        int32_t aim_pan = clamp(target_pan, neck_pan - eye_pan_max, neck_pan + eye_pan_max);
+        int32_t aim_tilt = clamp(target_tilt, neck_tilt - eye_tilt_max, neck_tilt + eye_tilt_max);
+        int32_t err_pan = have_target ? aim_pan - gaze_pan : 0;
+        int32_t err_tilt = have_target ? aim_tilt - gaze_tilt : 0;
+        bool moving = abs32(target_vpan) >= pursuit_min || abs32(target_vtilt) >= pursuit_min;
+
+        if (mode == SACCADE) {
+            bool running = saccade.tick();
+            gaze_pan = saccade.positionQ16(0);
+            gaze_tilt = saccade.positionQ16(1);
+            if (!running) {
+                mode = moving ? PURSUIT : FIXATE;
+                micro_countdown = nextMicroTicks();
+            }
+        } else if (abs32(err_pan) > saccade_threshold || abs32(err_tilt) > saccade_threshold) {
+            startSaccade(gaze_pan, gaze_tilt, aim_pan, aim_tilt, moving, false);
+        } else if (moving && abs32(target_vpan) <= pursuit_max && abs32(target_vtilt) <= pursuit_max) {
+            mode = PURSUIT;
+            gaze_pan += mulQ16(target_vpan, pursuit_gain_q16) + mulQ16(err_pan, pursuit_pos_q16);
+            gaze_tilt += mulQ16(target_vtilt, pursuit_gain_q16) + mulQ16(err_tilt, pursuit_pos_q16);
+        } else {
+            mode = FIXATE;
+            if (--micro_countdown == 0) {
+                micro_countdown = nextMicroTicks();
+                if (have_target) {
+                    // Re-aim at the target with a small random offset
+                    int32_t amp = q16(MICRO_MIN_DEG) + (int32_t)(rand16() * (uint32_t)q16(MICRO_MAX_DEG - MICRO_MIN_DEG) >> 16);
+                    int32_t dx = (int32_t)(rand16() & 1 ? amp : -amp);
+                    int32_t dy = (int32_t)((rand16() * (uint32_t)amp) >> 16) - amp / 2;
+                    startSaccade(gaze_pan, gaze_tilt, aim_pan + dx, aim_tilt + dy, false, true);
+                }
+            }
+        }
+
+        // Neck offload: recruit the neck for eccentric targets
+        if (have_target) {
+            int32_t np = clamp(target_pan, -neck_pan_max, neck_pan_max);
+            int32_t nt = clamp(target_tilt, -neck_tilt_max, neck_tilt_max);
+            if (abs32(target_pan - out.neck_pan_q16) > neck_offload ||
+                abs32(target_tilt - out.neck_tilt_q16) > neck_offload) {
+                out.neck_pan_q16 = np;
+                out.neck_tilt_q16 = nt;
+                out.neck_request_seq++;
+                stats.neck_requests++;
+            }
+        }
+
+        // Counter-rotate: whatever the neck did, the eyes make up the rest
+        eye_pan = clamp(gaze_pan - neck_pan, -eye_pan_max, eye_pan_max);
+        eye_tilt = clamp(gaze_tilt - neck_tilt, -eye_tilt_max, eye_tilt_max);
+        // At an eye limit gaze is wherever the eye could get to
+        gaze_cmd_pan = neck_pan + eye_pan;
+        gaze_cmd_tilt = neck_tilt + eye_tilt;
+        publish();
+        return out;
+    }
+
+    const Output& output() const { return out; }
+    const Stats& getStats() const { return stats; }
+    Mode getMode() const { return mode; }
+    uint32_t tickHz() const { return hz; }
+
+    /** Main-sequence duration for an amplitude, seconds */
+    static float saccadeDuration(float amplitude_deg) {
+        float vp = MAIN_SEQ_VMAX * (1.0f - expf(-amplitude_deg / MAIN_SEQ_C));
+        return vp > 0.0f ? 1.875f * amplitude_deg / vp : 0.0f;
+    }
+
+private:
+    uint32_t hz;
+    int32_t eye_pan_max, eye_tilt_max;
+    int32_t neck_pan_max, neck_tilt_max;
+    int32_t neck_offload;
+    int32_t pursuit_gain_q16, pursuit_pos_q16;
+    int32_t pursuit_min, pursuit_max;
+    int32_t saccade_threshold;
+    uint32_t stale_ticks;
+
+    uint16_t cx, cy, disp_w, disp_h;
+    int32_t px_per_deg_q8;
+    float half_ipd_mm;
+
+    int32_t eye_pan, eye_tilt;
+    int32_t neck_pan, neck_tilt;
+    int32_t gaze_cmd_pan, gaze_cmd_tilt;
+    int32_t target_pan, target_tilt;
+    int32_t target_vpan, target_vtilt;      // Q16 deg per tick
+    int32_t sample_pan, sample_tilt;
+    int32_t vergence;
+    bool have_target;
+    uint32_t ticks_since_sample;
+
+    Mode mode;
+    MinJerkTrajectory<2> saccade;
+    uint32_t micro_countdown;
+    uint32_t rng;
+
+    Output out;
+    Stats stats;
+
+    static int32_t q16(float v) { return (int32_t)lroundf(v * ONE); }
+    static int32_t abs32(int32_t v) { return v < 0 ? -v : v; }
+    static int32_t clamp(int32_t v, int32_t lo, int32_t hi) { return v < lo ? lo : (v > hi ? hi : v); }
+    static int32_t mulQ16(int32_t a, int32_t b) { return (int32_t)(((int64_t)a * b) >> 16); }
+
+    uint32_t rand16() {
+        rng = rng * 1664525u + 1013904223u;
+        return rng >> 16;
+    }
+
+    uint32_t nextMicroTicks() {
+        uint32_t ms = MICRO_MIN_MS + (rand16() * (MICRO_MAX_MS - MICRO_MIN_MS) >> 16);
+        uint32_t t = ms * hz / 1000;
+        return t > 0 ? t : 1;
+    }
+
+    void startSaccade(int32_t from_pan, int32_t from_tilt, int32_t to_pan, int32_t to_tilt,
+                      bool lead, bool micro) {
+        float dp = (float)(to_pan - from_pan) / ONE;
+        float dt = (float)(to_tilt - from_tilt) / ONE;
+        float amplitude = sqrtf(dp * dp + dt * dt);
+        float duration = saccadeDuration(amplitude);
+        float end[2] = {(float)to_pan / ONE, (float)to_tilt / ONE};
+        if (lead) {
+            // Land where a moving target will be, not where it was
+            end[0] += (float)target_vpan / ONE * duration * hz;
+            end[1] += (float)target_vtilt / ONE * duration * hz;
+        }
+        float start[2] = {(float)from_pan / ONE, (float)from_tilt / ONE};
+        saccade.reset(start);
+        saccade.moveTo(end, duration);
+        mode = SACCADE;
+        if (micro) stats.microsaccades++;
+        else stats.saccades++;
+    }
+
+    uint16_t pupil(int32_t center, int32_t angle_q16, uint16_t span) const {
+        int32_t p = center + (int32_t)(((int64_t)angle_q16 * px_per_deg_q8) >> 24);
+        return (uint16_t)clamp(p, 0, span - 1);
+    }
+
+    void publish() {
+        out.eye_pan_q16 = eye_pan;
+        out.eye_tilt_q16 = eye_tilt;
+        // Converging: the left eye turns right, the right eye left
+        out.left_pan_q16 = eye_pan + vergence;
+        out.right_pan_q16 = eye_pan - vergence;
+        out.gaze_pan_q16 = neck_pan + eye_pan;
+        out.gaze_tilt_q16 = neck_tilt + eye_tilt;
+        out.pupil_left_x = pupil(cx, out.left_pan_q16, disp_w);
+        out.pupil_right_x = pupil(cx, out.right_pan_q16, disp_w);
+        // Display y grows downward; looking up moves the pupil up
+        out.pupil_left_y = out.pupil_right_y = pupil(cy, -eye_tilt, disp_h);
+        out.mode = mode;
+    }
+};
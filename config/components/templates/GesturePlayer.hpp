@@ -0,0 +1,269 @@
+/**
+ * @file GesturePlayer.hpp
+ * @brief Keyframe gesture playback with crossfades for C servo channels
+ *
+ * SUBSYSTEM: goblin hand (5 fingers) and arm (7 joints) gesture libraries
+ *
+ * ARCHITECTURE:
+ * - A gesture is a Track: a flash-resident array of Keys (time in ms, ease
+ *   mode, one int16 value per channel in 1/100 of the channel unit) plus a
+ *   HOLD / LOOP flag. A library is an array of Tracks indexed by dense
+ *   gesture id, so lookup is one index, no names
+ * - Up to V voices play at once, each with its own clock, key cursor and
+ *   blend weight. play() starts a voice at weight 0 and fades every other
+ *   voice out over the same time, so an in-progress gesture keeps moving
+ *   while it hands over. playPose() / setPose() do the same for a single
+ *   static pose (direct commands, "wherever the fingers are now")
+ * - tick() is one batched pass: per voice advance the clock, step the
+ *   cursor, one divide for the segment fraction and one for the weight;
+ *   then per channel a lerp and a weighted accumulate. Weights are eased
+ *   (smoothstep) and normalised once per tick, so the output is always a
+ *   convex mix of the voices and does not jump when one starts or retires
+ * - Segments are linear or smoothstep per key; HOLD tracks stay on the last
+ *   key, LOOP tracks wrap at the last key time (author the last key equal
+ *   to the first for a seamless loop)
+ * - A full voice table folds all voices into one static voice holding the
+ *   present output, so nothing jumps; the outgoing gestures stop moving
+ *   while they fade
+ *
+ * MEMORY: V x (2C + ~32) + 2C bytes, no heap. Keys: 3 + 2C bytes each, in
+ *         flash
+ *
+ * TIMING: tick() V x (2 divides + C multiply-adds) + C for the output
+ *
+ * USAGE:
+ *   typedef GesturePlayer<5, 4> HandPlayer;
+ *   static const HandPlayer::Key wave_keys[] = {{0, EASE, {...}}, ...};
+ *   static const HandPlayer::Track library[] = {{wave_keys, 3, HandPlayer::TRACK_LOOP}, ...};
+ *   player.configure(library, 2);
+ *   player.play(GESTURE_WAVE, 400);          // crossfade 400 ms
+ *   every tick: player.tick(dt_us); player.value(c) -> servo c
+ */
+
+#pragma once
+
+#include <cstdint>
+
+template<uint8_t C, uint8_t V = 4>
+class GesturePlayer {
+public:
+    static constexpr int32_t ONE = 32768;               // Q15 weight / fraction
+    static constexpr uint8_t NONE = 0xFF;
+
+    enum Ease : uint8_t { EASE_LINEAR = 0, EASE_SMOOTH };
+    enum TrackMode : uint8_t { TRACK_HOLD = 0, TRACK_LOOP };
+
+    struct Key {
+        uint16_t t_ms;                  // From the start of the track
+        uint8_t ease;                   // Shape of the segment that ends at this key
+        int16_t value[C];
+    };
+
+    struct Track {
+        const Key* keys;
+        uint8_t count;
+        uint8_t mode;
+    };
+
+    GesturePlayer() { configure(nullptr, 0); }
+
+    void configure(const Track* library, uint8_t count) {
+        tracks = library;
+        track_count = library ? count : 0;
+        int16_t zero[C] = {};
+        setPose(zero);
+    }
+
+    /** Crossfade to gesture id over fade_ms. false if the id is unknown */
+    bool play(uint8_t id, uint16_t fade_ms) {
+        if (id >= track_count || tracks[id].count == 0) return false;
+        Voice& v = startVoice(fade_ms);
+        v.keys = tracks[id].keys;
+        v.count = tracks[id].count;
+        v.mode = tracks[id].mode;
+        v.id = id;
+        last_id = id;
+        return true;
+    }
+
+    /** Crossfade to a static pose (1/100 units) over fade_ms */
+    void playPose(const int16_t* pose, uint16_t fade_ms) {
+        Voice& v = startVoice(fade_ms);
+        for (uint8_t c = 0; c < C; c++) v.pose[c] = pose[c];
+        last_id = NONE;
+    }
+
+    /** Jump to a static pose, dropping every voice */
+    void setPose(const int16_t* pose) {
+        active = 0;
+        Voice& v = voices[active++];
+        clearVoice(v);
+        v.w = v.w_from = v.w_to = ONE;
+        for (uint8_t c = 0; c < C; c++) {
+            v.pose[c] = pose[c];
+            out[c] = pose[c];
+        }
+        last_id = NONE;
+    }
+
+    /** Advance all voices by dt_us and mix */
+    void tick(uint32_t dt_us) {
+        int32_t w_eff[V];
+        int32_t total = 0;
+        for (uint8_t k = 0; k < active; k++) {
+            Voice& v = voices[k];
+            advance(v, dt_us);
+            w_eff[k] = smooth(v.w);
+            total += w_eff[k];
+        }
+
+        int32_t acc[C] = {};
+        for (uint8_t k = 0; k < active; k++) {
+            if (w_eff[k] == 0) continue;
+            int32_t wn = total > 0 ? (int32_t)(((int64_t)w_eff[k] << 15) / total) : ONE;
+            const Voice& v = voices[k];
+            if (!v.keys) {
+                for (uint8_t c = 0; c < C; c++) acc[c] += wn * v.pose[c];
+                continue;
+            }
+            const Key& a = v.keys[v.key];
+            const Key& b = v.keys[v.key + 1 < v.count ? v.key + 1 : v.key];
+            int32_t s = fraction(v, a, b);
+            for (uint8_t c = 0; c < C; c++) {
+                int32_t x = a.value[c] + (((int32_t)(b.value[c] - a.value[c]) * s) >> 15);
+                acc[c] += wn * x;
+            }
+        }
+        if (total > 0) {
+            for (uint8_t c = 0; c < C; c++) out[c] = (int16_t)((acc[c] + (ONE >> 1)) >> 15);
+        }
+        retire();
+    }
+
+    int16_t value(uint8_t c) const { return c < C ? out[c] : 0; }
+    const int16_t* pose() const { return out; }
+    uint8_t activeVoices() const { return active; }
+    /** Most recent gesture id started, NONE after a pose */
+    uint8_t current() const { return last_id; }
+    bool isBlending() const { return active > 1; }
+
+    /** Output will still change: a fade, a running keyframe track or a loop */
+    bool isAnimating() const {
+        if (active > 1) return true;
+        const Voice& v = voices[0];
+        return v.keys && (v.mode == TRACK_LOOP || v.key + 1 < v.count);
+    }
+
+private:
+    struct Voice {
+        const Key* keys;                // nullptr = static pose
+        uint8_t count;
+        uint8_t mode;
+        uint8_t key;                    // Segment start
+        uint8_t id;
+        uint32_t t_us;
+        uint32_t fade_us;
+        uint32_t fade_len_us;
+        int32_t w;                      // Q15, linear in fade time
+        int32_t w_from;
+        int32_t w_to;
+        int16_t pose[C];
+    };
+
+    const Track* tracks;
+    uint8_t track_count;
+    Voice voices[V];
+    uint8_t active;
+    uint8_t last_id;
+    int16_t out[C];
+
+    static void clearVoice(Voice& v) {
+        v.keys = nullptr;
+        v.count = 0;
+        v.mode = TRACK_HOLD;
+        v.key = 0;
+        v.id = NONE;
+        v.t_us = 0;
+        v.fade_us = v.fade_len_us = 0;
+        v.w = v.w_from = v.w_to = 0;
+    }
+
+    static int32_t smooth(int32_t w) {
+        // 3w^2 - 2w^3 in Q15
+        int32_t w2 = (w * w) >> 15;
+        return (w2 * (3 * ONE - 2 * w)) >> 15;
+    }
+
+    void beginFade(Voice& v, int32_t to, uint32_t len_us) {
+        v.w_from = v.w;
+        v.w_to = to;
+        v.fade_us = 0;
+        v.fade_len_us = len_us;
+        if (len_us == 0) v.w = to;
+    }
+
+    Voice& startVoice(uint16_t fade_ms) {
+        uint32_t len_us = (uint32_t)fade_ms * 1000u;
+        for (uint8_t k = 0; k < active; k++) beginFade(voices[k], 0, len_us);
+        if (active == V) {
+            // Full: fold everything into the present output as one static
+            // voice, which then fades like the rest
+            Voice& f = voices[0];
+            clearVoice(f);
+            for (uint8_t c = 0; c < C; c++) f.pose[c] = out[c];
+            f.w = ONE;
+            beginFade(f, 0, len_us);
+            active = 1;
+        }
+        Voice& v = voices[active++];
+        clearVoice(v);
+        beginFade(v, ONE, len_us);
+        if (len_us == 0) {                              // Cut: only the new voice remains
+            voices[0] = v;
+            active = 1;
+            return voices[0];
+        }
+        return v;
+    }
+
+    void advance(Voice& v, uint32_t dt_us) {
+        if (v.w != v.w_to) {
+            v.fade_us += dt_us;
+            if (v.fade_us >= v.fade_len_us) {
+                v.w = v.w_to;
+            } else {
+                v.w = v.w_from + (int32_t)((int64_t)(v.w_to - v.w_from) * v.fade_us / v.fade_len_us);
+            }
+        }
+        if (!v.keys) return;
+
+        v.t_us += dt_us;
+        uint32_t end_us = (uint32_t)v.keys[v.count - 1].t_ms * 1000u;
+        if (v.t_us >= end_us) {
+            if (v.mode == TRACK_LOOP && end_us > 0) {
+                v.t_us %= end_us;
+                v.key = 0;
+            } else {
+                v.t_us = end_us;
+            }
+        }
+        while (v.key + 1 < v.count && v.t_us >= (uint32_t)v.keys[v.key + 1].t_ms * 1000u) v.key++;
+    }
+
+    int32_t fraction(const Voice& v, const Key& a, const Key& b) const {
+        if (&a == &b) return 0;
+        uint32_t t0 = (uint32_t)a.t_ms * 1000u;
+        uint32_t len = (uint32_t)(b.t_ms - a.t_ms) * 1000u;
+        if (len == 0) return ONE;
+        int32_t s = (int32_t)(((uint64_t)(v.t_us - t0) << 15) / len);
+        if (s > ONE) s = ONE;
+        return b.ease == EASE_SMOOTH ? smooth(s) : s;
+    }
+
+    void retire() {
+        for (uint8_t k = 0; k < active;) {
+            if (voices[k].w == 0 && voices[k].w_to == 0 && active > 1) voices[k] = voices[--active];
+            else k++;
+        }
+    }
+};
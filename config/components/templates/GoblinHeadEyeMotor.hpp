@@ -10,6 +10,9 @@
  * - Blink: NEMA8_GEARED_5 linear actuator (eyelid)
  * - Display: GC9A01 240×240 RGB565
  * - Mood affects eye color, pupil dilation
+ * - Gaze: the head's one GazeController (goblin_gaze) picks targets and
+ *   runs saccades / pursuit / microsaccades; followGaze() hands its
+ *   eye-in-head output to the motors and the drawn pupil
  * 
  * MEMORY:
  * - Frame buffer: 115.2 KB (240×240×2 RGB565)
@@ -29,7 +32,8 @@
 #include <cstring>
 #include <cstdlib>
 #include "config/components/templates/goblin_eye_mood_display_v2.hpp"
-#include "config/components/hardware/stepper_motor_library.hpp"
+#include "config/components/hardware/StepperController.hpp"
+#include "config/components/templates/GazeController.hpp"
 #include "shared/Mood.hpp"
 
 class GoblinHeadEyeMotor {
@@ -117,7 +121,7 @@ public:
         // NEMA17: 200 steps/rev → ~1.8° per step
         // Pan range: -45° to +45° = 90° total = ~50 steps
         // Position 0 = center
-        updateMotorTargets();
+        updateMotorTargets(0, 0);
         
         initialized = true;
         return true;
@@ -132,16 +136,13 @@ public:
         // Update blink state machine
         updateBlink(now_ms);
         
-        // Update motor positions (in component loop, handled by dispatcher)
-        // TODO: Motor steps dispatched via GPIO ISR
-        
         // Render eye display with current mood
         eye_display.renderFrame(current_mood, 0x00FF00);  // Green base
         eye_display.sendToDisplay();
     }
     
     /**
-     * Set target gaze position (degrees)
+     * Set target gaze position (degrees), bypassing the gaze controller
      */
     void lookAt(int16_t pan_deg, int16_t tilt_deg) {
         // Clamp to limits
@@ -150,7 +151,23 @@ public:
         state.tilt_target = (tilt_deg < TILT_MIN) ? TILT_MIN : 
                            (tilt_deg > TILT_MAX) ? TILT_MAX : tilt_deg;
         
-        updateMotorTargets();
+        updateMotorTargets(state.pan_target * GazeController::ONE, state.tilt_target * GazeController::ONE);
+    }
+    
+    /**
+     * Follow the head's gaze controller: motors take the eye-in-head angles,
+     * the display the pupil of this eye
+     * @param right_eye Which pupil (vergence) this eye draws
+     */
+    void followGaze(const GazeController::Output& out, bool right_eye) {
+        state.pan_angle = (int16_t)(out.eye_pan_q16 / GazeController::ONE);
+        state.tilt_angle = (int16_t)(out.eye_tilt_q16 / GazeController::ONE);
+        updateMotorTargets(out.eye_pan_q16, out.eye_tilt_q16);
+        if (right_eye) {
+            eye_display.setPupilPosition(out.pupil_right_x, out.pupil_right_y);
+        } else {
+            eye_display.setPupilPosition(out.pupil_left_x, out.pupil_left_y);
+        }
     }
     
     /**
@@ -203,15 +220,15 @@ private:
     StepperController blink_controller;
     
     /**
-     * Convert target angles to motor step positions
+     * Convert eye angles (degrees Q16) to motor step positions
      */
-    void updateMotorTargets() {
+    void updateMotorTargets(int32_t pan_q16, int32_t tilt_q16) {
         // NEMA17 Standard: 200 steps/rev, 1.8° per step
         // Range: -45° to +45° → 25 to -25 steps from center (1.8° per step ≈ 25 steps per 45°)
         // Tilt: ±30° → ±16.67 steps (NEMA14 similar)
         
-        int32_t pan_steps = (state.pan_target * 100) / 180;  // Rough conversion
-        int32_t tilt_steps = (state.tilt_target * 100) / 180;
+        int32_t pan_steps = (int32_t)(((int64_t)pan_q16 * 100 / 180) >> 16);  // Rough conversion
+        int32_t tilt_steps = (int32_t)(((int64_t)tilt_q16 * 100 / 180) >> 16);
         
         pan_controller.moveTo(pan_steps);
         tilt_controller.moveTo(tilt_steps);
@@ -255,5 +272,3 @@ private:
         }
     }
 };
-
-#endif // GOBLIN_HEAD_EYE_MOTOR_HPP
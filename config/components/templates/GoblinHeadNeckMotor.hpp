@@ -12,12 +12,14 @@
  * 
  * MEMORY:
  * - Motor state: 96 bytes
- * - Interpolation buffer: 32 bytes
- * Total: ~130 bytes (negligible)
+ * - Trajectory (MinJerkTrajectory<3>): ~240 bytes
+ * Total: ~340 bytes (negligible)
  * 
  * TIMING:
- * - Update: 30 Hz (32 ms)
- * - Smooth motion: exponential easing over 200-500ms
+ * - act(): ~30 Hz (32 ms); catches up on 100 Hz trajectory ticks
+ * - Motion: all three axes follow minimum-jerk profiles scaled to one
+ *   shared duration, so they start and arrive together; a new target
+ *   mid-motion blends from the present velocity and acceleration
  * 
  * MOTION RANGES:
  * - Pan: ±60° (left-right turn)
@@ -30,7 +32,8 @@
 #include <cstdint>
 #include <cstring>
 #include <cmath>
-#include "config/components/hardware/stepper_motor_library.hpp"
+#include "config/components/hardware/StepperController.hpp"
+#include "config/components/templates/MinJerkTrajectory.hpp"
 
 class GoblinHeadNeckMotor {
 public:
@@ -42,6 +45,15 @@ public:
     static constexpr int16_t ROLL_MIN = -25;
     static constexpr int16_t ROLL_MAX = 25;
     
+    // Trajectory setpoint rate and per-axis limits (deg/s, deg/s^2)
+    static constexpr uint32_t TRAJECTORY_HZ = 100;
+    static constexpr float PAN_MAX_VEL = 240.0f;
+    static constexpr float PAN_MAX_ACCEL = 1500.0f;
+    static constexpr float TILT_MAX_VEL = 180.0f;
+    static constexpr float TILT_MAX_ACCEL = 1200.0f;
+    static constexpr float ROLL_MAX_VEL = 120.0f;
+    static constexpr float ROLL_MAX_ACCEL = 900.0f;
+    
     // Neck presets (for attention/emotion)
     enum NeckPose {
         CENTER = 0,
@@ -64,7 +76,7 @@ public:
         int16_t roll_target;
         
         uint32_t motion_start_time;
-        uint32_t motion_duration_ms;
+        uint32_t motion_duration_ms;    // Planned (shared) duration of the current move
         bool is_moving;
         
         NeckPose current_pose;
@@ -78,6 +90,12 @@ public:
     {
         memset(&state, 0, sizeof(state));
         state.current_pose = CENTER;
+        last_tick_ms = 0;
+        
+        trajectory.configure(TRAJECTORY_HZ);
+        trajectory.setLimits(0, PAN_MAX_VEL, PAN_MAX_ACCEL);
+        trajectory.setLimits(1, TILT_MAX_VEL, TILT_MAX_ACCEL);
+        trajectory.setLimits(2, ROLL_MAX_VEL, ROLL_MAX_ACCEL);
     }
     
     /**
@@ -124,11 +142,21 @@ public:
     void act(uint32_t now_ms) {
         if (!initialized) return;
         
-        // Update easing if motion in progress
-        if (state.is_moving) {
-            updateMotionEasing(now_ms);
+        // Run every trajectory tick that fell due since the last call
+        const uint32_t tick_ms = 1000 / TRAJECTORY_HZ;
+        if (!state.is_moving || now_ms - last_tick_ms > 10 * tick_ms) {
+            // Idle, or stalled far behind: restart the tick clock now
+            last_tick_ms = now_ms;
+        }
+        while (state.is_moving && now_ms - last_tick_ms >= tick_ms) {
+            last_tick_ms += tick_ms;
+            state.is_moving = trajectory.tick();
         }
         
+        state.pan_angle = roundDeg(trajectory.positionQ16(0));
+        state.tilt_angle = roundDeg(trajectory.positionQ16(1));
+        state.roll_angle = roundDeg(trajectory.positionQ16(2));
+        
         // Update motor positions
         updateMotorTargets();
     }
@@ -147,13 +175,15 @@ public:
         state.tilt_target = clamp(tilt_deg, TILT_MIN, TILT_MAX);
         state.roll_target = clamp(roll_deg, ROLL_MIN, ROLL_MAX);
         
-        state.motion_duration_ms = duration_ms;
-        state.motion_start_time = 0;  // Will be set on first act()
+        // One shared duration: every axis arrives on the same tick
+        float target[3] = {
+            (float)state.pan_target, (float)state.tilt_target, (float)state.roll_target
+        };
+        float duration_s = trajectory.moveTo(target, duration_ms / 1000.0f);
         
-        // Calculate if actually moving
-        state.is_moving = (state.pan_angle != state.pan_target) ||
-                         (state.tilt_angle != state.tilt_target) ||
-                         (state.roll_angle != state.roll_target);
+        state.motion_duration_ms = (uint32_t)(duration_s * 1000.0f + 0.5f);
+        state.motion_start_time = 0;
+        state.is_moving = trajectory.isActive();
     }
     
     /**
@@ -239,6 +269,9 @@ private:
     StepperController tilt_controller;
     StepperController roll_controller;
     
+    MinJerkTrajectory<3> trajectory;
+    uint32_t last_tick_ms;
+    
     /**
      * Clamp value to range
      */
@@ -249,76 +282,28 @@ private:
     }
     
     /**
-     * Easing function: ease-in-out-cubic for smooth motion
-     * @param t Time elapsed (0.0 to 1.0)
-     */
-    static float easeInOutCubic(float t) {
-        if (t < 0.5f) {
-            return 4.0f * t * t * t;
-        } else {
-            float f = (2.0f * t) - 2.0f;
-            return 0.5f * f * f * f + 1.0f;
-        }
-    }
-    
-    /**
-     * Update motion easing (interpolate toward targets)
+     * Q16 degrees to whole degrees, rounded to nearest
      */
-    void updateMotionEasing(uint32_t now_ms) {
-        // Initialize motion start time on first call
-        if (state.motion_start_time == 0) {
-            state.motion_start_time = now_ms;
-        }
-        
-        uint32_t elapsed_ms = now_ms - state.motion_start_time;
-        float t = (float)elapsed_ms / (float)state.motion_duration_ms;
-        
-        if (t >= 1.0f) {
-            // Motion complete
-            state.pan_angle = state.pan_target;
-            state.tilt_angle = state.tilt_target;
-            state.roll_angle = state.roll_target;
-            state.is_moving = false;
-            state.motion_start_time = 0;
-        } else {
-            // Interpolate with easing
-            float ease = easeInOutCubic(t);
-            
-            // Calculate deltas
-            int16_t pan_delta = state.pan_target - (state.pan_angle + 
-                                (state.pan_target - state.pan_angle) * ease);
-            int16_t tilt_delta = state.tilt_target - (state.tilt_angle + 
-                                 (state.tilt_target - state.tilt_angle) * ease);
-            int16_t roll_delta = state.roll_target - (state.roll_angle + 
-                                 (state.roll_target - state.roll_angle) * ease);
-            
-            // Apply eased positions
-            state.pan_angle = state.pan_angle + (int16_t)(pan_delta);
-            state.tilt_angle = state.tilt_angle + (int16_t)(tilt_delta);
-            state.roll_angle = state.roll_angle + (int16_t)(roll_delta);
-        }
+    static int16_t roundDeg(int32_t q16) {
+        return (int16_t)((q16 + (q16 >= 0 ? 32768 : -32768)) / 65536);
     }
     
     /**
      * Update stepper motor positions from angle state
      */
     void updateMotorTargets() {
-        // NEMA23 Standard: 200 steps/rev, geared for smooth motion
-        // Pan: ±60° range → ±33 steps (rough estimate with gearing)
-        int32_t pan_steps = (state.pan_angle * 200) / 360;
-        
-        // NEMA17 High-Torque: 200 steps/rev
-        // Tilt: ±45° range → ±25 steps
-        int32_t tilt_steps = (state.tilt_angle * 200) / 360;
-        
-        // NEMA14: 200 steps/rev
-        // Roll: ±25° range → ±14 steps
-        int32_t roll_steps = (state.roll_angle * 200) / 360;
-        
-        pan_controller.moveTo(pan_steps);
-        tilt_controller.moveTo(tilt_steps);
-        roll_controller.moveTo(roll_steps);
+        // 200 steps/rev on all three axes; setpoints come from the
+        // trajectory in Q16 degrees so sub-degree motion still steps
+        // NEMA23 Standard pan: ±60° range → ±33 steps (rough estimate with gearing)
+        // NEMA17 High-Torque tilt: ±45° range → ±25 steps
+        // NEMA14 roll: ±25° range → ±14 steps
+        pan_controller.moveTo(degQ16ToSteps(trajectory.positionQ16(0)));
+        tilt_controller.moveTo(degQ16ToSteps(trajectory.positionQ16(1)));
+        roll_controller.moveTo(degQ16ToSteps(trajectory.positionQ16(2)));
+    }
+    
+    static int32_t degQ16ToSteps(int32_t deg_q16) {
+        int64_t steps_q16 = (int64_t)deg_q16 * 200 / 360;
+        return (int32_t)((steps_q16 + (steps_q16 >= 0 ? 32768 : -32768)) / 65536);
     }
 };
-
-#endif // GOBLIN_HEAD_NECK_MOTOR_HPP
@@ -0,0 +1,279 @@
+/**
+ * @file GripForceController.hpp
+ * @brief Per-finger force/position hybrid grip control, fixed point
+ *
+ * SUBSYSTEM: hand controller (ESP32-C3, 5 finger servos + fingertip FSRs)
+ *
+ * ARCHITECTURE:
+ * - Every finger is in one of three modes:
+ *     POSITION  linear ramp to a commanded angle (gestures, release)
+ *     APPROACH  close at a fixed rate until the fingertip force reaches the
+ *               contact threshold, or stop at the grip limit (no object)
+ *     HOLD      PI on force error. The command is the contact angle plus a
+ *               correction, so the loop regulates indentation into the
+ *               object rather than an absolute angle
+ * - The force error is turned into an angle through a nominal object
+ *   stiffness (per mille per degree) before the gains apply, so kp / ki are
+ *   dimensionless / 1/s and the same gains hold for any tick rate. Loop
+ *   gain scales with real / nominal stiffness: soft objects settle slower,
+ *   hard ones faster
+ * - Entry into HOLD is bumpless (integrator preloaded so the first command
+ *   equals the last approach command). Conditional integration stops
+ *   windup while the command sits on a limit
+ * - Force below the slip threshold for a few ticks drops the finger back
+ *   to APPROACH from where it is, so a shifted object is re-acquired
+ * - Angles are 1/100 degree, forces per mille, gains Q16. tick() is integer
+ *   only with one divide per holding finger
+ *
+ * MEMORY: ~40 bytes per finger, no heap
+ *
+ * TIMING: tick() N x (~10 integer ops, one divide in HOLD)
+ *
+ * USAGE:
+ *   GripForceController<5> grip;
+ *   grip.configure(500, 90.0f, 50, 25);        // Hz, approach deg/s, contact / slip per mille
+ *   grip.setGains(0.3f, 8.0f, 20.0f);           // kp, ki 1/s, nominal stiffness per mille/deg
+ *   grip.grip(i, 150, 180.0f);                  // hold 150 per mille, close no further than 180 deg
+ *   every tick: grip.tick(force); send grip.positionCdeg(i) to the servos
+ *   grip.moveTo(i, 0.0f, 0.5f);                 // release
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+
+template<uint8_t N>
+class GripForceController {
+public:
+    enum Mode : uint8_t { MODE_POSITION = 0, MODE_APPROACH, MODE_HOLD };
+
+    static constexpr int32_t CDEG_MAX = 18000;
+    static constexpr uint8_t SLIP_TICKS_MIN = 2;
+
+    GripForceController() {
+        configure(500, 90.0f, 50, 25);
+        setGains(0.3f, 8.0f, 20.0f);
+    }
+
+    /**
+     * @param tick_hz Rate tick() is called at
+     * @param approach_dps Closing speed before contact, deg/s
+     * @param contact_permille Force that ends the approach
+     * @param slip_permille Force below which a held finger has lost the object
+     */
+    void configure(uint32_t tick_hz, float approach_dps, int16_t contact_permille, int16_t slip_permille) {
+        hz = tick_hz > 0 ? tick_hz : 1;
+        approach_step_q8 = (int32_t)lroundf(approach_dps * 100.0f * 256.0f / (float)hz);
+        if (approach_step_q8 < 1) approach_step_q8 = 1;
+        setThresholds(contact_permille, slip_permille);
+        slip_ticks = (uint8_t)(hz / 100 > SLIP_TICKS_MIN ? (hz / 100 > 255 ? 255 : hz / 100) : SLIP_TICKS_MIN);
+        for (uint8_t i = 0; i < N; i++) {
+            lo[i] = 0;
+            hi[i] = CDEG_MAX;
+            pos_q8[i] = 0;
+            target_q8[i] = 0;
+            step_q8[i] = 0;
+            ramp_ticks[i] = 0;
+            mode_of[i] = MODE_POSITION;
+            force_target[i] = 0;
+            contact_cdeg[i] = 0;
+            integ_q16[i] = 0;
+            slip_count[i] = 0;
+            at_limit[i] = false;
+            last_force[i] = 0;
+        }
+    }
+
+    /** Contact / slip thresholds, per mille; fingers keep their state */
+    void setThresholds(int16_t contact_permille, int16_t slip_permille) {
+        contact = contact_permille;
+        slip = slip_permille < contact_permille ? slip_permille : contact_permille;
+    }
+
+    /**
+     * @param kp Proportional gain on the stiffness-normalised error
+     * @param ki Integral gain, 1/s
+     * @param stiffness_permille_per_deg Nominal object stiffness
+     */
+    void setGains(float kp, float ki, float stiffness_permille_per_deg) {
+        if (kp < 0.0f) kp = 0.0f;
+        if (kp > 1.0f) kp = 1.0f;
+        if (ki < 0.0f) ki = 0.0f;
+        if (stiffness_permille_per_deg < 1.0f) stiffness_permille_per_deg = 1.0f;
+        kp_q16 = (int32_t)lroundf(kp * 65536.0f);
+        ki_tick_q16 = (int32_t)lroundf(ki * 65536.0f / (float)hz);
+        if (ki_tick_q16 > 32768) ki_tick_q16 = 32768;   // Half the error per tick at most
+        stiffness_q8 = (int32_t)lroundf(stiffness_permille_per_deg * 256.0f);
+    }
+
+    /** Mechanical range of a finger, degrees (0 = open) */
+    void setLimits(uint8_t i, float open_deg, float closed_deg) {
+        if (i >= N) return;
+        lo[i] = clampCdeg(toCdeg(open_deg));
+        hi[i] = clampCdeg(toCdeg(closed_deg));
+        if (hi[i] < lo[i]) hi[i] = lo[i];
+    }
+
+    /** Position mode: ramp linearly to deg over duration_s (0 = jump) */
+    void moveTo(uint8_t i, float deg, float duration_s) {
+        if (i >= N) return;
+        int32_t t = limit(i, toCdeg(deg)) << 8;
+        uint32_t ticks = duration_s > 0.0f ? (uint32_t)lroundf(duration_s * (float)hz) : 0;
+        mode_of[i] = MODE_POSITION;
+        at_limit[i] = false;
+        target_q8[i] = t;
+        ramp_ticks[i] = ticks;
+        step_q8[i] = ticks > 0 ? (t - pos_q8[i]) / (int32_t)ticks : 0;
+        if (ticks == 0) pos_q8[i] = t;
+    }
+
+    /** Position mode: jump to a 1/100 degree command (per-tick setpoint feeds) */
+    void setPosition(uint8_t i, int32_t cdeg) {
+        if (i >= N) return;
+        mode_of[i] = MODE_POSITION;
+        at_limit[i] = false;
+        target_q8[i] = pos_q8[i] = limit(i, cdeg) << 8;
+        ramp_ticks[i] = 0;
+    }
+
+    /** Close until contact, then hold force_permille; never past limit_deg */
+    void grip(uint8_t i, int16_t force_permille, float limit_deg) {
+        if (i >= N) return;
+        force_target[i] = force_permille > contact ? force_permille : contact;
+        target_q8[i] = limit(i, toCdeg(limit_deg)) << 8;
+        if (mode_of[i] == MODE_HOLD) return;            // Already on the object: new setpoint only
+        mode_of[i] = MODE_APPROACH;
+        at_limit[i] = false;
+        slip_count[i] = 0;
+    }
+
+    /** Change the held force without re-approaching */
+    void setForce(uint8_t i, int16_t force_permille) {
+        if (i < N) force_target[i] = force_permille > contact ? force_permille : contact;
+    }
+
+    /** Fingertip forces, per mille. Call at tick_hz */
+    void tick(const int16_t* force) {
+        for (uint8_t i = 0; i < N; i++) {
+            int32_t f = force[i];
+            last_force[i] = (int16_t)f;
+            switch (mode_of[i]) {
+                case MODE_POSITION:
+                    if (ramp_ticks[i] > 1) {
+                        pos_q8[i] += step_q8[i];
+                        ramp_ticks[i]--;
+                    } else {
+                        pos_q8[i] = target_q8[i];
+                        ramp_ticks[i] = 0;
+                    }
+                    break;
+
+                case MODE_APPROACH:
+                    if (f >= contact) {
+                        enterHold(i, f);
+                        break;
+                    }
+                    if (pos_q8[i] < target_q8[i]) {
+                        pos_q8[i] += approach_step_q8;
+                        if (pos_q8[i] >= target_q8[i]) pos_q8[i] = target_q8[i];
+                    } else if (pos_q8[i] > target_q8[i]) {
+                        pos_q8[i] = target_q8[i];
+                    }
+                    at_limit[i] = pos_q8[i] == target_q8[i];
+                    break;
+
+                case MODE_HOLD:
+                    hold(i, f);
+                    break;
+            }
+        }
+    }
+
+    int32_t positionCdeg(uint8_t i) const { return i < N ? pos_q8[i] >> 8 : 0; }
+    float position(uint8_t i) const { return i < N ? (float)pos_q8[i] / 25600.0f : 0.0f; }
+    Mode mode(uint8_t i) const { return i < N ? (Mode)mode_of[i] : MODE_POSITION; }
+    bool holding(uint8_t i) const { return i < N && mode_of[i] == MODE_HOLD; }
+    /** APPROACH stopped at the grip limit without touching anything */
+    bool reachedLimit(uint8_t i) const { return i < N && at_limit[i]; }
+    /** POSITION mode ramp finished */
+    bool settled(uint8_t i) const { return i < N && mode_of[i] == MODE_POSITION && ramp_ticks[i] == 0; }
+    int16_t forceTarget(uint8_t i) const { return i < N ? force_target[i] : 0; }
+    int32_t forceError(uint8_t i) const { return i < N ? (int32_t)force_target[i] - last_force[i] : 0; }
+    int32_t contactCdeg(uint8_t i) const { return i < N ? contact_cdeg[i] : 0; }
+
+private:
+    uint32_t hz;
+    int32_t approach_step_q8;
+    int16_t contact;
+    int16_t slip;
+    uint8_t slip_ticks;
+    int32_t kp_q16;
+    int32_t ki_tick_q16;
+    int32_t stiffness_q8;
+
+    int32_t lo[N];
+    int32_t hi[N];
+    int32_t pos_q8[N];                  // Command, 1/100 deg Q8
+    int32_t target_q8[N];               // Ramp end (POSITION) or grip limit
+    int32_t step_q8[N];
+    uint32_t ramp_ticks[N];
+    uint8_t mode_of[N];
+    int16_t force_target[N];
+    int32_t contact_cdeg[N];
+    int32_t integ_q16[N];               // Correction past contact, 1/100 deg Q16
+    uint8_t slip_count[N];
+    bool at_limit[N];
+    int16_t last_force[N];
+
+    static int32_t toCdeg(float deg) { return (int32_t)lroundf(deg * 100.0f); }
+    static int32_t clampCdeg(int32_t c) { return c < 0 ? 0 : (c > CDEG_MAX ? CDEG_MAX : c); }
+    int32_t limit(uint8_t i, int32_t c) const { return c < lo[i] ? lo[i] : (c > hi[i] ? hi[i] : c); }
+
+    /** Force error as the indentation change that would remove it, 1/100 deg */
+    int32_t errorCdeg(int32_t e) const {
+        int32_t c = e * 25600 / stiffness_q8;
+        return c < -CDEG_MAX ? -CDEG_MAX : (c > CDEG_MAX ? CDEG_MAX : c);
+    }
+
+    void enterHold(uint8_t i, int32_t f) {
+        mode_of[i] = MODE_HOLD;
+        at_limit[i] = false;
+        slip_count[i] = 0;
+        contact_cdeg[i] = pos_q8[i] >> 8;
+        // Bumpless: the first HOLD command equals the present one
+        integ_q16[i] = -(int32_t)(((int64_t)kp_q16 * errorCdeg(force_target[i] - f)));
+    }
+
+    void hold(uint8_t i, int32_t f) {
+        if (f < slip) {
+            if (++slip_count[i] >= slip_ticks) {
+                mode_of[i] = MODE_APPROACH;             // Lost it: close again from here
+                slip_count[i] = 0;
+                return;
+            }
+        } else {
+            slip_count[i] = 0;
+        }
+
+        int32_t e = errorCdeg(force_target[i] - f);
+        int32_t integ = integ_q16[i] + e * ki_tick_q16;
+        const int32_t integ_max = CDEG_MAX << 16;
+        if (integ > integ_max) integ = integ_max;
+        if (integ < -integ_max) integ = -integ_max;
+
+        int64_t u = ((int64_t)contact_cdeg[i] << 16) + (int64_t)kp_q16 * e + integ;
+        int32_t cmd = (int32_t)(u >> 16);
+        int32_t top = target_q8[i] >> 8;
+        if (cmd > top) {
+            cmd = top;
+            if (e < 0) integ_q16[i] = integ;            // Only integrate away from the limit
+        } else if (cmd < lo[i]) {
+            cmd = lo[i];
+            if (e > 0) integ_q16[i] = integ;
+        } else {
+            integ_q16[i] = integ;
+        }
+        pos_q8[i] = cmd << 8;
+    }
+};
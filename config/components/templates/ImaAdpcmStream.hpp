@@ -0,0 +1,275 @@
+/**
+ * @file ImaAdpcmStream.hpp
+ * @brief Streaming IMA-ADPCM (4:1) clip decoder for the speaker block path
+ *
+ * SUBSYSTEM: any subsystem with i2s_driver (goblin_head speaker first)
+ *
+ * ARCHITECTURE:
+ * - Clip format "P32A" (written by tools/adpcm_encode.py):
+ *     16-byte header: "P32A", u32 sample_rate, u32 sample_count,
+ *                     u16 block_bytes, u8 channels (1), u8 version (1)
+ *     then fixed-size blocks: i16 predictor, u8 step index, u8 reserved,
+ *     (block_bytes - 4) bytes of 4-bit codes, low nibble first
+ * - Every block restarts from its own predictor/step index, so a corrupt or
+ *   skipped chunk costs one block, never the rest of the clip
+ * - Source is a read callback (offset, len): flash-mapped data, a flash
+ *   partition (esp_partition_read) or a FILE on SPIFFS/SD all fit
+ * - decode() fills whatever block size the caller renders (10 ms in
+ *   i2s_driver); one source read per ADPCM block, no full-clip buffer
+ * - prime() reads the first block ahead, so a requester can open a file
+ *   clip off the block path and hand over a stream that starts without I/O
+ *
+ * MEMORY:
+ * - One chunk buffer (MAX_BLOCK_BYTES = 1 KB) + ~24 bytes state
+ * - Clip storage: 0.5 byte/sample, 22 KB per second at 44.1 kHz mono
+ *
+ * TIMING:
+ * - ~15 integer ops per sample, no multiplies in the inner loop
+ *
+ * USAGE:
+ *   static ImaAdpcmStream clip;
+ *   if (clip.open(ImaAdpcmStream::readMemory, &mem_source) == ImaAdpcmStream::OK) {
+ *       size_t got = clip.decode(block, 441);   // < 441 at end of clip
+ *   }
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+class ImaAdpcmStream {
+public:
+    static constexpr size_t HEADER_BYTES = 16;
+    static constexpr size_t BLOCK_HEADER_BYTES = 4;
+    static constexpr size_t MAX_BLOCK_BYTES = 1024;
+    static constexpr uint8_t FORMAT_VERSION = 1;
+
+    enum Result : uint8_t {
+        OK = 0,
+        ERR_READ,           // Source returned short header
+        ERR_FORMAT,         // Magic/version/channel mismatch
+        ERR_BLOCK_SIZE      // block_bytes out of range
+    };
+
+    /**
+     * Source callback: copy len bytes at offset into dst
+     * @return Bytes actually copied (short at end of data)
+     */
+    typedef size_t (*ReadFn)(void* ctx, uint32_t offset, uint8_t* dst, size_t len);
+
+    /** Memory-mapped clip (const data in flash or esp_partition_mmap) */
+    struct MemorySource {
+        const uint8_t* data;
+        size_t size;
+    };
+
+    static size_t readMemory(void* ctx, uint32_t offset, uint8_t* dst, size_t len) {
+        const MemorySource* src = (const MemorySource*)ctx;
+        if (offset >= src->size) return 0;
+        if (len > src->size - offset) len = src->size - offset;
+        memcpy(dst, src->data + offset, len);
+        return len;
+    }
+
+    ImaAdpcmStream() { close(); }
+
+    Result open(ReadFn read_fn, void* read_ctx) {
+        close();
+        uint8_t hdr[HEADER_BYTES];
+        if (!read_fn || read_fn(read_ctx, 0, hdr, HEADER_BYTES) != HEADER_BYTES) return ERR_READ;
+        if (memcmp(hdr, "P32A", 4) != 0 || hdr[14] != 1 || hdr[15] != FORMAT_VERSION) return ERR_FORMAT;
+
+        uint16_t bytes = (uint16_t)(hdr[12] | (hdr[13] << 8));
+        if (bytes <= BLOCK_HEADER_BYTES || bytes > MAX_BLOCK_BYTES) return ERR_BLOCK_SIZE;
+
+        reader = read_fn;
+        reader_ctx = read_ctx;
+        sample_rate = readU32(hdr + 4);
+        sample_count = readU32(hdr + 8);
+        block_bytes = bytes;
+        next_block_offset = HEADER_BYTES;
+        return OK;
+    }
+
+    void close() {
+        reader = nullptr;
+        reader_ctx = nullptr;
+        sample_rate = 0;
+        sample_count = 0;
+        samples_out = 0;
+        block_bytes = 0;
+        block_valid = 0;
+        block_pos = 0;
+        next_block_offset = 0;
+        predictor = 0;
+        step_index = 0;
+        chunk_reads = 0;
+        head_pending = false;
+    }
+
+    /**
+     * Read the first chunk now, so the first decode() does no source I/O.
+     * Call right after open() on the requester's side of a block path.
+     * @return false if the clip has no readable first block
+     */
+    bool prime() {
+        if (!reader || samples_out > 0 || block_valid > 0) return reader != nullptr;
+        if (sample_count == 0) return true;
+        head_pending = loadBlock();
+        return head_pending;
+    }
+
+    bool isOpen() const { return reader != nullptr; }
+    bool finished() const { return !reader || samples_out >= sample_count; }
+    uint32_t sampleRate() const { return sample_rate; }
+    uint32_t sampleCount() const { return sample_count; }
+    uint32_t position() const { return samples_out; }
+    uint32_t chunkReads() const { return chunk_reads; }
+
+    /** Samples one block of block_bytes decodes to */
+    static uint32_t samplesPerBlock(uint16_t block_bytes) {
+        return 1 + 2 * (uint32_t)(block_bytes - BLOCK_HEADER_BYTES);
+    }
+
+    /**
+     * Decode up to count samples, scaled by gain_x256 (256 = unity)
+     * @return Samples written; less than count only at end of clip or on a source error
+     */
+    size_t decode(int16_t* out, size_t count, uint16_t gain_x256 = 256) {
+        size_t n = 0;
+        if (head_pending && count > 0) {
+            head_pending = false;
+            out[n++] = scale(predictor, gain_x256);
+            samples_out++;
+        }
+        while (n < count && samples_out < sample_count) {
+            if (block_pos >= block_valid) {
+                if (!loadBlock()) break;
+                out[n++] = scale(predictor, gain_x256);
+                samples_out++;
+                continue;
+            }
+            uint8_t byte = chunk[block_pos];
+            uint8_t code = nibble_high ? (uint8_t)(byte >> 4) : (uint8_t)(byte & 0x0F);
+            if (nibble_high) block_pos++;
+            nibble_high = !nibble_high;
+
+            out[n++] = scale(step(code), gain_x256);
+            samples_out++;
+        }
+        return n;
+    }
+
+    /**
+     * Encode count samples (<= samplesPerBlock) into one block. Used by the
+     * host tests; tools/adpcm_encode.py implements the same quantiser.
+     * @param step_idx In/out step index carried between blocks
+     * @return Bytes written (always block_bytes; unused codes are zero)
+     */
+    static size_t encodeBlock(const int16_t* pcm, size_t count, uint8_t* block, uint16_t block_bytes, int& step_idx) {
+        memset(block, 0, block_bytes);
+        if (count == 0) return block_bytes;
+        int32_t pred = pcm[0];
+        block[0] = (uint8_t)(pred & 0xFF);
+        block[1] = (uint8_t)((pred >> 8) & 0xFF);
+        block[2] = (uint8_t)step_idx;
+
+        for (size_t i = 1; i < count; i++) {
+            int32_t diff = pcm[i] - pred;
+            int32_t stepsize = STEP_TABLE[step_idx];
+            uint8_t code = 0;
+            if (diff < 0) { code = 8; diff = -diff; }
+            int32_t delta = stepsize >> 3;
+            if (diff >= stepsize) { code |= 4; diff -= stepsize; delta += stepsize; }
+            stepsize >>= 1;
+            if (diff >= stepsize) { code |= 2; diff -= stepsize; delta += stepsize; }
+            stepsize >>= 1;
+            if (diff >= stepsize) { code |= 1; delta += stepsize; }
+
+            pred += (code & 8) ? -delta : delta;
+            if (pred > 32767) pred = 32767;
+            if (pred < -32768) pred = -32768;
+            step_idx += INDEX_TABLE[code];
+            if (step_idx < 0) step_idx = 0;
+            if (step_idx > 88) step_idx = 88;
+
+            size_t byte = BLOCK_HEADER_BYTES + (i - 1) / 2;
+            block[byte] |= ((i - 1) & 1) ? (uint8_t)(code << 4) : code;
+        }
+        return block_bytes;
+    }
+
+private:
+    static constexpr int16_t STEP_TABLE[89] = {
+        7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+        50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+        253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+        1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+        3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487,
+        12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+    };
+    static constexpr int8_t INDEX_TABLE[16] = {
+        -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8
+    };
+
+    ReadFn reader;
+    void* reader_ctx;
+    uint32_t sample_rate;
+    uint32_t sample_count;
+    uint32_t samples_out;
+    uint32_t next_block_offset;
+    uint32_t chunk_reads;
+    uint16_t block_bytes;
+    uint16_t block_valid;       // Bytes of the current chunk that hold codes
+    uint16_t block_pos;
+    bool nibble_high = false;
+    bool head_pending = false;      // prime() loaded block 0, its first sample not yet out
+    int32_t predictor;
+    int32_t step_index;
+    uint8_t chunk[MAX_BLOCK_BYTES];
+
+    static uint32_t readU32(const uint8_t* p) {
+        return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    }
+
+    static int16_t scale(int32_t s, uint16_t gain_x256) {
+        if (gain_x256 == 256) return (int16_t)s;
+        s = (s * gain_x256) >> 8;
+        if (s > 32767) s = 32767;
+        if (s < -32768) s = -32768;
+        return (int16_t)s;
+    }
+
+    bool loadBlock() {
+        size_t got = reader(reader_ctx, next_block_offset, chunk, block_bytes);
+        chunk_reads++;
+        if (got < BLOCK_HEADER_BYTES) {
+            sample_count = samples_out;     // Truncated clip: end cleanly
+            return false;
+        }
+        next_block_offset += block_bytes;
+        predictor = (int16_t)(chunk[0] | (chunk[1] << 8));
+        step_index = chunk[2] > 88 ? 88 : chunk[2];
+        block_pos = BLOCK_HEADER_BYTES;
+        block_valid = (uint16_t)got;
+        nibble_high = false;
+        return true;
+    }
+
+    int32_t step(uint8_t code) {
+        int32_t stepsize = STEP_TABLE[step_index];
+        int32_t delta = stepsize >> 3;
+        if (code & 4) delta += stepsize;
+        if (code & 2) delta += stepsize >> 1;
+        if (code & 1) delta += stepsize >> 2;
+        predictor += (code & 8) ? -delta : delta;
+        if (predictor > 32767) predictor = 32767;
+        if (predictor < -32768) predictor = -32768;
+        step_index += INDEX_TABLE[code];
+        if (step_index < 0) step_index = 0;
+        if (step_index > 88) step_index = 88;
+        return predictor;
+    }
+};
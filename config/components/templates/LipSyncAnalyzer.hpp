@@ -0,0 +1,263 @@
+/**
+ * @file LipSyncAnalyzer.hpp
+ * @brief Audio-driven lip-sync block stage (envelope + coarse viseme + lookahead)
+ *
+ * SUBSYSTEM: goblin_head (ESP32-S3 R8N16), runs inside i2s_driver's block path
+ *
+ * ARCHITECTURE:
+ * - Sits between the audio renderer and the I2S output: every PCM block is
+ *   analysed, then passed on through a short delay line
+ * - Per frame (default 10 ms): mean-abs envelope, zero-crossing rate and a
+ *   one-pole low/high band split - all integer, one pass over the samples
+ * - Coarse viseme: MBP (closed), AH, EH, OH, OO, FS (sibilant). The first
+ *   five ids match GoblinHeadMouthMotor::speakPhoneme()
+ * - Scheduling: every frame produces a MouthCue stamped with the time it
+ *   will actually be heard (sound_ms) and the time it must be issued
+ *   (issue_ms = sound_ms - actuator latency) so the jaw lands on time
+ * - Lookahead: if the output path (DMA queue) is shorter than the actuator
+ *   latency, the delay line holds audio back just long enough that every
+ *   cue can still be issued in the future
+ * - Cues go through a single-producer/single-consumer ring, so the audio
+ *   path (producer) and the mouth loop (consumer) never block each other
+ *
+ * MEMORY:
+ * - Delay line: MAX_DELAY_SAMPLES int16 = 16 KB (put the object in PSRAM
+ *   if SRAM is tight)
+ * - Cue ring: 32 x 12 bytes
+ *
+ * TIMING:
+ * - ~6 integer ops per sample + one classification per frame
+ *
+ * USAGE:
+ *   static LipSyncAnalyzer lip_sync;
+ *   lip_sync.configure(44100, 10, 40, 80);      // 40 ms DMA, 80 ms jaw
+ *   lip_sync.processBlock(render, to_i2s, n, now_ms);
+ *   LipSyncAnalyzer::MouthCue cue;
+ *   while (lip_sync.popDueCue(now_ms, cue)) jaw_write(cue.jaw_open);   // goblin_jaw
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <atomic>
+
+class LipSyncAnalyzer {
+public:
+    static constexpr size_t MAX_DELAY_SAMPLES = 8192;  // 185 ms at 44.1 kHz
+    static constexpr size_t CUE_QUEUE_SIZE = 32;       // Power of two
+    static constexpr uint8_t JAW_OPEN_MAX = 60;        // Matches GoblinHeadMouthMotor::JAW_OPEN_MAX
+
+    enum Viseme : uint8_t {
+        VISEME_AH = 0,      // Wide open vowel
+        VISEME_EH = 1,      // Medium open, spread
+        VISEME_OH = 2,      // Rounded
+        VISEME_OO = 3,      // Tight rounded
+        VISEME_MBP = 4,     // Closed (silence, bilabials)
+        VISEME_FS = 5,      // Sibilant/fricative - teeth nearly closed
+        VISEME_COUNT = 6
+    };
+
+    struct MouthCue {
+        uint32_t issue_ms;  // Command the actuator at this time
+        uint32_t sound_ms;  // When the matching audio reaches the speaker
+        uint8_t viseme;
+        uint8_t jaw_open;   // 0..JAW_OPEN_MAX degrees
+        uint8_t envelope;   // 0..255 loudness of this frame
+    };
+
+    LipSyncAnalyzer() {
+        configure(44100, 10, 0, 0);
+    }
+
+    /**
+     * @param sample_rate_hz Rate of the PCM passing through
+     * @param frame_ms Analysis frame length (10-20 ms)
+     * @param output_latency_ms Time from leaving this stage to leaving the speaker (DMA queue)
+     * @param actuator_latency_ms Time the mouth needs from command to reaching a pose
+     */
+    void configure(uint32_t sample_rate_hz, uint16_t frame_ms, uint16_t output_latency_ms, uint16_t actuator_latency_ms) {
+        sample_rate = sample_rate_hz;
+        frame_samples = (uint32_t)sample_rate_hz * frame_ms / 1000;
+        if (frame_samples == 0) frame_samples = 1;
+        output_latency = output_latency_ms;
+        actuator_latency = actuator_latency_ms;
+
+        // A frame is only classified once complete, i.e. up to one frame after its
+        // first sample entered; the delay line must cover that plus the actuator
+        int32_t needed_ms = (int32_t)actuator_latency_ms + frame_ms - output_latency_ms;
+        uint32_t needed = needed_ms > 0 ? (uint32_t)needed_ms * sample_rate_hz / 1000 : 0;
+        delay_samples = needed < MAX_DELAY_SAMPLES ? needed : MAX_DELAY_SAMPLES;
+
+        reset();
+    }
+
+    /**
+     * @param silence_mean_abs Frames quieter than this close the mouth
+     * @param full_scale_mean_abs Mean-abs level that opens the jaw fully
+     */
+    void setLevels(uint16_t silence_mean_abs, uint16_t full_scale_mean_abs) {
+        silence_level = silence_mean_abs;
+        full_scale_level = full_scale_mean_abs > silence_mean_abs ? full_scale_mean_abs : silence_mean_abs + 1;
+    }
+
+    void reset() {
+        memset(delay_line, 0, sizeof(delay_line));
+        delay_pos = 0;
+        frame_fill = 0;
+        frame_sum_abs = 0;
+        frame_low_energy = 0;
+        frame_high_energy = 0;
+        frame_crossings = 0;
+        lowpass = 0;
+        last_sample = 0;
+        envelope = 0;
+        last_viseme = VISEME_MBP;
+        cue_head.store(0);
+        cue_tail.store(0);
+        dropped_cues = 0;
+    }
+
+    uint16_t addedDelayMs() const { return (uint16_t)(delay_samples * 1000 / sample_rate); }
+    uint32_t droppedCues() const { return dropped_cues; }
+
+    /**
+     * Analyse one block and pass it on delayed. in and out may alias.
+     * @param now_ms Time the block is handed to this stage
+     */
+    void processBlock(const int16_t* in, int16_t* out, size_t count, uint32_t now_ms) {
+        for (size_t i = 0; i < count; i++) {
+            int32_t x = in[i];
+
+            // Features: mean-abs, zero crossings, one-pole split (~900 Hz at 44.1 kHz)
+            frame_sum_abs += (uint32_t)(x < 0 ? -x : x);
+            if ((x ^ last_sample) < 0) frame_crossings++;
+            last_sample = x;
+            lowpass += (x - lowpass) >> 3;
+            int32_t high = x - lowpass;
+            frame_low_energy += (uint32_t)((lowpass * lowpass) >> 10);
+            frame_high_energy += (uint32_t)((high * high) >> 10);
+
+            if (++frame_fill >= frame_samples) {
+                // Sample i leaves this stage after delay_samples more samples
+                int32_t frame_start = (int32_t)i + 1 - (int32_t)frame_samples;
+                int32_t offset_ms = (frame_start + (int32_t)delay_samples) * 1000 / (int32_t)sample_rate;
+                finishFrame(now_ms + output_latency + offset_ms);
+            }
+
+            // Delay line: write new, emit oldest
+            if (delay_samples) {
+                int16_t delayed = delay_line[delay_pos];
+                delay_line[delay_pos] = (int16_t)x;
+                if (++delay_pos >= delay_samples) delay_pos = 0;
+                out[i] = delayed;
+            } else {
+                out[i] = (int16_t)x;
+            }
+        }
+    }
+
+    /**
+     * Consumer side: next cue whose issue time has come. Cues that are
+     * already stale (sound already played) are skipped.
+     */
+    bool popDueCue(uint32_t now_ms, MouthCue& cue) {
+        while (true) {
+            uint32_t tail = cue_tail.load(std::memory_order_relaxed);
+            if (tail == cue_head.load(std::memory_order_acquire)) return false;
+            const MouthCue& next = cues[tail & (CUE_QUEUE_SIZE - 1)];
+            if ((int32_t)(now_ms - next.issue_ms) < 0) return false;
+            cue = next;
+            cue_tail.store(tail + 1, std::memory_order_release);
+            if ((int32_t)(now_ms - cue.sound_ms) <= (int32_t)frame_ms()) return true;
+        }
+    }
+
+    static Viseme classify(uint32_t mean_abs, uint32_t crossings_hz, uint32_t high_ratio_x256, uint16_t silence) {
+        if (mean_abs < silence) return VISEME_MBP;
+        if (high_ratio_x256 > 150 && crossings_hz > 2500) return VISEME_FS;
+        if (crossings_hz < 250) return VISEME_OO;
+        if (crossings_hz < 500) return VISEME_OH;
+        if (crossings_hz < 1100) return VISEME_AH;
+        return VISEME_EH;
+    }
+
+private:
+    uint32_t sample_rate = 44100;
+    uint32_t frame_samples = 441;
+    uint16_t output_latency = 0;
+    uint16_t actuator_latency = 0;
+    uint32_t delay_samples = 0;
+
+    uint16_t silence_level = 300;
+    uint16_t full_scale_level = 8000;
+
+    int16_t delay_line[MAX_DELAY_SAMPLES];
+    uint32_t delay_pos = 0;
+
+    uint32_t frame_fill = 0;
+    uint32_t frame_sum_abs = 0;
+    uint32_t frame_low_energy = 0;
+    uint32_t frame_high_energy = 0;
+    uint32_t frame_crossings = 0;
+    int32_t lowpass = 0;
+    int32_t last_sample = 0;
+    uint32_t envelope = 0;
+    Viseme last_viseme = VISEME_MBP;
+
+    MouthCue cues[CUE_QUEUE_SIZE];
+    std::atomic<uint32_t> cue_head{0};
+    std::atomic<uint32_t> cue_tail{0};
+    uint32_t dropped_cues = 0;
+
+    uint32_t frame_ms() const { return frame_samples * 1000 / sample_rate; }
+
+    void finishFrame(uint32_t sound_ms) {
+        uint32_t mean_abs = frame_sum_abs / frame_samples;
+        uint32_t crossings_hz = frame_crossings * sample_rate / (2 * frame_samples);
+        uint32_t total = frame_low_energy + frame_high_energy;
+        uint32_t high_ratio = total ? (uint32_t)(((uint64_t)frame_high_energy << 8) / total) : 0;
+
+        // Fast attack, slower release - jaws snap open and settle closed
+        if (mean_abs > envelope) envelope += (mean_abs - envelope) * 3 / 4;
+        else envelope -= (envelope - mean_abs) / 2;
+
+        // Shape follows this frame; a silent frame keeps the last shape while
+        // the envelope releases, so the mouth closes instead of snapping shut
+        Viseme v = classify(mean_abs, crossings_hz, high_ratio, silence_level);
+        if (v == VISEME_MBP && envelope >= silence_level) v = last_viseme;
+        last_viseme = v;
+
+        static const uint16_t openness_x256[VISEME_COUNT] = {256, 150, 200, 110, 0, 60};
+        uint32_t level = envelope > silence_level ? envelope - silence_level : 0;
+        uint32_t span = full_scale_level - silence_level;
+        if (level > span) level = span;
+        uint32_t jaw = (uint32_t)JAW_OPEN_MAX * level / span * openness_x256[v] / 256;
+
+        MouthCue cue;
+        cue.sound_ms = sound_ms;
+        cue.issue_ms = sound_ms - actuator_latency;
+        cue.viseme = v;
+        cue.jaw_open = (uint8_t)jaw;
+        uint32_t env8 = envelope * 255 / full_scale_level;
+        cue.envelope = (uint8_t)(env8 > 255 ? 255 : env8);
+        pushCue(cue);
+
+        frame_fill = 0;
+        frame_sum_abs = 0;
+        frame_low_energy = 0;
+        frame_high_energy = 0;
+        frame_crossings = 0;
+    }
+
+    void pushCue(const MouthCue& cue) {
+        uint32_t head = cue_head.load(std::memory_order_relaxed);
+        if (head - cue_tail.load(std::memory_order_acquire) >= CUE_QUEUE_SIZE) {
+            dropped_cues++;     // Consumer stalled - newest cue loses, audio never waits
+            return;
+        }
+        cues[head & (CUE_QUEUE_SIZE - 1)] = cue;
+        cue_head.store(head + 1, std::memory_order_release);
+    }
+};
@@ -0,0 +1,485 @@
+/**
+ * @file MeshCoordinator.hpp
+ * @brief P32 mesh coordinator: CRC16 framing, per-priority receive rings, zero-copy dispatch
+ *
+ * SUBSYSTEM: torso master and every slave controller on the ESP-NOW mesh
+ *            (components/mesh/p32_mesh_coordinator.cpp wraps it in the C API)
+ *
+ * ARCHITECTURE:
+ * - Wire format is p32_mesh_header_t (16 bytes, packed, little endian)
+ *   followed by up to 200 payload bytes. checksum = CRC-16/CCITT-FALSE
+ *   (poly 0x1021, init 0xFFFF) over the first 14 header bytes and the
+ *   payload, i.e. everything but the checksum itself
+ * - CRC is slice-by-4: four 256-entry tables built at compile time (2 KB
+ *   of flash), one table step per 4 bytes instead of 8 shift/xor steps per
+ *   byte. bitwise() and table() are kept as references for the host test
+ * - Receive: one preallocated ring per priority (EMERGENCY, COMMAND,
+ *   STATUS, HEARTBEAT), single producer (the ESP-NOW receive callback or
+ *   a host socket) and single consumer (poll() from the component loop).
+ *   The transport writes the frame straight into a ring slot, either
+ *   reserve() + recv into the slot + commit(), or receive() which does the
+ *   one unavoidable copy out of the driver buffer. commit() validates
+ *   length, magic, destination and CRC before publishing, so a bad frame
+ *   never takes a slot
+ * - Dispatch: poll() always takes the highest non-empty priority, calls
+ *   the handler for the message type with pointers into the slot and
+ *   releases the slot when the handler returns. Nothing is copied; a
+ *   handler that needs the data later copies what it needs
+ * - Sequence numbers run per sender and message type, so a gap seen in
+ *   FIFO order within one ring is a lost frame (ring overflow included)
+ * - Node table: up to 8 nodes keyed by role, online on the first frame,
+ *   offline after node_timeout_ms without one, with a change callback
+ * - Transport is a send function + context (MeshTransport). ESP-NOW on
+ *   the robot, UDP multicast on the host (test/host_support)
+ *
+ * MEMORY: 4 x RING_SLOTS x 224 bytes of slots + ~300 bytes, no heap
+ *
+ * TIMING: commit() of a 216-byte frame is dominated by the CRC, a few
+ *         hundred ns on the host; poll() adds the handler call and a few
+ *         loads per frame. The ESP-NOW callback never blocks
+ *
+ * USAGE:
+ *   static MeshCoordinator<8> mesh;
+ *   MeshCoordinator<8>::Transport radio = { espnow_send, nullptr };
+ *   mesh.begin(P32_ROLE_MASTER, radio, 3000);
+ *   mesh.onMessage(MESH_MSG_STATUS, on_status, nullptr);
+ *   // ESP-NOW receive callback:  mesh.receive(data, len, recv_info->src_addr);
+ *   // component act():          mesh.poll(16, now_ms);
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+static constexpr uint32_t MESH_MAGIC = 0x4D323350u;        // "P32M" on the wire
+static constexpr uint16_t MESH_HEADER_BYTES = 16;
+static constexpr uint16_t MESH_MAX_PAYLOAD = 200;
+static constexpr uint16_t MESH_MAX_FRAME = MESH_HEADER_BYTES + MESH_MAX_PAYLOAD;
+static constexpr uint8_t MESH_MAX_NODES = 8;
+static constexpr uint8_t MESH_BROADCAST = 0xFF;
+
+static constexpr uint8_t MESH_MSG_HEARTBEAT = 0x01;
+static constexpr uint8_t MESH_MSG_COMMAND = 0x02;
+static constexpr uint8_t MESH_MSG_STATUS = 0x03;
+static constexpr uint8_t MESH_MSG_EMERGENCY = 0xFF;
+
+/** Same layout as p32_mesh_header_t */
+struct __attribute__((packed)) MeshHeader {
+    uint32_t magic;
+    uint8_t msg_type;
+    uint8_t source_role;
+    uint8_t dest_role;
+    uint8_t sequence;
+    uint32_t timestamp;
+    uint16_t payload_len;
+    uint16_t checksum;
+};
+static_assert(sizeof(MeshHeader) == MESH_HEADER_BYTES, "MeshHeader must match p32_mesh_header_t");
+
+struct MeshCrc16Tables {
+    uint16_t t[4][256];
+};
+
+/** t[0] is the classic byte table, t[k] advances it over k more zero bytes */
+constexpr MeshCrc16Tables meshCrc16BuildTables() {
+    MeshCrc16Tables tables{};
+    for (int i = 0; i < 256; i++) {
+        uint16_t crc = (uint16_t)(i << 8);
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (uint16_t)((crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1);
+        }
+        tables.t[0][i] = crc;
+    }
+    for (int k = 1; k < 4; k++) {
+        for (int i = 0; i < 256; i++) {
+            uint16_t prev = tables.t[k - 1][i];
+            tables.t[k][i] = (uint16_t)((prev << 8) ^ tables.t[0][prev >> 8]);
+        }
+    }
+    return tables;
+}
+
+class MeshCrc16 {
+public:
+    static constexpr uint16_t INIT = 0xFFFF;
+    static constexpr MeshCrc16Tables TABLES = meshCrc16BuildTables();
+
+    /** Slice-by-4, the routine the coordinator uses */
+    static uint16_t update(uint16_t crc, const uint8_t* p, size_t n) {
+        while (n >= 4) {
+            crc = (uint16_t)(crc ^ (p[0] << 8 | p[1]));
+            crc = (uint16_t)(TABLES.t[3][crc >> 8] ^ TABLES.t[2][crc & 0xFF] ^
+                             TABLES.t[1][p[2]] ^ TABLES.t[0][p[3]]);
+            p += 4;
+            n -= 4;
+        }
+        while (n--) crc = (uint16_t)((crc << 8) ^ TABLES.t[0][(crc >> 8) ^ *p++]);
+        return crc;
+    }
+
+    /** One table lookup per byte (reference) */
+    static uint16_t table(uint16_t crc, const uint8_t* p, size_t n) {
+        while (n--) crc = (uint16_t)((crc << 8) ^ TABLES.t[0][(crc >> 8) ^ *p++]);
+        return crc;
+    }
+
+    /** Eight shift/xor steps per byte (reference) */
+    static uint16_t bitwise(uint16_t crc, const uint8_t* p, size_t n) {
+        while (n--) {
+            crc ^= (uint16_t)(*p++ << 8);
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (uint16_t)((crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1);
+            }
+        }
+        return crc;
+    }
+
+    /** Checksum of a frame: header without its checksum field, then the payload */
+    static uint16_t frame(const uint8_t* frame, uint16_t payload_len) {
+        uint16_t crc = update(INIT, frame, MESH_HEADER_BYTES - 2);
+        return update(crc, frame + MESH_HEADER_BYTES, payload_len);
+    }
+};
+
+template<uint8_t RING_SLOTS>
+class MeshCoordinator {
+    static_assert(RING_SLOTS >= 2 && RING_SLOTS <= 128 && (RING_SLOTS & (RING_SLOTS - 1)) == 0,
+                  "RING_SLOTS must be a power of two in 2..128");
+
+public:
+    static constexpr uint8_t PRIORITIES = 4;    // EMERGENCY, COMMAND, STATUS, HEARTBEAT
+
+    enum Result : uint8_t {
+        OK = 0,
+        ERR_LENGTH,         // Shorter than a header, longer than a frame or payload_len mismatch
+        ERR_MAGIC,
+        ERR_TYPE,           // Unknown message type
+        ERR_CRC,
+        ERR_NOT_FOR_US,     // Other destination, or our own frame echoed back
+        ERR_FULL,           // Ring for this priority is full (frame dropped)
+        ERR_TRANSPORT,      // Transport send failed
+        RESULT_COUNT
+    };
+
+    struct Transport {
+        typedef bool (*SendFn)(void* ctx, uint8_t dest_role, const uint8_t* frame, uint16_t len);
+        SendFn send;
+        void* ctx;
+    };
+
+    /** Handler gets pointers into the ring slot, valid until it returns */
+    typedef void (*Handler)(void* ctx, const MeshHeader* header, const uint8_t* payload,
+                            const uint8_t* src_addr);
+
+    struct Node {
+        uint8_t role;
+        uint8_t addr[6];
+        uint8_t status;                 // p32_node_status_t
+        bool online;
+        uint32_t last_seen_ms;
+        uint32_t messages;
+        uint32_t lost;                  // Sequence gaps
+        uint8_t next_seq[PRIORITIES];
+        uint8_t seq_valid;              // Bit per priority
+    };
+
+    typedef void (*NodeFn)(void* ctx, const Node& node, bool online);
+
+    struct Stats {
+        uint32_t received;                      // Published to a ring
+        uint32_t rejected[RESULT_COUNT];        // By reason
+        uint32_t dispatched[PRIORITIES];
+        uint8_t peak_depth[PRIORITIES];
+        uint32_t sent;
+        uint32_t send_errors;
+    };
+
+    MeshCoordinator() {
+        Transport none = { nullptr, nullptr };
+        begin(0, none, 3000);
+    }
+
+    /** Reset rings, nodes and statistics; handlers stay registered */
+    void begin(uint8_t local_role, Transport transport, uint32_t node_timeout_ms) {
+        role = local_role;
+        link = transport;
+        timeout_ms = node_timeout_ms;
+        for (uint8_t p = 0; p < PRIORITIES; p++) {
+            rings[p].head.store(0, std::memory_order_relaxed);
+            rings[p].tail.store(0, std::memory_order_relaxed);
+            tx_seq[p] = 0;
+        }
+        pending = PRIORITIES;
+        memset(nodes, 0, sizeof(nodes));
+        node_count = 0;
+        memset(&stats, 0, sizeof(stats));
+    }
+
+    void onMessage(uint8_t msg_type, Handler fn, void* ctx) {
+        uint8_t p = priorityOf(msg_type);
+        if (p >= PRIORITIES) return;
+        handlers[p].fn = fn;
+        handlers[p].ctx = ctx;
+    }
+
+    void onNodeChange(NodeFn fn, void* ctx) {
+        node_fn = fn;
+        node_ctx = ctx;
+    }
+
+    // ---- Producer side (transport receive path) ----
+
+    /**
+     * Free slot in the ring for msg_type to receive a frame into, or
+     * nullptr (unknown type, ring full). Follow with commit()
+     */
+    uint8_t* reserve(uint8_t msg_type) {
+        uint8_t p = priorityOf(msg_type);
+        if (p >= PRIORITIES) { stats.rejected[ERR_TYPE]++; return nullptr; }
+        Ring& r = rings[p];
+        uint8_t head = r.head.load(std::memory_order_relaxed);
+        if ((uint8_t)(head - r.tail.load(std::memory_order_acquire)) >= RING_SLOTS) {
+            stats.rejected[ERR_FULL]++;
+            return nullptr;
+        }
+        pending = p;
+        return r.slots[head & MASK].data;
+    }
+
+    /** Validate the frame written into the reserved slot and publish it */
+    Result commit(uint16_t len, const uint8_t* src_addr) {
+        uint8_t p = pending;
+        pending = PRIORITIES;
+        if (p >= PRIORITIES) return reject(ERR_TYPE);
+        Ring& r = rings[p];
+        uint8_t head = r.head.load(std::memory_order_relaxed);
+        Slot& slot = r.slots[head & MASK];
+
+        Result res = check(slot.data, len);
+        if (res != OK) return reject(res);
+        const MeshHeader* h = (const MeshHeader*)slot.data;
+        if (priorityOf(h->msg_type) != p) return reject(ERR_TYPE);
+        if (h->source_role == role || (h->dest_role != role && h->dest_role != MESH_BROADCAST)) {
+            return reject(ERR_NOT_FOR_US);
+        }
+
+        slot.len = len;
+        if (src_addr) memcpy(slot.src, src_addr, 6);
+        else memset(slot.src, 0, 6);
+        r.head.store((uint8_t)(head + 1), std::memory_order_release);
+
+        uint8_t depth = (uint8_t)(head + 1 - r.tail.load(std::memory_order_relaxed));
+        if (depth > stats.peak_depth[p]) stats.peak_depth[p] = depth;
+        stats.received++;
+        return OK;
+    }
+
+    /** Receive from a buffer the driver owns (ESP-NOW callback): one copy into the ring */
+    Result receive(const uint8_t* data, uint16_t len, const uint8_t* src_addr) {
+        if (len < MESH_HEADER_BYTES || len > MESH_MAX_FRAME) return reject(ERR_LENGTH);
+        uint8_t msg_type = ((const MeshHeader*)data)->msg_type;
+        uint8_t* slot = reserve(msg_type);
+        if (!slot) return priorityOf(msg_type) < PRIORITIES ? ERR_FULL : ERR_TYPE;
+        memcpy(slot, data, len);
+        return commit(len, src_addr);
+    }
+
+    // ---- Consumer side (component loop) ----
+
+    /**
+     * Dispatch up to max_frames, highest priority first, then take nodes
+     * that have gone quiet offline. Returns frames dispatched
+     */
+    uint16_t poll(uint16_t max_frames, uint32_t now_ms) {
+        uint16_t done = 0;
+        while (done < max_frames) {
+            uint8_t p = 0;
+            uint8_t tail = 0;
+            for (; p < PRIORITIES; p++) {
+                tail = rings[p].tail.load(std::memory_order_relaxed);
+                if (rings[p].head.load(std::memory_order_acquire) != tail) break;
+            }
+            if (p == PRIORITIES) break;
+
+            Ring& r = rings[p];
+            const Slot& slot = r.slots[tail & MASK];
+            const MeshHeader* h = (const MeshHeader*)slot.data;
+            track(p, h, slot.src, now_ms);
+            if (handlers[p].fn) {
+                handlers[p].fn(handlers[p].ctx, h, slot.data + MESH_HEADER_BYTES, slot.src);
+            }
+            r.tail.store((uint8_t)(tail + 1), std::memory_order_release);
+            stats.dispatched[p]++;
+            done++;
+        }
+        expire(now_ms);
+        return done;
+    }
+
+    /** Frame, seal and hand a message to the transport */
+    Result send(uint8_t msg_type, uint8_t dest_role, const void* payload, uint16_t payload_len,
+                uint32_t now_ms) {
+        uint8_t p = priorityOf(msg_type);
+        if (p >= PRIORITIES) return ERR_TYPE;
+        if (payload_len > MESH_MAX_PAYLOAD) return ERR_LENGTH;
+        uint8_t frame[MESH_MAX_FRAME];
+        MeshHeader h;
+        h.magic = MESH_MAGIC;
+        h.msg_type = msg_type;
+        h.source_role = role;
+        h.dest_role = dest_role;
+        h.sequence = tx_seq[p]++;
+        h.timestamp = now_ms;
+        h.payload_len = payload_len;
+        h.checksum = 0;
+        memcpy(frame, &h, MESH_HEADER_BYTES);
+        if (payload_len) memcpy(frame + MESH_HEADER_BYTES, payload, payload_len);
+        seal(frame);
+
+        uint16_t len = (uint16_t)(MESH_HEADER_BYTES + payload_len);
+        if (!link.send || !link.send(link.ctx, dest_role, frame, len)) {
+            stats.send_errors++;
+            return ERR_TRANSPORT;
+        }
+        stats.sent++;
+        return OK;
+    }
+
+    /** Write the checksum of a framed message (header filled in) */
+    static void seal(uint8_t* frame) {
+        MeshHeader* h = (MeshHeader*)frame;
+        uint16_t crc = MeshCrc16::frame(frame, h->payload_len);
+        memcpy(&h->checksum, &crc, 2);
+    }
+
+    /** Length, magic and CRC of a received frame */
+    static Result check(const uint8_t* frame, uint16_t len) {
+        if (len < MESH_HEADER_BYTES || len > MESH_MAX_FRAME) return ERR_LENGTH;
+        MeshHeader h;
+        memcpy(&h, frame, MESH_HEADER_BYTES);
+        if (h.magic != MESH_MAGIC) return ERR_MAGIC;
+        if (h.payload_len != len - MESH_HEADER_BYTES) return ERR_LENGTH;
+        if (MeshCrc16::frame(frame, h.payload_len) != h.checksum) return ERR_CRC;
+        return OK;
+    }
+
+    /** Ring index for a message type: 0 = most urgent, PRIORITIES if unknown */
+    static uint8_t priorityOf(uint8_t msg_type) {
+        switch (msg_type) {
+            case MESH_MSG_EMERGENCY: return 0;
+            case MESH_MSG_COMMAND:   return 1;
+            case MESH_MSG_STATUS:    return 2;
+            case MESH_MSG_HEARTBEAT: return 3;
+            default:                 return PRIORITIES;
+        }
+    }
+
+    const Node* node(uint8_t node_role) const {
+        for (uint8_t i = 0; i < node_count; i++) {
+            if (nodes[i].role == node_role) return &nodes[i];
+        }
+        return nullptr;
+    }
+    const Node* nodeAt(uint8_t index) const { return index < node_count ? &nodes[index] : nullptr; }
+    uint8_t nodeCount() const { return node_count; }
+    uint8_t onlineCount() const {
+        uint8_t n = 0;
+        for (uint8_t i = 0; i < node_count; i++) n += nodes[i].online ? 1 : 0;
+        return n;
+    }
+
+    uint8_t depth(uint8_t priority) const {
+        const Ring& r = rings[priority];
+        return (uint8_t)(r.head.load(std::memory_order_acquire) - r.tail.load(std::memory_order_acquire));
+    }
+    uint8_t localRole() const { return role; }
+    const Stats& statistics() const { return stats; }
+
+private:
+    static constexpr uint8_t MASK = RING_SLOTS - 1;
+
+    struct Slot {
+        alignas(4) uint8_t data[MESH_MAX_FRAME];
+        uint8_t src[6];
+        uint16_t len;
+    };
+
+    struct Ring {
+        Slot slots[RING_SLOTS];
+        std::atomic<uint8_t> head;      // Written by the producer
+        std::atomic<uint8_t> tail;      // Written by the consumer
+    };
+
+    struct HandlerEntry {
+        Handler fn = nullptr;
+        void* ctx = nullptr;
+    };
+
+    Result reject(Result res) {
+        stats.rejected[res]++;
+        return res;
+    }
+
+    void track(uint8_t p, const MeshHeader* h, const uint8_t* src, uint32_t now_ms) {
+        Node* n = nullptr;
+        for (uint8_t i = 0; i < node_count; i++) {
+            if (nodes[i].role == h->source_role) { n = &nodes[i]; break; }
+        }
+        if (!n) {
+            if (node_count >= MESH_MAX_NODES) return;
+            n = &nodes[node_count++];
+            n->role = h->source_role;
+        }
+        memcpy(n->addr, src, 6);
+        n->last_seen_ms = now_ms;
+        n->messages++;
+
+        uint8_t bit = (uint8_t)(1u << p);
+        if (n->seq_valid & bit) {
+            uint8_t gap = (uint8_t)(h->sequence - n->next_seq[p]);
+            if (gap < 128) n->lost += gap;         // Older sequence: sender restarted
+        }
+        n->next_seq[p] = (uint8_t)(h->sequence + 1);
+        n->seq_valid |= bit;
+
+        if (h->msg_type == MESH_MSG_STATUS && h->payload_len > 0) {
+            n->status = *((const uint8_t*)h + MESH_HEADER_BYTES);
+        } else if (h->msg_type == MESH_MSG_EMERGENCY) {
+            n->status = 5;                          // P32_STATUS_EMERGENCY
+        } else if (n->status == 0) {
+            n->status = 2;                          // P32_STATUS_READY
+        }
+        if (!n->online) {
+            n->online = true;
+            if (node_fn) node_fn(node_ctx, *n, true);
+        }
+    }
+
+    void expire(uint32_t now_ms) {
+        for (uint8_t i = 0; i < node_count; i++) {
+            Node& n = nodes[i];
+            if (n.online && now_ms - n.last_seen_ms > timeout_ms) {
+                n.online = false;
+                n.status = 0;                       // P32_STATUS_OFFLINE
+                n.seq_valid = 0;
+                if (node_fn) node_fn(node_ctx, n, false);
+            }
+        }
+    }
+
+    Ring rings[PRIORITIES];
+    HandlerEntry handlers[PRIORITIES];
+    NodeFn node_fn = nullptr;
+    void* node_ctx = nullptr;
+    Transport link;
+    uint8_t role;
+    uint8_t pending;                // Ring of the reserved slot (producer)
+    uint8_t tx_seq[PRIORITIES];
+    uint32_t timeout_ms;
+    Node nodes[MESH_MAX_NODES];
+    uint8_t node_count;
+    Stats stats;
+};
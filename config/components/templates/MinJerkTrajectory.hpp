@@ -0,0 +1,207 @@
+/**
+ * @file MinJerkTrajectory.hpp
+ * @brief Time-synchronised minimum-jerk trajectories for N coupled axes
+ *
+ * SUBSYSTEM: goblin_head neck (pan / tilt / roll); any multi-axis pose
+ *
+ * ARCHITECTURE:
+ * - moveTo() plans one quintic per axis over a SHARED duration T, so every
+ *   axis arrives on the same tick. T is the longest time any axis needs
+ *   under its own velocity / acceleration limit (min-jerk rest-to-rest
+ *   peaks at 1.875 D/T and 5.774 D/T^2), or the caller's duration if
+ *   that is longer
+ * - Each quintic starts from the axis' present position, velocity and
+ *   acceleration and ends at rest on the target:
+ *       x(s) = c0 + c1 s + c2 s^2 + c3 s^3 + c4 s^4 + c5 s^5,  s = t/T
+ *       c0 = p0, c1 = V, c2 = A/2,      (V = v0 T, A = a0 T^2, D = pf - p0)
+ *       c3 = 10D - 6V - 1.5A,  c4 = -15D + 8V + 1.5A,  c5 = 6D - 3V - 0.5A
+ *   so a new target mid-motion continues with no jump in position,
+ *   velocity or acceleration. From rest this is the classic
+ *   10s^3 - 15s^4 + 6s^5 minimum-jerk profile
+ * - Coefficients are stored in Q16 (1/65536 of the position unit) and
+ *   normalised time in Q24 is derived from the tick count by one multiply
+ *   with a precomputed 2^32 / N, so tick() is a Horner pass per axis
+ *   (5 multiply-shift-adds) with no division and no float. Q24 time keeps
+ *   the setpoint velocity free of tick-to-tick jitter even over thousands
+ *   of ticks; int64 products limit moves to ~250000 units
+ * - The last tick lands exactly on the target (no asymptotic easing)
+ *
+ * MEMORY: 72 bytes per axis + ~20, no heap
+ *
+ * TIMING:
+ *   moveTo(): ~30 float ops per axis plus one sqrt per axis
+ *   tick():   N x 5 int64 multiply-adds
+ *
+ * USAGE:
+ *   MinJerkTrajectory<3> neck;
+ *   neck.configure(100);                     // 100 Hz setpoints
+ *   neck.setLimits(0, 240.0f, 1500.0f);      // pan: deg/s, deg/s^2
+ *   ...
+ *   float target[3] = {45.0f, -10.0f, 5.0f};
+ *   neck.moveTo(target, 0.3f);               // at least 300 ms
+ *   every tick: neck.tick(); send neck.position(i) to the motors
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+
+template<uint8_t N>
+class MinJerkTrajectory {
+public:
+    static constexpr int32_t ONE = 65536;   // Q16 unit
+
+    MinJerkTrajectory() { configure(100); }
+
+    /** @param tick_hz Rate tick() is called at */
+    void configure(uint32_t tick_hz) {
+        hz = tick_hz > 0 ? (float)tick_hz : 1.0f;
+        for (uint8_t i = 0; i < N; i++) {
+            vmax[i] = 1.0e9f;
+            amax[i] = 1.0e9f;
+            for (uint8_t c = 0; c < 6; c++) coef[i][c] = 0;
+            pos_q16[i] = 0;
+        }
+        k = n_ticks = 0;
+        inv_n_q32 = 0;
+        active = false;
+    }
+
+    /** Per-axis limits, units/s and units/s^2 */
+    void setLimits(uint8_t axis, float max_velocity, float max_accel) {
+        if (axis >= N) return;
+        vmax[axis] = max_velocity > 0.0f ? max_velocity : 1.0e9f;
+        amax[axis] = max_accel > 0.0f ? max_accel : 1.0e9f;
+    }
+
+    /** Jump to a pose with no motion (power-up, homing) */
+    void reset(const float* pose) {
+        for (uint8_t i = 0; i < N; i++) {
+            pos_q16[i] = toQ16(pose[i]);
+            for (uint8_t c = 0; c < 6; c++) coef[i][c] = 0;
+            coef[i][0] = pos_q16[i];
+        }
+        k = n_ticks = 0;
+        active = false;
+    }
+
+    /**
+     * Head for a new pose, blending from the present motion
+     * @param target Pose, one value per axis
+     * @param min_duration_s Arrive no sooner than this
+     * @return Planned duration, seconds
+     */
+    float moveTo(const float* target, float min_duration_s = 0.0f) {
+        // Present state in units, units/s, units/s^2
+        float p0[N], v0[N], a0[N];
+        for (uint8_t i = 0; i < N; i++) stateAt(i, p0[i], v0[i], a0[i]);
+
+        // Shared duration: the slowest axis sets the pace for all
+        float T = min_duration_s;
+        for (uint8_t i = 0; i < N; i++) {
+            float d = fabsf(target[i] - p0[i]);
+            // A moving axis also has to shed its present speed
+            float dv = fabsf(v0[i]);
+            float t_v = (1.875f * d + dv * 0.5f) / vmax[i];
+            float t_a = sqrtf(5.774f * d / amax[i]) + dv / amax[i];
+            if (t_v > T) T = t_v;
+            if (t_a > T) T = t_a;
+        }
+
+        uint32_t ticks = (uint32_t)ceilf(T * hz);
+        if (ticks < 1) ticks = 1;
+        T = (float)ticks / hz;
+
+        for (uint8_t i = 0; i < N; i++) {
+            float D = target[i] - p0[i];
+            float V = v0[i] * T;
+            float A = a0[i] * T * T;
+            int64_t* c = coef[i];
+            c[0] = toQ16(p0[i]);
+            c[1] = toQ16(V);
+            c[2] = toQ16(0.5f * A);
+            c[3] = toQ16(10.0f * D - 6.0f * V - 1.5f * A);
+            c[4] = toQ16(-15.0f * D + 8.0f * V + 1.5f * A);
+            // Pin the end point exactly: whatever the rounding, x(1) = target
+            c[5] = toQ16(target[i]) - c[0] - c[1] - c[2] - c[3] - c[4];
+            end_q16[i] = toQ16(target[i]);
+        }
+
+        n_ticks = ticks;
+        inv_n_q32 = (uint32_t)((((uint64_t)1 << 32) + ticks - 1) / ticks);
+        k = 0;
+        active = true;
+        return T;
+    }
+
+    /** Advance one tick; false once every axis is at rest on its target */
+    bool tick() {
+        if (!active) return false;
+        k++;
+        if (k >= n_ticks) {
+            for (uint8_t i = 0; i < N; i++) pos_q16[i] = end_q16[i];
+            active = false;
+            return false;
+        }
+        int64_t s = ((uint64_t)k * inv_n_q32) >> 8;    // t/T in Q24
+        for (uint8_t i = 0; i < N; i++) {
+            const int64_t* c = coef[i];
+            int64_t acc = c[5];
+            acc = ((acc * s) >> 24) + c[4];
+            acc = ((acc * s) >> 24) + c[3];
+            acc = ((acc * s) >> 24) + c[2];
+            acc = ((acc * s) >> 24) + c[1];
+            acc = ((acc * s) >> 24) + c[0];
+            pos_q16[i] = acc;
+        }
+        return true;
+    }
+
+    /** Setpoint in Q16 units (integer consumers) */
+    int32_t positionQ16(uint8_t axis) const { return axis < N ? (int32_t)pos_q16[axis] : 0; }
+
+    /** Setpoint in units */
+    float position(uint8_t axis) const { return axis < N ? (float)pos_q16[axis] / ONE : 0.0f; }
+
+    /** Setpoint velocity, units/s (telemetry, stepper speed hints) */
+    float velocity(uint8_t axis) const {
+        if (axis >= N) return 0.0f;
+        float p, v, a;
+        stateAt(axis, p, v, a);
+        return v;
+    }
+
+    bool isActive() const { return active; }
+    uint32_t ticksRemaining() const { return active ? n_ticks - k : 0; }
+    uint32_t ticksTotal() const { return n_ticks; }
+
+private:
+    float hz;
+    float vmax[N];
+    float amax[N];
+    int64_t coef[N][6];
+    int64_t pos_q16[N];
+    int64_t end_q16[N];
+    uint32_t k;
+    uint32_t n_ticks;
+    uint32_t inv_n_q32;
+    bool active;
+
+    static int64_t toQ16(float v) { return (int64_t)llroundf(v * ONE); }
+
+    // Position, velocity and acceleration of an axis at the present tick
+    void stateAt(uint8_t i, float& p, float& v, float& a) const {
+        p = (float)pos_q16[i] / ONE;
+        if (!active || n_ticks == 0) { v = a = 0.0f; return; }
+        float T = (float)n_ticks / hz;
+        float s = (float)k / (float)n_ticks;
+        const int64_t* c = coef[i];
+        float c1 = (float)c[1] / ONE, c2 = (float)c[2] / ONE, c3 = (float)c[3] / ONE;
+        float c4 = (float)c[4] / ONE, c5 = (float)c[5] / ONE;
+        float dx = c1 + s * (2.0f * c2 + s * (3.0f * c3 + s * (4.0f * c4 + s * 5.0f * c5)));
+        float ddx = 2.0f * c2 + s * (6.0f * c3 + s * (12.0f * c4 + s * 20.0f * c5));
+        v = dx / T;
+        a = ddx / (T * T);
+    }
+};
@@ -0,0 +1,164 @@
+/**
+ * @file MoodDynamics.hpp
+ * @brief Fixed-rate leaky-integrator mood engine with quantized, hysteretic publication
+ *
+ * SUBSYSTEM: goblin_head (goblin_mood), any subsystem that owns the Mood
+ *
+ * ARCHITECTURE:
+ * - One Q16 integrator per mood component (N = Mood::componentCount). Other
+ *   components never write the Mood; they post stimuli here:
+ *     stimulate(c, amount)  impulse, accumulated until the next tick (O(1))
+ *     drive(c, level)       sustained input, e.g. attention -> curiosity
+ * - tick() runs at a fixed rate. Per component:
+ *     x += gain x pending impulses
+ *     x += (baseline + gain x drive - x) x alpha
+ *   alpha = 1 - e^(-1 / (rate x tau)), from a Pade approximation at
+ *   configure time, so every component relaxes to its resting level with
+ *   its own time constant. Personality sets the baselines and gains
+ * - Publication: x is rounded to a multiple of the quantum; a new Mood is
+ *   due only when some component's quantized level has moved at least
+ *   `band` from what was last published. Jitter smaller than the band
+ *   never reaches the display retint or the mesh broadcast. A component
+ *   that has settled back onto its quantized baseline is always published,
+ *   so the resting mood is exact rather than stuck inside the band
+ * - A publication snapshots all components at once (one Mood per change)
+ *
+ * MEMORY: N x 16 bytes + 16, no heap
+ *
+ * TIMING: tick() is N multiply-adds and compares, independent of how many
+ *         stimuli were posted; integer only
+ *
+ * USAGE:
+ *   static MoodDynamics<Mood::componentCount> dynamics;
+ *   dynamics.configure(20, 2, 8);                  // 20 Hz, quantum 4, band 8
+ *   dynamics.setDecay(Mood::FEAR, 2500);
+ *   dynamics.stimulate(Mood::FEAR, 40);            // from any component
+ *   if (dynamics.tick()) publish(dynamics.mood()); // 20 Hz
+ */
+
+#pragma once
+
+#include <cstdint>
+
+template<uint8_t N>
+class MoodDynamics {
+public:
+    static constexpr int32_t UNIT = 65536;              // Q16 per mood unit
+    static constexpr int8_t LEVEL_MAX = 127;
+    static constexpr int8_t LEVEL_MIN = -128;
+
+    MoodDynamics() { configure(20, 2, 8); }
+
+    /**
+     * @param rate_hz tick() rate
+     * @param quant_shift published levels are multiples of 2^quant_shift (0-4)
+     * @param band minimum quantized change that triggers a publication
+     */
+    void configure(uint16_t rate_hz, uint8_t quant_shift, uint8_t band) {
+        hz = rate_hz ? rate_hz : 1;
+        shift = quant_shift > 4 ? 4 : quant_shift;
+        hysteresis = band ? band : 1;
+        for (uint8_t c = 0; c < N; c++) {
+            x[c] = 0;
+            pending[c] = 0;
+            baseline[c] = 0;
+            drive_level[c] = 0;
+            gain_q8[c] = 256;
+            published[c] = 0;
+            setDecay(c, 2000);
+        }
+        publish_count = 0;
+        tick_count = 0;
+        first = true;
+    }
+
+    /** Time constant to relax back to baseline; 0 = follow the target immediately */
+    void setDecay(uint8_t c, uint32_t tau_ms) {
+        if (c >= N) return;
+        uint32_t ticks_x1000 = (uint32_t)hz * tau_ms;
+        int64_t a = ticks_x1000 ? ((int64_t)UNIT * 1000) / (ticks_x1000 + 500) : UNIT;
+        alpha[c] = (int32_t)(a > UNIT ? UNIT : a);
+    }
+
+    /** Resting level the component decays to (personality) */
+    void setBaseline(uint8_t c, int8_t level) {
+        if (c < N) baseline[c] = level;
+    }
+
+    /** Sensitivity to stimuli and drive, Q8 (256 = 1.0) */
+    void setGain(uint8_t c, uint16_t gain) {
+        if (c < N) gain_q8[c] = gain;
+    }
+
+    /** Impulse, applied at the next tick and then decayed */
+    void stimulate(uint8_t c, int16_t amount) {
+        if (c >= N) return;
+        int32_t p = pending[c] + amount;
+        pending[c] = p > 1024 ? 1024 : (p < -1024 ? -1024 : p);
+    }
+
+    /** Sustained input added to the baseline until changed; 0 releases it */
+    void drive(uint8_t c, int8_t level) {
+        if (c < N) drive_level[c] = level;
+    }
+
+    /** Integrate one step. true when a new Mood should be published */
+    bool tick() {
+        bool due = first;
+        for (uint8_t c = 0; c < N; c++) {
+            int32_t target = clampLevel(baseline[c] + ((drive_level[c] * gain_q8[c]) >> 8)) * UNIT;
+            int32_t v = x[c];
+            if (pending[c]) {
+                v += (int32_t)(((int64_t)pending[c] * gain_q8[c] * UNIT) >> 8);
+                pending[c] = 0;
+            }
+            v += (int32_t)(((int64_t)(target - v) * alpha[c]) >> 16);
+            if (v > LEVEL_MAX * UNIT) v = LEVEL_MAX * UNIT;
+            if (v < LEVEL_MIN * UNIT) v = LEVEL_MIN * UNIT;
+            x[c] = v;
+
+            int8_t q = quantize(v);
+            int16_t moved = q - published[c];
+            if (moved >= hysteresis || -moved >= hysteresis) due = true;
+            else if (moved != 0 && q == quantize(baseline[c] * UNIT) && drive_level[c] == 0) due = true;
+        }
+        tick_count++;
+        if (!due) return false;
+        for (uint8_t c = 0; c < N; c++) published[c] = quantize(x[c]);
+        publish_count++;
+        first = false;
+        return true;
+    }
+
+    /** Last published levels */
+    const int8_t* mood() const { return published; }
+    int8_t value(uint8_t c) const { return c < N ? published[c] : 0; }
+    /** Integrator state in whole units (not quantized, not gated) */
+    int16_t level(uint8_t c) const { return c < N ? (int16_t)((x[c] + UNIT / 2) >> 16) : 0; }
+    uint32_t publications() const { return publish_count; }
+    uint32_t ticks() const { return tick_count; }
+
+private:
+    uint16_t hz;
+    uint8_t shift;
+    uint8_t hysteresis;
+    bool first;
+    int32_t x[N];                       // Q16
+    int32_t alpha[N];                   // Q16 per tick
+    int32_t pending[N];                 // Units, summed impulses
+    uint16_t gain_q8[N];
+    int8_t baseline[N];
+    int8_t drive_level[N];
+    int8_t published[N];
+    uint32_t publish_count;
+    uint32_t tick_count;
+
+    static int32_t clampLevel(int32_t v) {
+        return v > LEVEL_MAX ? LEVEL_MAX : (v < LEVEL_MIN ? LEVEL_MIN : v);
+    }
+
+    int8_t quantize(int32_t v) const {
+        int32_t half = (UNIT << shift) >> 1;
+        return (int8_t)clampLevel(((v + half) >> (16 + shift)) * (1 << shift));
+    }
+};
@@ -0,0 +1,181 @@
+/**
+ * @file MoodTintCache.hpp
+ * @brief LRU cache of mood-tinted frames (or palettes) keyed by frame id and quantized mood
+ *
+ * SUBSYSTEM: goblin_head (goblin_eye), any display component that tints
+ *            source art by Mood
+ *
+ * ARCHITECTURE:
+ * - Mood wanders between a handful of nearby states (MoodDynamics publishes
+ *   on a grid with hysteresis), so the eye keeps producing the same tinted
+ *   frames. Each tinted result is stored in an arena the caller allocates
+ *   (PSRAM on the ESP32-S3) and found again by key instead of retinted
+ * - Key = source frame id + the mood snapped to a 2^mood_shift grid. The
+ *   caller tints with the snapped mood (Key::mood), so an entry depends
+ *   only on its key and a hit is exact. The quantized components are
+ *   hashed (FNV-1a) for the scan and compared in full on a hash match
+ * - Entries are fixed size: one tinted frame (240x240x2 bytes) or one
+ *   tinted palette (256x2 bytes). The byte budget sets the slot count,
+ *   capped at MAX_SLOTS
+ * - LRU by use stamp; insert() reuses a free slot or evicts the least
+ *   recently used one and returns it for the caller to fill
+ * - Statistics: lookups, hits, evictions and bytes not retinted
+ *
+ * MEMORY: MAX_SLOTS x 32 bytes + the caller's arena, no heap
+ *
+ * TIMING: find()/insert() scan MAX_SLOTS hashes, well under a microsecond
+ *         against ~1 ms to retint a 240x240 frame from PSRAM
+ *
+ * USAGE:
+ *   static MoodTintCache<16> cache;
+ *   cache.configure(heap_caps_malloc(budget, MALLOC_CAP_SPIRAM), budget, 240 * 240 * 2, 3);
+ *   MoodTintCache<16>::Key key = cache.makeKey(frame_id, mood.components, Mood::componentCount);
+ *   const uint8_t* tinted = cache.find(key);
+ *   if (!tinted) { uint8_t* slot = cache.insert(key); tint(slot, source, key.mood); tinted = slot; }
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+template<uint8_t MAX_SLOTS>
+class MoodTintCache {
+public:
+    static constexpr uint8_t MAX_COMPONENTS = 12;
+
+    struct Key {
+        uint32_t frame_id;
+        uint32_t hash;
+        uint8_t count;
+        int8_t mood[MAX_COMPONENTS];    // Snapped components; tint with these
+    };
+
+    MoodTintCache() { configure(nullptr, 0, 0, 0); }
+
+    /**
+     * @param arena Caller-owned storage (PSRAM), at least budget_bytes
+     * @param budget_bytes Bytes the cache may use; slots = budget / entry_bytes
+     * @param entry_bytes Size of one tinted frame or palette
+     * @param mood_shift Mood grid is 2^mood_shift units (0 = exact)
+     */
+    void configure(uint8_t* arena, uint32_t budget_bytes, uint32_t entry_bytes, uint8_t mood_shift) {
+        storage = arena;
+        entry_size = entry_bytes;
+        shift = mood_shift > 7 ? 7 : mood_shift;
+        uint32_t fit = (arena && entry_bytes) ? budget_bytes / entry_bytes : 0;
+        slot_count = (uint8_t)(fit > MAX_SLOTS ? MAX_SLOTS : fit);
+        lookup_count = 0;
+        hit_count = 0;
+        eviction_count = 0;
+        clear();
+    }
+
+    /** Drop every entry (e.g. the source art was reloaded); keeps statistics */
+    void clear() {
+        for (uint8_t i = 0; i < MAX_SLOTS; i++) entries[i].valid = false;
+        clock = 0;
+    }
+
+    /** Drop the entries of one source frame */
+    void invalidateFrame(uint32_t frame_id) {
+        for (uint8_t i = 0; i < slot_count; i++) {
+            if (entries[i].key.frame_id == frame_id) entries[i].valid = false;
+        }
+    }
+
+    /** Snap mood to the cache grid (bin centre) and hash it with the frame id */
+    Key makeKey(uint32_t frame_id, const int8_t* mood, uint8_t count) const {
+        Key key;
+        key.frame_id = frame_id;
+        key.count = count > MAX_COMPONENTS ? MAX_COMPONENTS : count;
+        uint32_t h = 2166136261u;
+        for (uint8_t i = 0; i < 4; i++) h = (h ^ ((frame_id >> (8 * i)) & 0xFF)) * 16777619u;
+        for (uint8_t i = 0; i < MAX_COMPONENTS; i++) {
+            int8_t q = 0;
+            if (i < key.count) {
+                int16_t snapped = (int16_t)(mood[i] & ~((1 << shift) - 1));   // Floor to the bin
+                if (shift) snapped = (int16_t)(snapped + (1 << (shift - 1)));
+                q = (int8_t)(snapped > 127 ? 127 : snapped);
+            }
+            key.mood[i] = q;
+            h = (h ^ (uint8_t)q) * 16777619u;
+        }
+        key.hash = h;
+        return key;
+    }
+
+    /** Tinted entry for key, or nullptr. Counts a lookup */
+    const uint8_t* find(const Key& key) {
+        lookup_count++;
+        for (uint8_t i = 0; i < slot_count; i++) {
+            Entry& e = entries[i];
+            if (e.valid && sameKey(e.key, key)) {
+                e.used = ++clock;
+                hit_count++;
+                return storage + (uint32_t)i * entry_size;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * Slot for key, to be filled by the caller before the next find().
+     * Evicts the least recently used entry when full; nullptr when the
+     * budget holds no entry at all
+     */
+    uint8_t* insert(const Key& key) {
+        if (slot_count == 0) return nullptr;
+        uint8_t victim = 0;
+        bool full = true;
+        for (uint8_t i = 0; i < slot_count; i++) {
+            if (!entries[i].valid) { victim = i; full = false; break; }
+            if (entries[i].used < entries[victim].used) victim = i;
+        }
+        if (full) eviction_count++;
+        Entry& e = entries[victim];
+        e.key = key;
+        e.valid = true;
+        e.used = ++clock;
+        return storage + (uint32_t)victim * entry_size;
+    }
+
+    static bool sameKey(const Key& a, const Key& b) {
+        return a.hash == b.hash && a.frame_id == b.frame_id && a.count == b.count &&
+               memcmp(a.mood, b.mood, MAX_COMPONENTS) == 0;
+    }
+
+    uint8_t slots() const { return slot_count; }
+    uint8_t used() const {
+        uint8_t n = 0;
+        for (uint8_t i = 0; i < slot_count; i++) n += entries[i].valid ? 1 : 0;
+        return n;
+    }
+    uint32_t entryBytes() const { return entry_size; }
+    uint32_t lookups() const { return lookup_count; }
+    uint32_t hits() const { return hit_count; }
+    uint32_t misses() const { return lookup_count - hit_count; }
+    uint32_t evictions() const { return eviction_count; }
+    /** Hit rate in percent */
+    uint32_t hitRate() const { return lookup_count ? (uint32_t)((uint64_t)hit_count * 100 / lookup_count) : 0; }
+    /** Tinted bytes served from the cache instead of recomputed */
+    uint64_t bytesSaved() const { return (uint64_t)hit_count * entry_size; }
+
+private:
+    struct Entry {
+        Key key;
+        uint32_t used;                  // LRU stamp
+        bool valid;
+    };
+
+    Entry entries[MAX_SLOTS];
+    uint8_t* storage;
+    uint32_t entry_size;
+    uint8_t shift;
+    uint8_t slot_count;
+    uint32_t clock;
+    uint32_t lookup_count;
+    uint32_t hit_count;
+    uint32_t eviction_count;
+
+};
@@ -0,0 +1,331 @@
+/**
+ * @file MultiAxisStepEngine.hpp
+ * @brief Coordinated step/dir generation for up to 8 axes from one timer ISR
+ *
+ * SUBSYSTEM: clearpath_motor_driver (neck_motor_3dof and any multi-stepper rig)
+ *
+ * ARCHITECTURE:
+ * - A segment is a straight move in step space (signed steps per axis)
+ *   with a nominal path speed. Segments are queued in a ring (QUEUE deep)
+ *   by the task side with push(); the timer ISR calls tick() at a fixed
+ *   rate and consumes them in order
+ * - tick(): a phase accumulator advances by the current event rate (Q32
+ *   events per tick); each carry is one Bresenham event: the dominant
+ *   axis steps and every other axis steps when its error term overflows,
+ *   so all axes arrive together on a straight line. The rate ramps by a
+ *   constant per tick (constant acceleration in time) up to the nominal
+ *   rate and, past the segment's decel point, down to its exit rate
+ * - Lookahead: push() computes the junction speed with the previous
+ *   segment from the junction deviation (the corner is rounded by at most
+ *   `junction_dev` steps at the centripetal acceleration limit), then
+ *   re-runs a reverse and a forward pass over the queue so every entry
+ *   speed is reachable from the one before and can still brake to rest at
+ *   the end of the queue. Consecutive moves blend without stopping as
+ *   long as the queue is fed ahead of the ISR
+ * - The executing segment keeps its entry speed; only its exit (and so its
+ *   decel point) may rise when later segments arrive. The ISR re-reads
+ *   those two fields every tick, and carries its actual rate into the next
+ *   segment (capped at the planned entry), so a late update never jumps
+ *   speed
+ * - When the direction of any axis changes at a segment start the ISR
+ *   skips one tick so DIR settles a full tick before the first STEP
+ *
+ * MEMORY: QUEUE x ~64 bytes + ~80
+ *
+ * TIMING:
+ *   tick(): integer only; ~10 ops without an event, + 3 ops per axis on
+ *   an event, one 64-bit divide per segment load
+ *   push(): float, O(QUEUE); call with the step ISR masked
+ *   Max step rate per axis: tick_hz / 2 (pulse high one tick, low the next)
+ *
+ * USAGE:
+ *   MultiAxisStepEngine eng;
+ *   eng.configure(40000, 3, 20000.0f, 4.0f);
+ *   int32_t d[3] = { 800, -200, 50 };
+ *   eng.push(d, 6000.0f);
+ *   // Timer ISR at 40 kHz: clear STEP pins; bits = eng.tick();
+ *   //   write eng.dirBits() to DIR pins, set STEP pins in bits
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+
+class MultiAxisStepEngine {
+public:
+    static constexpr uint8_t MAX_AXES = 8;
+    static constexpr uint8_t QUEUE = 16;                // Power of two
+
+    struct Segment {
+        int32_t steps[MAX_AXES];
+        uint32_t abs_steps[MAX_AXES];
+        uint32_t events;                // Dominant axis steps
+        uint32_t dir_bits;
+        float length;                   // Euclidean, steps
+        float unit[MAX_AXES];
+        float nominal;                  // Path speed, steps/s
+        float entry;                    // Planned path speed at entry
+        float entry_max;                // Junction limit
+
+        // For the ISR, in events (Q32 per tick)
+        uint32_t events_per_len_q16;    // events / length
+        uint32_t entry_rate;
+        uint32_t nominal_rate;
+        uint32_t accel_rate;
+        volatile uint32_t exit_rate;
+        volatile uint32_t decel_after;
+    };
+
+    MultiAxisStepEngine() { configure(40000, 3, 10000.0f, 2.0f); }
+
+    /**
+     * @param tick_hz ISR rate
+     * @param axes Axis count (<= MAX_AXES)
+     * @param accel Path acceleration, steps/s^2
+     * @param junction_dev Corner rounding allowance, steps (0 = stop at every corner)
+     */
+    void configure(uint32_t tick_hz, uint8_t axes, float accel, float junction_dev) {
+        hz = (float)tick_hz;
+        n_axes = axes > MAX_AXES ? MAX_AXES : axes;
+        a = accel > 1.0f ? accel : 1.0f;
+        jdev = junction_dev;
+        // Slowest rate ever used: the speed reached over half a step from rest
+        v_floor = sqrtf(a);
+        clear();
+        for (uint8_t i = 0; i < MAX_AXES; i++) pos[i] = 0;
+        dir = 0;
+    }
+
+    /** Path acceleration for segments pushed from now on */
+    void setAcceleration(float accel) {
+        a = accel > 1.0f ? accel : 1.0f;
+        v_floor = sqrtf(a);
+    }
+
+    /** Drop everything queued and stop at once (e-stop; motors lose no count) */
+    void clear() {
+        head = tail = 0;
+        cur = nullptr;
+        rate = 0;
+        phase = 0;
+        prev_unit_valid = false;
+    }
+
+    /**
+     * Queue a straight move
+     * @param delta Signed steps per axis (n_axes entries)
+     * @param speed Nominal path speed, steps/s
+     * @return false when the queue is full
+     */
+    bool push(const int32_t* delta, float speed) {
+        uint8_t next = (head + 1) & (QUEUE - 1);
+        if (next == tail) return false;
+        Segment& s = queue[head];
+        float len2 = 0.0f;
+        s.events = 0;
+        s.dir_bits = 0;
+        for (uint8_t i = 0; i < MAX_AXES; i++) {
+            int32_t d = i < n_axes ? delta[i] : 0;
+            s.steps[i] = d;
+            s.abs_steps[i] = (uint32_t)(d < 0 ? -d : d);
+            if (d < 0) s.dir_bits |= 1u << i;
+            if (s.abs_steps[i] > s.events) s.events = s.abs_steps[i];
+            len2 += (float)d * (float)d;
+        }
+        if (s.events == 0) return true;
+        s.length = sqrtf(len2);
+        for (uint8_t i = 0; i < MAX_AXES; i++) s.unit[i] = (float)s.steps[i] / s.length;
+        float max_event_speed = 0.5f * hz;
+        float k = (float)s.events / s.length;
+        s.nominal = fminf(fmaxf(speed, v_floor), max_event_speed / k);
+        s.events_per_len_q16 = (uint32_t)(k * 65536.0f + 0.5f);
+        s.accel_rate = (uint32_t)((double)a * k / ((double)hz * hz) * 4294967296.0 + 0.5);
+        if (s.accel_rate == 0) s.accel_rate = 1;
+        s.nominal_rate = toRate(s.nominal * k);
+
+        // Junction speed with the segment before (Grbl's junction deviation)
+        float vj = 0.0f;
+        bool have_prev = head != tail || cur != nullptr;
+        if (have_prev && prev_unit_valid && jdev > 0.0f) {
+            float cos_theta = 0.0f;
+            for (uint8_t i = 0; i < MAX_AXES; i++) cos_theta -= prev_unit[i] * s.unit[i];
+            if (cos_theta < 0.999f) {
+                vj = fminf(prev_nominal, s.nominal);
+                if (cos_theta > -0.999f) {
+                    float sin_half = sqrtf(0.5f * (1.0f - cos_theta));
+                    vj = fminf(vj, sqrtf(a * jdev * sin_half / (1.0f - sin_half)));
+                }
+            }
+        }
+        s.entry_max = vj;
+        s.entry = fminf(vj, sqrtf(2.0f * a * s.length));
+        for (uint8_t i = 0; i < MAX_AXES; i++) prev_unit[i] = s.unit[i];
+        prev_unit_valid = true;
+        prev_nominal = s.nominal;
+
+        head = next;
+        replan();
+        return true;
+    }
+
+    /**
+     * Timer ISR body
+     * @return Bit mask of axes to pulse this tick
+     */
+    uint32_t tick() {
+        if (cur == nullptr) {
+            if (tail == head) {
+                rate = 0;
+                return 0;
+            }
+            load();
+            if (dir_changed) return 0;          // DIR setup time
+        }
+        if (events_done < cur->decel_after) {
+            rate += cur->accel_rate;
+            if (rate > cur->nominal_rate) rate = cur->nominal_rate;
+        } else {
+            uint32_t floor = cur->exit_rate > rate_floor ? cur->exit_rate : rate_floor;
+            rate = (rate > floor + cur->accel_rate) ? rate - cur->accel_rate : floor;
+        }
+        uint32_t before = phase;
+        phase += rate;
+        if (phase >= before) return 0;          // No carry, no event
+
+        // Bresenham event
+        uint32_t bits = 0;
+        const uint32_t ev = cur->events;
+        for (uint8_t i = 0; i < n_axes; i++) {
+            err[i] += cur->abs_steps[i];
+            if (err[i] >= ev) {
+                err[i] -= ev;
+                bits |= 1u << i;
+                pos[i] += (dir >> i) & 1 ? -1 : 1;
+            }
+        }
+        if (++events_done >= ev) {
+            last_k_q16 = cur->events_per_len_q16;
+            cur = nullptr;
+            tail = (tail + 1) & (QUEUE - 1);
+        }
+        return bits;
+    }
+
+    uint32_t dirBits() const { return dir; }
+    int32_t position(uint8_t axis) const { return axis < MAX_AXES ? pos[axis] : 0; }
+    void setPosition(uint8_t axis, int32_t p) { if (axis < MAX_AXES) pos[axis] = p; }
+    bool idle() const { return cur == nullptr && head == tail; }
+    uint8_t queued() const { return (uint8_t)((head - tail) & (QUEUE - 1)); }
+    bool full() const { return ((head + 1) & (QUEUE - 1)) == tail; }
+    uint8_t axes() const { return n_axes; }
+
+    /** Present path speed, steps/s (for telemetry) */
+    float speed() const {
+        uint32_t k = cur != nullptr ? cur->events_per_len_q16 : last_k_q16;
+        if (k == 0) return 0.0f;
+        return (float)rate / 4294967296.0f * hz * 65536.0f / (float)k;
+    }
+
+    /** Planned entry speed of the i-th queued segment (0 = executing or next) */
+    float plannedEntry(uint8_t i) const { return queue[(tail + i) & (QUEUE - 1)].entry; }
+
+private:
+    uint32_t toRate(float events_per_s) const {
+        double r = (double)events_per_s / hz * 4294967296.0;
+        return r >= 2147483648.0 ? 0x80000000u : (uint32_t)r;
+    }
+
+    void load() {
+        cur = &queue[tail];
+        events_done = 0;
+        dir_changed = cur->dir_bits != dir;
+        dir = cur->dir_bits;
+        uint32_t half = cur->events >> 1;
+        for (uint8_t i = 0; i < n_axes; i++) err[i] = half;
+        // Carry the real speed across the junction, never above the plan
+        uint32_t carried = 0;
+        if (rate != 0 && last_k_q16 != 0) {
+            carried = (uint32_t)((uint64_t)rate * cur->events_per_len_q16 / last_k_q16);
+        }
+        rate = carried < cur->entry_rate ? carried : cur->entry_rate;
+        rate_floor = toRate(v_floor * (float)cur->events_per_len_q16 / 65536.0f);
+        if (rate < rate_floor) rate = rate_floor;
+    }
+
+    /** Reverse then forward pass over the queue, then per-segment rates */
+    void replan() {
+        uint8_t start = tail;
+        uint8_t last = (head - 1) & (QUEUE - 1);
+        bool executing = cur != nullptr;
+
+        // Reverse: every entry must be able to brake to the next one.
+        // The executing segment's entry is history and stays as it is
+        if (!(executing && last == start)) {
+            uint8_t first = executing ? (uint8_t)((start + 1) & (QUEUE - 1)) : start;
+            float next_entry = 0.0f;
+            for (uint8_t i = last;; i = (i - 1) & (QUEUE - 1)) {
+                Segment& s = queue[i];
+                s.entry = fminf(s.entry_max, sqrtf(next_entry * next_entry + 2.0f * a * s.length));
+                next_entry = s.entry;
+                if (i == first) break;
+            }
+        }
+
+        // Forward: every entry must be reachable from the one before
+        for (uint8_t i = start; i != last; i = (i + 1) & (QUEUE - 1)) {
+            Segment& s = queue[i];
+            Segment& n = queue[(i + 1) & (QUEUE - 1)];
+            float reach = sqrtf(s.entry * s.entry + 2.0f * a * s.length);
+            if (n.entry > reach) n.entry = reach;
+        }
+
+        // Rates and decel points
+        for (uint8_t i = start;; i = (i + 1) & (QUEUE - 1)) {
+            Segment& s = queue[i];
+            float exit = (i == last) ? 0.0f : queue[(i + 1) & (QUEUE - 1)].entry;
+            float k = (float)s.events / s.length;
+            float vi = s.entry * k, vn = s.nominal * k, vf = exit * k, ak = a * k;
+            float decel_events = (vn * vn - vf * vf) / (2.0f * ak);
+            float accel_events = (vn * vn - vi * vi) / (2.0f * ak);
+            float after;
+            if (accel_events + decel_events > (float)s.events) {
+                after = (2.0f * ak * (float)s.events + vf * vf - vi * vi) / (4.0f * ak);
+            } else {
+                after = (float)s.events - decel_events;
+            }
+            if (after < 0.0f) after = 0.0f;
+            if (&s != cur) s.entry_rate = toRate(vi);
+            s.exit_rate = toRate(vf);
+            s.decel_after = (uint32_t)after;
+            if (i == last) break;
+        }
+    }
+
+    float hz;
+    uint8_t n_axes;
+    float a;
+    float jdev;
+    float v_floor;
+
+    Segment queue[QUEUE];
+    volatile uint8_t head = 0;
+    volatile uint8_t tail = 0;
+
+    // Task side
+    float prev_unit[MAX_AXES];
+    float prev_nominal = 0.0f;
+    bool prev_unit_valid = false;
+
+    // ISR side
+    Segment* volatile cur = nullptr;
+    uint32_t rate = 0;
+    uint32_t rate_floor = 0;
+    uint32_t phase = 0;
+    uint32_t events_done = 0;
+    uint32_t err[MAX_AXES];
+    uint32_t dir = 0;
+    bool dir_changed = false;
+    uint32_t last_k_q16 = 0;
+    volatile int32_t pos[MAX_AXES];
+};
@@ -0,0 +1,203 @@
+/**
+ * @file Pca9685Shadow.hpp
+ * @brief Register shadow and burst planner for one PCA9685 PWM chip
+ *
+ * SUBSYSTEM: servo outputs (arm, hand, torso controllers via pca9685_driver)
+ *
+ * ARCHITECTURE:
+ * - Mirrors LEDn_ON/LEDn_OFF for all 16 channels. Writers only touch the
+ *   shadow; a channel whose value actually changes is marked dirty in a
+ *   16-bit mask. Rewriting the same value costs nothing
+ * - plan() turns the dirty mask into runs of consecutive channels. With
+ *   MODE1.AI (auto-increment) set, one I2C write of
+ *       [LED0_ON_L + 4*first] [ON_L ON_H OFF_L OFF_H] x count
+ *   updates a whole run, so a tick costs one transaction per run instead
+ *   of one per channel. Runs separated by at most max_gap clean channels
+ *   are merged: re-sending a clean channel (4 bytes) is cheaper than the
+ *   START / address / register / STOP and driver setup of another
+ *   transaction
+ * - encode() copies a run into a transfer buffer and clears its dirty
+ *   bits in the same step, so a writer racing the flush either lands
+ *   before the copy (and is sent) or after it (and stays dirty for the
+ *   next flush). If the transfer fails, markDirty() puts the run back
+ * - The shadow also answers reads (present pulse widths) without a bus
+ *   transaction
+ * - flush() is the whole per-chip flush (plan, encode, write, re-queue on
+ *   failure) over a caller-supplied bus, so pca9685_driver.src and the
+ *   host test run the same loop
+ *
+ * MEMORY: 68 bytes, no heap
+ *
+ * TIMING: set() a compare and a store; plan() one pass over 16 bits
+ *
+ * USAGE:
+ *   Pca9685Shadow shadow;
+ *   shadow.set(3, 307);                   // OFF count, ON at 0
+ *   Pca9685Shadow::Run runs[Pca9685Shadow::MAX_RUNS];
+ *   uint8_t n = shadow.plan(runs);
+ *   for each run: len = shadow.encode(runs[i], buf); i2c write buf[0..len)
+ *   // or all of it: shadow.flush(bus, buf), bus = lock()/unlock()/write()
+ */
+
+#pragma once
+
+#include <cstdint>
+
+class Pca9685Shadow {
+public:
+    static constexpr uint8_t CHANNELS = 16;
+    static constexpr uint8_t MAX_RUNS = 8;              // 16 channels, alternating
+    static constexpr uint8_t REG_LED0_ON_L = 0x06;
+    static constexpr uint8_t BYTES_PER_CHANNEL = 4;
+    static constexpr uint8_t MAX_BURST_BYTES = 1 + CHANNELS * BYTES_PER_CHANNEL;
+    static constexpr uint16_t FULL_BIT = 0x1000;        // LEDn_ON_H / OFF_H bit 4
+    static constexpr uint16_t COUNT_MASK = 0x0FFF;
+
+    struct Run {
+        uint8_t first;      // First channel
+        uint8_t count;      // Channels in the burst
+    };
+
+    struct FlushResult {
+        uint8_t transactions;   // Writes issued
+        uint8_t channels;       // Channels carried by them
+        uint8_t errors;         // Failed writes (runs re-queued)
+    };
+
+    Pca9685Shadow() { configure(1); }
+
+    /** @param max_gap Clean channels a burst may re-send to merge two runs */
+    void configure(uint8_t max_gap) {
+        gap = max_gap;
+        reset();
+    }
+
+    /** Power-on register state: every output full-off, nothing to send */
+    void reset() {
+        for (uint8_t ch = 0; ch < CHANNELS; ch++) {
+            on[ch] = 0;
+            off[ch] = FULL_BIT;
+        }
+        dirty = 0;
+    }
+
+    /**
+     * Stage a channel
+     * @param off_count 0-4095 (or FULL_BIT for full off)
+     * @return true if the value changed (channel now dirty)
+     */
+    bool set(uint8_t ch, uint16_t off_count, uint16_t on_count = 0) {
+        if (ch >= CHANNELS) return false;
+        off_count &= (COUNT_MASK | FULL_BIT);
+        on_count &= (COUNT_MASK | FULL_BIT);
+        if (on[ch] == on_count && off[ch] == off_count) return false;
+        on[ch] = on_count;
+        off[ch] = off_count;
+        dirty |= (uint16_t)(1u << ch);
+        return true;
+    }
+
+    /** Output held low (servo unpowered / limp) */
+    bool setFullOff(uint8_t ch) { return set(ch, FULL_BIT, 0); }
+
+    uint16_t offCount(uint8_t ch) const { return ch < CHANNELS ? off[ch] : 0; }
+    uint16_t onCount(uint8_t ch) const { return ch < CHANNELS ? on[ch] : 0; }
+    bool isFullOff(uint8_t ch) const { return ch < CHANNELS && (off[ch] & FULL_BIT); }
+
+    uint16_t dirtyMask() const { return dirty; }
+
+    /** Force channels to be re-sent (chip reset, bus error) */
+    void markDirty(uint16_t mask) { dirty |= mask; }
+    void markDirty(const Run& r) { dirty |= runMask(r); }
+
+    /**
+     * Split the dirty mask into bursts
+     * @param out At least MAX_RUNS entries
+     * @return Number of runs
+     */
+    uint8_t plan(Run* out) const {
+        uint8_t n = 0;
+        uint8_t ch = 0;
+        while (ch < CHANNELS && n < MAX_RUNS) {
+            if (!((dirty >> ch) & 1)) { ch++; continue; }
+            uint8_t first = ch;
+            uint8_t last = ch;
+            uint8_t clean = 0;
+            for (ch++; ch < CHANNELS; ch++) {
+                if ((dirty >> ch) & 1) {
+                    last = ch;
+                    clean = 0;
+                } else if (++clean > gap) {
+                    break;
+                }
+            }
+            out[n].first = first;
+            out[n].count = (uint8_t)(last - first + 1);
+            n++;
+            ch = (uint8_t)(last + 1);
+        }
+        return n;
+    }
+
+    /**
+     * Serialise a run (register address first) and clear its dirty bits
+     * @param buf At least MAX_BURST_BYTES
+     * @return Bytes to write after the device address
+     */
+    uint8_t encode(const Run& r, uint8_t* buf) {
+        uint8_t len = 0;
+        buf[len++] = (uint8_t)(REG_LED0_ON_L + BYTES_PER_CHANNEL * r.first);
+        for (uint8_t ch = r.first; ch < r.first + r.count; ch++) {
+            buf[len++] = (uint8_t)(on[ch] & 0xFF);
+            buf[len++] = (uint8_t)(on[ch] >> 8);
+            buf[len++] = (uint8_t)(off[ch] & 0xFF);
+            buf[len++] = (uint8_t)(off[ch] >> 8);
+        }
+        dirty &= (uint16_t)~runMask(r);
+        return len;
+    }
+
+    /**
+     * Send every dirty run of this chip
+     * @param bus lock()/unlock() guard the shadow against writers (held
+     *            only for plan/encode, never across the write);
+     *            write(buf, len) returns false if the transfer failed
+     * @param buf At least MAX_BURST_BYTES
+     */
+    template<class Bus>
+    FlushResult flush(Bus& bus, uint8_t* buf) {
+        FlushResult result = {0, 0, 0};
+        Run runs[MAX_RUNS];
+        bus.lock();
+        uint8_t n = plan(runs);
+        bus.unlock();
+
+        for (uint8_t r = 0; r < n; r++) {
+            // Copy and clear under the lock; a write landing after this
+            // stays dirty for the next flush
+            bus.lock();
+            uint8_t len = encode(runs[r], buf);
+            bus.unlock();
+
+            result.transactions++;
+            result.channels = (uint8_t)(result.channels + runs[r].count);
+            if (!bus.write(buf, len)) {
+                bus.lock();
+                markDirty(runs[r]);
+                bus.unlock();
+                result.errors++;
+            }
+        }
+        return result;
+    }
+
+    static uint16_t runMask(const Run& r) {
+        return (uint16_t)(((1u << r.count) - 1u) << r.first);
+    }
+
+private:
+    uint16_t on[CHANNELS];
+    uint16_t off[CHANNELS];
+    uint16_t dirty;
+    uint8_t gap;
+};
@@ -0,0 +1,135 @@
+/**
+ * @file PowerGovernor.hpp
+ * @brief State-of-charge driven power level with hysteresis and a per-level load policy
+ *
+ * SUBSYSTEM: flying_dragon power system (flying_dragon_power_system)
+ *
+ * ARCHITECTURE:
+ * - Four levels: FULL, ECO, LOW, CRITICAL. Each has an entry SoC; the
+ *   governor drops a level as soon as SoC falls below its entry point and
+ *   only climbs back once SoC is `hysteresis` above it and has stayed there
+ *   for `dwell_s` (charging, or the OCV correction moving SoC up after a
+ *   hard manoeuvre). Loaded-voltage sag never reaches the governor: it
+ *   works on BatteryEstimator's SoC, which is already sag compensated
+ * - Each level maps to a Policy the rest of the creature acts on:
+ *     period_stretch  - multiplier on hitCount for dispatch entries marked
+ *                       "powerStretch" (cosmetic and slow-sensor work)
+ *     display_pct     - backlight brightness for displays
+ *     frame_divisor   - animation components render every Nth frame
+ * - The policy table is data: configure() can replace it per creature
+ *
+ * MEMORY: ~40 bytes, no heap
+ *
+ * TIMING: a handful of compares per update()
+ *
+ * USAGE:
+ *   PowerGovernor gov;
+ *   gov.update(batt.soc(), 0.01f);
+ *   if (gov.changed()) publish(gov.level(), gov.policy());
+ */
+
+#pragma once
+
+#include <cstdint>
+
+class PowerGovernor {
+public:
+    enum Level : uint8_t { LEVEL_FULL = 0, LEVEL_ECO, LEVEL_LOW, LEVEL_CRITICAL, LEVEL_COUNT };
+
+    struct Policy {
+        uint8_t period_stretch;
+        uint8_t display_pct;
+        uint8_t frame_divisor;
+    };
+
+    PowerGovernor() {
+        static const float ENTER[LEVEL_COUNT] = {1.0f, 0.50f, 0.25f, 0.10f};
+        static const Policy POLICY[LEVEL_COUNT] = {
+            {1, 100, 1},
+            {2, 70, 1},
+            {4, 40, 2},
+            {8, 10, 4},
+        };
+        configure(ENTER, POLICY, 0.05f, 5.0f);
+    }
+
+    /**
+     * @param enter_soc SoC below which each level starts (FULL's entry is ignored)
+     * @param policies Load policy per level
+     * @param hysteresis SoC margin above the entry point needed to climb back
+     * @param dwell_s Time that margin must hold before climbing
+     */
+    void configure(const float enter_soc[LEVEL_COUNT], const Policy policies[LEVEL_COUNT], float hysteresis, float dwell_s) {
+        for (int i = 0; i < LEVEL_COUNT; i++) {
+            enter[i] = enter_soc[i];
+            table[i] = policies[i];
+        }
+        hyst = hysteresis;
+        dwell = dwell_s;
+        reset();
+    }
+
+    void reset() {
+        current = LEVEL_FULL;
+        recover_s = 0.0f;
+        level_changed = false;
+    }
+
+    /** @return The level after this step */
+    Level update(float soc, float dt) {
+        level_changed = false;
+        if (!(soc == soc)) return current;
+
+        // Down: immediately, as far as needed
+        Level target = LEVEL_FULL;
+        for (int i = LEVEL_COUNT - 1; i > LEVEL_FULL; i--) {
+            if (soc < enter[i]) {
+                target = (Level)i;
+                break;
+            }
+        }
+        if (target > current) {
+            current = target;
+            recover_s = 0.0f;
+            level_changed = true;
+            return current;
+        }
+
+        // Up: one level at a time, after the margin has held for the dwell time
+        if (current > LEVEL_FULL && soc >= enter[current] + hyst) {
+            recover_s += dt;
+            if (recover_s >= dwell) {
+                current = (Level)(current - 1);
+                recover_s = 0.0f;
+                level_changed = true;
+            }
+        } else {
+            recover_s = 0.0f;
+        }
+        return current;
+    }
+
+    Level level() const { return current; }
+    bool changed() const { return level_changed; }
+    const Policy& policy() const { return table[current]; }
+    const Policy& policy(Level l) const { return table[l]; }
+
+    static const char* levelName(Level l) {
+        switch (l) {
+            case LEVEL_FULL: return "FULL";
+            case LEVEL_ECO: return "ECO";
+            case LEVEL_LOW: return "LOW";
+            case LEVEL_CRITICAL: return "CRITICAL";
+            default: return "?";
+        }
+    }
+
+private:
+    float enter[LEVEL_COUNT];
+    Policy table[LEVEL_COUNT];
+    float hyst;
+    float dwell;
+    Level current;
+    float recover_s;
+    bool level_changed;
+};
@@ -0,0 +1,207 @@
+/**
+ * @file QuadXMixer.hpp
+ * @brief Quad-X motor mixer with prioritised saturation, plus wing-surface mixing
+ *
+ * SUBSYSTEM: flying_dragon flight system (flying_dragon_motor_controller)
+ *
+ * ARCHITECTURE:
+ * - Motor order and geometry (body x forward, y left, z up; viewed from above):
+ *
+ *         front
+ *      3 FL     1 FR          FR/RL spin CW, FL/RR spin CCW
+ *          \   /              roll  (+x torque): left motors up
+ *           \ /               pitch (+y torque): rear motors up
+ *           / \               yaw   (+z torque): CW motors up (reaction
+ *          /   \                                  torque on the airframe)
+ *      2 RL     0 RR
+ *
+ *   motor_i = T + 0.5 * (roll * R_i + pitch * P_i + yaw * Y_i)
+ *   so a torque demand of 1.0 at T = 0.5 spans the full 0..1 range
+ * - Saturation never clips motors independently (that would turn a roll
+ *   demand into a yaw error). Instead, in priority order:
+ *     1. roll/pitch are scaled together if their spread alone exceeds 0..1
+ *     2. yaw gets whatever spread is left
+ *     3. thrust is shifted so the whole set fits (the craft keeps attitude
+ *        authority at zero and full throttle, at the cost of collective)
+ *   Each cut axis is reported to the controller for anti-windup
+ * - WingSurfaceMixer maps the same torque demand onto the six wing servos
+ *   (shoulder, twist, flap per side) with a per-tick slew limit matching
+ *   the servo speed. The wings are slow trim surfaces; the props carry the
+ *   fast stabilisation
+ *
+ * MEMORY: QuadXMixer 8 bytes, WingSurfaceMixer ~100 bytes, no heap
+ *
+ * TIMING: fixed ~40 float ops per mix(); no loops over data-dependent counts
+ *
+ * USAGE:
+ *   QuadXMixer mixer;
+ *   float motors[4];
+ *   mixer.mix(throttle, torque, motors);          // motors 0..1
+ *   controller.setSaturation(mixer.saturation());
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+class QuadXMixer {
+public:
+    static constexpr int MOTORS = 4;
+
+    enum Motor : uint8_t { REAR_RIGHT = 0, FRONT_RIGHT, REAR_LEFT, FRONT_LEFT };
+
+    QuadXMixer() : min_out(0.0f) {
+        for (int a = 0; a < 3; a++) sat[a] = 0;
+    }
+
+    /** @param idle Lowest output while armed, keeps the props spinning (0..0.2) */
+    void setIdle(float idle) { min_out = idle < 0.0f ? 0.0f : (idle > 0.2f ? 0.2f : idle); }
+
+    /**
+     * @param throttle Collective demand 0..1
+     * @param torque Roll, pitch, yaw demand, nominally -1..1
+     * @param out Motor commands, min_out..1
+     * @return Collective actually applied (differs from throttle when shifted)
+     */
+    float mix(float throttle, const float torque[3], float out[MOTORS]) {
+        float span = 1.0f - min_out;
+        float r = torque[0] * 0.5f * span;
+        float p = torque[1] * 0.5f * span;
+        float y = torque[2] * 0.5f * span;
+        sat[0] = sat[1] = sat[2] = 0;
+
+        // 1. Roll + pitch alone: spread is 2 * (|r| + |p|)
+        float rp = fabsf(r) + fabsf(p);
+        if (2.0f * rp > span) {
+            float k = span / (2.0f * rp);
+            r *= k;
+            p *= k;
+            sat[0] = (int8_t)((torque[0] > 0.0f) - (torque[0] < 0.0f));
+            sat[1] = (int8_t)((torque[1] > 0.0f) - (torque[1] < 0.0f));
+        }
+
+        // 2. Yaw gets the spread roll/pitch left over
+        float a[MOTORS];
+        mixAxes(r, p, 0.0f, a);
+        float y_room = yawRoom(a, y, span);
+        if (y_room < fabsf(y)) {
+            sat[2] = y > 0.0f ? 1 : -1;
+            y = y > 0.0f ? y_room : -y_room;
+        }
+        mixAxes(r, p, y, a);
+
+        // 3. Shift collective so every motor lands in [min_out, 1]
+        float lo = a[0], hi = a[0];
+        for (int i = 1; i < MOTORS; i++) {
+            if (a[i] < lo) lo = a[i];
+            if (a[i] > hi) hi = a[i];
+        }
+        float t = min_out + throttle * span;
+        if (t + hi > 1.0f) t = 1.0f - hi;
+        if (t + lo < min_out) t = min_out - lo;
+        for (int i = 0; i < MOTORS; i++) out[i] = t + a[i];
+        return span > 0.0f ? (t - min_out) / span : 0.0f;
+    }
+
+    /** Per axis: +1 / -1 when the last mix() had to cut that axis, 0 otherwise */
+    const int8_t* saturation() const { return sat; }
+
+private:
+    float min_out;
+    int8_t sat[3];
+
+    static void mixAxes(float r, float p, float y, float a[MOTORS]) {
+        a[REAR_RIGHT] = -r + p - y;
+        a[FRONT_RIGHT] = -r - p + y;
+        a[REAR_LEFT] = r + p + y;
+        a[FRONT_LEFT] = r - p - y;
+    }
+
+    /** Largest |yaw| that keeps the spread of a + yaw pattern within span */
+    static float yawRoom(const float a[MOTORS], float y, float span) {
+        // Yaw adds +m to one diagonal pair (up) and -m to the other (down);
+        // the binding constraint is (max(up) + m) - (min(down) - m) <= span
+        bool cw_up = y >= 0.0f;
+        float u0 = cw_up ? a[FRONT_RIGHT] : a[REAR_RIGHT];
+        float u1 = cw_up ? a[REAR_LEFT] : a[FRONT_LEFT];
+        float d0 = cw_up ? a[REAR_RIGHT] : a[FRONT_RIGHT];
+        float d1 = cw_up ? a[FRONT_LEFT] : a[REAR_LEFT];
+        float up_hi = u0 > u1 ? u0 : u1;
+        float dn_lo = d0 < d1 ? d0 : d1;
+        float m = 0.5f * (span - (up_hi - dn_lo));
+        return m > 0.0f ? m : 0.0f;
+    }
+};
+
+/**
+ * Six wing servos driven from the same torque demand
+ */
+class WingSurfaceMixer {
+public:
+    static constexpr int SERVOS = 6;
+
+    enum Servo : uint8_t {
+        LEFT_SHOULDER = 0, LEFT_TWIST, LEFT_FLAP,
+        RIGHT_SHOULDER, RIGHT_TWIST, RIGHT_FLAP
+    };
+
+    WingSurfaceMixer() {
+        // Rows: roll, pitch, yaw, collective -> deflection (-1..1 of the servo's half range)
+        static const float DEFAULT_GAINS[SERVOS][4] = {
+            {0.0f, 0.0f, 0.6f, 0.3f},       // Shoulders sweep against each other for yaw,
+            {0.8f, 0.5f, 0.0f, 0.0f},       // twist acts as aileron + elevator,
+            {0.0f, 0.0f, 0.0f, 0.4f},       // flaps follow collective (extra lift in a climb)
+            {0.0f, 0.0f, -0.6f, 0.3f},
+            {-0.8f, 0.5f, 0.0f, 0.0f},
+            {0.0f, 0.0f, 0.0f, 0.4f},
+        };
+        for (int s = 0; s < SERVOS; s++) {
+            for (int k = 0; k < 4; k++) gain[s][k] = DEFAULT_GAINS[s][k];
+            pos[s] = 0.0f;
+        }
+        configure(1.0f / 400.0f, 375.0f, 90.0f);
+    }
+
+    /**
+     * @param dt_s Control period
+     * @param servo_dps Servo slew rate (MG996R: 60 deg / 0.16 s)
+     * @param half_range_deg Servo travel either side of neutral
+     */
+    void configure(float dt_s, float servo_dps, float half_range_deg) {
+        max_step = half_range_deg > 0.0f ? servo_dps * dt_s / half_range_deg : 1.0f;
+    }
+
+    void setGain(Servo servo, int input, float g) {
+        if (input >= 0 && input < 4) gain[servo][input] = g;
+    }
+
+    /** Return every surface to neutral immediately (disarmed) */
+    void neutral() {
+        for (int s = 0; s < SERVOS; s++) pos[s] = 0.0f;
+    }
+
+    /**
+     * @param collective Applied collective 0..1 (0.5 = neutral flaps)
+     * @param torque Roll, pitch, yaw demand as given to QuadXMixer
+     * @param out Deflection per servo, -1..1, slew-limited
+     */
+    void mix(float collective, const float torque[3], float out[SERVOS]) {
+        float c = collective * 2.0f - 1.0f;
+        for (int s = 0; s < SERVOS; s++) {
+            float target = gain[s][0] * torque[0] + gain[s][1] * torque[1] + gain[s][2] * torque[2] + gain[s][3] * c;
+            if (target > 1.0f) target = 1.0f;
+            if (target < -1.0f) target = -1.0f;
+            float step = target - pos[s];
+            if (step > max_step) step = max_step;
+            if (step < -max_step) step = -max_step;
+            pos[s] += step;
+            out[s] = pos[s];
+        }
+    }
+
+private:
+    float gain[SERVOS][4];
+    float pos[SERVOS];
+    float max_step;
+};
@@ -0,0 +1,207 @@
+/**
+ * @file SafetyMonitor.hpp
+ * @brief Table-driven safety rule evaluator with debounce, latching and latency accounting
+ *
+ * SUBSYSTEM: flying_dragon flight system (flying_dragon_flight_safety)
+ *
+ * ARCHITECTURE:
+ * - The caller samples every monitored signal into one float array
+ *   (battery volts, tilt, body rate, altitude, heartbeat ages...) and calls
+ *   evaluate() at a fixed period
+ * - Each Rule is one row: signal, ABOVE/BELOW threshold, hold time, action
+ *   and flags. A rule fires once its condition has held continuously for
+ *   hold_ms; a NaN signal counts as violating (a dead sensor must not
+ *   read as healthy)
+ * - Actions are ordered by severity; the result is the most severe action
+ *   among firing and latched rules:
+ *     WARN  - report only
+ *     FLOOR - stop descending (altitude floor)
+ *     LAND  - level out and descend at the landing rate
+ *     KILL  - motors off now
+ * - RULE_LATCH keeps an action after its condition clears, until reset()
+ *   (disarm). RULE_ARMED_ONLY / RULE_AIRBORNE_ONLY skip the row unless the
+ *   matching STATUS_ bit is passed in; RULE_NOT_LANDING skips it during a
+ *   commanded landing
+ * - Latency bookkeeping: every rule records when its condition first
+ *   became true (onset) and when it fired; fired - onset - hold_ms is the
+ *   monitor's own reaction delay, bounded by one evaluation period plus
+ *   scheduling jitter
+ *
+ * MEMORY: MAX_RULES x 24 bytes + 24, no heap
+ *
+ * TIMING: O(rules) compares per evaluate(), no arithmetic beyond the compares
+ *
+ * USAGE:
+ *   static const SafetyMonitor::Rule RULES[] = {
+ *       {SafetyMonitor::SIG_BATTERY_V, SafetyMonitor::BELOW, SafetyMonitor::ACT_LAND,
+ *        SafetyMonitor::RULE_ARMED_ONLY | SafetyMonitor::RULE_LATCH, 11.0f, 2000},
+ *   };
+ *   monitor.configure(RULES, sizeof(RULES) / sizeof(RULES[0]));
+ *   SafetyMonitor::Result r = monitor.evaluate(signals, now_us, SafetyMonitor::STATUS_ARMED);
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+class SafetyMonitor {
+public:
+    static constexpr size_t MAX_RULES = 16;
+
+    enum Signal : uint8_t {
+        SIG_BATTERY_V = 0,
+        SIG_TILT_DEG,           // max(|roll|, |pitch|)
+        SIG_RATE_DPS,           // max |body rate|
+        SIG_ALTITUDE_M,
+        SIG_COMMAND_AGE_MS,     // FlightCommand heartbeat
+        SIG_FUSION_AGE_MS,      // FlightState heartbeat
+        SIG_CONTROL_AGE_MS,     // Motor controller tick heartbeat
+        SIG_COUNT
+    };
+
+    enum Compare : uint8_t { ABOVE = 0, BELOW };
+
+    enum Action : uint8_t { ACT_NONE = 0, ACT_WARN, ACT_FLOOR, ACT_LAND, ACT_KILL };
+
+    enum RuleFlags : uint8_t {
+        RULE_LATCH = 0x01,
+        RULE_ARMED_ONLY = 0x02,         // Same bit as STATUS_ARMED
+        RULE_AIRBORNE_ONLY = 0x04,      // Same bit as STATUS_AIRBORNE
+        RULE_NOT_LANDING = 0x08,
+    };
+
+    enum Status : uint8_t {
+        STATUS_ARMED = 0x02,
+        STATUS_AIRBORNE = 0x04,
+        STATUS_LANDING = 0x08,          // A landing is being commanded
+    };
+
+    struct Rule {
+        uint8_t signal;
+        uint8_t compare;
+        uint8_t action;
+        uint8_t flags;
+        float threshold;
+        uint16_t hold_ms;
+    };
+
+    struct Result {
+        Action action;          // Most severe active action
+        int8_t rule;            // Row that set it, -1 for none
+        bool changed;           // action differs from the previous evaluate()
+        uint32_t onset_us;      // When that row's condition first held
+    };
+
+    SafetyMonitor() : rule_count(0), latched(ACT_NONE), latched_rule(-1), last_action(ACT_NONE) {}
+
+    void configure(const Rule* rules, size_t count) {
+        rule_count = count > MAX_RULES ? MAX_RULES : count;
+        for (size_t i = 0; i < rule_count; i++) table[i] = rules[i];
+        reset();
+    }
+
+    /** Clear latches and debounce state (on disarm) */
+    void reset() {
+        for (size_t i = 0; i < MAX_RULES; i++) {
+            state[i].onset_us = 0;
+            state[i].fired_us = 0;
+            state[i].active = false;
+            state[i].fired = false;
+        }
+        latched = ACT_NONE;
+        latched_rule = -1;
+        last_action = ACT_NONE;
+    }
+
+    /**
+     * @param signals One value per Signal
+     * @param now_us Monotonic time of this evaluation
+     * @param status STATUS_ bits describing the vehicle right now
+     */
+    Result evaluate(const float signals[SIG_COUNT], uint32_t now_us, uint8_t status) {
+        Action best = latched;
+        int8_t best_rule = latched_rule;
+
+        for (size_t i = 0; i < rule_count; i++) {
+            const Rule& r = table[i];
+            RuleState& s = state[i];
+            uint8_t required = r.flags & (RULE_ARMED_ONLY | RULE_AIRBORNE_ONLY);
+            bool applies = (required & ~status) == 0 && !((r.flags & RULE_NOT_LANDING) && (status & STATUS_LANDING));
+            float v = signals[r.signal];
+            // NaN compares false both ways: treat it as a violation
+            bool healthy = r.compare == ABOVE ? (v <= r.threshold) : (v >= r.threshold);
+            if (!applies || healthy) {
+                s.active = false;
+                s.fired = false;
+                continue;
+            }
+            if (!s.active) {
+                s.active = true;
+                s.onset_us = now_us;
+            }
+            if (!s.fired && now_us - s.onset_us >= (uint32_t)r.hold_ms * 1000u) {
+                s.fired = true;
+                s.fired_us = now_us;
+                fire_count++;
+                uint32_t delay = now_us - s.onset_us - (uint32_t)r.hold_ms * 1000u;
+                if (delay > worst_delay_us) worst_delay_us = delay;
+            }
+            if (s.fired) {
+                if (r.action > best) {
+                    best = (Action)r.action;
+                    best_rule = (int8_t)i;
+                }
+                if ((r.flags & RULE_LATCH) && r.action > latched) {
+                    latched = (Action)r.action;
+                    latched_rule = (int8_t)i;
+                }
+            }
+        }
+
+        Result res;
+        res.action = best;
+        res.rule = best_rule;
+        res.changed = best != last_action;
+        res.onset_us = best_rule >= 0 ? state[best_rule].onset_us : 0;
+        last_action = best;
+        return res;
+    }
+
+    const Rule& rule(size_t i) const { return table[i]; }
+    size_t ruleCount() const { return rule_count; }
+
+    /** Time the given row fired (0 if it has not) */
+    uint32_t firedAt(size_t i) const { return state[i].fired ? state[i].fired_us : 0; }
+
+    /** Worst observed fired - onset - hold, microseconds */
+    uint32_t worstDelayUs() const { return worst_delay_us; }
+    uint32_t fireCount() const { return fire_count; }
+
+    static const char* actionName(Action a) {
+        switch (a) {
+            case ACT_WARN: return "WARN";
+            case ACT_FLOOR: return "FLOOR";
+            case ACT_LAND: return "LAND";
+            case ACT_KILL: return "KILL";
+            default: return "NONE";
+        }
+    }
+
+private:
+    struct RuleState {
+        uint32_t onset_us;
+        uint32_t fired_us;
+        bool active;
+        bool fired;
+    };
+
+    Rule table[MAX_RULES];
+    RuleState state[MAX_RULES];
+    size_t rule_count;
+    Action latched;
+    int8_t latched_rule;
+    Action last_action;
+    uint32_t worst_delay_us = 0;
+    uint32_t fire_count = 0;
+};
@@ -0,0 +1,252 @@
+/**
+ * @file SensorFusionEngine.hpp
+ * @brief Timestamped presence / proximity / attention fusion over lock-free sample queues
+ *
+ * SUBSYSTEM: goblin_head (goblin_sensor_fusion), any subsystem with sensors
+ *
+ * ARCHITECTURE:
+ * - One single-producer queue per source (ultrasonic, PIR, touch, mic).
+ *   Each producer component owns one source, so posting is a plain
+ *   acquire/release ring - no CAS, no lock, never blocks; a full ring
+ *   drops the sample and counts it
+ * - Every sample carries the time it was MEASURED, not the time it was
+ *   posted. A sample older than the newest one already seen for its
+ *   source is discarded (stale), so late deliveries never overwrite fresh
+ *   state
+ * - update(now) runs at a fixed rate: drains at most QUEUE samples per
+ *   source, then ages each source's evidence by its own half-life
+ *   (confidence = quality * 2^(-age / half_life), shift + linear
+ *   interpolation, no expf)
+ * - Evidence per source (0-255):
+ *     ultrasonic: confidence x nearness (near_cm -> 255, far_cm -> 0)
+ *     PIR:        confidence while motion is reported
+ *     touch:      confidence while any pad is touched
+ *     mic:        confidence x loudness (loud_level -> 255)
+ * - presence  = noisy-OR of all evidence
+ *   attention = touch, or a blend of nearness, approach speed and sound
+ *   proximity = ultrasonic distance while its confidence holds, 0 on touch
+ *
+ * MEMORY: SRC_COUNT x (QUEUE x 12 + 24) bytes, no heap
+ *
+ * TIMING: O(SRC_COUNT x QUEUE) worst case per update(), integer only
+ *
+ * USAGE:
+ *   static SensorFusionEngine<> fusion;
+ *   fusion.post(SensorFusionEngine<>::SRC_ULTRASONIC, sample);   // producers
+ *   const SensorFusionEngine<>::Output& out = fusion.update(now_ms);   // 20 Hz
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+
+template <size_t QUEUE = 16>
+class SensorFusionEngine {
+    static_assert((QUEUE & (QUEUE - 1)) == 0, "QUEUE must be a power of two");
+
+public:
+    enum Source : uint8_t {
+        SRC_ULTRASONIC = 0,     // value = distance cm, aux = velocity cm/s
+        SRC_PIR,                // value = 1 motion / 0 quiet
+        SRC_TOUCH,              // value = bitmask of touched pads
+        SRC_MIC,                // value = level, aux = azimuth deg x10
+        SRC_COUNT
+    };
+
+    struct Sample {
+        uint32_t t_ms;          // Measurement time
+        int16_t value;
+        int16_t aux;
+        uint8_t quality;        // Producer's own confidence, 255 = certain
+    };
+
+    struct Output {
+        uint32_t t_ms;
+        uint8_t presence;           // Someone is there
+        uint8_t attention;          // ...and is engaging with us
+        uint16_t proximity_cm;      // 0 = touching, 0xFFFF = unknown
+        int16_t approach_cm_s;      // Positive = coming closer
+        int16_t sound_azimuth_x10;
+        uint8_t confidence[SRC_COUNT];
+        uint8_t fresh_sources;      // Sources with non-zero confidence
+        bool valid;
+    };
+
+    struct Stats {
+        uint32_t applied;
+        uint32_t stale;         // Older than the newest sample of its source
+        uint32_t max_drained;   // Most samples handled in one update()
+    };
+
+    SensorFusionEngine() {
+        for (size_t s = 0; s < SRC_COUNT; s++) {
+            sources[s].last.t_ms = 0;
+            sources[s].last.value = 0;
+            sources[s].last.aux = 0;
+            sources[s].last.quality = 0;
+            sources[s].seen = false;
+        }
+        half_life_ms[SRC_ULTRASONIC] = 400;
+        half_life_ms[SRC_PIR] = 3000;       // PIR re-arms slowly; hold its evidence
+        half_life_ms[SRC_TOUCH] = 1500;
+        half_life_ms[SRC_MIC] = 800;
+        stats.applied = 0;
+        stats.stale = 0;
+        stats.max_drained = 0;
+        out = Output();
+        out.proximity_cm = 0xFFFF;
+    }
+
+    /**
+     * @param near_cm / far_cm Ultrasonic nearness ramp
+     * @param loud_level Mic level giving full sound evidence
+     * @param approach_cm_s Approach speed giving full approach attention
+     */
+    void configure(uint16_t near_cm, uint16_t far_cm, int16_t loud_level, int16_t approach_cm_s) {
+        near = near_cm;
+        far = far_cm > near_cm ? far_cm : (uint16_t)(near_cm + 1);
+        loud = loud_level > 0 ? loud_level : 1;
+        approach_full = approach_cm_s > 0 ? approach_cm_s : 1;
+    }
+
+    void setHalfLife(Source source, uint16_t ms) {
+        if (source < SRC_COUNT) half_life_ms[source] = ms ? ms : 1;
+    }
+
+    // ---- Producer side (one producer per source, never blocks) ----
+
+    bool post(Source source, const Sample& sample) {
+        if (source >= SRC_COUNT) return false;
+        Ring& r = rings[source];
+        uint32_t head = r.head.load(std::memory_order_relaxed);
+        if (head - r.tail.load(std::memory_order_acquire) >= QUEUE) {
+            r.dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        r.cells[head & (QUEUE - 1)] = sample;
+        r.head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // ---- Consumer side (fusion task only) ----
+
+    const Output& update(uint32_t now_ms) {
+        uint32_t drained = 0;
+        for (size_t s = 0; s < SRC_COUNT; s++) {
+            Ring& r = rings[s];
+            uint32_t tail = r.tail.load(std::memory_order_relaxed);
+            uint32_t head = r.head.load(std::memory_order_acquire);
+            uint32_t n = head - tail;
+            if (n > QUEUE) n = QUEUE;
+            for (uint32_t i = 0; i < n; i++) {
+                apply(sources[s], r.cells[(tail + i) & (QUEUE - 1)], now_ms);
+            }
+            r.tail.store(tail + n, std::memory_order_release);
+            drained += n;
+        }
+        if (drained > stats.max_drained) stats.max_drained = drained;
+
+        uint8_t ev[SRC_COUNT];
+        out.fresh_sources = 0;
+        for (size_t s = 0; s < SRC_COUNT; s++) {
+            out.confidence[s] = confidence((Source)s, now_ms);
+            if (out.confidence[s]) out.fresh_sources++;
+        }
+
+        // Ultrasonic: nearness and approach
+        const Sample& us = sources[SRC_ULTRASONIC].last;
+        uint32_t c_us = out.confidence[SRC_ULTRASONIC];
+        uint32_t nearness = 0;
+        if (c_us && us.value >= 0) {
+            if (us.value <= near) nearness = 255;
+            else if (us.value < far) nearness = 255u * (uint32_t)(far - us.value) / (uint32_t)(far - near);
+        }
+        ev[SRC_ULTRASONIC] = (uint8_t)(c_us * nearness / 255);
+        out.proximity_cm = (c_us >= 64 && us.value >= 0) ? (uint16_t)us.value : 0xFFFF;
+        out.approach_cm_s = c_us >= 64 ? (int16_t)-us.aux : 0;
+
+        ev[SRC_PIR] = sources[SRC_PIR].last.value ? out.confidence[SRC_PIR] : 0;
+        ev[SRC_TOUCH] = sources[SRC_TOUCH].last.value ? out.confidence[SRC_TOUCH] : 0;
+        if (ev[SRC_TOUCH] >= 128) out.proximity_cm = 0;
+
+        const Sample& mic = sources[SRC_MIC].last;
+        int32_t level = mic.value < 0 ? 0 : (mic.value > loud ? loud : mic.value);
+        ev[SRC_MIC] = (uint8_t)((uint32_t)out.confidence[SRC_MIC] * (uint32_t)level / (uint32_t)loud);
+        out.sound_azimuth_x10 = ev[SRC_MIC] ? mic.aux : 0;
+
+        // Noisy-OR: presence is missed only if every source misses it
+        uint32_t miss = 255;
+        for (size_t s = 0; s < SRC_COUNT; s++) miss = miss * (255u - ev[s]) / 255u;
+        out.presence = (uint8_t)(255u - miss);
+
+        int32_t approach = out.approach_cm_s > 0 ? out.approach_cm_s : 0;
+        if (approach > approach_full) approach = approach_full;
+        uint32_t approach_ev = c_us * (uint32_t)approach / (uint32_t)approach_full;
+        uint32_t blend = (3u * ev[SRC_ULTRASONIC] + approach_ev + ev[SRC_MIC] + ev[SRC_PIR] / 2u) / 4u;
+        if (blend > 255) blend = 255;
+        out.attention = (uint8_t)(ev[SRC_TOUCH] > blend ? ev[SRC_TOUCH] : blend);
+
+        out.t_ms = now_ms;
+        out.valid = out.fresh_sources > 0;
+        return out;
+    }
+
+    const Output& output() const { return out; }
+    const Stats& getStats() const { return stats; }
+
+    /** Producer-side drops (ring full) for one source */
+    uint32_t droppedCount(Source source) const {
+        return source < SRC_COUNT ? rings[source].dropped.load(std::memory_order_relaxed) : 0;
+    }
+
+private:
+    struct Ring {
+        std::atomic<uint32_t> head{0};
+        std::atomic<uint32_t> tail{0};
+        std::atomic<uint32_t> dropped{0};
+        Sample cells[QUEUE];
+    };
+
+    struct SourceState {
+        Sample last;
+        bool seen;
+    };
+
+    Ring rings[SRC_COUNT];
+    SourceState sources[SRC_COUNT];
+    uint16_t half_life_ms[SRC_COUNT];
+    uint16_t near = 30;
+    uint16_t far = 150;
+    int16_t loud = 2000;
+    int16_t approach_full = 50;
+    Stats stats;
+    Output out;
+
+    void apply(SourceState& src, const Sample& sample, uint32_t now_ms) {
+        if (src.seen && (int32_t)(sample.t_ms - src.last.t_ms) < 0) {
+            stats.stale++;
+            return;
+        }
+        src.last = sample;
+        // A clock ahead of ours must not make the sample look fresher than now
+        if ((int32_t)(src.last.t_ms - now_ms) > 0) src.last.t_ms = now_ms;
+        src.seen = true;
+        stats.applied++;
+    }
+
+    uint8_t confidence(Source s, uint32_t now_ms) const {
+        const SourceState& src = sources[s];
+        if (!src.seen) return 0;
+        int32_t age = (int32_t)(now_ms - src.last.t_ms);
+        if (age <= 0) return src.last.quality;
+        uint32_t hl = half_life_ms[s];
+        uint32_t halvings = (uint32_t)age / hl;
+        if (halvings >= 8) return 0;
+        uint32_t c = (uint32_t)src.last.quality >> halvings;
+        // Linear between halvings: within 6% of the exponential
+        c -= (c * ((uint32_t)age % hl)) / (2u * hl);
+        return (uint8_t)c;
+    }
+};
@@ -0,0 +1,360 @@
+/**
+ * @file StepperMotionPlanner.hpp
+ * @brief Trapezoidal (AVR446) and jerk-limited S-curve step interval tables
+ *
+ * SUBSYSTEM: any StepperController (goblin neck, eyes, mouth; arms, legs)
+ *
+ * ARCHITECTURE:
+ * - plan() runs once per point-to-point move (rest to rest) and fills a
+ *   table with the timer interval of every step of the acceleration ramp.
+ *   The deceleration ramp is the same table read backwards and the cruise
+ *   is one constant, so the step ISR only ever does
+ *       pulse STEP; reload timer with nextInterval()
+ * - Intervals are kept in 1/256 tick (Q8); nextInterval() carries the
+ *   fraction into the next step, so timing stays exact on average even
+ *   when one tick is a sizeable part of an interval
+ * - TRAPEZOID: the AVR446 integer recurrence
+ *       c0 = 0.676 * f * sqrt(2 / a)
+ *       c[n] = c[n-1] - (2 c[n-1] + r) / (4n + 1),  r = remainder carried
+ *   (constant acceleration, infinite jerk at the phase joins)
+ * - S_CURVE: jerk-limited ramp, 0 -> v_peak in three phases
+ *   (jerk +J, accel A, jerk -J; the middle one vanishes for short ramps).
+ *   The time of step n is found by Newton's method on the piecewise-cubic
+ *   position, warm-started from the previous step; the interval to step
+ *   n+1 is then solved on the local cubic, which keeps it accurate where
+ *   absolute float times would already have lost ticks
+ * - Short moves never reach v_max: v_peak is lowered until both ramps fit
+ *   in the distance (closed form for trapezoid, bisection for S-curve)
+ * - Ramps longer than MAX_RAMP steps keep the first FINE_STEPS intervals
+ *   one per step (that is where the interval changes fastest), then one
+ *   sample every `stride` steps; steps in between are interpolated
+ *   linearly, so speed stays continuous instead of jumping per group
+ * - stop() turns the remaining motion into the mirror of the ramp from
+ *   the current speed (controlled stop, no position loss)
+ *
+ * MEMORY: MAX_RAMP x 4 bytes + ~60, no heap
+ *
+ * TIMING:
+ *   plan(): TRAPEZOID one integer divide per ramp step,
+ *           S_CURVE a few Newton iterations per stored step
+ *           (+ 40 bisection steps on short moves)
+ *   nextInterval(): a compare, a table load and a shift (plus one
+ *   multiply and two divides past FINE_STEPS on strided ramps)
+ *
+ * USAGE:
+ *   StepperMotionPlanner planner;
+ *   planner.configure(1000000, 2000.0f, 8000.0f, 200000.0f, StepperMotionPlanner::S_CURVE);
+ *   planner.plan(1200);
+ *   uint32_t ticks;
+ *   while ((ticks = planner.nextInterval()) != 0) { wait(ticks); pulse(); }
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+
+class StepperMotionPlanner {
+public:
+    static constexpr uint32_t MAX_RAMP = 512;
+    static constexpr uint32_t FINE_STEPS = MAX_RAMP / 2;   // Stored one per step before any striding
+    static constexpr uint32_t FRAC_BITS = 8;
+
+    enum Profile : uint8_t { CONSTANT = 0, TRAPEZOID, S_CURVE };
+
+    StepperMotionPlanner() {
+        configure(1000000, 1000.0f, 0.0f, 0.0f, CONSTANT);
+    }
+
+    /**
+     * @param tick_hz Step timer resolution
+     * @param v_max Cruise speed, steps/s
+     * @param a_max Acceleration, steps/s^2 (0 -> CONSTANT)
+     * @param j_max Jerk, steps/s^3 (S_CURVE only)
+     * @param profile Velocity profile shape
+     */
+    void configure(uint32_t tick_hz, float v_max, float a_max, float j_max, Profile profile) {
+        f = (float)tick_hz;
+        vmax = v_max > 1.0f ? v_max : 1.0f;
+        amax = a_max;
+        jmax = j_max;
+        shape = profile;
+        if (shape != CONSTANT && amax <= 0.0f) shape = CONSTANT;
+        if (shape == S_CURVE && jmax <= 0.0f) shape = TRAPEZOID;
+        total = 0;
+        done = 0;
+        ramp_len = 0;
+        decel_from = 0;
+    }
+
+    void setMaxSpeed(float v_max) { vmax = v_max > 1.0f ? v_max : 1.0f; }
+    float maxSpeed() const { return vmax; }
+    Profile profile() const { return shape; }
+
+    /**
+     * Plan a rest-to-rest move
+     * @param steps Distance, always positive (direction is the caller's)
+     */
+    void plan(uint32_t steps) {
+        total = steps;
+        done = 0;
+        frac = 0;
+        ramp_len = 0;
+        stride = 1;
+        last_m = 0;
+        table_len = 0;
+        peak = vmax;
+        cruise_q8 = toQ8(1.0f / vmax);
+        decel_from = total;
+        if (steps == 0 || shape == CONSTANT) return;
+
+        // Highest peak speed whose two ramps fit in the distance
+        float v = vmax;
+        if (2.0f * rampDistance(v) > (float)steps) {
+            if (shape == TRAPEZOID) {
+                v = sqrtf(amax * (float)steps);
+            } else {
+                float lo = 0.0f, hi = v;
+                for (int i = 0; i < 40; i++) {
+                    float mid = 0.5f * (lo + hi);
+                    if (2.0f * rampDistance(mid) > (float)steps) hi = mid; else lo = mid;
+                }
+                v = lo;
+            }
+        }
+        peak = v;
+        cruise_q8 = toQ8(1.0f / v);
+
+        uint32_t ramp = (uint32_t)rampDistance(v);
+        if (ramp > steps / 2) ramp = steps / 2;
+        if (ramp == 0) ramp = 1;
+        ramp_len = ramp;
+        if (ramp > MAX_RAMP) {
+            // Samples at m = 0, stride, 2 stride ... and the last step
+            last_m = ramp - 1 - FINE_STEPS;
+            const uint32_t groups = MAX_RAMP - FINE_STEPS - 2;
+            stride = (last_m + groups - 1) / groups;
+        }
+
+        if (shape == TRAPEZOID) buildTrapezoid(); else buildSCurve(v);
+        decel_from = total > 2 * ramp_len ? total - ramp_len : ramp_len;
+    }
+
+    /**
+     * Interval to wait before the next step, in timer ticks; 0 when the move is done.
+     * Each call accounts for one step.
+     */
+    uint32_t nextInterval() {
+        if (done >= total) return 0;
+        uint32_t q = intervalQ8(done++) + frac;
+        frac = q & ((1u << FRAC_BITS) - 1);
+        uint32_t ticks = q >> FRAC_BITS;
+        return ticks > 0 ? ticks : 1;
+    }
+
+    /**
+     * Decelerate to rest as fast as the profile allows from where we are now
+     * @return Steps still to go
+     */
+    uint32_t stop() {
+        if (done >= total) return 0;
+        if (shape == CONSTANT) {
+            total = done;
+            return 0;
+        }
+        if (done >= decel_from) return total - done;    // Already decelerating
+        // Ramp index that matches the present speed
+        uint32_t level = done < ramp_len ? done : ramp_len;
+        total = done + level;
+        decel_from = done;
+        return level;
+    }
+
+    bool active() const { return done < total; }
+    uint32_t stepsDone() const { return done; }
+    uint32_t stepsTotal() const { return total; }
+    uint32_t remaining() const { return total - done; }
+    uint32_t rampSteps() const { return ramp_len; }
+    uint32_t rampStride() const { return stride; }
+    float peakSpeed() const { return peak; }
+
+    /** Duration of the planned move, seconds */
+    float plannedDuration() const {
+        uint64_t q = 0;
+        for (uint32_t n = 0; n < total; n++) q += intervalQ8(n);
+        return (float)(q >> FRAC_BITS) / f;
+    }
+
+private:
+    uint32_t toQ8(float seconds) const {
+        return (uint32_t)(seconds * f * (float)(1u << FRAC_BITS) + 0.5f);
+    }
+
+    uint32_t intervalQ8(uint32_t n) const {
+        if (shape == CONSTANT || (n >= ramp_len && n < decel_from)) return cruise_q8;
+        return entry(n < ramp_len ? n : total - 1 - n);
+    }
+
+    /** Distance covered while accelerating from rest to v */
+    float rampDistance(float v) const {
+        if (shape == TRAPEZOID) return v * v / (2.0f * amax);
+        // S-curve ramp is symmetric about its midpoint: mean speed v/2
+        float t1, t2;
+        sCurveTimes(v, t1, t2);
+        return 0.5f * v * (2.0f * t1 + t2);
+    }
+
+    /** Jerk and constant-accel phase lengths for a ramp to v */
+    void sCurveTimes(float v, float& t1, float& t2) const {
+        if (v * jmax >= amax * amax) {
+            t1 = amax / jmax;
+            t2 = v / amax - t1;
+        } else {
+            t1 = sqrtf(v / jmax);
+            t2 = 0.0f;
+        }
+    }
+
+    uint32_t entry(uint32_t n) const {
+        if (n < FINE_STEPS || stride == 1) return n < table_len ? table[n] : cruise_q8;
+        // Coarse region: interpolate between the samples either side
+        uint32_t m = n - FINE_STEPS;
+        uint32_t g = m / stride;
+        uint32_t i = FINE_STEPS + g;
+        if (i + 1 >= table_len) return table[table_len - 1];
+        uint32_t span = (g + 1) * stride <= last_m ? stride : last_m - g * stride;
+        int64_t c0 = table[i], c1 = table[i + 1];
+        return (uint32_t)(c0 - (c0 - c1) * (int64_t)(m - g * stride) / (int64_t)span);
+    }
+
+    bool sampled(uint32_t n) const {
+        if (n < FINE_STEPS || stride == 1) return true;
+        uint32_t m = n - FINE_STEPS;
+        return m % stride == 0 || m == last_m;
+    }
+
+    void record(uint32_t q8) {
+        table[table_len++] = q8 < cruise_q8 ? cruise_q8 : q8;
+    }
+
+    void buildTrapezoid() {
+        // AVR446: first interval with the 0.676 correction, then the integer recurrence (in Q8)
+        uint64_t c = toQ8(0.676f * sqrtf(2.0f / amax));
+        uint64_t rest = 0;
+        for (uint32_t n = 0; n < ramp_len; n++) {
+            if (n > 0) {
+                uint64_t den = 4 * (uint64_t)n + 1;
+                uint64_t num = 2 * c + rest;
+                c -= num / den;
+                rest = num % den;
+            }
+            if (sampled(n)) record((uint32_t)c);
+        }
+    }
+
+    struct Ramp {
+        float a, tb, tc, tend, v1, s1, v2, s2, vpeak;
+    };
+
+    void buildSCurve(float v) {
+        float t1, t2;
+        sCurveTimes(v, t1, t2);
+        Ramp r;
+        r.a = jmax * t1;                    // Peak accel actually reached
+        r.tb = t1;
+        r.tc = t1 + t2;
+        r.tend = 2.0f * t1 + t2;
+        r.v1 = 0.5f * jmax * t1 * t1;
+        r.s1 = jmax * t1 * t1 * t1 / 6.0f;
+        r.v2 = r.v1 + r.a * t2;
+        r.s2 = r.s1 + r.v1 * t2 + 0.5f * r.a * t2 * t2;
+        r.vpeak = v;
+
+        float t = 0.0f;                     // Time of step n (position n)
+        uint32_t n_prev = 0;
+        for (uint32_t n = 0; n < ramp_len; n++) {
+            if (!sampled(n)) continue;
+            if (n > 0) t = crossing(r, (float)n, t, (float)(n - n_prev));
+            n_prev = n;
+            record(toQ8(stepTime(r, t)));
+        }
+    }
+
+    /** Time at which the ramp reaches position n, Newton from the previous crossing */
+    float crossing(const Ramp& r, float n, float t_from, float dn) const {
+        float vel = speedAt(r, t_from);
+        float t = vel > 1e-3f ? t_from + dn / vel : cbrtf(6.0f * n / jmax);
+        for (int it = 0; it < 8; it++) {
+            if (t > r.tend) return r.tend + (n - posAt(r, r.tend)) / r.vpeak;
+            vel = speedAt(r, t);
+            if (vel < 1e-3f) break;
+            float dt = (posAt(r, t) - n) / vel;
+            t -= dt;
+            if (t < t_from) t = t_from;
+            if (fabsf(dt) * f < 0.01f) break;
+        }
+        return t;
+    }
+
+    /** Duration of the one step that starts at t: v d + a d^2/2 + j d^3/6 = 1 */
+    float stepTime(const Ramp& r, float t) const {
+        if (t >= r.tend) return 1.0f / r.vpeak;
+        float v = speedAt(r, t);
+        float a = accelAt(r, t);
+        float j = t < r.tb ? jmax : (t < r.tc ? 0.0f : -jmax);
+        // Each term alone gives an upper bound; Newton from above on the cubic
+        float d = cbrtf(6.0f / jmax);
+        if (v > 1e-3f) d = fminf(d, 1.0f / v);
+        if (a > 1e-3f) d = fminf(d, sqrtf(2.0f / a));
+        for (int it = 0; it < 8; it++) {
+            float g = v * d + 0.5f * a * d * d + j * d * d * d / 6.0f - 1.0f;
+            float dg = v + a * d + 0.5f * j * d * d;
+            if (dg <= 0.0f) break;
+            float step = g / dg;
+            d -= step;
+            if (fabsf(step) * f < 0.001f) break;
+        }
+        return d;
+    }
+
+    float speedAt(const Ramp& r, float t) const {
+        if (t <= r.tb) return 0.5f * jmax * t * t;
+        if (t <= r.tc) return r.v1 + r.a * (t - r.tb);
+        if (t > r.tend) t = r.tend;
+        float u = t - r.tc;
+        return r.v2 + r.a * u - 0.5f * jmax * u * u;
+    }
+
+    float accelAt(const Ramp& r, float t) const {
+        if (t <= r.tb) return jmax * t;
+        if (t <= r.tc) return r.a;
+        if (t > r.tend) return 0.0f;
+        return r.a - jmax * (t - r.tc);
+    }
+
+    float posAt(const Ramp& r, float t) const {
+        if (t <= r.tb) return jmax * t * t * t / 6.0f;
+        if (t <= r.tc) {
+            float u = t - r.tb;
+            return r.s1 + r.v1 * u + 0.5f * r.a * u * u;
+        }
+        float u = t - r.tc;
+        return r.s2 + r.v2 * u + 0.5f * r.a * u * u - jmax * u * u * u / 6.0f;
+    }
+
+    float f;
+    float vmax, amax, jmax;
+    Profile shape;
+    float peak = 0.0f;
+
+    uint32_t total;
+    uint32_t done;
+    uint32_t frac = 0;                      // Q8 remainder carried between steps
+    uint32_t ramp_len;
+    uint32_t decel_from;
+    uint32_t stride = 1;
+    uint32_t last_m = 0;
+    uint32_t cruise_q8 = 0;
+    uint32_t table_len = 0;
+    uint32_t table[MAX_RAMP];               // Ramp intervals, Q8 ticks
+};
@@ -0,0 +1,262 @@
+/**
+ * @file StereoEarLocalizer.hpp
+ * @brief Two-ear sound source direction estimator (TDOA + ILD)
+ *
+ * SUBSYSTEM: goblin_head (ESP32-S3 R8N16), fed by goblin_ear_localizer
+ *
+ * ARCHITECTURE:
+ * - Input: one block of time-aligned left/right 16-bit PCM per call
+ * - Pre-whitening: first difference (x[n] - x[n-1]) flattens the speech
+ *   spectrum so the correlation peak is sharp - a cheap stand-in for the
+ *   PHAT weighting of GCC-PHAT without needing an FFT
+ * - TDOA: integer cross-correlation over +/- max_lag samples only
+ *   (ears 100 mm apart => +/- 292 us => +/- 5 lags at 16 kHz),
+ *   parabolic interpolation gives sub-sample resolution
+ * - ILD: left/right energy ratio in dB, mapped through a simple
+ *   head-shadow gain; used where the correlation peak is weak
+ * - Output: azimuth (-90 = hard left, +90 = hard right) and a 0-255
+ *   confidence built from peak coherence, SNR over the tracked noise floor
+ *   and ITD/ILD sign agreement
+ *
+ * MEMORY:
+ * - Work buffers: 2 x MAX_BLOCK int16 = 2 KB
+ * - No heap, no FFT tables
+ *
+ * TIMING (256-sample block = 16 ms at 16 kHz):
+ * - (2 * max_lag + 1) * block MACs + 2 * block energy MACs
+ *   => ~3.4k 32-bit MACs per block with defaults, well under 1% of one core
+ *
+ * USAGE:
+ *   StereoEarLocalizer localizer;
+ *   localizer.configure(16000, 100);
+ *   StereoEarLocalizer::Estimate est;
+ *   if (localizer.processBlock(left, right, 256, est) && est.valid) {
+ *       // est.azimuth_deg_x10, est.confidence
+ *   }
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+class StereoEarLocalizer {
+public:
+    static constexpr size_t MAX_BLOCK = 512;
+    static constexpr int MAX_LAG_LIMIT = 16;
+    static constexpr float SPEED_OF_SOUND_MM_PER_S = 343000.0f;
+
+    struct Estimate {
+        int16_t azimuth_deg_x10;    // Smoothed azimuth, -900..+900 (positive = right)
+        int16_t raw_azimuth_deg_x10;// This block only, before smoothing
+        uint8_t confidence;         // 0 = no information, 255 = certain
+        int16_t tdoa_us;            // Arrival time left minus right (positive = source on right)
+        int16_t ild_db_x10;         // Right minus left level (positive = right louder)
+        uint16_t level;             // RMS of the louder ear after whitening
+        bool valid;                 // Block carried enough signal to estimate anything
+    };
+
+    StereoEarLocalizer() {
+        configure(16000, 100);
+    }
+
+    /**
+     * Configure geometry and rate
+     * @param sample_rate_hz Per-channel sample rate
+     * @param ear_spacing_mm Acoustic distance between the two microphones
+     */
+    void configure(uint32_t sample_rate_hz, uint16_t ear_spacing_mm) {
+        sample_rate = sample_rate_hz;
+        ear_spacing = ear_spacing_mm;
+
+        float max_delay_samples = (ear_spacing_mm / SPEED_OF_SOUND_MM_PER_S) * sample_rate_hz;
+        max_lag = (int)ceilf(max_delay_samples) + 1;
+        if (max_lag > MAX_LAG_LIMIT) max_lag = MAX_LAG_LIMIT;
+
+        reset();
+    }
+
+    /**
+     * Tuning knobs - defaults suit INMP441 mics in the goblin ear cavities
+     * @param gate_ratio_x16 Block level must exceed noise floor * ratio / 16
+     * @param ild_deg_per_db Head-shadow mapping from ILD to azimuth
+     * @param smoothing_x256 Weight of the newest estimate at full confidence
+     */
+    void setTuning(uint16_t gate_ratio_x16, float ild_deg_per_db, uint16_t smoothing_x256) {
+        gate_ratio = gate_ratio_x16;
+        ild_gain = ild_deg_per_db;
+        smoothing = smoothing_x256 > 256 ? 256 : smoothing_x256;
+    }
+
+    void reset() {
+        prev_left = 0;
+        prev_right = 0;
+        noise_floor = 0;
+        smoothed_az_x10 = 0;
+        have_track = false;
+    }
+
+    int maxLag() const { return max_lag; }
+
+    /**
+     * Process one block of synchronised left/right samples
+     * @return false if the block size is unusable; est.valid reports whether
+     *         the block contained a detectable source
+     */
+    bool processBlock(const int16_t* left, const int16_t* right, size_t count, Estimate& est) {
+        est.valid = false;
+        est.confidence = 0;
+        est.tdoa_us = 0;
+        est.ild_db_x10 = 0;
+        est.level = 0;
+        est.azimuth_deg_x10 = smoothed_az_x10;
+        est.raw_azimuth_deg_x10 = 0;
+
+        if (!left || !right || count > MAX_BLOCK || count <= (size_t)(4 * max_lag)) {
+            return false;
+        }
+
+        // Whitening + energy in one pass. Halving keeps the difference in int16.
+        int64_t energy_l = 0;
+        int64_t energy_r = 0;
+        for (size_t i = 0; i < count; i++) {
+            int32_t dl = ((int32_t)left[i] - prev_left) >> 1;
+            int32_t dr = ((int32_t)right[i] - prev_right) >> 1;
+            prev_left = left[i];
+            prev_right = right[i];
+            work_l[i] = (int16_t)dl;
+            work_r[i] = (int16_t)dr;
+            energy_l += dl * dl;
+            energy_r += dr * dr;
+        }
+
+        int64_t energy_max = energy_l > energy_r ? energy_l : energy_r;
+        uint32_t level = isqrt64((uint64_t)(energy_max / (int64_t)count));
+        est.level = level > 0xFFFF ? 0xFFFF : (uint16_t)level;
+
+        // Noise floor: fast fall, slow rise, so speech bursts don't drag it up
+        if (noise_floor == 0 || level < noise_floor) {
+            noise_floor = level;
+        } else {
+            noise_floor += (level - noise_floor) / 64 + 1;
+        }
+        if (level == 0 || (uint64_t)level * 16 < (uint64_t)noise_floor * gate_ratio) {
+            return true;
+        }
+
+        // Cross-correlation R[k] = sum l[n] * r[n + k] over the lag window
+        int64_t corr[2 * MAX_LAG_LIMIT + 1];
+        const int n0 = max_lag;
+        const int n1 = (int)count - max_lag;
+        int best = 0;
+        for (int k = -max_lag; k <= max_lag; k++) {
+            int64_t acc = 0;
+            const int16_t* a = work_l + n0;
+            const int16_t* b = work_r + n0 + k;
+            for (int n = n0; n < n1; n++) {
+                acc += (int32_t)(*a++) * (*b++);
+            }
+            corr[k + max_lag] = acc;
+            if (acc > corr[best]) best = k + max_lag;
+        }
+
+        // Sub-sample peak refinement
+        float peak_offset = 0.0f;
+        if (best > 0 && best < 2 * max_lag) {
+            float ym = (float)corr[best - 1];
+            float y0 = (float)corr[best];
+            float yp = (float)corr[best + 1];
+            float denom = ym - 2.0f * y0 + yp;
+            if (denom < 0.0f) {
+                peak_offset = 0.5f * (ym - yp) / denom;
+                if (peak_offset > 0.5f) peak_offset = 0.5f;
+                if (peak_offset < -0.5f) peak_offset = -0.5f;
+            }
+        }
+
+        // Left lags right by d samples when the source is on the right,
+        // which puts the correlation peak at k = -d
+        float tdoa_samples = -((float)(best - max_lag) + peak_offset);
+        float tdoa_s = tdoa_samples / (float)sample_rate;
+        est.tdoa_us = (int16_t)lrintf(tdoa_s * 1e6f);
+
+        float overlap = (float)(n1 - n0) / (float)count;
+        float coherence = (float)corr[best] / (sqrtf((float)energy_l * (float)energy_r) * overlap + 1.0f);
+        if (coherence < 0.0f) coherence = 0.0f;
+        if (coherence > 1.0f) coherence = 1.0f;
+
+        float sin_az = tdoa_s * SPEED_OF_SOUND_MM_PER_S / (float)ear_spacing;
+        if (sin_az > 1.0f) sin_az = 1.0f;
+        if (sin_az < -1.0f) sin_az = -1.0f;
+        float itd_az = asinf(sin_az) * (180.0f / (float)M_PI);
+
+        float ild_db = 10.0f * log10f(((float)energy_r + 1.0f) / ((float)energy_l + 1.0f));
+        est.ild_db_x10 = (int16_t)lrintf(ild_db * 10.0f);
+        float ild_az = ild_db * ild_gain;
+        if (ild_az > 90.0f) ild_az = 90.0f;
+        if (ild_az < -90.0f) ild_az = -90.0f;
+
+        // Trust ITD when the peak is coherent; lean on ILD when it is not
+        float w = coherence * coherence;
+        float az = w * itd_az + (1.0f - w) * ild_az;
+
+        float agreement = 1.0f;
+        if (fabsf(itd_az) > 20.0f && fabsf(ild_az) > 20.0f && (itd_az > 0.0f) != (ild_az > 0.0f)) {
+            agreement = 0.5f;
+        }
+        float snr = (float)level / (float)(noise_floor + 1);
+        float snr_factor = snr >= 4.0f ? 1.0f : (snr - 1.0f) / 3.0f;
+        if (snr_factor < 0.0f) snr_factor = 0.0f;
+
+        int conf = (int)lrintf(255.0f * coherence * snr_factor * agreement);
+        est.confidence = (uint8_t)(conf > 255 ? 255 : (conf < 0 ? 0 : conf));
+        est.raw_azimuth_deg_x10 = (int16_t)lrintf(az * 10.0f);
+        est.valid = true;
+
+        // Confidence-weighted tracking so one reflection doesn't whip the head round
+        int32_t alpha = (int32_t)smoothing * est.confidence / 255;
+        if (!have_track) {
+            smoothed_az_x10 = est.raw_azimuth_deg_x10;
+            have_track = est.confidence > 0;
+        } else {
+            smoothed_az_x10 += (int16_t)(((int32_t)(est.raw_azimuth_deg_x10 - smoothed_az_x10) * alpha) / 256);
+        }
+        est.azimuth_deg_x10 = smoothed_az_x10;
+        return true;
+    }
+
+private:
+    uint32_t sample_rate = 16000;
+    uint16_t ear_spacing = 100;
+    int max_lag = 6;
+
+    uint16_t gate_ratio = 24;       // 1.5x noise floor
+    float ild_gain = 9.0f;
+    uint16_t smoothing = 96;
+
+    int16_t prev_left = 0;
+    int16_t prev_right = 0;
+    uint32_t noise_floor = 0;
+    int16_t smoothed_az_x10 = 0;
+    bool have_track = false;
+
+    int16_t work_l[MAX_BLOCK];
+    int16_t work_r[MAX_BLOCK];
+
+    static uint32_t isqrt64(uint64_t v) {
+        uint64_t r = 0;
+        uint64_t bit = (uint64_t)1 << 62;
+        while (bit > v) bit >>= 2;
+        while (bit) {
+            if (v >= r + bit) {
+                v -= r + bit;
+                r = (r >> 1) + bit;
+            } else {
+                r >>= 1;
+            }
+            bit >>= 2;
+        }
+        return (uint32_t)r;
+    }
+};
@@ -0,0 +1,239 @@
+/**
+ * @file UltrasonicRangeFilter.hpp
+ * @brief Median + outlier-gated Kalman filter for ultrasonic (HC-SR04) ranges
+ *
+ * SUBSYSTEM: any subsystem with an hc_sr04 (goblin_nose first)
+ *
+ * ARCHITECTURE:
+ * - Constant-velocity Kalman filter [distance, velocity]. Each echo is
+ *   gated by its normalised innovation (y^2 > gate^2 * S => rejected), so
+ *   ghost echoes (multipath, crosstalk, second bounce) never move the
+ *   estimate and accepted echoes enter without median delay
+ * - Running median of the last N echoes (N odd, <= MAX_WINDOW) is the
+ *   re-acquire point: after REACQUIRE_AFTER consecutive rejections the
+ *   target really moved (someone stepped in front) and the track restarts
+ *   at the median instead of sulking on the old distance or jumping to a
+ *   lone ghost
+ * - Missed echoes (timeout) only run the prediction step; uncertainty
+ *   grows and the published confidence falls
+ * - Timestamps come from the echo capture, so irregular ping spacing and
+ *   dropped pings are handled by the real dt
+ *
+ * MEMORY: ~60 bytes, no heap
+ *
+ * TIMING: a 2x2 Kalman step per echo, N-element insertion sort on re-acquire
+ *
+ * USAGE:
+ *   UltrasonicRangeFilter filter;
+ *   filter.update(raw_mm, t_us);            // on every echo
+ *   filter.miss(t_us);                      // on echo timeout
+ *   UltrasonicRangeFilter::Estimate e = filter.estimate();
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+class UltrasonicRangeFilter {
+public:
+    static constexpr size_t MAX_WINDOW = 7;
+    static constexpr uint8_t REACQUIRE_AFTER = 4;
+
+    struct Estimate {
+        float distance_mm;
+        float velocity_mm_s;    // Positive = moving away
+        float sigma_mm;         // 1-sigma distance uncertainty
+        uint8_t confidence;     // 0 = no track, 255 = solid
+        bool valid;             // Track exists and confidence is usable
+    };
+
+    UltrasonicRangeFilter() {
+        configure(3, 5.0f, 2000.0f, 3.0f, 20.0f, 4000.0f);
+    }
+
+    /**
+     * @param window Re-acquire median length (1, 3, 5 or 7)
+     * @param noise_mm 1-sigma echo jitter
+     * @param accel_mm_s2 Expected target acceleration (process noise)
+     * @param gate_sigma Innovation gate in standard deviations
+     * @param min_mm / max_mm Sensor range; echoes outside are rejected
+     */
+    void configure(uint8_t window, float noise_mm, float accel_mm_s2, float gate_sigma, float min_mm, float max_mm) {
+        window_len = window < 1 ? 1 : (window > MAX_WINDOW ? MAX_WINDOW : window);
+        if ((window_len & 1) == 0) window_len--;
+        meas_var = noise_mm * noise_mm;
+        accel_var = accel_mm_s2 * accel_mm_s2;
+        gate_sq = gate_sigma * gate_sigma;
+        min_range = min_mm;
+        max_range = max_mm;
+        reset();
+    }
+
+    void reset() {
+        fill = 0;
+        head = 0;
+        has_track = false;
+        rejects_in_row = 0;
+        quality = 0.0f;
+        x_pos = 0.0f;
+        x_vel = 0.0f;
+        p00 = p01 = p11 = 0.0f;
+        last_us = 0;
+        accepted = 0;
+        rejected = 0;
+    }
+
+    /**
+     * Feed one echo
+     * @return true if it moved the estimate, false if it was rejected
+     */
+    bool update(float raw_mm, uint64_t t_us) {
+        if (!(raw_mm >= min_range && raw_mm <= max_range)) {
+            miss(t_us);
+            rejected++;
+            return false;
+        }
+
+        window[head] = raw_mm;
+        head = (uint8_t)((head + 1) % window_len);
+        if (fill < window_len) fill++;
+
+        if (!has_track) {
+            startTrack(raw_mm, t_us);
+            return true;
+        }
+
+        predict(t_us);
+        float y = raw_mm - x_pos;
+        float s = p00 + meas_var;
+        if (y * y > gate_sq * s) {
+            rejected++;
+            quality *= 0.8f;
+            if (++rejects_in_row >= REACQUIRE_AFTER) {
+                // Consistent disagreement: the scene changed, not the sensor
+                startTrack(median(), t_us);
+                return true;
+            }
+            return false;
+        }
+
+        rejects_in_row = 0;
+        float k0 = p00 / s;
+        float k1 = p01 / s;
+        x_pos += k0 * y;
+        x_vel += k1 * y;
+        float n00 = (1.0f - k0) * p00;
+        float n01 = (1.0f - k0) * p01;
+        float n11 = p11 - k1 * p01;
+        p00 = n00;
+        p01 = n01;
+        p11 = n11;
+
+        quality += (1.0f - quality) * 0.2f;
+        accepted++;
+        return true;
+    }
+
+    /** Echo timed out: coast on the prediction */
+    void miss(uint64_t t_us) {
+        if (!has_track) return;
+        predict(t_us);
+        quality *= 0.8f;
+    }
+
+    Estimate estimate() const {
+        Estimate e;
+        e.distance_mm = x_pos;
+        e.velocity_mm_s = x_vel;
+        e.sigma_mm = sqrtf(p00);
+        e.valid = false;
+        e.confidence = 0;
+        if (!has_track) return e;
+
+        // Confidence: recent acceptance history scaled down as uncertainty grows
+        float spread = 1.0f - e.sigma_mm / (20.0f * sqrtf(meas_var));
+        if (spread < 0.0f) spread = 0.0f;
+        float c = 255.0f * quality * spread;
+        e.confidence = (uint8_t)(c > 255.0f ? 255.0f : c);
+        e.valid = e.confidence >= 64;
+        return e;
+    }
+
+    uint32_t acceptedCount() const { return accepted; }
+    uint32_t rejectedCount() const { return rejected; }
+
+private:
+    float window[MAX_WINDOW];
+    uint8_t window_len = 3;
+    uint8_t fill = 0;
+    uint8_t head = 0;
+
+    float meas_var = 25.0f;
+    float accel_var = 4.0e6f;
+    float gate_sq = 9.0f;
+    float min_range = 20.0f;
+    float max_range = 4000.0f;
+
+    bool has_track = false;
+    uint8_t rejects_in_row = 0;
+    float quality = 0.0f;
+    float x_pos = 0.0f;
+    float x_vel = 0.0f;
+    float p00 = 0.0f, p01 = 0.0f, p11 = 0.0f;
+    uint64_t last_us = 0;
+    uint32_t accepted = 0;
+    uint32_t rejected = 0;
+
+    float median() const {
+        float sorted[MAX_WINDOW];
+        for (uint8_t i = 0; i < fill; i++) {
+            float v = window[i];
+            int j = i - 1;
+            while (j >= 0 && sorted[j] > v) {
+                sorted[j + 1] = sorted[j];
+                j--;
+            }
+            sorted[j + 1] = v;
+        }
+        return sorted[fill / 2];
+    }
+
+    void startTrack(float z, uint64_t t_us) {
+        // Window restarts too, so stale echoes from the old scene can't vote
+        window[0] = z;
+        fill = 1;
+        head = 1 % window_len;
+        x_pos = z;
+        x_vel = 0.0f;
+        p00 = meas_var;
+        p01 = 0.0f;
+        p11 = 1.0e6f;           // Velocity unknown: +/-1 m/s
+        last_us = t_us;
+        has_track = true;
+        rejects_in_row = 0;
+        quality = 0.5f;
+        accepted++;
+    }
+
+    void predict(uint64_t t_us) {
+        float dt = (float)(t_us - last_us) * 1e-6f;
+        last_us = t_us;
+        if (dt <= 0.0f) return;
+        if (dt > 1.0f) dt = 1.0f;
+
+        x_pos += x_vel * dt;
+        // Discrete white-noise acceleration model
+        float dt2 = dt * dt;
+        float q00 = 0.25f * dt2 * dt2 * accel_var;
+        float q01 = 0.5f * dt2 * dt * accel_var;
+        float q11 = dt2 * accel_var;
+        float n00 = p00 + 2.0f * dt * p01 + dt2 * p11 + q00;
+        float n01 = p01 + dt * p11 + q01;
+        float n11 = p11 + q11;
+        p00 = n00;
+        p01 = n01;
+        p11 = n11;
+    }
+};
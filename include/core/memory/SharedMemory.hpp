@@ -37,6 +37,7 @@ private:
     
     static void on_data_sent(const uint8_t* mac_addr, esp_now_send_status_t status);
     static void on_data_recv(const uint8_t* mac_addr, const uint8_t* data, int len);
+    static void espnow_recv(const esp_now_recv_info_t* recv_info, const uint8_t* data, int len);
     void espnow_broadcast(shared_type_id_t type_id, void* data, size_t size);
 #endif
 
@@ -70,6 +71,13 @@ public:
     
 #if defined(ESP_PLATFORM) && defined(CONFIG_ESP_WIFI_ESPNOW)
     void espnow_init();
+    
+    // ESP-NOW has one receive callback per node. Other protocols on the radio
+    // (e.g. the P32 mesh) register here: frames whose first 4 bytes are their
+    // magic go to them, everything else is a GSM update
+    static constexpr int ESPNOW_FRAME_HANDLERS = 2;
+    static esp_err_t espnow_add_frame_handler(uint32_t magic, esp_now_recv_cb_t handler);
+    static void espnow_remove_frame_handler(uint32_t magic);
 #endif
 
     template<typename T>
@@ -33,9 +33,16 @@ static const char* TAG = "P32_ARM";
 #define PCA9685_I2C_ADDRESS_LEFT    0x41
 #define PCA9685_I2C_ADDRESS_RIGHT   0x42
 
+// Arm geometry (mm) for the reach solver; the hand length runs from the
+// wrist to the palm centre, the point p32_arm_reach_target() places
+#define ARM_UPPER_ARM_LENGTH_MM     250.0f
+#define ARM_FOREARM_LENGTH_MM       200.0f
+#define ARM_HAND_LENGTH_MM          80.0f
+
 // Timing and monitoring
 #define ARM_MAX_CURRENT_THRESHOLD   8.0f   // Amperes per arm
 #define ARM_STATUS_REPORT_INTERVAL  1000   // Milliseconds
+#define ARM_GESTURE_FADE_MS         600    // Crossfade into a new gesture
 
 // Arm identification
 typedef enum {
@@ -148,6 +155,7 @@ static bool p32_arm_calculate_inverse_kinematics(p32_vector3_t target, float joi
 static p32_vector3_t p32_arm_calculate_forward_kinematics(float joint_angles[7]);
 
 // Utility function prototypes
+static esp_err_t p32_arm_write_joint_angles(const float joint_angles[7]);
 static uint16_t p32_arm_angle_to_pwm(float angle, uint8_t joint_index);
 static float p32_arm_read_servo_currents(void);
 static void p32_arm_reduce_power(float power_factor);
@@ -171,10 +179,7 @@ typedef struct {
     bool emergency_stop_active;
 } p32_system_status_t;
 
-// PCA9685 servo driver interface (external library)
-esp_err_t pca9685_init(i2c_port_t i2c_port, uint8_t address);
-esp_err_t pca9685_set_pwm_freq(uint8_t freq);
-esp_err_t pca9685_set_pwm(uint8_t channel, uint16_t pwm_value);
-uint16_t pca9685_get_pwm(uint8_t channel);
+// PCA9685 servo driver (shadowed registers, burst flush)
+#include "config/components/drivers/pca9685_driver.hdr"
 
 #endif // P32_ARM_CONTROLLER_H
\ No newline at end of file
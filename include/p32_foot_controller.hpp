@@ -58,6 +58,16 @@ extern "C" {
 #define FOOT_TASK_PRIORITY          5
 #define FOOT_SUBSYSTEM_ID           0x08
 
+// Pressure pipeline (one FSR scan per tick, integer CoP / support polygon)
+#define FOOT_PIPELINE_HZ            200
+#define FOOT_PIPELINE_PERIOD_US     (1000000 / FOOT_PIPELINE_HZ)
+#define FOOT_FSR_FILTER_SHIFT       1   // Per-sensor smoothing, alpha = 1/2
+#define FOOT_CONTACT_ON_PERMILLE    150 // Sensor contact hysteresis (15% / 5%)
+#define FOOT_CONTACT_OFF_PERMILLE   50
+#define FOOT_STABILITY_MARGIN_MM    10  // CoP this far inside the support polygon = stable
+#define FOOT_PUBLISH_COP_DELTA_MM   2   // Publish FootPressure when CoP / margin move this much
+#define FOOT_PUBLISH_HEARTBEAT_MS   50  // ... or at least this often
+
 // Physical wiring optimization metrics
 #define FOOT_MAX_SENSOR_WIRE_LENGTH_CM  10  // Maximum sensor wire length
 #define FOOT_TOTAL_WIRING_LENGTH_CM     104 // Total physical wiring
@@ -63,6 +63,21 @@ extern "C" {
 #define HAND_TASK_PRIORITY          5
 #define HAND_SUBSYSTEM_ID           0x03
 
+// Grip force loop: an esp_timer wakes the control task at HAND_GRIP_CONTROL_HZ.
+// Each tick scans the five FSRs, runs the force/position controller and
+// sends all five fingers in one PCA9685 flush. The servos still only see a
+// new pulse every 20 ms PWM frame; the fast loop cuts sensing-to-decision
+// latency, which is what limits contact overshoot.
+#define HAND_GRIP_CONTROL_HZ        500
+#define HAND_GRIP_PERIOD_US         (1000000 / HAND_GRIP_CONTROL_HZ)
+#define HAND_FORCE_FILTER_SHIFT     1           // FSR smoothing, alpha = 1 / 2^shift
+#define HAND_GRIP_APPROACH_DPS      90.0f       // Closing speed before contact
+#define HAND_GRIP_SLIP_PERMILLE     25          // Held finger below this has lost the object
+#define HAND_GRIP_KP                0.3f
+#define HAND_GRIP_KI                8.0f        // 1/s
+#define HAND_GRIP_STIFFNESS         20.0f       // Nominal object stiffness, per mille per degree
+#define HAND_GRIP_LIMIT_DEG         180.0f      // Approach never closes past this
+
 // Torso master controller MAC address for ESP-NOW
 #define TORSO_MASTER_MAC            {0x24, 0x6F, 0x28, 0xAB, 0xCD, 0xEF}
 
@@ -267,6 +282,21 @@ bool p32_hand_is_grip_detected(void);
  */
 esp_err_t p32_hand_get_grip_analysis(float* strength, float* center_x, float* center_y);
 
+/**
+ * @brief Close fingers until contact, then hold a fingertip force
+ * @param finger_mask Bit per finger (bit 0 = thumb)
+ * @param force_percent Force to hold (0-100%, at least the low threshold)
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE with force monitoring off
+ */
+esp_err_t p32_hand_grip(uint8_t finger_mask, float force_percent);
+
+/**
+ * @brief Let go: ramp every finger open
+ * @param duration_ms Opening time
+ * @return ESP_OK on success, error code on failure
+ */
+esp_err_t p32_hand_release(uint16_t duration_ms);
+
 /**
  * @brief Perform force sensor calibration
  * @param calibration_data Pointer to calibration data structure
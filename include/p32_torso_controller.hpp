@@ -142,10 +142,7 @@ static float p32_torso_read_system_current(void);
 static void p32_torso_update_subsystem_status(p32_subsystem_status_t *status);
 static void p32_torso_send_status_update(void);
 
-// PCA9685 servo driver interface (external library)
-esp_err_t pca9685_init(i2c_port_t i2c_port, uint8_t address);
-esp_err_t pca9685_set_pwm_freq(uint8_t freq);
-esp_err_t pca9685_set_pwm(uint8_t channel, uint16_t pwm_value);
-uint16_t pca9685_get_pwm(uint8_t channel);
+// PCA9685 servo driver (shadowed registers, burst flush)
+#include "config/components/drivers/pca9685_driver.hdr"
 
 #endif // P32_TORSO_CONTROLLER_H
\ No newline at end of file
@@ -16,20 +16,52 @@ esp_err_t gc9a01_init(void);
 void gc9a01_act(void);
 esp_err_t generic_spi_display_init(void);
 void generic_spi_display_act(void);
+esp_err_t goblin_ear_localizer_init(void);
+void goblin_ear_localizer_act(void);
 esp_err_t goblin_eye_init(void);
 void goblin_eye_act(void);
+esp_err_t goblin_gaze_init(void);
+void goblin_gaze_act(void);
+esp_err_t goblin_head_neck_motor_init(void);
+void goblin_head_neck_motor_act(void);
+esp_err_t goblin_jaw_init(void);
+void goblin_jaw_act(void);
 esp_err_t goblin_left_eye_init(void);
 void goblin_left_eye_act(void);
+esp_err_t goblin_mood_init(void);
+void goblin_mood_act(void);
 esp_err_t goblin_mouth_display_init(void);
 void goblin_mouth_display_act(void);
 esp_err_t goblin_mouth_mood_display_init(void);
 void goblin_mouth_mood_display_act(void);
+esp_err_t goblin_nose_init(void);
+void goblin_nose_act(void);
 esp_err_t goblin_right_eye_init(void);
 void goblin_right_eye_act(void);
+esp_err_t goblin_sensor_fusion_init(void);
+void goblin_sensor_fusion_act(void);
+esp_err_t goblin_speaker_init(void);
+void goblin_speaker_act(void);
+esp_err_t gpio_pair_driver_init(void);
+void gpio_pair_driver_act(void);
+esp_err_t hc_sr04_init(void);
+void hc_sr04_act(void);
+esp_err_t i2s_bus_0_init(void);
+void i2s_bus_0_act(void);
+esp_err_t i2s_driver_init(void);
+void i2s_driver_act(void);
+esp_err_t i2s_generic_driver_init(void);
+void i2s_generic_driver_act(void);
+esp_err_t servo_sg90_micro_init(void);
+void servo_sg90_micro_act(void);
+esp_err_t speaker_init(void);
+void speaker_act(void);
 esp_err_t spi_display_bus_init(void);
 void spi_display_bus_act(void);
+esp_err_t spiffs_storage_init(void);
+void spiffs_storage_act(void);
 
-// Declarations from config\components\hardware\gc9a01.hdr
+// Declarations from config/components/hardware/gc9a01.hdr
 // gc9a01 component header
 // Defines data structures for GC9A01 display
 
@@ -98,7 +130,7 @@ struct gc9a01
 
 #endif // GC9A01_HDR
 
-// Declarations from config\components\drivers\generic_spi_display.hdr
+// Declarations from config/components/drivers/generic_spi_display.hdr
 #ifndef GENERIC_SPI_DISPLAY_HDR
 #define GENERIC_SPI_DISPLAY_HDR
 
@@ -119,33 +151,592 @@ void generic_spi_display_act(void);
 
 #endif // GENERIC_SPI_DISPLAY_HDR
 
-// Declarations from config\bots\bot_families\goblins\head\goblin_eye.hdr
+// Declarations from config/bots/bot_families/goblins/head/goblin_ear_localizer.hdr
+// Goblin ear localizer - stereo sound direction from both ear microphones
+#ifndef GOBLIN_EAR_LOCALIZER_HDR
+#define GOBLIN_EAR_LOCALIZER_HDR
+
+#include <esp_err.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Initialize the stereo localizer (16 kHz, 100 mm ear spacing)
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t goblin_ear_localizer_init(void);
+
+/**
+ * @brief Drain available stereo frames, estimate direction per block and
+ *        publish SoundDirection to shared memory
+ * Called every loop by subsystem dispatcher; never blocks on I2S
+ */
+void goblin_ear_localizer_act(void);
+
+// Dependency on I2S driver (both ear mics on one stereo bus)
+esp_err_t i2s_generic_driver_read_stereo(int32_t *frames, size_t max_frames, size_t *frames_read);
+
+// Dependency on sensor fusion (ear level feeds presence/attention)
+#define GOBLIN_FUSION_MIC 3
+bool goblin_sensor_fusion_post(uint8_t source, uint32_t t_ms, int16_t value, int16_t aux, uint8_t quality);
+
+#endif // GOBLIN_EAR_LOCALIZER_HDR
+
+// Declarations from config/bots/bot_families/goblins/head/goblin_eye.hdr
 // goblin_eye.hdr
 #ifndef GOBLIN_EYE_HDR
 #define GOBLIN_EYE_HDR
 
 #include "esp_err.h"
+#include <stdint.h>
 
 esp_err_t goblin_eye_init(void);
 void goblin_eye_act(void);
 
+// Untinted source frame for the eye; tinted copies are cached per frame_id and mood
+void goblin_eye_show_frame(const uint8_t* source, uint32_t frame_id);
+
+// Pupil centre in display pixels (goblin_gaze); the frame is slid to put it there
+void goblin_eye_set_pupil(uint16_t x, uint16_t y);
+
 #endif // GOBLIN_EYE_HDR
 
-// Declarations from config\bots\bot_families\goblins\head\goblin_left_eye.hdr
+// Declarations from config/bots/bot_families/goblins/head/goblin_gaze.hdr
+// Goblin gaze - saccades, smooth pursuit and fixation toward sensed targets
+#ifndef GOBLIN_GAZE_HDR
+#define GOBLIN_GAZE_HDR
+
+#include <esp_err.h>
+#include <stdint.h>
+
+/**
+ * @brief Initialize the gaze controller (200 Hz, eyes +/-45 pan, +/-30 tilt)
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t goblin_gaze_init(void);
+
+/**
+ * @brief Take targets from SensorFusion / SoundDirection, run the gaze ticks
+ *        that fell due, hand neck requests to the neck and the pupil to the eyes
+ * Called every loop by subsystem dispatcher; skips between ticks
+ */
+void goblin_gaze_act(void);
+
+// Dependency on goblin_head_neck_motor (gaze offload and counter-rotation)
+esp_err_t goblin_head_neck_motor_set_pose(float pan_degrees, float tilt_degrees, float roll_degrees);
+void goblin_head_neck_motor_get_pose(float* pan_degrees, float* tilt_degrees, float* roll_degrees);
+
+// Dependency on goblin_eye (pupil drawn on the eye displays)
+void goblin_eye_set_pupil(uint16_t x, uint16_t y);
+
+#endif // GOBLIN_GAZE_HDR
+
+// Declarations from config/components/creature_specific/goblin_head_neck_motor.hdr
+#ifndef GOBLIN_HEAD_NECK_MOTOR_H
+#define GOBLIN_HEAD_NECK_MOTOR_H
+
+#include <esp_err.h>
+#include "../../hardware/motors/neck_motor_3dof.hdr"
+
+// Goblin-specific neck motor controller
+// This component provides high-level control interface for the 3-DOF neck system
+
+esp_err_t goblin_head_neck_motor_init(void);
+void goblin_head_neck_motor_act(void);
+
+// High-level movement functions
+esp_err_t goblin_head_neck_motor_set_pose(float pan_degrees, float tilt_degrees, float roll_degrees);
+esp_err_t goblin_head_neck_motor_center(void);
+esp_err_t goblin_head_neck_motor_nod(void);
+esp_err_t goblin_head_neck_motor_shake(void);
+
+// Present trajectory setpoint in degrees (for gaze counter-rotation)
+void goblin_head_neck_motor_get_pose(float* pan_degrees, float* tilt_degrees, float* roll_degrees);
+
+#endif // GOBLIN_HEAD_NECK_MOTOR_H
+
+// Declarations from config/bots/bot_families/goblins/head/goblin_jaw.hdr
+#ifndef GOBLIN_JAW_HDR
+#define GOBLIN_JAW_HDR
+
+#include <esp_err.h>
+#include <stdint.h>
+
+/**
+ * @brief Initialize goblin_jaw component
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t goblin_jaw_init(void);
+
+/**
+ * @brief Execute goblin_jaw component action
+ * Called periodically by subsystem dispatcher
+ */
+void goblin_jaw_act(void);
+
+#endif // GOBLIN_JAW_HDR
+
+// Declarations from config/bots/bot_families/goblins/head/goblin_left_eye.hdr
 // Auto-generated header for goblin_left_eye
 #include <esp_err.h>
 
 esp_err_t goblin_left_eye_init(void);
 void goblin_left_eye_act(void);
 
-// Declarations from config\bots\bot_families\goblins\head\goblin_right_eye.hdr
+// Dependency on spiffs_storage (eye library lives under /spiffs/eyes)
+esp_err_t spiffs_storage_mount(void);
+
+// Declarations from config/bots/bot_families/goblins/head/goblin_mood.hdr
+// Goblin mood - the only component that writes Mood
+#ifndef GOBLIN_MOOD_HDR
+#define GOBLIN_MOOD_HDR
+
+#include <esp_err.h>
+#include <stdint.h>
+
+/**
+ * @brief Initialize the mood integrators from Personality and publish a neutral Mood
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t goblin_mood_init(void);
+
+/**
+ * @brief Integrate stimuli at 20 Hz; write Mood only on a change beyond the band
+ * Called every loop by subsystem dispatcher; skips between ticks
+ */
+void goblin_mood_act(void);
+
+/**
+ * @brief Post a mood impulse instead of writing Mood directly
+ * Applied at the next tick, scaled by the personality gain, then decays
+ * @param component Mood::Component index
+ * @param amount Signed mood units (-128 to +127 scale)
+ */
+void goblin_mood_stimulus(uint8_t component, int16_t amount);
+
+#endif // GOBLIN_MOOD_HDR
+
+// Declarations from config/bots/bot_families/goblins/head/goblin_nose.hdr
+// Goblin nose component with HC-SR04 ultrasonic sensor
+#ifndef GOBLIN_NOSE_HDR
+#define GOBLIN_NOSE_HDR
+
+#include <esp_err.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Initialize goblin nose with HC-SR04 sensor
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t goblin_nose_init(void);
+
+/**
+ * @brief Process nose sensor readings and update state
+ * Called periodically by subsystem dispatcher
+ */
+void goblin_nose_act(void);
+
+/**
+ * @brief Get the current nose sensor distance reading
+ * @return Distance in cm, or -1 if no valid reading
+ */
+float goblin_nose_get_distance(void);
+
+/**
+ * @brief Check if there's a proximity alert (object very close)
+ * @return true if object is closer than proximity threshold (10cm)
+ */
+bool goblin_nose_proximity_alert(void);
+
+/**
+ * @brief Get sensor statistics
+ * @param total_readings Output: total number of readings attempted (can be NULL)
+ * @param valid_readings Output: number of successful readings (can be NULL)
+ * @return Current success rate as percentage
+ */
+float goblin_nose_get_stats(uint32_t* total_readings, uint32_t* valid_readings);
+
+// Dependency on sensor fusion (filtered echoes feed presence/proximity)
+#define GOBLIN_FUSION_ULTRASONIC 0
+bool goblin_sensor_fusion_post(uint8_t source, uint32_t t_ms, int16_t value, int16_t aux, uint8_t quality);
+
+// Dependency on mood (proximity alerts are mood impulses)
+void goblin_mood_stimulus(uint8_t component, int16_t amount);
+
+#endif // GOBLIN_NOSE_HDR
+
+// Declarations from config/bots/bot_families/goblins/head/goblin_right_eye.hdr
 // Auto-generated header for goblin_right_eye
 #include <esp_err.h>
 
 esp_err_t goblin_right_eye_init(void);
 void goblin_right_eye_act(void);
 
-// Declarations from config\components\interfaces\spi_display_bus.hdr
+// Declarations from config/bots/bot_families/goblins/head/goblin_sensor_fusion.hdr
+// Goblin sensor fusion - presence/proximity/attention from all head sensors
+#ifndef GOBLIN_SENSOR_FUSION_HDR
+#define GOBLIN_SENSOR_FUSION_HDR
+
+#include <esp_err.h>
+#include <stdint.h>
+
+// Sources, in SensorFusionEngine order
+#define GOBLIN_FUSION_ULTRASONIC 0
+#define GOBLIN_FUSION_PIR 1
+#define GOBLIN_FUSION_TOUCH 2
+#define GOBLIN_FUSION_MIC 3
+
+/**
+ * @brief Initialize the fusion engine and publish an empty SensorFusion
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t goblin_sensor_fusion_init(void);
+
+/**
+ * @brief Fuse queued samples and publish SensorFusion at 20 Hz
+ * Called every loop by subsystem dispatcher; skips between ticks
+ */
+void goblin_sensor_fusion_act(void);
+
+/**
+ * @brief Queue one sensor sample (lock-free, never blocks)
+ * One producer component per source
+ * @param source GOBLIN_FUSION_* source
+ * @param t_ms Time the sample was measured (esp_timer ms), not when it is posted
+ * @param value Distance cm / motion 0-1 / touched pad mask / mic level
+ * @param aux Velocity cm/s for ultrasonic, azimuth deg x10 for mic, else 0
+ * @param quality Producer confidence 0-255
+ * @return true if queued, false if the source queue is full
+ */
+bool goblin_sensor_fusion_post(uint8_t source, uint32_t t_ms, int16_t value, int16_t aux, uint8_t quality);
+
+#endif // GOBLIN_SENSOR_FUSION_HDR
+
+// Declarations from config/bots/bot_families/goblins/head/goblin_speaker.hdr
+// Auto-generated header for goblin_speaker
+#include <esp_err.h>
+
+esp_err_t goblin_speaker_init(void);
+void goblin_speaker_act(void);
+
+// Declarations from config/components/drivers/gpio_pair_driver.hdr
+#ifndef GPIO_PAIR_DRIVER_HDR
+#define GPIO_PAIR_DRIVER_HDR
+
+#include <esp_err.h>
+#include <stdint.h>
+
+/**
+ * @brief Initialize gpio_pair_driver component
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t gpio_pair_driver_init(void);
+
+/**
+ * @brief Execute gpio_pair_driver component action
+ * Called periodically by subsystem dispatcher
+ */
+void gpio_pair_driver_act(void);
+
+/**
+ * @brief Configure GPIO pair for ultrasonic sensor (trigger/echo)
+ * @param trigger_pin GPIO pin for trigger output
+ * @param echo_pin GPIO pin for echo input
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t gpio_pair_configure_ultrasonic(int trigger_pin, int echo_pin);
+
+/**
+ * @brief Send trigger pulse to start ultrasonic measurement
+ * Must be called first to initiate HC-SR04 measurement cycle
+ * @return ESP_OK if trigger successful, ESP_ERR_TIMEOUT for simulated failure
+ */
+esp_err_t gpio_pair_trigger_ultrasonic(void);
+
+/**
+ * @brief Check echo pin status and return measurement when ready
+ * Call repeatedly after trigger until ESP_OK is returned
+ * @param pulse_duration_us Output: echo pulse duration in microseconds
+ * @return ESP_OK if measurement ready, ESP_ERR_NOT_FINISHED if still measuring, ESP_ERR_TIMEOUT if failed
+ */
+esp_err_t gpio_pair_check_echo(uint32_t* pulse_duration_us);
+
+/**
+ * @brief Get the echo start timestamp of the last completed measurement
+ * Captured by the echo edge ISR in hardware mode
+ * @return esp_timer time in microseconds
+ */
+uint64_t gpio_pair_get_echo_time_us(void);
+
+/**
+ * @brief Reset measurement state to idle
+ * Call after successful measurement to prepare for next cycle
+ */
+void gpio_pair_reset_measurement(void);
+
+#endif // GPIO_PAIR_DRIVER_HDR
+
+// Declarations from config/components/hardware/hc_sr04.hdr
+#ifndef HC_SR04_HDR
+#define HC_SR04_HDR
+
+#include <esp_err.h>
+#include <stdint.h>
+
+/**
+ * @brief Initialize hc_sr04 component
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t hc_sr04_init(void);
+
+/**
+ * @brief Execute hc_sr04 component action
+ * Called periodically by subsystem dispatcher
+ */
+void hc_sr04_act(void);
+
+/**
+ * @brief Get the current distance reading in centimeters
+ * Filtered: ghost echoes are rejected and missed pings are bridged
+ * @return Distance in cm (2-400cm range), or -1 if no valid reading
+ */
+float hc_sr04_get_distance_cm(void);
+
+/**
+ * @brief Check if sensor has a valid reading
+ * @return true if distance reading is valid, false otherwise
+ */
+bool hc_sr04_is_valid_reading(void);
+
+/**
+ * @brief Get the filtered target velocity
+ * @return cm/s, negative when the target approaches, 0 if no valid reading
+ */
+float hc_sr04_get_velocity_cm_s(void);
+
+/**
+ * @brief Get the confidence of the filtered reading
+ * @return 0 (no track) to 255 (steady echoes)
+ */
+uint8_t hc_sr04_get_confidence(void);
+
+/**
+ * @brief Get the last echo distance before filtering
+ * @return Distance in cm, or -1 if the last ping timed out
+ */
+float hc_sr04_get_raw_distance_cm(void);
+
+#endif // HC_SR04_HDR
+
+// Declarations from config/components/interfaces/i2s_bus.hdr
+#ifndef I2S_BUS_HDR
+#define I2S_BUS_HDR
+
+#include <esp_err.h>
+#include <stdint.h>
+#include "driver/i2s.h"
+
+/**
+ * @brief Initialize i2s_bus component
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t i2s_bus_init(void);
+
+/**
+ * @brief Execute i2s_bus component action
+ * Called periodically by subsystem dispatcher
+ */
+void i2s_bus_act(void);
+
+/**
+ * @brief Claim pins for one I2S device: shared BCLK/WS plus its own data in
+ * @param pin_config Output: pins ready for i2s_set_pin()
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if the board is out of pins
+ */
+esp_err_t i2s_bus_get_pins(i2s_pin_config_t *pin_config);
+
+#endif // I2S_BUS_HDR
+
+// Declarations from config/components/drivers/i2s_driver.hdr
+#ifndef I2S_DRIVER_HDR
+#define I2S_DRIVER_HDR
+
+#include <esp_err.h>
+#include <stdint.h>
+#include <stddef.h>
+
+// Mixer priorities (higher preempts/ducks lower), after p32_audio_clip_type_t
+#define AUDIO_PRIORITY_AMBIENT 10
+#define AUDIO_PRIORITY_REACTION 50
+#define AUDIO_PRIORITY_COMMUNICATION 70
+#define AUDIO_PRIORITY_ALERT 90
+
+/**
+ * @brief Initialize i2s_driver component
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t i2s_driver_init(void);
+
+/**
+ * @brief Execute i2s_driver component action
+ * Called periodically by subsystem dispatcher
+ */
+void i2s_driver_act(void);
+
+/**
+ * @brief Queue a sound for the mixer - never waits on the audio path
+ * Uses /spiffs/sounds/<sound_name>.p32a when present (opened by the clip
+ * loader task), synthesized otherwise.
+ * Re-requests of a sound already started within the retrigger window, and
+ * requests every voice outranks, are dropped before any file I/O.
+ * @param sound_name Name of the sound effect
+ * @param frequency Synth frequency in Hz (fallback when there is no clip)
+ * @param volume Volume level (0.0 to 1.0)
+ * @param priority AUDIO_PRIORITY_* - preempts and ducks lower priorities
+ * @param duration_ms Synth length, 0 = until stopped
+ * @return false if the request was deduped, outranked or the queue was full
+ */
+bool i2s_driver_request_sound(const char* sound_name, float frequency, float volume,
+                              uint8_t priority, uint32_t duration_ms);
+
+/**
+ * @brief Start playing a sound effect (debug mode, AUDIO_PRIORITY_REACTION)
+ * @param sound_name Name of the sound effect
+ * @param frequency Frequency in Hz
+ * @param volume Volume level (0.0 to 1.0)
+ */
+void i2s_driver_play_sound(const char* sound_name, float frequency, float volume);
+
+/**
+ * @brief Stop audio playback (all voices)
+ */
+void i2s_driver_stop_sound(void);
+
+/**
+ * @brief Play an IMA-ADPCM clip (P32A, see tools/adpcm_encode.py) from a file
+ * Streamed one chunk per audio block - the clip is never loaded whole.
+ * The file is opened, validated and its first chunk read by the clip
+ * loader task, so neither the caller nor the audio path does file I/O.
+ * A missing or invalid file is logged by the loader and not played.
+ * @param path File path on a mounted filesystem (e.g. "/spiffs/sounds/x.p32a", < 64 chars)
+ * @param volume Volume level (0.0 to 1.0)
+ * @return ESP_OK when queued (or already playing), ESP_ERR_INVALID_ARG (path too long),
+ *         ESP_ERR_NOT_FOUND (no free clip slot or no loader) or ESP_ERR_NO_MEM (loader queue full)
+ */
+esp_err_t i2s_driver_play_clip_file(const char* path, float volume);
+
+/**
+ * @brief Play an IMA-ADPCM clip held in memory-mapped flash
+ * @param name Name reported in logs/audio events
+ * @param data Clip bytes (must stay valid until playback ends)
+ * @param size Clip size in bytes
+ * @param volume Volume level (0.0 to 1.0)
+ */
+esp_err_t i2s_driver_play_clip_memory(const char* name, const uint8_t* data, size_t size, float volume);
+
+class LipSyncAnalyzer;
+
+/**
+ * @brief Lip-sync stage inside the speaker block path
+ * Jaw/viseme cues are scheduled ahead of the audio by the actuator latency.
+ * The cue ring is single-consumer: goblin_jaw drains it on the goblin head
+ * @return Analyzer owned by i2s_driver (never NULL)
+ */
+LipSyncAnalyzer* i2s_driver_get_lip_sync(void);
+
+// Dependency on spiffs_storage (clips live under /spiffs/sounds)
+esp_err_t spiffs_storage_mount(void);
+
+#endif // I2S_DRIVER_HDR
+
+// Declarations from config/components/drivers/i2s_generic_driver.hdr
+#ifndef I2S_GENERIC_DRIVER_H
+#define I2S_GENERIC_DRIVER_H
+
+#include <esp_err.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "driver/i2s.h"
+#include "esp_log.h"
+
+// Component interface functions
+esp_err_t i2s_generic_driver_init(void);
+void i2s_generic_driver_act(void);
+
+// API functions for audio data access
+esp_err_t i2s_generic_driver_read_samples(int32_t *buffer, size_t *bytes_read);
+esp_err_t i2s_generic_driver_read_stereo(int32_t *frames, size_t max_frames, size_t *frames_read);
+esp_err_t i2s_generic_driver_get_sample_rate(uint32_t *rate);
+esp_err_t i2s_generic_driver_is_dma_active(bool *active);
+esp_err_t i2s_generic_driver_start_dma(void);
+esp_err_t i2s_generic_driver_stop_dma(void);
+
+// I2S bus dependency - provided by i2s_bus component
+esp_err_t i2s_bus_get_pins(i2s_pin_config_t *pin_config);
+
+#endif // I2S_GENERIC_DRIVER_H
+
+// Declarations from config/components/hardware/servo_sg90_micro.hdr
+// Auto-generated header for servo_sg90_micro
+#include <esp_err.h>
+
+esp_err_t servo_sg90_micro_init(void);
+void servo_sg90_micro_act(void);
+
+// Declarations from config/components/hardware/speaker.hdr
+#ifndef SPEAKER_HDR
+#define SPEAKER_HDR
+
+#include <esp_err.h>
+#include <stdint.h>
+
+/**
+ * @brief Initialize speaker component
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t speaker_init(void);
+
+/**
+ * @brief Execute speaker component action
+ * Called periodically by subsystem dispatcher
+ */
+void speaker_act(void);
+
+/**
+ * @brief Play a specific sound by name
+ * @param sound_name Name of sound effect to play
+ */
+void speaker_play_sound_by_name(const char* sound_name);
+
+/**
+ * @brief Play proximity alert sound
+ */
+void speaker_play_proximity_alert(void);
+
+/**
+ * @brief Play mood-based ambient sound
+ * @param mood Current mood string ("aggressive", "playful", "curious", etc.)
+ */
+void speaker_play_mood_sound(const char* mood);
+
+/**
+ * @brief Synthesize and speak goblin words/phrases
+ * @param phrase Text phrase to convert to goblin speech
+ */
+void speaker_speak_goblin_phrase(const char* phrase);
+
+/**
+ * @brief Play goblin emotional response with intensity
+ * @param emotion Emotion type ("angry", "happy", "scared", etc.)
+ * @param intensity Intensity level (0.0 to 1.0)
+ */
+void speaker_play_emotional_response(const char* emotion, float intensity);
+
+#endif // SPEAKER_HDR
+
+// Declarations from config/components/interfaces/spi_display_bus.hdr
 // SPI display bus component header
 // Exposes current SPI pin assignment for display devices
 
@@ -180,4 +771,34 @@ void spi_display_bus_act(void);
 
 #endif // SPI_DISPLAY_BUS_H
 
+// Declarations from config/components/interfaces/spiffs_storage.hdr
+#ifndef SPIFFS_STORAGE_HDR
+#define SPIFFS_STORAGE_HDR
+
+#include <esp_err.h>
+
+#define SPIFFS_STORAGE_BASE_PATH "/spiffs"
+
+/**
+ * @brief Initialize spiffs_storage component (mounts /spiffs)
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t spiffs_storage_init(void);
+
+/**
+ * @brief Execute spiffs_storage component action
+ * Called periodically by subsystem dispatcher
+ */
+void spiffs_storage_act(void);
+
+/**
+ * @brief Mount the 'storage' partition at /spiffs; safe to call repeatedly
+ * Never formats: a missing or blank image just leaves the files absent.
+ * @return ESP_OK if mounted, ESP_ERR_NOT_FOUND if there is no storage partition,
+ *         ESP_FAIL if the partition holds no valid SPIFFS image
+ */
+esp_err_t spiffs_storage_mount(void);
+
+#endif // SPIFFS_STORAGE_HDR
+
 #endif // GOBLIN_HEAD_COMPONENT_FUNCTIONS_HPP
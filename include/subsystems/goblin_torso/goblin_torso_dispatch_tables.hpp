@@ -13,6 +13,7 @@ using act_function_t = void (*)(void);
 extern const init_function_t goblin_torso_init_table[];
 extern const act_function_t goblin_torso_act_table[];
 extern const uint32_t goblin_torso_hitcount_table[];
+extern const uint8_t goblin_torso_stretch_table[];
 extern const std::size_t goblin_torso_init_table_size;
 extern const std::size_t goblin_torso_act_table_size;
 
@@ -13,6 +13,7 @@ using act_function_t = void (*)(void);
 extern const init_function_t test_head_init_table[];
 extern const act_function_t test_head_act_table[];
 extern const uint32_t test_head_hitcount_table[];
+extern const uint8_t test_head_stretch_table[];
 extern const std::size_t test_head_init_table_size;
 extern const std::size_t test_head_act_table_size;
 
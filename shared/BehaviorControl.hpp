@@ -1,6 +1,8 @@
 #ifndef BEHAVIOR_CONTROL_HPP
 #define BEHAVIOR_CONTROL_HPP
 
+#include <cstdint>
+
 // Type ID definition - matches SharedMemory.hpp
 typedef int shared_type_id_t;
 
@@ -8,16 +10,43 @@ class BehaviorControl {
 public:
     uint32_t version;
 
-    // Unified creature behavior state
+    // Unified creature behavior state (compiled state index of the sequencer's table)
     uint8_t current_behavior;
+    uint8_t previous_behavior;
     uint8_t behavior_intensity;
     bool behavior_active;
     uint32_t behavior_start_time;
 
+    // Per-state outputs from the behavior tables
+    uint16_t wing_beat_hz_x10;
+    uint8_t max_bank_deg;
+    bool flight_requested;      // Request only; flight safety and the controller decide
+
     // Coordination flags
     bool master_override;
     uint8_t coordination_priority;
 
+    uint32_t transition_count;
+
+    // Default constructor
+    BehaviorControl() :
+        version(1),
+        current_behavior(0),
+        previous_behavior(0),
+        behavior_intensity(0),
+        behavior_active(false),
+        behavior_start_time(0),
+        wing_beat_hz_x10(0),
+        max_bank_deg(0),
+        flight_requested(false),
+        master_override(false),
+        coordination_priority(0),
+        transition_count(0)
+    {}
 };
 
-#endif // BEHAVIOR_CONTROL_HPP
\ No newline at end of file
+// SharedMemory type ID (required for GSM.read<BehaviorControl>() / GSM.write<BehaviorControl>())
+#include "core/memory/SharedMemory.hpp"
+template<> inline shared_type_id_t getTypeId<BehaviorControl>() { return 9; }
+
+#endif // BEHAVIOR_CONTROL_HPP
@@ -0,0 +1,41 @@
+#ifndef FLIGHT_COMMAND_HPP
+#define FLIGHT_COMMAND_HPP
+
+#include <cstdint>
+
+// Type ID definition - matches SharedMemory.hpp
+typedef int shared_type_id_t;
+
+class FlightCommand {
+public:
+    uint32_t version;
+
+    // Setpoints for flying_dragon_motor_controller (behavior sequencer / flight safety)
+    float throttle;             // Collective 0..1
+    float roll_deg;             // Angle setpoints, earth-levelled
+    float pitch_deg;
+    float yaw_rate_dps;         // Yaw is commanded as a rate
+
+    // Status
+    uint32_t timestamp_us;
+    bool armed;                 // false = motors stopped, wings neutral
+    bool landing;               // Commanded descent: suspends the altitude floor
+
+    // Default constructor
+    FlightCommand() :
+        version(1),
+        throttle(0.0f),
+        roll_deg(0.0f),
+        pitch_deg(0.0f),
+        yaw_rate_dps(0.0f),
+        timestamp_us(0),
+        armed(false),
+        landing(false)
+    {}
+};
+
+// SharedMemory type ID (required for GSM.read<FlightCommand>() / GSM.write<FlightCommand>())
+#include "core/memory/SharedMemory.hpp"
+template<> inline shared_type_id_t getTypeId<FlightCommand>() { return 6; }
+
+#endif // FLIGHT_COMMAND_HPP
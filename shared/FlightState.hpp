@@ -0,0 +1,59 @@
+#ifndef FLIGHT_STATE_HPP
+#define FLIGHT_STATE_HPP
+
+#include <cstdint>
+
+// Type ID definition - matches SharedMemory.hpp
+typedef int shared_type_id_t;
+
+class FlightState {
+public:
+    uint32_t version;
+
+    // Attitude (body -> earth, earth z up), from flying_dragon_sensor_fusion
+    float quaternion[4];        // w, x, y, z
+    float roll_deg;
+    float pitch_deg;
+    float yaw_deg;              // Drifts slowly without a magnetometer
+
+    // Bias-corrected body rates
+    float roll_rate_dps;
+    float pitch_rate_dps;
+    float yaw_rate_dps;
+
+    // Barometer + accel complementary estimate, relative to the arming ground level
+    float altitude_m;
+    float vertical_speed_m_s;
+
+    // Status
+    uint32_t timestamp_us;
+    uint32_t update_count;
+    uint16_t imu_rate_hz;       // Achieved estimator rate
+    bool attitude_valid;        // Start-up convergence done
+    bool altitude_valid;        // Ground pressure captured
+
+    // Default constructor
+    FlightState() :
+        version(1),
+        quaternion{1.0f, 0.0f, 0.0f, 0.0f},
+        roll_deg(0.0f),
+        pitch_deg(0.0f),
+        yaw_deg(0.0f),
+        roll_rate_dps(0.0f),
+        pitch_rate_dps(0.0f),
+        yaw_rate_dps(0.0f),
+        altitude_m(0.0f),
+        vertical_speed_m_s(0.0f),
+        timestamp_us(0),
+        update_count(0),
+        imu_rate_hz(0),
+        attitude_valid(false),
+        altitude_valid(false)
+    {}
+};
+
+// SharedMemory type ID (required for GSM.read<FlightState>() / GSM.write<FlightState>())
+#include "core/memory/SharedMemory.hpp"
+template<> inline shared_type_id_t getTypeId<FlightState>() { return 5; }
+
+#endif // FLIGHT_STATE_HPP
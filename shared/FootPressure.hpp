@@ -0,0 +1,49 @@
+#ifndef FOOT_PRESSURE_HPP
+#define FOOT_PRESSURE_HPP
+
+#include <cstdint>
+
+// Type ID definition - matches SharedMemory.hpp
+typedef int shared_type_id_t;
+
+// Sole pressure of one foot, from its foot controller at 200 Hz.
+// Each foot board owns one of the two types below, so a foot publishing
+// never overwrites what the other foot last broadcast.
+class FootPressure {
+public:
+    uint32_t version;
+
+    int16_t cop_x_mm16;             // Center of pressure, 1/16 mm from foot center (x right)
+    int16_t cop_y_mm16;             // 1/16 mm, y forward
+    int16_t margin_mm16;            // CoP distance inside the support polygon (negative = outside)
+    uint16_t load_permille;         // Sum of FSR loads, per mille of one sensor's full scale
+    uint8_t contact_mask;           // FSRs in contact
+    uint8_t loading_pattern;        // loading_pattern_t
+    bool foot_stable;               // Margin above FOOT_STABILITY_MARGIN_MM
+    uint32_t timestamp_us;
+    uint32_t update_count;
+
+    // Default constructor
+    FootPressure() :
+        version(1),
+        cop_x_mm16(0),
+        cop_y_mm16(0),
+        margin_mm16(INT16_MIN),
+        load_permille(0),
+        contact_mask(0),
+        loading_pattern(0),
+        foot_stable(false),
+        timestamp_us(0),
+        update_count(0)
+    {}
+};
+
+class LeftFootPressure : public FootPressure {};
+class RightFootPressure : public FootPressure {};
+
+// SharedMemory type IDs (required for GSM.read<LeftFootPressure>() / GSM.write<LeftFootPressure>())
+#include "core/memory/SharedMemory.hpp"
+template<> inline shared_type_id_t getTypeId<LeftFootPressure>() { return 10; }
+template<> inline shared_type_id_t getTypeId<RightFootPressure>() { return 11; }
+
+#endif // FOOT_PRESSURE_HPP
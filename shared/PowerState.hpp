@@ -0,0 +1,50 @@
+#ifndef POWER_STATE_HPP
+#define POWER_STATE_HPP
+
+#include <cstdint>
+
+// Type ID definition - matches SharedMemory.hpp
+typedef int shared_type_id_t;
+
+class PowerState {
+public:
+    uint32_t version;
+
+    // Battery, from flying_dragon_power_system (oversampled ADC, filtered)
+    float battery_v;
+    float current_a;            // Positive = discharge
+    float soc_pct;              // 0-100, coulomb count corrected by the OCV curve
+    float consumed_mah;
+    float remaining_s;          // At the present draw
+
+    // Governor output - every subsystem scales its load from these
+    uint8_t level;              // 0 full, 1 eco, 2 low, 3 critical
+    uint8_t period_stretch;     // hitCount multiplier for "powerStretch" dispatch entries
+    uint8_t display_pct;        // Backlight brightness
+    uint8_t frame_divisor;      // Animations render every Nth frame
+
+    uint32_t timestamp_us;
+    bool valid;                 // At least one full ADC step measured
+
+    // Default constructor
+    PowerState() :
+        version(1),
+        battery_v(0.0f),
+        current_a(0.0f),
+        soc_pct(100.0f),
+        consumed_mah(0.0f),
+        remaining_s(0.0f),
+        level(0),
+        period_stretch(1),
+        display_pct(100),
+        frame_divisor(1),
+        timestamp_us(0),
+        valid(false)
+    {}
+};
+
+// SharedMemory type ID (required for GSM.read<PowerState>() / GSM.write<PowerState>())
+#include "core/memory/SharedMemory.hpp"
+template<> inline shared_type_id_t getTypeId<PowerState>() { return 7; }
+
+#endif // POWER_STATE_HPP
@@ -1,6 +1,8 @@
 #ifndef SENSOR_FUSION_HPP
 #define SENSOR_FUSION_HPP
 
+#include <cstdint>
+
 // Type ID definition - matches SharedMemory.hpp
 typedef int shared_type_id_t;
 
@@ -9,16 +11,45 @@ public:
     uint32_t version;
 
     // Combined sensor data from all chips
-    uint8_t fused_distance_cm;
+    uint8_t fused_distance_cm;      // 255 = nothing in range
     bool fused_touch_detected;
     int8_t fused_temperature_c;
     int8_t fused_humidity;
 
+    // Fixed-rate estimate from goblin_sensor_fusion (SensorFusionEngine)
+    uint8_t presence;               // 0-255: someone is there
+    uint8_t attention;              // 0-255: ...and engaging (close, approaching, touching, talking)
+    uint16_t proximity_cm;          // 0 = touching, 0xFFFF = unknown
+    int16_t approach_cm_s;          // Positive = coming closer
+    int16_t sound_azimuth_x10;      // Direction of the sound that counted, head frame
+    uint8_t source_confidence[4];   // Ultrasonic, PIR, touch, mic after age decay
+
     // Fusion metadata
-    uint8_t sensor_count;
+    uint8_t sensor_count;           // Sources still contributing
     uint32_t last_fusion_time;
     bool fusion_valid;
 
+    // Default constructor
+    SensorFusion() :
+        version(1),
+        fused_distance_cm(255),
+        fused_touch_detected(false),
+        fused_temperature_c(0),
+        fused_humidity(0),
+        presence(0),
+        attention(0),
+        proximity_cm(0xFFFF),
+        approach_cm_s(0),
+        sound_azimuth_x10(0),
+        source_confidence{0, 0, 0, 0},
+        sensor_count(0),
+        last_fusion_time(0),
+        fusion_valid(false)
+    {}
 };
 
-#endif // SENSOR_FUSION_HPP
\ No newline at end of file
+// SharedMemory type ID (required for GSM.read<SensorFusion>() / GSM.write<SensorFusion>())
+#include "core/memory/SharedMemory.hpp"
+template<> inline shared_type_id_t getTypeId<SensorFusion>() { return 4; }
+
+#endif // SENSOR_FUSION_HPP
@@ -0,0 +1,45 @@
+#ifndef SOUND_DIRECTION_HPP
+#define SOUND_DIRECTION_HPP
+
+#include <cstdint>
+
+// Type ID definition - matches SharedMemory.hpp
+typedef int shared_type_id_t;
+
+class SoundDirection {
+public:
+    uint32_t version;
+
+    // Direction estimate from the two-ear localizer (head frame)
+    int16_t azimuth_deg_x10;    // -900 = hard left, +900 = hard right
+    uint8_t confidence;         // 0-255, gaze/neck targeting should ignore low values
+
+    // Raw cues behind the estimate
+    int16_t tdoa_us;            // Left arrival minus right arrival
+    int16_t ild_db_x10;         // Right level minus left level
+    uint16_t level;             // Louder-ear RMS after whitening
+
+    // Status
+    uint32_t timestamp_ms;
+    uint32_t update_count;
+    bool valid;
+
+    // Default constructor
+    SoundDirection() :
+        version(1),
+        azimuth_deg_x10(0),
+        confidence(0),
+        tdoa_us(0),
+        ild_db_x10(0),
+        level(0),
+        timestamp_ms(0),
+        update_count(0),
+        valid(false)
+    {}
+};
+
+// SharedMemory type ID (required for GSM.read<SoundDirection>() / GSM.write<SoundDirection>())
+#include "core/memory/SharedMemory.hpp"
+template<> inline shared_type_id_t getTypeId<SoundDirection>() { return 3; }
+
+#endif // SOUND_DIRECTION_HPP
@@ -17,6 +17,12 @@ static uint8_t peer_addr[ESP_NOW_ETH_ALEN] = {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF};
 SharedMemory* SharedMemory::instance = nullptr;
 #if defined(CONFIG_ESP_WIFI_ESPNOW)
 bool SharedMemory::esp_now_initialized = false;
+
+// Protocols sharing the ESP-NOW receive callback, by frame magic
+static struct {
+    uint32_t magic;
+    volatile esp_now_recv_cb_t handler;
+} frame_handlers[SharedMemory::ESPNOW_FRAME_HANDLERS] = {};
 #endif
 
 #if defined(CONFIG_ESP_WIFI_ESPNOW)
@@ -57,6 +63,66 @@ void SharedMemory::on_data_recv(const uint8_t* mac_addr, const uint8_t* data, in
     // Update memory from network data
     instance->update_memory_from_network(type_id, payload, payload_size);
 }
+
+// The node's one ESP-NOW receive callback (WiFi task): registered protocols
+// by magic, GSM updates otherwise
+void SharedMemory::espnow_recv(const esp_now_recv_info_t* recv_info, const uint8_t* data, int len) 
+{
+    if (len >= (int)sizeof(uint32_t)) 
+    {
+        uint32_t magic;
+        memcpy(&magic, data, sizeof(magic));
+        for (int i = 0; i < ESPNOW_FRAME_HANDLERS; i++) 
+        {
+            esp_now_recv_cb_t handler = frame_handlers[i].handler;
+            if (handler && frame_handlers[i].magic == magic) 
+            {
+                handler(recv_info, data, len);
+                return;
+            }
+        }
+    }
+    on_data_recv(recv_info->src_addr, data, len);
+}
+
+esp_err_t SharedMemory::espnow_add_frame_handler(uint32_t magic, esp_now_recv_cb_t handler) 
+{
+    int slot = -1;
+    for (int i = 0; i < ESPNOW_FRAME_HANDLERS; i++) 
+    {
+        if (frame_handlers[i].handler && frame_handlers[i].magic == magic) 
+        {
+            slot = i;       // Replace
+            break;
+        }
+        if (!frame_handlers[i].handler && slot < 0) 
+        {
+            slot = i;
+        }
+    }
+    if (slot < 0) 
+    {
+        ESP_LOGE(TAG, "No free ESP-NOW frame handler for magic 0x%08lx", (unsigned long)magic);
+        return ESP_ERR_NO_MEM;
+    }
+    frame_handlers[slot].handler = NULL;
+    frame_handlers[slot].magic = magic;
+    frame_handlers[slot].handler = handler;
+    
+    // Whoever comes first installs the dispatcher; ESP-NOW must be up
+    return esp_now_register_recv_cb(espnow_recv);
+}
+
+void SharedMemory::espnow_remove_frame_handler(uint32_t magic) 
+{
+    for (int i = 0; i < ESPNOW_FRAME_HANDLERS; i++) 
+    {
+        if (frame_handlers[i].magic == magic) 
+        {
+            frame_handlers[i].handler = NULL;
+        }
+    }
+}
 #endif
 
 #if defined(CONFIG_ESP_WIFI_ESPNOW)
@@ -73,9 +139,7 @@ void SharedMemory::espnow_init()
     ESP_ERROR_CHECK(esp_now_register_send_cb([](const esp_now_send_info_t* send_info, esp_now_send_status_t status) {
         SharedMemory::on_data_sent(send_info->des_addr, status);
     }));
-    ESP_ERROR_CHECK(esp_now_register_recv_cb([](const esp_now_recv_info_t* recv_info, const uint8_t* data, int len) {
-        SharedMemory::on_data_recv(recv_info->src_addr, data, len);
-    }));
+    ESP_ERROR_CHECK(esp_now_register_recv_cb(espnow_recv));
     
     // Add broadcast peer
     esp_now_peer_info_t peerInfo = {};
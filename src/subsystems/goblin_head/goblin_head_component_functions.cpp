@@ -35,8 +35,9 @@ static int current_row_count = 10;
 static int max_display_height = INT_MAX;  // Min height across all displays
 static char* color_schema = nullptr;
 
+static int chunk_count;
 static bool debug = true;
-// --- Begin: config\components\hardware\gc9a01.src ---
+// --- Begin: config/components/hardware/gc9a01.src ---
 // gc9a01 component implementation
 // Defines display parameters via gc9a01.hdr for upstream components
 // Actual display I/O handled by lower-level driver (generic_spi_display)
@@ -53,9 +54,9 @@ void gc9a01_act(void)
 {
     // No-op: display I/O handled by lower layers
 }
-// --- End: config\components\hardware\gc9a01.src ---
+// --- End: config/components/hardware/gc9a01.src ---
 
-// --- Begin: config\components\drivers\generic_spi_display.src ---
+// --- Begin: config/components/drivers/generic_spi_display.src ---
 // generic_spi_display.src - Display output driver with debug routing
 // If debug=true: sends buffer data to PC via network (for visualization)
 // If debug=false: sends buffer data to physical GC9A01 displays via SPI DMA
@@ -267,20 +268,24 @@ esp_err_t generic_spi_display_init(void) {
     
     if (debug)
     {
-        // Debug mode: WiFi disabled, will output to serial monitor only
-        ESP_LOGI(TAG, "Display driver init: DEBUG MODE (serial monitor output)");
-        
-        // WiFi code temporarily disabled
-        // if (!wifi_already_initialized)
-        // {
-        //     esp_err_t ret = setup_wifi();
-        //     if (ret != ESP_OK)
-        //     {
-        //         ESP_LOGE(TAG, "WiFi setup failed: %d", ret);
-        //         return ret;
-        //     }
-        //     wifi_already_initialized = true;
-        // }
+        // Debug mode: setup WiFi and connect to visualization server
+        ESP_LOGI(TAG, "Display driver init: DEBUG MODE (network to PC)");
+        
+        // Only first display initializes WiFi (shared resource)
+        if (!wifi_already_initialized)
+        {
+            esp_err_t ret = setup_wifi();
+            if (ret != ESP_OK)
+            {
+                ESP_LOGE(TAG, "WiFi setup failed: %d", ret);
+                return ret;
+            }
+            wifi_already_initialized = true;
+        }
+        else
+        {
+            ESP_LOGI(TAG, "WiFi already initialized by another display");
+        }
     }
     else
     {
@@ -306,20 +311,20 @@ void generic_spi_display_act(void) {
     
     if (debug)
     {
-        // === DEBUG MODE: Output to serial monitor ===
-        
-        // Network code temporarily disabled
-        // if (!network_state.connected_to_server)
-        // {
-        //     static uint32_t last_connect_attempt = 0;
-        //     uint32_t now = esp_log_timestamp();
-        //     if (now - last_connect_attempt > 5000)
-        //     {
-        //         connect_to_server();
-        //         last_connect_attempt = now;
-        //     }
-        //     return;
-        // }
+        // === DEBUG MODE: Send buffer to PC via network ===
+        
+        // Try to connect if not connected
+        if (!network_state.connected_to_server)
+        {
+            static uint32_t last_connect_attempt = 0;
+            uint32_t now = esp_log_timestamp();
+            if (now - last_connect_attempt > 5000)  // Try every 5 seconds
+            {
+                connect_to_server();
+                last_connect_attempt = now;
+            }
+            return;
+        }
         
         // Rotate through display slots
         if (display_buffers[current_send_slot].front_buffer == NULL || 
@@ -342,55 +347,49 @@ void generic_spi_display_act(void) {
         
         display_buffer_slot_t* slot = &display_buffers[current_send_slot];
         
-        // Output debug info to serial monitor instead of network
-        ESP_LOGI(TAG, "[DEBUG] Slot %d: buffer=%p, size=%u bytes, dims=%dx%d, bpp=%d, current_row_count=%d",
-                 current_send_slot, (void*)slot->front_buffer, slot->buffer_size,
-                 slot->width, slot->height, slot->bpp, current_row_count);
-        
-        // Network send code temporarily disabled
         // Build and send packet header
-        // typedef struct {
-        //     uint32_t magic;
-        //     uint32_t frame_number;
-        //     uint32_t width;
-        //     uint32_t height;
-        //     uint32_t bytes_per_pixel;
-        // } __attribute__((packed)) display_packet_header_t;
-        // 
-        // display_packet_header_t header;
-        // header.magic = 0xDEADBEEF;
-        // header.frame_number = network_state.frames_sent;
-        // header.width = slot->width;
-        // header.height = slot->height;
-        // header.bytes_per_pixel = slot->bpp;
-        // 
+        typedef struct {
+            uint32_t magic;
+            uint32_t frame_number;
+            uint32_t width;
+            uint32_t height;
+            uint32_t bytes_per_pixel;
+        } __attribute__((packed)) display_packet_header_t;
+        
+        display_packet_header_t header;
+        header.magic = 0xDEADBEEF;
+        header.frame_number = network_state.frames_sent;
+        header.width = slot->width;
+        header.height = slot->height;
+        header.bytes_per_pixel = slot->bpp;
+        
         // Debug output: show parameters being sent
-        // ESP_LOGI(TAG, "[DEBUG] Sending: slot=%d, buffer=%p, size=%u bytes, dims=%dx%d, current_row_count=%d",
-        //          current_send_slot, (void*)slot->front_buffer, slot->buffer_size, 
-        //          slot->width, slot->height, current_row_count);
-        // 
+        ESP_LOGI(TAG, "[DEBUG] Sending: slot=%d, buffer=%p, size=%u bytes, dims=%dx%d, current_row_count=%d",
+                 current_send_slot, (void*)slot->front_buffer, slot->buffer_size, 
+                 slot->width, slot->height, current_row_count);
+        
         // Send header
-        // ssize_t sent_header = send(network_state.socket_fd, &header, sizeof(header), 0);
-        // if (sent_header != sizeof(header))
-        // {
-        //     ESP_LOGE(TAG, "Failed to send header: %d", sent_header);
-        // }
-        // else
-        // {
-        //     Send full frame from front_buffer (already allocated in internal RAM!)
-        //     ssize_t sent_data = send(network_state.socket_fd, slot->front_buffer, slot->buffer_size, 0);
-        //     if (sent_data == slot->buffer_size)
-        //     {
-        //         network_state.frames_sent++;
-        //         ESP_LOGI(TAG, "[DEBUG] Successfully sent frame %u from slot %d: %u bytes total",
-        //                  network_state.frames_sent, current_send_slot, 
-        //                  (uint32_t)(sizeof(header) + slot->buffer_size));
-        //     }
-        //     else
-        //     {
-        //         ESP_LOGE(TAG, "Failed to send data: %d (expected %u)", sent_data, slot->buffer_size);
-        //     }
-        // }
+        ssize_t sent_header = send(network_state.socket_fd, &header, sizeof(header), 0);
+        if (sent_header != sizeof(header))
+        {
+            ESP_LOGE(TAG, "Failed to send header: %d", sent_header);
+        }
+        else
+        {
+            // Send full frame from front_buffer (already allocated in internal RAM!)
+            ssize_t sent_data = send(network_state.socket_fd, slot->front_buffer, slot->buffer_size, 0);
+            if (sent_data == slot->buffer_size)
+            {
+                network_state.frames_sent++;
+                ESP_LOGI(TAG, "[DEBUG] Successfully sent frame %u from slot %d: %u bytes total",
+                         network_state.frames_sent, current_send_slot, 
+                         (uint32_t)(sizeof(header) + slot->buffer_size));
+            }
+            else
+            {
+                ESP_LOGE(TAG, "Failed to send data: %d (expected %u)", sent_data, slot->buffer_size);
+            }
+        }
         
         // Move to next slot for next call
         current_send_slot++;
@@ -508,23 +507,148 @@ void generic_spi_display_act(void) {
         }
     }
 }
-// --- End: config\components\drivers\generic_spi_display.src ---
+// --- End: config/components/drivers/generic_spi_display.src ---
+
+// --- Begin: config/bots/bot_families/goblins/head/goblin_ear_localizer.src ---
+// goblin_ear_localizer component implementation
+// Turns the two independent ear microphones into a direction sensor
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "config/components/templates/StereoEarLocalizer.hpp"
+#include "shared/SoundDirection.hpp"
+
+#define EAR_LOCALIZER_SAMPLE_RATE 16000
+#define EAR_LOCALIZER_SPACING_MM 100       // ear_left/ear_right mounting points in goblin_head.json
+#define EAR_LOCALIZER_BLOCK 256            // 16 ms per estimate
+#define EAR_LOCALIZER_MIN_CONFIDENCE 40    // Below this, leave the last published direction alone
+
+static StereoEarLocalizer ear_localizer;
+
+// Block assembly: I2S delivers whatever the DMA ring holds, estimates need full blocks
+static int32_t ear_frames[EAR_LOCALIZER_BLOCK * 2];
+static int16_t ear_left_block[EAR_LOCALIZER_BLOCK];
+static int16_t ear_right_block[EAR_LOCALIZER_BLOCK];
+static size_t ear_block_fill = 0;
+
+static uint32_t ear_blocks_processed = 0;
+static uint64_t ear_process_time_us = 0;
+
+esp_err_t goblin_ear_localizer_init(void) {
+    ESP_LOGI("goblin_ear_localizer", "Initializing stereo ear localizer");
+    
+    ear_localizer.configure(EAR_LOCALIZER_SAMPLE_RATE, EAR_LOCALIZER_SPACING_MM);
+    ear_block_fill = 0;
+    
+    SoundDirection* direction = GSM.read<SoundDirection>();
+    direction->valid = false;
+    GSM.write<SoundDirection>();
+    
+    ESP_LOGI("goblin_ear_localizer", "Localizer ready: %d-sample blocks, +/-%d lag search",
+             EAR_LOCALIZER_BLOCK, ear_localizer.maxLag());
+    return ESP_OK;
+}
+
+void goblin_ear_localizer_act(void) {
+    size_t frames_read = 0;
+    size_t wanted = EAR_LOCALIZER_BLOCK - ear_block_fill;
+    esp_err_t result = i2s_generic_driver_read_stereo(ear_frames, wanted, &frames_read);
+    if (result != ESP_OK && result != ESP_ERR_TIMEOUT) {
+        ESP_LOGW("goblin_ear_localizer", "Stereo read failed: %d", result);
+        return;
+    }
+    
+    // Convert 32-bit I2S slots (24-bit data, left slot first) to 16-bit
+    for (size_t i = 0; i < frames_read; i++) {
+        ear_left_block[ear_block_fill + i] = (int16_t)(ear_frames[2 * i] >> 16);
+        ear_right_block[ear_block_fill + i] = (int16_t)(ear_frames[2 * i + 1] >> 16);
+    }
+    ear_block_fill += frames_read;
+    if (ear_block_fill < EAR_LOCALIZER_BLOCK) {
+        return;
+    }
+    ear_block_fill = 0;
+    
+    uint64_t start_us = esp_timer_get_time();
+    StereoEarLocalizer::Estimate estimate;
+    ear_localizer.processBlock(ear_left_block, ear_right_block, EAR_LOCALIZER_BLOCK, estimate);
+    ear_process_time_us += esp_timer_get_time() - start_us;
+    ear_blocks_processed++;
+    
+    // Loudness counts for presence even when the direction is unsure
+    if (estimate.valid) {
+        goblin_sensor_fusion_post(GOBLIN_FUSION_MIC, (uint32_t)(start_us / 1000),
+                                  (int16_t)(estimate.level > 32767 ? 32767 : estimate.level),
+                                  estimate.azimuth_deg_x10, estimate.confidence);
+    }
+    
+    if (estimate.valid && estimate.confidence >= EAR_LOCALIZER_MIN_CONFIDENCE) {
+        SoundDirection* direction = GSM.read<SoundDirection>();
+        direction->azimuth_deg_x10 = estimate.azimuth_deg_x10;
+        direction->confidence = estimate.confidence;
+        direction->tdoa_us = estimate.tdoa_us;
+        direction->ild_db_x10 = estimate.ild_db_x10;
+        direction->level = estimate.level;
+        direction->timestamp_ms = (uint32_t)(esp_timer_get_time() / 1000);
+        direction->update_count++;
+        direction->valid = true;
+        GSM.write<SoundDirection>();
+        
+        ESP_LOGD("goblin_ear_localizer", "Sound at %d.%d deg (conf %u, tdoa %d us, ild %d.%d dB)",
+                 estimate.azimuth_deg_x10 / 10, abs(estimate.azimuth_deg_x10 % 10), estimate.confidence,
+                 estimate.tdoa_us, estimate.ild_db_x10 / 10, abs(estimate.ild_db_x10 % 10));
+    }
+    
+    if (ear_blocks_processed % 625 == 0) {  // Every ~10 s
+        ESP_LOGI("goblin_ear_localizer", "Average cost %llu us per %d-sample block",
+                 ear_process_time_us / ear_blocks_processed, EAR_LOCALIZER_BLOCK);
+    }
+}
+// --- End: config/bots/bot_families/goblins/head/goblin_ear_localizer.src ---
 
-// --- Begin: config\bots\bot_families\goblins\head\goblin_eye.src ---
+// --- Begin: config/bots/bot_families/goblins/head/goblin_eye.src ---
 // goblin_eye component implementation
 // Generic goblin eye rendering using mood-based color effects
 // Note: display_width, display_height, bytes_per_pixel are injected by use_fields system
 
+#include <string.h>
 #include "esp_log.h"
+#include "esp_heap_caps.h"
 #include "shared/mood.hpp"
 #include "core/memory/SharedMemory.hpp"
+#include "config/components/templates/MoodTintCache.hpp"
 
 // Goblin emotion intensity multiplier - goblins show emotions STRONGLY (1.5x)
 static constexpr float GOBLIN_EMOTION_INTENSITY = 1.5f;
 
-// Mood tracking for optimization
-static Mood lastMood;
-static bool mood_initialized = false;
+// Tinted frame cache in PSRAM: revisiting a recent mood costs a lookup and a
+// copy instead of a retint. Mood is snapped to 8-unit bins for the key.
+// 24 frames hold a 4-frame blink under the last 6 moods
+#define EYE_TINT_CACHE_SLOTS 24
+#define EYE_TINT_CACHE_BUDGET_BYTES (24UL * 240 * 240 * 2)     // ~2.6 MB
+#define EYE_TINT_MOOD_SHIFT 3
+
+typedef MoodTintCache<EYE_TINT_CACHE_SLOTS> EyeTintCache;
+
+static EyeTintCache eye_tint_cache;
+static bool eye_tint_cache_ready = false;
+
+// Untinted art currently shown; front_buffer is only ever written from it
+static const uint8_t* eye_source = NULL;
+static uint32_t eye_source_id = 0;
+static uint8_t* eye_captured_source = NULL;     // Snapshot when no source was set
+
+// Key of the frame now in front_buffer
+static EyeTintCache::Key eye_shown_key;
+static bool eye_shown_valid = false;
+static uint32_t eye_retints = 0;
+
+// Pupil centre from goblin_gaze; the art is drawn looking straight ahead and
+// slid by the pupil's offset from the display centre. Negative = centred
+static int32_t eye_pupil_x = -1;
+static int32_t eye_pupil_y = -1;
+static int32_t eye_shown_dx = 0;
+static int32_t eye_shown_dy = 0;
 
 // Mood-to-color mapping for goblin eyes
 static const MoodColorEffect goblin_mood_effects[Mood::componentCount] = {
@@ -548,13 +672,130 @@ static const MoodColorEffect goblin_mood_effects[Mood::componentCount] = {
     MoodColorEffect(0.5f * GOBLIN_EMOTION_INTENSITY, 0.5f * GOBLIN_EMOTION_INTENSITY, 0.5f * GOBLIN_EMOTION_INTENSITY)
 };
 
+/**
+ * Set the untinted source for the next frames (e.g. the current animation
+ * frame in PSRAM). frame_id must change whenever the pixels do
+ */
+void goblin_eye_show_frame(const uint8_t* source, uint32_t frame_id)
+{
+    eye_source = source;
+    eye_source_id = frame_id;
+}
+
+/**
+ * Pupil centre in display pixels (both eyes share one buffer, so one pupil)
+ */
+void goblin_eye_set_pupil(uint16_t x, uint16_t y)
+{
+    eye_pupil_x = x;
+    eye_pupil_y = y;
+}
+
+static int32_t eye_pupil_offset(int32_t pupil, int32_t span)
+{
+    if (pupil < 0)
+    {
+        return 0;
+    }
+    int32_t offset = pupil - span / 2;
+    int32_t limit = span / 4;       // Further and the iris slides off the lens
+    return offset < -limit ? -limit : (offset > limit ? limit : offset);
+}
+
+/**
+ * Copy source into dest moved by (dx, dy) pixels, repeating the edge rows and
+ * columns into the uncovered strip. dest may be source
+ */
+static void eye_blit_offset(uint8_t* dest, const uint8_t* source, int32_t dx, int32_t dy)
+{
+    const int32_t row_bytes = display_width * bytes_per_pixel;
+    const int32_t shift_bytes = (dx < 0 ? -dx : dx) * bytes_per_pixel;
+    uint8_t edge[4];
+
+    // Rows that still have to be read stay ahead of the rows being written
+    for (int32_t i = 0; i < display_height; i++)
+    {
+        int32_t y = dy > 0 ? display_height - 1 - i : i;
+        int32_t from = y - dy;
+        from = from < 0 ? 0 : (from >= display_height ? display_height - 1 : from);
+        uint8_t* d = dest + y * row_bytes;
+        const uint8_t* s = source + from * row_bytes;
+
+        if (dx > 0)
+        {
+            memcpy(edge, s, bytes_per_pixel);
+            memmove(d + shift_bytes, s, row_bytes - shift_bytes);
+            for (int32_t x = 0; x < shift_bytes; x += bytes_per_pixel)
+            {
+                memcpy(d + x, edge, bytes_per_pixel);
+            }
+        }
+        else if (dx < 0)
+        {
+            memcpy(edge, s + row_bytes - bytes_per_pixel, bytes_per_pixel);
+            memmove(d, s + shift_bytes, row_bytes - shift_bytes);
+            for (int32_t x = row_bytes - shift_bytes; x < row_bytes; x += bytes_per_pixel)
+            {
+                memcpy(d + x, edge, bytes_per_pixel);
+            }
+        }
+        else if (d != s)
+        {
+            memcpy(d, s, row_bytes);
+        }
+    }
+}
+
+static void eye_tint_cache_setup(void)
+{
+    uint8_t* arena = (uint8_t*)heap_caps_malloc(EYE_TINT_CACHE_BUDGET_BYTES, MALLOC_CAP_SPIRAM);
+    if (arena == NULL)
+    {
+        ESP_LOGW("goblin_eye", "No PSRAM for the tint cache, retinting every mood change");
+    }
+    eye_tint_cache.configure(arena, arena ? EYE_TINT_CACHE_BUDGET_BYTES : 0, display_size, EYE_TINT_MOOD_SHIFT);
+
+    // Nothing has provided art yet: keep what the eye allocator painted as frame 0
+    if (eye_source == NULL)
+    {
+        eye_captured_source = (uint8_t*)heap_caps_malloc(display_size, MALLOC_CAP_SPIRAM);
+        if (eye_captured_source != NULL)
+        {
+            memcpy(eye_captured_source, front_buffer, display_size);
+            goblin_eye_show_frame(eye_captured_source, 0);
+        }
+    }
+    eye_tint_cache_ready = true;
+
+    ESP_LOGI("goblin_eye", "Tint cache: %u slots of %lu bytes, mood grid %d",
+             eye_tint_cache.slots(), (unsigned long)display_size, 1 << EYE_TINT_MOOD_SHIFT);
+}
+
+/**
+ * Tint source with the snapped mood of key into dest
+ */
+static void eye_tint_frame(uint8_t* dest, const uint8_t* source, const EyeTintCache::Key& key)
+{
+    Mood snapped;
+    for (int i = 0; i < Mood::componentCount; ++i)
+    {
+        snapped.components[i] = key.mood[i];
+    }
+    if (dest != source)
+    {
+        memcpy(dest, source, display_size);
+    }
+    adjustMood<Pixel_RGB565>(dest, display_size / bytes_per_pixel, snapped, goblin_mood_effects);
+    eye_retints++;
+}
+
 esp_err_t goblin_eye_init(void) 
 {
     ESP_LOGI("goblin_eye", "Initializing goblin eye mood processing (intensity: %.1fx)", GOBLIN_EMOTION_INTENSITY);
     
-    // Clear mood tracking
-    lastMood.clear();
-    mood_initialized = false;
+    // Cache and source are set up on the first act(), once the eye buffer exists
+    eye_shown_valid = false;
+    eye_retints = 0;
     
     return ESP_OK;
 }
@@ -574,177 +815,2839 @@ void goblin_eye_act(void)
         return;
     }
     
-    // Check if mood changed (optimization - only render when mood changes)
-    if (lastMood != *mood_ptr || !mood_initialized)
+    if (!eye_tint_cache_ready)
     {
-        // Calculate pixel count from buffer size
-        const uint32_t pixel_count = display_size / bytes_per_pixel;
-        
-        // Apply mood effects to display buffer
-        adjustMood<Pixel_RGB565>(
-            front_buffer,
-            pixel_count,
-            *mood_ptr,
-            goblin_mood_effects
-        );
-        
-        lastMood = *mood_ptr;
-        mood_initialized = true;
-        
-        ESP_LOGD("goblin_eye", "Applied mood effects to buffer (%u pixels)", pixel_count);
+        eye_tint_cache_setup();
+    }
+    if (eye_source == NULL)
+    {
+        return;
     }
-}
-// --- End: config\bots\bot_families\goblins\head\goblin_eye.src ---
-
-// --- Begin: config\bots\bot_families\goblins\head\goblin_left_eye.src ---
-// goblin_left_eye.src - Allocate display buffer for left eye
-// Component chain: goblin_left_eye (allocate) -> goblin_eye (render) -> generic_spi_display (send)
-// Note: display_width, display_height, bytes_per_pixel auto-assigned by use_fields in init() and act()
-
-#include "esp_log.h"
-#include "esp_heap_caps.h"
 
-// Eye position (left eye relative to skull center)
-struct LeftEyePosition {
-    int16_t x;      // -50 = left of center
-    int16_t y;      // +30 = above center
-    int16_t z;      // -35 = slightly back
-} left_eye_position = {-50, 30, -35};
+    // Same source frame, mood bin and pupil: front_buffer is already right
+    EyeTintCache::Key key = eye_tint_cache.makeKey(eye_source_id, mood_ptr->components, Mood::componentCount);
+    int32_t dx = eye_pupil_offset(eye_pupil_x, display_width);
+    int32_t dy = eye_pupil_offset(eye_pupil_y, display_height);
+    if (eye_shown_valid && EyeTintCache::sameKey(key, eye_shown_key) && dx == eye_shown_dx && dy == eye_shown_dy)
+    {
+        return;
+    }
 
-esp_err_t goblin_left_eye_init(void)
-{
-    // NOTE: display_width, display_height, bytes_per_pixel are auto-assigned above by generator
-    
-    // Calculate buffer size based on display parameters
-    display_size = display_width * display_height * bytes_per_pixel;
-    
-    ESP_LOGI("goblin_left_eye", "Allocating display buffer for left eye (%u bytes, %dx%d)", 
-             display_size, display_width, display_height);
-    
-    // Allocate front buffer (DMA-capable internal RAM)
-    front_buffer = (uint8_t*)heap_caps_malloc(display_size, MALLOC_CAP_DMA);
-    if (!front_buffer)
+    const uint8_t* tinted = eye_tint_cache.find(key);
+    if (tinted == NULL)
     {
-        ESP_LOGE("goblin_left_eye", "Failed to allocate %u bytes for front buffer", display_size);
-        return ESP_ERR_NO_MEM;
+        uint8_t* slot = eye_tint_cache.insert(key);
+        if (slot == NULL)
+        {
+            eye_tint_frame(front_buffer, eye_source, key);      // No cache budget
+            eye_blit_offset(front_buffer, front_buffer, dx, dy);
+        }
+        else
+        {
+            eye_tint_frame(slot, eye_source, key);
+            tinted = slot;
+        }
     }
-    
-    // Allocate back buffer (DMA-capable internal RAM)
-    back_buffer = (uint8_t*)heap_caps_malloc(display_size, MALLOC_CAP_DMA);
-    if (!back_buffer)
+    if (tinted != NULL)
     {
-        ESP_LOGE("goblin_left_eye", "Failed to allocate %u bytes for back buffer", display_size);
-        free(front_buffer);
-        front_buffer = NULL;
-        return ESP_ERR_NO_MEM;
+        eye_blit_offset(front_buffer, tinted, dx, dy);
     }
-    
-    // Initialize both buffers with neutral color (dark green iris)
-    uint16_t neutral = 0x0400;  // RGB565: (0, 8, 0)
-    uint16_t* front_u16 = (uint16_t*)front_buffer;
-    uint16_t* back_u16 = (uint16_t*)back_buffer;
-    
-    uint32_t pixel_count = display_size / bytes_per_pixel;
-    for (uint32_t i = 0; i < pixel_count; i++)
+    eye_shown_key = key;
+    eye_shown_valid = true;
+    eye_shown_dx = dx;
+    eye_shown_dy = dy;
+
+    if (eye_tint_cache.lookups() % 256 == 0)
     {
-        front_u16[i] = neutral;
-        back_u16[i] = neutral;
+        ESP_LOGI("goblin_eye", "Tint cache: %lu%% hits of %lu lookups, %lu retints, %lu evictions, %llu KB not retinted",
+                 (unsigned long)eye_tint_cache.hitRate(), (unsigned long)eye_tint_cache.lookups(),
+                 (unsigned long)eye_retints, (unsigned long)eye_tint_cache.evictions(),
+                 (unsigned long long)(eye_tint_cache.bytesSaved() / 1024));
     }
+}
+// --- End: config/bots/bot_families/goblins/head/goblin_eye.src ---
+
+// --- Begin: config/bots/bot_families/goblins/head/goblin_gaze.src ---
+// goblin_gaze component implementation
+// Oculomotor layer between the head's sensors and the eyes / neck
+// Targets: SoundDirection from goblin_ear_localizer, SensorFusion from goblin_sensor_fusion
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "config/components/templates/GazeController.hpp"
+// Removed: #include "shared/SensorFusion.hpp" - auto-included by generator
+#include "shared/SoundDirection.hpp"
+
+#define GAZE_TICK_HZ 200
+#define GAZE_PERIOD_US (1000000 / GAZE_TICK_HZ)
+#define GAZE_MAX_CATCHUP 8                  // Ticks run per act() at most
+#define GAZE_EYE_PAN_LIMIT 45.0f
+#define GAZE_EYE_TILT_LIMIT 30.0f
+#define GAZE_NECK_OFFLOAD_DEG 15.0f
+#define GAZE_SOUND_MIN_CONFIDENCE 96
+#define GAZE_ATTENTION_MIN 64
+#define GAZE_TARGET_TIMEOUT_MS 2000         // No sensor target this long: hold gaze
+
+static GazeController gaze;
+static uint64_t gaze_next_tick_us = 0;
+static uint32_t gaze_last_sound_update = 0;
+static uint32_t gaze_last_fusion_time = 0;
+static uint32_t gaze_last_target_ms = 0;
+static uint16_t gaze_neck_seq = 0;
+static uint16_t gaze_pupil_x = 0;
+static uint16_t gaze_pupil_y = 0;
+static uint32_t gaze_ticks = 0;
+static uint64_t gaze_time_us = 0;
+
+esp_err_t goblin_gaze_init(void) {
+    ESP_LOGI("goblin_gaze", "Initializing gaze controller");
     
-    ESP_LOGI("goblin_left_eye", "Display buffers allocated (position: %d,%d,%d mm)",
-             left_eye_position.x, left_eye_position.y, left_eye_position.z);
+    gaze.configure(GAZE_TICK_HZ, GAZE_EYE_PAN_LIMIT, GAZE_EYE_TILT_LIMIT, GAZE_NECK_OFFLOAD_DEG);
+    gaze.setNeckLimits(60.0f, 30.0f);
+    gaze.setDisplay(240, 240, 1.5f, 53.0f);     // GC9A01 eyes, 53 mm apart
+    gaze_neck_seq = gaze.output().neck_request_seq;
+    gaze_next_tick_us = esp_timer_get_time();
     
+    ESP_LOGI("goblin_gaze", "Gaze ready: %d Hz, eyes +/-%.0f/%.0f deg, neck beyond %.0f deg",
+             GAZE_TICK_HZ, GAZE_EYE_PAN_LIMIT, GAZE_EYE_TILT_LIMIT, GAZE_NECK_OFFLOAD_DEG);
     return ESP_OK;
 }
 
-void goblin_left_eye_act(void)
-{
-    // NOTE: display_width, display_height, bytes_per_pixel are auto-assigned above by generator
+// Sound direction wins when it is confident; otherwise the fused estimate
+static void goblin_gaze_update_target(uint32_t now_ms) {
+    SensorFusion* fused = GSM.read<SensorFusion>();
+    SoundDirection* sound = GSM.read<SoundDirection>();
+    float distance_cm = (fused->proximity_cm == 0xFFFF) ? 0.0f : (float)fused->proximity_cm;
     
-    // Buffer management handled by component chain:
-    // - goblin_eye.src will render mood effects into front_buffer
-    // - generic_spi_display.src will send to hardware or debug server
+    if (sound->valid && sound->confidence >= GAZE_SOUND_MIN_CONFIDENCE &&
+        sound->update_count != gaze_last_sound_update) {
+        gaze_last_sound_update = sound->update_count;
+        gaze.setTarget(sound->azimuth_deg_x10 / 10.0f, 0.0f, distance_cm);
+        gaze_last_target_ms = now_ms;
+    } else if (fused->fusion_valid && fused->attention >= GAZE_ATTENTION_MIN &&
+               fused->last_fusion_time != gaze_last_fusion_time) {
+        gaze_last_fusion_time = fused->last_fusion_time;
+        gaze.setTarget(fused->sound_azimuth_x10 / 10.0f, 0.0f, distance_cm);
+        gaze_last_target_ms = now_ms;
+    } else if (now_ms - gaze_last_target_ms > GAZE_TARGET_TIMEOUT_MS) {
+        gaze.clearTarget();
+    }
 }
-// --- End: config\bots\bot_families\goblins\head\goblin_left_eye.src ---
 
-// --- Begin: config\bots\bot_families\goblins\head\goblin_mouth_display.src ---
-// goblin_mouth_display.src - Mouth display (currently disabled - not enough RAM)
-// Note: display_width, display_height, bytes_per_pixel auto-assigned by use_fields
+void goblin_gaze_act(void) {
+    uint64_t start_us = esp_timer_get_time();
+    if ((int64_t)(start_us - gaze_next_tick_us) < 0) {
+        return;
+    }
+    
+    goblin_gaze_update_target((uint32_t)(start_us / 1000));
+    
+    // Fixed rate; bounded catch-up, then skip ahead instead of bursting
+    int ticks = 0;
+    while ((int64_t)(start_us - gaze_next_tick_us) >= 0 && ticks < GAZE_MAX_CATCHUP) {
+        float neck_pan, neck_tilt, neck_roll;
+        goblin_head_neck_motor_get_pose(&neck_pan, &neck_tilt, &neck_roll);
+        gaze.setNeckPose(neck_pan, neck_tilt);
+        gaze.tick();
+        gaze_next_tick_us += GAZE_PERIOD_US;
+        ticks++;
+    }
+    if ((int64_t)(start_us - gaze_next_tick_us) >= 0) {
+        gaze_next_tick_us = start_us + GAZE_PERIOD_US;
+    }
+    
+    const GazeController::Output& out = gaze.output();
+    if (out.neck_request_seq != gaze_neck_seq) {
+        gaze_neck_seq = out.neck_request_seq;
+        goblin_head_neck_motor_set_pose(out.neck_pan_q16 / 65536.0f, out.neck_tilt_q16 / 65536.0f, 0.0f);
+    }
+    
+    // Both eyes share one frame buffer: draw the pupil midway between them
+    uint16_t pupil_x = (uint16_t)((out.pupil_left_x + out.pupil_right_x) / 2);
+    uint16_t pupil_y = out.pupil_left_y;
+    if (pupil_x != gaze_pupil_x || pupil_y != gaze_pupil_y) {
+        gaze_pupil_x = pupil_x;
+        gaze_pupil_y = pupil_y;
+        goblin_eye_set_pupil(pupil_x, pupil_y);
+    }
+    
+    gaze_time_us += esp_timer_get_time() - start_us;
+    gaze_ticks += ticks;
+    if (gaze_ticks >= 2000) {  // Every ~10 s
+        const GazeController::Stats& stats = gaze.getStats();
+        ESP_LOGI("goblin_gaze", "%lu saccades, %lu microsaccades, %lu neck requests, %lu us per tick",
+                 (unsigned long)stats.saccades, (unsigned long)stats.microsaccades,
+                 (unsigned long)stats.neck_requests, (unsigned long)(gaze_time_us / gaze_ticks));
+        gaze_ticks = 0;
+        gaze_time_us = 0;
+    }
+}
+// --- End: config/bots/bot_families/goblins/head/goblin_gaze.src ---
 
+// --- Begin: config/components/creature_specific/goblin_head_neck_motor.src ---
+// Removed: #include "goblin_head_neck_motor.hdr" - .hdr content aggregated into .hpp
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "config/components/templates/MinJerkTrajectory.hpp"
 
-// Mouth position (relative to skull center)
-struct MouthPosition {
-    int16_t x;      // 0 = center
-    int16_t y;      // -80 = below center
-    int16_t z;      // 0 = front of face
-} mouth_position = {0, -80, 0};
-
-esp_err_t goblin_mouth_display_init(void)
-{
-    // NOTE: display_width, display_height, bytes_per_pixel are auto-assigned above by generator
-    // Mouth display currently disabled - 480x320 RGB666 (460KB) exceeds available RAM
-    
-    ESP_LOGW("goblin_mouth_display", "Mouth display disabled (would need %d bytes for %dx%d)",
-             display_width * display_height * bytes_per_pixel, display_width, display_height);
-    
+// Stub implementations for missing neck_motor_3dof functions
+// TODO: These should come from hardware/motors/neck_motor_3dof component
+esp_err_t neck_motor_3dof_init(void) {
+    ESP_LOGW("neck_motor_3dof", "Stub init - no hardware");
     return ESP_OK;
 }
 
-void goblin_mouth_display_act(void)
-{
-    // NOTE: display_width, display_height, bytes_per_pixel are auto-assigned above by generator
-    // Currently disabled - implement chunked rendering when ready
+void neck_motor_3dof_act(void) {
+    // No-op
 }
-// --- End: config\bots\bot_families\goblins\head\goblin_mouth_display.src ---
 
-// --- Begin: config\components\templates\goblin_mouth_mood_display.src ---
-// goblin_mouth_mood_display stub - rendering logic placeholder
-#include "esp_log.h"
+esp_err_t neck_set_pan(int32_t position, uint32_t speed) {
+    ESP_LOGD("neck_motor_3dof", "Stub pan: %ld @ %lu", position, speed);
+    return ESP_OK;
+}
 
-esp_err_t goblin_mouth_mood_display_init(void) {
-    ESP_LOGI("goblin_mouth_mood_display", "Init (stub)");
+esp_err_t neck_set_tilt(int32_t position, uint32_t speed) {
+    ESP_LOGD("neck_motor_3dof", "Stub tilt: %ld @ %lu", position, speed);
     return ESP_OK;
 }
 
-void goblin_mouth_mood_display_act(void) {
-    // TODO: Implement mouth rendering with mood effects
+esp_err_t neck_set_roll(int32_t position, uint32_t speed) {
+    ESP_LOGD("neck_motor_3dof", "Stub roll: %ld @ %lu", position, speed);
+    return ESP_OK;
 }
-// --- End: config\components\templates\goblin_mouth_mood_display.src ---
 
-// --- Begin: config\bots\bot_families\goblins\head\goblin_right_eye.src ---
-// goblin_right_eye.src - Right eye uses same buffer as left (shared processing)
-// Component chain: goblin_right_eye -> goblin_eye (shared) -> generic_spi_display
-// Note: display_width, display_height, bytes_per_pixel auto-assigned by use_fields
+#define NECK_TRAJECTORY_HZ      100     // Setpoint rate, paced by esp_timer
+#define NECK_PERIOD_US          (1000000 / NECK_TRAJECTORY_HZ)
+#define NECK_MAX_CATCHUP        4       // Ticks run per act() at most
+#define NECK_STEPS_PER_DEGREE   106.67f
+#define NECK_DEFAULT_MOVE_S     0.3f
 
-#include "esp_log.h"
+// Pan, tilt, roll: synchronized minimum-jerk setpoints in degrees
+static MinJerkTrajectory<3> neck_trajectory;
 
-// Eye position (right eye relative to skull center)
-struct RightEyePosition {
-    int16_t x;      // +50 = right of center
-    int16_t y;      // +30 = above center
-    int16_t z;      // -35 = slightly back
-} right_eye_position = {50, 30, -35};
+// Gesture keyframes played by act() instead of blocking the loop
+typedef struct {
+    float pan;
+    float tilt;
+    float roll;
+    float duration_s;
+} neck_keyframe_t;
+
+static const neck_keyframe_t neck_nod_frames[] = {
+    {0.0f, 15.0f, 0.0f, 0.5f},
+    {0.0f, -10.0f, 0.0f, 0.5f},
+    {0.0f, 0.0f, 0.0f, 0.4f},
+};
 
-esp_err_t goblin_right_eye_init(void)
+static const neck_keyframe_t neck_shake_frames[] = {
+    {-30.0f, 0.0f, 0.0f, 0.3f},
+    {30.0f, 0.0f, 0.0f, 0.3f},
+    {0.0f, 0.0f, 0.0f, 0.3f},
+};
+
+static const neck_keyframe_t* neck_gesture = NULL;
+static uint8_t neck_gesture_len = 0;
+static uint8_t neck_gesture_next = 0;
+static uint64_t neck_next_tick_us = 0;
+
+static esp_err_t goblin_head_neck_motor_move(float pan_degrees, float tilt_degrees, float roll_degrees, float duration_s);
+
+static void goblin_head_neck_motor_play(const neck_keyframe_t* frames, uint8_t count)
 {
-    // NOTE: display_width, display_height, bytes_per_pixel are auto-assigned above by generator
-    // Right eye shares the buffer allocated by goblin_left_eye (both 240x240 RGB565)
+    neck_gesture = frames;
+    neck_gesture_len = count;
+    neck_gesture_next = 1;
+    goblin_head_neck_motor_move(frames[0].pan, frames[0].tilt, frames[0].roll, frames[0].duration_s);
+}
+
+// Initialize the goblin head neck motor controller
+esp_err_t goblin_head_neck_motor_init(void)
+{
+    ESP_LOGI("goblin_head_neck_motor", "Initializing goblin head neck motor controller");
     
-    ESP_LOGI("goblin_right_eye", "Right eye configured (shares buffer, %dx%d)",
-             display_width, display_height);
+    // Initialize the underlying hardware
+    esp_err_t ret = neck_motor_3dof_init();
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE("goblin_head_neck_motor", "Failed to initialize neck motor 3DOF hardware: %s", esp_err_to_name(ret));
+        return ret;
+    }
     
+    // Limits in deg/s and deg/s^2; the slowest axis paces the others
+    neck_trajectory.configure(NECK_TRAJECTORY_HZ);
+    neck_trajectory.setLimits(0, 240.0f, 1500.0f);
+    neck_trajectory.setLimits(1, 180.0f, 1200.0f);
+    neck_trajectory.setLimits(2, 120.0f, 900.0f);
+    neck_next_tick_us = esp_timer_get_time();
+    
+    // Center the neck to neutral position
+    ret = goblin_head_neck_motor_center();
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE("goblin_head_neck_motor", "Failed to center neck to neutral position: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    
+    ESP_LOGI("goblin_head_neck_motor", "Goblin head neck motor controller initialized successfully");
     return ESP_OK;
 }
 
-void goblin_right_eye_act(void)
+// One trajectory tick; true if the setpoint moved
+static bool goblin_head_neck_motor_tick(void)
 {
-    // NOTE: display_width, display_height, bytes_per_pixel are auto-assigned above by generator
-    // Buffer processing handled by shared goblin_eye component
-}
-// --- End: config\bots\bot_families\goblins\head\goblin_right_eye.src ---
+    if (neck_trajectory.isActive())
+    {
+        neck_trajectory.tick();
+        return true;
+    }
+    if (neck_gesture != NULL)
+    {
+        // Previous keyframe reached; queue the next or end the gesture
+        if (neck_gesture_next < neck_gesture_len)
+        {
+            const neck_keyframe_t* kf = &neck_gesture[neck_gesture_next++];
+            goblin_head_neck_motor_move(kf->pan, kf->tilt, kf->roll, kf->duration_s);
+        }
+        else
+        {
+            neck_gesture = NULL;
+        }
+    }
+    return false;
+}
+
+// Main activity loop for neck motor
+void goblin_head_neck_motor_act(void)
+{
+    uint64_t now_us = esp_timer_get_time();
+    
+    // Fixed rate; bounded catch-up, then skip ahead instead of bursting
+    bool moved = false;
+    int ticks = 0;
+    while ((int64_t)(now_us - neck_next_tick_us) >= 0 && ticks < NECK_MAX_CATCHUP)
+    {
+        moved |= goblin_head_neck_motor_tick();
+        neck_next_tick_us += NECK_PERIOD_US;
+        ticks++;
+    }
+    if ((int64_t)(now_us - neck_next_tick_us) >= 0)
+    {
+        neck_next_tick_us = now_us + NECK_PERIOD_US;
+    }
+    
+    if (moved)
+    {
+        // Stream the latest setpoint; speed is the setpoint velocity so the
+        // steppers cover the gap in about one tick
+        for (uint8_t axis = 0; axis < 3; axis++)
+        {
+            int32_t steps = (int32_t)lroundf(neck_trajectory.position(axis) * NECK_STEPS_PER_DEGREE);
+            uint32_t speed = (uint32_t)(fabsf(neck_trajectory.velocity(axis)) * NECK_STEPS_PER_DEGREE) + 1;
+            esp_err_t err = axis == 0 ? neck_set_pan(steps, speed)
+                          : axis == 1 ? neck_set_tilt(steps, speed)
+                          : neck_set_roll(steps, speed);
+            if (err != ESP_OK)
+            {
+                ESP_LOGW("goblin_head_neck_motor", "Axis %u setpoint rejected: %s", axis, esp_err_to_name(err));
+            }
+        }
+    }
+    
+    // Delegate to hardware layer
+    neck_motor_3dof_act();
+}
+
+// Set specific pose in degrees
+esp_err_t goblin_head_neck_motor_set_pose(float pan_degrees, float tilt_degrees, float roll_degrees)
+{
+    // Validate ranges for goblin-specific limits
+    if (pan_degrees < -60.0f || pan_degrees > 60.0f)
+    {
+        ESP_LOGW("goblin_head_neck_motor", "Pan angle %.1f out of range [-60, 60], clamping", pan_degrees);
+        pan_degrees = (pan_degrees < -60.0f) ? -60.0f : 60.0f;
+    }
+    
+    if (tilt_degrees < -30.0f || tilt_degrees > 45.0f)
+    {
+        ESP_LOGW("goblin_head_neck_motor", "Tilt angle %.1f out of range [-30, 45], clamping", tilt_degrees);
+        tilt_degrees = (tilt_degrees < -30.0f) ? -30.0f : 45.0f;
+    }
+    
+    if (roll_degrees < -15.0f || roll_degrees > 15.0f)
+    {
+        ESP_LOGW("goblin_head_neck_motor", "Roll angle %.1f out of range [-15, 15], clamping", roll_degrees);
+        roll_degrees = (roll_degrees < -15.0f) ? -15.0f : 15.0f;
+    }
+    
+    // A direct pose request cancels any gesture in progress
+    neck_gesture = NULL;
+    return goblin_head_neck_motor_move(pan_degrees, tilt_degrees, roll_degrees, NECK_DEFAULT_MOVE_S);
+}
+
+// Retarget the trajectory; blends from the present motion, all axes arrive together
+static esp_err_t goblin_head_neck_motor_move(float pan_degrees, float tilt_degrees, float roll_degrees, float duration_s)
+{
+    float target[3] = {pan_degrees, tilt_degrees, roll_degrees};
+    float planned_s = neck_trajectory.moveTo(target, duration_s);
+    
+    ESP_LOGD("goblin_head_neck_motor", "Pose %.1f/%.1f/%.1f in %lu ms", pan_degrees, tilt_degrees, roll_degrees,
+             (unsigned long)(planned_s * 1000.0f));
+    return ESP_OK;
+}
+
+// Present setpoint; what the motors are being driven to this tick
+void goblin_head_neck_motor_get_pose(float* pan_degrees, float* tilt_degrees, float* roll_degrees)
+{
+    if (pan_degrees) *pan_degrees = neck_trajectory.position(0);
+    if (tilt_degrees) *tilt_degrees = neck_trajectory.position(1);
+    if (roll_degrees) *roll_degrees = neck_trajectory.position(2);
+}
+
+// Center neck to neutral position
+esp_err_t goblin_head_neck_motor_center(void)
+{
+    ESP_LOGI("goblin_head_neck_motor", "Centering neck to neutral position");
+    return goblin_head_neck_motor_set_pose(0.0f, 0.0f, 0.0f);
+}
+
+// Perform a nodding motion
+esp_err_t goblin_head_neck_motor_nod(void)
+{
+    ESP_LOGI("goblin_head_neck_motor", "Performing nod gesture");
+    
+    goblin_head_neck_motor_play(neck_nod_frames, sizeof(neck_nod_frames) / sizeof(neck_nod_frames[0]));
+    return ESP_OK;
+}
+
+// Perform a head shake motion
+esp_err_t goblin_head_neck_motor_shake(void)
+{
+    ESP_LOGI("goblin_head_neck_motor", "Performing shake gesture");
+    
+    goblin_head_neck_motor_play(neck_shake_frames, sizeof(neck_shake_frames) / sizeof(neck_shake_frames[0]));
+    return ESP_OK;
+}
+// --- End: config/components/creature_specific/goblin_head_neck_motor.src ---
+
+// --- Begin: config/bots/bot_families/goblins/head/goblin_jaw.src ---
+#include <esp_err.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "driver/ledc.h"
+// Removed: #include "components/drivers/i2s_driver.hdr" - .hdr content aggregated into .hpp
+#include "config/components/templates/LipSyncAnalyzer.hpp"
+
+/**
+ * @file goblin_jaw.src
+ * @brief Jaw servo driven by the speaker's lip-sync stage
+ *
+ * The i2s_driver block path analyses every 10 ms of audio and schedules a
+ * jaw cue JAW_LATENCY_MS ahead of the sound. act() drains the cues that are
+ * due and moves the SG90 to the latest opening, so the jaw arrives as the
+ * matching audio leaves the speaker. Without cues the jaw closes.
+ */
+
+#define JAW_SERVO_GPIO 38
+#define JAW_LEDC_TIMER LEDC_TIMER_0
+#define JAW_LEDC_CHANNEL LEDC_CHANNEL_0
+#define JAW_PWM_FREQ_HZ 50
+#define JAW_PWM_PERIOD_US 20000
+#define JAW_DUTY_BITS 14
+#define JAW_PULSE_CLOSED_US 1000            // Jaw shut
+#define JAW_PULSE_US_PER_DEG 11.111f        // SG90: 0-180 deg = 500-2500 us
+#define JAW_HOLD_MS 120                     // Close after this long without a cue
+
+static bool jaw_initialized = false;
+static LipSyncAnalyzer* jaw_lip_sync = NULL;
+static uint32_t jaw_duty = 0;
+static uint32_t jaw_last_cue_ms = 0;
+static bool jaw_open = false;
+
+static uint32_t jaw_angle_to_duty(uint8_t jaw_deg) {
+    uint32_t pulse = (uint32_t)(JAW_PULSE_CLOSED_US + jaw_deg * JAW_PULSE_US_PER_DEG);
+    return (uint32_t)(((uint64_t)pulse << JAW_DUTY_BITS) / JAW_PWM_PERIOD_US);
+}
+
+static void jaw_write(uint8_t jaw_deg) {
+    uint32_t duty = jaw_angle_to_duty(jaw_deg);
+    if (duty == jaw_duty) {
+        return;     // Unchanged: skip the register write
+    }
+    jaw_duty = duty;
+    ledc_set_duty(LEDC_LOW_SPEED_MODE, JAW_LEDC_CHANNEL, duty);
+    ledc_update_duty(LEDC_LOW_SPEED_MODE, JAW_LEDC_CHANNEL);
+}
+
+/**
+ * @brief Initialize goblin_jaw
+ * Sets up the jaw servo PWM and attaches to the speaker's lip-sync stage
+ */
+esp_err_t goblin_jaw_init(void)
+{
+    if (jaw_initialized) {
+        return ESP_OK;
+    }
+
+    ledc_timer_config_t timer_conf = {};
+    timer_conf.speed_mode = LEDC_LOW_SPEED_MODE;
+    timer_conf.duty_resolution = (ledc_timer_bit_t)JAW_DUTY_BITS;
+    timer_conf.timer_num = JAW_LEDC_TIMER;
+    timer_conf.freq_hz = JAW_PWM_FREQ_HZ;
+    timer_conf.clk_cfg = LEDC_AUTO_CLK;
+    esp_err_t ret = ledc_timer_config(&timer_conf);
+    if (ret != ESP_OK) {
+        ESP_LOGE("goblin_jaw", "LEDC timer init failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    jaw_duty = jaw_angle_to_duty(0);
+    ledc_channel_config_t chan_conf = {};
+    chan_conf.gpio_num = JAW_SERVO_GPIO;
+    chan_conf.speed_mode = LEDC_LOW_SPEED_MODE;
+    chan_conf.channel = JAW_LEDC_CHANNEL;
+    chan_conf.timer_sel = JAW_LEDC_TIMER;
+    chan_conf.duty = jaw_duty;
+    chan_conf.hpoint = 0;
+    ret = ledc_channel_config(&chan_conf);
+    if (ret != ESP_OK) {
+        ESP_LOGE("goblin_jaw", "LEDC channel init failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    jaw_lip_sync = i2s_driver_get_lip_sync();
+    jaw_initialized = true;
+    ESP_LOGI("goblin_jaw", "Jaw servo on GPIO %d following speaker lip-sync", JAW_SERVO_GPIO);
+    return ESP_OK;
+}
+
+/**
+ * @brief Execute goblin_jaw action
+ * Drains due lip-sync cues every loop (cues are 10 ms apart)
+ */
+void goblin_jaw_act(void)
+{
+    if (!jaw_initialized) {
+        return;
+    }
+
+    uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    LipSyncAnalyzer::MouthCue cue;
+    bool got_cue = false;
+    while (jaw_lip_sync->popDueCue(now_ms, cue)) {
+        got_cue = true;     // Keep the latest; older ones are already late
+    }
+
+    if (got_cue) {
+        jaw_write(cue.jaw_open);
+        jaw_last_cue_ms = now_ms;
+        jaw_open = true;
+    } else if (jaw_open && (now_ms - jaw_last_cue_ms) > JAW_HOLD_MS) {
+        jaw_write(0);
+        jaw_open = false;
+    }
+}
+// --- End: config/bots/bot_families/goblins/head/goblin_jaw.src ---
+
+// --- Begin: config/bots/bot_families/goblins/head/goblin_left_eye.src ---
+// goblin_left_eye.src - Allocate display buffer for left eye
+// Component chain: goblin_left_eye (allocate) -> goblin_eye (render) -> generic_spi_display (send)
+// Note: display_width, display_height, bytes_per_pixel auto-assigned by use_fields in init() and act()
+
+#include <stdio.h>
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "config/components/templates/EyeAnimLibrary.hpp"
+
+// Compressed animation library (tools/eye_anim_encode.py), ~120 KB in PSRAM
+// instead of 29 raw frames (3.3 MB). Frames decode band by band into one
+// untinted source frame that goblin_eye tints and caches
+#define EYE_ANIM_LIBRARY_PATH "/spiffs/eyes/goblin_eye.p32e"
+#define EYE_ANIM_BLINK 0
+
+static EyeAnimLibrary eye_library;
+static uint8_t* eye_library_data = NULL;
+static uint16_t* eye_source_frame = NULL;
+static uint8_t eye_animation = EYE_ANIM_BLINK;
+static uint16_t eye_animation_frame = 0;
+static uint32_t eye_animation_loops = 0;
+static uint64_t eye_decode_us = 0;
+static uint32_t eye_decodes = 0;
+
+// Eye position (left eye relative to skull center)
+struct LeftEyePosition {
+    int16_t x;      // -50 = left of center
+    int16_t y;      // +30 = above center
+    int16_t z;      // -35 = slightly back
+} left_eye_position = {-50, 30, -35};
+
+/**
+ * Load the eye library from SPIFFS into PSRAM. Without one the eye keeps
+ * the neutral fill
+ */
+static bool load_eye_library(void)
+{
+    // The head's first init: mount /spiffs here, the speaker reuses the mount
+    if (spiffs_storage_mount() != ESP_OK)
+    {
+        ESP_LOGW("goblin_left_eye", "No /spiffs, showing the neutral fill");
+        return false;
+    }
+    FILE* file = fopen(EYE_ANIM_LIBRARY_PATH, "rb");
+    if (!file)
+    {
+        ESP_LOGW("goblin_left_eye", "No eye library at %s, showing the neutral fill", EYE_ANIM_LIBRARY_PATH);
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    eye_library_data = size > 0 ? (uint8_t*)heap_caps_malloc(size, MALLOC_CAP_SPIRAM) : NULL;
+    eye_source_frame = (uint16_t*)heap_caps_malloc(display_size, MALLOC_CAP_SPIRAM);
+    bool ok = eye_library_data && eye_source_frame && fread(eye_library_data, 1, size, file) == (size_t)size;
+    fclose(file);
+
+    EyeAnimLibrary::Result result = ok ? eye_library.open(eye_library_data, size) : EyeAnimLibrary::ERR_SIZE;
+    if (result == EyeAnimLibrary::OK &&
+        (eye_library.width() != display_width || eye_library.height() != display_height ||
+         eye_library.animationCount() == 0))
+    {
+        result = EyeAnimLibrary::ERR_FORMAT;
+    }
+    if (result != EyeAnimLibrary::OK)
+    {
+        ESP_LOGE("goblin_left_eye", "Eye library %s unusable (error %d)", EYE_ANIM_LIBRARY_PATH, result);
+        eye_library.close();
+        free(eye_library_data);
+        free(eye_source_frame);
+        eye_library_data = NULL;
+        eye_source_frame = NULL;
+        return false;
+    }
+
+    ESP_LOGI("goblin_left_eye", "Eye library: %d animations, %d frames, %ld bytes (%lu raw), %d-row bands",
+             eye_library.animationCount(), eye_library.frameCount(), size,
+             (unsigned long)eye_library.frameCount() * display_size, eye_library.bandRows());
+    return true;
+}
+
+/**
+ * Decode the current animation frame and hand it to goblin_eye
+ */
+static void show_eye_frame(void)
+{
+    EyeAnimLibrary::Animation anim = eye_library.animation(eye_animation);
+    uint16_t frame = (uint16_t)(anim.first_frame + eye_animation_frame);
+
+    uint64_t start_us = esp_timer_get_time();
+    EyeAnimLibrary::Result result = eye_library.decodeFrame(frame, eye_source_frame);
+    eye_decode_us += esp_timer_get_time() - start_us;
+    eye_decodes++;
+    if (result != EyeAnimLibrary::OK)
+    {
+        ESP_LOGE("goblin_left_eye", "Frame %d failed to decode (error %d)", frame, result);
+        return;
+    }
+    goblin_eye_show_frame((const uint8_t*)eye_source_frame, frame);
+
+    if (eye_decodes % 100 == 0)
+    {
+        ESP_LOGI("goblin_left_eye", "Average decode %llu us per frame", eye_decode_us / eye_decodes);
+    }
+}
+
+esp_err_t goblin_left_eye_init(void)
+{
+    display_width = 240;
+    display_height = 240;
+    bytes_per_pixel = 2;
+    color_schema = "RGB565";
+
+    // NOTE: display_width, display_height, bytes_per_pixel are auto-assigned above by generator
+    
+    // Calculate buffer size based on display parameters
+    display_size = display_width * display_height * bytes_per_pixel;
+    
+    ESP_LOGI("goblin_left_eye", "Allocating display buffer for left eye (%u bytes, %dx%d)", 
+             display_size, display_width, display_height);
+    
+    // Allocate front buffer (DMA-capable internal RAM)
+    front_buffer = (uint8_t*)heap_caps_malloc(display_size, MALLOC_CAP_DMA);
+    if (!front_buffer)
+    {
+        ESP_LOGE("goblin_left_eye", "Failed to allocate %u bytes for front buffer", display_size);
+        return ESP_ERR_NO_MEM;
+    }
+    
+    // Allocate back buffer (DMA-capable internal RAM)
+    back_buffer = (uint8_t*)heap_caps_malloc(display_size, MALLOC_CAP_DMA);
+    if (!back_buffer)
+    {
+        ESP_LOGE("goblin_left_eye", "Failed to allocate %u bytes for back buffer", display_size);
+        free(front_buffer);
+        front_buffer = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    
+    // Initialize both buffers with neutral color (dark green iris)
+    uint16_t neutral = 0x0400;  // RGB565: (0, 8, 0)
+    uint16_t* front_u16 = (uint16_t*)front_buffer;
+    uint16_t* back_u16 = (uint16_t*)back_buffer;
+    
+    uint32_t pixel_count = display_size / bytes_per_pixel;
+    for (uint32_t i = 0; i < pixel_count; i++)
+    {
+        front_u16[i] = neutral;
+        back_u16[i] = neutral;
+    }
+    
+    ESP_LOGI("goblin_left_eye", "Display buffers allocated (position: %d,%d,%d mm)",
+             left_eye_position.x, left_eye_position.y, left_eye_position.z);
+    
+    if (load_eye_library())
+    {
+        show_eye_frame();
+    }
+    
+    return ESP_OK;
+}
+
+void goblin_left_eye_act(void)
+{
+    display_width = 240;
+    display_height = 240;
+    bytes_per_pixel = 2;
+    color_schema = "RGB565";
+
+    // NOTE: display_width, display_height, bytes_per_pixel are auto-assigned above by generator
+    
+    // Buffer management handled by component chain:
+    // - goblin_eye.src will render mood effects into front_buffer
+    // - generic_spi_display.src will send to hardware or debug server
+    if (!eye_library.isOpen())
+    {
+        return;
+    }
+
+    // Advance the animation every delay_loops dispatch passes
+    EyeAnimLibrary::Animation anim = eye_library.animation(eye_animation);
+    if (++eye_animation_loops < anim.delay_loops)
+    {
+        return;
+    }
+    eye_animation_loops = 0;
+    eye_animation_frame = (uint16_t)((eye_animation_frame + 1) % anim.frame_count);
+    show_eye_frame();
+}
+// --- End: config/bots/bot_families/goblins/head/goblin_left_eye.src ---
+
+// --- Begin: config/bots/bot_families/goblins/head/goblin_mood.src ---
+// goblin_mood component implementation
+// Owns the Mood: everything else posts stimuli, this publishes settled changes only
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "config/components/templates/MoodDynamics.hpp"
+// Removed: #include "shared/Mood.hpp" - auto-included by generator
+// Removed: #include "shared/Personality.hpp" - auto-included by generator
+// Removed: #include "shared/SensorFusion.hpp" - auto-included by generator
+
+#define MOOD_PERIOD_MS 50                  // 20 Hz, same as goblin_sensor_fusion
+#define MOOD_QUANT_SHIFT 2                 // Published levels in steps of 4
+#define MOOD_BAND 8                        // Minimum published change
+#define MOOD_STARTLE_CM_S 80               // Approach faster than this...
+#define MOOD_STARTLE_NEAR_CM 60            // ...and closer than this is a startle
+#define MOOD_PRESENT 128                   // SensorFusion presence: someone is there
+#define MOOD_ABSENT 32
+
+typedef MoodDynamics<Mood::componentCount> goblin_mood_t;
+
+static goblin_mood_t mood_dynamics;
+
+// Relaxation time per Mood::Component, mirrored in goblin_mood.json
+static const uint16_t mood_tau_ms[Mood::componentCount] = {
+    4000,   // ANGER
+    2500,   // FEAR
+    6000,   // HAPPINESS
+    10000,  // SADNESS
+    3000,   // CURIOSITY
+    8000,   // AFFECTION
+    5000,   // IRRITATION
+    15000,  // CONTENTMENT
+    1500    // EXCITEMENT
+};
+
+static Personality mood_personality;
+static uint32_t mood_next_tick_ms = 0;
+static uint32_t mood_last_fusion_ms = 0;
+static bool mood_was_touched = false;
+static bool mood_was_startled = false;
+static bool mood_was_present = false;
+static uint64_t mood_time_us = 0;
+
+// Personality traits (0-127) set where each component rests and how hard
+// stimuli push it: gain 0.75x at trait 0 up to 1.25x at 127
+static void apply_personality(const Personality& p) {
+    mood_dynamics.setBaseline(Mood::ANGER, p.base_aggression / 8);
+    mood_dynamics.setBaseline(Mood::CURIOSITY, p.base_curiosity / 8);
+    mood_dynamics.setBaseline(Mood::FEAR, p.base_fear / 8);
+    mood_dynamics.setBaseline(Mood::AFFECTION, p.base_affection / 8);
+
+    mood_dynamics.setGain(Mood::ANGER, 192 + p.base_aggression);
+    mood_dynamics.setGain(Mood::IRRITATION, 192 + p.base_aggression);
+    mood_dynamics.setGain(Mood::CURIOSITY, 192 + p.base_curiosity);
+    mood_dynamics.setGain(Mood::EXCITEMENT, 192 + p.base_curiosity);
+    mood_dynamics.setGain(Mood::FEAR, 192 + p.base_fear);
+    mood_dynamics.setGain(Mood::AFFECTION, 192 + p.base_affection);
+    mood_dynamics.setGain(Mood::HAPPINESS, 192 + p.base_affection);
+
+    ESP_LOGI("goblin_mood", "Personality applied: aggression=%d, curiosity=%d, fear=%d, affection=%d",
+             p.base_aggression, p.base_curiosity, p.base_fear, p.base_affection);
+}
+
+// SensorFusion -> stimuli. Levels become drives; edges become impulses
+static void apply_fusion(const SensorFusion& fused) {
+    mood_dynamics.drive(Mood::CURIOSITY, (int8_t)(fused.attention / 3));
+    mood_dynamics.drive(Mood::EXCITEMENT, (int8_t)(fused.presence / 4));
+
+    bool startled = fused.approach_cm_s > MOOD_STARTLE_CM_S && fused.proximity_cm < MOOD_STARTLE_NEAR_CM;
+    if (startled && !mood_was_startled) {
+        int16_t fright = fused.approach_cm_s / 4;
+        mood_dynamics.stimulate(Mood::FEAR, fright > 40 ? 40 : fright);
+        mood_dynamics.stimulate(Mood::IRRITATION, 10);
+    }
+    mood_was_startled = startled;
+
+    if (fused.fused_touch_detected && !mood_was_touched) {
+        mood_dynamics.stimulate(Mood::AFFECTION, 40);
+        mood_dynamics.stimulate(Mood::HAPPINESS, 24);
+    }
+    mood_was_touched = fused.fused_touch_detected;
+
+    if (fused.presence >= MOOD_PRESENT) {
+        mood_was_present = true;
+    } else if (mood_was_present && fused.presence < MOOD_ABSENT) {
+        mood_dynamics.stimulate(Mood::SADNESS, 16);   // Left alone
+        mood_was_present = false;
+    }
+}
+
+esp_err_t goblin_mood_init(void) {
+    ESP_LOGI("goblin_mood", "Initializing mood dynamics");
+
+    mood_dynamics.configure(1000 / MOOD_PERIOD_MS, MOOD_QUANT_SHIFT, MOOD_BAND);
+    for (int c = 0; c < Mood::componentCount; c++) {
+        mood_dynamics.setDecay(c, mood_tau_ms[c]);
+    }
+
+    Personality* pers = GSM.read<Personality>();
+    if (pers) {
+        mood_personality = *pers;
+    }
+    apply_personality(mood_personality);
+
+    mood_next_tick_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    mood_was_touched = false;
+    mood_was_startled = false;
+    mood_was_present = false;
+
+    Mood* mood = GSM.read<Mood>();
+    mood->clear();
+    GSM.write<Mood>();
+
+    ESP_LOGI("goblin_mood", "Mood ready: %d ms period, quantum %d, band %d",
+             MOOD_PERIOD_MS, 1 << MOOD_QUANT_SHIFT, MOOD_BAND);
+    return ESP_OK;
+}
+
+void goblin_mood_stimulus(uint8_t component, int16_t amount) {
+    mood_dynamics.stimulate(component, amount);
+}
+
+void goblin_mood_act(void) {
+    uint64_t start_us = esp_timer_get_time();
+    uint32_t now_ms = (uint32_t)(start_us / 1000);
+    if ((int32_t)(now_ms - mood_next_tick_ms) < 0) {
+        return;
+    }
+    // Fixed rate; after a long stall skip ahead instead of bursting
+    mood_next_tick_ms += MOOD_PERIOD_MS;
+    if ((int32_t)(now_ms - mood_next_tick_ms) > 0) {
+        mood_next_tick_ms = now_ms + MOOD_PERIOD_MS;
+    }
+
+    Personality* pers = GSM.read<Personality>();
+    if (pers && *pers != mood_personality) {
+        mood_personality = *pers;
+        apply_personality(mood_personality);
+    }
+
+    SensorFusion* fused = GSM.read<SensorFusion>();
+    if (fused && fused->fusion_valid && fused->last_fusion_time != mood_last_fusion_ms) {
+        mood_last_fusion_ms = fused->last_fusion_time;
+        apply_fusion(*fused);
+    }
+
+    bool publish = mood_dynamics.tick();
+    mood_time_us += esp_timer_get_time() - start_us;
+
+    if (publish) {
+        Mood* mood = GSM.read<Mood>();
+        for (int c = 0; c < Mood::componentCount; c++) {
+            mood->components[c] = mood_dynamics.value(c);
+        }
+        GSM.write<Mood>();
+
+        ESP_LOGD("goblin_mood", "Mood published: anger=%d fear=%d happy=%d curious=%d excited=%d",
+                 mood->anger(), mood->fear(), mood->happiness(), mood->curiosity(), mood->excitement());
+    }
+
+    if (mood_dynamics.ticks() % 200 == 0) {  // Every ~10 s
+        ESP_LOGI("goblin_mood", "Average cost %llu us per tick; %lu publications in %lu ticks",
+                 mood_time_us / mood_dynamics.ticks(),
+                 (unsigned long)mood_dynamics.publications(), (unsigned long)mood_dynamics.ticks());
+    }
+}
+// --- End: config/bots/bot_families/goblins/head/goblin_mood.src ---
+
+// --- Begin: config/bots/bot_families/goblins/head/goblin_mouth_display.src ---
+// goblin_mouth_display.src - Mouth display (currently disabled - not enough RAM)
+// Note: display_width, display_height, bytes_per_pixel auto-assigned by use_fields
+
+#include "esp_log.h"
+
+// Mouth position (relative to skull center)
+struct MouthPosition {
+    int16_t x;      // 0 = center
+    int16_t y;      // -80 = below center
+    int16_t z;      // 0 = front of face
+} mouth_position = {0, -80, 0};
+
+esp_err_t goblin_mouth_display_init(void)
+{
+    display_width = 480;
+    display_height = 320;
+    bytes_per_pixel = 3;
+    color_schema = "RGB666";
+
+    // NOTE: display_width, display_height, bytes_per_pixel are auto-assigned above by generator
+    // Mouth display currently disabled - 480x320 RGB666 (460KB) exceeds available RAM
+    
+    ESP_LOGW("goblin_mouth_display", "Mouth display disabled (would need %d bytes for %dx%d)",
+             display_width * display_height * bytes_per_pixel, display_width, display_height);
+    
+    return ESP_OK;
+}
+
+void goblin_mouth_display_act(void)
+{
+    display_width = 480;
+    display_height = 320;
+    bytes_per_pixel = 3;
+    color_schema = "RGB666";
+
+    // NOTE: display_width, display_height, bytes_per_pixel are auto-assigned above by generator
+    // Currently disabled - implement chunked rendering when ready
+}
+// --- End: config/bots/bot_families/goblins/head/goblin_mouth_display.src ---
+
+// --- Begin: config/components/templates/goblin_mouth_mood_display.src ---
+// goblin_mouth_mood_display stub - rendering logic placeholder
+#include "esp_log.h"
+
+esp_err_t goblin_mouth_mood_display_init(void) {
+    ESP_LOGI("goblin_mouth_mood_display", "Init (stub)");
+    return ESP_OK;
+}
+
+void goblin_mouth_mood_display_act(void) {
+    // TODO: Implement mouth rendering with mood effects
+}
+// --- End: config/components/templates/goblin_mouth_mood_display.src ---
+
+// --- Begin: config/bots/bot_families/goblins/head/goblin_nose.src ---
+// goblin_nose component implementation
+// Integrates HC-SR04 ultrasonic sensor for proximity detection with audio responses
+
+#include "esp_log.h"
+// Removed: #include "components/hardware/hc_sr04.hdr" - .hdr content aggregated into .hpp
+// Removed: #include "components/hardware/speaker.hdr" - .hdr content aggregated into .hpp
+// Removed: #include "components/drivers/gpio_pair_driver.hdr" - .hdr content aggregated into .hpp
+// Removed: #include "shared/Mood.hpp" - auto-included by generator
+
+// Nose sensor state
+typedef struct {
+    float last_distance_cm;       // Last valid distance reading
+    uint32_t reading_count;       // Total readings taken
+    uint32_t valid_readings;      // Number of valid readings
+    bool proximity_alert;         // True when object is very close
+    uint64_t last_echo_us;        // Echo already handed to sensor fusion
+} goblin_nose_state_t;
+
+static goblin_nose_state_t nose_state = {
+    .last_distance_cm = -1.0f,
+    .reading_count = 0,
+    .valid_readings = 0,
+    .proximity_alert = false,
+    .last_echo_us = 0
+};
+
+// Proximity thresholds
+#define PROXIMITY_ALERT_CM 10.0f    // Alert if object closer than 10cm
+#define CLOSE_DISTANCE_CM 20.0f     // Close distance threshold
+#define FAR_DISTANCE_CM 100.0f      // Far distance threshold
+
+/**
+ * @brief Initialize goblin nose with HC-SR04 sensor
+ */
+esp_err_t goblin_nose_init(void) {
+    ESP_LOGI("goblin_nose", "Initializing goblin nose with HC-SR04 sensor");
+    
+    // Initialize the underlying HC-SR04 hardware
+    esp_err_t ret = hc_sr04_init();
+    if (ret != ESP_OK) {
+        ESP_LOGE("goblin_nose", "Failed to initialize HC-SR04 sensor: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    
+    ESP_LOGI("goblin_nose", "Goblin nose ready - proximity sensing enabled");
+    return ESP_OK;
+}
+
+/**
+ * @brief Process nose sensor readings and update state
+ */
+void goblin_nose_act(void) {
+    // Update the HC-SR04 hardware readings
+    hc_sr04_act();
+    
+    nose_state.reading_count++;
+    
+    // Get current distance reading
+    float distance_cm = hc_sr04_get_distance_cm();
+    bool is_valid = hc_sr04_is_valid_reading();
+    
+    if (is_valid) {
+        nose_state.valid_readings++;
+        nose_state.last_distance_cm = distance_cm;
+        
+        // One fusion sample per echo, stamped with the echo time
+        uint64_t echo_us = gpio_pair_get_echo_time_us();
+        if (echo_us != nose_state.last_echo_us) {
+            nose_state.last_echo_us = echo_us;
+            goblin_sensor_fusion_post(GOBLIN_FUSION_ULTRASONIC, (uint32_t)(echo_us / 1000),
+                                      (int16_t)distance_cm, (int16_t)hc_sr04_get_velocity_cm_s(),
+                                      hc_sr04_get_confidence());
+        }
+        
+        // Update proximity alert status
+        bool was_alert = nose_state.proximity_alert;
+        nose_state.proximity_alert = (distance_cm <= PROXIMITY_ALERT_CM);
+        
+        // Log interesting events and trigger audio responses
+        if (nose_state.proximity_alert && !was_alert) {
+            ESP_LOGW("goblin_nose", "PROXIMITY ALERT! Object detected at %.1f cm", distance_cm);
+            
+            // Trigger proximity-based goblin response; the mood follows what it says
+            if (distance_cm <= 5.0f) {
+                // Very close - aggressive response
+                speaker_play_emotional_response("angry", 0.8f);
+                speaker_speak_goblin_phrase("warning");
+                goblin_mood_stimulus(Mood::ANGER, 32);
+                goblin_mood_stimulus(Mood::IRRITATION, 24);
+            } else if (distance_cm <= 10.0f) {
+                // Close - curious/alert response
+                speaker_play_emotional_response("surprised", 0.6f);
+                speaker_speak_goblin_phrase("curious");
+                goblin_mood_stimulus(Mood::CURIOSITY, 32);
+                goblin_mood_stimulus(Mood::EXCITEMENT, 16);
+            }
+            
+        } else if (!nose_state.proximity_alert && was_alert) {
+            ESP_LOGI("goblin_nose", "Proximity alert cleared - object moved to %.1f cm", distance_cm);
+            
+            // Object moved away - relieved sound
+            speaker_play_sound_by_name("goblin_grunt_yes");
+            goblin_mood_stimulus(Mood::CONTENTMENT, 16);
+        }
+        
+        // Periodic distance reporting (every 50 readings)
+        if (nose_state.reading_count % 50 == 0) {
+            const char* distance_desc;
+            if (distance_cm <= PROXIMITY_ALERT_CM) {
+                distance_desc = "VERY CLOSE";
+            } else if (distance_cm <= CLOSE_DISTANCE_CM) {
+                distance_desc = "CLOSE";
+            } else if (distance_cm <= FAR_DISTANCE_CM) {
+                distance_desc = "MEDIUM";
+            } else {
+                distance_desc = "FAR";
+            }
+            
+            ESP_LOGI("goblin_nose", "Distance: %.1f cm (%s) - Success rate: %lu/%lu (%.1f%%)",
+                     distance_cm, distance_desc,
+                     nose_state.valid_readings, nose_state.reading_count,
+                     (float)nose_state.valid_readings * 100.0f / nose_state.reading_count);
+        }
+    } else {
+        ESP_LOGD("goblin_nose", "No valid sensor reading (out of range or obstacle)");
+    }
+}
+
+/**
+ * @brief Get the current nose sensor distance reading
+ * @return Distance in cm, or -1 if no valid reading
+ */
+float goblin_nose_get_distance(void) {
+    return nose_state.last_distance_cm;
+}
+
+/**
+ * @brief Check if there's a proximity alert (object very close)
+ * @return true if object is closer than proximity threshold
+ */
+bool goblin_nose_proximity_alert(void) {
+    return nose_state.proximity_alert;
+}
+
+/**
+ * @brief Get sensor statistics
+ * @param total_readings Output: total number of readings attempted
+ * @param valid_readings Output: number of successful readings
+ * @return Current success rate as percentage
+ */
+float goblin_nose_get_stats(uint32_t* total_readings, uint32_t* valid_readings) {
+    if (total_readings) *total_readings = nose_state.reading_count;
+    if (valid_readings) *valid_readings = nose_state.valid_readings;
+    
+    return (nose_state.reading_count > 0) ? 
+           (float)nose_state.valid_readings * 100.0f / nose_state.reading_count : 0.0f;
+}
+// --- End: config/bots/bot_families/goblins/head/goblin_nose.src ---
+
+// --- Begin: config/bots/bot_families/goblins/head/goblin_right_eye.src ---
+// goblin_right_eye.src - Right eye uses same buffer as left (shared processing)
+// Component chain: goblin_right_eye -> goblin_eye (shared) -> generic_spi_display
+// Note: display_width, display_height, bytes_per_pixel auto-assigned by use_fields
+
+#include "esp_log.h"
+
+// Eye position (right eye relative to skull center)
+struct RightEyePosition {
+    int16_t x;      // +50 = right of center
+    int16_t y;      // +30 = above center
+    int16_t z;      // -35 = slightly back
+} right_eye_position = {50, 30, -35};
+
+esp_err_t goblin_right_eye_init(void)
+{
+    display_width = 240;
+    display_height = 240;
+    bytes_per_pixel = 2;
+    color_schema = "RGB565";
+
+    // NOTE: display_width, display_height, bytes_per_pixel are auto-assigned above by generator
+    // Right eye shares the buffer allocated by goblin_left_eye (both 240x240 RGB565)
+    
+    ESP_LOGI("goblin_right_eye", "Right eye configured (shares buffer, %dx%d)",
+             display_width, display_height);
+    
+    return ESP_OK;
+}
+
+void goblin_right_eye_act(void)
+{
+    display_width = 240;
+    display_height = 240;
+    bytes_per_pixel = 2;
+    color_schema = "RGB565";
+
+    // NOTE: display_width, display_height, bytes_per_pixel are auto-assigned above by generator
+    // Buffer processing handled by shared goblin_eye component
+}
+// --- End: config/bots/bot_families/goblins/head/goblin_right_eye.src ---
+
+// --- Begin: config/bots/bot_families/goblins/head/goblin_sensor_fusion.src ---
+// goblin_sensor_fusion component implementation
+// Single consumer of the head's sensor samples; everything else reads SensorFusion
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "config/components/templates/SensorFusionEngine.hpp"
+// Removed: #include "shared/SensorFusion.hpp" - auto-included by generator
+
+#define SENSOR_FUSION_PERIOD_MS 50         // 20 Hz output
+#define SENSOR_FUSION_NEAR_CM 30
+#define SENSOR_FUSION_FAR_CM 150
+#define SENSOR_FUSION_LOUD_LEVEL 2000      // StereoEarLocalizer level for full sound evidence
+#define SENSOR_FUSION_APPROACH_CM_S 50
+
+typedef SensorFusionEngine<16> goblin_fusion_t;
+
+static goblin_fusion_t fusion_engine;
+static uint32_t fusion_next_tick_ms = 0;
+static uint32_t fusion_updates = 0;
+static uint64_t fusion_time_us = 0;
+
+esp_err_t goblin_sensor_fusion_init(void) {
+    ESP_LOGI("goblin_sensor_fusion", "Initializing sensor fusion");
+    
+    fusion_engine.configure(SENSOR_FUSION_NEAR_CM, SENSOR_FUSION_FAR_CM,
+                            SENSOR_FUSION_LOUD_LEVEL, SENSOR_FUSION_APPROACH_CM_S);
+    fusion_next_tick_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    
+    SensorFusion* fused = GSM.read<SensorFusion>();
+    fused->fusion_valid = false;
+    GSM.write<SensorFusion>();
+    
+    ESP_LOGI("goblin_sensor_fusion", "Fusion ready: %d ms period, %d-sample queue per source",
+             SENSOR_FUSION_PERIOD_MS, 16);
+    return ESP_OK;
+}
+
+bool goblin_sensor_fusion_post(uint8_t source, uint32_t t_ms, int16_t value, int16_t aux, uint8_t quality) {
+    goblin_fusion_t::Sample sample;
+    sample.t_ms = t_ms;
+    sample.value = value;
+    sample.aux = aux;
+    sample.quality = quality;
+    return fusion_engine.post((goblin_fusion_t::Source)source, sample);
+}
+
+void goblin_sensor_fusion_act(void) {
+    uint64_t start_us = esp_timer_get_time();
+    uint32_t now_ms = (uint32_t)(start_us / 1000);
+    if ((int32_t)(now_ms - fusion_next_tick_ms) < 0) {
+        return;
+    }
+    // Fixed rate; after a long stall skip ahead instead of bursting
+    fusion_next_tick_ms += SENSOR_FUSION_PERIOD_MS;
+    if ((int32_t)(now_ms - fusion_next_tick_ms) > 0) {
+        fusion_next_tick_ms = now_ms + SENSOR_FUSION_PERIOD_MS;
+    }
+    
+    const goblin_fusion_t::Output& out = fusion_engine.update(now_ms);
+    fusion_time_us += esp_timer_get_time() - start_us;
+    fusion_updates++;
+    
+    SensorFusion* fused = GSM.read<SensorFusion>();
+    fused->presence = out.presence;
+    fused->attention = out.attention;
+    fused->proximity_cm = out.proximity_cm;
+    fused->approach_cm_s = out.approach_cm_s;
+    fused->sound_azimuth_x10 = out.sound_azimuth_x10;
+    for (int s = 0; s < goblin_fusion_t::SRC_COUNT; s++) {
+        fused->source_confidence[s] = out.confidence[s];
+    }
+    fused->fused_distance_cm = out.proximity_cm > 254 ? 255 : (uint8_t)out.proximity_cm;
+    fused->fused_touch_detected = out.proximity_cm == 0;
+    fused->sensor_count = out.fresh_sources;
+    fused->last_fusion_time = now_ms;
+    fused->fusion_valid = out.valid;
+    GSM.write<SensorFusion>();
+    
+    if (fusion_updates % 200 == 0) {  // Every ~10 s
+        const goblin_fusion_t::Stats& stats = fusion_engine.getStats();
+        ESP_LOGI("goblin_sensor_fusion", "Average cost %llu us; %lu stale samples, %lu max per update",
+                 fusion_time_us / fusion_updates, (unsigned long)stats.stale, (unsigned long)stats.max_drained);
+    }
+}
+// --- End: config/bots/bot_families/goblins/head/goblin_sensor_fusion.src ---
+
+// --- Begin: config/bots/bot_families/goblins/head/goblin_speaker.src ---
+// goblin_speaker component implementation
+// Auto-generated stub - needs actual implementation
+
+#include "esp_log.h"
+esp_err_t goblin_speaker_init(void) {
+    ESP_LOGI("goblin_speaker", "goblin_speaker init - STUB IMPLEMENTATION");
+    // TODO: Add actual initialization code
+    return ESP_OK;
+}
+
+void goblin_speaker_act(void) {
+    // TODO: Add actual action code
+    // ESP_LOGD("goblin_speaker", "goblin_speaker act");
+}
+// --- End: config/bots/bot_families/goblins/head/goblin_speaker.src ---
+
+// --- Begin: config/components/drivers/gpio_pair_driver.src ---
+// gpio_pair_driver component implementation
+// Debug driver for GPIO pairs - simulates HC-SR04 ultrasonic sensor timing
+// Hardware mode captures echo edges in a GPIO ISR; check_echo() only pairs
+// the timestamps, so the echo width no longer depends on how often act() runs
+
+#include "esp_log.h"
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/gpio.h"
+#include "esp_timer.h"
+#include <math.h>
+
+// Debug configuration
+#define DEBUG_MODE 1  // Set to 0 for real GPIO hardware
+#define SOUND_SPEED_CM_US 0.0343f  // Speed of sound: 343 m/s = 0.0343 cm/?s
+#define MIN_DISTANCE_CM 2.0f
+#define MAX_DISTANCE_CM 400.0f
+#define ECHO_TIMEOUT_US 30000
+#define ECHO_EDGE_RING 8            // Power of two; a clean echo is 2 edges
+#define SIM_GHOST_PERCENT 4         // Multipath / crosstalk echoes in debug mode
+
+// Echo edge captured by the ISR
+typedef struct {
+    uint64_t time_us;
+    uint8_t level;
+} echo_edge_t;
+
+// Single producer (ISR) / single consumer (check_echo) ring
+static echo_edge_t echo_edges[ECHO_EDGE_RING];
+static volatile uint32_t echo_edge_head = 0;
+static volatile uint32_t echo_edge_tail = 0;
+static volatile uint32_t echo_edge_overruns = 0;
+
+// HC-SR04 measurement states
+typedef enum {
+    HC_SR04_IDLE = 0,
+    HC_SR04_TRIGGERED,      // Trigger pulse sent, waiting for echo to start
+    HC_SR04_MEASURING,      // Echo started, measuring duration
+    HC_SR04_COMPLETE,       // Measurement done, result ready
+    HC_SR04_TIMEOUT         // Measurement failed
+} hc_sr04_state_t;
+
+// GPIO pair debug simulation state
+typedef struct {
+    int trigger_pin;
+    int echo_pin;
+    bool configured;
+    
+    // Debug simulation state
+    hc_sr04_state_t measurement_state;
+    uint64_t trigger_time_us;
+    uint64_t echo_start_us;
+    uint32_t simulated_pulse_duration_us;
+    uint32_t measurement_count;
+    float current_distance_cm;
+    uint64_t last_echo_us;          // Echo start of the last completed measurement
+} gpio_pair_state_t;
+
+static gpio_pair_state_t pair_state = {
+    .trigger_pin = -1,
+    .echo_pin = -1,
+    .configured = false,
+    .measurement_state = HC_SR04_IDLE,
+    .trigger_time_us = 0,
+    .echo_start_us = 0,
+    .simulated_pulse_duration_us = 0,
+    .measurement_count = 0,
+    .current_distance_cm = 30.0f,
+    .last_echo_us = 0
+};
+
+/**
+ * @brief Echo pin edge ISR: timestamp and queue, nothing else
+ */
+static void IRAM_ATTR echo_edge_isr(void* arg) {
+    uint32_t head = echo_edge_head;
+    if (head - echo_edge_tail >= ECHO_EDGE_RING) {
+        echo_edge_overruns++;
+        return;
+    }
+    echo_edge_t* edge = &echo_edges[head & (ECHO_EDGE_RING - 1)];
+    edge->time_us = (uint64_t)esp_timer_get_time();
+    edge->level = (uint8_t)gpio_get_level((gpio_num_t)pair_state.echo_pin);
+    echo_edge_head = head + 1;
+}
+
+static bool pop_echo_edge(echo_edge_t* edge) {
+    uint32_t tail = echo_edge_tail;
+    if (tail == echo_edge_head) {
+        return false;
+    }
+    *edge = echo_edges[tail & (ECHO_EDGE_RING - 1)];
+    echo_edge_tail = tail + 1;
+    return true;
+}
+
+/**
+ * @brief Generate simulated distance for debug mode
+ */
+static float generate_simulated_distance(void) {
+    pair_state.measurement_count++;
+    
+    // Simulate someone moving back and forth
+    float time_factor = (float)pair_state.measurement_count * 0.05f;  // Slower oscillation
+    float base_distance = 30.0f + 20.0f * sinf(time_factor * 0.2f);  // 10-50cm oscillation
+    
+    // Add noise
+    float noise = ((float)(esp_random() % 1000) / 1000.0f - 0.5f) * 2.0f;  // ?1cm noise
+    base_distance += noise;
+    
+    // Ghost echoes: second bounce off a wall, or a near reflection off the snout
+    if ((esp_random() % 100) < SIM_GHOST_PERCENT) {
+        base_distance = (esp_random() & 1) ? base_distance * 2.0f : 6.0f + (float)(esp_random() % 40) / 10.0f;
+    }
+    
+    // Clamp to sensor range
+    if (base_distance < MIN_DISTANCE_CM) base_distance = MIN_DISTANCE_CM;
+    if (base_distance > MAX_DISTANCE_CM) base_distance = MAX_DISTANCE_CM;
+    
+    return base_distance;
+}
+
+/**
+ * @brief Initialize GPIO pair driver
+ */
+esp_err_t gpio_pair_driver_init(void) {
+    debug = false;
+
+    if (DEBUG_MODE) {
+        ESP_LOGI("gpio_pair_driver", "GPIO pair driver init (DEBUG MODE)");
+        ESP_LOGI("gpio_pair_driver", "Simulating HC-SR04 ultrasonic sensor timing");
+    } else {
+        ESP_LOGI("gpio_pair_driver", "GPIO pair driver init (HARDWARE MODE)");
+    }
+    
+    pair_state.measurement_state = HC_SR04_IDLE;
+    return ESP_OK;
+}
+
+/**
+ * @brief Execute GPIO pair driver action
+ */
+void gpio_pair_driver_act(void) {
+    debug = false;
+
+    // This driver is passive - actual work done on demand via measure functions
+    ESP_LOGD("gpio_pair_driver", "GPIO pair driver act");
+}
+
+/**
+ * @brief Configure GPIO pair for ultrasonic sensor
+ */
+esp_err_t gpio_pair_configure_ultrasonic(int trigger_pin, int echo_pin) {
+    ESP_LOGI("gpio_pair_driver", "Configuring GPIO pair: trigger=%d, echo=%d", 
+             trigger_pin, echo_pin);
+    
+    pair_state.trigger_pin = trigger_pin;
+    pair_state.echo_pin = echo_pin;
+    
+    if (!DEBUG_MODE) {
+        // Configure real GPIO pins
+        gpio_config_t trigger_config = {
+            .pin_bit_mask = (1ULL << trigger_pin),
+            .mode = GPIO_MODE_OUTPUT,
+            .pull_up_en = GPIO_PULLUP_DISABLE,
+            .pull_down_en = GPIO_PULLDOWN_DISABLE,
+            .intr_type = GPIO_INTR_DISABLE
+        };
+        
+        gpio_config_t echo_config = {
+            .pin_bit_mask = (1ULL << echo_pin),
+            .mode = GPIO_MODE_INPUT,
+            .pull_up_en = GPIO_PULLUP_DISABLE,
+            .pull_down_en = GPIO_PULLDOWN_DISABLE,
+            .intr_type = GPIO_INTR_ANYEDGE
+        };
+        
+        esp_err_t ret = gpio_config(&trigger_config);
+        if (ret != ESP_OK) {
+            ESP_LOGE("gpio_pair_driver", "Failed to configure trigger pin: %s", esp_err_to_name(ret));
+            return ret;
+        }
+        
+        ret = gpio_config(&echo_config);
+        if (ret != ESP_OK) {
+            ESP_LOGE("gpio_pair_driver", "Failed to configure echo pin: %s", esp_err_to_name(ret));
+            return ret;
+        }
+        
+        // Set trigger pin low initially
+        gpio_set_level((gpio_num_t)trigger_pin, 0);
+        
+        // Shared ISR service may already be installed by another driver
+        ret = gpio_install_isr_service(0);
+        if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
+            ESP_LOGE("gpio_pair_driver", "Failed to install GPIO ISR service: %s", esp_err_to_name(ret));
+            return ret;
+        }
+        
+        ret = gpio_isr_handler_add((gpio_num_t)echo_pin, echo_edge_isr, NULL);
+        if (ret != ESP_OK) {
+            ESP_LOGE("gpio_pair_driver", "Failed to attach echo ISR: %s", esp_err_to_name(ret));
+            return ret;
+        }
+    }
+    
+    pair_state.configured = true;
+    return ESP_OK;
+}
+
+/**
+ * @brief Send trigger pulse to start ultrasonic measurement
+ */
+esp_err_t gpio_pair_trigger_ultrasonic(void) {
+    if (!pair_state.configured) {
+        ESP_LOGE("gpio_pair_driver", "GPIO pair not configured");
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    if (pair_state.measurement_state != HC_SR04_IDLE) {
+        ESP_LOGW("gpio_pair_driver", "Measurement already in progress");
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    if (DEBUG_MODE) {
+        // Debug simulation: prepare the measurement
+        pair_state.current_distance_cm = generate_simulated_distance();
+        
+        // Simulate occasional failures (5% chance)
+        if ((esp_random() % 100) < 5) {
+            pair_state.measurement_state = HC_SR04_TIMEOUT;
+            ESP_LOGD("gpio_pair_driver", "Simulated trigger failure");
+            return ESP_ERR_TIMEOUT;
+        }
+        
+        // Calculate pulse duration for the simulated distance
+        // duration = (distance * 2) / sound_speed (round trip)
+        pair_state.simulated_pulse_duration_us = (uint32_t)((pair_state.current_distance_cm * 2.0f) / SOUND_SPEED_CM_US);
+        
+        ESP_LOGD("gpio_pair_driver", "Debug trigger: %.1f cm -> %lu ?s pulse", 
+                 pair_state.current_distance_cm, pair_state.simulated_pulse_duration_us);
+    } else {
+        // Real hardware: drop stale edges, then send 10?s trigger pulse
+        echo_edge_tail = echo_edge_head;
+        gpio_set_level((gpio_num_t)pair_state.trigger_pin, 1);
+        esp_rom_delay_us(10);
+        gpio_set_level((gpio_num_t)pair_state.trigger_pin, 0);
+    }
+    
+    pair_state.trigger_time_us = esp_timer_get_time();
+    pair_state.measurement_state = HC_SR04_TRIGGERED;
+    
+    return ESP_OK;
+}
+
+/**
+ * @brief Check echo pin status and return measurement when ready
+ * Call this repeatedly after trigger until ESP_OK is returned
+ */
+esp_err_t gpio_pair_check_echo(uint32_t* pulse_duration_us) {
+    if (!pair_state.configured) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    uint64_t current_time_us = esp_timer_get_time();
+    
+    if (DEBUG_MODE) {
+        // Debug simulation timing
+        switch (pair_state.measurement_state) {
+            case HC_SR04_IDLE:
+                return ESP_ERR_INVALID_STATE;
+                
+            case HC_SR04_TRIGGERED:
+                // Simulate delay before echo starts (typ. 100-200?s)
+                if ((current_time_us - pair_state.trigger_time_us) > 150) {
+                    pair_state.echo_start_us = current_time_us;
+                    pair_state.measurement_state = HC_SR04_MEASURING;
+                }
+                return ESP_ERR_NOT_FINISHED;
+                
+            case HC_SR04_MEASURING:
+                // Check if simulated echo pulse is complete
+                if ((current_time_us - pair_state.echo_start_us) >= pair_state.simulated_pulse_duration_us) {
+                    pair_state.measurement_state = HC_SR04_COMPLETE;
+                    pair_state.last_echo_us = pair_state.echo_start_us;
+                    *pulse_duration_us = pair_state.simulated_pulse_duration_us;
+                    ESP_LOGD("gpio_pair_driver", "Debug measurement complete: %.1f cm", pair_state.current_distance_cm);
+                    return ESP_OK;
+                }
+                return ESP_ERR_NOT_FINISHED;
+                
+            case HC_SR04_COMPLETE:
+                // Measurement already complete
+                *pulse_duration_us = pair_state.simulated_pulse_duration_us;
+                return ESP_OK;
+                
+            case HC_SR04_TIMEOUT:
+                return ESP_ERR_TIMEOUT;
+        }
+    } else {
+        // Real hardware: pair the ISR edge timestamps
+        echo_edge_t edge;
+        while (pair_state.measurement_state == HC_SR04_TRIGGERED ||
+               pair_state.measurement_state == HC_SR04_MEASURING) {
+            if (!pop_echo_edge(&edge)) {
+                break;
+            }
+            if (pair_state.measurement_state == HC_SR04_TRIGGERED && edge.level == 1) {
+                pair_state.echo_start_us = edge.time_us;
+                pair_state.measurement_state = HC_SR04_MEASURING;
+            } else if (pair_state.measurement_state == HC_SR04_MEASURING && edge.level == 0) {
+                pair_state.simulated_pulse_duration_us = (uint32_t)(edge.time_us - pair_state.echo_start_us);
+                pair_state.last_echo_us = pair_state.echo_start_us;
+                pair_state.measurement_state = HC_SR04_COMPLETE;
+            }
+        }
+        
+        switch (pair_state.measurement_state) {
+            case HC_SR04_TRIGGERED:
+                // No rising edge yet
+                if ((current_time_us - pair_state.trigger_time_us) > ECHO_TIMEOUT_US) {
+                    pair_state.measurement_state = HC_SR04_TIMEOUT;
+                    return ESP_ERR_TIMEOUT;
+                }
+                return ESP_ERR_NOT_FINISHED;
+                
+            case HC_SR04_MEASURING:
+                // Echo still HIGH
+                if ((current_time_us - pair_state.echo_start_us) > ECHO_TIMEOUT_US) {
+                    pair_state.measurement_state = HC_SR04_TIMEOUT;
+                    return ESP_ERR_TIMEOUT;
+                }
+                return ESP_ERR_NOT_FINISHED;
+                
+            case HC_SR04_COMPLETE:
+                *pulse_duration_us = pair_state.simulated_pulse_duration_us;
+                return ESP_OK;
+                
+            case HC_SR04_TIMEOUT:
+                return ESP_ERR_TIMEOUT;
+                
+            default:
+                return ESP_ERR_INVALID_STATE;
+        }
+    }
+    
+    return ESP_ERR_NOT_FINISHED;
+}
+
+/**
+ * @brief Timestamp of the last completed echo
+ */
+uint64_t gpio_pair_get_echo_time_us(void) {
+    return pair_state.last_echo_us;
+}
+
+/**
+ * @brief Reset measurement state to idle
+ */
+void gpio_pair_reset_measurement(void) {
+    pair_state.measurement_state = HC_SR04_IDLE;
+    ESP_LOGD("gpio_pair_driver", "Measurement reset to idle");
+}
+// --- End: config/components/drivers/gpio_pair_driver.src ---
+
+// --- Begin: config/components/hardware/hc_sr04.src ---
+// HC-SR04 Ultrasonic Distance Sensor Hardware Component
+// Uses gpio_pair_driver for pin management and protocol-correct timing
+
+#include "esp_log.h"
+#include "esp_timer.h"
+// Removed: #include "components/drivers/gpio_pair_driver.hdr" - .hdr content aggregated into .hpp
+#include "config/components/templates/UltrasonicRangeFilter.hpp"
+
+// HC-SR04 pins (configured via dynamic pin assignment)
+static int trigger_pin = -1;
+static int echo_pin = -1;
+
+// Sound speed constant for distance calculation
+#define SOUND_SPEED_CM_US 0.0343f  // Speed of sound: 343 m/s = 0.0343 cm/us
+#define PING_INTERVAL_US 60000     // Datasheet minimum; shorter lets old echoes ring into the next ping
+
+// Measurement state
+typedef enum {
+    HC_SR04_SENSOR_IDLE = 0,
+    HC_SR04_SENSOR_WAITING,      // Waiting for echo measurement
+    HC_SR04_SENSOR_READY         // Measurement complete
+} hc_sr04_sensor_state_t;
+
+static hc_sr04_sensor_state_t sensor_state = HC_SR04_SENSOR_IDLE;
+static float last_distance_cm = 0.0f;
+static bool measurement_valid = false;
+static uint64_t last_trigger_us = 0;
+
+// Median + gated Kalman: ghost echoes are rejected, timeouts coast
+static UltrasonicRangeFilter range_filter;
+
+
+
+esp_err_t hc_sr04_init(void) {
+    ESP_LOGI("hc_sr04", "Initializing HC-SR04 ultrasonic sensor");
+    
+    // Initialize the GPIO pair driver first
+    esp_err_t ret = gpio_pair_driver_init();
+    if (ret != ESP_OK) {
+        ESP_LOGE("hc_sr04", "Failed to initialize GPIO pair driver: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    
+    // Pin assignment happens via dynamic pin system
+    // For now, using example pins - will be assigned dynamically
+    trigger_pin = 12;  // Example - will be assigned dynamically
+    echo_pin = 13;     // Example - will be assigned dynamically
+    
+    // Configure the GPIO pair for ultrasonic measurement
+    ret = gpio_pair_configure_ultrasonic(trigger_pin, echo_pin);
+    if (ret != ESP_OK) {
+        ESP_LOGE("hc_sr04", "Failed to configure GPIO pair: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    
+    ESP_LOGI("hc_sr04", "HC-SR04 initialized using GPIO pair (trigger: %d, echo: %d)", trigger_pin, echo_pin);
+    return ESP_OK;
+
+}
+
+
+
+void hc_sr04_act(void) {
+    uint32_t pulse_duration_us = 0;
+    esp_err_t ret = ESP_ERR_NOT_FINISHED;
+    
+    switch (sensor_state) {
+        case HC_SR04_SENSOR_IDLE:
+            // Start new measurement by sending trigger pulse
+            if ((uint64_t)esp_timer_get_time() - last_trigger_us < PING_INTERVAL_US) {
+                break;
+            }
+            last_trigger_us = (uint64_t)esp_timer_get_time();
+            ret = gpio_pair_trigger_ultrasonic();
+            if (ret == ESP_OK) {
+                sensor_state = HC_SR04_SENSOR_WAITING;
+                ESP_LOGD("hc_sr04", "Trigger pulse sent, waiting for echo");
+            } else if (ret == ESP_ERR_TIMEOUT) {
+                // Trigger failed - stay idle and try again next time
+                range_filter.miss(last_trigger_us);
+                ESP_LOGD("hc_sr04", "Trigger failed, will retry");
+            } else if (ret == ESP_ERR_INVALID_STATE) {
+                // Measurement already in progress - shouldn't happen but handle gracefully
+                ESP_LOGD("hc_sr04", "Trigger skipped - measurement already in progress");
+            }
+            break;
+            
+        case HC_SR04_SENSOR_WAITING:
+            // Check if echo measurement is ready
+            ret = gpio_pair_check_echo(&pulse_duration_us);
+            if (ret == ESP_OK) {
+                // Measurement complete - calculate distance
+                last_distance_cm = (pulse_duration_us * SOUND_SPEED_CM_US) / 2.0f;
+                measurement_valid = true;
+                sensor_state = HC_SR04_SENSOR_READY;
+                
+                if (!range_filter.update(last_distance_cm * 10.0f, gpio_pair_get_echo_time_us())) {
+                    ESP_LOGD("hc_sr04", "Echo rejected as outlier: %.2f cm", last_distance_cm);
+                }
+                ESP_LOGD("hc_sr04", "Distance: %.2f cm (pulse: %lu us)", last_distance_cm, (unsigned long)pulse_duration_us);
+                
+                // Reset to idle for next measurement cycle
+                gpio_pair_reset_measurement();
+                sensor_state = HC_SR04_SENSOR_IDLE;
+                
+            } else if (ret == ESP_ERR_TIMEOUT) {
+                // Measurement timed out
+                measurement_valid = false;
+                range_filter.miss((uint64_t)esp_timer_get_time());
+                sensor_state = HC_SR04_SENSOR_IDLE;
+                gpio_pair_reset_measurement();
+                ESP_LOGD("hc_sr04", "Measurement timeout");
+            }
+            // If ret == ESP_ERR_NOT_FINISHED, keep waiting
+            break;
+            
+        case HC_SR04_SENSOR_READY:
+            // Measurement is ready, reset to idle for next cycle
+            gpio_pair_reset_measurement();
+            sensor_state = HC_SR04_SENSOR_IDLE;
+            break;
+    }
+}
+
+/**
+ * @brief Get the current distance reading in centimeters
+ */
+float hc_sr04_get_distance_cm(void) {
+    UltrasonicRangeFilter::Estimate e = range_filter.estimate();
+    return e.valid ? e.distance_mm / 10.0f : -1.0f;
+}
+
+/**
+ * @brief Check if sensor has a valid reading
+ */
+bool hc_sr04_is_valid_reading(void) {
+    return range_filter.estimate().valid;
+}
+
+/**
+ * @brief Get the filtered closing speed in cm/s
+ */
+float hc_sr04_get_velocity_cm_s(void) {
+    UltrasonicRangeFilter::Estimate e = range_filter.estimate();
+    return e.valid ? e.velocity_mm_s / 10.0f : 0.0f;
+}
+
+/**
+ * @brief Get the track confidence
+ */
+uint8_t hc_sr04_get_confidence(void) {
+    return range_filter.estimate().confidence;
+}
+
+/**
+ * @brief Get the last unfiltered echo distance
+ */
+float hc_sr04_get_raw_distance_cm(void) {
+    return measurement_valid ? last_distance_cm : -1.0f;
+}
+// --- End: config/components/hardware/hc_sr04.src ---
+
+// --- Begin: config/components/interfaces/i2s_bus.src ---
+// i2s_bus component implementation
+// I2S bus 0: shared clock pins plus a data line per device, dynamically assigned
+
+#include "esp_log.h"
+#include "driver/i2s.h"
+#include "driver/gpio.h"
+#include "esp32_s3_r8n16_pin_assignments.h"
+
+// BCLK/WS are shared by everything on the bus; claimed on first request
+static int i2s_bus_bclk = -1;
+static int i2s_bus_ws = -1;
+
+esp_err_t i2s_bus_0_init(void) {
+    ESP_LOGI("i2s_bus", "i2s_bus init - STUB IMPLEMENTATION");
+    // TODO: Add actual initialization code
+    return ESP_OK;
+}
+
+void i2s_bus_0_act(void) {
+    // TODO: Add actual action code
+    // ESP_LOGD("i2s_bus", "i2s_bus act");
+}
+
+esp_err_t i2s_bus_get_pins(i2s_pin_config_t *pin_config) {
+    if (!pin_config) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    if (i2s_bus_bclk < 0) {
+        i2s_bus_bclk = assign_pin(i2s_assignable, i2s_assignable_count);
+        i2s_bus_ws = assign_pin(i2s_assignable, i2s_assignable_count);
+    }
+    // Each caller gets its own data line (input only: the ear mics)
+    int data_in = assign_pin(i2s_assignable, i2s_assignable_count);
+    if (i2s_bus_bclk < 0 || i2s_bus_ws < 0 || data_in < 0) {
+        ESP_LOGE("i2s_bus", "I2S bus ran out of assignable pins");
+        return ESP_ERR_NOT_FOUND;
+    }
+    
+    pin_config->mck_io_num = I2S_PIN_NO_CHANGE;
+    pin_config->bck_io_num = i2s_bus_bclk;
+    pin_config->ws_io_num = i2s_bus_ws;
+    pin_config->data_out_num = I2S_PIN_NO_CHANGE;
+    pin_config->data_in_num = data_in;
+    
+    ESP_LOGI("i2s_bus", "I2S pins assigned BCLK:%d WS:%d DIN:%d", i2s_bus_bclk, i2s_bus_ws, data_in);
+    return ESP_OK;
+}
+// --- End: config/components/interfaces/i2s_bus.src ---
+
+// --- Begin: config/components/drivers/i2s_driver.src ---
+// i2s_driver component implementation
+// Debug implementation - streams audio data to PC via serial
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include <math.h>
+#include <stdio.h>
+#include <atomic>
+#include "config/components/templates/LipSyncAnalyzer.hpp"
+#include "config/components/templates/ImaAdpcmStream.hpp"
+#include "config/components/templates/AudioMixer.hpp"
+// Removed: #include "components/drivers/i2s_driver.hdr" - .hdr content aggregated into .hpp
+
+// Forward declarations
+static float generate_goblin_waveform(float sample_time, float base_freq);
+
+// Debug audio configuration
+#define DEBUG_AUDIO_MODE 1      // Set to 0 for real I2S hardware
+#define SAMPLE_RATE 44100       // 44.1kHz sample rate
+#define AUDIO_BUFFER_SIZE 1024  // Samples per buffer
+#define CHANNELS 1              // Mono audio
+#define AUDIO_BLOCK_SAMPLES 441 // 10 ms blocks through the audio path
+#define AUDIO_BLOCK_US 10000
+#define DMA_LATENCY_MS 40       // 4 DMA buffers queued ahead of the DAC
+#define JAW_LATENCY_MS 80       // Command-to-pose time of the jaw actuator
+#define MIXER_VOICES 3          // Concurrent sounds
+#define MIXER_DUCK_GAIN 77      // Lower-priority voices at ~-10 dB (x/256)
+#define MIXER_RETRIGGER_MS 300  // Same sound re-requested within this is ignored
+#define SOUND_CLIP_DIR "/spiffs/sounds"
+
+#define CLIP_FILE_SLOTS (MIXER_VOICES + 1)  // Open clip files: one per voice + one in flight
+#define CLIP_LOADER_QUEUE 8                 // Load jobs waiting for the loader task
+#define CLIP_LOADER_STACK 4096
+#define CLIP_LOADER_PRIO 4                  // Below the loop, above idle: file I/O is never urgent
+
+static size_t clip_file_read(void* ctx, uint32_t offset, uint8_t* dst, size_t len) {
+    FILE* f = (FILE*)ctx;
+    if (fseek(f, (long)offset, SEEK_SET) != 0) return 0;
+    return fread(dst, 1, len, f);
+}
+
+/**
+ * Clip file opened, validated and primed by the loader task, so the SPIFFS
+ * open and the header/first chunk reads stay off both the requester and the
+ * block path. A voice claims it in start() and hands it back in stop(); the
+ * loader closes it on its next job, never inside mix().
+ */
+struct ClipFileSlot {
+    enum State : uint8_t { FREE = 0, BUSY, READY, PLAYING, DONE };
+    std::atomic<uint8_t> state;
+    FILE* file;
+    ImaAdpcmStream stream;
+
+    bool claim(uint8_t from, uint8_t to) {
+        return state.compare_exchange_strong(from, to, std::memory_order_acq_rel);
+    }
+};
+
+static ClipFileSlot clip_files[CLIP_FILE_SLOTS];
+
+/** Is there a clip slot free or waiting to be closed? No I/O, any task */
+static bool clip_file_available(void) {
+    for (int i = 0; i < CLIP_FILE_SLOTS; i++) {
+        uint8_t state = clip_files[i].state.load(std::memory_order_acquire);
+        if (state == ClipFileSlot::FREE || state == ClipFileSlot::DONE) return true;
+    }
+    return false;
+}
+
+/**
+ * Open path as a ready-to-decode clip (loader task only)
+ * @return Slot to put in a request, NULL if missing/invalid or all slots busy
+ */
+static ClipFileSlot* clip_file_open(const char* path, bool log_missing) {
+    // Close what voices returned since the last request
+    for (int i = 0; i < CLIP_FILE_SLOTS; i++) {
+        ClipFileSlot& slot = clip_files[i];
+        if (slot.claim(ClipFileSlot::DONE, ClipFileSlot::BUSY)) {
+            slot.stream.close();
+            fclose(slot.file);
+            slot.file = NULL;
+            slot.state.store(ClipFileSlot::FREE, std::memory_order_release);
+        }
+    }
+
+    for (int i = 0; i < CLIP_FILE_SLOTS; i++) {
+        ClipFileSlot& slot = clip_files[i];
+        if (!slot.claim(ClipFileSlot::FREE, ClipFileSlot::BUSY)) continue;
+
+        slot.file = fopen(path, "rb");
+        if (!slot.file) {
+            if (log_missing) ESP_LOGW("i2s_driver", "Clip %s not found", path);
+            slot.state.store(ClipFileSlot::FREE, std::memory_order_release);
+            return NULL;
+        }
+        bool ok = false;
+        if (slot.stream.open(clip_file_read, slot.file) != ImaAdpcmStream::OK) {
+            ESP_LOGW("i2s_driver", "Clip %s rejected", path);
+        } else if (slot.stream.sampleRate() != SAMPLE_RATE) {
+            ESP_LOGW("i2s_driver", "Clip %s is %lu Hz, output runs at %d Hz", path, (unsigned long)slot.stream.sampleRate(), SAMPLE_RATE);
+        } else {
+            ok = slot.stream.prime();
+        }
+        if (!ok) {
+            slot.stream.close();
+            fclose(slot.file);
+            slot.file = NULL;
+            slot.state.store(ClipFileSlot::FREE, std::memory_order_release);
+            return NULL;
+        }
+        slot.state.store(ClipFileSlot::READY, std::memory_order_release);
+        return &slot;
+    }
+    ESP_LOGW("i2s_driver", "All %d clip files in use, %s not opened", CLIP_FILE_SLOTS, path);
+    return NULL;
+}
+
+/** Give a ready clip back unplayed (request dropped or refused) */
+static void clip_file_release(ClipFileSlot* slot) {
+    if (slot) slot->claim(ClipFileSlot::READY, ClipFileSlot::DONE);
+}
+
+/**
+ * One mixer voice: recorded IMA-ADPCM clip (memory or pre-opened file) if
+ * available, synthesized effect otherwise. start() does no file I/O.
+ */
+struct SpeakerVoice {
+    struct Request {
+        char name[64];              // Sound name or clip path (logs, voicing)
+        float frequency_hz;         // Synth fallback
+        float volume;               // 0.0-1.0
+        uint32_t duration_ms;       // Synth length, 0 = until stopped
+        const uint8_t* clip_data;   // Memory-mapped clip, or NULL
+        size_t clip_size;
+        ClipFileSlot* clip_file;    // Ready file clip from clip_file_open(), or NULL
+    };
+
+    ImaAdpcmStream clip;            // Memory clips decode here
+    ImaAdpcmStream::MemorySource memory;
+    ImaAdpcmStream* stream;         // &clip or the file slot's stream
+    ClipFileSlot* file_slot;
+    bool use_clip;
+    char name[64];
+    float frequency_hz;
+    float amplitude;
+    uint32_t sample_count;
+    uint32_t sample_limit;
+
+    bool start(const Request& r) {
+        stop();
+        strncpy(name, r.name, sizeof(name) - 1);
+        name[sizeof(name) - 1] = 0;
+        amplitude = r.volume < 0.0f ? 0.0f : (r.volume > 1.0f ? 1.0f : r.volume);
+        frequency_hz = r.frequency_hz;
+        sample_count = 0;
+        sample_limit = r.duration_ms ? r.duration_ms * (SAMPLE_RATE / 1000) : 0;
+
+        if (r.clip_file) {
+            if (r.clip_file->claim(ClipFileSlot::READY, ClipFileSlot::PLAYING)) {
+                file_slot = r.clip_file;
+                stream = &file_slot->stream;
+                use_clip = true;
+                return true;
+            }
+            return frequency_hz > 0.0f;
+        }
+
+        if (r.clip_data) {
+            memory.data = r.clip_data;
+            memory.size = r.clip_size;
+            use_clip = openMemoryClip();
+            return use_clip;
+        }
+        return frequency_hz > 0.0f;     // Synth
+    }
 
-// --- Begin: config\components\interfaces\spi_display_bus.src ---
+    size_t render(int16_t* out, size_t count) {
+        if (use_clip) {
+            return stream->decode(out, count, (uint16_t)(amplitude * 256.0f));
+        }
+
+        bool voiced = strstr(name, "speech") || strstr(name, "growl") || strstr(name, "roar");
+        size_t n = 0;
+        for (; n < count; n++) {
+            if (sample_limit && sample_count >= sample_limit) break;
+            float sample_time = (float)sample_count / (float)SAMPLE_RATE;
+            
+            // Complex goblin waveform for speech and vocalizations, sine for system sounds
+            float v = voiced ? generate_goblin_waveform(sample_time, frequency_hz)
+                             : sinf(2.0f * M_PI * frequency_hz * sample_time);
+            v *= amplitude;
+            if (v > 1.0f) v = 1.0f;
+            if (v < -1.0f) v = -1.0f;
+            out[n] = (int16_t)(v * 32767.0f);
+            sample_count++;
+        }
+        return n;
+    }
+
+    void stop() {
+        clip.close();
+        if (file_slot) {
+            file_slot->state.store(ClipFileSlot::DONE, std::memory_order_release);
+            file_slot = NULL;
+        }
+        stream = NULL;
+        use_clip = false;
+    }
+
+    static void discard(const Request& r) {
+        clip_file_release(r.clip_file);
+    }
+
+private:
+    bool openMemoryClip() {
+        if (clip.open(ImaAdpcmStream::readMemory, &memory) != ImaAdpcmStream::OK) {
+            ESP_LOGW("i2s_driver", "Clip %s rejected", name);
+            return false;
+        }
+        if (clip.sampleRate() != SAMPLE_RATE) {
+            ESP_LOGW("i2s_driver", "Clip %s is %lu Hz, output runs at %d Hz", name, (unsigned long)clip.sampleRate(), SAMPLE_RATE);
+            clip.close();
+            return false;
+        }
+        stream = &clip;
+        return true;
+    }
+};
+
+typedef AudioMixer<SpeakerVoice, MIXER_VOICES> speaker_mixer_t;
+
+// Audio path state
+typedef struct {
+    bool initialized;
+    bool playing;               // At least one voice rendered in the last block
+    uint64_t last_update_us;
+} debug_audio_state_t;
+
+// Block path: mixer (voices + ducking) -> lip-sync stage (analyse + lookahead delay) -> output
+static int16_t audio_block[AUDIO_BLOCK_SAMPLES];
+static speaker_mixer_t speaker_mixer;
+static LipSyncAnalyzer speaker_lip_sync;
+
+/**
+ * One clip to open for a request that already passed the mixer's preview.
+ * The loader opens it and posts the request, with the clip if it opened.
+ */
+typedef struct {
+    SpeakerVoice::Request request;
+    char path[sizeof(SpeakerVoice::Request::name) + sizeof(SOUND_CLIP_DIR) + 8];
+    uint8_t priority;
+    bool clip_required;         // play_clip_file: no synth fallback
+} clip_load_job_t;
+
+static QueueHandle_t clip_loader_queue = NULL;
+static void clip_loader_task(void* arg);
+
+static debug_audio_state_t audio_state = {
+    .initialized = false,
+    .playing = false,
+    .last_update_us = 0
+};
+
+esp_err_t i2s_driver_init(void) {
+    debug = false;
+
+    if (DEBUG_AUDIO_MODE) {
+        ESP_LOGI("i2s_driver", "I2S driver init (DEBUG AUDIO MODE)");
+        ESP_LOGI("i2s_driver", "Audio will be streamed to PC via serial");
+        ESP_LOGI("i2s_driver", "Sample rate: %d Hz, Channels: %d", SAMPLE_RATE, CHANNELS);
+        
+        // Print header for PC audio capture script
+        printf("AUDIO_STREAM_START\n");
+        printf("SAMPLE_RATE=%d\n", SAMPLE_RATE);
+        printf("CHANNELS=%d\n", CHANNELS);
+        printf("BUFFER_SIZE=%d\n", AUDIO_BUFFER_SIZE);
+        printf("FORMAT=INT16\n");
+        printf("AUDIO_HEADER_END\n");
+        
+    } else {
+        ESP_LOGI("i2s_driver", "I2S driver init (HARDWARE MODE)");
+        // TODO: Initialize real I2S hardware on GPIO 4,5,6
+    }
+    
+    speaker_mixer.configure(MIXER_DUCK_GAIN, MIXER_RETRIGGER_MS);
+    if (spiffs_storage_mount() != ESP_OK) {
+        ESP_LOGW("i2s_driver", "No %s - synthesized sounds only", SOUND_CLIP_DIR);
+    } else if (!clip_loader_queue) {
+        clip_loader_queue = xQueueCreate(CLIP_LOADER_QUEUE, sizeof(clip_load_job_t));
+        if (!clip_loader_queue ||
+            xTaskCreate(clip_loader_task, "clip_loader", CLIP_LOADER_STACK, NULL, CLIP_LOADER_PRIO, NULL) != pdPASS) {
+            ESP_LOGW("i2s_driver", "Clip loader not started - synthesized sounds only");
+            if (clip_loader_queue) vQueueDelete(clip_loader_queue);
+            clip_loader_queue = NULL;
+        }
+    }
+    speaker_lip_sync.configure(SAMPLE_RATE, 10, DEBUG_AUDIO_MODE ? 0 : DMA_LATENCY_MS, JAW_LATENCY_MS);
+    ESP_LOGI("i2s_driver", "Mixer: %d voices; lip-sync stage adds %u ms lookahead",
+             MIXER_VOICES, speaker_lip_sync.addedDelayMs());
+    
+    audio_state.initialized = true;
+    audio_state.last_update_us = esp_timer_get_time();
+    return ESP_OK;
+}
+
+void i2s_driver_act(void) {
+    debug = false;
+
+    if (!audio_state.initialized) return;
+    
+    uint64_t current_time_us = esp_timer_get_time();
+    
+    // One 10 ms block per period; if the loop stalled, skip ahead rather than burst
+    if ((current_time_us - audio_state.last_update_us) < AUDIO_BLOCK_US) {
+        return;
+    }
+    if ((current_time_us - audio_state.last_update_us) > 4 * AUDIO_BLOCK_US) {
+        audio_state.last_update_us = current_time_us;
+    } else {
+        audio_state.last_update_us += AUDIO_BLOCK_US;
+    }
+    
+    uint32_t now_ms = (uint32_t)(current_time_us / 1000);
+    audio_state.playing = speaker_mixer.mix(audio_block, AUDIO_BLOCK_SAMPLES, now_ms) > 0;
+    
+    // Mouth cues are scheduled here, before the audio is heard
+    speaker_lip_sync.processBlock(audio_block, audio_block, AUDIO_BLOCK_SAMPLES, now_ms);
+    
+    if (DEBUG_AUDIO_MODE && audio_state.playing) {
+        // Stream to PC via serial (every 16 samples for better quality)
+        for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i += 16) {
+            printf("AUDIO_DATA:%d\n", audio_block[i]);
+        }
+    }
+}
+
+/**
+ * @brief Lip-sync stage of the speaker path, for mouth components to drain cues
+ */
+LipSyncAnalyzer* i2s_driver_get_lip_sync(void) {
+    return &speaker_lip_sync;
+}
+
+/**
+ * @brief Generate complex waveform for goblin speech synthesis
+ */
+static float generate_goblin_waveform(float sample_time, float base_freq) {
+    // Base sine wave
+    float base_wave = sinf(2.0f * M_PI * base_freq * sample_time);
+    
+    // Add harmonics for goblin-like roughness
+    float harmonic2 = 0.3f * sinf(2.0f * M_PI * base_freq * 2.0f * sample_time);
+    float harmonic3 = 0.2f * sinf(2.0f * M_PI * base_freq * 3.0f * sample_time);
+    
+    // Add noise for growling effect
+    float noise = ((float)(esp_random() % 1000) / 1000.0f - 0.5f) * 0.1f;
+    
+    // Add frequency modulation for warbling effect
+    float fm_freq = base_freq + 20.0f * sinf(2.0f * M_PI * 3.0f * sample_time);
+    float fm_wave = 0.4f * sinf(2.0f * M_PI * fm_freq * sample_time);
+    
+    return base_wave + harmonic2 + harmonic3 + noise + fm_wave;
+}
+
+static bool i2s_driver_post(const char* sound_name, const SpeakerVoice::Request& request, uint8_t priority) {
+    if (!speaker_mixer.play(speaker_mixer_t::hashName(sound_name), priority, 256, request)) {
+        ESP_LOGW("i2s_driver", "Audio queue full, dropped %s", sound_name);
+        clip_file_release(request.clip_file);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Opens clips for queued requests, then hands them to the mixer. A burst of
+ * the same sound opens the file once: the mixer would dedupe the rest.
+ */
+static void clip_loader_task(void* arg) {
+    static clip_load_job_t job;
+    uint32_t recent_id[CLIP_FILE_SLOTS] = {0};
+    uint32_t recent_ms[CLIP_FILE_SLOTS] = {0};
+    int recent_next = 0;
+
+    while (true) {
+        if (xQueueReceive(clip_loader_queue, &job, portMAX_DELAY) != pdTRUE) continue;
+
+        uint32_t id = speaker_mixer_t::hashName(job.request.name);
+        uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+        bool repeat = false;
+        for (int i = 0; i < CLIP_FILE_SLOTS; i++) {
+            if (recent_id[i] == id && now_ms - recent_ms[i] < MIXER_RETRIGGER_MS) repeat = true;
+        }
+        if (repeat || !speaker_mixer.admits(id, job.priority, now_ms)) continue;
+        recent_id[recent_next] = id;
+        recent_ms[recent_next] = now_ms;
+        recent_next = (recent_next + 1) % CLIP_FILE_SLOTS;
+
+        job.request.clip_file = clip_file_open(job.path, job.clip_required);
+        if (!job.request.clip_file && job.clip_required) continue;
+        i2s_driver_post(job.request.name, job.request, job.priority);
+    }
+}
+
+/**
+ * Hand a request to the loader; posts it straight to the mixer (synth) when
+ * no clip could be opened anyway or the loader is not running
+ */
+static bool i2s_driver_queue_load(const clip_load_job_t& job) {
+    if (clip_loader_queue && clip_file_available()) {
+        if (xQueueSend(clip_loader_queue, &job, 0) == pdTRUE) return true;
+        ESP_LOGW("i2s_driver", "Clip loader busy, %s without clip", job.request.name);
+    }
+    if (job.clip_required) return false;
+    return i2s_driver_post(job.request.name, job.request, job.priority);
+}
+
+/**
+ * @brief Queue a sound for the mixer (never waits on the audio path)
+ */
+bool i2s_driver_request_sound(const char* sound_name, float frequency, float volume,
+                              uint8_t priority, uint32_t duration_ms) {
+    // Retriggers and requests every voice outranks stop here, before any I/O
+    uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    if (!speaker_mixer.admits(speaker_mixer_t::hashName(sound_name), priority, now_ms)) {
+        return false;
+    }
+
+    clip_load_job_t job;
+    memset(&job, 0, sizeof(job));
+    strncpy(job.request.name, sound_name, sizeof(job.request.name) - 1);
+    job.request.frequency_hz = frequency;
+    job.request.volume = volume;
+    job.request.duration_ms = duration_ms;
+    job.priority = priority;
+
+    // Recorded clip if there is one; the mixer falls back to the synth otherwise
+    snprintf(job.path, sizeof(job.path), "%s/%s.p32a", SOUND_CLIP_DIR, job.request.name);
+    
+    // Notify PC about sound change with enhanced info
+    if (DEBUG_AUDIO_MODE) {
+        printf("AUDIO_EVENT:PLAY=%s,FREQ=%.1f,VOL=%.2f,PRIO=%u,TYPE=", sound_name, frequency, volume, priority);
+        
+        // Categorize sound type for PC audio processing
+        if (strstr(sound_name, "speech")) {
+            printf("SPEECH\n");
+        } else if (strstr(sound_name, "growl") || strstr(sound_name, "roar")) {
+            printf("VOCALIZATION\n");
+        } else if (strstr(sound_name, "emotional")) {
+            printf("EMOTION\n");
+        } else if (strstr(sound_name, "proximity")) {
+            printf("ALERT\n");
+        } else {
+            printf("EFFECT\n");
+        }
+    }
+    return i2s_driver_queue_load(job);
+}
+
+/**
+ * @brief Start playing a sound effect
+ */
+void i2s_driver_play_sound(const char* sound_name, float frequency, float volume) {
+    ESP_LOGI("i2s_driver", "Playing sound: %s (%.1f Hz, %.1f vol)", sound_name, frequency, volume);
+    i2s_driver_request_sound(sound_name, frequency, volume, AUDIO_PRIORITY_REACTION, 0);
+}
+
+/**
+ * @brief Stop audio playback
+ */
+void i2s_driver_stop_sound(void) {
+    ESP_LOGI("i2s_driver", "Stopping audio playback");
+    speaker_mixer.stopAll();
+    
+    if (DEBUG_AUDIO_MODE) {
+        printf("AUDIO_EVENT:STOP\n");
+    }
+}
+
+/**
+ * @brief Stream an IMA-ADPCM clip (P32A) from a file, one chunk per block
+ */
+esp_err_t i2s_driver_play_clip_file(const char* path, float volume) {
+    clip_load_job_t job;
+    memset(&job, 0, sizeof(job));
+    if (strlen(path) >= sizeof(job.request.name)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    if (!speaker_mixer.admits(speaker_mixer_t::hashName(path), AUDIO_PRIORITY_COMMUNICATION, now_ms)) {
+        return ESP_OK;      // Already playing inside the retrigger window, or outranked
+    }
+    if (!clip_loader_queue || !clip_file_available()) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    strcpy(job.request.name, path);
+    strcpy(job.path, path);
+    job.request.volume = volume;
+    job.priority = AUDIO_PRIORITY_COMMUNICATION;
+    job.clip_required = true;
+    return xQueueSend(clip_loader_queue, &job, 0) == pdTRUE ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+/**
+ * @brief Stream an IMA-ADPCM clip (P32A) from memory-mapped flash
+ */
+esp_err_t i2s_driver_play_clip_memory(const char* name, const uint8_t* data, size_t size, float volume) {
+    SpeakerVoice::Request request;
+    memset(&request, 0, sizeof(request));
+    strncpy(request.name, name, sizeof(request.name) - 1);
+    request.volume = volume;
+    request.clip_data = data;
+    request.clip_size = size;
+    return i2s_driver_post(name, request, AUDIO_PRIORITY_COMMUNICATION) ? ESP_OK : ESP_ERR_NO_MEM;
+}
+// --- End: config/components/drivers/i2s_driver.src ---
+
+// --- Begin: config/components/drivers/i2s_generic_driver.src ---
+esp_err_t i2s_generic_driver_init(void)
+{
+    ESP_LOGI("i2s_generic_driver", "Initializing I2S generic driver");
+    
+    // I2S configuration for digital microphone
+    i2s_config_t i2s_config = {
+        .mode = I2S_MODE_MASTER | I2S_MODE_RX,
+        .sample_rate = 16000,
+        .bits_per_sample = I2S_BITS_PER_SAMPLE_32BIT,
+        .channel_format = I2S_CHANNEL_FMT_RIGHT_LEFT,  // Both ear mics share the bus (L/R select pins)
+        .communication_format = I2S_COMM_FORMAT_I2S,
+        .dma_buf_count = 8,
+        .dma_buf_len = 1024,
+        .use_apll = false,
+        .tx_desc_auto_clear = false,
+        .fixed_mclk = 0
+    };
+    
+    // Get I2S pins from bus
+    i2s_pin_config_t pin_config;
+    esp_err_t result = i2s_bus_get_pins(&pin_config);
+    if (result != ESP_OK)
+    {
+        ESP_LOGE("i2s_generic_driver", "Failed to get I2S pins from bus: %d", result);
+        return result;
+    }
+    
+    // Install I2S driver
+    result = i2s_driver_install(I2S_NUM_0, &i2s_config, 0, NULL);
+    if (result != ESP_OK)
+    {
+        ESP_LOGE("i2s_generic_driver", "Failed to install I2S driver: %d", result);
+        return result;
+    }
+    
+    // Set I2S pins
+    result = i2s_set_pin(I2S_NUM_0, &pin_config);
+    if (result != ESP_OK)
+    {
+        ESP_LOGE("i2s_generic_driver", "Failed to set I2S pins: %d", result);
+        i2s_driver_uninstall(I2S_NUM_0);
+        return result;
+    }
+    
+    ESP_LOGI("i2s_generic_driver", "I2S generic driver initialized successfully");
+    return ESP_OK;
+}
+
+void i2s_generic_driver_act(void)
+{
+    static bool dma_active = false;
+    static uint32_t last_check_time = 0;
+    uint32_t current_time = esp_timer_get_time() / 1000; // Convert to ms
+    
+    // Check DMA status every 100ms to avoid excessive checking
+    if (current_time - last_check_time < 100)
+    {
+        return;
+    }
+    last_check_time = current_time;
+    
+    // Check if DMA needs initiation
+    if (!dma_active)
+    {
+        // Start I2S reception (initiates DMA)
+        esp_err_t result = i2s_start(I2S_NUM_0);
+        if (result == ESP_OK)
+        {
+            dma_active = true;
+            ESP_LOGD("i2s_generic_driver", "DMA initiated for I2S audio capture");
+        }
+        else
+        {
+            ESP_LOGW("i2s_generic_driver", "Failed to start I2S DMA: %d", result);
+        }
+    }
+    else
+    {
+        // DMA is running - check for buffer underruns or errors
+        // In a real implementation, you'd check I2S status registers
+        // For now, just maintain the active state
+        ESP_LOGV("i2s_generic_driver", "I2S DMA active, monitoring...");
+    }
+}
+
+// API Functions
+esp_err_t i2s_generic_driver_read_samples(int32_t *buffer, size_t *bytes_read)
+{
+    if (!buffer || !bytes_read)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    // Bus carries interleaved left/right slots - mono callers still get 1024
+    // left-mic samples, pulled through a small stereo scratch block at a time
+    static int32_t stereo_scratch[2 * 128];
+    size_t samples = 0;
+    *bytes_read = 0;
+    while (samples < 1024)
+    {
+        size_t frames = 1024 - samples;
+        if (frames > 128)
+        {
+            frames = 128;
+        }
+        size_t chunk_bytes = 0;
+        esp_err_t result = i2s_read(I2S_NUM_0, stereo_scratch, frames * 2 * sizeof(int32_t), &chunk_bytes, pdMS_TO_TICKS(100));
+        size_t got = chunk_bytes / (2 * sizeof(int32_t));
+        for (size_t i = 0; i < got; i++)
+        {
+            buffer[samples + i] = stereo_scratch[2 * i];
+        }
+        samples += got;
+        *bytes_read = samples * sizeof(int32_t);
+        if (result != ESP_OK)
+        {
+            // A timeout after some blocks still hands back what arrived
+            return samples > 0 ? ESP_OK : result;
+        }
+        if (got < frames)
+        {
+            break;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t i2s_generic_driver_read_stereo(int32_t *frames, size_t max_frames, size_t *frames_read)
+{
+    if (!frames || !frames_read)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    // Zero timeout: take whatever the DMA ring already holds, never stall the loop
+    size_t bytes_read = 0;
+    esp_err_t result = i2s_read(I2S_NUM_0, frames, max_frames * 2 * sizeof(int32_t), &bytes_read, 0);
+    *frames_read = bytes_read / (2 * sizeof(int32_t));
+    return result;
+}
+
+esp_err_t i2s_generic_driver_get_sample_rate(uint32_t *rate)
+{
+    if (!rate)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    *rate = 16000; // Current configured sample rate
+    return ESP_OK;
+}
+
+esp_err_t i2s_generic_driver_is_dma_active(bool *active)
+{
+    if (!active)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    // In real implementation, check I2S peripheral status
+    *active = true; // Placeholder - would check actual DMA state
+    return ESP_OK;
+}
+
+esp_err_t i2s_generic_driver_start_dma(void)
+{
+    return i2s_start(I2S_NUM_0);
+}
+
+esp_err_t i2s_generic_driver_stop_dma(void)
+{
+    return i2s_stop(I2S_NUM_0);
+}
+// --- End: config/components/drivers/i2s_generic_driver.src ---
+
+// --- Begin: config/components/hardware/servo_sg90_micro.src ---
+// servo_sg90_micro component implementation
+// Auto-generated stub - needs actual implementation
+
+#include "esp_log.h"
+esp_err_t servo_sg90_micro_init(void) {
+    ESP_LOGI("servo_sg90_micro", "servo_sg90_micro init - STUB IMPLEMENTATION");
+    // TODO: Add actual initialization code
+    return ESP_OK;
+}
+
+void servo_sg90_micro_act(void) {
+    // TODO: Add actual action code
+    // ESP_LOGD("servo_sg90_micro", "servo_sg90_micro act");
+}
+// --- End: config/components/hardware/servo_sg90_micro.src ---
+
+// --- Begin: config/components/hardware/speaker.src ---
+// speaker component implementation
+// Debug implementation - triggers audio through i2s_driver
+
+#include "esp_log.h"
+#include "esp_timer.h"
+// Removed: #include "components/drivers/i2s_driver.hdr" - .hdr content aggregated into .hpp
+
+// Speaker state for mood-based audio
+typedef struct {
+    bool initialized;
+    uint64_t last_sound_us;
+    uint32_t sound_counter;
+    char current_mood[32];
+    bool audio_active;
+} speaker_state_t;
+
+static speaker_state_t speaker_state = {
+    .initialized = false,
+    .last_sound_us = 0,
+    .sound_counter = 0,
+    .current_mood = "neutral",
+    .audio_active = false
+};
+
+// Enhanced goblin sound effects library
+typedef struct {
+    const char* name;
+    float frequency_hz;
+    float volume;
+    uint32_t duration_ms;
+    const char* description;
+    const char* mood_context;
+} sound_effect_t;
+
+static const sound_effect_t sound_library[] = {
+    // Basic goblin vocalizations
+    {"goblin_growl_low", 120.0f, 0.5f, 2500, "Deep threatening growl", "aggressive"},
+    {"goblin_growl_med", 180.0f, 0.4f, 2000, "Warning growl", "cautious"},
+    {"goblin_snarl", 250.0f, 0.6f, 1200, "Angry snarl", "hostile"},
+    {"goblin_hiss", 400.0f, 0.3f, 800, "Threatening hiss", "defensive"},
+    
+    // Goblin laughter and amusement
+    {"goblin_cackle", 350.0f, 0.4f, 1800, "Evil cackling laugh", "mischievous"},
+    {"goblin_chuckle", 280.0f, 0.3f, 1000, "Amused chuckle", "playful"},
+    {"goblin_giggle", 450.0f, 0.2f, 600, "High-pitched giggle", "happy"},
+    
+    // Goblin communication
+    {"goblin_grunt_yes", 200.0f, 0.3f, 500, "Affirmative grunt", "agreeable"},
+    {"goblin_grunt_no", 150.0f, 0.4f, 800, "Negative grunt", "disagreeable"},
+    {"goblin_question", 300.0f, 0.3f, 400, "Questioning sound", "curious"},
+    {"goblin_surprise", 600.0f, 0.5f, 300, "Surprised exclamation", "startled"},
+    
+    // Goblin roars and calls
+    {"goblin_roar_short", 180.0f, 0.7f, 1500, "Short intimidating roar", "territorial"},
+    {"goblin_roar_long", 160.0f, 0.6f, 3000, "Long battle roar", "aggressive"},
+    {"goblin_howl", 220.0f, 0.5f, 2200, "Mournful howl", "lonely"},
+    {"goblin_screech", 800.0f, 0.4f, 600, "High-pitched screech", "alarmed"},
+    
+    // Environmental responses
+    {"proximity_close", 1000.0f, 0.4f, 200, "Something approaching", "alert"},
+    {"proximity_very_close", 1200.0f, 0.6f, 150, "Danger close", "defensive"},
+    {"movement_detected", 500.0f, 0.3f, 300, "Motion sensor triggered", "attentive"},
+    
+    // System sounds
+    {"system_boot", 440.0f, 0.3f, 1000, "System startup", "neutral"},
+    {"system_error", 220.0f, 0.5f, 1500, "Error occurred", "confused"},
+    {"idle_breathing", 80.0f, 0.1f, 4000, "Quiet breathing", "calm"},
+    {"idle_snore", 60.0f, 0.2f, 6000, "Sleeping sounds", "sleepy"}
+};
+#define SOUND_LIBRARY_SIZE (sizeof(sound_library) / sizeof(sound_effect_t))
+
+// Synthesized phrases/emotions have no natural end; bound them so voices free up
+#define SPEECH_DURATION_MS 1200
+#define EMOTION_DURATION_MS 1000
+
+/**
+ * @brief Priority of a library effect, from its name
+ */
+static uint8_t speaker_effect_priority(const sound_effect_t* sound) {
+    if (strncmp(sound->name, "proximity", 9) == 0 || strcmp(sound->name, "system_error") == 0) {
+        return AUDIO_PRIORITY_ALERT;
+    }
+    if (strncmp(sound->name, "idle", 4) == 0) {
+        return AUDIO_PRIORITY_AMBIENT;
+    }
+    return AUDIO_PRIORITY_REACTION;
+}
+
+/**
+ * @brief Queue an effect: the mixer plays a recorded IMA-ADPCM clip
+ * (/spiffs/sounds/<name>.p32a) if one exists, the synthesized tone otherwise
+ */
+static void speaker_start_effect(const sound_effect_t* sound) {
+    i2s_driver_request_sound(sound->name, sound->frequency_hz, sound->volume,
+                             speaker_effect_priority(sound), sound->duration_ms);
+}
+
+esp_err_t speaker_init(void) {
+    chunk_count = 1;
+
+    ESP_LOGI("speaker", "Speaker hardware init");
+    
+    // Initialize I2S driver first
+    esp_err_t ret = i2s_driver_init();
+    if (ret != ESP_OK) {
+        ESP_LOGE("speaker", "Failed to initialize I2S driver: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    
+    speaker_state.initialized = true;
+    speaker_state.last_sound_us = esp_timer_get_time();
+    
+    // Play boot sound
+    speaker_play_sound_by_name("system_boot");
+    
+    ESP_LOGI("speaker", "Speaker initialized with %d sound effects", SOUND_LIBRARY_SIZE);
+    return ESP_OK;
+}
+
+void speaker_act(void) {
+    chunk_count = 1;
+
+    if (!speaker_state.initialized) return;
+    
+    uint64_t current_time_us = esp_timer_get_time();
+    
+    // Demo: Play random sounds every 10 seconds
+    if ((current_time_us - speaker_state.last_sound_us) > 10000000) {  // 10 seconds
+        
+        // Select sound based on counter for demo purposes
+        uint32_t sound_index = speaker_state.sound_counter % SOUND_LIBRARY_SIZE;
+        const sound_effect_t* sound = &sound_library[sound_index];
+        
+        ESP_LOGI("speaker", "Demo: Playing %s", sound->name);
+        speaker_start_effect(sound);
+        
+        speaker_state.sound_counter++;
+        speaker_state.last_sound_us = current_time_us;
+        speaker_state.audio_active = true;
+        
+        // Schedule stop after duration
+        // Note: In real implementation, this would be handled by a timer
+    }
+    
+    // Call I2S driver to actually generate audio
+    i2s_driver_act();
+}
+
+/**
+ * @brief Play a specific sound by name
+ */
+void speaker_play_sound_by_name(const char* sound_name) {
+    for (int i = 0; i < SOUND_LIBRARY_SIZE; i++) {
+        if (strcmp(sound_library[i].name, sound_name) == 0) {
+            const sound_effect_t* sound = &sound_library[i];
+            ESP_LOGI("speaker", "Playing sound: %s", sound_name);
+            speaker_start_effect(sound);
+            return;
+        }
+    }
+    ESP_LOGW("speaker", "Sound not found: %s", sound_name);
+}
+
+/**
+ * @brief Play proximity alert sound
+ */
+void speaker_play_proximity_alert(void) {
+    speaker_play_sound_by_name("proximity_alert");
+}
+
+/**
+ * @brief Play mood-based ambient sound
+ */
+void speaker_play_mood_sound(const char* mood) {
+    strncpy(speaker_state.current_mood, mood, sizeof(speaker_state.current_mood) - 1);
+    
+    if (strcmp(mood, "aggressive") == 0) {
+        speaker_play_sound_by_name("goblin_roar_short");
+    } else if (strcmp(mood, "playful") == 0) {
+        speaker_play_sound_by_name("goblin_cackle");
+    } else if (strcmp(mood, "curious") == 0) {
+        speaker_play_sound_by_name("goblin_question");
+    } else if (strcmp(mood, "defensive") == 0) {
+        speaker_play_sound_by_name("goblin_hiss");
+    } else if (strcmp(mood, "happy") == 0) {
+        speaker_play_sound_by_name("goblin_giggle");
+    } else {
+        speaker_play_sound_by_name("idle_breathing");
+    }
+}
+
+/**
+ * @brief Synthesize and speak goblin words/phrases
+ */
+void speaker_speak_goblin_phrase(const char* phrase) {
+    ESP_LOGI("speaker", "Speaking goblin phrase: '%s'", phrase);
+    
+    // Goblin speech synthesis using phonetic mapping
+    if (strcmp(phrase, "hello") == 0 || strcmp(phrase, "greetings") == 0) {
+        // "Grrrak!" - Goblin greeting
+        i2s_driver_request_sound("goblin_speech_greetings", 180.0f, 0.4f, AUDIO_PRIORITY_COMMUNICATION, SPEECH_DURATION_MS);
+        
+    } else if (strcmp(phrase, "warning") == 0 || strcmp(phrase, "danger") == 0) {
+        // "Krash grok!" - Danger warning  
+        i2s_driver_request_sound("goblin_speech_warning", 220.0f, 0.6f, AUDIO_PRIORITY_COMMUNICATION, SPEECH_DURATION_MS);
+        
+    } else if (strcmp(phrase, "attack") == 0 || strcmp(phrase, "fight") == 0) {
+        // "GRAAAHHH!" - Battle cry
+        i2s_driver_request_sound("goblin_speech_attack", 160.0f, 0.8f, AUDIO_PRIORITY_COMMUNICATION, SPEECH_DURATION_MS);
+        
+    } else if (strcmp(phrase, "retreat") == 0 || strcmp(phrase, "flee") == 0) {
+        // "Grik grak grok!" - Retreat call
+        i2s_driver_request_sound("goblin_speech_retreat", 300.0f, 0.5f, AUDIO_PRIORITY_COMMUNICATION, SPEECH_DURATION_MS);
+        
+    } else if (strcmp(phrase, "curious") == 0 || strcmp(phrase, "what") == 0) {
+        // "Grok?" - Questioning
+        i2s_driver_request_sound("goblin_speech_question", 350.0f, 0.3f, AUDIO_PRIORITY_COMMUNICATION, SPEECH_DURATION_MS);
+        
+    } else if (strcmp(phrase, "yes") == 0 || strcmp(phrase, "agree") == 0) {
+        // "Grok grok!" - Agreement
+        i2s_driver_request_sound("goblin_speech_yes", 200.0f, 0.4f, AUDIO_PRIORITY_COMMUNICATION, SPEECH_DURATION_MS);
+        
+    } else if (strcmp(phrase, "no") == 0 || strcmp(phrase, "disagree") == 0) {
+        // "Grak! Grak!" - Disagreement
+        i2s_driver_request_sound("goblin_speech_no", 180.0f, 0.5f, AUDIO_PRIORITY_COMMUNICATION, SPEECH_DURATION_MS);
+        
+    } else if (strcmp(phrase, "hungry") == 0 || strcmp(phrase, "food") == 0) {
+        // "Nom nom grak!" - Hunger
+        i2s_driver_request_sound("goblin_speech_hungry", 150.0f, 0.4f, AUDIO_PRIORITY_COMMUNICATION, SPEECH_DURATION_MS);
+        
+    } else if (strcmp(phrase, "sleep") == 0 || strcmp(phrase, "tired") == 0) {
+        // "Zzzgrok..." - Sleepy
+        i2s_driver_request_sound("goblin_speech_sleepy", 100.0f, 0.2f, AUDIO_PRIORITY_COMMUNICATION, SPEECH_DURATION_MS);
+        
+    } else {
+        // Unknown phrase - generic goblin babble
+        ESP_LOGW("speaker", "Unknown phrase, playing generic goblin sounds");
+        i2s_driver_request_sound("goblin_speech_generic", 250.0f, 0.3f, AUDIO_PRIORITY_COMMUNICATION, SPEECH_DURATION_MS);
+    }
+    
+    // Notify PC about speech synthesis
+    printf("SPEECH_EVENT:PHRASE=%s\n", phrase);
+}
+
+/**
+ * @brief Play goblin emotional response
+ */
+void speaker_play_emotional_response(const char* emotion, float intensity) {
+    ESP_LOGI("speaker", "Emotional response: %s (intensity: %.2f)", emotion, intensity);
+    
+    // Adjust volume and frequency based on intensity (0.0 to 1.0)
+    float volume = 0.2f + (intensity * 0.5f);  // 0.2 to 0.7 range
+    
+    if (strcmp(emotion, "angry") == 0) {
+        float freq = 150.0f + (intensity * 100.0f);  // 150-250Hz range
+        i2s_driver_request_sound("goblin_emotional_angry", freq, volume, AUDIO_PRIORITY_REACTION, EMOTION_DURATION_MS);
+        
+    } else if (strcmp(emotion, "happy") == 0) {
+        float freq = 300.0f + (intensity * 200.0f);  // 300-500Hz range
+        i2s_driver_request_sound("goblin_emotional_happy", freq, volume, AUDIO_PRIORITY_REACTION, EMOTION_DURATION_MS);
+        
+    } else if (strcmp(emotion, "scared") == 0) {
+        float freq = 400.0f + (intensity * 400.0f);  // 400-800Hz range
+        i2s_driver_request_sound("goblin_emotional_scared", freq, volume, AUDIO_PRIORITY_REACTION, EMOTION_DURATION_MS);
+        
+    } else if (strcmp(emotion, "surprised") == 0) {
+        float freq = 500.0f + (intensity * 300.0f);  // 500-800Hz range
+        i2s_driver_request_sound("goblin_emotional_surprised", freq, volume, AUDIO_PRIORITY_REACTION, EMOTION_DURATION_MS);
+        
+    } else if (strcmp(emotion, "sad") == 0) {
+        float freq = 120.0f + (intensity * 80.0f);   // 120-200Hz range
+        i2s_driver_request_sound("goblin_emotional_sad", freq, volume, AUDIO_PRIORITY_REACTION, EMOTION_DURATION_MS);
+        
+    } else {
+        // Default neutral emotion
+        i2s_driver_request_sound("goblin_emotional_neutral", 200.0f, volume, AUDIO_PRIORITY_REACTION, EMOTION_DURATION_MS);
+    }
+}
+// --- End: config/components/hardware/speaker.src ---
+
+// --- Begin: config/components/interfaces/spi_display_bus.src ---
 // spi_display_bus component implementation
 // Dedicated SPI bus for display devices with dynamic pin assignment
 
@@ -878,4 +3781,56 @@ void spi_display_bus_act(void) {
         slot = 0;
     }
 }
-// --- End: config\components\interfaces\spi_display_bus.src ---
+// --- End: config/components/interfaces/spi_display_bus.src ---
+
+// --- Begin: config/components/interfaces/spiffs_storage.src ---
+// spiffs_storage component implementation
+// Mounts the 'storage' partition (partitions.csv) at /spiffs once, for every consumer
+
+#include "esp_log.h"
+#include "esp_spiffs.h"
+// Removed: #include "components/interfaces/spiffs_storage.hdr" - .hdr content aggregated into .hpp
+
+#define SPIFFS_STORAGE_LABEL "storage"
+#define SPIFFS_STORAGE_MAX_FILES 8      // Clip slots (4) + eye library + config, with headroom
+
+static esp_err_t spiffs_storage_result = ESP_ERR_INVALID_STATE;    // Not tried yet
+
+esp_err_t spiffs_storage_init(void) {
+    return spiffs_storage_mount();
+}
+
+void spiffs_storage_act(void) {
+    // Nothing periodic: the filesystem is passive
+}
+
+esp_err_t spiffs_storage_mount(void) {
+    // Called from the consumers' init on the dispatcher task, so no locking
+    if (spiffs_storage_result != ESP_ERR_INVALID_STATE) {
+        return spiffs_storage_result;
+    }
+
+    esp_vfs_spiffs_conf_t conf = {};
+    conf.base_path = SPIFFS_STORAGE_BASE_PATH;
+    conf.partition_label = SPIFFS_STORAGE_LABEL;
+    conf.max_files = SPIFFS_STORAGE_MAX_FILES;
+    conf.format_if_mount_failed = false;
+
+    esp_err_t ret = esp_vfs_spiffs_register(&conf);
+    if (ret == ESP_ERR_INVALID_STATE) {
+        ret = ESP_OK;   // Someone else registered it already
+    }
+    if (ret == ESP_OK) {
+        size_t total = 0, used = 0;
+        esp_spiffs_info(SPIFFS_STORAGE_LABEL, &total, &used);
+        ESP_LOGI("spiffs_storage", "Mounted %s at %s: %u of %u bytes used",
+                 SPIFFS_STORAGE_LABEL, SPIFFS_STORAGE_BASE_PATH, (unsigned)used, (unsigned)total);
+    } else if (ret == ESP_ERR_NOT_FOUND) {
+        ESP_LOGE("spiffs_storage", "No '%s' partition - flash with partitions.csv", SPIFFS_STORAGE_LABEL);
+    } else {
+        ESP_LOGE("spiffs_storage", "Mount failed (%s) - run pio run -t uploadfs", esp_err_to_name(ret));
+    }
+    spiffs_storage_result = ret;
+    return ret;
+}
+// --- End: config/components/interfaces/spiffs_storage.src ---
@@ -9,13 +9,30 @@ const init_function_t goblin_head_init_table[] = {
     &gc9a01_init,
     &spi_display_bus_init,
     &generic_spi_display_init,
+    &spiffs_storage_init,
     &goblin_right_eye_init,
     &goblin_eye_init,
     &gc9a01_init,
     &spi_display_bus_init,
     &generic_spi_display_init,
     &goblin_mouth_display_init,
-    &goblin_mouth_mood_display_init
+    &goblin_mouth_mood_display_init,
+    &goblin_speaker_init,
+    &speaker_init,
+    &i2s_bus_0_init,
+    &i2s_driver_init,
+    &spiffs_storage_init,
+    &goblin_jaw_init,
+    &servo_sg90_micro_init,
+    &goblin_nose_init,
+    &hc_sr04_init,
+    &gpio_pair_driver_init,
+    &goblin_ear_localizer_init,
+    &i2s_generic_driver_init,
+    &goblin_sensor_fusion_init,
+    &goblin_mood_init,
+    &goblin_head_neck_motor_init,
+    &goblin_gaze_init
 };
 
 const act_function_t goblin_head_act_table[] = {
@@ -24,13 +41,30 @@ const act_function_t goblin_head_act_table[] = {
     &gc9a01_act,
     &spi_display_bus_act,
     &generic_spi_display_act,
+    &spiffs_storage_act,
     &goblin_right_eye_act,
     &goblin_eye_act,
     &gc9a01_act,
     &spi_display_bus_act,
     &generic_spi_display_act,
     &goblin_mouth_display_act,
-    &goblin_mouth_mood_display_act
+    &goblin_mouth_mood_display_act,
+    &goblin_speaker_act,
+    &speaker_act,
+    &i2s_bus_0_act,
+    &i2s_driver_act,
+    &spiffs_storage_act,
+    &goblin_jaw_act,
+    &servo_sg90_micro_act,
+    &goblin_nose_act,
+    &hc_sr04_act,
+    &gpio_pair_driver_act,
+    &goblin_ear_localizer_act,
+    &i2s_generic_driver_act,
+    &goblin_sensor_fusion_act,
+    &goblin_mood_act,
+    &goblin_head_neck_motor_act,
+    &goblin_gaze_act
 };
 
 const uint32_t goblin_head_hitcount_table[] = {
@@ -39,15 +73,64 @@ const uint32_t goblin_head_hitcount_table[] = {
     1,
     1,
     1,
+    1,
     5,
     1,
     1,
     1,
     1,
     1,
+    1,
+    84000,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
     1
 };
 
+const uint8_t goblin_head_stretch_table[] = {
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0
+};
+
 const std::size_t goblin_head_init_table_size = sizeof(goblin_head_init_table) / sizeof(init_function_t);
 const std::size_t goblin_head_act_table_size = sizeof(goblin_head_act_table) / sizeof(act_function_t);
 
@@ -12,6 +12,9 @@ const act_function_t goblin_torso_act_table[] = {
 const uint32_t goblin_torso_hitcount_table[] = {
 };
 
+const uint8_t goblin_torso_stretch_table[] = {
+};
+
 const std::size_t goblin_torso_init_table_size = sizeof(goblin_torso_init_table) / sizeof(init_function_t);
 const std::size_t goblin_torso_act_table_size = sizeof(goblin_torso_act_table) / sizeof(act_function_t);
 
@@ -15,6 +15,10 @@ const uint32_t test_head_hitcount_table[] = {
     1
 };
 
+const uint8_t test_head_stretch_table[] = {
+    0
+};
+
 const std::size_t test_head_init_table_size = sizeof(test_head_init_table) / sizeof(init_function_t);
 const std::size_t test_head_act_table_size = sizeof(test_head_act_table) / sizeof(act_function_t);
 
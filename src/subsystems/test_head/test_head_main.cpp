@@ -4,6 +4,8 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "shared/PowerState.hpp"
+
 // Auto-generated subsystem main loop for test_head
 
 uint32_t g_loopCount = 0;
@@ -15,10 +17,16 @@ extern "C" void app_main(void) {
         }
     }
 
+    // Power governor policy, published locally or received over ESP-NOW
+    const PowerState* power = GSM.read<PowerState>();
+
     while (true) {
+        const uint32_t stretch = power->period_stretch > 0U ? power->period_stretch : 1U;
         for (std::size_t i = 0; i < test_head_act_table_size; ++i) {
             const auto func = test_head_act_table[i];
-            const auto hit = test_head_hitcount_table[i];
+            const uint32_t hit = test_head_stretch_table[i]
+                ? test_head_hitcount_table[i] * stretch
+                : test_head_hitcount_table[i];
             if (func && hit > 0U && (g_loopCount % hit) == 0U) {
                 func();
             }
@@ -0,0 +1,56 @@
+/**
+ * @file host_bench.hpp
+ * @brief Timing helpers for host-side cost measurements
+ *
+ * Numbers printed by host suites are host nanoseconds, not ESP32 cycles.
+ * They are used to compare algorithms against each other and to catch
+ * regressions; on-target cost still has to be confirmed with esp_cpu cycle
+ * counters on the real chip.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <sys/stat.h>
+
+namespace host_bench {
+
+/** Create the directory suites dump their artifacts into (WAV, CSV, frames) */
+inline void ensureOutputDir(const char* dir = "test_output") {
+    mkdir(dir, 0755);
+}
+
+inline uint64_t nowNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Accumulates per-call cost (mean and worst case).
+ */
+struct CostStats {
+    uint64_t total_ns = 0;
+    uint64_t worst_ns = 0;
+    uint32_t calls = 0;
+
+    void add(uint64_t ns) {
+        total_ns += ns;
+        if (ns > worst_ns) worst_ns = ns;
+        calls++;
+    }
+    double meanNs() const { return calls ? (double)total_ns / calls : 0.0; }
+
+    void print(const char* label, double budget_ns = 0.0) const {
+        if (budget_ns > 0.0) {
+            printf("[BENCH] %-36s mean %9.1f ns  worst %9llu ns  (%5.2f%% of %.0f ns budget)\n",
+                   label, meanNs(), (unsigned long long)worst_ns, 100.0 * meanNs() / budget_ns, budget_ns);
+        } else {
+            printf("[BENCH] %-36s mean %9.1f ns  worst %9llu ns\n",
+                   label, meanNs(), (unsigned long long)worst_ns);
+        }
+    }
+};
+
+} // namespace host_bench
@@ -0,0 +1,119 @@
+/**
+ * @file udp_mesh_transport.hpp
+ * @brief Linux UDP multicast backend for MeshCoordinator (host benchmarks)
+ *
+ * Stands in for the ESP-NOW radio so several mesh nodes can run on one
+ * machine: every node joins the same multicast group on loopback and sends
+ * every frame to the group, which is what an ESP-NOW broadcast does.
+ * Unicast destinations are filtered by the coordinator (dest_role), our
+ * own frames coming back through IP_MULTICAST_LOOP are dropped the same way.
+ *
+ * pump() peeks the header to find the message type, reserves the ring slot
+ * and recvfrom()s the datagram straight into it, so the host path is copy
+ * free end to end. The 6-byte source address is the sender's IPv4 address
+ * and port.
+ *
+ * Loopback timings are host kernel timings, not ESP-NOW air time (~2 ms
+ * per 250-byte frame at 1 Mbps); they measure the coordinator, not the radio.
+ */
+
+#pragma once
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "config/components/templates/MeshCoordinator.hpp"
+
+namespace host_mesh {
+
+struct UdpMulticastTransport {
+    int fd = -1;
+    sockaddr_in group = {};
+
+    /** Join group on loopback; false if the host has no multicast route */
+    bool open(const char* group_ip = "239.255.32.32", uint16_t port = 32032) {
+        fd = socket(AF_INET, SOCK_DGRAM, 0);
+        if (fd < 0) return false;
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+        int rcvbuf = 1 << 20;
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+        sockaddr_in bind_addr = {};
+        bind_addr.sin_family = AF_INET;
+        bind_addr.sin_port = htons(port);
+        bind_addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        if (bind(fd, (sockaddr*)&bind_addr, sizeof(bind_addr)) != 0) { close(); return false; }
+
+        ip_mreq membership = {};
+        inet_pton(AF_INET, group_ip, &membership.imr_multiaddr);
+        membership.imr_interface.s_addr = htonl(INADDR_LOOPBACK);
+        if (setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) != 0) {
+            close();
+            return false;
+        }
+        in_addr loopback = {};
+        loopback.s_addr = htonl(INADDR_LOOPBACK);
+        setsockopt(fd, IPPROTO_IP, IP_MULTICAST_IF, &loopback, sizeof(loopback));
+        unsigned char loop = 1;
+        setsockopt(fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+
+        group.sin_family = AF_INET;
+        group.sin_port = htons(port);
+        group.sin_addr = membership.imr_multiaddr;
+        return true;
+    }
+
+    void close() {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    }
+
+    /** MeshCoordinator Transport::SendFn; ctx is the UdpMulticastTransport */
+    static bool send(void* ctx, uint8_t, const uint8_t* frame, uint16_t len) {
+        UdpMulticastTransport* self = (UdpMulticastTransport*)ctx;
+        return sendto(self->fd, frame, len, 0, (const sockaddr*)&self->group, sizeof(self->group)) == len;
+    }
+
+    /** Wait up to timeout_ms for a datagram */
+    bool wait(int timeout_ms) {
+        pollfd p = { fd, POLLIN, 0 };
+        return ::poll(&p, 1, timeout_ms) > 0;
+    }
+
+    /** Move waiting datagrams into mesh's rings; returns datagrams read */
+    template<class Coordinator>
+    uint16_t pump(Coordinator& mesh, uint16_t max_frames) {
+        uint16_t n = 0;
+        while (n < max_frames) {
+            uint8_t peek[MESH_HEADER_BYTES];
+            ssize_t got = recv(fd, peek, sizeof(peek), MSG_PEEK | MSG_DONTWAIT);
+            if (got < 0) break;
+            n++;
+
+            uint8_t* slot = got >= 5 ? mesh.reserve(((const MeshHeader*)peek)->msg_type) : nullptr;
+            if (!slot) {
+                recv(fd, peek, sizeof(peek), MSG_DONTWAIT);     // Drop it
+                continue;
+            }
+            sockaddr_in from = {};
+            socklen_t from_len = sizeof(from);
+            got = recvfrom(fd, slot, MESH_MAX_FRAME, MSG_DONTWAIT | MSG_TRUNC, (sockaddr*)&from, &from_len);
+            if (got < 0) break;
+            uint8_t src[6];
+            memcpy(src, &from.sin_addr.s_addr, 4);
+            memcpy(src + 4, &from.sin_port, 2);
+            mesh.commit((uint16_t)(got > 0xFFFF ? 0xFFFF : got), src);
+        }
+        return n;
+    }
+};
+
+} // namespace host_mesh
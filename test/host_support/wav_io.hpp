@@ -0,0 +1,78 @@
+/**
+ * @file wav_io.hpp
+ * @brief Minimal 16-bit PCM WAV reader/writer for host-side audio tests
+ *
+ * Host test suites (env:host_test) use this to dump synthetic audio and
+ * trajectories to test_output/ for inspection, and to read them back so the
+ * code under test is evaluated from real WAV files rather than from arrays.
+ *
+ * Only canonical RIFF/WAVE files with a single "fmt " chunk and 16-bit PCM
+ * samples are supported - which is all the generators here ever write.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace host_wav {
+
+struct WavData {
+    uint32_t sample_rate = 0;
+    uint16_t channels = 0;
+    std::vector<int16_t> samples;   // Interleaved when channels > 1
+
+    size_t frames() const { return channels ? samples.size() / channels : 0; }
+};
+
+inline void put16(FILE* f, uint16_t v) { uint8_t b[2] = {(uint8_t)v, (uint8_t)(v >> 8)}; fwrite(b, 1, 2, f); }
+inline void put32(FILE* f, uint32_t v) { put16(f, (uint16_t)v); put16(f, (uint16_t)(v >> 16)); }
+
+inline bool write(const char* path, const WavData& wav) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+
+    uint32_t data_bytes = (uint32_t)(wav.samples.size() * sizeof(int16_t));
+    fwrite("RIFF", 1, 4, f);
+    put32(f, 36 + data_bytes);
+    fwrite("WAVEfmt ", 1, 8, f);
+    put32(f, 16);
+    put16(f, 1);                                      // PCM
+    put16(f, wav.channels);
+    put32(f, wav.sample_rate);
+    put32(f, wav.sample_rate * wav.channels * 2);     // Byte rate
+    put16(f, (uint16_t)(wav.channels * 2));           // Block align
+    put16(f, 16);
+    fwrite("data", 1, 4, f);
+    put32(f, data_bytes);
+    for (int16_t s : wav.samples) put16(f, (uint16_t)s);
+    fclose(f);
+    return true;
+}
+
+inline bool read(const char* path, WavData& wav) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+
+    uint8_t hdr[44];
+    bool ok = fread(hdr, 1, sizeof(hdr), f) == sizeof(hdr)
+           && memcmp(hdr, "RIFF", 4) == 0 && memcmp(hdr + 8, "WAVEfmt ", 8) == 0
+           && hdr[20] == 1 && hdr[34] == 16 && memcmp(hdr + 36, "data", 4) == 0;
+    if (ok) {
+        wav.channels = (uint16_t)(hdr[22] | (hdr[23] << 8));
+        wav.sample_rate = (uint32_t)hdr[24] | ((uint32_t)hdr[25] << 8) | ((uint32_t)hdr[26] << 16) | ((uint32_t)hdr[27] << 24);
+        uint32_t data_bytes = (uint32_t)hdr[40] | ((uint32_t)hdr[41] << 8) | ((uint32_t)hdr[42] << 16) | ((uint32_t)hdr[43] << 24);
+        wav.samples.resize(data_bytes / 2);
+        for (size_t i = 0; i < wav.samples.size(); i++) {
+            uint8_t b[2];
+            if (fread(b, 1, 2, f) != 2) { ok = false; break; }
+            wav.samples[i] = (int16_t)(b[0] | (b[1] << 8));
+        }
+    }
+    fclose(f);
+    return ok;
+}
+
+} // namespace host_wav
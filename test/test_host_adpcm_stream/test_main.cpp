@@ -0,0 +1,249 @@
+/**
+ * @file test_main.cpp
+ * @brief Host benchmark of ImaAdpcmStream as i2s_driver drives it
+ *
+ * Encodes a synthetic voice clip to a P32A file (same quantiser as
+ * tools/adpcm_encode.py), then streams it back in 10 ms blocks from a FILE
+ * and from memory, measuring decode cost per block, source reads and the
+ * decoder's footprint.
+ *
+ * Outputs for inspection (test_output/):
+ *   adpcm_clip.p32a          - encoded clip
+ *   adpcm_source.wav         - original PCM
+ *   adpcm_decoded.wav        - streamed decode
+ *
+ * Run: pio test -e host_test -f test_host_adpcm_stream
+ */
+
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "config/components/templates/ImaAdpcmStream.hpp"
+#include "../host_support/wav_io.hpp"
+#include "../host_support/host_bench.hpp"
+
+static const uint32_t SAMPLE_RATE = 44100;
+static const size_t BLOCK = 441;            // i2s_driver render block
+static const uint16_t BLOCK_BYTES = 256;    // tools/adpcm_encode.py default
+
+static uint32_t rng_state = 4242;
+static float frand() {
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return (float)(rng_state >> 8) / 16777216.0f - 0.5f;
+}
+
+/** Growl-like test clip: gliding harmonics, syllable envelope, breath noise */
+static std::vector<int16_t> renderVoice(float seconds) {
+    std::vector<int16_t> pcm((size_t)(seconds * SAMPLE_RATE));
+    float phase = 0.0f;
+    for (size_t n = 0; n < pcm.size(); n++) {
+        float t = (float)n / SAMPLE_RATE;
+        float f0 = 140.0f + 60.0f * sinf(6.2831853f * 0.7f * t);
+        phase += 6.2831853f * f0 / SAMPLE_RATE;
+        float env = 0.5f + 0.5f * sinf(6.2831853f * 3.0f * t);
+        float v = sinf(phase) + 0.5f * sinf(2.0f * phase) + 0.3f * sinf(5.0f * phase) + 0.15f * frand();
+        pcm[n] = (int16_t)lrintf(v * env * 12000.0f);
+    }
+    return pcm;
+}
+
+static std::vector<uint8_t> encodeClip(const std::vector<int16_t>& pcm) {
+    std::vector<uint8_t> clip(ImaAdpcmStream::HEADER_BYTES, 0);
+    memcpy(clip.data(), "P32A", 4);
+    uint32_t rate = SAMPLE_RATE, count = (uint32_t)pcm.size();
+    for (int i = 0; i < 4; i++) {
+        clip[4 + i] = (uint8_t)(rate >> (8 * i));
+        clip[8 + i] = (uint8_t)(count >> (8 * i));
+    }
+    clip[12] = BLOCK_BYTES & 0xFF;
+    clip[13] = BLOCK_BYTES >> 8;
+    clip[14] = 1;
+    clip[15] = ImaAdpcmStream::FORMAT_VERSION;
+
+    uint32_t spb = ImaAdpcmStream::samplesPerBlock(BLOCK_BYTES);
+    int step_idx = 0;
+    uint8_t block[BLOCK_BYTES];
+    for (size_t start = 0; start < pcm.size(); start += spb) {
+        size_t n = pcm.size() - start < spb ? pcm.size() - start : spb;
+        ImaAdpcmStream::encodeBlock(&pcm[start], n, block, BLOCK_BYTES, step_idx);
+        clip.insert(clip.end(), block, block + BLOCK_BYTES);
+    }
+    return clip;
+}
+
+static size_t fileRead(void* ctx, uint32_t offset, uint8_t* dst, size_t len) {
+    FILE* f = (FILE*)ctx;
+    if (fseek(f, (long)offset, SEEK_SET) != 0) return 0;
+    return fread(dst, 1, len, f);
+}
+
+static float snrDb(const std::vector<int16_t>& ref, const std::vector<int16_t>& test) {
+    double sig = 0.0, err = 0.0;
+    for (size_t i = 0; i < ref.size() && i < test.size(); i++) {
+        sig += (double)ref[i] * ref[i];
+        double d = (double)ref[i] - test[i];
+        err += d * d;
+    }
+    return (float)(10.0 * log10(sig / (err + 1.0)));
+}
+
+/** Stream the whole clip in render-sized blocks */
+static std::vector<int16_t> streamAll(ImaAdpcmStream& stream, host_bench::CostStats* cost) {
+    std::vector<int16_t> out;
+    int16_t block[BLOCK];
+    while (!stream.finished()) {
+        uint64_t t0 = host_bench::nowNs();
+        size_t got = stream.decode(block, BLOCK);
+        if (cost) cost->add(host_bench::nowNs() - t0);
+        out.insert(out.end(), block, block + got);
+        if (got < BLOCK) break;
+    }
+    return out;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_file_streaming_round_trip_and_cost(void) {
+    std::vector<int16_t> pcm = renderVoice(3.0f);
+    std::vector<uint8_t> clip = encodeClip(pcm);
+
+    host_bench::ensureOutputDir();
+    FILE* f = fopen("test_output/adpcm_clip.p32a", "wb");
+    TEST_ASSERT_NOT_NULL(f);
+    fwrite(clip.data(), 1, clip.size(), f);
+    fclose(f);
+
+    f = fopen("test_output/adpcm_clip.p32a", "rb");
+    TEST_ASSERT_NOT_NULL(f);
+    static ImaAdpcmStream stream;
+    TEST_ASSERT_EQUAL(ImaAdpcmStream::OK, stream.open(fileRead, f));
+    TEST_ASSERT_EQUAL_UINT32(SAMPLE_RATE, stream.sampleRate());
+
+    host_bench::CostStats cost;
+    std::vector<int16_t> decoded = streamAll(stream, &cost);
+    uint32_t reads = stream.chunkReads();
+    fclose(f);
+
+    TEST_ASSERT_EQUAL(pcm.size(), decoded.size());
+    float snr = snrDb(pcm, decoded);
+    uint32_t spb = ImaAdpcmStream::samplesPerBlock(BLOCK_BYTES);
+    uint32_t expected_reads = (uint32_t)((pcm.size() + spb - 1) / spb);
+
+    printf("[ADPCM] %zu samples: %zu PCM bytes -> %zu clip bytes (%.2f:1), SNR %.1f dB\n",
+           pcm.size(), pcm.size() * 2, clip.size(), (float)(pcm.size() * 2) / clip.size(), snr);
+    printf("[ADPCM] decoder footprint %zu bytes, %u chunk reads of %u bytes (%u expected)\n",
+           sizeof(ImaAdpcmStream), reads, BLOCK_BYTES, expected_reads);
+    cost.print("ImaAdpcmStream::decode (441 samples)", 1e9 * BLOCK / SAMPLE_RATE);
+
+    host_wav::WavData wav;
+    wav.sample_rate = SAMPLE_RATE;
+    wav.channels = 1;
+    wav.samples = pcm;
+    host_wav::write("test_output/adpcm_source.wav", wav);
+    wav.samples = decoded;
+    host_wav::write("test_output/adpcm_decoded.wav", wav);
+
+    TEST_ASSERT_GREATER_THAN(3.9f, (float)(pcm.size() * 2) / clip.size());
+    TEST_ASSERT_GREATER_THAN(20.0f, snr);
+    TEST_ASSERT_EQUAL_UINT32(expected_reads, reads);
+    TEST_ASSERT_LESS_THAN(ImaAdpcmStream::MAX_BLOCK_BYTES + 128, sizeof(ImaAdpcmStream));
+    TEST_ASSERT_LESS_THAN(0.02 * 1e9 * BLOCK / SAMPLE_RATE, cost.meanNs());
+}
+
+void test_memory_source_matches_file_and_applies_gain(void) {
+    std::vector<int16_t> pcm = renderVoice(0.5f);
+    std::vector<uint8_t> clip = encodeClip(pcm);
+    ImaAdpcmStream::MemorySource mem = {clip.data(), clip.size()};
+
+    static ImaAdpcmStream unity_gain, half_gain, primed;
+    TEST_ASSERT_EQUAL(ImaAdpcmStream::OK, unity_gain.open(ImaAdpcmStream::readMemory, &mem));
+    TEST_ASSERT_EQUAL(ImaAdpcmStream::OK, half_gain.open(ImaAdpcmStream::readMemory, &mem));
+    TEST_ASSERT_EQUAL(ImaAdpcmStream::OK, primed.open(ImaAdpcmStream::readMemory, &mem));
+
+    // Primed on the requester side: the first block-path decode reads nothing
+    TEST_ASSERT_TRUE(primed.prime());
+    TEST_ASSERT_EQUAL_UINT32(1, primed.chunkReads());
+
+    int16_t a[BLOCK], b[BLOCK], c[BLOCK];
+    size_t total = 0;
+    while (!unity_gain.finished()) {
+        size_t na = unity_gain.decode(a, BLOCK);
+        size_t nb = half_gain.decode(b, BLOCK, 128);
+        size_t nc = primed.decode(c, BLOCK);
+        if (total == 0) TEST_ASSERT_EQUAL_UINT32(1, primed.chunkReads());
+        TEST_ASSERT_EQUAL(na, nb);
+        TEST_ASSERT_EQUAL(na, nc);
+        for (size_t i = 0; i < na; i++) TEST_ASSERT_INT_WITHIN(1, a[i] >> 1, b[i]);
+        TEST_ASSERT_EQUAL(0, memcmp(a, c, na * sizeof(int16_t)));
+        total += na;
+    }
+    TEST_ASSERT_EQUAL_UINT32(unity_gain.chunkReads(), primed.chunkReads());
+    TEST_ASSERT_EQUAL(pcm.size(), total);
+    TEST_ASSERT_EQUAL(0, unity_gain.decode(a, BLOCK));
+}
+
+void test_corrupt_block_is_contained(void) {
+    std::vector<int16_t> pcm = renderVoice(0.5f);
+    std::vector<uint8_t> clip = encodeClip(pcm);
+    std::vector<uint8_t> damaged = clip;
+    size_t bad_block = 5;
+    size_t offset = ImaAdpcmStream::HEADER_BYTES + bad_block * BLOCK_BYTES;
+    for (size_t i = 0; i < BLOCK_BYTES; i++) damaged[offset + i] ^= 0x5A;
+
+    ImaAdpcmStream::MemorySource good = {clip.data(), clip.size()};
+    ImaAdpcmStream::MemorySource bad = {damaged.data(), damaged.size()};
+    static ImaAdpcmStream s_good, s_bad;
+    s_good.open(ImaAdpcmStream::readMemory, &good);
+    s_bad.open(ImaAdpcmStream::readMemory, &bad);
+    std::vector<int16_t> ref = streamAll(s_good, nullptr);
+    std::vector<int16_t> out = streamAll(s_bad, nullptr);
+
+    uint32_t spb = ImaAdpcmStream::samplesPerBlock(BLOCK_BYTES);
+    TEST_ASSERT_EQUAL(ref.size(), out.size());
+    for (size_t i = 0; i < ref.size(); i++) {
+        if (i / spb == bad_block) continue;
+        TEST_ASSERT_EQUAL_INT16(ref[i], out[i]);
+    }
+}
+
+void test_rejects_bad_clips_and_ends_truncated_ones(void) {
+    std::vector<int16_t> pcm = renderVoice(0.2f);
+    std::vector<uint8_t> clip = encodeClip(pcm);
+    static ImaAdpcmStream stream;
+
+    std::vector<uint8_t> wrong = clip;
+    wrong[0] = 'X';
+    ImaAdpcmStream::MemorySource src = {wrong.data(), wrong.size()};
+    TEST_ASSERT_EQUAL(ImaAdpcmStream::ERR_FORMAT, stream.open(ImaAdpcmStream::readMemory, &src));
+    TEST_ASSERT_FALSE(stream.isOpen());
+
+    src = {clip.data(), 8};
+    TEST_ASSERT_EQUAL(ImaAdpcmStream::ERR_READ, stream.open(ImaAdpcmStream::readMemory, &src));
+
+    wrong = clip;
+    wrong[12] = 0xFF;
+    wrong[13] = 0xFF;
+    src = {wrong.data(), wrong.size()};
+    TEST_ASSERT_EQUAL(ImaAdpcmStream::ERR_BLOCK_SIZE, stream.open(ImaAdpcmStream::readMemory, &src));
+
+    // Cut mid-clip: plays what is there, then reports finished
+    size_t keep = ImaAdpcmStream::HEADER_BYTES + 3 * BLOCK_BYTES + 10;
+    src = {clip.data(), keep};
+    TEST_ASSERT_EQUAL(ImaAdpcmStream::OK, stream.open(ImaAdpcmStream::readMemory, &src));
+    std::vector<int16_t> out = streamAll(stream, nullptr);
+    TEST_ASSERT_TRUE(stream.finished());
+    TEST_ASSERT_EQUAL(3 * ImaAdpcmStream::samplesPerBlock(BLOCK_BYTES) + 1 + 2 * 6, out.size());
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_file_streaming_round_trip_and_cost);
+    RUN_TEST(test_memory_source_matches_file_and_applies_gain);
+    RUN_TEST(test_corrupt_block_is_contained);
+    RUN_TEST(test_rejects_bad_clips_and_ends_truncated_ones);
+    return UNITY_END();
+}
@@ -0,0 +1,260 @@
+/**
+ * @file test_main.cpp
+ * @brief Arm inverse kinematics (ArmIKSolver)
+ *
+ * Uses the arm geometry and joint limits of p32_arm_controller.hpp
+ * (250 / 200 mm links, 80 mm hand).
+ *
+ * - Forward kinematics: rest pose hangs straight down, flexion raises the
+ *   arm forward, abduction outward
+ * - Closed form: straight-wrist targets solve exactly with no iterations
+ *   and reproduce the target through forward kinematics
+ * - Accuracy sweep: hand positions from random in-limit poses across the
+ *   workspace (straight and bent wrist), solved cold from the rest pose
+ *   and warm from a nearby pose; solutions always respect the limits
+ * - Fast reject: targets beyond reach or inside the elbow shell are
+ *   refused before solving and leave the pose untouched
+ * - Warm-started tracking: a hand following a circle converges in a few
+ *   iterations per step with small joint changes
+ * - Cost: cold and warm solves
+ *
+ * Outputs for inspection (test_output/):
+ *   arm_ik_sweep.csv - target, error_mm, status, iterations per sample
+ *
+ * Run: pio test -e host_test -f test_host_arm_ik
+ */
+
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "config/components/templates/ArmIKSolver.hpp"
+#include "../host_support/host_bench.hpp"
+
+// Same numbers as ARM_JOINT_MIN_ANGLES / ARM_JOINT_MAX_ANGLES
+static const float MIN_DEG[7] = {-90.0f, -180.0f, -90.0f, 0.0f, -90.0f, -180.0f, -45.0f};
+static const float MAX_DEG[7] = {180.0f, 90.0f, 90.0f, 150.0f, 90.0f, 180.0f, 45.0f};
+
+static ArmIKSolver ik;
+
+static float frand(float lo, float hi) {
+    return lo + (hi - lo) * (float)rand() / (float)RAND_MAX;
+}
+
+static void randomPose(float* q, bool bent_wrist) {
+    for (int j = 0; j < 7; j++) q[j] = frand(MIN_DEG[j], MAX_DEG[j]);
+    if (!bent_wrist) q[4] = q[6] = 0.0f;
+}
+
+static void assertWithinLimits(const float* q) {
+    for (int j = 0; j < 7; j++) {
+        TEST_ASSERT_TRUE(q[j] >= MIN_DEG[j] - 1e-3f);
+        TEST_ASSERT_TRUE(q[j] <= MAX_DEG[j] + 1e-3f);
+    }
+}
+
+static float handError(const float* q, float x, float y, float z) {
+    ArmIKSolver::Vec3 h;
+    ik.forward(q, h);
+    return sqrtf((h.x - x) * (h.x - x) + (h.y - y) * (h.y - y) + (h.z - z) * (h.z - z));
+}
+
+void setUp(void) {
+    ik.configure(250.0f, 200.0f, 80.0f);
+    for (uint8_t j = 0; j < 7; j++) ik.setJointLimit(j, MIN_DEG[j], MAX_DEG[j]);
+    srand(40);
+}
+
+void tearDown(void) {}
+
+void test_forward_kinematics(void) {
+    float q[7] = {0};
+    ArmIKSolver::Vec3 h;
+    ik.forward(q, h);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0.0f, h.x);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0.0f, h.y);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, -530.0f, h.z);
+
+    q[0] = 90.0f;                   // Straight forward
+    ik.forward(q, h);
+    TEST_ASSERT_FLOAT_WITHIN(1e-2f, 530.0f, h.x);
+    TEST_ASSERT_FLOAT_WITHIN(1e-2f, 0.0f, h.z);
+
+    q[0] = 0.0f; q[1] = 90.0f;      // Straight out to the side
+    ik.forward(q, h);
+    TEST_ASSERT_FLOAT_WITHIN(1e-2f, 530.0f, h.y);
+
+    q[1] = 0.0f; q[3] = 90.0f;      // Forearm forward from a hanging arm
+    ik.forward(q, h);
+    TEST_ASSERT_FLOAT_WITHIN(1e-2f, 280.0f, h.x);
+    TEST_ASSERT_FLOAT_WITHIN(1e-2f, -250.0f, h.z);
+}
+
+void test_closed_form_exact(void) {
+    int analytic = 0;
+    for (int n = 0; n < 500; n++) {
+        float truth[7];
+        randomPose(truth, false);
+        ArmIKSolver::Vec3 t;
+        ik.forward(truth, t);
+
+        // Seed with the true swivel: the closed form should take it directly
+        float q[7] = {0, 0, truth[2], 0, 0, 0, 0};
+        ArmIKSolver::Result r = ik.solve(t.x, t.y, t.z, q);
+        TEST_ASSERT_TRUE(r.status != ArmIKSolver::IK_UNREACHABLE);
+        assertWithinLimits(q);
+        TEST_ASSERT_TRUE(handError(q, t.x, t.y, t.z) < 0.5f);
+        if (r.status == ArmIKSolver::IK_ANALYTIC) {
+            analytic++;
+            TEST_ASSERT_EQUAL_UINT8(0, r.iterations);
+            TEST_ASSERT_TRUE(handError(q, t.x, t.y, t.z) < 0.05f);
+        }
+    }
+    printf("closed form: %d / 500 solved analytically\n", analytic);
+    TEST_ASSERT_TRUE(analytic > 450);
+}
+
+static void sweep(bool bent_wrist, bool warm, FILE* csv, float& worst, int& misses) {
+    worst = 0.0f;
+    misses = 0;
+    for (int n = 0; n < 2000; n++) {
+        float truth[7];
+        randomPose(truth, bent_wrist);
+        ArmIKSolver::Vec3 t;
+        ik.forward(truth, t);
+
+        float q[7] = {0, 0, 0, 0, truth[4], truth[5], truth[6]};
+        if (warm) {
+            for (int j = 0; j < 4; j++) q[j] = truth[j] + frand(-10.0f, 10.0f);
+        }
+        ArmIKSolver::Result r = ik.solve(t.x, t.y, t.z, q);
+        TEST_ASSERT_TRUE(r.status != ArmIKSolver::IK_UNREACHABLE);
+        assertWithinLimits(q);
+
+        float err = handError(q, t.x, t.y, t.z);
+        TEST_ASSERT_FLOAT_WITHIN(0.01f, r.error_mm, err);
+        if (err > worst) worst = err;
+        if (err > 1.0f) misses++;
+        if (csv) {
+            fprintf(csv, "%d,%d,%.1f,%.1f,%.1f,%.3f,%d,%d\n", bent_wrist, warm,
+                    t.x, t.y, t.z, err, (int)r.status, r.iterations);
+        }
+    }
+}
+
+void test_accuracy_sweep(void) {
+    host_bench::ensureOutputDir();
+    FILE* csv = fopen("test_output/arm_ik_sweep.csv", "w");
+    if (csv) fprintf(csv, "bent_wrist,warm,x,y,z,error_mm,status,iterations\n");
+
+    for (int bent = 0; bent <= 1; bent++) {
+        for (int warm = 0; warm <= 1; warm++) {
+            float worst;
+            int misses;
+            sweep(bent != 0, warm != 0, csv, worst, misses);
+            printf("sweep %-8s %-5s: worst %.2f mm, %d / 2000 over 1 mm\n",
+                   bent ? "bent" : "straight", warm ? "warm" : "cold", worst, misses);
+            // Warm starts must always land; cold starts from the rest pose
+            // may occasionally get stuck against a limit
+            TEST_ASSERT_TRUE(warm ? misses == 0 : misses < 40);
+        }
+    }
+    if (csv) fclose(csv);
+}
+
+void test_fast_reject(void) {
+    float q[7] = {10, 20, 30, 40, 0, 0, 0};
+    ArmIKSolver::Result r = ik.solve(600.0f, 0.0f, 0.0f, q);
+    TEST_ASSERT_EQUAL(ArmIKSolver::IK_UNREACHABLE, r.status);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 70.0f, r.error_mm);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 10.0f, q[0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 40.0f, q[3]);
+
+    // Elbow stops at 150 deg: the hand can't come closer than ~140 mm
+    TEST_ASSERT_FALSE(ik.inReach(0.0f, 0.0f, -120.0f, q));
+    r = ik.solve(0.0f, 0.0f, -120.0f, q);
+    TEST_ASSERT_EQUAL(ArmIKSolver::IK_UNREACHABLE, r.status);
+    TEST_ASSERT_TRUE(ik.inReach(0.0f, 0.0f, -150.0f, q));
+    TEST_ASSERT_TRUE(ik.inReach(0.0f, 0.0f, -529.0f, q));
+}
+
+void test_warm_tracking(void) {
+    // Hand circles in front of the chest
+    float q[7] = {45, 10, 0, 60, 0, 0, 0};
+    int worst_iter = 0;
+    float worst_jump = 0.0f;
+    for (int k = 0; k <= 200; k++) {
+        float a = 2.0f * (float)M_PI * k / 200.0f;
+        float x = 300.0f + 80.0f * cosf(a);
+        float y = 100.0f + 80.0f * sinf(a);
+        float z = -150.0f;
+        float prev[7];
+        for (int j = 0; j < 7; j++) prev[j] = q[j];
+        ArmIKSolver::Result r = ik.solve(x, y, z, q);
+        TEST_ASSERT_TRUE(r.status == ArmIKSolver::IK_ANALYTIC || r.status == ArmIKSolver::IK_CONVERGED);
+        TEST_ASSERT_TRUE(handError(q, x, y, z) < 0.5f);
+        if (k > 0) {
+            if (r.iterations > worst_iter) worst_iter = r.iterations;
+            for (int j = 0; j < 4; j++) {
+                float jump = fabsf(q[j] - prev[j]);
+                if (jump > worst_jump) worst_jump = jump;
+            }
+        }
+    }
+    printf("tracking: worst %d iterations, worst joint step %.2f deg\n", worst_iter, worst_jump);
+    TEST_ASSERT_TRUE(worst_iter <= 3);
+    TEST_ASSERT_TRUE(worst_jump < 5.0f);
+
+    // Same circle with the wrist cocked: no closed form, DLS from warm starts
+    float qb[7] = {45, 10, 0, 60, 30, 0, 15};
+    worst_iter = 0;
+    for (int k = 0; k <= 200; k++) {
+        float a = 2.0f * (float)M_PI * k / 200.0f;
+        float x = 300.0f + 80.0f * cosf(a);
+        float y = 100.0f + 80.0f * sinf(a);
+        ArmIKSolver::Result r = ik.solve(x, y, -150.0f, qb);
+        TEST_ASSERT_EQUAL(ArmIKSolver::IK_CONVERGED, r.status);
+        TEST_ASSERT_FLOAT_WITHIN(1e-3f, 30.0f, qb[4]);
+        if (k > 0 && r.iterations > worst_iter) worst_iter = r.iterations;
+    }
+    printf("tracking, bent wrist: worst %d iterations\n", worst_iter);
+    TEST_ASSERT_TRUE(worst_iter <= 3);
+}
+
+void test_cost(void) {
+    host_bench::CostStats cold, warm;
+    volatile float sink = 0.0f;
+    for (int n = 0; n < 20000; n++) {
+        float truth[7];
+        randomPose(truth, true);
+        ArmIKSolver::Vec3 t;
+        ik.forward(truth, t);
+
+        float q[7] = {0, 0, 0, 0, truth[4], truth[5], truth[6]};
+        uint64_t t0 = host_bench::nowNs();
+        ik.solve(t.x, t.y, t.z, q);
+        cold.add(host_bench::nowNs() - t0);
+        sink += q[0];
+
+        for (int j = 0; j < 4; j++) q[j] = truth[j] + 2.0f;
+        t0 = host_bench::nowNs();
+        ik.solve(t.x, t.y, t.z, q);
+        warm.add(host_bench::nowNs() - t0);
+        sink += q[0];
+    }
+    cold.print("ArmIKSolver::solve() cold, bent wrist", 1000000.0);
+    warm.print("ArmIKSolver::solve() warm, bent wrist", 1000000.0);
+    (void)sink;
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_forward_kinematics);
+    RUN_TEST(test_closed_form_exact);
+    RUN_TEST(test_accuracy_sweep);
+    RUN_TEST(test_fast_reject);
+    RUN_TEST(test_warm_tracking);
+    RUN_TEST(test_cost);
+    return UNITY_END();
+}
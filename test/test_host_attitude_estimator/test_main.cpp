@@ -0,0 +1,299 @@
+/**
+ * @file test_main.cpp
+ * @brief Host replay of synthetic IMU/baro traces through AttitudeEstimator + BaroAltitudeFilter
+ *
+ * Traces are generated from a known trajectory at the flying_dragon rates
+ * (ICM20689 1 kHz, BMP390 50 Hz) with gyro bias, sensor noise, wing-beat
+ * vibration and thrust pulses, then replayed through the estimators.
+ *
+ * Outputs for inspection (test_output/):
+ *   attitude_estimator.csv - t, true/estimated roll, pitch, yaw, altitude, vertical speed
+ *
+ * Run: pio test -e host_test -f test_host_attitude_estimator
+ */
+
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "config/components/templates/AttitudeEstimator.hpp"
+#include "config/components/templates/BaroAltitudeFilter.hpp"
+#include "../host_support/host_bench.hpp"
+
+static const float G = 9.80665f;
+static const float DEG = 3.14159265f / 180.0f;
+static const uint32_t IMU_HZ = 1000;
+static const uint32_t BARO_DIV = 20;           // 50 Hz
+
+static uint32_t rng_state = 99;
+static float gauss() {
+    // Sum of uniforms: cheap, deterministic, close enough to normal
+    float s = 0.0f;
+    for (int i = 0; i < 4; i++) {
+        rng_state = rng_state * 1664525u + 1013904223u;
+        s += (float)(rng_state >> 8) / 16777216.0f;
+    }
+    return (s - 2.0f) * 1.7320508f;
+}
+
+struct Truth {
+    float roll, pitch, yaw;         // rad
+    float p, q, r;                  // body rates rad/s
+    float alt, vz, az_up;           // m, m/s, m/s^2
+};
+
+/**
+ * Flight: 0-3 s resting on a 12 deg slope (roll), 3-6 s level hover climb,
+ * 6-20 s banking / pitching manoeuvres with yaw turns, climbing to 10 m and back
+ */
+static Truth trajectory(float t) {
+    Truth s;
+    if (t < 3.0f) {
+        s.roll = 12.0f * DEG;
+        s.pitch = -5.0f * DEG;
+        s.yaw = 0.0f;
+    } else {
+        float u = t - 3.0f;
+        float ramp = u < 3.0f ? u / 3.0f : 1.0f;
+        s.roll = (12.0f * DEG) * (1.0f - ramp) + ramp * 25.0f * DEG * sinf(0.7f * u);
+        s.pitch = (-5.0f * DEG) * (1.0f - ramp) + ramp * 15.0f * DEG * sinf(0.45f * u + 0.5f);
+        s.yaw = 0.4f * u;
+    }
+    // Altitude: smooth climb to 10 m between 3 s and 13 s, descent to 2 m by 20 s
+    if (t < 3.0f) {
+        s.alt = 0.0f; s.vz = 0.0f; s.az_up = 0.0f;
+    } else if (t < 13.0f) {
+        float u = (t - 3.0f) / 10.0f;
+        s.alt = 10.0f * (u - sinf(6.2831853f * u) / 6.2831853f);
+        s.vz = 1.0f * (1.0f - cosf(6.2831853f * u));
+        s.az_up = 0.6283185f * sinf(6.2831853f * u);
+    } else {
+        float u = (t - 13.0f) / 7.0f;
+        if (u > 1.0f) u = 1.0f;
+        s.alt = 10.0f - 8.0f * (u - sinf(6.2831853f * u) / 6.2831853f);
+        s.vz = -8.0f / 7.0f * (1.0f - cosf(6.2831853f * u));
+        s.az_up = -8.0f / 49.0f * 6.2831853f * sinf(6.2831853f * u);
+        if (t >= 20.0f) { s.vz = 0.0f; s.az_up = 0.0f; }
+    }
+    return s;
+}
+
+static void eulerRates(float t, Truth& s) {
+    // Body rates from numeric Euler derivatives (ZYX)
+    const float h = 1e-4f;
+    Truth a = trajectory(t - h), b = trajectory(t + h);
+    float droll = (b.roll - a.roll) / (2 * h), dpitch = (b.pitch - a.pitch) / (2 * h), dyaw = (b.yaw - a.yaw) / (2 * h);
+    float sr = sinf(s.roll), cr = cosf(s.roll), sp = sinf(s.pitch), cp = cosf(s.pitch);
+    s.p = droll - sp * dyaw;
+    s.q = cr * dpitch + sr * cp * dyaw;
+    s.r = -sr * dpitch + cr * cp * dyaw;
+}
+
+/** Earth-frame up vector (0,0,1) seen in body frame, ZYX */
+static void upInBody(const Truth& s, float& x, float& y, float& z) {
+    x = -sinf(s.pitch);
+    y = sinf(s.roll) * cosf(s.pitch);
+    z = cosf(s.roll) * cosf(s.pitch);
+}
+
+static float wrapPi(float a) {
+    while (a > 3.14159265f) a -= 6.2831853f;
+    while (a < -3.14159265f) a += 6.2831853f;
+    return a;
+}
+
+struct RunResult {
+    float converge_s;           // First time roll/pitch error < 2 deg and stays
+    float rp_rms_deg;           // Roll/pitch RMS after convergence
+    float rp_max_deg;
+    float yaw_drift_deg;        // At the end
+    float alt_rms_m;
+    float baro_rms_m;           // Raw baro error for comparison
+    float vz_rms;
+    float bias_err_dps;
+};
+
+static RunResult runTrace(bool init_from_accel, bool vibration, host_bench::CostStats* cost, const char* csv_path) {
+    AttitudeEstimator ahrs;
+    BaroAltitudeFilter alt;
+    const float bias[3] = {1.5f * DEG, -0.8f * DEG, 0.6f * DEG};
+    const float dt = 1.0f / IMU_HZ;
+    const float ground_pa = 100800.0f;
+    alt.setGround(ground_pa);
+
+    FILE* csv = csv_path ? fopen(csv_path, "w") : nullptr;
+    if (csv) fprintf(csv, "t,roll,roll_est,pitch,pitch_est,yaw,yaw_est,alt,alt_est,baro,vz,vz_est\n");
+
+    RunResult res = {-1.0f, 0, 0, 0, 0, 0, 0, 0};
+    double rp_sq = 0.0, alt_sq = 0.0, baro_sq = 0.0, vz_sq = 0.0;
+    uint32_t rp_n = 0, alt_n = 0, baro_n = 0;
+    float last_bad = 0.0f;
+    float baro_alt = 0.0f;
+    const uint32_t steps = 22 * IMU_HZ;
+
+    for (uint32_t i = 0; i < steps; i++) {
+        float t = i * dt;
+        Truth s = trajectory(t);
+        eulerRates(t, s);
+
+        float ux, uy, uz;
+        upInBody(s, ux, uy, uz);
+        // Specific force: gravity reaction + vertical acceleration, both along earth up
+        float f = G + s.az_up;
+        float ax = ux * f, ay = uy * f, az = uz * f;
+        float gx = s.p + bias[0], gy = s.q + bias[1], gz = s.r + bias[2];
+        // Sensor noise (ICM20689 class) + wing-beat vibration and thrust pulses in flight
+        ax += 0.05f * gauss(); ay += 0.05f * gauss(); az += 0.05f * gauss();
+        gx += 0.003f * gauss(); gy += 0.003f * gauss(); gz += 0.003f * gauss();
+        if (vibration && t > 3.0f) {
+            float beat = sinf(6.2831853f * 23.0f * t);
+            az += 3.0f * beat;
+            ax += 1.0f * beat;
+            gx += 0.05f * beat;
+            // Wing downstroke / recovery pulse pair: no net velocity change
+            float phase = fmodf(t, 1.7f);
+            if (phase < 0.15f) az += 6.0f;
+            else if (phase < 0.3f) az -= 6.0f;
+        }
+
+        if (i == 0 && init_from_accel) ahrs.initFromAccel(ax, ay, az);
+
+        uint64_t t0 = host_bench::nowNs();
+        ahrs.update(gx, gy, gz, ax, ay, az, dt);
+        alt.predict(ahrs.verticalAccel(ax, ay, az, G), dt);
+        if (cost) cost->add(host_bench::nowNs() - t0);
+
+        if (i % BARO_DIV == 0) {
+            // BMP390: ~0.35 m RMS noise after its IIR, pressure from the true altitude
+            float true_p = ground_pa * powf(1.0f - s.alt / 44330.0f, 1.0f / 0.190295f);
+            float p = true_p + 4.0f * gauss();
+            baro_alt = BaroAltitudeFilter::pressureToAltitude(p, ground_pa);
+            alt.correct(baro_alt);
+            if (t > 5.0f) {
+                baro_sq += (baro_alt - s.alt) * (baro_alt - s.alt);
+                baro_n++;
+            }
+        }
+
+        float er = fabsf(wrapPi(ahrs.roll() - s.roll)) / DEG;
+        float ep = fabsf(wrapPi(ahrs.pitch() - s.pitch)) / DEG;
+        float e = er > ep ? er : ep;
+        if (e >= 2.0f) last_bad = t;
+        if (t > 5.0f) {
+            rp_sq += er * er + ep * ep;
+            rp_n += 2;
+            if (e > res.rp_max_deg) res.rp_max_deg = e;
+            alt_sq += (alt.altitude() - s.alt) * (alt.altitude() - s.alt);
+            vz_sq += (alt.verticalSpeed() - s.vz) * (alt.verticalSpeed() - s.vz);
+            alt_n++;
+        }
+        if (csv && i % 10 == 0) {
+            fprintf(csv, "%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.3f,%.3f,%.3f,%.3f,%.3f\n", t, s.roll / DEG,
+                    ahrs.roll() / DEG, s.pitch / DEG, ahrs.pitch() / DEG, wrapPi(s.yaw) / DEG, ahrs.yaw() / DEG, s.alt,
+                    alt.altitude(), baro_alt, s.vz, alt.verticalSpeed());
+        }
+        if (i == steps - 1) res.yaw_drift_deg = fabsf(wrapPi(ahrs.yaw() - s.yaw)) / DEG;
+    }
+    if (csv) fclose(csv);
+
+    res.converge_s = last_bad + dt;
+    res.rp_rms_deg = (float)sqrt(rp_sq / rp_n);
+    res.alt_rms_m = (float)sqrt(alt_sq / alt_n);
+    res.baro_rms_m = (float)sqrt(baro_sq / baro_n);
+    res.vz_rms = (float)sqrt(vz_sq / alt_n);
+    float bx = ahrs.biasX() - bias[0], by = ahrs.biasY() - bias[1];
+    res.bias_err_dps = sqrtf(bx * bx + by * by) / DEG;
+    return res;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_converges_from_cold_start(void) {
+    // Identity start on a 12 deg slope: the boosted gain must pull it in
+    RunResult r = runTrace(false, false, nullptr, nullptr);
+    printf("[AHRS] cold start: converged (<2 deg) at %.2f s, then RMS %.2f deg, max %.2f deg\n", r.converge_s,
+           r.rp_rms_deg, r.rp_max_deg);
+    TEST_ASSERT_LESS_THAN(1.0f, r.converge_s);
+
+    RunResult a = runTrace(true, false, nullptr, nullptr);
+    printf("[AHRS] accel init: converged at %.3f s\n", a.converge_s);
+    TEST_ASSERT_LESS_THAN(0.05f, a.converge_s);
+}
+
+void test_tracks_manoeuvres_with_vibration(void) {
+    host_bench::ensureOutputDir();
+    host_bench::CostStats cost;
+    RunResult r = runTrace(true, true, &cost, "test_output/attitude_estimator.csv");
+    printf("[AHRS] manoeuvres + 23 Hz wing beat: roll/pitch RMS %.2f deg, max %.2f deg, yaw drift %.1f deg\n",
+           r.rp_rms_deg, r.rp_max_deg, r.yaw_drift_deg);
+    printf("[AHRS] gyro bias error after 22 s: %.3f deg/s (roll/pitch axes)\n", r.bias_err_dps);
+    printf("[ALT]  baro raw RMS %.2f m -> fused RMS %.2f m, vertical speed RMS %.2f m/s\n", r.baro_rms_m,
+           r.alt_rms_m, r.vz_rms);
+    cost.print("AHRS + altitude per IMU sample", 1e9 / IMU_HZ);
+
+    TEST_ASSERT_LESS_THAN(1.5f, r.rp_rms_deg);
+    TEST_ASSERT_LESS_THAN(4.0f, r.rp_max_deg);
+    TEST_ASSERT_LESS_THAN(0.5f, r.bias_err_dps);
+    TEST_ASSERT_LESS_THAN(r.baro_rms_m * 0.6f, r.alt_rms_m);
+    TEST_ASSERT_LESS_THAN(0.3f, r.vz_rms);
+}
+
+void test_magnetometer_holds_yaw(void) {
+    AttitudeEstimator ahrs;
+    const float dt = 1.0f / IMU_HZ;
+    const float gz_bias = 0.6f * DEG;
+    // Level, pointing north; field 60 deg dip
+    float mx = cosf(60.0f * DEG), my = 0.0f, mz = -sinf(60.0f * DEG);
+    ahrs.initFromAccel(0.0f, 0.0f, G);
+    for (uint32_t i = 0; i < 60 * IMU_HZ; i++) {
+        ahrs.updateMag(0.003f * gauss(), 0.003f * gauss(), gz_bias + 0.003f * gauss(), 0.05f * gauss(),
+                       0.05f * gauss(), G + 0.05f * gauss(), mx, my, mz, dt);
+    }
+    float with_mag = fabsf(ahrs.yaw()) / DEG;
+
+    AttitudeEstimator gyro_only;
+    gyro_only.initFromAccel(0.0f, 0.0f, G);
+    for (uint32_t i = 0; i < 60 * IMU_HZ; i++) {
+        gyro_only.update(0.0f, 0.0f, gz_bias, 0.0f, 0.0f, G, dt);
+    }
+    float without = fabsf(gyro_only.yaw()) / DEG;
+    printf("[AHRS] 60 s with 0.6 deg/s z-bias: yaw error %.2f deg with magnetometer, %.1f deg without\n", with_mag,
+           without);
+    TEST_ASSERT_LESS_THAN(2.0f, with_mag);
+    TEST_ASSERT_GREATER_THAN(20.0f, without);
+}
+
+void test_update_cost_headroom(void) {
+    AttitudeEstimator ahrs;
+    BaroAltitudeFilter alt;
+    host_bench::CostStats cost;
+    volatile float sink = 0.0f;
+    const int N = 200000;
+    uint64_t t0 = host_bench::nowNs();
+    for (int i = 0; i < N; i++) {
+        float w = 0.001f * (i & 63);
+        ahrs.update(w, -w, 0.5f * w, 0.1f, -0.2f, 9.8f, 0.001f);
+        alt.predict(ahrs.verticalAccel(0.1f, -0.2f, 9.8f, 9.80665f), 0.001f);
+        if (i % 20 == 0) alt.correct(0.0f);
+    }
+    uint64_t total = host_bench::nowNs() - t0;
+    sink = ahrs.roll() + alt.altitude();
+    (void)sink;
+    double ns = (double)total / N;
+    // Flop count is fixed, so the host ratio carries over: report the share of a 1 kHz slot
+    printf("[AHRS] %.1f ns per update on host = %.3f%% of the 1 kHz loop; headroom x%.0f\n", ns,
+           100.0 * ns / 1e6, 1e6 / ns);
+    printf("[AHRS] target check: flying_dragon_sensor_fusion logs esp_cpu cycles per update\n");
+    TEST_ASSERT_LESS_THAN(2000.0, ns);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_converges_from_cold_start);
+    RUN_TEST(test_tracks_manoeuvres_with_vibration);
+    RUN_TEST(test_magnetometer_holds_yaw);
+    RUN_TEST(test_update_cost_headroom);
+    return UNITY_END();
+}
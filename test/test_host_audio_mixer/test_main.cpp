@@ -0,0 +1,309 @@
+/**
+ * @file test_main.cpp
+ * @brief Host tests of AudioMixer: preemption, ducking, dedupe, admission preview, lock-free queue
+ *
+ * Voices are plain tone generators so every gain and voice decision can be
+ * checked exactly. The ducking scenario is also written out for listening.
+ *
+ * Outputs for inspection (test_output/):
+ *   audio_mixer_ducking.wav  - ambient hum ducked under an alert, then restored
+ *
+ * Run: pio test -e host_test -f test_host_audio_mixer
+ */
+
+#include <unity.h>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "config/components/templates/AudioMixer.hpp"
+#include "../host_support/wav_io.hpp"
+#include "../host_support/host_bench.hpp"
+
+static const uint32_t SAMPLE_RATE = 44100;
+static const size_t BLOCK = 441;
+
+struct ToneVoice {
+    struct Request {
+        float frequency_hz;     // 0 = DC at level (for exact gain checks)
+        int16_t level;
+        uint32_t samples;       // 0 = until stopped
+        bool fail;              // start() refuses, like a missing clip
+    };
+
+    Request req;
+    uint32_t pos;
+
+    bool start(const Request& r) {
+        req = r;
+        pos = 0;
+        return !r.fail;
+    }
+
+    size_t render(int16_t* out, size_t count) {
+        size_t n = 0;
+        for (; n < count; n++) {
+            if (req.samples && pos >= req.samples) break;
+            float v = req.frequency_hz > 0.0f ? sinf(6.2831853f * req.frequency_hz * pos / SAMPLE_RATE) : 1.0f;
+            out[n] = (int16_t)(v * req.level);
+            pos++;
+        }
+        return n;
+    }
+
+    void stop() {}
+
+    static uint32_t discarded;
+    static void discard(const Request&) { discarded++; }
+};
+
+uint32_t ToneVoice::discarded = 0;
+
+typedef AudioMixer<ToneVoice, 3, 16> TestMixer;
+
+static ToneVoice::Request tone(float hz, int16_t level, uint32_t ms = 0) {
+    ToneVoice::Request r = {hz, level, ms * (SAMPLE_RATE / 1000), false};
+    return r;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_priority_preemption_and_rejection(void) {
+    static TestMixer mixer;
+    int16_t out[BLOCK];
+    uint32_t ambient = TestMixer::hashName("idle_breathing");
+    uint32_t growl = TestMixer::hashName("goblin_growl_low");
+    uint32_t snarl = TestMixer::hashName("goblin_snarl");
+    uint32_t alert = TestMixer::hashName("proximity_close");
+    uint32_t hum = TestMixer::hashName("background_hum");
+
+    mixer.play(ambient, 10, 256, tone(80, 3000));
+    mixer.play(growl, 50, 256, tone(120, 3000));
+    mixer.play(snarl, 50, 256, tone(250, 3000));
+    mixer.mix(out, BLOCK, 0);
+    TEST_ASSERT_EQUAL(3, mixer.activeVoices());
+
+    // All voices busy: an alert steals the least important one
+    mixer.play(alert, 90, 256, tone(1000, 3000));
+    mixer.mix(out, BLOCK, 10);
+    TEST_ASSERT_TRUE(mixer.isPlaying(alert));
+    TEST_ASSERT_FALSE(mixer.isPlaying(ambient));
+    TEST_ASSERT_EQUAL(1, mixer.getStats().preempted);
+
+    // Nothing left below priority 50: background request is refused and handed back
+    uint32_t discarded_before = ToneVoice::discarded;
+    mixer.play(hum, 5, 256, tone(60, 3000));
+    mixer.mix(out, BLOCK, 20);
+    TEST_ASSERT_FALSE(mixer.isPlaying(hum));
+    TEST_ASSERT_EQUAL(1, mixer.getStats().rejected);
+    TEST_ASSERT_EQUAL_UINT32(1, ToneVoice::discarded - discarded_before);
+
+    // Equal priority takes the oldest of its class
+    uint32_t question = TestMixer::hashName("goblin_question");
+    mixer.play(question, 50, 256, tone(300, 3000));
+    mixer.mix(out, BLOCK, 30);
+    TEST_ASSERT_TRUE(mixer.isPlaying(question));
+    TEST_ASSERT_FALSE(mixer.isPlaying(growl));
+    TEST_ASSERT_TRUE(mixer.isPlaying(snarl));
+
+    // Unplayable request (missing clip) leaves the slot free
+    mixer.stopAll();
+    ToneVoice::Request bad = tone(0, 0);
+    bad.fail = true;
+    mixer.play(hum, 50, 256, bad);
+    mixer.mix(out, BLOCK, 40);
+    TEST_ASSERT_EQUAL(0, mixer.activeVoices());
+    TEST_ASSERT_EQUAL(1, mixer.getStats().unplayable);
+}
+
+void test_ducking_ramps_and_restores(void) {
+    static TestMixer mixer;
+    mixer.configure(64, 250);   // Duck to 1/4
+    int16_t out[BLOCK];
+    uint32_t hum = TestMixer::hashName("hum");
+    uint32_t alert = TestMixer::hashName("alert");
+
+    host_wav::WavData wav;
+    wav.sample_rate = SAMPLE_RATE;
+    wav.channels = 1;
+
+    // DC voices: the mix value is exactly level * gain / 256
+    mixer.play(hum, 10, 256, tone(0, 8000));
+    for (int b = 0; b < 3; b++) mixer.mix(out, BLOCK, b * 10);
+    TEST_ASSERT_INT_WITHIN(40, 8000, out[BLOCK - 1]);
+
+    mixer.play(alert, 90, 256, tone(0, 8000, 200));
+    mixer.mix(out, BLOCK, 30);
+    // First block after the alert: hum ramps 256 -> 64 and alert fades in, no steps
+    int max_step = 0;
+    for (size_t i = 1; i < BLOCK; i++) {
+        int step = abs(out[i] - out[i - 1]);
+        if (step > max_step) max_step = step;
+    }
+    TEST_ASSERT_LESS_THAN(100, max_step);
+    TEST_ASSERT_EQUAL(64, mixer.voiceGain(hum));
+    mixer.mix(out, BLOCK, 40);
+    TEST_ASSERT_INT_WITHIN(60, 8000 + 2000, out[BLOCK / 2]);
+
+    // Alert ends after 200 ms: hum comes back up
+    for (int b = 5; b < 30; b++) mixer.mix(out, BLOCK, b * 10);
+    TEST_ASSERT_FALSE(mixer.isPlaying(alert));
+    TEST_ASSERT_EQUAL(256, mixer.voiceGain(hum));
+    TEST_ASSERT_INT_WITHIN(40, 8000, out[BLOCK - 1]);
+
+    // Audible version of the same scenario
+    static TestMixer listen;
+    listen.configure(64, 250);
+    listen.play(hum, 10, 256, tone(110, 9000));
+    for (int b = 0; b < 150; b++) {
+        if (b == 50) listen.play(alert, 90, 256, tone(880, 9000, 500));
+        listen.mix(out, BLOCK, b * 10);
+        wav.samples.insert(wav.samples.end(), out, out + BLOCK);
+    }
+    host_bench::ensureOutputDir();
+    TEST_ASSERT_TRUE(host_wav::write("test_output/audio_mixer_ducking.wav", wav));
+}
+
+void test_rapid_retriggers_are_deduplicated(void) {
+    static TestMixer mixer;
+    mixer.configure(77, 300);
+    int16_t out[BLOCK];
+    uint32_t nose = TestMixer::hashName("goblin_emotional_surprised");
+    uint32_t discarded_before = ToneVoice::discarded;
+
+    // Nose fires on every reading for 200 ms (2 requests per block)
+    for (int b = 0; b < 20; b++) {
+        mixer.play(nose, 50, 256, tone(500, 6000, 1000));
+        mixer.play(nose, 50, 256, tone(500, 6000, 1000));
+        mixer.mix(out, BLOCK, b * 10);
+    }
+    TEST_ASSERT_EQUAL(1, mixer.getStats().started);
+    TEST_ASSERT_EQUAL(39, mixer.getStats().deduped);
+    TEST_ASSERT_EQUAL_UINT32(39, ToneVoice::discarded - discarded_before);
+    TEST_ASSERT_EQUAL(1, mixer.activeVoices());
+
+    // Outside the window it restarts in place instead of stacking voices
+    mixer.play(nose, 50, 256, tone(500, 6000, 1000));
+    mixer.mix(out, BLOCK, 400);
+    TEST_ASSERT_EQUAL(2, mixer.getStats().started);
+    TEST_ASSERT_EQUAL(1, mixer.activeVoices());
+}
+
+void test_admits_matches_what_mix_would_do(void) {
+    static TestMixer mixer;
+    mixer.configure(77, 300);
+    int16_t out[BLOCK];
+    uint32_t nose = TestMixer::hashName("goblin_emotional_surprised");
+    uint32_t growl = TestMixer::hashName("goblin_growl_low");
+    uint32_t snarl = TestMixer::hashName("goblin_snarl");
+    uint32_t hum = TestMixer::hashName("background_hum");
+
+    // Empty mixer admits anything; a queued but unmixed PLAY is not seen yet
+    TEST_ASSERT_TRUE(mixer.admits(nose, 50, 0));
+    mixer.play(nose, 50, 256, tone(500, 6000, 2000));
+    TEST_ASSERT_TRUE(mixer.admits(nose, 50, 0));
+    mixer.mix(out, BLOCK, 0);
+
+    // Retrigger window, then restart in place
+    TEST_ASSERT_FALSE(mixer.admits(nose, 50, 100));
+    TEST_ASSERT_TRUE(mixer.admits(nose, 50, 400));
+
+    // All voices busy at 50: lower priority would be rejected, equal would steal
+    mixer.play(growl, 50, 256, tone(120, 3000));
+    mixer.play(snarl, 50, 256, tone(250, 3000));
+    mixer.mix(out, BLOCK, 10);
+    TEST_ASSERT_EQUAL(3, mixer.activeVoices());
+    TEST_ASSERT_FALSE(mixer.admits(hum, 10, 20));
+    TEST_ASSERT_TRUE(mixer.admits(hum, 50, 20));
+
+    // Preview and mixer agree on the refusal
+    uint32_t rejected_before = mixer.getStats().rejected;
+    mixer.play(hum, 10, 256, tone(60, 3000));
+    mixer.mix(out, BLOCK, 20);
+    TEST_ASSERT_EQUAL(rejected_before + 1, mixer.getStats().rejected);
+
+    mixer.stopAll();
+    mixer.mix(out, BLOCK, 30);
+    TEST_ASSERT_TRUE(mixer.admits(hum, 10, 40));
+}
+
+void test_concurrent_producers_never_block_or_lose_accounting(void) {
+    static TestMixer mixer;
+    mixer.configure(77, 50);
+    const int producers = 4;
+    const int per_producer = 5000;
+    std::atomic<uint32_t> accepted{0};
+    std::atomic<bool> done{false};
+
+    host_bench::CostStats mix_cost;
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&, p]() {
+            for (int i = 0; i < per_producer; i++) {
+                uint32_t id = (uint32_t)(p * 7 + (i % 5));
+                if (mixer.play(id, (uint8_t)(i % 100), 256, tone(200 + 50 * p, 2000, 30))) {
+                    accepted.fetch_add(1);
+                }
+                if (i % 4 == 0) std::this_thread::yield();
+            }
+        });
+    }
+
+    int16_t out[BLOCK];
+    uint32_t now = 0;
+    while (!done.load()) {
+        uint64_t t0 = host_bench::nowNs();
+        mixer.mix(out, BLOCK, now);
+        mix_cost.add(host_bench::nowNs() - t0);
+        now += 10;
+        if (accepted.load() + mixer.queueFullCount() >= (uint32_t)(producers * per_producer)) done.store(true);
+    }
+    for (auto& t : threads) t.join();
+    // Drain what is left
+    for (int i = 0; i < 4; i++) mixer.mix(out, BLOCK, now += 10);
+
+    const TestMixer::Stats& st = mixer.getStats();
+    uint32_t applied = st.started + st.deduped + st.rejected + st.unplayable;
+    printf("[MIXER] %u accepted, %u queue-full drops; started %u, deduped %u, preempted %u, rejected %u\n",
+           accepted.load(), mixer.queueFullCount(), st.started, st.deduped, st.preempted, st.rejected);
+    printf("[MIXER] max %u commands drained per block\n", st.max_commands);
+    mix_cost.print("AudioMixer::mix (3 voices, 441)", 1e9 * BLOCK / SAMPLE_RATE);
+
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)(producers * per_producer), accepted.load() + mixer.queueFullCount());
+    TEST_ASSERT_EQUAL_UINT32(accepted.load(), applied);
+    TEST_ASSERT_LESS_OR_EQUAL(16, st.max_commands);
+}
+
+void test_mix_cost_is_bounded(void) {
+    static TestMixer mixer;
+    int16_t out[BLOCK];
+    host_bench::CostStats cost;
+    for (int b = 0; b < 2000; b++) {
+        // Worst case every block: full queue, all voices busy, preemption churn
+        for (int i = 0; i < 16; i++) {
+            mixer.play(TestMixer::hashName(i & 1 ? "a" : "b") + (uint32_t)(b * 16 + i), (uint8_t)(i * 16), 256,
+                       tone(300 + i, 4000));
+        }
+        uint64_t t0 = host_bench::nowNs();
+        mixer.mix(out, BLOCK, (uint32_t)b * 10);
+        cost.add(host_bench::nowNs() - t0);
+    }
+    cost.print("AudioMixer::mix worst-case load", 1e9 * BLOCK / SAMPLE_RATE);
+    TEST_ASSERT_EQUAL(3, mixer.activeVoices());
+    TEST_ASSERT_LESS_THAN(0.05 * 1e9 * BLOCK / SAMPLE_RATE, cost.meanNs());
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_priority_preemption_and_rejection);
+    RUN_TEST(test_ducking_ramps_and_restores);
+    RUN_TEST(test_rapid_retriggers_are_deduplicated);
+    RUN_TEST(test_admits_matches_what_mix_would_do);
+    RUN_TEST(test_concurrent_producers_never_block_or_lose_accounting);
+    RUN_TEST(test_mix_cost_is_bounded);
+    return UNITY_END();
+}
@@ -0,0 +1,125 @@
+// Auto-generated by tools/generate_tables.py from config/bots/bot_families/dragons/flying_dragon_behavior_sequencer.json - do not edit
+// Behavior tables for flying_dragon_behavior_sequencer
+#pragma once
+
+#include <cstdint>
+#include "config/components/templates/BehaviorMachine.hpp"
+
+namespace flying_dragon_behavior_sequencer_behavior {
+
+enum State : uint8_t {
+    STATE_IDLE = 0,
+    STATE_ALERT = 1,
+    STATE_EXPLORATION = 2,
+    STATE_PLAY = 3,
+    STATE_AGGRESSION = 4,
+    STATE_SLEEP = 5,
+    STATE_FLIGHT_MODE = 6,
+    STATE_COUNT
+};
+
+enum Fact : uint8_t {
+    FACT_PRESENCE = 0,
+    FACT_ATTENTION = 1,
+    FACT_PROXIMITY_CM = 2,
+    FACT_ANGER = 3,
+    FACT_FEAR = 4,
+    FACT_HAPPINESS = 5,
+    FACT_CURIOSITY = 6,
+    FACT_EXCITEMENT = 7,
+    FACT_POWER_LEVEL = 8,
+    FACT_ARMED = 9,
+    FACT_ALTITUDE_DM = 10,
+    FACT_COUNT
+};
+
+enum Output : uint8_t {
+    OUT_INTENSITY = 0,
+    OUT_WING_BEAT_HZ_X10 = 1,
+    OUT_MAX_BANK_DEG = 2,
+    OUT_FLIGHT_REQUEST = 3,
+    OUTPUT_COUNT
+};
+
+static const BehaviorMachine::Guard guards[] = {
+    {FACT_POWER_LEVEL, BehaviorMachine::OP_GE, 3},
+    {FACT_PRESENCE, BehaviorMachine::OP_GE, 100},
+    {FACT_CURIOSITY, BehaviorMachine::OP_GE, 40},
+    {FACT_POWER_LEVEL, BehaviorMachine::OP_LE, 1},
+    {FACT_PRESENCE, BehaviorMachine::OP_LT, 20},
+    {FACT_ANGER, BehaviorMachine::OP_GE, 64},
+    {FACT_ATTENTION, BehaviorMachine::OP_GE, 150},
+    {FACT_HAPPINESS, BehaviorMachine::OP_GE, 24},
+    {FACT_PRESENCE, BehaviorMachine::OP_LT, 40},
+    {FACT_EXCITEMENT, BehaviorMachine::OP_GE, 60},
+    {FACT_POWER_LEVEL, BehaviorMachine::OP_EQ, 0},
+    {FACT_ANGER, BehaviorMachine::OP_LT, 24},
+    {FACT_PRESENCE, BehaviorMachine::OP_GE, 160},
+    {FACT_POWER_LEVEL, BehaviorMachine::OP_LE, 2},
+    {FACT_POWER_LEVEL, BehaviorMachine::OP_LE, 1},
+    {FACT_PRESENCE, BehaviorMachine::OP_GE, 20},
+    {FACT_ARMED, BehaviorMachine::OP_EQ, 0},
+    {FACT_ALTITUDE_DM, BehaviorMachine::OP_LE, 2},
+    {FACT_POWER_LEVEL, BehaviorMachine::OP_GE, 2},
+};
+
+static const BehaviorMachine::Transition transitions[] = {
+    {0, 1, STATE_SLEEP, 2000},  // IDLE -> SLEEP
+    {1, 1, STATE_ALERT, 200},  // IDLE -> ALERT
+    {2, 2, STATE_EXPLORATION, 3000},  // IDLE -> EXPLORATION
+    {4, 1, STATE_SLEEP, 60000},  // IDLE -> SLEEP
+    {0, 1, STATE_SLEEP, 2000},  // ALERT -> SLEEP
+    {5, 1, STATE_AGGRESSION, 300},  // ALERT -> AGGRESSION
+    {6, 2, STATE_PLAY, 500},  // ALERT -> PLAY
+    {8, 1, STATE_IDLE, 5000},  // ALERT -> IDLE
+    {0, 1, STATE_SLEEP, 2000},  // EXPLORATION -> SLEEP
+    {1, 1, STATE_ALERT, 200},  // EXPLORATION -> ALERT
+    {9, 2, STATE_FLIGHT_MODE, 2000},  // EXPLORATION -> FLIGHT_MODE
+    {0, 0, STATE_IDLE, 30000},  // EXPLORATION -> IDLE
+    {0, 1, STATE_SLEEP, 2000},  // PLAY -> SLEEP
+    {5, 1, STATE_AGGRESSION, 300},  // PLAY -> AGGRESSION
+    {8, 1, STATE_IDLE, 8000},  // PLAY -> IDLE
+    {0, 1, STATE_SLEEP, 2000},  // AGGRESSION -> SLEEP
+    {11, 1, STATE_ALERT, 2000},  // AGGRESSION -> ALERT
+    {12, 2, STATE_ALERT, 500},  // SLEEP -> ALERT
+    {14, 2, STATE_IDLE, 1000},  // SLEEP -> IDLE
+    {16, 2, STATE_IDLE, 5000},  // FLIGHT_MODE -> IDLE
+    {18, 1, STATE_IDLE, 0},  // FLIGHT_MODE -> IDLE
+};
+
+static const BehaviorMachine::State states[STATE_COUNT] = {
+    {0, 4},  // IDLE
+    {4, 4},  // ALERT
+    {8, 4},  // EXPLORATION
+    {12, 3},  // PLAY
+    {15, 2},  // AGGRESSION
+    {17, 2},  // SLEEP
+    {19, 2},  // FLIGHT_MODE
+};
+
+static const int16_t outputs[] = {
+    30, 25, 20, 0,  // IDLE
+    70, 30, 30, 0,  // ALERT
+    50, 30, 30, 0,  // EXPLORATION
+    80, 35, 45, 0,  // PLAY
+    100, 40, 60, 0,  // AGGRESSION
+    5, 0, 0, 0,  // SLEEP
+    60, 35, 45, 1,  // FLIGHT_MODE
+};
+
+static const char* const state_names[STATE_COUNT] = {
+    "IDLE",
+    "ALERT",
+    "EXPLORATION",
+    "PLAY",
+    "AGGRESSION",
+    "SLEEP",
+    "FLIGHT_MODE",
+};
+
+static const BehaviorMachine::Table table = {
+    states, transitions, guards, outputs, state_names,
+    STATE_COUNT, FACT_COUNT, OUTPUT_COUNT, STATE_IDLE
+};
+
+}  // namespace flying_dragon_behavior_sequencer_behavior
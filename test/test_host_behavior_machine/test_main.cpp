@@ -0,0 +1,323 @@
+/**
+ * @file test_main.cpp
+ * @brief Host tests of BehaviorMachine over the compiled flying dragon behavior tables
+ *
+ * flying_dragon_behavior_sequencer_behavior.hpp in this directory is the
+ * generator's output for the dragon sequencer JSON. Regenerate it after
+ * editing the "behavior" block:
+ *   python tools/generate_tables.py --behavior \
+ *       config/bots/bot_families/dragons/flying_dragon_behavior_sequencer.json \
+ *       test/test_host_behavior_machine/flying_dragon_behavior_sequencer_behavior.hpp
+ *
+ * - Scripted stimuli: a 2-minute script (visitor, play, anger, departure,
+ *   sleep timeout, wake, exploration, flight, low battery) is replayed at
+ *   the sequencer's 50 Hz with events off the tick grid. Every expected
+ *   transition happens in order, and the reaction latency (transition time
+ *   minus event time minus hold_ms) stays within one tick
+ * - Hold semantics: a guard that drops for one tick restarts its hold; a
+ *   guard-free row is a timeout from state entry; the first ready row in
+ *   table order wins
+ * - Outputs: per-state output rows follow the state
+ * - Cost: tick() per state over the script vs an interpreter that keeps
+ *   state and fact names as strings and scans every transition
+ *
+ * Outputs for inspection (test_output/):
+ *   behavior_machine.csv - t, state, presence, anger, happiness, curiosity,
+ *                          excitement, power_level, armed
+ *
+ * Run: pio test -e host_test -f test_host_behavior_machine
+ */
+
+#include <unity.h>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "config/components/templates/BehaviorMachine.hpp"
+#include "flying_dragon_behavior_sequencer_behavior.hpp"
+#include "../host_support/host_bench.hpp"
+
+namespace fsm = flying_dragon_behavior_sequencer_behavior;
+
+static const uint32_t PERIOD_MS = 20;
+
+struct Event {
+    uint32_t t_ms;
+    uint8_t fact;
+    int16_t value;
+};
+
+struct Expected {
+    uint32_t after_ms;          // Event time the transition reacts to
+    uint16_t hold_ms;
+    uint8_t to;
+};
+
+// Events land 7 ms after a tick so the latency measurement sees real phase
+static const Event SCRIPT[] = {
+    {2007, fsm::FACT_PRESENCE, 150},
+    {4007, fsm::FACT_ATTENTION, 200},
+    {4007, fsm::FACT_HAPPINESS, 40},
+    {8007, fsm::FACT_ANGER, 80},
+    {10007, fsm::FACT_ANGER, 10},
+    {10007, fsm::FACT_ATTENTION, 80},
+    {14007, fsm::FACT_PRESENCE, 10},
+    {14007, fsm::FACT_ATTENTION, 0},
+    {14007, fsm::FACT_HAPPINESS, 0},
+    {85007, fsm::FACT_PRESENCE, 30},
+    {88007, fsm::FACT_CURIOSITY, 50},
+    {92007, fsm::FACT_EXCITEMENT, 70},
+    {95007, fsm::FACT_ARMED, 1},
+    {95007, fsm::FACT_ALTITUDE_DM, 50},
+    {110007, fsm::FACT_POWER_LEVEL, 2},
+    {112007, fsm::FACT_POWER_LEVEL, 3},
+};
+
+static const Expected EXPECTED[] = {
+    {2007, 200, fsm::STATE_ALERT},
+    {4007, 500, fsm::STATE_PLAY},
+    {8007, 300, fsm::STATE_AGGRESSION},
+    {10007, 2000, fsm::STATE_ALERT},
+    {14007, 5000, fsm::STATE_IDLE},
+    {19020, 60000, fsm::STATE_SLEEP},          // Presence already low on entry to IDLE
+    {85007, 1000, fsm::STATE_IDLE},
+    {88007, 3000, fsm::STATE_EXPLORATION},
+    {92007, 2000, fsm::STATE_FLIGHT_MODE},
+    {110007, 0, fsm::STATE_IDLE},
+    {112007, 2000, fsm::STATE_SLEEP},
+};
+
+static const size_t SCRIPT_LEN = sizeof(SCRIPT) / sizeof(SCRIPT[0]);
+static const size_t EXPECTED_LEN = sizeof(EXPECTED) / sizeof(EXPECTED[0]);
+
+/**
+ * Previous-style interpreter: names everywhere, every transition scanned
+ */
+struct StringMachine {
+    struct Row {
+        std::string from;
+        std::string to;
+        std::vector<std::string> facts;
+        std::vector<uint8_t> ops;
+        std::vector<int16_t> values;
+        uint16_t hold_ms;
+    };
+    std::vector<Row> rows;
+    std::map<std::string, int16_t> facts;
+    std::vector<uint32_t> onset;
+    std::vector<bool> holding;
+    std::string state;
+    uint32_t entered_ms;
+
+    void build() {
+        rows.clear();
+        static const char* const FACT_NAMES[fsm::FACT_COUNT] = {
+            "presence", "attention", "proximity_cm", "anger", "fear", "happiness",
+            "curiosity", "excitement", "power_level", "armed", "altitude_dm"};
+        for (uint8_t s = 0; s < fsm::STATE_COUNT; s++) {
+            const BehaviorMachine::State& st = fsm::states[s];
+            for (uint8_t i = 0; i < st.transition_count; i++) {
+                const BehaviorMachine::Transition& t = fsm::transitions[st.first_transition + i];
+                Row r;
+                r.from = fsm::state_names[s];
+                r.to = fsm::state_names[t.to];
+                for (uint8_t k = 0; k < t.guard_count; k++) {
+                    const BehaviorMachine::Guard& g = fsm::guards[t.first_guard + k];
+                    r.facts.push_back(FACT_NAMES[g.fact]);
+                    r.ops.push_back(g.op);
+                    r.values.push_back(g.value);
+                }
+                r.hold_ms = t.hold_ms;
+                rows.push_back(r);
+            }
+        }
+        for (uint8_t f = 0; f < fsm::FACT_COUNT; f++) facts[FACT_NAMES[f]] = 0;
+        onset.assign(rows.size(), 0);
+        holding.assign(rows.size(), false);
+        state = "IDLE";
+        entered_ms = 0;
+    }
+
+    void tick(uint32_t now_ms) {
+        for (size_t i = 0; i < rows.size(); i++) {
+            const Row& r = rows[i];
+            if (r.from != state) continue;
+            bool ok = true;
+            for (size_t k = 0; k < r.facts.size() && ok; k++) {
+                int16_t v = facts[r.facts[k]];
+                switch (r.ops[k]) {
+                    case BehaviorMachine::OP_LT: ok = v < r.values[k]; break;
+                    case BehaviorMachine::OP_LE: ok = v <= r.values[k]; break;
+                    case BehaviorMachine::OP_GT: ok = v > r.values[k]; break;
+                    case BehaviorMachine::OP_GE: ok = v >= r.values[k]; break;
+                    case BehaviorMachine::OP_EQ: ok = v == r.values[k]; break;
+                    default: ok = v != r.values[k]; break;
+                }
+            }
+            if (!ok) { holding[i] = false; continue; }
+            if (!holding[i]) { holding[i] = true; onset[i] = r.facts.empty() ? entered_ms : now_ms; }
+            if (now_ms - onset[i] >= r.hold_ms) {
+                state = r.to;
+                entered_ms = now_ms;
+                holding.assign(rows.size(), false);
+                return;
+            }
+        }
+    }
+};
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_scripted_stimuli(void) {
+    host_bench::ensureOutputDir();
+    FILE* csv = fopen("test_output/behavior_machine.csv", "w");
+    TEST_ASSERT_NOT_NULL(csv);
+    fprintf(csv, "t_ms,state,presence,anger,happiness,curiosity,excitement,power_level,armed\n");
+
+    BehaviorMachine machine;
+    machine.configure(&fsm::table, 0);
+    TEST_ASSERT_EQUAL(fsm::STATE_IDLE, machine.state());
+
+    int16_t facts[fsm::FACT_COUNT] = {};
+    size_t next_event = 0;
+    size_t next_expected = 0;
+    int32_t worst_latency = 0;
+    bool saw_flight_request = false;
+    host_bench::CostStats cost;
+
+    for (uint32_t now = PERIOD_MS; now <= 120000; now += PERIOD_MS) {
+        while (next_event < SCRIPT_LEN && SCRIPT[next_event].t_ms <= now) {
+            facts[SCRIPT[next_event].fact] = SCRIPT[next_event].value;
+            next_event++;
+        }
+        uint64_t t0 = host_bench::nowNs();
+        BehaviorMachine::Result r = machine.tick(facts, now);
+        cost.add(host_bench::nowNs() - t0);
+
+        if (r.changed) {
+            TEST_ASSERT_TRUE(next_expected < EXPECTED_LEN);
+            const Expected& e = EXPECTED[next_expected++];
+            printf("[SCRIPT] %6u ms %-12s -> %-12s\n", now, machine.stateName(r.from), machine.stateName(r.to));
+            TEST_ASSERT_EQUAL(e.to, r.to);
+            int32_t latency = (int32_t)(now - e.after_ms) - e.hold_ms;
+            TEST_ASSERT_TRUE(latency >= 0);
+            if (latency > worst_latency) worst_latency = latency;
+        }
+        if (machine.state() == fsm::STATE_FLIGHT_MODE) {
+            saw_flight_request |= machine.output(fsm::OUT_FLIGHT_REQUEST) == 1;
+        }
+        fprintf(csv, "%u,%s,%d,%d,%d,%d,%d,%d,%d\n", now, machine.stateName(machine.state()),
+                facts[fsm::FACT_PRESENCE], facts[fsm::FACT_ANGER], facts[fsm::FACT_HAPPINESS],
+                facts[fsm::FACT_CURIOSITY], facts[fsm::FACT_EXCITEMENT], facts[fsm::FACT_POWER_LEVEL],
+                facts[fsm::FACT_ARMED]);
+    }
+    fclose(csv);
+
+    printf("[SCRIPT] %u transitions, worst reaction latency %d ms (engine %u ms), period %u ms\n",
+           machine.transitions(), worst_latency, machine.worstDelayMs(), PERIOD_MS);
+    cost.print("BehaviorMachine tick(), dragon", 1e6 * PERIOD_MS);
+    TEST_ASSERT_EQUAL(EXPECTED_LEN, next_expected);
+    TEST_ASSERT_TRUE(worst_latency <= (int32_t)PERIOD_MS);
+    TEST_ASSERT_TRUE(machine.worstDelayMs() <= PERIOD_MS);
+    TEST_ASSERT_TRUE(saw_flight_request);
+    TEST_ASSERT_EQUAL(5, machine.output(fsm::OUT_INTENSITY));      // SLEEP row
+}
+
+void test_hold_and_priority(void) {
+    BehaviorMachine machine;
+    machine.configure(&fsm::table, 0);
+    int16_t facts[fsm::FACT_COUNT] = {};
+    uint32_t now = 0;
+
+    // IDLE -> ALERT needs presence >= 100 for 200 ms; one low tick restarts it
+    facts[fsm::FACT_PRESENCE] = 120;
+    for (int i = 0; i < 9; i++) machine.tick(facts, now += PERIOD_MS);
+    facts[fsm::FACT_PRESENCE] = 90;
+    machine.tick(facts, now += PERIOD_MS);
+    facts[fsm::FACT_PRESENCE] = 120;
+    for (int i = 0; i < 10; i++) machine.tick(facts, now += PERIOD_MS);
+    TEST_ASSERT_EQUAL(fsm::STATE_IDLE, machine.state());
+    machine.tick(facts, now += PERIOD_MS);
+    TEST_ASSERT_EQUAL(fsm::STATE_ALERT, machine.state());
+    TEST_ASSERT_EQUAL(70, machine.output(fsm::OUT_INTENSITY));
+
+    // Critical battery and anger both ready in ALERT: SLEEP is the earlier row
+    facts[fsm::FACT_ANGER] = 100;
+    facts[fsm::FACT_POWER_LEVEL] = 3;
+    uint32_t start = now;
+    while (machine.state() == fsm::STATE_ALERT && now - start < 5000) machine.tick(facts, now += PERIOD_MS);
+    TEST_ASSERT_EQUAL(fsm::STATE_AGGRESSION, machine.state());   // 300 ms hold beats 2000 ms
+    start = now;
+    while (machine.state() == fsm::STATE_AGGRESSION && now - start < 5000) machine.tick(facts, now += PERIOD_MS);
+    TEST_ASSERT_EQUAL(fsm::STATE_SLEEP, machine.state());
+    TEST_ASSERT_EQUAL(fsm::STATE_AGGRESSION, machine.previous());
+
+    // Guard-free timeout from entry: EXPLORATION -> IDLE after 30 s
+    BehaviorMachine explore;
+    explore.configure(&fsm::table, 0);
+    int16_t calm[fsm::FACT_COUNT] = {};
+    calm[fsm::FACT_CURIOSITY] = 60;
+    calm[fsm::FACT_PRESENCE] = 50;
+    now = 0;
+    while (explore.state() != fsm::STATE_EXPLORATION) explore.tick(calm, now += PERIOD_MS);
+    uint32_t entered = now;
+    while (explore.state() == fsm::STATE_EXPLORATION && now - entered < 40000) explore.tick(calm, now += PERIOD_MS);
+    TEST_ASSERT_EQUAL(fsm::STATE_IDLE, explore.state());
+    TEST_ASSERT_EQUAL(30000, now - entered);
+}
+
+void test_tick_cost(void) {
+    BehaviorMachine machine;
+    machine.configure(&fsm::table, 0);
+    StringMachine legacy;
+    legacy.build();
+    static const char* const FACT_NAMES[fsm::FACT_COUNT] = {
+        "presence", "attention", "proximity_cm", "anger", "fear", "happiness",
+        "curiosity", "excitement", "power_level", "armed", "altitude_dm"};
+    const uint32_t ticks_per_lap = 120000 / PERIOD_MS;
+
+    // Whole script per timed lap so the clock read does not dominate a tick
+    host_bench::CostStats compiled_cost, string_cost;
+    for (int lap = 0; lap < 50; lap++) {
+        int16_t facts[fsm::FACT_COUNT] = {};
+        size_t next_event = 0;
+        machine.reset(0);
+        uint64_t t0 = host_bench::nowNs();
+        for (uint32_t now = PERIOD_MS; now <= 120000; now += PERIOD_MS) {
+            while (next_event < SCRIPT_LEN && SCRIPT[next_event].t_ms <= now) {
+                facts[SCRIPT[next_event].fact] = SCRIPT[next_event].value;
+                next_event++;
+            }
+            machine.tick(facts, now);
+        }
+        compiled_cost.add((host_bench::nowNs() - t0) / ticks_per_lap);
+
+        legacy.build();
+        next_event = 0;
+        t0 = host_bench::nowNs();
+        for (uint32_t now = PERIOD_MS; now <= 120000; now += PERIOD_MS) {
+            while (next_event < SCRIPT_LEN && SCRIPT[next_event].t_ms <= now) {
+                legacy.facts[FACT_NAMES[SCRIPT[next_event].fact]] = SCRIPT[next_event].value;
+                next_event++;
+            }
+            legacy.tick(now);
+        }
+        string_cost.add((host_bench::nowNs() - t0) / ticks_per_lap);
+    }
+    compiled_cost.print("compiled tables tick()", 1e6 * PERIOD_MS);
+    string_cost.print("string interpreter tick()", 1e6 * PERIOD_MS);
+    TEST_ASSERT_EQUAL(fsm::STATE_SLEEP, machine.state());
+    TEST_ASSERT_TRUE(legacy.state == "SLEEP");
+    TEST_ASSERT_TRUE(compiled_cost.meanNs() * 3.0 < string_cost.meanNs());
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_scripted_stimuli);
+    RUN_TEST(test_hold_and_priority);
+    RUN_TEST(test_tick_cost);
+    return UNITY_END();
+}
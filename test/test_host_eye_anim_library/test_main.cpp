@@ -0,0 +1,352 @@
+/**
+ * @file test_main.cpp
+ * @brief Host tests of EyeAnimLibrary: round trip, library size, corruption, band decode throughput
+ *
+ * The frames are the 7 procedural goblin eye animations of
+ * PSRAM_ANIMATION_SYSTEM.md (29 frames, 240x240 RGB565): amber eyeball,
+ * radial iris gradient, slit pupil, highlight, eyelids. The library is
+ * built with EyeAnimLibrary::encodeBand and the same band sharing as
+ * tools/eye_anim_encode.py.
+ *
+ * - Round trip: every band of every frame decodes bit-exact into a band
+ *   buffer; decodeFrame() matches too
+ * - Size: library against 29 raw frames (3.3 MB), per animation, and how
+ *   many bands are shared between frames
+ * - Corruption: bad magic, truncated data, a band stream that overruns or
+ *   underfills its pixels are all rejected
+ * - Throughput: band decode against the time the 80 MHz SPI bus needs to
+ *   send the same band (240 x 16 x 2 bytes = 768 us)
+ *
+ * Outputs for inspection (test_output/):
+ *   eye_anim_library.csv - animation, frames, raw_bytes, band_bytes (shared
+ *                          bands counted once per animation)
+ *   eye_anim/            - frames (.raw), manifest.json and the library
+ *                          built here (goblin_eye.p32e); running
+ *                          tools/eye_anim_encode.py on the manifest must
+ *                          produce the same bytes
+ *
+ * Run: pio test -e host_test -f test_host_eye_anim_library
+ */
+
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+
+#include "config/components/templates/EyeAnimLibrary.hpp"
+#include "../host_support/host_bench.hpp"
+
+static const int W = 240;
+static const int H = 240;
+static const int BAND_ROWS = 16;
+static const uint32_t FRAME_PIXELS = W * H;
+static const double SPI_BYTES_PER_S = 80e6 / 8;
+
+struct EyePose {
+    int lid;            // Rows covered from top and bottom at the centre
+    int pupil_w;        // Slit half-width
+    int dx;             // Gaze offset
+};
+
+struct AnimSpec {
+    const char* name;
+    uint16_t delay_loops;
+    std::vector<EyePose> poses;
+};
+
+static std::vector<AnimSpec> animations()
+{
+    return {
+        {"BLINK", 30, {{0, 8, 0}, {40, 8, 0}, {80, 8, 0}, {120, 8, 0}}},
+        {"STARTLE", 15, {{10, 8, 0}, {6, 11, 0}, {3, 14, 0}, {0, 17, 0}, {0, 20, 0}}},
+        {"CONTENT", 50, {{70, 8, 0}, {72, 8, 0}, {74, 8, 0}, {72, 8, 0}}},
+        {"DART", 20, {{0, 8, 0}, {0, 8, -30}, {0, 8, -50}, {0, 8, 30}, {0, 8, 50}}},
+        {"SLEEP", 60, {{120, 8, 0}, {117, 8, 0}, {120, 8, 0}}},
+        {"CURIOUS", 25, {{0, 14, 0}, {0, 10, 0}, {0, 7, 0}, {0, 5, 0}}},
+        {"SUSPICIOUS", 35, {{60, 8, 20}, {64, 8, 20}, {68, 8, 20}, {64, 8, 20}}},
+    };
+}
+
+static uint16_t rgb565(int r, int g, int b)
+{
+    return (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+}
+
+static void drawEye(uint16_t* frame, const EyePose& pose)
+{
+    const uint16_t skin = rgb565(74, 92, 40);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            int ex = x - 120, ey = y - 120;
+            int ix = x - 120 - pose.dx, iy = ey;
+            uint16_t c = 0x0000;
+            if (ex * ex + ey * ey < 110 * 110) c = rgb565(216, 196, 120);       // Amber eyeball
+            int ir2 = ix * ix + iy * iy;
+            if (ir2 < 64 * 64) {                                                // Iris, radial gradient
+                int shade = (int)std::sqrt((double)ir2) * 2;
+                c = rgb565(200 - shade, 140 - shade / 2, 20 + shade / 4);
+            }
+            if (ix > -pose.pupil_w && ix < pose.pupil_w && iy > -52 && iy < 52) c = 0x0000;
+            int hx = ix + 22, hy = iy + 24;
+            if (hx * hx + hy * hy < 9 * 9) c = 0xFFFF;                         // Highlight
+            // Eyelids: curved edge, pose.lid rows at the centre
+            int curve = (ex * ex) / 240;
+            if (y < pose.lid + curve - 10 || y > H - pose.lid - curve + 10) c = skin;
+            if (pose.lid >= 120) c = (ex * ex + ey * ey < 110 * 110 && ey == 0) ? 0x0000 : skin;
+            frame[y * W + x] = c;
+        }
+    }
+}
+
+struct Built {
+    std::vector<uint8_t> library;
+    std::vector<std::vector<uint16_t>> frames;
+    uint32_t unique_bands;
+    uint32_t total_bands;
+};
+
+/** Same layout and band sharing as tools/eye_anim_encode.py */
+static Built buildLibrary(const std::vector<AnimSpec>& specs)
+{
+    Built out;
+    for (const AnimSpec& a : specs) {
+        for (const EyePose& pose : a.poses) {
+            out.frames.push_back(std::vector<uint16_t>(FRAME_PIXELS));
+            drawEye(out.frames.back().data(), pose);
+        }
+    }
+    const int bands = (H + BAND_ROWS - 1) / BAND_ROWS;
+
+    std::vector<uint8_t>& lib = out.library;
+    auto u16 = [&lib](uint16_t v) { lib.push_back(v & 0xFF); lib.push_back(v >> 8); };
+    auto u32 = [&lib](uint32_t v) { for (int i = 0; i < 4; i++) lib.push_back((v >> (8 * i)) & 0xFF); };
+    lib.insert(lib.end(), {'P', '3', '2', 'E'});
+    u16(W); u16(H); u16(BAND_ROWS); u16((uint16_t)out.frames.size());
+    lib.push_back((uint8_t)specs.size());
+    lib.push_back(EyeAnimLibrary::FORMAT_VERSION);
+    u16(0);
+    uint16_t first = 0;
+    for (const AnimSpec& a : specs) {
+        u16(first); u16((uint16_t)a.poses.size()); u16(a.delay_loops); u16(0);
+        first = (uint16_t)(first + a.poses.size());
+    }
+
+    std::vector<uint8_t> data;
+    std::map<std::string, uint32_t> stored;
+    std::vector<uint8_t> scratch(W * BAND_ROWS * 3);
+    for (const std::vector<uint16_t>& frame : out.frames) {
+        for (int b = 0; b < bands; b++) {
+            int rows = (b + 1) * BAND_ROWS > H ? H - b * BAND_ROWS : BAND_ROWS;
+            uint32_t n = EyeAnimLibrary::encodeBand(frame.data() + b * BAND_ROWS * W, (uint32_t)(rows * W), scratch.data());
+            std::string key((const char*)scratch.data(), n);
+            auto it = stored.find(key);
+            if (it == stored.end()) {
+                it = stored.emplace(key, (uint32_t)data.size()).first;
+                data.insert(data.end(), scratch.begin(), scratch.begin() + n);
+            }
+            u32(it->second);
+            u32(n);
+        }
+    }
+    lib.insert(lib.end(), data.begin(), data.end());
+    out.unique_bands = (uint32_t)stored.size();
+    out.total_bands = (uint32_t)(out.frames.size() * bands);
+    return out;
+}
+
+static Built& shared()
+{
+    static Built built = buildLibrary(animations());
+    return built;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_round_trip(void) {
+    Built& built = shared();
+    EyeAnimLibrary lib;
+    TEST_ASSERT_EQUAL(EyeAnimLibrary::OK, lib.open(built.library.data(), built.library.size()));
+    TEST_ASSERT_EQUAL(W, lib.width());
+    TEST_ASSERT_EQUAL(15, lib.bands());
+    TEST_ASSERT_EQUAL(29, lib.frameCount());
+    TEST_ASSERT_EQUAL(7, lib.animationCount());
+    TEST_ASSERT_EQUAL(5, lib.animation(3).frame_count);        // DART
+    TEST_ASSERT_EQUAL(13, lib.animation(3).first_frame);
+    TEST_ASSERT_EQUAL(20, lib.animation(3).delay_loops);
+
+    std::vector<uint16_t> band(W * BAND_ROWS);
+    uint32_t mismatched = 0;
+    for (uint16_t f = 0; f < lib.frameCount(); f++) {
+        for (uint16_t b = 0; b < lib.bands(); b++) {
+            TEST_ASSERT_EQUAL(EyeAnimLibrary::OK, lib.decodeBand(f, b, band.data()));
+            if (memcmp(band.data(), built.frames[f].data() + b * BAND_ROWS * W,
+                       lib.rowsInBand(b) * W * sizeof(uint16_t)) != 0) {
+                mismatched++;
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL(0, mismatched);
+
+    std::vector<uint16_t> frame(FRAME_PIXELS);
+    TEST_ASSERT_EQUAL(EyeAnimLibrary::OK, lib.decodeFrame(28, frame.data()));
+    TEST_ASSERT_TRUE(frame == built.frames[28]);
+    TEST_ASSERT_EQUAL(EyeAnimLibrary::ERR_RANGE, lib.decodeBand(29, 0, band.data()));
+    TEST_ASSERT_EQUAL(EyeAnimLibrary::ERR_RANGE, lib.decodeBand(0, 15, band.data()));
+
+    // Odd band height: the last band is short
+    static const uint16_t ramp[7] = {0x0000, 0x0021, 0x0042, 0xF800, 0xF800, 0x0042, 0xFFFF};
+    uint8_t stream[32];
+    uint16_t back[7];
+    uint32_t n = EyeAnimLibrary::encodeBand(ramp, 7, stream);
+    TEST_ASSERT_TRUE(EyeAnimLibrary::decodeStream(stream, n, back, 7));
+    TEST_ASSERT_TRUE(memcmp(ramp, back, sizeof(ramp)) == 0);
+
+    // Runs beyond one long-run op
+    std::vector<uint16_t> flat(40000, 0x1234), flat_back(40000);
+    std::vector<uint8_t> flat_stream(16);
+    n = EyeAnimLibrary::encodeBand(flat.data(), 40000, flat_stream.data());
+    TEST_ASSERT_EQUAL(3 + 2 * 3, n);      // Literal + 3 long runs (16256 + 16256 + 7487)
+    TEST_ASSERT_TRUE(EyeAnimLibrary::decodeStream(flat_stream.data(), n, flat_back.data(), 40000));
+    TEST_ASSERT_TRUE(flat == flat_back);
+}
+
+void test_library_size(void) {
+    Built& built = shared();
+    EyeAnimLibrary lib;
+    lib.open(built.library.data(), built.library.size());
+
+    host_bench::ensureOutputDir();
+    FILE* csv = fopen("test_output/eye_anim_library.csv", "w");
+    TEST_ASSERT_NOT_NULL(csv);
+    fprintf(csv, "animation,frames,raw_bytes,band_bytes\n");
+    std::vector<AnimSpec> specs = animations();
+    for (uint8_t a = 0; a < lib.animationCount(); a++) {
+        EyeAnimLibrary::Animation anim = lib.animation(a);
+        std::map<uint32_t, uint32_t> seen;
+        for (uint16_t f = anim.first_frame; f < anim.first_frame + anim.frame_count; f++) {
+            for (uint16_t b = 0; b < lib.bands(); b++) {
+                const uint8_t* entry = built.library.data() + EyeAnimLibrary::HEADER_BYTES +
+                                       lib.animationCount() * EyeAnimLibrary::ANIMATION_BYTES +
+                                       (f * lib.bands() + b) * EyeAnimLibrary::INDEX_ENTRY_BYTES;
+                uint32_t offset = entry[0] | entry[1] << 8 | entry[2] << 16 | (uint32_t)entry[3] << 24;
+                seen[offset] = lib.bandBytes(f, b);
+            }
+        }
+        uint32_t bytes = 0;
+        for (auto& kv : seen) bytes += kv.second;
+        uint32_t raw = anim.frame_count * FRAME_PIXELS * 2;
+        printf("[SIZE] %-11s %u frames %8u -> %6u bytes (%5.1f:1)\n", specs[a].name, anim.frame_count,
+               raw, bytes, (double)raw / bytes);
+        fprintf(csv, "%s,%u,%u,%u\n", specs[a].name, anim.frame_count, raw, bytes);
+    }
+    fclose(csv);
+
+    uint32_t raw = 29 * FRAME_PIXELS * 2;
+    printf("[SIZE] library %zu bytes for %u raw (%.1f:1), %u of %u bands stored\n",
+           built.library.size(), raw, (double)raw / built.library.size(), built.unique_bands, built.total_bands);
+    TEST_ASSERT_TRUE(built.library.size() * 20 < raw);          // Under 5% of the raw library
+    TEST_ASSERT_TRUE(built.unique_bands * 2 < built.total_bands);
+
+    // Fixture for the Python encoder: same frames, same bytes expected
+    mkdir("test_output/eye_anim", 0755);
+    FILE* manifest = fopen("test_output/eye_anim/manifest.json", "w");
+    TEST_ASSERT_NOT_NULL(manifest);
+    fprintf(manifest, "{\n    \"width\": %d, \"height\": %d, \"band_rows\": %d,\n    \"animations\": [\n", W, H, BAND_ROWS);
+    uint32_t index = 0;
+    for (size_t a = 0; a < specs.size(); a++) {
+        fprintf(manifest, "        {\"name\": \"%s\", \"delay_loops\": %u, \"frames\": [", specs[a].name, specs[a].delay_loops);
+        for (size_t f = 0; f < specs[a].poses.size(); f++, index++) {
+            char path[64];
+            snprintf(path, sizeof(path), "test_output/eye_anim/frame_%02u.raw", index);
+            FILE* raw_file = fopen(path, "wb");
+            TEST_ASSERT_NOT_NULL(raw_file);
+            fwrite(built.frames[index].data(), sizeof(uint16_t), FRAME_PIXELS, raw_file);
+            fclose(raw_file);
+            fprintf(manifest, "%s\"frame_%02u.raw\"", f ? ", " : "", index);
+        }
+        fprintf(manifest, "]}%s\n", a + 1 < specs.size() ? "," : "");
+    }
+    fprintf(manifest, "    ]\n}\n");
+    fclose(manifest);
+    FILE* out = fopen("test_output/eye_anim/goblin_eye.p32e", "wb");
+    TEST_ASSERT_NOT_NULL(out);
+    fwrite(built.library.data(), 1, built.library.size(), out);
+    fclose(out);
+}
+
+void test_corruption(void) {
+    Built& built = shared();
+    std::vector<uint8_t> bad = built.library;
+    EyeAnimLibrary lib;
+
+    bad[3] = 'X';
+    TEST_ASSERT_EQUAL(EyeAnimLibrary::ERR_FORMAT, lib.open(bad.data(), bad.size()));
+    TEST_ASSERT_FALSE(lib.isOpen());
+    TEST_ASSERT_EQUAL(EyeAnimLibrary::ERR_SIZE, lib.open(built.library.data(), 100));
+
+    // Truncated band data: tables fit, late bands point past the end
+    TEST_ASSERT_EQUAL(EyeAnimLibrary::OK, lib.open(built.library.data(), built.library.size() - 10));
+    std::vector<uint16_t> frame(FRAME_PIXELS);
+    bool any_size_error = false;
+    for (uint16_t f = 0; f < lib.frameCount(); f++) {
+        any_size_error |= lib.decodeFrame(f, frame.data()) == EyeAnimLibrary::ERR_SIZE;
+    }
+    TEST_ASSERT_TRUE(any_size_error);
+
+    // Streams that overrun or underfill the band
+    uint16_t px[64];
+    const uint8_t overrun[] = {EyeAnimLibrary::OP_LITERAL, 0x34, 0x12, EyeAnimLibrary::OP_RUN | 63};
+    TEST_ASSERT_FALSE(EyeAnimLibrary::decodeStream(overrun, sizeof(overrun), px, 64));
+    const uint8_t underfill[] = {EyeAnimLibrary::OP_LITERAL, 0x34, 0x12, EyeAnimLibrary::OP_RUN | 10};
+    TEST_ASSERT_FALSE(EyeAnimLibrary::decodeStream(underfill, sizeof(underfill), px, 64));
+    const uint8_t trailing[] = {EyeAnimLibrary::OP_LITERAL, 0x34, 0x12, EyeAnimLibrary::OP_RUN | 62, 0x00};
+    TEST_ASSERT_FALSE(EyeAnimLibrary::decodeStream(trailing, sizeof(trailing), px, 64));
+    TEST_ASSERT_TRUE(EyeAnimLibrary::decodeStream(trailing, sizeof(trailing) - 1, px, 64));
+    const uint8_t cut_literal[] = {EyeAnimLibrary::OP_LITERAL, 0x34};
+    TEST_ASSERT_FALSE(EyeAnimLibrary::decodeStream(cut_literal, sizeof(cut_literal), px, 1));
+}
+
+void test_band_throughput(void) {
+    Built& built = shared();
+    EyeAnimLibrary lib;
+    lib.open(built.library.data(), built.library.size());
+
+    std::vector<uint16_t> band(W * BAND_ROWS);
+    host_bench::CostStats cost;
+    uint64_t total_ns = 0;
+    uint64_t pixels = 0;
+    for (int lap = 0; lap < 20; lap++) {
+        for (uint16_t f = 0; f < lib.frameCount(); f++) {
+            for (uint16_t b = 0; b < lib.bands(); b++) {
+                uint64_t t0 = host_bench::nowNs();
+                lib.decodeBand(f, b, band.data());
+                uint64_t ns = host_bench::nowNs() - t0;
+                cost.add(ns);
+                total_ns += ns;
+                pixels += (uint64_t)W * lib.rowsInBand(b);
+            }
+        }
+    }
+    double spi_band_ns = W * BAND_ROWS * 2 / SPI_BYTES_PER_S * 1e9;
+    double decode_mb_s = pixels * 2 / (total_ns * 1e-9) / 1e6;
+    cost.print("decodeBand 240x16", spi_band_ns);
+    printf("[BENCH] decode %.0f MB/s of RGB565 vs %.0f MB/s SPI drain (%.0fx)\n",
+           decode_mb_s, SPI_BYTES_PER_S / 1e6, decode_mb_s * 1e6 / SPI_BYTES_PER_S);
+    // Keep a wide margin for the ESP32-S3, which runs this loop ~10x slower
+    TEST_ASSERT_TRUE(cost.meanNs() * 20 < spi_band_ns);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_library_size);
+    RUN_TEST(test_corruption);
+    RUN_TEST(test_band_throughput);
+    return UNITY_END();
+}
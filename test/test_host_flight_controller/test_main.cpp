@@ -0,0 +1,372 @@
+/**
+ * @file test_main.cpp
+ * @brief Host rigid-body simulation of CascadedAttitudeController + QuadXMixer
+ *
+ * The flying_dragon airframe (2.56 kg, 10" props on a 0.5 m X, T/W 1.5) is
+ * simulated as a rigid body with first-order motor lag, rotor reaction
+ * torque, gyro noise and one control tick of sensor delay. Physics runs at
+ * 2 kHz; the controller runs at the 400 Hz ESC rate exactly as the
+ * flying_dragon_motor_controller tick does.
+ *
+ * Outputs for inspection (test_output/):
+ *   flight_controller_sim.csv - t, roll/pitch setpoint and response, yaw rate, motors 0-3
+ *
+ * Run: pio test -e host_test -f test_host_flight_controller
+ */
+
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+
+#include "config/components/templates/CascadedAttitudeController.hpp"
+#include "config/components/templates/QuadXMixer.hpp"
+#include "../host_support/host_bench.hpp"
+
+static const float DEG = 3.14159265f / 180.0f;
+static const float G = 9.80665f;
+static const float CONTROL_HZ = 400.0f;
+static const int PHYSICS_PER_TICK = 5;         // 2 kHz physics
+static const float IDLE = 0.05f;
+
+static uint32_t rng_state = 7;
+static float gauss() {
+    float s = 0.0f;
+    for (int i = 0; i < 4; i++) {
+        rng_state = rng_state * 1664525u + 1013904223u;
+        s += (float)(rng_state >> 8) / 16777216.0f;
+    }
+    return (s - 2.0f) * 1.7320508f;
+}
+
+/**
+ * Rotational rigid body with four lagged rotors in the QuadXMixer layout
+ */
+struct Airframe {
+    // Geometry and mass properties
+    float mass = 2.56f;
+    float arm = 0.177f;                     // x and y offset of each rotor
+    float max_thrust = 9.4f;                // N per rotor
+    float torque_per_thrust = 0.016f;       // m, rotor drag torque / thrust
+    float ixx = 0.045f, iyy = 0.045f, izz = 0.080f;
+    float motor_tau = 0.03f;
+
+    // State
+    float q[4] = {1.0f, 0.0f, 0.0f, 0.0f};
+    float w[3] = {0.0f, 0.0f, 0.0f};
+    float thrust[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    float disturbance[3] = {0.0f, 0.0f, 0.0f};
+
+    void settle(float u) {
+        for (int i = 0; i < 4; i++) thrust[i] = u * max_thrust;
+    }
+
+    void step(const float cmd[4], float dt) {
+        // Rotor positions (x, y) and spin (+1 = CW seen from above -> +z reaction)
+        static const float PX[4] = {-1.0f, 1.0f, -1.0f, 1.0f};
+        static const float PY[4] = {-1.0f, -1.0f, 1.0f, 1.0f};
+        static const float SPIN[4] = {-1.0f, 1.0f, 1.0f, -1.0f};
+        float k = dt / (dt + motor_tau);
+        float tau[3] = {disturbance[0], disturbance[1], disturbance[2]};
+        for (int i = 0; i < 4; i++) {
+            float u = cmd[i] < 0.0f ? 0.0f : (cmd[i] > 1.0f ? 1.0f : cmd[i]);
+            thrust[i] += (u * max_thrust - thrust[i]) * k;
+            tau[0] += PY[i] * arm * thrust[i];
+            tau[1] += -PX[i] * arm * thrust[i];
+            tau[2] += SPIN[i] * torque_per_thrust * thrust[i];
+        }
+        // Euler: I dw = tau - w x (I w), light aerodynamic damping
+        float iw[3] = {ixx * w[0], iyy * w[1], izz * w[2]};
+        float cx = w[1] * iw[2] - w[2] * iw[1];
+        float cy = w[2] * iw[0] - w[0] * iw[2];
+        float cz = w[0] * iw[1] - w[1] * iw[0];
+        w[0] += (tau[0] - cx - 0.01f * w[0]) / ixx * dt;
+        w[1] += (tau[1] - cy - 0.01f * w[1]) / iyy * dt;
+        w[2] += (tau[2] - cz - 0.02f * w[2]) / izz * dt;
+
+        float h = 0.5f * dt;
+        float a = q[0], b = q[1], c = q[2], d = q[3];
+        q[0] += (-b * w[0] - c * w[1] - d * w[2]) * h;
+        q[1] += (a * w[0] + c * w[2] - d * w[1]) * h;
+        q[2] += (a * w[1] - b * w[2] + d * w[0]) * h;
+        q[3] += (a * w[2] + b * w[1] - c * w[0]) * h;
+        float n = 1.0f / sqrtf(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+        for (int i = 0; i < 4; i++) q[i] *= n;
+    }
+
+    float roll() const { return atan2f(2.0f * (q[0] * q[1] + q[2] * q[3]), 1.0f - 2.0f * (q[1] * q[1] + q[2] * q[2])); }
+    float pitch() const { return asinf(fmaxf(-1.0f, fminf(1.0f, 2.0f * (q[0] * q[2] - q[3] * q[1])))); }
+    float hoverThrottle() const { return mass * G / (4.0f * max_thrust); }
+};
+
+struct Setpoint {
+    float roll, pitch, yaw_rate, throttle;
+};
+
+/**
+ * Closed loop: one controller tick per 1/400 s, sensor values delayed by one tick
+ */
+struct Loop {
+    Airframe body;
+    CascadedAttitudeController ctl;
+    QuadXMixer mixer;
+    WingSurfaceMixer wings;
+    float motors[4];
+    float surfaces[6];
+    float meas_roll = 0.0f, meas_pitch = 0.0f, meas_rates[3] = {0.0f, 0.0f, 0.0f};
+    bool motors_in_range = true;
+    FILE* csv = nullptr;
+    float t = 0.0f;
+
+    Loop() {
+        ctl.configure(1.0f / CONTROL_HZ);
+        mixer.setIdle(IDLE);
+        wings.configure(1.0f / CONTROL_HZ, 375.0f, 90.0f);
+        body.settle(body.hoverThrottle());
+        for (int i = 0; i < 4; i++) motors[i] = body.hoverThrottle();
+    }
+
+    void tick(const Setpoint& sp) {
+        float torque[3];
+        ctl.update(sp.roll, sp.pitch, sp.yaw_rate, meas_roll, meas_pitch, meas_rates, torque);
+        float collective = mixer.mix(sp.throttle, torque, motors);
+        ctl.setSaturation(mixer.saturation());
+        wings.mix(collective, torque, surfaces);
+        for (int i = 0; i < 4; i++) {
+            if (motors[i] < IDLE - 1e-5f || motors[i] > 1.0f + 1e-5f) motors_in_range = false;
+        }
+
+        // Sensors sampled now are what the next tick sees
+        meas_roll = body.roll() + 0.05f * DEG * gauss();
+        meas_pitch = body.pitch() + 0.05f * DEG * gauss();
+        for (int a = 0; a < 3; a++) meas_rates[a] = body.w[a] + 0.3f * DEG * gauss();
+
+        float dt = 1.0f / (CONTROL_HZ * PHYSICS_PER_TICK);
+        for (int i = 0; i < PHYSICS_PER_TICK; i++) body.step(motors, dt);
+        t += 1.0f / CONTROL_HZ;
+
+        if (csv) {
+            fprintf(csv, "%.4f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n", t, sp.roll / DEG, body.roll() / DEG,
+                    sp.pitch / DEG, body.pitch() / DEG, body.w[2] / DEG, motors[0], motors[1], motors[2], motors[3]);
+        }
+    }
+};
+
+struct StepMetrics {
+    float rise_s = -1.0f;           // 10% -> 90%
+    float settle_s = -1.0f;         // last entry into +/- 5% band
+    float overshoot = 0.0f;         // fraction of the step
+    float final_error_deg = 0.0f;
+};
+
+/** Step the roll (axis 0) or pitch (axis 1) setpoint by step_deg at t0 and record the response */
+static StepMetrics runStep(Loop& loop, int axis, float step_deg, float duration_s) {
+    StepMetrics m;
+    Setpoint sp = {0.0f, 0.0f, 0.0f, loop.body.hoverThrottle()};
+    for (int i = 0; i < (int)(0.5f * CONTROL_HZ); i++) loop.tick(sp);
+    float t0 = loop.t;
+    float target = step_deg * DEG;
+    if (axis == 0) sp.roll = target; else sp.pitch = target;
+    float t10 = -1.0f, t90 = -1.0f, peak = 0.0f, last_out = t0;
+    int n = (int)(duration_s * CONTROL_HZ);
+    for (int i = 0; i < n; i++) {
+        loop.tick(sp);
+        float y = (axis == 0 ? loop.body.roll() : loop.body.pitch()) / target;
+        if (t10 < 0.0f && y >= 0.1f) t10 = loop.t;
+        if (t90 < 0.0f && y >= 0.9f) t90 = loop.t;
+        if (y > peak) peak = y;
+        if (fabsf(y - 1.0f) > 0.05f) last_out = loop.t;
+    }
+    m.rise_s = (t10 >= 0.0f && t90 >= 0.0f) ? t90 - t10 : -1.0f;
+    m.settle_s = last_out - t0;
+    m.overshoot = peak > 1.0f ? peak - 1.0f : 0.0f;
+    m.final_error_deg = ((axis == 0 ? loop.body.roll() : loop.body.pitch()) - target) / DEG;
+    return m;
+}
+
+void test_angle_step_response(void) {
+    host_bench::ensureOutputDir();
+    Loop loop;
+    loop.csv = fopen("test_output/flight_controller_sim.csv", "w");
+    if (loop.csv) fprintf(loop.csv, "t,roll_sp,roll,pitch_sp,pitch,yaw_rate_dps,m0,m1,m2,m3\n");
+
+    StepMetrics roll = runStep(loop, 0, 20.0f, 1.5f);
+    StepMetrics pitch = runStep(loop, 1, -15.0f, 1.5f);
+    if (loop.csv) fclose(loop.csv);
+
+    printf("[SIM] roll 20 deg:   rise %.3f s  settle %.3f s  overshoot %.1f%%  final err %.2f deg\n",
+           roll.rise_s, roll.settle_s, 100.0f * roll.overshoot, roll.final_error_deg);
+    printf("[SIM] pitch -15 deg: rise %.3f s  settle %.3f s  overshoot %.1f%%  final err %.2f deg\n",
+           pitch.rise_s, pitch.settle_s, 100.0f * pitch.overshoot, pitch.final_error_deg);
+
+    TEST_ASSERT_TRUE(roll.rise_s > 0.0f && roll.rise_s < 0.35f);
+    TEST_ASSERT_TRUE(roll.settle_s < 0.8f);
+    TEST_ASSERT_TRUE(roll.overshoot < 0.15f);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 0.0f, roll.final_error_deg);
+    TEST_ASSERT_TRUE(pitch.rise_s > 0.0f && pitch.rise_s < 0.35f);
+    TEST_ASSERT_TRUE(pitch.overshoot < 0.15f);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 0.0f, pitch.final_error_deg);
+    TEST_ASSERT_TRUE(loop.motors_in_range);
+}
+
+void test_integrator_removes_cog_offset(void) {
+    // Payload 4 cm off-centre to the right: constant -1 N*m roll torque
+    Loop loop;
+    loop.body.disturbance[0] = -1.0f;
+    Setpoint sp = {0.0f, 0.0f, 0.0f, loop.body.hoverThrottle()};
+    float worst = 0.0f;
+    for (int i = 0; i < (int)(3.0f * CONTROL_HZ); i++) {
+        loop.tick(sp);
+        if (fabsf(loop.body.roll()) > worst) worst = fabsf(loop.body.roll());
+    }
+    float final_deg = loop.body.roll() / DEG;
+    printf("[SIM] CoG offset: peak %.2f deg, after 3 s %.3f deg, roll I %.3f\n", worst / DEG, final_deg,
+           loop.ctl.integrator(CascadedAttitudeController::ROLL));
+    TEST_ASSERT_TRUE(worst < 5.0f * DEG);
+    TEST_ASSERT_FLOAT_WITHIN(0.3f, 0.0f, final_deg);
+}
+
+void test_saturation_keeps_roll_pitch_priority(void) {
+    // Full throttle + aggressive yaw + roll step: yaw and collective give way, roll still tracks
+    Loop loop;
+    Setpoint sp = {25.0f * DEG, 0.0f, 200.0f * DEG, 0.98f};
+    float roll_err_late = 0.0f;
+    uint32_t yaw_cut = 0;
+    int n = (int)(1.5f * CONTROL_HZ);
+    for (int i = 0; i < n; i++) {
+        loop.tick(sp);
+        if (loop.mixer.saturation()[2] != 0) yaw_cut++;
+        if (i > n / 2) roll_err_late = fmaxf(roll_err_late, fabsf(loop.body.roll() - sp.roll));
+    }
+    printf("[SIM] saturated: yaw cut in %lu/%d ticks, late roll error %.2f deg, yaw rate %.0f dps\n",
+           (unsigned long)yaw_cut, n, roll_err_late / DEG, loop.body.w[2] / DEG);
+    TEST_ASSERT_TRUE(loop.motors_in_range);
+    TEST_ASSERT_TRUE(yaw_cut > 0);
+    TEST_ASSERT_TRUE(roll_err_late < 2.0f * DEG);
+
+    // Zero throttle: the mixer lifts collective to keep authority (motors never below idle)
+    Loop low;
+    Setpoint sp_low = {-20.0f * DEG, 10.0f * DEG, 0.0f, 0.0f};
+    for (int i = 0; i < (int)(0.5f * CONTROL_HZ); i++) low.tick(sp_low);
+    TEST_ASSERT_TRUE(low.motors_in_range);
+    TEST_ASSERT_FLOAT_WITHIN(3.0f, -20.0f, low.body.roll() / DEG);
+}
+
+void test_anti_windup_limits_recovery_overshoot(void) {
+    // A gust larger than full authority for 1 s, then released
+    Loop loop;
+    Setpoint sp = {0.0f, 0.0f, 0.0f, loop.body.hoverThrottle()};
+    loop.body.disturbance[0] = 4.5f;
+    float pushed = 0.0f;
+    for (int i = 0; i < (int)(1.0f * CONTROL_HZ); i++) {
+        loop.tick(sp);
+        // Catch it before it flips: the test is about windup, not recovery from inversion
+        if (loop.body.roll() > 30.0f * DEG) {
+            loop.body.q[0] = cosf(15.0f * DEG);
+            loop.body.q[1] = sinf(15.0f * DEG);
+            loop.body.q[2] = loop.body.q[3] = 0.0f;
+            loop.body.w[0] = 0.0f;
+        }
+        pushed = loop.body.roll();
+    }
+    loop.body.disturbance[0] = 0.0f;
+    float overshoot = 0.0f;
+    for (int i = 0; i < (int)(1.5f * CONTROL_HZ); i++) {
+        loop.tick(sp);
+        if (-loop.body.roll() > overshoot) overshoot = -loop.body.roll();
+    }
+    printf("[SIM] gust release from %.1f deg: overshoot %.2f deg, final %.2f deg\n", pushed / DEG, overshoot / DEG,
+           loop.body.roll() / DEG);
+    TEST_ASSERT_TRUE(overshoot < 6.0f * DEG);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 0.0f, loop.body.roll() / DEG);
+}
+
+void test_mixer_output_and_flags(void) {
+    QuadXMixer mixer;
+    mixer.setIdle(IDLE);
+    float out[4];
+
+    // Inside the envelope: exact linear mix, no flags
+    float small[3] = {0.2f, -0.1f, 0.05f};
+    float c = mixer.mix(0.5f, small, out);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.5f, c);
+    float span = 1.0f - IDLE;
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, IDLE + 0.5f * span + 0.5f * span * (0.2f - 0.1f + 0.05f),
+                             out[QuadXMixer::REAR_LEFT]);
+    TEST_ASSERT_EQUAL_INT(0, mixer.saturation()[0] | mixer.saturation()[1] | mixer.saturation()[2]);
+
+    // Roll + yaw beyond authority: roll kept whole, yaw cut and flagged, all outputs in range
+    float big[3] = {0.8f, 0.0f, 0.9f};
+    mixer.mix(0.5f, big, out);
+    float roll_diff = (out[QuadXMixer::REAR_LEFT] + out[QuadXMixer::FRONT_LEFT]) -
+                      (out[QuadXMixer::REAR_RIGHT] + out[QuadXMixer::FRONT_RIGHT]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 2.0f * 0.8f * span, roll_diff);
+    TEST_ASSERT_EQUAL_INT(0, mixer.saturation()[0]);
+    TEST_ASSERT_EQUAL_INT(1, mixer.saturation()[2]);
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(out[i] >= IDLE - 1e-5f && out[i] <= 1.0f + 1e-5f);
+    }
+
+    // Roll + pitch alone too large: scaled together (direction kept), both flagged
+    float huge[3] = {1.2f, -0.6f, 0.0f};
+    mixer.mix(0.5f, huge, out);
+    float r = (out[QuadXMixer::REAR_LEFT] + out[QuadXMixer::FRONT_LEFT]) -
+              (out[QuadXMixer::REAR_RIGHT] + out[QuadXMixer::FRONT_RIGHT]);
+    float p = (out[QuadXMixer::REAR_LEFT] + out[QuadXMixer::REAR_RIGHT]) -
+              (out[QuadXMixer::FRONT_LEFT] + out[QuadXMixer::FRONT_RIGHT]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, -2.0f, r / p);
+    TEST_ASSERT_EQUAL_INT(1, mixer.saturation()[0]);
+    TEST_ASSERT_EQUAL_INT(-1, mixer.saturation()[1]);
+
+    // Wing surfaces: slew-limited to the servo speed per tick
+    WingSurfaceMixer wings;
+    wings.configure(1.0f / CONTROL_HZ, 375.0f, 90.0f);
+    float surf[6];
+    float roll_cmd[3] = {1.0f, 0.0f, 0.0f};
+    wings.mix(0.5f, roll_cmd, surf);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 375.0f / CONTROL_HZ / 90.0f, surf[WingSurfaceMixer::LEFT_TWIST]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, -375.0f / CONTROL_HZ / 90.0f, surf[WingSurfaceMixer::RIGHT_TWIST]);
+    for (int i = 0; i < 200; i++) wings.mix(0.5f, roll_cmd, surf);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.8f, surf[WingSurfaceMixer::LEFT_TWIST]);
+}
+
+void test_control_tick_cost(void) {
+    // One full tick: cascaded PID + motor mix + wing mix. Budget 100 us on target
+    CascadedAttitudeController ctl;
+    QuadXMixer mixer;
+    WingSurfaceMixer wings;
+    mixer.setIdle(IDLE);
+    host_bench::CostStats cost;
+    float motors[4], surfaces[6], torque[3];
+    float rates[3] = {0.0f, 0.0f, 0.0f};
+    volatile float sink = 0.0f;
+    for (int i = 0; i < 200000; i++) {
+        float s = 0.3f * sinf((float)i * 0.001f);
+        rates[0] = s;
+        rates[1] = -s;
+        rates[2] = 0.5f * s;
+        uint64_t t0 = host_bench::nowNs();
+        ctl.update(s, -s, 2.0f * s, 0.5f * s, 0.2f * s, rates, torque);
+        float c = mixer.mix(0.6f + s, torque, motors);
+        ctl.setSaturation(mixer.saturation());
+        wings.mix(c, torque, surfaces);
+        cost.add(host_bench::nowNs() - t0);
+        sink = sink + motors[0] + surfaces[1];
+    }
+    (void)sink;
+    cost.print("attitude + mixer tick", 100000.0);
+    TEST_ASSERT_TRUE(cost.meanNs() < 5000.0);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_angle_step_response);
+    RUN_TEST(test_integrator_removes_cog_offset);
+    RUN_TEST(test_saturation_keeps_roll_pitch_priority);
+    RUN_TEST(test_anti_windup_limits_recovery_overshoot);
+    RUN_TEST(test_mixer_output_and_flags);
+    RUN_TEST(test_control_tick_cost);
+    return UNITY_END();
+}
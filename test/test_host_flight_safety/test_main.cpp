@@ -0,0 +1,281 @@
+/**
+ * @file test_main.cpp
+ * @brief Scripted fault scenarios against SafetyMonitor with the flying_dragon rule table
+ *
+ * Each scenario scripts the monitored signals over time (battery sag,
+ * flip, gyro runaway, lost heartbeats, altitude floor...) and runs the
+ * monitor at its 2 ms period with scheduling jitter. The action and the
+ * time from fault onset to action are checked against the rule's hold
+ * time plus two periods (one to see the fault, one to see the hold expire).
+ *
+ * A second suite runs the monitor in its own thread next to a "dispatch
+ * loop" thread that stalls for hundreds of milliseconds, the way the real
+ * safety task runs next to app_main, and checks the KILL still lands on
+ * time.
+ *
+ * Outputs for inspection (test_output/):
+ *   flight_safety_scenarios.csv - scenario, expected action, action seen, latency
+ *
+ * Run: pio test -e host_test -f test_host_flight_safety
+ */
+
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+
+#include "config/components/templates/SafetyMonitor.hpp"
+#include "../host_support/host_bench.hpp"
+
+typedef SafetyMonitor SM;
+
+static const uint32_t PERIOD_US = 2000;
+static const uint32_t JITTER_US = 300;
+
+// Same rows as flying_dragon_flight_safety.src
+static const SM::Rule RULES[] = {
+    {SM::SIG_BATTERY_V, SM::BELOW, SM::ACT_WARN, SM::RULE_ARMED_ONLY, 11.5f, 1000},
+    {SM::SIG_BATTERY_V, SM::BELOW, SM::ACT_LAND, SM::RULE_ARMED_ONLY | SM::RULE_LATCH, 11.0f, 2000},
+    {SM::SIG_TILT_DEG, SM::ABOVE, SM::ACT_KILL, SM::RULE_ARMED_ONLY | SM::RULE_LATCH, 70.0f, 300},
+    {SM::SIG_RATE_DPS, SM::ABOVE, SM::ACT_KILL, SM::RULE_ARMED_ONLY | SM::RULE_LATCH, 500.0f, 200},
+    {SM::SIG_ALTITUDE_M, SM::BELOW, SM::ACT_FLOOR, SM::RULE_AIRBORNE_ONLY | SM::RULE_NOT_LANDING, 0.5f, 0},
+    {SM::SIG_COMMAND_AGE_MS, SM::ABOVE, SM::ACT_LAND, SM::RULE_ARMED_ONLY | SM::RULE_LATCH, 500.0f, 0},
+    {SM::SIG_FUSION_AGE_MS, SM::ABOVE, SM::ACT_KILL, SM::RULE_ARMED_ONLY | SM::RULE_LATCH, 50.0f, 0},
+    {SM::SIG_CONTROL_AGE_MS, SM::ABOVE, SM::ACT_KILL, SM::RULE_ARMED_ONLY | SM::RULE_LATCH, 20.0f, 0},
+};
+static const size_t RULE_COUNT = sizeof(RULES) / sizeof(RULES[0]);
+
+static uint32_t rng_state = 31;
+static uint32_t jitter() {
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return (rng_state >> 8) % JITTER_US;
+}
+
+/** Healthy hover: full battery, level, 2 m up, fresh heartbeats */
+static void healthySignals(float s[SM::SIG_COUNT]) {
+    s[SM::SIG_BATTERY_V] = 15.8f;
+    s[SM::SIG_TILT_DEG] = 4.0f;
+    s[SM::SIG_RATE_DPS] = 30.0f;
+    s[SM::SIG_ALTITUDE_M] = 2.0f;
+    s[SM::SIG_COMMAND_AGE_MS] = 15.0f;
+    s[SM::SIG_FUSION_AGE_MS] = 6.0f;
+    s[SM::SIG_CONTROL_AGE_MS] = 1.5f;
+}
+
+/**
+ * One scripted scenario: fault injected at FAULT_US, signals computed from
+ * the time since the fault
+ */
+struct Scenario {
+    const char* name;
+    void (*script)(float s[SM::SIG_COUNT], int32_t since_fault_us);
+    uint8_t status;
+    SM::Action expect;
+    uint32_t expect_after_ms;       // Deliberate delay (hold time or heartbeat threshold)
+    bool expect_latched;            // Still active after the fault clears at +4 s
+};
+
+static const uint32_t FAULT_US = 1000000;
+static const int32_t CLEAR_AFTER_US = 4000000;
+static const uint8_t FLYING = SM::STATUS_ARMED | SM::STATUS_AIRBORNE;
+
+static void scriptBatterySag(float s[], int32_t dt) {
+    if (dt >= 0 && dt < CLEAR_AFTER_US) s[SM::SIG_BATTERY_V] = 10.8f;   // Recovers under lower load after
+}
+static void scriptBatteryDip(float s[], int32_t dt) {
+    if (dt >= 0 && dt < 1500000) s[SM::SIG_BATTERY_V] = 11.3f;          // Punch-out sag: warn only
+}
+static void scriptFlip(float s[], int32_t dt) {
+    if (dt >= 0 && dt < CLEAR_AFTER_US) s[SM::SIG_TILT_DEG] = 95.0f;
+}
+static void scriptGyroRunaway(float s[], int32_t dt) {
+    if (dt >= 0 && dt < CLEAR_AFTER_US) s[SM::SIG_RATE_DPS] = 820.0f;
+}
+static void scriptRateSpike(float s[], int32_t dt) {
+    if (dt >= 0 && dt < 100000) s[SM::SIG_RATE_DPS] = 650.0f;            // Aerobatic flick, shorter than hold
+}
+static void scriptCommandLoss(float s[], int32_t dt) {
+    if (dt >= 0 && dt < CLEAR_AFTER_US) s[SM::SIG_COMMAND_AGE_MS] = 15.0f + dt * 0.001f;
+}
+static void scriptFusionStall(float s[], int32_t dt) {
+    if (dt >= 0 && dt < CLEAR_AFTER_US) s[SM::SIG_FUSION_AGE_MS] = 6.0f + dt * 0.001f;
+}
+static void scriptControlStall(float s[], int32_t dt) {
+    if (dt >= 0 && dt < CLEAR_AFTER_US) s[SM::SIG_CONTROL_AGE_MS] = 1.5f + dt * 0.001f;
+}
+static void scriptSinkBelowFloor(float s[], int32_t dt) {
+    if (dt >= 0) s[SM::SIG_ALTITUDE_M] = dt < CLEAR_AFTER_US ? 0.42f : 0.8f;
+}
+static void scriptAltitudeLost(float s[], int32_t dt) {
+    if (dt >= 0 && dt < CLEAR_AFTER_US) s[SM::SIG_ALTITUDE_M] = NAN;
+}
+
+static const Scenario SCENARIOS[] = {
+    {"battery sag -> land", scriptBatterySag, FLYING, SM::ACT_LAND, 2000, true},
+    {"battery dip -> warn", scriptBatteryDip, FLYING, SM::ACT_WARN, 1000, false},
+    {"flip -> kill", scriptFlip, FLYING, SM::ACT_KILL, 300, true},
+    {"gyro runaway -> kill", scriptGyroRunaway, FLYING, SM::ACT_KILL, 200, true},
+    {"rate spike -> none", scriptRateSpike, FLYING, SM::ACT_NONE, 0, false},
+    {"command loss -> land", scriptCommandLoss, FLYING, SM::ACT_LAND, 485, true},
+    {"fusion stall -> kill", scriptFusionStall, FLYING, SM::ACT_KILL, 44, true},
+    {"control stall -> kill", scriptControlStall, FLYING, SM::ACT_KILL, 18, true},
+    {"below floor -> floor", scriptSinkBelowFloor, FLYING, SM::ACT_FLOOR, 0, false},
+    {"below floor landing -> none", scriptSinkBelowFloor, FLYING | SM::STATUS_LANDING, SM::ACT_NONE, 0, false},
+    {"altitude NaN -> floor", scriptAltitudeLost, FLYING, SM::ACT_FLOOR, 0, false},
+    {"flip disarmed -> none", scriptFlip, 0, SM::ACT_NONE, 0, false},
+};
+
+struct Outcome {
+    SM::Action worst;               // Most severe action seen
+    int32_t latency_us;             // Fault onset -> first evaluate() returning `worst`
+    SM::Action at_end;              // Action after the fault cleared
+};
+
+static Outcome runScenario(const Scenario& sc) {
+    SafetyMonitor monitor;
+    monitor.configure(RULES, RULE_COUNT);
+    Outcome out = {SM::ACT_NONE, -1, SM::ACT_NONE};
+    uint32_t t = 0;
+    while (t < FAULT_US + (uint32_t)CLEAR_AFTER_US + 1000000) {
+        float s[SM::SIG_COUNT];
+        healthySignals(s);
+        sc.script(s, (int32_t)(t - FAULT_US));
+        SM::Result r = monitor.evaluate(s, t, sc.status);
+        if (r.action > out.worst) {
+            out.worst = r.action;
+            out.latency_us = (int32_t)(t - FAULT_US);
+        }
+        out.at_end = r.action;
+        t += PERIOD_US + jitter();
+    }
+    return out;
+}
+
+void test_scripted_fault_scenarios(void) {
+    host_bench::ensureOutputDir();
+    FILE* csv = fopen("test_output/flight_safety_scenarios.csv", "w");
+    if (csv) fprintf(csv, "scenario,expected,seen,latency_ms,bound_ms,at_end\n");
+
+    for (const Scenario& sc : SCENARIOS) {
+        Outcome o = runScenario(sc);
+        uint32_t bound_us = sc.expect_after_ms * 1000u + 2u * (PERIOD_US + JITTER_US);
+        printf("[SAFETY] %-28s expect %-5s seen %-5s latency %8.2f ms (bound %7.2f ms) end %s\n", sc.name,
+               SM::actionName(sc.expect), SM::actionName(o.worst), o.latency_us / 1000.0f, bound_us / 1000.0f,
+               SM::actionName(o.at_end));
+        if (csv) {
+            fprintf(csv, "%s,%s,%s,%.3f,%.3f,%s\n", sc.name, SM::actionName(sc.expect), SM::actionName(o.worst),
+                    o.latency_us / 1000.0f, bound_us / 1000.0f, SM::actionName(o.at_end));
+        }
+
+        TEST_ASSERT_EQUAL_INT_MESSAGE(sc.expect, o.worst, sc.name);
+        if (sc.expect != SM::ACT_NONE) {
+            TEST_ASSERT_TRUE_MESSAGE(o.latency_us >= (int32_t)(sc.expect_after_ms * 1000u), sc.name);
+            TEST_ASSERT_TRUE_MESSAGE(o.latency_us <= (int32_t)bound_us, sc.name);
+            TEST_ASSERT_EQUAL_INT_MESSAGE(sc.expect_latched ? sc.expect : SM::ACT_NONE, o.at_end, sc.name);
+        }
+    }
+    if (csv) fclose(csv);
+}
+
+void test_most_severe_rule_wins_and_reset_clears(void) {
+    SafetyMonitor monitor;
+    monitor.configure(RULES, RULE_COUNT);
+    float s[SM::SIG_COUNT];
+    healthySignals(s);
+    s[SM::SIG_ALTITUDE_M] = 0.3f;                   // FLOOR
+    s[SM::SIG_COMMAND_AGE_MS] = 900.0f;             // LAND
+    SM::Result r = monitor.evaluate(s, 1000, FLYING);
+    TEST_ASSERT_EQUAL_INT(SM::ACT_LAND, r.action);
+    TEST_ASSERT_EQUAL_INT(5, r.rule);
+    TEST_ASSERT_TRUE(r.changed);
+
+    r = monitor.evaluate(s, 3000, FLYING);
+    TEST_ASSERT_FALSE(r.changed);
+
+    // Latched LAND survives recovery until the disarm reset
+    healthySignals(s);
+    r = monitor.evaluate(s, 5000, FLYING);
+    TEST_ASSERT_EQUAL_INT(SM::ACT_LAND, r.action);
+    monitor.reset();
+    r = monitor.evaluate(s, 7000, FLYING);
+    TEST_ASSERT_EQUAL_INT(SM::ACT_NONE, r.action);
+}
+
+void test_kill_lands_while_dispatch_loop_stalls(void) {
+    // The "dispatch loop" ticks the control heartbeat every 2.5 ms, then blocks
+    // for 300 ms (a slow display flush, a blocking I2C retry...). The monitor
+    // thread runs on its own clock and must KILL within 20 ms + period.
+    using clock = std::chrono::steady_clock;
+    const auto origin = clock::now();
+    auto now_us = [&]() { return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - origin).count(); };
+
+    std::atomic<uint32_t> control_tick_us(1);
+    std::atomic<bool> stop(false);
+    std::atomic<uint32_t> stall_start_us(0);
+
+    std::thread dispatch([&]() {
+        uint32_t start = now_us();
+        while (now_us() - start < 200000) {
+            control_tick_us.store(now_us());
+            std::this_thread::sleep_for(std::chrono::microseconds(2500));
+        }
+        stall_start_us.store(control_tick_us.load());
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));     // Stalled
+        while (!stop.load()) {
+            control_tick_us.store(now_us());
+            std::this_thread::sleep_for(std::chrono::microseconds(2500));
+        }
+    });
+
+    SafetyMonitor monitor;
+    monitor.configure(RULES, RULE_COUNT);
+    uint32_t kill_at_us = 0;
+    uint32_t worst_period_us = 0;
+    uint32_t last_us = 0;
+    host_bench::CostStats cost;
+    auto next = clock::now();
+    while (now_us() < 600000) {
+        next += std::chrono::microseconds(PERIOD_US);
+        std::this_thread::sleep_until(next);
+        uint32_t t = now_us();
+        if (last_us) {
+            uint32_t period = t - last_us;
+            if (period > worst_period_us) worst_period_us = period;
+        }
+        last_us = t;
+
+        float s[SM::SIG_COUNT];
+        healthySignals(s);
+        s[SM::SIG_CONTROL_AGE_MS] = (float)(t - control_tick_us.load()) * 0.001f;
+        uint64_t t0 = host_bench::nowNs();
+        SM::Result r = monitor.evaluate(s, t, FLYING);
+        cost.add(host_bench::nowNs() - t0);
+        if (r.action == SM::ACT_KILL && kill_at_us == 0) kill_at_us = now_us();
+    }
+    stop.store(true);
+    dispatch.join();
+
+    uint32_t stall = stall_start_us.load();
+    float latency_ms = (kill_at_us - stall) / 1000.0f;
+    printf("[SAFETY] dispatch stall: KILL %.2f ms after the last control tick (rule 20 ms), worst monitor period %.2f ms\n",
+           latency_ms, worst_period_us / 1000.0f);
+    cost.print("SafetyMonitor::evaluate (8 rules)", PERIOD_US * 1000.0);
+
+    TEST_ASSERT_TRUE(kill_at_us > 0);
+    TEST_ASSERT_TRUE(latency_ms >= 20.0f);
+    // 20 ms rule + one period + host scheduling slack (target: + jitter only)
+    TEST_ASSERT_TRUE(latency_ms < 20.0f + PERIOD_US / 1000.0f + 10.0f);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_scripted_fault_scenarios);
+    RUN_TEST(test_most_severe_rule_wins_and_reset_clears);
+    RUN_TEST(test_kill_lands_while_dispatch_loop_stalls);
+    return UNITY_END();
+}
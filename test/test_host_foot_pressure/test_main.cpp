@@ -0,0 +1,324 @@
+/**
+ * @file test_main.cpp
+ * @brief Foot FSR pressure pipeline (FootPressureEstimator)
+ *
+ * Sensor layout, zones and thresholds are the goblin foot controller's
+ * (8 FSRs, MCP3008 10-bit counts, 15% / 5% contact hysteresis). Traces are
+ * replayed scan by scan at the 200 Hz pipeline rate.
+ *
+ * - Geometry: CoP and stability margin match a float reference (weighted
+ *   mean, convex hull by brute force) over random loads and contact sets,
+ *   including one- and two-contact supports
+ * - Incremental sums: after a long random replay the running sums equal a
+ *   fresh estimator fed the same scan; the hull is rebuilt only when the
+ *   contact set changes
+ * - Calibration: per-sensor zero / span map raw counts to per mille
+ * - Latency: a push that moves the load onto the heel, time until CoP is
+ *   90% of the way there and until the foot reads unstable; pipeline
+ *   unfiltered and at the firmware's smoothing (shift 1) vs the previous
+ *   float path (20 ms loop, 0.2 sensor EMA, 0.3 CoP EMA)
+ * - Cost: update() per scan vs the previous float update + analysis
+ *
+ * Outputs for inspection (test_output/):
+ *   foot_pressure.csv - t, cop_x, cop_y, margin, contact mask, stable over a
+ *                       replayed walking step sequence
+ *
+ * Run: pio test -e host_test -f test_host_foot_pressure
+ */
+
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+
+#include "config/components/templates/FootPressureEstimator.hpp"
+#include "../host_support/host_bench.hpp"
+
+typedef FootPressureEstimator<8> Fsr;
+
+static const int HZ = 200;
+static const int16_t X[8] = {-25, 25, -15, 15, -20, 20, -10, 10};
+static const int16_t Y[8] = {-80, -80, -40, -40, 0, 0, 40, 40};
+static const uint8_t ZONE[8] = {Fsr::ZONE_HEEL, Fsr::ZONE_HEEL, Fsr::ZONE_MID, Fsr::ZONE_MID,
+                                Fsr::ZONE_FORE, Fsr::ZONE_FORE, Fsr::ZONE_FORE, Fsr::ZONE_FORE};
+
+static void configureFoot(Fsr& f, uint8_t shift) {
+    f.configure(X, Y, ZONE, 150, 50, shift);
+}
+
+// Percent of full scale -> MCP3008 counts
+static void toRaw(const float pct[8], uint16_t raw[8]) {
+    for (int i = 0; i < 8; i++) raw[i] = (uint16_t)lroundf(std::min(100.0f, std::max(0.0f, pct[i])) * 10.23f);
+}
+
+// Reference: float convex hull of the contacting sensors + min signed distance
+static float refMargin(uint32_t mask, float px, float py) {
+    std::vector<int> pts;
+    for (int i = 0; i < 8; i++) if ((mask >> i) & 1) pts.push_back(i);
+    if (pts.empty()) return -1e9f;
+    if (pts.size() == 1)
+        return -std::max(fabsf(px - X[pts[0]]), fabsf(py - Y[pts[0]]));
+    // An edge (a, b) is on the hull if every point is on its left (or on it)
+    float best = 1e9f;
+    bool any = false;
+    for (int a : pts) for (int b : pts) {
+        if (a == b) continue;
+        float ex = X[b] - X[a], ey = Y[b] - Y[a];
+        float len = sqrtf(ex * ex + ey * ey);
+        bool hull_edge = true;
+        for (int k : pts) {
+            float cr = ex * (Y[k] - Y[a]) - ey * (X[k] - X[a]);
+            if (cr < -1e-6f) { hull_edge = false; break; }
+        }
+        if (!hull_edge) continue;
+        any = true;
+        best = std::min(best, (-ey * (px - X[a]) + ex * (py - Y[a])) / len);
+    }
+    return any ? best : -1e9f;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_geometry_matches_reference(void) {
+    srand(7);
+    Fsr f;
+    configureFoot(f, 0);
+    float worst_cop = 0.0f, worst_margin = 0.0f;
+    int checked = 0, degenerate = 0;
+    for (int k = 0; k < 5000; k++) {
+        float pct[8];
+        for (int i = 0; i < 8; i++) pct[i] = (rand() % 3 == 0) ? 0.0f : (rand() % 1000) / 10.0f;
+        uint16_t raw[8];
+        toRaw(pct, raw);
+        f.update(raw);
+
+        float w = 0, sx = 0, sy = 0;
+        for (int i = 0; i < 8; i++) {
+            float l = (float)f.load(i);
+            w += l; sx += l * X[i]; sy += l * Y[i];
+        }
+        if (w < 1.0f || f.contactMask() == 0) continue;
+        worst_cop = std::max(worst_cop, std::max(fabsf(f.copX() - sx / w), fabsf(f.copY() - sy / w)));
+        float ref = refMargin(f.contactMask(), f.copX(), f.copY());
+        worst_margin = std::max(worst_margin, fabsf(f.margin() - ref));
+        if (f.hullSize() < 3) degenerate++;
+        checked++;
+    }
+    printf("[GEOM] %d scans (%d on a point / line): worst CoP %.3f mm, worst margin %.3f mm\n",
+           checked, degenerate, worst_cop, worst_margin);
+    TEST_ASSERT_TRUE(worst_cop < 0.15f);
+    TEST_ASSERT_TRUE(worst_margin < 0.25f);
+    TEST_ASSERT_TRUE(degenerate > 0);
+
+    // Flat stance: CoP in the middle, well inside, stable
+    float flat[8] = {40, 40, 40, 40, 40, 40, 40, 40};
+    uint16_t raw[8];
+    toRaw(flat, raw);
+    Fsr g;
+    configureFoot(g, 0);
+    g.update(raw);
+    printf("[GEOM] flat stance: CoP (%.1f, %.1f) mm, margin %.1f mm\n", g.copX(), g.copY(), g.margin());
+    TEST_ASSERT_TRUE(g.isStable(10));
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 0.0f, g.copX());
+
+    // On the toes only: a line support is never stable
+    float toes[8] = {0, 0, 0, 0, 0, 0, 60, 60};
+    toRaw(toes, raw);
+    g.update(raw);
+    TEST_ASSERT_EQUAL(2, g.hullSize());
+    TEST_ASSERT_TRUE(g.margin() <= 0.0f);
+    TEST_ASSERT_FALSE(g.isStable(10));
+}
+
+void test_incremental_sums_and_hull_cache(void) {
+    srand(11);
+    Fsr f;
+    configureFoot(f, 0);
+    uint32_t mask_changes = 0;
+    uint32_t prev_mask = 0;
+    uint16_t raw[8];
+    for (int k = 0; k < 200000; k++) {
+        // Slowly varying loads with occasional lift-offs
+        float pct[8];
+        for (int i = 0; i < 8; i++) {
+            float s = 40.0f + 35.0f * sinf(k * 0.0007f * (i + 1) + i);
+            pct[i] = (rand() % 500 == 0) ? 0.0f : s + (rand() % 100) / 50.0f;
+        }
+        toRaw(pct, raw);
+        f.update(raw);
+        if (f.contactMask() != prev_mask) mask_changes++;
+        prev_mask = f.contactMask();
+    }
+    printf("[INCR] 200000 scans: %u contact changes, %u hull rebuilds\n",
+           (unsigned)mask_changes, (unsigned)f.hullBuilds());
+    TEST_ASSERT_EQUAL(mask_changes, f.hullBuilds());
+    TEST_ASSERT_TRUE(f.hullBuilds() < 200000 / 10);
+
+    // Same final state from scratch: a fresh estimator fed only the last scan
+    Fsr fresh;
+    configureFoot(fresh, 0);
+    fresh.update(raw);
+    printf("[INCR] after replay CoP (%d, %d) vs fresh (%d, %d), 1/16 mm\n",
+           (int)f.copXQ(), (int)f.copYQ(), (int)fresh.copXQ(), (int)fresh.copYQ());
+    TEST_ASSERT_EQUAL(fresh.totalLoad(), f.totalLoad());
+    TEST_ASSERT_EQUAL(fresh.copXQ(), f.copXQ());
+    TEST_ASSERT_EQUAL(fresh.copYQ(), f.copYQ());
+    TEST_ASSERT_EQUAL(fresh.marginQ(), f.marginQ());
+}
+
+void test_calibration(void) {
+    Fsr f;
+    configureFoot(f, 0);
+    f.setCalibration(0, 100, 600);      // Zero at 100 counts, full scale at 600
+    uint16_t raw[8] = {100, 0, 0, 0, 0, 0, 0, 0};
+    f.update(raw);
+    TEST_ASSERT_EQUAL(0, f.load(0));
+    raw[0] = 350;
+    f.update(raw);
+    TEST_ASSERT_INT_WITHIN(1, 500, f.load(0));
+    raw[0] = 900;
+    f.update(raw);
+    TEST_ASSERT_EQUAL(1000, f.load(0));
+    raw[0] = 40;
+    f.update(raw);
+    TEST_ASSERT_EQUAL(0, f.load(0));
+}
+
+// The previous float path: 20 ms control loop, 0.2 EMA per sensor, 0.3 EMA on CoP
+struct LegacyFoot {
+    float p[8] = {0};
+    float cop_x = 0, cop_y = 0;
+    bool stable = false;
+    void update(const uint16_t raw[8]) {
+        float total = 0, wx = 0, wy = 0;
+        for (int i = 0; i < 8; i++) {
+            float pct = raw[i] / 1023.0f * 100.0f;
+            p[i] = 0.2f * pct + 0.8f * p[i];
+            total += p[i]; wx += p[i] * X[i]; wy += p[i] * Y[i];
+        }
+        if (total > 1.0f) {
+            cop_x = 0.3f * wx / total + 0.7f * cop_x;
+            cop_y = 0.3f * wy / total + 0.7f * cop_y;
+        }
+        float heel = (p[0] + p[1]) / 2, fore = (p[4] + p[5] + p[6] + p[7]) / 4;
+        float left = (p[0] + p[2] + p[4] + p[6]) / 4, right = (p[1] + p[3] + p[5] + p[7]) / 4;
+        float lr = (left - right) / (left + right + 1) * 100, fa = (fore - heel) / (fore + heel + 1) * 100;
+        stable = fabsf(lr) < 30 && fabsf(fa) < 30 && total / 8 > 10;
+    }
+};
+
+void test_push_latency(void) {
+    // Flat stance, then at t = 0 the load rolls onto the heel (push from the front)
+    float flat[8] = {40, 40, 40, 40, 40, 40, 40, 40};
+    float heel[8] = {90, 90, 3, 3, 0, 0, 0, 0};
+    uint16_t raw_flat[8], raw_heel[8];
+    toRaw(flat, raw_flat);
+    toRaw(heel, raw_heel);
+    const float cop_final = -80.0f + 0.0f;              // Heel row
+    const float cop_start = 0.0f;
+    const float target = cop_start + 0.9f * (cop_final - cop_start);
+
+
+    int cop_ms[2] = {-1, -1}, unstable_ms[2] = {-1, -1};
+    for (int shift = 0; shift <= 1; shift++) {
+        Fsr f;
+        configureFoot(f, shift);
+        for (int k = 0; k < HZ; k++) f.update(raw_flat);
+        float cop0 = f.copY();
+        for (int k = 1; k <= HZ; k++) {
+            f.update(raw_heel);
+            int t_ms = k * 1000 / HZ;
+            if (cop_ms[shift] < 0 && f.copY() <= cop0 + 0.9f * (cop_final - cop0)) cop_ms[shift] = t_ms;
+            if (unstable_ms[shift] < 0 && !f.isStable(10)) unstable_ms[shift] = t_ms;
+        }
+    }
+
+    LegacyFoot legacy;
+    for (int k = 0; k < 50; k++) legacy.update(raw_flat);
+    int legacy_cop_ms = -1, legacy_unstable_ms = -1;
+    for (int k = 1; k <= 100; k++) {
+        legacy.update(raw_heel);
+        int t_ms = k * 20;
+        if (legacy_cop_ms < 0 && legacy.cop_y <= target) legacy_cop_ms = t_ms;
+        if (legacy_unstable_ms < 0 && !legacy.stable) legacy_unstable_ms = t_ms;
+    }
+    printf("[LATENCY] CoP 90%%: pipeline %d ms unfiltered / %d ms shift 1, previous %d ms\n",
+           cop_ms[0], cop_ms[1], legacy_cop_ms);
+    printf("[LATENCY] unstable flag: pipeline %d ms / %d ms, previous %d ms\n",
+           unstable_ms[0], unstable_ms[1], legacy_unstable_ms);
+    TEST_ASSERT_TRUE(cop_ms[0] > 0 && cop_ms[0] <= 1000 / HZ);
+    TEST_ASSERT_TRUE(unstable_ms[0] > 0 && unstable_ms[0] <= 1000 / HZ);
+    TEST_ASSERT_TRUE(cop_ms[1] > 0 && cop_ms[1] <= 30);
+    TEST_ASSERT_TRUE(unstable_ms[1] > 0 && unstable_ms[1] <= 30);
+    TEST_ASSERT_TRUE(legacy_cop_ms < 0 || legacy_cop_ms > 5 * cop_ms[1]);
+}
+
+// Walking: heel strike -> flat -> toe-off -> swing, 1 s per step
+static void stepLoads(float phase, float pct[8]) {
+    for (int i = 0; i < 8; i++) pct[i] = 0.0f;
+    if (phase >= 0.6f) return;                          // Swing
+    float u = phase / 0.6f;                             // 0..1 over stance
+    float heel = u < 0.5f ? 80.0f * (1.0f - u * 2.0f) + 10.0f : 0.0f;
+    float mid = 50.0f * sinf((float)M_PI * u);
+    float fore = u > 0.2f ? 80.0f * sinf((float)M_PI * (u - 0.2f) / 0.8f) : 0.0f;
+    float toe = u > 0.5f ? 90.0f * sinf((float)M_PI * (u - 0.5f) / 0.5f) : 0.0f;
+    pct[0] = heel * 1.1f; pct[1] = heel * 0.9f;
+    pct[2] = mid; pct[3] = mid * 0.9f;
+    pct[4] = fore; pct[5] = fore * 0.85f;
+    pct[6] = toe; pct[7] = toe * 0.7f;
+}
+
+void test_replay_walking_cost(void) {
+    Fsr f;
+    configureFoot(f, 1);
+    LegacyFoot legacy;
+    host_bench::CostStats cost, legacy_cost;
+    host_bench::ensureOutputDir();
+    FILE* out = fopen("test_output/foot_pressure.csv", "w");
+    if (out) fprintf(out, "t,cop_x,cop_y,margin,contacts,stable\n");
+
+    int stable_ticks = 0, contact_ticks = 0;
+    for (int k = 0; k < 10 * HZ; k++) {
+        float pct[8];
+        stepLoads(fmodf((float)k / HZ, 1.0f), pct);
+        for (int i = 0; i < 8; i++) pct[i] += (rand() % 100) / 100.0f;  // ADC noise
+        uint16_t raw[8];
+        toRaw(pct, raw);
+
+        uint64_t t0 = host_bench::nowNs();
+        f.update(raw);
+        bool stable = f.isStable(10);
+        uint64_t t1 = host_bench::nowNs();
+        cost.add(t1 - t0);
+
+        t0 = host_bench::nowNs();
+        legacy.update(raw);
+        t1 = host_bench::nowNs();
+        legacy_cost.add(t1 - t0);
+
+        if (f.inContact()) contact_ticks++;
+        if (stable) stable_ticks++;
+        if (out) fprintf(out, "%.3f,%.2f,%.2f,%.2f,%u,%d\n", (float)k / HZ, f.copX(), f.copY(),
+                         std::max(-200.0f, f.margin()), (unsigned)f.contactMask(), stable ? 1 : 0);
+    }
+    if (out) fclose(out);
+    printf("[REPLAY] 10 steps: contact %d%% of ticks, stable %d%% of contact, %u hull rebuilds\n",
+           contact_ticks * 100 / (10 * HZ), stable_ticks * 100 / std::max(1, contact_ticks),
+           (unsigned)f.hullBuilds());
+    TEST_ASSERT_TRUE(stable_ticks > 0 && stable_ticks < contact_ticks);
+    cost.print("update() 8 FSRs + margin (integer)", 1e9 / HZ);
+    legacy_cost.print("previous float update + analysis", 1e9 / HZ);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_geometry_matches_reference);
+    RUN_TEST(test_incremental_sums_and_hull_cache);
+    RUN_TEST(test_calibration);
+    RUN_TEST(test_push_latency);
+    RUN_TEST(test_replay_walking_cost);
+    return UNITY_END();
+}
@@ -0,0 +1,363 @@
+/**
+ * @file test_main.cpp
+ * @brief CPG gait generator over fixed-point spline tables (CpgGaitEngine)
+ *
+ * Gaits are the flying dragon leg formulas from LEG_FEET_DESIGN.md
+ * (walk, run, jump, stand), 2 legs x 4 joints, ticked at 50 Hz as
+ * flying_dragon_leg_assembly does.
+ *
+ * - Tables: the fixed-point spline hits every knot to 1/64 deg and
+ *   matches a float Catmull-Rom between knots
+ * - Phase locking: walking holds L/R in anti-phase; walk -> jump pulls
+ *   the legs into phase and jump -> walk back apart (the unstable
+ *   half-turn case), both within 1.5 s, without any phase step
+ * - Continuity: speed changes slew the frequency; gait switches,
+ *   including one in the middle of another blend, move no joint faster
+ *   than the gaits themselves do
+ * - Cost: tick() for 8 joints vs evaluating the formulas with sinf()
+ *
+ * Outputs for inspection (test_output/):
+ *   gait_engine.csv - t, gait, phase L/R, 8 joint angles over a scripted
+ *                     walk / speed up / run / jump / walk / stand run
+ *
+ * Run: pio test -e host_test -f test_host_gait_engine
+ */
+
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include <algorithm>
+
+#include "config/components/templates/CpgGaitEngine.hpp"
+#include "../host_support/host_bench.hpp"
+
+typedef CpgGaitEngine<2, 4> Engine;
+
+static const uint32_t HZ = 50;
+static const int N = Engine::SEGMENTS;
+enum { IDLE, WALK, RUN, JUMP };
+static const float CYCLE_HZ[4] = {0.0f, 0.833f, 1.667f, 2.5f};
+
+// LEG_FEET_DESIGN.md, same sampling as flying_dragon_leg_assembly
+static void gaitPose(int mode, float phi, float q[4]) {
+    static const float key[][4] = {
+        {0.00f, 0.0f, 20.0f, 5.0f},
+        {0.15f, 30.0f, 90.0f, -30.0f},
+        {0.30f, -10.0f, 0.0f, 30.0f},
+        {0.60f, 10.0f, 30.0f, 0.0f},
+        {1.00f, 0.0f, 20.0f, 5.0f},
+    };
+    float w = sinf(2.0f * (float)M_PI * phi);
+    q[0] = 0.0f; q[1] = 0.0f; q[2] = 20.0f; q[3] = 5.0f;
+    if (mode == WALK) {
+        q[0] = 6.0f * w;
+        q[1] = 40.0f * w;
+        q[2] = std::max(0.0f, -0.6f * q[1] + 20.0f);
+        q[3] = 0.25f * (q[2] - q[1]);
+    } else if (mode == RUN) {
+        q[1] = 55.0f * w;
+        q[2] = std::min(90.0f, std::max(0.0f, -1.2f * q[1] + 30.0f));
+        q[3] = 20.0f * sinf(2.0f * (float)M_PI * (phi + 0.25f));
+    } else if (mode == JUMP) {
+        int i = 1;
+        while (i < 4 && phi > key[i][0]) i++;
+        float u = (phi - key[i - 1][0]) / (key[i][0] - key[i - 1][0]);
+        for (int j = 1; j < 4; j++) q[j] = key[i - 1][j] + u * (key[i][j] - key[i - 1][j]);
+    }
+}
+
+static void knotsFor(int mode, float knots[4][N]) {
+    for (int s = 0; s < N; s++) {
+        float q[4];
+        gaitPose(mode, (float)s / N, q);
+        for (int j = 0; j < 4; j++) knots[j][s] = q[j];
+    }
+}
+
+static void configureDragon(Engine& e, uint32_t hz = HZ) {
+    static const float alternate[2] = {0.0f, 0.5f};
+    static const float together[2] = {0.0f, 0.0f};
+    e.configure(hz, 2.0f);
+    e.setJointLimits(0, -45.0f, 45.0f);
+    e.setJointLimits(1, -60.0f, 60.0f);
+    e.setJointLimits(2, 0.0f, 120.0f);
+    e.setJointLimits(3, -45.0f, 45.0f);
+    float knots[4][N];
+    for (int g = IDLE; g <= JUMP; g++) {
+        knotsFor(g, knots);
+        TEST_ASSERT_TRUE(e.setGait(g, knots, CYCLE_HZ[g], g == JUMP ? together : alternate));
+    }
+}
+
+// Signed distance of the L/R relative phase from a target, turns
+static float relError(const Engine& e, float target) {
+    float d = e.relativePhase(1) - target;
+    return d - roundf(d);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_tables_match_spline(void) {
+    // One segment per tick: cycle frequency = tick rate / SEGMENTS
+    Engine e;
+    configureDragon(e);
+    const float cycle = (float)HZ / N;
+    float knots[4][N];
+    knotsFor(WALK, knots);
+    const float offsets[2] = {0.0f, 0.5f};
+    e.setGait(WALK, knots, cycle, offsets);
+    e.reset(WALK, 1.0f);
+
+    float worst_knot = 0.0f;
+    for (int k = 1; k <= 2 * N; k++) {
+        e.tick();
+        int s = k % N;
+        for (int j = 0; j < 4; j++) {
+            worst_knot = fmaxf(worst_knot, fabsf(e.angle(0, j) - knots[j][s]));
+            worst_knot = fmaxf(worst_knot, fabsf(e.angle(1, j) - knots[j][(s + N / 2) % N]));
+        }
+    }
+    printf("[TABLE] worst knot error %.4f deg\n", worst_knot);
+    TEST_ASSERT_TRUE(worst_knot <= 1.0f / 64.0f);
+
+    // Between knots: 4 ticks per segment against float Catmull-Rom
+    Engine f;
+    configureDragon(f);
+    f.setGait(WALK, knots, cycle / 4.0f, offsets);
+    f.reset(WALK, 1.0f);
+    float worst_mid = 0.0f;
+    for (int k = 1; k <= 4 * N; k++) {
+        f.tick();
+        int s = (k / 4) % N;
+        float t = (k % 4) / 4.0f;
+        for (int j = 0; j < 4; j++) {
+            const float* p = knots[j];
+            float p0 = p[(s + N - 1) % N], p1 = p[s], p2 = p[(s + 1) % N], p3 = p[(s + 2) % N];
+            float ref = p1 + t * (0.5f * (p2 - p0) +
+                        t * ((p0 - 2.5f * p1 + 2.0f * p2 - 0.5f * p3) +
+                        t * (0.5f * (p3 - p0) + 1.5f * (p1 - p2))));
+            ref = j == 2 ? fmaxf(ref, 0.0f) : ref;
+            worst_mid = fmaxf(worst_mid, fabsf(f.angle(0, j) - ref));
+        }
+    }
+    printf("[TABLE] worst in-segment error vs float spline %.4f deg\n", worst_mid);
+    TEST_ASSERT_TRUE(worst_mid < 0.1f);
+
+    // Against the formulas themselves: 16 knots per cycle are enough
+    Engine g;
+    configureDragon(g);
+    g.reset(RUN, 1.0f);
+    float worst_formula = 0.0f;
+    for (int k = 0; k < 10 * (int)HZ; k++) {
+        g.tick();
+        float q[4];
+        gaitPose(RUN, g.phase(0), q);
+        for (int j = 0; j < 4; j++) worst_formula = fmaxf(worst_formula, fabsf(g.angle(0, j) - q[j]));
+    }
+    printf("[TABLE] run gait vs formula: worst %.2f deg\n", worst_formula);
+    TEST_ASSERT_TRUE(worst_formula < 5.0f);
+}
+
+void test_phase_locking(void) {
+    Engine e;
+    configureDragon(e);
+    e.reset(WALK, 1.0f);
+
+    // Steady walk: anti-phase holds
+    float worst = 0.0f;
+    for (int k = 0; k < 10 * (int)HZ; k++) {
+        e.tick();
+        worst = fmaxf(worst, fabsf(relError(e, 0.5f)));
+    }
+    printf("[LOCK] walk 10 s: worst L/R error %.4f turns, %.3f Hz\n", worst, e.frequency());
+    TEST_ASSERT_TRUE(worst < 1.0f / 256.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, CYCLE_HZ[WALK], e.frequency());
+
+    // Walk -> jump -> walk: both transitions lock within 1.5 s
+    const int modes[2] = {JUMP, WALK};
+    const float target[2] = {0.0f, 0.5f};
+    for (int m = 0; m < 2; m++) {
+        e.select(modes[m], 1.0f, 0.4f);
+        int locked_at = -1;
+        float max_rel_step = 0.0f;
+        float prev = e.relativePhase(1);
+        for (int k = 0; k < 3 * (int)HZ; k++) {
+            e.tick();
+            float d = e.relativePhase(1) - prev;
+            max_rel_step = fmaxf(max_rel_step, fabsf(d - roundf(d)));
+            prev = e.relativePhase(1);
+            if (locked_at < 0 && fabsf(relError(e, target[m])) < 0.01f) locked_at = k + 1;
+        }
+        printf("[LOCK] -> %s: locked after %.2f s, largest relative phase step %.4f turns/tick\n",
+               modes[m] == JUMP ? "jump" : "walk", locked_at / (float)HZ, max_rel_step);
+        TEST_ASSERT_TRUE(locked_at > 0 && locked_at <= 1.5f * HZ);
+        TEST_ASSERT_TRUE(fabsf(relError(e, target[m])) < 1.0f / 256.0f);
+        TEST_ASSERT_TRUE(max_rel_step < 0.05f);
+    }
+}
+
+struct Frame { float t; int gait; float phase[2]; float q[2][4]; };
+
+static float maxStep(const std::vector<Frame>& f, size_t from, size_t to) {
+    float worst = 0.0f;
+    for (size_t k = std::max<size_t>(from, 1); k < to && k < f.size(); k++)
+        for (int l = 0; l < 2; l++)
+            for (int j = 0; j < 4; j++)
+                worst = fmaxf(worst, fabsf(f[k].q[l][j] - f[k - 1].q[l][j]));
+    return worst;
+}
+
+// Scripted session: (time s, gait, speed)
+struct Cue { float t; int gait; float speed; };
+static const Cue SCRIPT[] = {
+    {0.0f, WALK, 1.0f}, {3.0f, WALK, 1.5f}, {5.0f, RUN, 1.0f},
+    {8.0f, JUMP, 1.0f}, {8.2f, WALK, 0.8f}, {11.0f, IDLE, 1.0f},
+};
+static const int CUES = sizeof(SCRIPT) / sizeof(SCRIPT[0]);
+static const float BLEND_S = 0.4f;
+
+static std::vector<Frame> runScript(Engine& e, float blend_s) {
+    std::vector<Frame> out;
+    e.reset(IDLE, 1.0f);
+    int cue = 0;
+    for (int k = 0; k < 13 * (int)HZ; k++) {
+        float t = (float)k / HZ;
+        while (cue < CUES && t >= SCRIPT[cue].t - 1e-4f) {
+            if (cue > 0 && SCRIPT[cue].gait == SCRIPT[cue - 1].gait) e.setSpeed(SCRIPT[cue].speed);
+            else e.select(SCRIPT[cue].gait, SCRIPT[cue].speed, blend_s);
+            cue++;
+        }
+        e.tick();
+        Frame f;
+        f.t = t;
+        f.gait = e.gait();
+        for (int l = 0; l < 2; l++) {
+            f.phase[l] = e.phase(l);
+            for (int j = 0; j < 4; j++) f.q[l][j] = e.angle(l, j);
+        }
+        out.push_back(f);
+    }
+    return out;
+}
+
+void test_blend_continuity(void) {
+    // How fast each gait moves its joints on its own
+    float steady[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (int g = WALK; g <= JUMP; g++) {
+        Engine e;
+        configureDragon(e);
+        e.reset(g, g == WALK ? 1.5f : 1.0f);
+        std::vector<Frame> f;
+        for (int k = 0; k < 4 * (int)HZ; k++) {
+            e.tick();
+            Frame fr;
+            for (int l = 0; l < 2; l++)
+                for (int j = 0; j < 4; j++) fr.q[l][j] = e.angle(l, j);
+            f.push_back(fr);
+        }
+        steady[g] = maxStep(f, 0, f.size());
+    }
+    printf("[BLEND] steady max step deg/tick: walk %.2f run %.2f jump %.2f\n",
+           steady[WALK], steady[RUN], steady[JUMP]);
+
+    Engine e;
+    configureDragon(e);
+    std::vector<Frame> f = runScript(e, BLEND_S);
+    Engine hard;
+    configureDragon(hard);
+    std::vector<Frame> h = runScript(hard, 0.0f);
+
+    for (int c = 1; c < CUES; c++) {
+        size_t k0 = (size_t)lroundf(SCRIPT[c].t * HZ);
+        size_t k1 = k0 + (size_t)(BLEND_S * HZ) + 2;
+        float from = steady[SCRIPT[c - 1].gait];
+        float to = steady[SCRIPT[c].gait];
+        float bound = fmaxf(from, to) * 1.2f + 0.5f;
+        float blended = maxStep(f, k0, k1);
+        float cut = maxStep(h, k0, k0 + 2);
+        printf("[BLEND] %5.1f s gait %d -> %d: max step %.2f deg/tick (bound %.2f, hard switch %.2f)\n",
+               SCRIPT[c].t, SCRIPT[c - 1].gait, SCRIPT[c].gait, blended, bound, cut);
+        TEST_ASSERT_TRUE(blended <= bound);
+    }
+
+    // Speed change: frequency ramps, never steps
+    Engine s;
+    configureDragon(s);
+    s.reset(WALK, 1.0f);
+    s.setSpeed(1.5f);
+    float prev = s.frequency();
+    float max_df = 0.0f;
+    int reached = -1;
+    for (int k = 0; k < 2 * (int)HZ; k++) {
+        s.tick();
+        max_df = fmaxf(max_df, fabsf(s.frequency() - prev));
+        prev = s.frequency();
+        if (reached < 0 && fabsf(prev - 1.5f * CYCLE_HZ[WALK]) < 1e-3f) reached = k + 1;
+    }
+    printf("[SPEED] 0.83 -> 1.25 Hz in %.2f s, largest step %.4f Hz/tick\n", reached / (float)HZ, max_df);
+    TEST_ASSERT_TRUE(reached > 5 && reached <= (int)HZ);
+    TEST_ASSERT_TRUE(max_df < 0.05f);
+
+    // Stand at the end: settled on the stand pose, legs still
+    for (int j = 0; j < 4; j++) {
+        float q[4];
+        gaitPose(IDLE, 0.0f, q);
+        TEST_ASSERT_FLOAT_WITHIN(0.05f, q[j], f.back().q[0][j]);
+        TEST_ASSERT_FLOAT_WITHIN(0.05f, q[j], f.back().q[1][j]);
+    }
+
+    host_bench::ensureOutputDir();
+    FILE* out = fopen("test_output/gait_engine.csv", "w");
+    if (out) {
+        fprintf(out, "t,gait,phase_l,phase_r,l_hip_x,l_hip_y,l_knee,l_ankle,r_hip_x,r_hip_y,r_knee,r_ankle\n");
+        for (const Frame& fr : f) {
+            fprintf(out, "%.3f,%d,%.4f,%.4f", fr.t, fr.gait, fr.phase[0], fr.phase[1]);
+            for (int l = 0; l < 2; l++)
+                for (int j = 0; j < 4; j++) fprintf(out, ",%.3f", fr.q[l][j]);
+            fprintf(out, "\n");
+        }
+        fclose(out);
+    }
+}
+
+void test_tick_cost(void) {
+    Engine e;
+    configureDragon(e);
+    e.reset(WALK, 1.0f);
+    host_bench::CostStats table_cost, formula_cost;
+    volatile float sink = 0.0f;
+    float phi = 0.0f;
+    for (int k = 0; k < 20000; k++) {
+        if (k % 500 == 0) e.select((k / 500) % 3 + 1, 1.0f, 0.4f);
+        uint64_t t0 = host_bench::nowNs();
+        e.tick();
+        uint64_t t1 = host_bench::nowNs();
+        table_cost.add(t1 - t0);
+        sink = sink + e.angle(1, 2);
+
+        // What the leg act() would cost evaluating the formulas directly
+        t0 = host_bench::nowNs();
+        phi += CYCLE_HZ[RUN] / HZ;
+        phi -= floorf(phi);
+        float q[2][4];
+        gaitPose(RUN, phi, q[0]);
+        gaitPose(RUN, fmodf(phi + 0.5f, 1.0f), q[1]);
+        t1 = host_bench::nowNs();
+        formula_cost.add(t1 - t0);
+        sink = sink + q[1][2];
+    }
+    table_cost.print("tick() 2 legs x 4 joints (tables)", 1000000000 / HZ);
+    formula_cost.print("formulas with sinf(), 2 legs", 1000000000 / HZ);
+    (void)sink;
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_tables_match_spline);
+    RUN_TEST(test_phase_locking);
+    RUN_TEST(test_blend_continuity);
+    RUN_TEST(test_tick_cost);
+    return UNITY_END();
+}
@@ -0,0 +1,233 @@
+/**
+ * @file test_main.cpp
+ * @brief Saccade / pursuit / fixation gaze controller (GazeController)
+ *
+ * The controller runs at 200 Hz. Targets arrive as 20 Hz samples the way
+ * SensorFusion publishes them. Where the neck matters it is simulated by
+ * a MinJerkTrajectory following the controller's neck requests, with the
+ * actual neck pose fed back every tick.
+ *
+ * - Main sequence: step targets of 2-30 deg; peak gaze velocity matches
+ *   Vmax (1 - exp(-A/C)), duration grows with amplitude, lands on target
+ * - Smooth pursuit: a 20 deg/s target is tracked at ~0.95 gain with a
+ *   small position error and only a few catch-up saccades
+ * - Fixation: microsaccades every 0.5-1.5 s, 0.1-0.4 deg, gaze stays on
+ *   target
+ * - Neck offload: a 50 deg target is foveated by a saccade first; the neck
+ *   then turns and the eyes counter-rotate back toward centre while gaze
+ *   holds on target
+ * - Pupils follow eye angle and converge on near targets
+ * - Cost: tick() mean and worst (saccade planning tick)
+ *
+ * Outputs for inspection (test_output/):
+ *   gaze_offload.csv - t, target, gaze, eye, neck (pan, deg)
+ *
+ * Run: pio test -e host_test -f test_host_gaze_controller
+ */
+
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "config/components/templates/GazeController.hpp"
+#include "../host_support/host_bench.hpp"
+
+static const uint32_t HZ = 200;
+static const uint32_t SAMPLE_EVERY = HZ / 20;     // 20 Hz target samples
+
+static float deg(int32_t q16) { return (float)q16 / 65536.0f; }
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_main_sequence(void) {
+    const float amps[] = {2.0f, 5.0f, 10.0f, 20.0f, 30.0f};
+    float last_duration = 0.0f;
+    for (float A : amps) {
+        GazeController g;
+        g.configure(HZ, 45.0f, 30.0f, 1000.0f);     // Neck never recruited
+        g.setTarget(A, 0.0f);
+        float prev = 0.0f, vpk = 0.0f, overshoot = 0.0f;
+        uint32_t start = 0, end = 0;
+        for (uint32_t k = 1; k < HZ; k++) {
+            g.tick();
+            float p = deg(g.output().gaze_pan_q16);
+            float v = (p - prev) * HZ;
+            prev = p;
+            if (v > vpk) vpk = v;
+            if (p - A > overshoot) overshoot = p - A;
+            if (start == 0 && g.getMode() == GazeController::SACCADE) start = k;
+            if (start != 0 && end == 0 && g.getMode() != GazeController::SACCADE) end = k;
+        }
+        float expect_vp = GazeController::MAIN_SEQ_VMAX * (1.0f - expf(-A / GazeController::MAIN_SEQ_C));
+        float duration = (float)(end - start) / HZ;
+        printf("[MAINSEQ] A %4.1f deg  peak %5.1f deg/s (main sequence %5.1f)  duration %3.0f ms  final %.3f  saccades %lu\n",
+               A, vpk, expect_vp, duration * 1000.0f, prev, (unsigned long)g.getStats().saccades);
+        // Peak of a 5 ms sampled min-jerk lies within a few % of the analytic one
+        TEST_ASSERT_FLOAT_WITHIN(expect_vp * 0.08f, expect_vp, vpk);
+        TEST_ASSERT_TRUE(duration >= last_duration);
+        TEST_ASSERT_FLOAT_WITHIN(0.4f, A, prev);       // Within a microsaccade of the target
+        TEST_ASSERT_TRUE(overshoot <= 0.41f);
+        TEST_ASSERT_EQUAL_UINT32(1, g.getStats().saccades);
+        last_duration = duration;
+    }
+}
+
+void test_smooth_pursuit(void) {
+    GazeController g;
+    g.configure(HZ, 45.0f, 30.0f, 1000.0f);
+    const float vel = 20.0f;
+    float worst_err = 0.0f, gain_sum = 0.0f;
+    int gain_n = 0;
+    float prev = 0.0f;
+    for (uint32_t k = 0; k < 3 * HZ; k++) {
+        float target = -20.0f + vel * (float)k / HZ;
+        if (k % SAMPLE_EVERY == 0) g.setTarget(target, 0.0f);
+        g.tick();
+        float p = deg(g.output().gaze_pan_q16);
+        if (k > HZ && g.getMode() == GazeController::PURSUIT) {
+            worst_err = fmaxf(worst_err, fabsf(target - p));
+            gain_sum += (p - prev) * HZ / vel;
+            gain_n++;
+        }
+        prev = p;
+    }
+    float gain = gain_n ? gain_sum / gain_n : 0.0f;
+    printf("[PURSUIT] gain %.3f  worst error %.2f deg  saccades %lu  pursuit ticks %d\n",
+           gain, worst_err, (unsigned long)g.getStats().saccades, gain_n);
+    TEST_ASSERT_TRUE(gain_n > (int)HZ);          // Pursuit, not a saccade train
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 1.0f, gain);
+    TEST_ASSERT_TRUE(worst_err < 1.0f);
+    TEST_ASSERT_TRUE(g.getStats().saccades <= 3);
+}
+
+void test_fixation_microsaccades(void) {
+    GazeController g;
+    g.configure(HZ, 45.0f, 30.0f, 1000.0f);
+    g.setTarget(8.0f, -4.0f);
+    for (uint32_t k = 0; k < HZ; k++) g.tick();   // Land
+    uint32_t micro0 = g.getStats().microsaccades;
+    uint32_t sacc0 = g.getStats().saccades;
+
+    float worst = 0.0f;
+    for (uint32_t k = 0; k < 20 * HZ; k++) {
+        if (k % SAMPLE_EVERY == 0) g.setTarget(8.0f, -4.0f);
+        g.tick();
+        float ep = deg(g.output().gaze_pan_q16) - 8.0f;
+        float et = deg(g.output().gaze_tilt_q16) + 4.0f;
+        worst = fmaxf(worst, fmaxf(fabsf(ep), fabsf(et)));
+    }
+    uint32_t micro = g.getStats().microsaccades - micro0;
+    printf("[FIXATE] 20 s: %lu microsaccades, %lu saccades, worst offset %.2f deg\n",
+           (unsigned long)micro, (unsigned long)(g.getStats().saccades - sacc0), worst);
+    TEST_ASSERT_TRUE(micro >= 13 && micro <= 40);
+    TEST_ASSERT_EQUAL_UINT32(sacc0, g.getStats().saccades);
+    TEST_ASSERT_TRUE(worst <= 0.41f);
+}
+
+void test_neck_offload_counter_rotation(void) {
+    GazeController g;
+    g.configure(HZ, 45.0f, 30.0f, 15.0f);
+    MinJerkTrajectory<2> neck;
+    neck.configure(HZ);
+    neck.setLimits(0, 120.0f, 600.0f);
+    neck.setLimits(1, 90.0f, 500.0f);
+    uint16_t seen_seq = g.output().neck_request_seq;
+
+    host_bench::ensureOutputDir();
+    FILE* f = fopen("test_output/gaze_offload.csv", "w");
+    if (f) fprintf(f, "t,target,gaze,eye,neck\n");
+
+    const float target = 50.0f;
+    uint32_t foveated_at = 0;
+    float worst_after = 0.0f;
+    for (uint32_t k = 0; k < 2 * HZ; k++) {
+        if (k % SAMPLE_EVERY == 0) g.setTarget(target, 5.0f);
+        g.setNeckPoseQ16(neck.positionQ16(0), neck.positionQ16(1));
+        const GazeController::Output& o = g.tick();
+        if (o.neck_request_seq != seen_seq) {
+            seen_seq = o.neck_request_seq;
+            float req[2] = {deg(o.neck_pan_q16), deg(o.neck_tilt_q16)};
+            neck.moveTo(req);
+        }
+        neck.tick();
+        float gaze = deg(o.gaze_pan_q16);
+        if (foveated_at == 0 && fabsf(gaze - target) < 0.5f) foveated_at = k;
+        // From the first foveation on (plus one saccade's worth of slack
+        // for the eyes reaching their limit), gaze must hold
+        if (foveated_at && k > foveated_at + HZ / 10) worst_after = fmaxf(worst_after, fabsf(gaze - target));
+        if (f) fprintf(f, "%.3f,%.2f,%.3f,%.3f,%.3f\n", (double)k / HZ, target, gaze,
+                       deg(o.eye_pan_q16), deg(neck.positionQ16(0)));
+    }
+    if (f) fclose(f);
+
+    const GazeController::Output& o = g.output();
+    printf("[OFFLOAD] foveated at %lu ms, worst gaze error after %.2f deg, eye ends %.2f, neck %.2f, requests %lu\n",
+           (unsigned long)(foveated_at * 1000 / HZ), worst_after, deg(o.eye_pan_q16),
+           deg(neck.positionQ16(0)), (unsigned long)g.getStats().neck_requests);
+    TEST_ASSERT_TRUE(foveated_at > 0 && foveated_at < HZ / 2);
+    TEST_ASSERT_TRUE(worst_after < 1.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, target, deg(neck.positionQ16(0)));
+    TEST_ASSERT_TRUE(fabsf(deg(o.eye_pan_q16)) < 1.0f);      // Eyes re-centred
+    TEST_ASSERT_EQUAL_UINT32(1, g.getStats().neck_requests);
+}
+
+void test_pupils_and_vergence(void) {
+    GazeController g;
+    g.configure(HZ, 45.0f, 30.0f, 1000.0f);
+    g.setDisplay(240, 240, 1.5f, 53.0f);
+    g.setTarget(10.0f, 6.0f);
+    for (uint32_t k = 0; k < HZ / 2; k++) g.tick();
+    const GazeController::Output& o = g.output();
+    float ep = deg(o.eye_pan_q16), et = deg(o.eye_tilt_q16);
+    printf("[PUPIL] far: eye %.2f/%.2f  L (%u,%u)  R (%u,%u)\n", ep, et,
+           o.pupil_left_x, o.pupil_left_y, o.pupil_right_x, o.pupil_right_y);
+    TEST_ASSERT_INT_WITHIN(1, 120 + (int)lroundf(ep * 1.5f), o.pupil_left_x);
+    TEST_ASSERT_EQUAL_UINT16(o.pupil_left_x, o.pupil_right_x);
+    TEST_ASSERT_INT_WITHIN(1, 120 - (int)lroundf(et * 1.5f), o.pupil_left_y);
+
+    // 20 cm away: each eye turns in by atan(26.5 / 200) = 7.5 deg
+    g.setTarget(10.0f, 6.0f, 20.0f);
+    g.tick();
+    int conv = (int)o.pupil_left_x - (int)o.pupil_right_x;
+    printf("[PUPIL] near: L %u  R %u  convergence %d px\n", o.pupil_left_x, o.pupil_right_x, conv);
+    TEST_ASSERT_INT_WITHIN(1, (int)lroundf(2.0f * 7.55f * 1.5f), conv);
+}
+
+void test_tick_cost(void) {
+    GazeController g;
+    g.configure(HZ, 45.0f, 30.0f, 15.0f);
+    host_bench::CostStats cost;
+    volatile int32_t sink = 0;
+    for (uint32_t k = 0; k < 200000; k++) {
+        if (k % SAMPLE_EVERY == 0) {
+            // A wandering target: pursuit, catch-up and fresh saccades
+            float t = (float)k / HZ;
+            float az = 30.0f * sinf(t * 0.7f) + ((k / 700) % 3 == 0 ? 15.0f : 0.0f);
+            g.setTarget(az, 10.0f * sinf(t * 0.3f), 80.0f);
+        }
+        uint64_t t0 = host_bench::nowNs();
+        const GazeController::Output& o = g.tick();
+        cost.add(host_bench::nowNs() - t0);
+        sink += o.pupil_left_x;
+        g.setNeckPoseQ16(o.neck_pan_q16, o.neck_tilt_q16);
+    }
+    (void)sink;
+    cost.print("tick() (200 Hz budget 5 ms)", 5000000);
+    printf("[COST] saccades %lu  microsaccades %lu  neck requests %lu\n",
+           (unsigned long)g.getStats().saccades, (unsigned long)g.getStats().microsaccades,
+           (unsigned long)g.getStats().neck_requests);
+    TEST_ASSERT_TRUE(cost.meanNs() < 2000.0);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_main_sequence);
+    RUN_TEST(test_smooth_pursuit);
+    RUN_TEST(test_fixation_microsaccades);
+    RUN_TEST(test_neck_offload_counter_rotation);
+    RUN_TEST(test_pupils_and_vergence);
+    RUN_TEST(test_tick_cost);
+    return UNITY_END();
+}
@@ -0,0 +1,251 @@
+/**
+ * @file test_main.cpp
+ * @brief Keyframe gesture playback and crossfades (GesturePlayer)
+ *
+ * Channels are servo angles in 1/100 degree, ticked at the hand's 500 Hz
+ * grip loop (2 ms) unless noted.
+ *
+ * - Sampling: a single voice reproduces linear and smoothstep segments of a
+ *   float reference, holds on the last key, and wraps LOOP tracks
+ * - Crossfade: switching from a looping wave to a pose mid-gesture moves no
+ *   faster per tick than the two tracks plus the eased fade allow, and ends
+ *   exactly on the new pose with one voice left
+ * - Voice pressure: a new gesture every 50 ms with 400 ms fades never
+ *   exceeds the voice table, and folding a full table causes no step
+ * - Poses: setPose() snaps, playPose() fades
+ * - Cost: tick() for 1..8 simultaneous tracks on the arm (7 channels) vs
+ *   the previous float pose interpolation
+ *
+ * Outputs for inspection (test_output/):
+ *   gesture_player.csv - t, voices, channel 0..2 through wave -> point -> rest
+ *
+ * Run: pio test -e host_test -f test_host_gesture_player
+ */
+
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+#include "config/components/templates/GesturePlayer.hpp"
+#include "../host_support/host_bench.hpp"
+
+typedef GesturePlayer<3, 4> P3;
+typedef GesturePlayer<7, 8> Arm;
+
+static const uint32_t DT_US = 2000;
+
+static const P3::Key RAMP_KEYS[] = {
+    {0,    P3::EASE_LINEAR, {0, 1000, -500}},
+    {400,  P3::EASE_LINEAR, {9000, 1000, 500}},
+    {1000, P3::EASE_SMOOTH, {3000, -4000, 500}},
+};
+static const P3::Key WAVE_KEYS[] = {
+    {0,   P3::EASE_LINEAR, {9000, 0, 0}},
+    {250, P3::EASE_SMOOTH, {9000, 4500, 1500}},
+    {500, P3::EASE_SMOOTH, {9000, -4500, 1500}},
+    {600, P3::EASE_SMOOTH, {9000, 0, 0}},
+};
+static const P3::Key POINT_KEYS[] = {
+    {0, P3::EASE_LINEAR, {4500, 0, -1500}},
+};
+static const P3::Key REST_KEYS[] = {
+    {0, P3::EASE_LINEAR, {0, 0, 0}},
+};
+
+enum { G_RAMP = 0, G_WAVE, G_POINT, G_REST, G_COUNT };
+
+static const P3::Track LIBRARY[G_COUNT] = {
+    {RAMP_KEYS, 3, P3::TRACK_HOLD},
+    {WAVE_KEYS, 4, P3::TRACK_LOOP},
+    {POINT_KEYS, 1, P3::TRACK_HOLD},
+    {REST_KEYS, 1, P3::TRACK_HOLD},
+};
+
+// Float reference for one track at time t (ms)
+static float refSample(const P3::Track& tr, float t_ms, int c) {
+    float end = tr.keys[tr.count - 1].t_ms;
+    if (tr.mode == P3::TRACK_LOOP && end > 0.0f) t_ms = fmodf(t_ms, end);
+    if (t_ms >= end) return tr.keys[tr.count - 1].value[c];
+    for (int k = 0; k + 1 < tr.count; k++) {
+        const P3::Key& a = tr.keys[k];
+        const P3::Key& b = tr.keys[k + 1];
+        if (t_ms < b.t_ms) {
+            float s = (t_ms - a.t_ms) / (float)(b.t_ms - a.t_ms);
+            if (b.ease == P3::EASE_SMOOTH) s = s * s * (3.0f - 2.0f * s);
+            return a.value[c] + (b.value[c] - a.value[c]) * s;
+        }
+    }
+    return tr.keys[tr.count - 1].value[c];
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_sampling_matches_reference(void) {
+    for (int g : {G_RAMP, G_WAVE}) {
+        P3 p;
+        p.configure(LIBRARY, G_COUNT);
+        p.play((uint8_t)g, 0);
+        TEST_ASSERT_EQUAL(1, p.activeVoices());
+        float worst = 0.0f;
+        for (int k = 1; k <= 1500; k++) {
+            p.tick(DT_US);
+            float t_ms = k * DT_US / 1000.0f;
+            for (int c = 0; c < 3; c++)
+                worst = std::max(worst, fabsf(p.value((uint8_t)c) - refSample(LIBRARY[g], t_ms, c)));
+        }
+        printf("[SAMPLE] %s: worst error %.2f (1/100 deg) over 3 s\n", g == G_RAMP ? "ramp hold" : "wave loop", worst);
+        TEST_ASSERT_TRUE(worst <= 2.0f);
+        TEST_ASSERT_EQUAL(g == G_WAVE, p.isAnimating());
+    }
+    P3 p;
+    p.configure(LIBRARY, G_COUNT);
+    TEST_ASSERT_FALSE(p.play(G_COUNT, 100));
+    TEST_ASSERT_FALSE(p.play(200, 100));
+}
+
+void test_crossfade_is_continuous(void) {
+    host_bench::ensureOutputDir();
+    FILE* csv = fopen("test_output/gesture_player.csv", "w");
+    if (csv) fprintf(csv, "t,voices,ch0,ch1,ch2\n");
+
+    P3 p;
+    p.configure(LIBRARY, G_COUNT);
+    p.play(G_WAVE, 0);
+    const uint16_t FADE_MS = 300;
+    int16_t prev[3] = {};
+    float worst_excess = 0.0f;
+    int switch_tick = 330;                          // 660 ms: mid-swing of the second wave
+    for (int k = 1; k <= 1500; k++) {
+        if (k == switch_tick) p.play(G_POINT, FADE_MS);
+        if (k == 1000) p.play(G_REST, FADE_MS);
+        p.tick(DT_US);
+        if (k > 1) {
+            for (int c = 0; c < 3; c++) {
+                // Allowed step: fastest either track moves in a tick plus the
+                // peak of the eased fade (1.5 x gap x dt / fade)
+                float t_ms = k * DT_US / 1000.0f;
+                float gap = 0.0f;
+                float track_step = 0.0f;
+                for (int g : {G_WAVE, G_POINT, G_REST}) {
+                    float x = refSample(LIBRARY[g], t_ms, c);
+                    track_step = std::max(track_step, fabsf(x - refSample(LIBRARY[g], t_ms - DT_US / 1000.0f, c)));
+                    for (int h : {G_WAVE, G_POINT, G_REST}) gap = std::max(gap, fabsf(x - refSample(LIBRARY[h], t_ms, c)));
+                }
+                float allowed = track_step + 1.5f * gap * DT_US / (FADE_MS * 1000.0f) + 2.0f;
+                worst_excess = std::max(worst_excess, fabsf((float)(p.value((uint8_t)c) - prev[c])) - allowed);
+            }
+        }
+        for (int c = 0; c < 3; c++) prev[c] = p.value((uint8_t)c);
+        if (k == switch_tick + 1) TEST_ASSERT_EQUAL(2, p.activeVoices());
+        if (k == switch_tick + (int)(FADE_MS * 1000 / DT_US) + 1) {
+            TEST_ASSERT_EQUAL(1, p.activeVoices());
+            for (int c = 0; c < 3; c++) TEST_ASSERT_EQUAL(POINT_KEYS[0].value[c], p.value((uint8_t)c));
+            TEST_ASSERT_EQUAL(G_POINT, p.current());
+            TEST_ASSERT_FALSE(p.isAnimating());
+        }
+        if (csv) fprintf(csv, "%.3f,%u,%d,%d,%d\n", k * DT_US / 1e6f, p.activeVoices(),
+                         p.value(0), p.value(1), p.value(2));
+    }
+    if (csv) fclose(csv);
+    printf("[FADE] wave -> point -> rest: worst step over the allowed bound %.2f (1/100 deg)\n", worst_excess);
+    TEST_ASSERT_TRUE(worst_excess <= 0.0f);
+    for (int c = 0; c < 3; c++) TEST_ASSERT_EQUAL(0, p.value((uint8_t)c));
+}
+
+void test_voice_pressure_and_poses(void) {
+    P3 p;
+    p.configure(LIBRARY, G_COUNT);
+    int16_t prev[3] = {};
+    int max_active = 0;
+    int worst_step = 0;
+    for (int k = 1; k <= 2000; k++) {
+        if (k % 25 == 0) p.play((uint8_t)((k / 25) % G_COUNT), 400);
+        p.tick(DT_US);
+        max_active = std::max(max_active, (int)p.activeVoices());
+        if (k > 1)
+            for (int c = 0; c < 3; c++) worst_step = std::max(worst_step, abs(p.value((uint8_t)c) - prev[c]));
+        for (int c = 0; c < 3; c++) prev[c] = p.value((uint8_t)c);
+    }
+    printf("[PRESSURE] gesture every 50 ms, 400 ms fades: max %d voices, worst step %d (1/100 deg)\n",
+           max_active, worst_step);
+    TEST_ASSERT_EQUAL(4, max_active);
+    TEST_ASSERT_TRUE(worst_step < 150);                  // Tracks alone move up to ~110 per tick
+
+    const int16_t pose[3] = {1234, -2345, 3456};
+    p.setPose(pose);
+    TEST_ASSERT_EQUAL(1, p.activeVoices());
+    for (int c = 0; c < 3; c++) TEST_ASSERT_EQUAL(pose[c], p.value((uint8_t)c));
+    p.tick(DT_US);
+    for (int c = 0; c < 3; c++) TEST_ASSERT_EQUAL(pose[c], p.value((uint8_t)c));
+    TEST_ASSERT_FALSE(p.isAnimating());
+
+    const int16_t target[3] = {0, 0, 0};
+    p.playPose(target, 100);
+    p.tick(DT_US);
+    TEST_ASSERT_TRUE(p.isAnimating());
+    TEST_ASSERT_TRUE(abs(p.value(0) - pose[0]) < 10);     // Eased start
+    for (int k = 0; k < 50; k++) p.tick(DT_US);
+    for (int c = 0; c < 3; c++) TEST_ASSERT_EQUAL(0, p.value((uint8_t)c));
+    TEST_ASSERT_EQUAL(P3::NONE, p.current());
+}
+
+// Arm library for the cost test: 7 joints, 4 keys, all looping
+static Arm::Key ARM_KEYS[8][4];
+static Arm::Track ARM_LIBRARY[8];
+
+void test_tick_cost(void) {
+    for (int g = 0; g < 8; g++) {
+        for (int k = 0; k < 4; k++) {
+            ARM_KEYS[g][k].t_ms = (uint16_t)(k * (300 + 37 * g));
+            ARM_KEYS[g][k].ease = (uint8_t)(k & 1);
+            for (int c = 0; c < 7; c++)
+                ARM_KEYS[g][k].value[c] = (int16_t)(k == 3 ? ARM_KEYS[g][0].value[c] : (rand() % 18000) - 9000);
+        }
+        ARM_LIBRARY[g] = {ARM_KEYS[g], 4, Arm::TRACK_LOOP};
+    }
+
+    int32_t sink = 0;
+    for (int n : {1, 2, 4, 8}) {
+        Arm p;
+        p.configure(ARM_LIBRARY, 8);
+        // n voices alive: long fades so none retires during the run
+        for (int g = 0; g < n; g++) p.play((uint8_t)g, g == 0 ? 0 : 60000);
+        TEST_ASSERT_EQUAL(n, p.activeVoices());
+        host_bench::CostStats cost;
+        for (int k = 0; k < 20000; k++) {
+            uint64_t t0 = host_bench::nowNs();
+            p.tick(DT_US);
+            cost.add(host_bench::nowNs() - t0);
+            sink += p.value((uint8_t)(k % 7));
+        }
+        char label[64];
+        snprintf(label, sizeof(label), "tick() 7 joints, %d track%s", n, n > 1 ? "s" : "");
+        cost.print(label, 1e9 * DT_US / 1e6);
+    }
+
+    // Previous path: float lerp of 7 joints from a start pose
+    host_bench::CostStats legacy;
+    float cur[7], from[7], to[7];
+    for (int c = 0; c < 7; c++) { from[c] = (float)(rand() % 180); to[c] = (float)(rand() % 180); }
+    for (int k = 0; k < 20000; k++) {
+        uint64_t t0 = host_bench::nowNs();
+        float progress = (float)(k % 100) / 100.0f;
+        for (int c = 0; c < 7; c++) cur[c] = from[c] + (to[c] - from[c]) * progress;
+        legacy.add(host_bench::nowNs() - t0);
+        sink += (int32_t)cur[k % 7];
+    }
+    legacy.print("previous float pose lerp, 7 joints", 1e9 * DT_US / 1e6);
+    printf("[COST] checksum %d\n", (int)(sink & 0xff));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_sampling_matches_reference);
+    RUN_TEST(test_crossfade_is_continuous);
+    RUN_TEST(test_voice_pressure_and_poses);
+    RUN_TEST(test_tick_cost);
+    return UNITY_END();
+}
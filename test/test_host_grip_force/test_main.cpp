@@ -0,0 +1,276 @@
+/**
+ * @file test_main.cpp
+ * @brief Grip force control loop (GripForceController)
+ *
+ * Each finger is an SG90 on a PCA9685 pressing a fingertip FSR into a
+ * spring-contact object: the servo latches its command once per 20 ms PWM
+ * frame, quantised to PCA9685 counts, and slews at up to 600 deg/s; force
+ * is stiffness x indentation past the contact angle, read back through the
+ * 10-bit MCP3008 with noise and the firmware's integer smoothing. Gains and
+ * thresholds are the hand controller's.
+ *
+ * - Settling: grip on soft / medium / firm objects at 500 Hz and 1 kHz,
+ *   time from contact until force stays within +-20 per mille of the
+ *   target, overshoot and steady error; vs the previous position-only
+ *   power grip, whose force is whatever the gesture angle happens to give
+ * - Slip: the object shifts away mid-hold; the finger re-approaches and is
+ *   back on target
+ * - No object: approach stops at the grip limit with no windup, and a
+ *   release ramps the finger open
+ * - Cost: tick() for five fingers
+ *
+ * Outputs for inspection (test_output/):
+ *   grip_force.csv - t, commanded / servo angle, force per object, 500 Hz
+ *
+ * Run: pio test -e host_test -f test_host_grip_force
+ */
+
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+#include "config/components/templates/GripForceController.hpp"
+#include "../host_support/host_bench.hpp"
+
+typedef GripForceController<5> Grip;
+
+// Firmware settings (p32_hand_controller.hpp)
+static const int16_t CONTACT = 50;          // FORCE_THRESHOLD_LOW, per mille
+static const int16_t SLIP = 25;
+static const int16_t TARGET = 150;          // FORCE_THRESHOLD_HIGH
+static const float APPROACH_DPS = 90.0f;
+static const float KP = 0.3f, KI = 8.0f, STIFFNESS = 20.0f;
+static const uint8_t FILTER_SHIFT = 1;
+static const int32_t BAND = 20;             // Settled: within +-2% of full scale
+
+static const float SIM_HZ = 10000.0f;
+
+struct Object {
+    const char* name;
+    float contact_deg;
+    float stiffness;                        // Per mille per degree
+};
+
+static const Object OBJECTS[3] = {
+    {"soft", 60.0f, 5.0f},
+    {"medium", 70.0f, 20.0f},
+    {"firm", 80.0f, 60.0f},
+};
+
+/** One finger: servo frame latch + slew, spring contact, FSR + ADC + filter */
+struct Finger {
+    float theta = 0.0f;                     // Servo shaft angle, deg
+    float latched = 0.0f;
+    float contact_deg = 200.0f;
+    float stiffness = 0.0f;
+    int32_t filt_q4 = 0;
+    uint32_t rng = 12345;
+
+    float force() const {
+        float f = (theta - contact_deg) * stiffness;
+        return f < 0.0f ? 0.0f : (f > 1000.0f ? 1000.0f : f);
+    }
+
+    // PCA9685 counts as set_servo_position_cdeg() computes them
+    static float quantise(int32_t cdeg) {
+        int32_t counts = 102 + cdeg * (491 - 102) / 18000;
+        return (float)(counts - 102) * 180.0f / (491 - 102);
+    }
+
+    void step(float dt) {
+        float err = latched - theta;
+        float v = std::max(-600.0f, std::min(600.0f, 30.0f * err));
+        theta += v * dt;
+    }
+
+    int16_t sense() {
+        rng = rng * 1664525u + 1013904223u;
+        int noise = (int)((rng >> 24) % 7) - 3;                         // +-3 counts
+        int raw = (int)lroundf(force() * 1.023f) + noise;
+        raw = std::max(0, std::min(1023, raw));
+        int32_t pm = raw * 1000 / 1023;
+        filt_q4 += ((pm << 4) - filt_q4) >> FILTER_SHIFT;
+        return (int16_t)(filt_q4 >> 4);
+    }
+};
+
+struct GripResult {
+    float contact_ms;       // From grip command to contact
+    float settle_ms;        // From contact to staying within the band
+    float peak;
+    float final_error;
+};
+
+/** Run one grip on one object for `seconds` at `hz`; all fingers identical */
+static GripResult runGrip(const Object& obj, uint32_t hz, float seconds, FILE* csv = nullptr) {
+    Grip g;
+    g.configure(hz, APPROACH_DPS, CONTACT, SLIP);
+    g.setGains(KP, KI, STIFFNESS);
+    Finger fingers[5];
+    for (auto& f : fingers) { f.contact_deg = obj.contact_deg; f.stiffness = obj.stiffness; }
+    for (uint8_t i = 0; i < 5; i++) g.grip(i, TARGET, 180.0f);
+
+    int sub = (int)(SIM_HZ / hz);
+    int frame = (int)(SIM_HZ * 0.02f);
+    int steps = (int)(seconds * SIM_HZ);
+    int16_t force[5] = {};
+    GripResult r = {-1.0f, -1.0f, 0.0f, 0.0f};
+    int last_out = -1;
+    for (int k = 0; k < steps; k++) {
+        if (k % sub == 0) {
+            for (int i = 0; i < 5; i++) force[i] = fingers[i].sense();
+            g.tick(force);
+            float t_ms = k * 1000.0f / SIM_HZ;
+            if (r.contact_ms < 0.0f && g.holding(0)) r.contact_ms = t_ms;
+            if (r.contact_ms >= 0.0f) {
+                float f = fingers[0].force();
+                r.peak = std::max(r.peak, f);
+                if (fabsf(f - TARGET) > BAND) last_out = k;
+            }
+            if (csv && hz == 500) fprintf(csv, "%s,%.3f,%.2f,%.2f,%d\n", obj.name, t_ms / 1000.0f,
+                                          g.position(0), fingers[0].theta, force[0]);
+        }
+        if (k % frame == 0)
+            for (int i = 0; i < 5; i++) fingers[i].latched = Finger::quantise(g.positionCdeg(i));
+        for (auto& f : fingers) f.step(1.0f / SIM_HZ);
+    }
+    if (r.contact_ms >= 0.0f) {
+        float out_ms = last_out < 0 ? 0.0f : (last_out + 1) * 1000.0f / SIM_HZ;
+        r.settle_ms = std::max(0.0f, out_ms - r.contact_ms);
+    }
+    r.final_error = fingers[0].force() - TARGET;
+    return r;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_settling_vs_position_only(void) {
+    host_bench::ensureOutputDir();
+    FILE* csv = fopen("test_output/grip_force.csv", "w");
+    if (csv) fprintf(csv, "object,t,command_deg,servo_deg,force_permille\n");
+
+    for (const Object& obj : OBJECTS) {
+        for (uint32_t hz : {500u, 1000u}) {
+            GripResult r = runGrip(obj, hz, 4.0f, csv);
+            printf("[SETTLE] %-6s %4u Hz: contact after %4.0f ms, settled %4.0f ms later, "
+                   "peak %3.0f, final error %+4.1f per mille\n",
+                   obj.name, (unsigned)hz, r.contact_ms, r.settle_ms, r.peak, r.final_error);
+            TEST_ASSERT_TRUE(r.contact_ms > 0.0f);
+            TEST_ASSERT_TRUE(r.settle_ms >= 0.0f);
+            TEST_ASSERT_TRUE(r.settle_ms < 1500.0f);
+            TEST_ASSERT_TRUE(r.peak < 2.0f * TARGET);
+            TEST_ASSERT_FLOAT_WITHIN((float)BAND, 0.0f, r.final_error);
+        }
+        // Previous path: power_grip closes every finger to 90 deg regardless
+        float legacy = std::max(0.0f, std::min(1000.0f, (90.0f - obj.contact_deg) * obj.stiffness));
+        printf("[SETTLE] %-6s position-only power_grip: %3.0f per mille\n", obj.name, legacy);
+    }
+    if (csv) fclose(csv);
+}
+
+void test_slip_recovery(void) {
+    Grip g;
+    g.configure(500, APPROACH_DPS, CONTACT, SLIP);
+    g.setGains(KP, KI, STIFFNESS);
+    Finger f;
+    f.contact_deg = 70.0f;
+    f.stiffness = 20.0f;
+    g.grip(0, TARGET, 180.0f);
+
+    int16_t force[5] = {};
+    int frame = (int)(SIM_HZ * 0.02f);
+    int slip_at = (int)(2.0f * SIM_HZ);
+    int back_at = -1;
+    for (int k = 0; k < (int)(4.0f * SIM_HZ); k++) {
+        if (k == slip_at) f.contact_deg += 15.0f;        // Object slides out of the fingertip
+        if (k % 20 == 0) {
+            force[0] = f.sense();
+            g.tick(force);
+            if (k > slip_at && back_at < 0 && g.holding(0) && fabsf(f.force() - TARGET) <= BAND)
+                back_at = k;
+        }
+        if (k % frame == 0) f.latched = Finger::quantise(g.positionCdeg(0));
+        f.step(1.0f / SIM_HZ);
+    }
+    float ms = back_at < 0 ? -1.0f : (back_at - slip_at) * 1000.0f / SIM_HZ;
+    printf("[SLIP] 15 deg shift: back on target after %.0f ms, final %.0f per mille\n", ms, f.force());
+    TEST_ASSERT_TRUE(back_at > 0);
+    TEST_ASSERT_TRUE(ms < 1000.0f);
+    TEST_ASSERT_TRUE(g.holding(0));
+    TEST_ASSERT_FLOAT_WITHIN((float)BAND, (float)TARGET, f.force());
+}
+
+void test_no_object_and_release(void) {
+    Grip g;
+    g.configure(500, APPROACH_DPS, CONTACT, SLIP);
+    g.setGains(KP, KI, STIFFNESS);
+    g.setLimits(1, 10.0f, 170.0f);
+    int16_t force[5] = {};
+    g.grip(1, TARGET, 180.0f);
+    for (int k = 0; k < 1500; k++) g.tick(force);                      // 3 s, nothing to touch
+    printf("[LIMIT] no object: stopped at %.1f deg, mode %d\n", g.position(1), (int)g.mode(1));
+    TEST_ASSERT_TRUE(g.reachedLimit(1));
+    TEST_ASSERT_EQUAL(17000, g.positionCdeg(1));
+    TEST_ASSERT_EQUAL(Grip::MODE_APPROACH, g.mode(1));
+
+    // Approach took 170 deg / 90 deg/s
+    Grip h;
+    h.configure(500, APPROACH_DPS, CONTACT, SLIP);
+    int ticks = 0;
+    h.grip(0, TARGET, 90.0f);
+    while (!h.reachedLimit(0) && ticks < 5000) { h.tick(force); ticks++; }
+    TEST_ASSERT_INT_WITHIN(2, 500, ticks);
+
+    // Hold against a hard stop, then the object vanishes under a limit: no windup
+    force[1] = 400;
+    g.grip(1, TARGET, 100.0f);
+    for (int k = 0; k < 500; k++) g.tick(force);
+    TEST_ASSERT_TRUE(g.holding(1));
+    TEST_ASSERT_TRUE(g.positionCdeg(1) >= 1000);                       // Backed off to the open limit
+    force[1] = 100;
+    for (int k = 0; k < 50; k++) g.tick(force);
+    TEST_ASSERT_TRUE(g.positionCdeg(1) > 1000);                        // Recovers at once, not after unwinding
+
+    g.moveTo(1, 0.0f, 0.5f);
+    for (int k = 0; k < 249; k++) g.tick(force);
+    TEST_ASSERT_FALSE(g.settled(1));
+    g.tick(force);
+    TEST_ASSERT_TRUE(g.settled(1));
+    TEST_ASSERT_EQUAL(1000, g.positionCdeg(1));                         // Clamped to the open limit
+}
+
+void test_tick_cost(void) {
+    Grip g;
+    g.configure(500, APPROACH_DPS, CONTACT, SLIP);
+    g.setGains(KP, KI, STIFFNESS);
+    for (uint8_t i = 0; i < 5; i++) g.grip(i, TARGET, 180.0f);
+    host_bench::CostStats cost;
+    int16_t force[5];
+    uint32_t rng = 7;
+    uint32_t sink = 0;
+    for (int k = 0; k < 200000; k++) {
+        for (int i = 0; i < 5; i++) {
+            rng = rng * 1664525u + 1013904223u;
+            force[i] = (int16_t)(k < 100 ? 0 : 100 + (rng >> 26));
+        }
+        uint64_t t0 = host_bench::nowNs();
+        g.tick(force);
+        cost.add(host_bench::nowNs() - t0);
+        sink += (uint32_t)g.positionCdeg((uint8_t)(k % 5));
+    }
+    printf("[COST] checksum %u\n", (unsigned)(sink & 0xff));
+    cost.print("tick() 5 fingers, holding", 1e9 / 500);
+    TEST_ASSERT_TRUE(g.holding(0));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_settling_vs_position_only);
+    RUN_TEST(test_slip_recovery);
+    RUN_TEST(test_no_object_and_release);
+    RUN_TEST(test_tick_cost);
+    return UNITY_END();
+}
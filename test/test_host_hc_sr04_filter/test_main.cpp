@@ -0,0 +1,206 @@
+/**
+ * @file test_main.cpp
+ * @brief Host evaluation of UltrasonicRangeFilter on the HC-SR04 simulator
+ *
+ * Extends the DEBUG_MODE simulator of gpio_pair_driver (sinusoidal
+ * approach/retreat + uniform +/-1 cm echo jitter + 5% lost echoes) with
+ * ghost echoes and harder motion - a sudden step and a fast approach - and
+ * runs the filter at the driver's 60 ms ping interval.
+ *
+ * Outputs for inspection (test_output/):
+ *   hc_sr04_filter.csv  - t, truth, raw echo, filtered distance, velocity, confidence
+ *
+ * Run: pio test -e host_test -f test_host_hc_sr04_filter
+ */
+
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "config/components/templates/UltrasonicRangeFilter.hpp"
+#include "../host_support/host_bench.hpp"
+
+static const uint32_t PING_US = 60000;      // hc_sr04 ping interval
+static const float JITTER_MM = 10.0f;       // gpio_pair_driver: +/-1 cm
+static const float LOST_PERCENT = 5.0f;     // gpio_pair_driver: 5% timeouts
+static const float GHOST_PERCENT = 4.0f;    // Added: multipath / crosstalk
+
+static uint32_t rng_state = 2024;
+static float frand() {
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return (float)(rng_state >> 8) / 16777216.0f;
+}
+
+struct Sample {
+    float t_s;
+    float truth_mm;
+    float raw_mm;       // < 0 = lost echo
+    float filt_mm;
+    float vel_mm_s;
+    uint8_t confidence;
+    bool valid;
+};
+
+/**
+ * Scenario: 0-20 s sinusoid 100-500 mm (5 s period), step to 800 mm at 20 s,
+ * then at 24 s a fast approach to 100 mm at 400 mm/s, then hold
+ */
+static float truthAt(float t) {
+    if (t < 20.0f) return 300.0f + 200.0f * sinf(6.2831853f * 0.2f * t);
+    if (t < 24.0f) return 800.0f;
+    float d = 800.0f - 400.0f * (t - 24.0f);
+    return d < 100.0f ? 100.0f : d;
+}
+
+static std::vector<Sample> runScenario(host_bench::CostStats* cost) {
+    UltrasonicRangeFilter filter;
+    std::vector<Sample> log;
+    uint32_t ghost_burst = 0;
+
+    for (uint64_t t_us = 0; t_us < 30000000ull; t_us += PING_US) {
+        Sample s;
+        s.t_s = (float)t_us * 1e-6f;
+        s.truth_mm = truthAt(s.t_s);
+
+        float roll = 100.0f * frand();
+        if (roll < LOST_PERCENT) {
+            s.raw_mm = -1.0f;
+        } else if (roll < LOST_PERCENT + GHOST_PERCENT || ghost_burst) {
+            // Ghosts: second bounce (2x) or a near reflection off the snout
+            s.raw_mm = frand() < 0.5f ? 2.0f * s.truth_mm : 60.0f + 40.0f * frand();
+            ghost_burst = ghost_burst ? ghost_burst - 1 : (frand() < 0.2f ? 1 : 0);
+        } else {
+            s.raw_mm = s.truth_mm + (2.0f * frand() - 1.0f) * JITTER_MM;
+        }
+
+        uint64_t t0 = host_bench::nowNs();
+        if (s.raw_mm < 0.0f) filter.miss(t_us);
+        else filter.update(s.raw_mm, t_us);
+        UltrasonicRangeFilter::Estimate e = filter.estimate();
+        if (cost) cost->add(host_bench::nowNs() - t0);
+
+        s.filt_mm = e.distance_mm;
+        s.vel_mm_s = e.velocity_mm_s;
+        s.confidence = e.confidence;
+        s.valid = e.valid;
+        log.push_back(s);
+    }
+    return log;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_filter_error_latency_and_outliers(void) {
+    host_bench::CostStats cost;
+    std::vector<Sample> log = runScenario(&cost);
+
+    // Error on the sinusoid after the first second
+    double raw_sq = 0.0, filt_sq = 0.0;
+    uint32_t raw_n = 0, filt_n = 0;
+    float worst_filt = 0.0f;
+    for (const Sample& s : log) {
+        if (s.t_s < 1.0f || s.t_s >= 20.0f) continue;
+        if (s.raw_mm >= 0.0f) {
+            raw_sq += (s.raw_mm - s.truth_mm) * (s.raw_mm - s.truth_mm);
+            raw_n++;
+        }
+        float err = fabsf(s.filt_mm - s.truth_mm);
+        filt_sq += err * err;
+        filt_n++;
+        if (err > worst_filt) worst_filt = err;
+    }
+    float raw_rms = (float)sqrt(raw_sq / raw_n);
+    float filt_rms = (float)sqrt(filt_sq / filt_n);
+
+    // Latency: shift of the truth that best explains the filtered track
+    float best_lag_ms = 0.0f, best_rms = 1e9f;
+    for (int lag_ms = 0; lag_ms <= 300; lag_ms += 5) {
+        double sq = 0.0;
+        uint32_t n = 0;
+        for (const Sample& s : log) {
+            if (s.t_s < 1.0f || s.t_s >= 20.0f) continue;
+            float d = s.filt_mm - truthAt(s.t_s - lag_ms * 1e-3f);
+            sq += d * d;
+            n++;
+        }
+        float rms = (float)sqrt(sq / n);
+        if (rms < best_rms) { best_rms = rms; best_lag_ms = (float)lag_ms; }
+    }
+
+    // Step 300 -> 800 mm at 20 s: time to settle within 20 mm
+    float settle_ms = -1.0f;
+    for (const Sample& s : log) {
+        if (s.t_s < 20.0f || s.t_s >= 24.0f) continue;
+        if (fabsf(s.filt_mm - s.truth_mm) < 20.0f) { settle_ms = (s.t_s - 20.0f) * 1000.0f; break; }
+    }
+
+    // Fast approach: error while closing at 400 mm/s, and velocity estimate
+    float approach_worst = 0.0f, vel_sum = 0.0f;
+    uint32_t vel_n = 0;
+    for (const Sample& s : log) {
+        if (s.t_s < 25.0f || s.t_s >= 25.7f) continue;
+        float err = fabsf(s.filt_mm - s.truth_mm);
+        if (err > approach_worst) approach_worst = err;
+        vel_sum += s.vel_mm_s;
+        vel_n++;
+    }
+    float approach_vel = vel_sum / vel_n;
+
+    printf("[HC-SR04] raw RMS %.1f mm -> filtered RMS %.1f mm, worst %.1f mm (ghost %.0f%%, lost %.0f%%)\n",
+           raw_rms, filt_rms, worst_filt, GHOST_PERCENT, LOST_PERCENT);
+    printf("[HC-SR04] tracking lag %.0f ms (residual %.1f mm), step settle %.0f ms\n",
+           best_lag_ms, best_rms, settle_ms);
+    printf("[HC-SR04] approach: worst error %.1f mm, velocity %.0f mm/s (truth -400)\n",
+           approach_worst, approach_vel);
+    cost.print("UltrasonicRangeFilter update+estimate", PING_US * 1000.0);
+
+    host_bench::ensureOutputDir();
+    FILE* csv = fopen("test_output/hc_sr04_filter.csv", "w");
+    if (csv) {
+        fprintf(csv, "t_s,truth_mm,raw_mm,filtered_mm,velocity_mm_s,confidence,valid\n");
+        for (const Sample& s : log) {
+            fprintf(csv, "%.3f,%.1f,%.1f,%.1f,%.1f,%u,%d\n", s.t_s, s.truth_mm, s.raw_mm, s.filt_mm,
+                    s.vel_mm_s, s.confidence, s.valid ? 1 : 0);
+        }
+        fclose(csv);
+    }
+
+    TEST_ASSERT_LESS_THAN(raw_rms / 4.0f, filt_rms);
+    TEST_ASSERT_LESS_THAN(30.0f, worst_filt);          // No ghost reaches the output
+    TEST_ASSERT_LESS_THAN(100.0f, best_lag_ms);        // Under two pings
+    TEST_ASSERT_GREATER_OR_EQUAL(0.0f, settle_ms);
+    TEST_ASSERT_LESS_THAN(500.0f, settle_ms);
+    TEST_ASSERT_LESS_THAN(60.0f, approach_worst);
+    TEST_ASSERT_FLOAT_WITHIN(80.0f, -400.0f, approach_vel);
+}
+
+void test_confidence_tracks_echo_quality(void) {
+    UltrasonicRangeFilter filter;
+    uint64_t t = 0;
+    for (int i = 0; i < 30; i++, t += PING_US) filter.update(500.0f + (i & 1 ? 3.0f : -3.0f), t);
+    UltrasonicRangeFilter::Estimate good = filter.estimate();
+    TEST_ASSERT_TRUE(good.valid);
+    TEST_ASSERT_GREATER_THAN(200, good.confidence);
+
+    // Target vanishes: coasting drops confidence and then validity
+    for (int i = 0; i < 12; i++, t += PING_US) filter.miss(t);
+    UltrasonicRangeFilter::Estimate lost = filter.estimate();
+    TEST_ASSERT_LESS_THAN(good.confidence / 4, lost.confidence);
+    TEST_ASSERT_FALSE(lost.valid);
+
+    // Out-of-range echoes never enter the track
+    UltrasonicRangeFilter fresh;
+    fresh.update(5.0f, 0);
+    fresh.update(9000.0f, PING_US);
+    TEST_ASSERT_FALSE(fresh.estimate().valid);
+    TEST_ASSERT_EQUAL(2, fresh.rejectedCount());
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_filter_error_latency_and_outliers);
+    RUN_TEST(test_confidence_tracks_echo_quality);
+    return UNITY_END();
+}
@@ -0,0 +1,251 @@
+/**
+ * @file test_main.cpp
+ * @brief Host run of the LipSyncAnalyzer block stage with a simulated jaw
+ *
+ * Renders a synthetic utterance (silence, vowel-like segments with a
+ * dominant formant, a sibilant), pushes it through the stage in 10 ms
+ * blocks exactly like i2s_driver does, and drives a jaw model with a pure
+ * transport delay equal to the actuator latency.
+ *
+ * Outputs for inspection (test_output/):
+ *   lip_sync_audio.wav       - audio as it leaves the stage (delayed)
+ *   lip_sync_trajectory.csv  - time, heard envelope, commanded and actual jaw
+ *
+ * Run: pio test -e host_test -f test_host_lip_sync
+ */
+
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "config/components/templates/LipSyncAnalyzer.hpp"
+#include "../host_support/wav_io.hpp"
+#include "../host_support/host_bench.hpp"
+
+static const uint32_t SAMPLE_RATE = 44100;
+static const uint32_t BLOCK = 441;          // 10 ms, as in i2s_driver
+static const uint16_t OUTPUT_LATENCY_MS = 40;
+static const uint16_t JAW_LATENCY_MS = 80;
+
+struct Segment {
+    int viseme;         // Expected class, -1 = silence
+    float formant_hz;   // Dominant component (sets zero-crossing rate)
+    uint32_t dur_ms;
+    float amp;
+};
+
+static const Segment UTTERANCE[] = {
+    {LipSyncAnalyzer::VISEME_MBP, 0.0f, 300, 0.0f},
+    {LipSyncAnalyzer::VISEME_AH, 750.0f, 250, 0.5f},
+    {LipSyncAnalyzer::VISEME_MBP, 0.0f, 150, 0.0f},
+    {LipSyncAnalyzer::VISEME_OO, 180.0f, 250, 0.4f},
+    {LipSyncAnalyzer::VISEME_MBP, 0.0f, 150, 0.0f},
+    {LipSyncAnalyzer::VISEME_OH, 380.0f, 200, 0.45f},
+    {LipSyncAnalyzer::VISEME_EH, 1600.0f, 200, 0.4f},
+    {LipSyncAnalyzer::VISEME_FS, -1.0f, 150, 0.25f},
+    {LipSyncAnalyzer::VISEME_AH, 800.0f, 300, 0.6f},
+    {LipSyncAnalyzer::VISEME_MBP, 0.0f, 300, 0.0f},
+};
+static const size_t SEGMENTS = sizeof(UTTERANCE) / sizeof(UTTERANCE[0]);
+
+static uint32_t rng_state = 777;
+static float frand() {
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return (float)(rng_state >> 8) / 16777216.0f - 0.5f;
+}
+
+static std::vector<int16_t> renderUtterance(std::vector<uint32_t>& onsets_ms) {
+    std::vector<int16_t> pcm;
+    uint32_t t_ms = 0;
+    float prev_noise = 0.0f;
+    for (size_t s = 0; s < SEGMENTS; s++) {
+        const Segment& seg = UTTERANCE[s];
+        onsets_ms.push_back(t_ms);
+        size_t n = (size_t)seg.dur_ms * SAMPLE_RATE / 1000;
+        for (size_t i = 0; i < n; i++) {
+            float t = (float)(pcm.size()) / SAMPLE_RATE;
+            float v = 0.0f;
+            if (seg.formant_hz > 0.0f) {
+                v = sinf(6.2831853f * seg.formant_hz * t) + 0.3f * sinf(6.2831853f * 120.0f * t);
+            } else if (seg.formant_hz < 0.0f) {
+                float w = frand();
+                v = 2.0f * (w - prev_noise);    // Differentiated noise: hiss
+                prev_noise = w;
+            }
+            v = v * seg.amp + 0.002f * frand();
+            pcm.push_back((int16_t)lrintf(fmaxf(-1.0f, fminf(1.0f, v)) * 32000.0f));
+        }
+        t_ms += seg.dur_ms;
+    }
+    return pcm;
+}
+
+struct SyncResult {
+    float mean_onset_error_ms;
+    float max_onset_error_ms;
+    uint32_t viseme_hits;
+    uint32_t viseme_checks;
+    uint32_t dropped_cues;
+    host_bench::CostStats cost;
+};
+
+/**
+ * @param actuator_latency_ms Latency the stage compensates for (0 = none)
+ */
+static SyncResult runSync(const std::vector<int16_t>& pcm, const std::vector<uint32_t>& onsets_ms,
+                          uint16_t actuator_latency_ms, bool dump) {
+    static LipSyncAnalyzer stage;
+    stage.configure(SAMPLE_RATE, 10, OUTPUT_LATENCY_MS, actuator_latency_ms);
+
+    size_t blocks = pcm.size() / BLOCK + 30;
+    uint32_t end_ms = (uint32_t)blocks * 10 + 200;
+    std::vector<int16_t> heard(end_ms * SAMPLE_RATE / 1000 + BLOCK, 0);
+    std::vector<int> jaw_cmd(end_ms, 0);
+    std::vector<int> viseme_cmd(end_ms, LipSyncAnalyzer::VISEME_MBP);
+
+    SyncResult r = {};
+    int16_t block[BLOCK];
+    int current_jaw = 0;
+    int current_viseme = LipSyncAnalyzer::VISEME_MBP;
+    for (size_t b = 0; b < blocks; b++) {
+        uint32_t now = (uint32_t)b * 10;
+        for (uint32_t i = 0; i < BLOCK; i++) {
+            size_t idx = b * BLOCK + i;
+            block[i] = idx < pcm.size() ? pcm[idx] : 0;
+        }
+        uint64_t t0 = host_bench::nowNs();
+        stage.processBlock(block, block, BLOCK, now);
+        r.cost.add(host_bench::nowNs() - t0);
+
+        // Heard after the DMA queue
+        size_t heard_at = (size_t)(now + OUTPUT_LATENCY_MS) * SAMPLE_RATE / 1000;
+        for (uint32_t i = 0; i < BLOCK && heard_at + i < heard.size(); i++) heard[heard_at + i] = block[i];
+
+        // Mouth loop ticks every 5 ms between audio blocks
+        for (uint32_t tick = now; tick < now + 10; tick += 5) {
+            LipSyncAnalyzer::MouthCue cue;
+            while (stage.popDueCue(tick, cue)) {
+                current_jaw = cue.jaw_open;
+                current_viseme = cue.viseme;
+            }
+            for (uint32_t ms = tick; ms < tick + 5 && ms < end_ms; ms++) {
+                jaw_cmd[ms] = current_jaw;
+                viseme_cmd[ms] = current_viseme;
+            }
+        }
+    }
+
+    // Jaw model: reaches the commanded pose JAW_LATENCY_MS after the command
+    std::vector<int> jaw_actual(end_ms, 0);
+    for (uint32_t ms = JAW_LATENCY_MS; ms < end_ms; ms++) jaw_actual[ms] = jaw_cmd[ms - JAW_LATENCY_MS];
+
+    // Onset error: heard onset (after the stage's own delay) vs jaw reaching a visible opening, for open segments after silence
+    float err_sum = 0.0f;
+    uint32_t err_count = 0;
+    for (size_t s = 1; s < SEGMENTS; s++) {
+        if (UTTERANCE[s].amp == 0.0f || UTTERANCE[s - 1].amp != 0.0f) continue;
+        uint32_t heard_onset = onsets_ms[s] + OUTPUT_LATENCY_MS + stage.addedDelayMs();
+        // Start from the point in the gap where the jaw is closed again
+        uint32_t ms = heard_onset - 100;
+        while (ms < end_ms && jaw_actual[ms] >= 8) ms++;
+        while (ms < end_ms && jaw_actual[ms] < 8) ms++;
+        uint32_t jaw_onset = ms;
+        float err = (float)jaw_onset - (float)heard_onset;
+        err_sum += fabsf(err);
+        if (fabsf(err) > r.max_onset_error_ms) r.max_onset_error_ms = fabsf(err);
+        err_count++;
+    }
+    r.dropped_cues = stage.droppedCues();
+    r.mean_onset_error_ms = err_count ? err_sum / err_count : 0.0f;
+
+    // Viseme in the steady middle of each segment, as the jaw shows it when heard
+    for (size_t s = 0; s < SEGMENTS; s++) {
+        uint32_t mid = onsets_ms[s] + UTTERANCE[s].dur_ms / 2 + OUTPUT_LATENCY_MS + stage.addedDelayMs();
+        if (mid < JAW_LATENCY_MS || mid >= end_ms) continue;
+        r.viseme_checks++;
+        if (viseme_cmd[mid - JAW_LATENCY_MS] == UTTERANCE[s].viseme) r.viseme_hits++;
+    }
+
+    if (dump) {
+        host_bench::ensureOutputDir();
+        host_wav::WavData wav;
+        wav.sample_rate = SAMPLE_RATE;
+        wav.channels = 1;
+        wav.samples = heard;
+        host_wav::write("test_output/lip_sync_audio.wav", wav);
+
+        FILE* csv = fopen("test_output/lip_sync_trajectory.csv", "w");
+        if (csv) {
+            fprintf(csv, "time_ms,heard_mean_abs,jaw_command,jaw_actual,viseme\n");
+            for (uint32_t ms = 0; ms < end_ms; ms++) {
+                uint32_t sum = 0;
+                size_t base = (size_t)ms * SAMPLE_RATE / 1000;
+                for (uint32_t i = 0; i < SAMPLE_RATE / 1000 && base + i < heard.size(); i++) sum += abs(heard[base + i]);
+                fprintf(csv, "%u,%u,%d,%d,%d\n", ms, sum / (SAMPLE_RATE / 1000), jaw_cmd[ms], jaw_actual[ms], viseme_cmd[ms]);
+            }
+            fclose(csv);
+        }
+    }
+    return r;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_lookahead_lands_jaw_on_time(void) {
+    std::vector<uint32_t> onsets;
+    std::vector<int16_t> pcm = renderUtterance(onsets);
+
+    SyncResult with = runSync(pcm, onsets, JAW_LATENCY_MS, true);
+    SyncResult without = runSync(pcm, onsets, 0, false);
+
+    printf("[LIPSYNC] compensated:   mean onset error %5.1f ms, worst %5.1f ms, visemes %u/%u\n",
+           with.mean_onset_error_ms, with.max_onset_error_ms, with.viseme_hits, with.viseme_checks);
+    printf("[LIPSYNC] uncompensated: mean onset error %5.1f ms, worst %5.1f ms\n",
+           without.mean_onset_error_ms, without.max_onset_error_ms);
+    with.cost.print("LipSyncAnalyzer::processBlock (10 ms)", 10e6);
+
+    TEST_ASSERT_LESS_OR_EQUAL(15, with.max_onset_error_ms);
+    TEST_ASSERT_GREATER_THAN(with.mean_onset_error_ms + 30.0f, without.mean_onset_error_ms);
+    TEST_ASSERT_EQUAL(with.viseme_checks, with.viseme_hits);
+    TEST_ASSERT_EQUAL(0, with.dropped_cues);
+    TEST_ASSERT_LESS_THAN(0.01 * 10e6, with.cost.meanNs());
+}
+
+void test_delay_line_is_exact(void) {
+    LipSyncAnalyzer stage;
+    stage.configure(SAMPLE_RATE, 10, 0, 20);     // Needs 30 ms of lookahead
+    uint32_t delay = (uint32_t)stage.addedDelayMs() * SAMPLE_RATE / 1000;
+    TEST_ASSERT_EQUAL(30, stage.addedDelayMs());
+
+    std::vector<int16_t> in(BLOCK * 8), out(BLOCK * 8);
+    for (size_t i = 0; i < in.size(); i++) in[i] = (int16_t)(i % 3000);
+    for (size_t b = 0; b < 8; b++) stage.processBlock(&in[b * BLOCK], &out[b * BLOCK], BLOCK, b * 10);
+    for (size_t i = delay; i < out.size(); i++) {
+        TEST_ASSERT_EQUAL_INT16(in[i - delay], out[i]);
+    }
+}
+
+void test_stalled_consumer_never_blocks_audio(void) {
+    LipSyncAnalyzer stage;
+    stage.configure(SAMPLE_RATE, 10, 40, 80);
+    int16_t block[BLOCK] = {0};
+    for (int b = 0; b < 200; b++) stage.processBlock(block, block, BLOCK, b * 10);
+    TEST_ASSERT_GREATER_THAN(0, stage.droppedCues());
+
+    // Consumer comes back: stale cues are discarded, not replayed
+    LipSyncAnalyzer::MouthCue cue;
+    uint32_t delivered = 0;
+    while (stage.popDueCue(2000, cue)) delivered++;
+    TEST_ASSERT_LESS_OR_EQUAL(1, delivered);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_lookahead_lands_jaw_on_time);
+    RUN_TEST(test_delay_line_is_exact);
+    RUN_TEST(test_stalled_consumer_never_blocks_audio);
+    return UNITY_END();
+}
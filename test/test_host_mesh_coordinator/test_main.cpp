@@ -0,0 +1,605 @@
+/**
+ * @file test_main.cpp
+ * @brief Host tests of MeshCoordinator: CRC16, framing, priority rings, zero-copy dispatch, UDP mesh
+ *
+ * - CRC16: CCITT-FALSE check value, slice-by-4 = byte table = bitwise over
+ *   every frame length
+ * - Framing: seal()/check(), and commit() rejects bad length, magic, CRC,
+ *   foreign destination and our own echo without taking a slot
+ * - Priority rings: EMERGENCY, COMMAND, STATUS, HEARTBEAT order, an
+ *   emergency arriving mid-poll is dispatched next, a full ring drops and
+ *   the drop shows up as a sequence gap
+ * - Zero copy: handlers see the bytes in the ring slot the transport
+ *   received into
+ * - Threads: a producer thread (the ESP-NOW callback's role) feeds 200k
+ *   frames through 8-slot rings to a polling consumer, in order, untorn
+ * - Node table: online on first frame, status from STATUS, offline after
+ *   the timeout, change callbacks
+ * - UDP mesh: master + 7 slaves on loopback multicast, one socket each.
+ *   Ping-pong latency and burst throughput (slaves -> master STATUS,
+ *   master -> all COMMAND broadcast)
+ * - Cost: CRC routines over a full frame, receive() + poll() per frame
+ *
+ * Outputs for inspection (test_output/):
+ *   mesh_udp.csv - phase, frames, seconds, frames_per_s, lat_mean_us,
+ *                  lat_p50_us, lat_p99_us, lat_max_us
+ *
+ * Run: pio test -e host_test -f test_host_mesh_coordinator
+ */
+
+#include <unity.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "config/components/templates/MeshCoordinator.hpp"
+#include "../host_support/udp_mesh_transport.hpp"
+#include "../host_support/host_bench.hpp"
+
+static const uint8_t MASTER = 0x10;            // P32_ROLE_MASTER
+static const uint8_t HEAD = 0x21;              // P32_ROLE_SLAVE_HEAD, slaves are 0x21..0x27
+static const uint8_t SRC_MAC[6] = {0x24, 0x6F, 0x28, 0x00, 0x00, 0x21};
+
+typedef MeshCoordinator<4> SmallMesh;
+typedef MeshCoordinator<8> SlaveMesh;
+typedef MeshCoordinator<32> MasterMesh;
+
+static uint16_t makeFrame(uint8_t* frame, uint8_t type, uint8_t src, uint8_t dest, uint8_t seq,
+                          const uint8_t* payload, uint16_t len)
+{
+    MeshHeader h;
+    h.magic = MESH_MAGIC;
+    h.msg_type = type;
+    h.source_role = src;
+    h.dest_role = dest;
+    h.sequence = seq;
+    h.timestamp = 0;
+    h.payload_len = len;
+    h.checksum = 0;
+    memcpy(frame, &h, MESH_HEADER_BYTES);
+    if (len) memcpy(frame + MESH_HEADER_BYTES, payload, len);
+    SmallMesh::seal(frame);
+    return (uint16_t)(MESH_HEADER_BYTES + len);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// ---- CRC16 ----
+
+static void test_crc16(void)
+{
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    TEST_ASSERT_EQUAL(0x29B1, MeshCrc16::bitwise(MeshCrc16::INIT, check, 9));
+    TEST_ASSERT_EQUAL(0x29B1, MeshCrc16::table(MeshCrc16::INIT, check, 9));
+    TEST_ASSERT_EQUAL(0x29B1, MeshCrc16::update(MeshCrc16::INIT, check, 9));
+
+    srand(50);
+    uint8_t buf[MESH_MAX_FRAME];
+    for (int i = 0; i < (int)sizeof(buf); i++) buf[i] = (uint8_t)rand();
+    for (uint16_t len = 0; len <= MESH_MAX_FRAME; len++) {
+        uint16_t ref = MeshCrc16::bitwise(MeshCrc16::INIT, buf, len);
+        TEST_ASSERT_EQUAL(ref, MeshCrc16::table(MeshCrc16::INIT, buf, len));
+        TEST_ASSERT_EQUAL(ref, MeshCrc16::update(MeshCrc16::INIT, buf, len));
+        // Split anywhere: the routine is incremental
+        uint16_t split = MeshCrc16::update(MeshCrc16::INIT, buf, len / 3);
+        TEST_ASSERT_EQUAL(ref, MeshCrc16::update(split, buf + len / 3, len - len / 3));
+    }
+}
+
+// ---- Framing ----
+
+static void test_frame_validation(void)
+{
+    uint8_t payload[40];
+    for (int i = 0; i < 40; i++) payload[i] = (uint8_t)(i * 7);
+    uint8_t frame[MESH_MAX_FRAME];
+    uint16_t len = makeFrame(frame, MESH_MSG_STATUS, HEAD, MASTER, 0, payload, 40);
+    TEST_ASSERT_EQUAL(SmallMesh::OK, SmallMesh::check(frame, len));
+
+    uint8_t bad[MESH_MAX_FRAME];
+    memcpy(bad, frame, len);
+    bad[MESH_HEADER_BYTES + 17] ^= 0x04;
+    TEST_ASSERT_EQUAL(SmallMesh::ERR_CRC, SmallMesh::check(bad, len));
+    memcpy(bad, frame, len);
+    bad[10] ^= 0x01;                            // Header byte under the CRC (timestamp)
+    TEST_ASSERT_EQUAL(SmallMesh::ERR_CRC, SmallMesh::check(bad, len));
+    memcpy(bad, frame, len);
+    bad[0] = 'X';
+    TEST_ASSERT_EQUAL(SmallMesh::ERR_MAGIC, SmallMesh::check(bad, len));
+    TEST_ASSERT_EQUAL(SmallMesh::ERR_LENGTH, SmallMesh::check(frame, (uint16_t)(len - 1)));
+    TEST_ASSERT_EQUAL(SmallMesh::ERR_LENGTH, SmallMesh::check(frame, 10));
+
+    SmallMesh::Transport none = { nullptr, nullptr };
+    SmallMesh mesh;
+    mesh.begin(MASTER, none, 3000);
+    bad[0] = frame[0];
+    bad[MESH_HEADER_BYTES + 3] ^= 0x80;
+    TEST_ASSERT_EQUAL(SmallMesh::ERR_CRC, mesh.receive(bad, len, SRC_MAC));
+
+    uint8_t other[MESH_MAX_FRAME];
+    uint16_t other_len = makeFrame(other, MESH_MSG_COMMAND, HEAD, 0x22, 0, payload, 4);
+    TEST_ASSERT_EQUAL(SmallMesh::ERR_NOT_FOR_US, mesh.receive(other, other_len, SRC_MAC));
+    other_len = makeFrame(other, MESH_MSG_COMMAND, MASTER, MESH_BROADCAST, 0, payload, 4);
+    TEST_ASSERT_EQUAL(SmallMesh::ERR_NOT_FOR_US, mesh.receive(other, other_len, SRC_MAC));
+    other_len = makeFrame(other, 0x42, HEAD, MASTER, 0, payload, 4);
+    TEST_ASSERT_EQUAL(SmallMesh::ERR_TYPE, mesh.receive(other, other_len, SRC_MAC));
+
+    for (uint8_t p = 0; p < SmallMesh::PRIORITIES; p++) TEST_ASSERT_EQUAL(0, mesh.depth(p));
+    TEST_ASSERT_EQUAL(SmallMesh::OK, mesh.receive(frame, len, SRC_MAC));
+    TEST_ASSERT_EQUAL(1, mesh.depth(2));
+    const SmallMesh::Stats& st = mesh.statistics();
+    TEST_ASSERT_EQUAL(1, st.received);
+    TEST_ASSERT_EQUAL(1, st.rejected[SmallMesh::ERR_CRC]);
+    TEST_ASSERT_EQUAL(2, st.rejected[SmallMesh::ERR_NOT_FOR_US]);
+    TEST_ASSERT_EQUAL(1, st.rejected[SmallMesh::ERR_TYPE]);
+}
+
+// ---- Priority rings ----
+
+struct Order {
+    uint8_t types[64];
+    uint8_t count = 0;
+    SmallMesh* inject_into = nullptr;       // Receive an emergency from the first STATUS handler
+};
+
+static void recordOrder(void* ctx, const MeshHeader* h, const uint8_t*, const uint8_t*)
+{
+    Order* o = (Order*)ctx;
+    o->types[o->count++] = h->msg_type;
+    if (o->inject_into && h->msg_type == MESH_MSG_STATUS) {
+        uint8_t frame[MESH_MAX_FRAME];
+        uint8_t code = 0x99;
+        uint16_t len = makeFrame(frame, MESH_MSG_EMERGENCY, 0x24, MESH_BROADCAST, 1, &code, 1);
+        o->inject_into->receive(frame, len, SRC_MAC);
+        o->inject_into = nullptr;
+    }
+}
+
+static void test_priority_and_overflow(void)
+{
+    SmallMesh::Transport none = { nullptr, nullptr };
+    SmallMesh mesh;
+    mesh.begin(MASTER, none, 3000);
+    Order order;
+    const uint8_t types[4] = {MESH_MSG_EMERGENCY, MESH_MSG_COMMAND, MESH_MSG_STATUS, MESH_MSG_HEARTBEAT};
+    for (uint8_t t : types) mesh.onMessage(t, recordOrder, &order);
+
+    uint8_t frame[MESH_MAX_FRAME];
+    uint8_t byte = 3;
+    uint8_t seq[4] = {0, 0, 0, 0};
+    // Arrival: HB HB HB ST ST CMD CMD EMG
+    const uint8_t arrival[8] = {MESH_MSG_HEARTBEAT, MESH_MSG_HEARTBEAT, MESH_MSG_HEARTBEAT, MESH_MSG_STATUS,
+                                MESH_MSG_STATUS, MESH_MSG_COMMAND, MESH_MSG_COMMAND, MESH_MSG_EMERGENCY};
+    for (uint8_t t : arrival) {
+        uint8_t p = SmallMesh::priorityOf(t);
+        uint16_t len = makeFrame(frame, t, HEAD, MASTER, seq[p]++, &byte, 1);
+        TEST_ASSERT_EQUAL(SmallMesh::OK, mesh.receive(frame, len, SRC_MAC));
+    }
+    order.inject_into = &mesh;
+    TEST_ASSERT_EQUAL(9, mesh.poll(100, 0));
+    const uint8_t expect[9] = {MESH_MSG_EMERGENCY, MESH_MSG_COMMAND, MESH_MSG_COMMAND, MESH_MSG_STATUS,
+                               MESH_MSG_EMERGENCY, MESH_MSG_STATUS, MESH_MSG_HEARTBEAT, MESH_MSG_HEARTBEAT,
+                               MESH_MSG_HEARTBEAT};
+    for (int i = 0; i < 9; i++) TEST_ASSERT_EQUAL(expect[i], order.types[i]);
+
+    // poll() budget: stops after max_frames, rest stays queued
+    for (int i = 0; i < 3; i++) {
+        uint16_t len = makeFrame(frame, MESH_MSG_HEARTBEAT, HEAD, MASTER, seq[3]++, &byte, 1);
+        mesh.receive(frame, len, SRC_MAC);
+    }
+    TEST_ASSERT_EQUAL(2, mesh.poll(2, 0));
+    TEST_ASSERT_EQUAL(1, mesh.depth(3));
+    mesh.poll(100, 0);
+
+    // Overflow: 6 heartbeats into a 4-slot ring, 2 dropped, seen as a gap later
+    int full = 0;
+    for (int i = 0; i < 6; i++) {
+        uint16_t len = makeFrame(frame, MESH_MSG_HEARTBEAT, HEAD, MASTER, seq[3]++, &byte, 1);
+        full += mesh.receive(frame, len, SRC_MAC) == SmallMesh::ERR_FULL ? 1 : 0;
+    }
+    TEST_ASSERT_EQUAL(2, full);
+    TEST_ASSERT_EQUAL(4, mesh.statistics().peak_depth[3]);
+    mesh.poll(100, 0);
+    TEST_ASSERT_EQUAL(0, mesh.node(HEAD)->lost);
+    uint16_t len = makeFrame(frame, MESH_MSG_HEARTBEAT, HEAD, MASTER, seq[3]++, &byte, 1);
+    mesh.receive(frame, len, SRC_MAC);
+    mesh.poll(100, 0);
+    TEST_ASSERT_EQUAL(2, mesh.node(HEAD)->lost);
+    printf("[INFO] priority: dispatch order ok, %d of 6 dropped on a full ring, %u counted lost\n",
+           full, (unsigned)mesh.node(HEAD)->lost);
+}
+
+// ---- Zero copy ----
+
+struct Seen {
+    const uint8_t* payload = nullptr;
+    const uint8_t* src = nullptr;
+    uint8_t first = 0;
+};
+
+static void recordPointer(void* ctx, const MeshHeader*, const uint8_t* payload, const uint8_t* src)
+{
+    Seen* s = (Seen*)ctx;
+    s->payload = payload;
+    s->src = src;
+    s->first = payload[0];
+}
+
+static void test_zero_copy_dispatch(void)
+{
+    SmallMesh::Transport none = { nullptr, nullptr };
+    static SmallMesh mesh;
+    mesh.begin(MASTER, none, 3000);
+    Seen seen;
+    mesh.onMessage(MESH_MSG_COMMAND, recordPointer, &seen);
+
+    // Transport receives straight into the slot (UDP pump does this)
+    uint8_t* slot = mesh.reserve(MESH_MSG_COMMAND);
+    TEST_ASSERT_NOT_NULL(slot);
+    uint8_t params[3] = {0x20, 0x01, 0x5A};
+    uint16_t len = makeFrame(slot, MESH_MSG_COMMAND, HEAD, MASTER, 0, params, 3);
+    TEST_ASSERT_EQUAL(SmallMesh::OK, mesh.commit(len, SRC_MAC));
+    TEST_ASSERT_EQUAL(1, mesh.poll(8, 0));
+    TEST_ASSERT_TRUE(seen.payload == slot + MESH_HEADER_BYTES);
+    TEST_ASSERT_EQUAL(0x20, seen.first);
+    TEST_ASSERT_EQUAL(0, memcmp(seen.src, SRC_MAC, 6));
+
+    // receive(): one copy out of the driver buffer, then pointers into the ring
+    uint8_t driver[MESH_MAX_FRAME];
+    len = makeFrame(driver, MESH_MSG_COMMAND, HEAD, MASTER, 1, params, 3);
+    mesh.receive(driver, len, SRC_MAC);
+    mesh.poll(8, 0);
+    const uint8_t* lo = (const uint8_t*)&mesh;
+    TEST_ASSERT_TRUE(seen.payload >= lo && seen.payload < lo + sizeof(mesh));
+    TEST_ASSERT_TRUE(seen.payload != driver + MESH_HEADER_BYTES);
+
+    // Invalid frame in a reserved slot is not published
+    slot = mesh.reserve(MESH_MSG_COMMAND);
+    len = makeFrame(slot, MESH_MSG_COMMAND, HEAD, MASTER, 2, params, 3);
+    slot[MESH_HEADER_BYTES] ^= 0xFF;
+    TEST_ASSERT_EQUAL(SmallMesh::ERR_CRC, mesh.commit(len, SRC_MAC));
+    TEST_ASSERT_EQUAL(0, mesh.depth(1));
+}
+
+// ---- Producer thread / consumer poll ----
+
+struct Loopback {
+    SlaveMesh* to;
+    uint32_t retries = 0;
+};
+
+static bool loopbackSend(void* ctx, uint8_t, const uint8_t* frame, uint16_t len)
+{
+    Loopback* lb = (Loopback*)ctx;
+    while (lb->to->receive(frame, len, SRC_MAC) == SlaveMesh::ERR_FULL) {
+        lb->retries++;
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+struct Stream {
+    uint32_t next[2] = {0, 0};
+    uint32_t torn = 0;
+    uint32_t out_of_order = 0;
+};
+
+static void checkStream(void* ctx, const MeshHeader* h, const uint8_t* payload, const uint8_t*)
+{
+    Stream* s = (Stream*)ctx;
+    int which = h->msg_type == MESH_MSG_COMMAND ? 0 : 1;
+    uint32_t counter;
+    memcpy(&counter, payload, 4);
+    if (counter != s->next[which]) s->out_of_order++;
+    s->next[which] = counter + 1;
+    for (uint16_t i = 4; i < h->payload_len; i++) {
+        if (payload[i] != (uint8_t)(counter + i)) { s->torn++; break; }
+    }
+}
+
+static void test_threaded_rings(void)
+{
+    static SlaveMesh receiver;
+    static SlaveMesh sender;
+    SlaveMesh::Transport none = { nullptr, nullptr };
+    receiver.begin(MASTER, none, 3000);
+    Loopback lb;
+    lb.to = &receiver;
+    SlaveMesh::Transport link = { loopbackSend, &lb };
+    sender.begin(HEAD, link, 3000);
+    Stream stream;
+    receiver.onMessage(MESH_MSG_COMMAND, checkStream, &stream);
+    receiver.onMessage(MESH_MSG_STATUS, checkStream, &stream);
+
+    const uint32_t N = 200000;
+    uint64_t t0 = host_bench::nowNs();
+    std::thread producer([&]() {
+        uint8_t payload[MESH_MAX_PAYLOAD];
+        uint32_t counter[2] = {0, 0};
+        for (uint32_t i = 0; i < N; i++) {
+            int which = (i % 3 == 0) ? 0 : 1;
+            uint16_t len = (uint16_t)(8 + (i * 37) % (MESH_MAX_PAYLOAD - 8));
+            memcpy(payload, &counter[which], 4);
+            for (uint16_t b = 4; b < len; b++) payload[b] = (uint8_t)(counter[which] + b);
+            counter[which]++;
+            sender.send(which ? MESH_MSG_STATUS : MESH_MSG_COMMAND, MASTER, payload, len, i);
+        }
+    });
+    uint32_t got = 0;
+    while (got < N) {
+        uint16_t n = receiver.poll(16, 0);
+        if (!n) std::this_thread::yield();
+        got += n;
+    }
+    producer.join();
+    double seconds = (host_bench::nowNs() - t0) / 1e9;
+
+    printf("[INFO] threads: %u frames in %.3f s (%.0f frames/s), %u retries on a full ring\n",
+           (unsigned)N, seconds, N / seconds, (unsigned)lb.retries);
+    TEST_ASSERT_EQUAL(N, receiver.statistics().received);
+    TEST_ASSERT_EQUAL(0, stream.torn);
+    TEST_ASSERT_EQUAL(0, stream.out_of_order);
+    TEST_ASSERT_EQUAL(0, receiver.node(HEAD)->lost);
+    TEST_ASSERT_EQUAL(N, stream.next[0] + stream.next[1]);
+}
+
+// ---- Node table ----
+
+struct Changes {
+    int online = 0;
+    int offline = 0;
+    uint8_t last_role = 0;
+};
+
+static void recordChange(void* ctx, const SmallMesh::Node& node, bool online)
+{
+    Changes* c = (Changes*)ctx;
+    (online ? c->online : c->offline)++;
+    c->last_role = node.role;
+}
+
+static void test_node_table(void)
+{
+    SmallMesh::Transport none = { nullptr, nullptr };
+    SmallMesh mesh;
+    mesh.begin(MASTER, none, 3000);
+    Changes changes;
+    mesh.onNodeChange(recordChange, &changes);
+
+    uint8_t frame[MESH_MAX_FRAME];
+    uint8_t hb[8] = {0};
+    uint16_t len = makeFrame(frame, MESH_MSG_HEARTBEAT, HEAD, MASTER, 0, hb, 8);
+    mesh.receive(frame, len, SRC_MAC);
+    len = makeFrame(frame, MESH_MSG_HEARTBEAT, 0x24, MESH_BROADCAST, 0, hb, 8);
+    mesh.receive(frame, len, SRC_MAC);
+    mesh.poll(8, 1000);
+    TEST_ASSERT_EQUAL(2, mesh.nodeCount());
+    TEST_ASSERT_EQUAL(2, mesh.onlineCount());
+    TEST_ASSERT_EQUAL(2, changes.online);
+    TEST_ASSERT_EQUAL(2, mesh.node(HEAD)->status);          // READY after a heartbeat
+
+    uint8_t status[12] = {4};                               // P32_STATUS_ERROR
+    len = makeFrame(frame, MESH_MSG_STATUS, HEAD, MASTER, 0, status, 12);
+    mesh.receive(frame, len, SRC_MAC);
+    mesh.poll(8, 2500);
+    TEST_ASSERT_EQUAL(4, mesh.node(HEAD)->status);
+    TEST_ASSERT_EQUAL(2, mesh.node(HEAD)->messages);
+
+    mesh.poll(8, 4001);                                     // 0x24 silent for 3001 ms
+    TEST_ASSERT_EQUAL(1, changes.offline);
+    TEST_ASSERT_EQUAL(0x24, changes.last_role);
+    TEST_ASSERT_FALSE(mesh.node(0x24)->online);
+    TEST_ASSERT_TRUE(mesh.node(HEAD)->online);
+    TEST_ASSERT_EQUAL(1, mesh.onlineCount());
+
+    len = makeFrame(frame, MESH_MSG_HEARTBEAT, 0x24, MESH_BROADCAST, 9, hb, 8);
+    mesh.receive(frame, len, SRC_MAC);
+    mesh.poll(8, 4100);
+    TEST_ASSERT_EQUAL(3, changes.online);
+    TEST_ASSERT_EQUAL(0, mesh.node(0x24)->lost);            // Sequence restarts after offline
+    TEST_ASSERT_EQUAL(2, mesh.nodeCount());
+}
+
+// ---- UDP multicast mesh ----
+
+static const int SLAVES = 7;
+static const uint16_t BENCH_PAYLOAD = 64;
+
+struct Latency {
+    std::vector<double> us;
+    uint32_t frames = 0;
+};
+
+static void masterStatus(void* ctx, const MeshHeader*, const uint8_t* payload, const uint8_t*)
+{
+    Latency* l = (Latency*)ctx;
+    uint64_t sent;
+    memcpy(&sent, payload + 16, 8);
+    l->us.push_back((host_bench::nowNs() - sent) / 1000.0);
+    l->frames++;
+}
+
+static void countCommand(void* ctx, const MeshHeader*, const uint8_t*, const uint8_t*)
+{
+    (*(uint32_t*)ctx)++;
+}
+
+static void statusPayload(uint8_t* payload)
+{
+    memset(payload, 0, BENCH_PAYLOAD);
+    payload[0] = 3;                                         // P32_STATUS_ACTIVE
+    uint64_t now = host_bench::nowNs();
+    memcpy(payload + 16, &now, 8);
+}
+
+static void latencySummary(FILE* csv, const char* phase, Latency& l, double seconds)
+{
+    std::vector<double> v = l.us;
+    std::sort(v.begin(), v.end());
+    double mean = 0.0;
+    for (double x : v) mean += x;
+    mean = v.empty() ? 0.0 : mean / v.size();
+    double p50 = v.empty() ? 0.0 : v[v.size() / 2];
+    double p99 = v.empty() ? 0.0 : v[(v.size() * 99) / 100];
+    double worst = v.empty() ? 0.0 : v.back();
+    printf("[BENCH] udp %-10s %6u frames  %8.0f frames/s  latency mean %7.1f us  p50 %7.1f  p99 %7.1f  max %8.1f\n",
+           phase, (unsigned)l.frames, l.frames / seconds, mean, p50, p99, worst);
+    if (csv) {
+        fprintf(csv, "%s,%u,%.4f,%.0f,%.1f,%.1f,%.1f,%.1f\n", phase, (unsigned)l.frames, seconds,
+                l.frames / seconds, mean, p50, p99, worst);
+    }
+}
+
+static void test_udp_multicast_mesh(void)
+{
+    static host_mesh::UdpMulticastTransport master_udp, slave_udp[SLAVES];
+    static MasterMesh master;
+    static SlaveMesh slaves[SLAVES];
+    if (!master_udp.open()) {
+        printf("[SKIP] udp: no multicast on loopback in this environment\n");
+        return;
+    }
+    for (int i = 0; i < SLAVES; i++) TEST_ASSERT_TRUE(slave_udp[i].open());
+
+    master.begin(MASTER, { host_mesh::UdpMulticastTransport::send, &master_udp }, 3000);
+    Latency latency;
+    master.onMessage(MESH_MSG_STATUS, masterStatus, &latency);
+    uint32_t commands[SLAVES] = {0};
+    for (int i = 0; i < SLAVES; i++) {
+        slaves[i].begin((uint8_t)(HEAD + i), { host_mesh::UdpMulticastTransport::send, &slave_udp[i] }, 3000);
+        slaves[i].onMessage(MESH_MSG_COMMAND, countCommand, &commands[i]);
+    }
+    host_bench::ensureOutputDir();
+    FILE* csv = fopen("test_output/mesh_udp.csv", "w");
+    if (csv) fprintf(csv, "phase,frames,seconds,frames_per_s,lat_mean_us,lat_p50_us,lat_p99_us,lat_max_us\n");
+    uint8_t payload[BENCH_PAYLOAD];
+
+    // Ping-pong: one STATUS in flight at a time
+    const int PINGS = 2000;
+    uint64_t t0 = host_bench::nowNs();
+    for (int i = 0; i < PINGS; i++) {
+        statusPayload(payload);
+        slaves[i % SLAVES].send(MESH_MSG_STATUS, MASTER, payload, BENCH_PAYLOAD, (uint32_t)i);
+        uint32_t want = latency.frames + 1;
+        while (latency.frames < want && master_udp.wait(100)) {
+            master_udp.pump(master, 16);
+            master.poll(16, 0);
+        }
+    }
+    latencySummary(csv, "ping_pong", latency, (host_bench::nowNs() - t0) / 1e9);
+    TEST_ASSERT_EQUAL(PINGS, latency.frames);
+
+    // Burst: every slave sends 16 STATUS per round, master broadcasts one COMMAND
+    Latency burst;
+    master.onMessage(MESH_MSG_STATUS, masterStatus, &burst);
+    const int ROUNDS = 200, BURST = 16;
+    uint8_t cmd[4] = {0x20, 0, 0, 0};
+    t0 = host_bench::nowNs();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int i = 0; i < SLAVES; i++) {
+            for (int k = 0; k < BURST; k++) {
+                statusPayload(payload);
+                slaves[i].send(MESH_MSG_STATUS, MASTER, payload, BENCH_PAYLOAD, (uint32_t)round);
+            }
+        }
+        master.send(MESH_MSG_COMMAND, MESH_BROADCAST, cmd, 4, (uint32_t)round);
+        uint32_t want = (uint32_t)(round + 1) * SLAVES * BURST;
+        while (burst.frames < want && master_udp.wait(100)) {
+            master_udp.pump(master, 16);
+            master.poll(16, 0);
+        }
+        for (int i = 0; i < SLAVES; i++) {
+            while (slave_udp[i].pump(slaves[i], 64)) slaves[i].poll(64, 0);
+        }
+    }
+    double seconds = (host_bench::nowNs() - t0) / 1e9;
+    latencySummary(csv, "burst", burst, seconds);
+    if (csv) fclose(csv);
+
+    uint32_t lost = 0;
+    for (uint8_t n = 0; n < master.nodeCount(); n++) lost += master.nodeAt(n)->lost;
+    const MasterMesh::Stats& st = master.statistics();
+    printf("[INFO] udp: master %u nodes online, %u lost, %u full, %u crc, %u not for us (own echo), peak STATUS depth %u/32\n",
+           (unsigned)master.onlineCount(), (unsigned)lost, (unsigned)st.rejected[MasterMesh::ERR_FULL],
+           (unsigned)st.rejected[MasterMesh::ERR_CRC], (unsigned)st.rejected[MasterMesh::ERR_NOT_FOR_US],
+           (unsigned)st.peak_depth[2]);
+
+    TEST_ASSERT_EQUAL(ROUNDS * SLAVES * BURST, burst.frames);
+    TEST_ASSERT_EQUAL(SLAVES, master.onlineCount());
+    TEST_ASSERT_EQUAL(0, lost);
+    TEST_ASSERT_EQUAL(0, st.rejected[MasterMesh::ERR_CRC]);
+    for (int i = 0; i < SLAVES; i++) {
+        TEST_ASSERT_EQUAL(ROUNDS, commands[i]);
+        // Slaves see each other's STATUS to the master and drop it before the CRC
+        TEST_ASSERT_TRUE(slaves[i].statistics().rejected[SlaveMesh::ERR_NOT_FOR_US] > 0);
+    }
+
+    master_udp.close();
+    for (int i = 0; i < SLAVES; i++) slave_udp[i].close();
+}
+
+// ---- Cost ----
+
+static void test_receive_cost(void)
+{
+    uint8_t frame[MESH_MAX_FRAME];
+    uint8_t payload[MESH_MAX_PAYLOAD];
+    for (int i = 0; i < MESH_MAX_PAYLOAD; i++) payload[i] = (uint8_t)(i * 13);
+    uint16_t len = makeFrame(frame, MESH_MSG_STATUS, HEAD, MASTER, 0, payload, MESH_MAX_PAYLOAD);
+
+    const int LAPS = 20000;
+    uint32_t sink = 0;
+    host_bench::CostStats bitwise, table, slice4, rx;
+    uint64_t t0 = host_bench::nowNs();
+    for (int i = 0; i < LAPS; i++) sink += MeshCrc16::bitwise(MeshCrc16::INIT, frame, len);
+    bitwise.add((host_bench::nowNs() - t0) / LAPS);
+    t0 = host_bench::nowNs();
+    for (int i = 0; i < LAPS; i++) sink += MeshCrc16::table(MeshCrc16::INIT, frame, len);
+    table.add((host_bench::nowNs() - t0) / LAPS);
+    t0 = host_bench::nowNs();
+    for (int i = 0; i < LAPS; i++) sink += MeshCrc16::update(MeshCrc16::INIT, frame, len);
+    slice4.add((host_bench::nowNs() - t0) / LAPS);
+
+    static SlaveMesh mesh;
+    SlaveMesh::Transport none = { nullptr, nullptr };
+    mesh.begin(MASTER, none, 3000);
+    Seen seen;
+    mesh.onMessage(MESH_MSG_STATUS, recordPointer, &seen);
+    t0 = host_bench::nowNs();
+    for (int i = 0; i < LAPS; i++) {
+        ((MeshHeader*)frame)->sequence = (uint8_t)i;
+        SlaveMesh::seal(frame);
+        mesh.receive(frame, len, SRC_MAC);
+        mesh.poll(4, 0);
+    }
+    rx.add((host_bench::nowNs() - t0) / LAPS);
+
+    // ESP-NOW at 1 Mbps: a 216-byte frame is ~2 ms of air time
+    bitwise.print("CRC16 bitwise, 216 B", 2e6);
+    table.print("CRC16 byte table, 216 B", 2e6);
+    slice4.print("CRC16 slice-by-4, 216 B", 2e6);
+    rx.print("seal + receive + poll, 216 B", 2e6);
+    printf("[INFO] cost: slice-by-4 %.1fx bitwise, %.1fx byte table (checksum sink %u)\n",
+           bitwise.meanNs() / slice4.meanNs(), table.meanNs() / slice4.meanNs(), (unsigned)(sink & 1));
+    TEST_ASSERT_EQUAL(LAPS, mesh.statistics().received);
+    TEST_ASSERT_EQUAL(0, mesh.node(HEAD)->lost);
+    TEST_ASSERT_TRUE(slice4.meanNs() < bitwise.meanNs());
+    TEST_ASSERT_TRUE(rx.meanNs() < 20000.0);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_crc16);
+    RUN_TEST(test_frame_validation);
+    RUN_TEST(test_priority_and_overflow);
+    RUN_TEST(test_zero_copy_dispatch);
+    RUN_TEST(test_threaded_rings);
+    RUN_TEST(test_node_table);
+    RUN_TEST(test_udp_multicast_mesh);
+    RUN_TEST(test_receive_cost);
+    return UNITY_END();
+}
@@ -0,0 +1,269 @@
+/**
+ * @file test_main.cpp
+ * @brief Host tests of MoodDynamics: decay, hysteresis, trace replay publication counts, cost
+ *
+ * Mood components are in Mood units (-128..127), ticked at goblin_mood's
+ * 20 Hz rate.
+ *
+ * - Decay: an impulse relaxes to the baseline with the configured time
+ *   constant, personality gain scales it, and the published mood lands
+ *   exactly on the quantized baseline once it settles
+ * - Hysteresis: a drive jittering inside the band publishes nothing after
+ *   the first settle; the published mood never lags the integrator by more
+ *   than band + quantum
+ * - Trace replay: a 2-minute visitor trace (noisy attention and presence
+ *   at 20 Hz, startles, touches, a component nudging curiosity every
+ *   2.5 s) is replayed through the engine and through the previous
+ *   behaviour, where each component wrote Mood directly and every changed
+ *   byte meant a retint plus a broadcast. Publications are counted for both
+ * - Cost: tick() with no stimuli and with 50 stimuli posted in between
+ *
+ * Outputs for inspection (test_output/):
+ *   mood_dynamics.csv - t, attention, legacy curiosity, integrator curiosity,
+ *                       published curiosity, fear, publication flags
+ *
+ * Run: pio test -e host_test -f test_host_mood_dynamics
+ */
+
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "config/components/templates/MoodDynamics.hpp"
+#include "../host_support/host_bench.hpp"
+
+static const int COMPONENTS = 9;                // Mood::componentCount
+enum { ANGER = 0, FEAR, HAPPINESS, SADNESS, CURIOSITY, AFFECTION, IRRITATION, CONTENTMENT, EXCITEMENT };
+
+typedef MoodDynamics<COMPONENTS> Dynamics;
+
+static const uint16_t RATE_HZ = 20;
+static const uint8_t QUANT_SHIFT = 2;
+static const uint8_t BAND = 8;
+
+static const uint16_t TAU_MS[COMPONENTS] = {4000, 2500, 6000, 10000, 3000, 8000, 5000, 15000, 1500};
+
+static uint32_t rng_state = 4242;
+static float frand() {
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return (float)(rng_state >> 8) / 16777216.0f;
+}
+
+static void configureGoblin(Dynamics& d) {
+    d.configure(RATE_HZ, QUANT_SHIFT, BAND);
+    for (int c = 0; c < COMPONENTS; c++) d.setDecay(c, TAU_MS[c]);
+    // goblin_personality defaults: aggression 60, curiosity 70, fear 20, affection 40
+    d.setBaseline(ANGER, 60 / 8);
+    d.setBaseline(CURIOSITY, 70 / 8);
+    d.setBaseline(FEAR, 20 / 8);
+    d.setBaseline(AFFECTION, 40 / 8);
+    d.setGain(CURIOSITY, 192 + 70);
+    d.setGain(EXCITEMENT, 192 + 70);
+    d.setGain(FEAR, 192 + 20);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_decay_and_rest(void) {
+    Dynamics d;
+    d.configure(RATE_HZ, 0, 4);
+    d.setDecay(FEAR, 2000);
+    d.tick();
+
+    d.stimulate(FEAR, 100);
+    d.tick();
+    TEST_ASSERT_INT_WITHIN(1, 98, d.level(FEAR));           // One tick of decay already applied
+    for (int i = 1; i < 40; i++) d.tick();                  // 2 s = one time constant
+    printf("[DECAY] fear after tau: %d (ideal %.1f)\n", d.level(FEAR), 100.0 * exp(-1.0));
+    TEST_ASSERT_INT_WITHIN(2, 37, d.level(FEAR));
+
+    // Gain scales the response
+    Dynamics lo, hi;
+    lo.configure(RATE_HZ, 0, 1);
+    hi.configure(RATE_HZ, 0, 1);
+    lo.setGain(ANGER, 192);
+    hi.setGain(ANGER, 320);
+    lo.stimulate(ANGER, 40);
+    hi.stimulate(ANGER, 40);
+    lo.tick();
+    hi.tick();
+    TEST_ASSERT_INT_WITHIN(1, 29, lo.level(ANGER));
+    TEST_ASSERT_INT_WITHIN(1, 49, hi.level(ANGER));
+
+    // Back at rest the published mood is exactly the quantized baseline,
+    // not left anywhere inside the band
+    Dynamics g;
+    configureGoblin(g);
+    g.tick();
+    g.stimulate(FEAR, 60);
+    g.stimulate(CURIOSITY, -50);
+    for (int i = 0; i < 60 * RATE_HZ; i++) g.tick();
+    TEST_ASSERT_EQUAL(4, g.value(FEAR));                    // baseline 2 -> quantum 4
+    TEST_ASSERT_EQUAL(8, g.value(CURIOSITY));               // baseline 8
+    TEST_ASSERT_EQUAL(8, g.value(ANGER));                   // baseline 7 -> 8
+    TEST_ASSERT_EQUAL(0, g.value(EXCITEMENT));
+    uint32_t settled = g.publications();
+    for (int i = 0; i < 60 * RATE_HZ; i++) g.tick();
+    TEST_ASSERT_EQUAL(settled, g.publications());
+}
+
+void test_hysteresis_suppresses_jitter(void) {
+    Dynamics d;
+    configureGoblin(d);
+    int worst_lag = 0;
+    uint32_t settle_pubs = 0;
+    for (int i = 0; i < 120 * RATE_HZ; i++) {
+        // Attention-like drive: 30 +/- 6 of noise each fusion update
+        d.drive(CURIOSITY, (int8_t)(30 + (int)(frand() * 13.0f) - 6));
+        d.drive(EXCITEMENT, (int8_t)(20 + (int)(frand() * 9.0f) - 4));
+        d.tick();
+        if (i == 20 * RATE_HZ) settle_pubs = d.publications();
+        for (int c = 0; c < COMPONENTS; c++) {
+            int lag = abs(d.level(c) - d.value(c));
+            if (lag > worst_lag) worst_lag = lag;
+        }
+    }
+    uint32_t jitter_pubs = d.publications() - settle_pubs;
+    printf("[JITTER] %u publications while settling, %u in 100 s of jitter, worst lag %d\n",
+           settle_pubs, jitter_pubs, worst_lag);
+    TEST_ASSERT_TRUE(settle_pubs <= 12);
+    TEST_ASSERT_EQUAL(0, jitter_pubs);
+    TEST_ASSERT_TRUE(worst_lag <= BAND + (1 << QUANT_SHIFT));
+}
+
+struct Frame {
+    uint8_t attention;
+    uint8_t presence;
+    int16_t approach_cm_s;
+    uint16_t proximity_cm;
+    bool touched;
+};
+
+/**
+ * Visitor trace, 120 s at 20 Hz:
+ *   0-20 s    empty room, sensor noise only
+ *   20-30 s   visitor approaches (fast dash at 27 s)
+ *   30-60 s   stands close talking; touches at 40 s and 52 s
+ *   60-70 s   leaves
+ *   70-90 s   empty room
+ *   90-110 s  second visitor lingers at a distance
+ *   110-120 s empty
+ */
+static Frame traceFrame(int i) {
+    float t = (float)i / RATE_HZ;
+    Frame f = {0, 0, 0, 300, false};
+    float att = 0.0f, pres = 0.0f;
+    if (t >= 20 && t < 30) { pres = 80 + 17 * (t - 20); att = 40 + 12 * (t - 20); f.proximity_cm = (uint16_t)(200 - 15 * (t - 20)); f.approach_cm_s = 15; }
+    else if (t >= 30 && t < 60) { pres = 250; att = 170; f.proximity_cm = 40; }
+    else if (t >= 60 && t < 70) { pres = 250 - 22 * (t - 60); att = 120 - 12 * (t - 60); f.proximity_cm = (uint16_t)(40 + 26 * (t - 60)); f.approach_cm_s = -25; }
+    else if (t >= 90 && t < 110) { pres = 160; att = 60; f.proximity_cm = 140; }
+    if (t >= 27 && t < 27.6f) { f.approach_cm_s = 140; f.proximity_cm = 50; }
+    if ((t >= 40 && t < 41.5f) || (t >= 52 && t < 53)) { f.touched = true; f.proximity_cm = 0; att = 255; }
+    // Fusion output jitter: a few counts on every update
+    att += frand() * 16.0f - 8.0f;
+    pres += frand() * 12.0f - 6.0f;
+    f.attention = (uint8_t)(att < 0 ? 0 : (att > 255 ? 255 : att));
+    f.presence = (uint8_t)(pres < 0 ? 0 : (pres > 255 ? 255 : pres));
+    return f;
+}
+
+static int8_t clamp8(int v) { return (int8_t)(v > 127 ? 127 : (v < -128 ? -128 : v)); }
+
+void test_trace_replay_publications(void) {
+    host_bench::ensureOutputDir();
+    FILE* csv = fopen("test_output/mood_dynamics.csv", "w");
+    TEST_ASSERT_NOT_NULL(csv);
+    fprintf(csv, "t,attention,legacy_curiosity,level_curiosity,published_curiosity,legacy_fear,published_fear,legacy_pub,engine_pub\n");
+
+    Dynamics d;
+    configureGoblin(d);
+
+    int8_t legacy[COMPONENTS] = {};
+    int8_t legacy_last[COMPONENTS] = {};
+    uint32_t legacy_pubs = 0;
+    bool was_startled = false, was_touched = false, was_present = false;
+    bool l_startled = false, l_touched = false;
+    int worst_lag = 0;
+
+    const int ticks = 120 * RATE_HZ;
+    for (int i = 0; i < ticks; i++) {
+        Frame f = traceFrame(i);
+
+        // Previous behaviour: components write Mood straight from their
+        // inputs; any changed byte is a retint + broadcast
+        legacy[CURIOSITY] = clamp8(f.attention / 3);
+        legacy[EXCITEMENT] = clamp8(f.presence / 4);
+        bool startled = f.approach_cm_s > 80 && f.proximity_cm < 60;
+        if (startled && !l_startled) { legacy[FEAR] = clamp8(legacy[FEAR] + 35); legacy[IRRITATION] = clamp8(legacy[IRRITATION] + 10); }
+        l_startled = startled;
+        if (f.touched && !l_touched) { legacy[AFFECTION] = clamp8(legacy[AFFECTION] + 40); legacy[HAPPINESS] = clamp8(legacy[HAPPINESS] + 24); }
+        l_touched = f.touched;
+        if (i % 50 == 0 && f.presence > 100) legacy[CURIOSITY] = clamp8(legacy[CURIOSITY] + 3);   // Pirate head nudge
+        bool legacy_pub = memcmp(legacy, legacy_last, sizeof(legacy)) != 0;
+        if (legacy_pub) { legacy_pubs++; memcpy(legacy_last, legacy, sizeof(legacy)); }
+
+        // goblin_mood: same inputs as stimuli
+        d.drive(CURIOSITY, (int8_t)(f.attention / 3));
+        d.drive(EXCITEMENT, (int8_t)(f.presence / 4));
+        if (startled && !was_startled) { d.stimulate(FEAR, 35); d.stimulate(IRRITATION, 10); }
+        was_startled = startled;
+        if (f.touched && !was_touched) { d.stimulate(AFFECTION, 40); d.stimulate(HAPPINESS, 24); }
+        was_touched = f.touched;
+        if (f.presence >= 128) was_present = true;
+        else if (was_present && f.presence < 32) { d.stimulate(SADNESS, 16); was_present = false; }
+        if (i % 50 == 0 && f.presence > 100) d.stimulate(CURIOSITY, 3);
+        bool engine_pub = d.tick();
+
+        for (int c = 0; c < COMPONENTS; c++) {
+            int lag = abs(d.level(c) - d.value(c));
+            if (lag > worst_lag) worst_lag = lag;
+        }
+        fprintf(csv, "%.2f,%u,%d,%d,%d,%d,%d,%d,%d\n", (double)i / RATE_HZ, f.attention,
+                legacy[CURIOSITY], d.level(CURIOSITY), d.value(CURIOSITY),
+                legacy[FEAR], d.value(FEAR), legacy_pub ? 1 : 0, engine_pub ? 1 : 0);
+    }
+    fclose(csv);
+
+    printf("[TRACE] %d ticks: legacy %u publications, MoodDynamics %u (%.1fx fewer), worst lag %d\n",
+           ticks, legacy_pubs, d.publications(), (double)legacy_pubs / d.publications(), worst_lag);
+    TEST_ASSERT_TRUE(legacy_pubs > (uint32_t)ticks / 2);
+    TEST_ASSERT_TRUE(d.publications() * 10 <= legacy_pubs);
+    TEST_ASSERT_TRUE(d.publications() >= 8);                 // Still follows the visit
+    TEST_ASSERT_TRUE(worst_lag <= BAND + (1 << QUANT_SHIFT));
+    TEST_ASSERT_TRUE(d.value(AFFECTION) <= 8);               // Touches have decayed by the end
+}
+
+void test_tick_cost(void) {
+    Dynamics d;
+    configureGoblin(d);
+    host_bench::CostStats quiet, busy;
+    volatile uint32_t sink = 0;
+    for (int i = 0; i < 20000; i++) {
+        d.drive(CURIOSITY, (int8_t)(i & 31));
+        uint64_t t0 = host_bench::nowNs();
+        sink += d.tick();
+        quiet.add(host_bench::nowNs() - t0);
+    }
+    for (int i = 0; i < 20000; i++) {
+        for (int s = 0; s < 50; s++) d.stimulate(s % COMPONENTS, (s & 1) ? 3 : -3);
+        uint64_t t0 = host_bench::nowNs();
+        sink += d.tick();
+        busy.add(host_bench::nowNs() - t0);
+    }
+    quiet.print("tick(), no stimuli", 1e9 / RATE_HZ);
+    busy.print("tick(), 50 stimuli pending", 1e9 / RATE_HZ);
+    (void)sink;
+    TEST_ASSERT_TRUE(busy.meanNs() < quiet.meanNs() * 3.0 + 50.0);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_decay_and_rest);
+    RUN_TEST(test_hysteresis_suppresses_jitter);
+    RUN_TEST(test_trace_replay_publications);
+    RUN_TEST(test_tick_cost);
+    return UNITY_END();
+}
@@ -0,0 +1,317 @@
+/**
+ * @file test_main.cpp
+ * @brief Host tests of MoodTintCache: keys, LRU eviction, budget, trace replay against retinting
+ *
+ * Frames are 240x240 RGB565 like the goblin eye; the tint is the same
+ * per-pixel work as adjustMood() (mood delta computed once, saturating add
+ * per pixel).
+ *
+ * - Keys: moods in the same 8-unit bin share a key, the next bin does not,
+ *   and the key carries the snapped mood the caller tints with
+ * - LRU: a touched entry survives, the least recently used one is evicted,
+ *   the byte budget sets the slot count, invalidateFrame() drops one frame
+ * - Trace replay: a 4-frame blink loop under a mood that steps between a
+ *   few nearby states at the eye's 20 fps. Every frame served
+ *   from the cache is byte-identical to a fresh tint. Retints and time are
+ *   compared with retinting on every change, over a sweep of budgets
+ *
+ * Outputs for inspection (test_output/):
+ *   mood_tint_cache.csv - budget_frames, hit_rate, retints, evictions,
+ *                         mb_saved, ms_cached, ms_retint
+ *
+ * Run: pio test -e host_test -f test_host_mood_tint_cache
+ */
+
+#include <unity.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "config/components/templates/MoodTintCache.hpp"
+#include "../host_support/host_bench.hpp"
+
+static const int COMPONENTS = 9;                // Mood::componentCount
+static const uint32_t PIXELS = 240 * 240;
+static const uint32_t FRAME_BYTES = PIXELS * 2;
+static const int ANIM_FRAMES = 4;
+
+typedef MoodTintCache<32> Cache;
+
+// Goblin effects in 1/256: anger red, fear blue, happiness warm, ...
+static const int16_t EFFECT_R[COMPONENTS] = {307, -77, 192, -115, 38, 154, 230, 115, 192};
+static const int16_t EFFECT_G[COMPONENTS] = {-115, -77, 192, -115, 269, 77, 77, 154, 192};
+static const int16_t EFFECT_B[COMPONENTS] = {-115, 230, 38, -38, 77, 154, -77, 38, 192};
+
+static void tint(uint16_t* dest, const uint16_t* src, const int8_t* mood)
+{
+    int32_t dr = 0, dg = 0, db = 0;
+    for (int i = 0; i < COMPONENTS; i++) {
+        dr += EFFECT_R[i] * mood[i];
+        dg += EFFECT_G[i] * mood[i];
+        db += EFFECT_B[i] * mood[i];
+    }
+    // Mood/128 x effect x 255, then to 5/6/5-bit channel units
+    int r = dr / (128 * 8), g = dg / (128 * 4), b = db / (128 * 8);
+    for (uint32_t p = 0; p < PIXELS; p++) {
+        uint16_t v = src[p];
+        int pr = (v >> 11) + r, pg = ((v >> 5) & 0x3F) + g, pb = (v & 0x1F) + b;
+        pr = pr < 0 ? 0 : (pr > 31 ? 31 : pr);
+        pg = pg < 0 ? 0 : (pg > 63 ? 63 : pg);
+        pb = pb < 0 ? 0 : (pb > 31 ? 31 : pb);
+        dest[p] = (uint16_t)((pr << 11) | (pg << 5) | pb);
+    }
+}
+
+static void drawEye(uint16_t* frame, int lid)
+{
+    for (int y = 0; y < 240; y++) {
+        for (int x = 0; x < 240; x++) {
+            int dx = x - 120, dy = y - 120;
+            int d2 = dx * dx + dy * dy;
+            uint16_t c = 0x0000;
+            if (d2 < 110 * 110) c = 0xC600;             // Amber
+            if (d2 < 60 * 60) c = 0x4A00;               // Iris
+            if (dx > -8 && dx < 8 && dy > -50 && dy < 50) c = 0x0000;   // Slit
+            if (y < lid || y > 240 - lid) c = 0x3186;  // Eyelid
+            frame[y * 240 + x] = c;
+        }
+    }
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_keys(void) {
+    static uint8_t arena[4 * 64];
+    Cache cache;
+    cache.configure(arena, sizeof(arena), 64, 3);
+
+    int8_t a[COMPONENTS] = {17, 0, 0, 0, -3, 0, 0, 0, 0};
+    int8_t b[COMPONENTS] = {22, 0, 0, 0, -8, 0, 0, 0, 0};
+    int8_t c[COMPONENTS] = {24, 0, 0, 0, -3, 0, 0, 0, 0};
+    Cache::Key ka = cache.makeKey(7, a, COMPONENTS);
+    Cache::Key kb = cache.makeKey(7, b, COMPONENTS);
+    Cache::Key kc = cache.makeKey(7, c, COMPONENTS);
+    TEST_ASSERT_TRUE(Cache::sameKey(ka, kb));
+    TEST_ASSERT_FALSE(Cache::sameKey(ka, kc));
+    TEST_ASSERT_FALSE(Cache::sameKey(ka, cache.makeKey(8, a, COMPONENTS)));
+    TEST_ASSERT_EQUAL(20, ka.mood[0]);          // Bin centre
+    TEST_ASSERT_EQUAL(-4, ka.mood[4]);
+    TEST_ASSERT_EQUAL(28, kc.mood[0]);
+
+    int8_t extremes[COMPONENTS] = {127, -128, 0, 0, 0, 0, 0, 0, 0};
+    Cache::Key ke = cache.makeKey(0, extremes, COMPONENTS);
+    TEST_ASSERT_EQUAL(124, ke.mood[0]);
+    TEST_ASSERT_EQUAL(-124, ke.mood[1]);
+
+    Cache exact;
+    exact.configure(arena, sizeof(arena), 64, 0);
+    TEST_ASSERT_FALSE(Cache::sameKey(exact.makeKey(7, a, COMPONENTS), exact.makeKey(7, b, COMPONENTS)));
+    TEST_ASSERT_EQUAL(17, exact.makeKey(7, a, COMPONENTS).mood[0]);
+}
+
+void test_lru_and_budget(void) {
+    static uint8_t arena[1024 * 4];
+    Cache cache;
+    cache.configure(arena, 3500, 1024, 3);          // 3 entries fit
+    TEST_ASSERT_EQUAL(3, cache.slots());
+
+    int8_t mood[COMPONENTS] = {};
+    Cache::Key k[4];
+    for (int f = 0; f < 4; f++) k[f] = cache.makeKey((uint32_t)f, mood, COMPONENTS);
+
+    for (int f = 0; f < 3; f++) {
+        TEST_ASSERT_TRUE(cache.find(k[f]) == nullptr);
+        uint8_t* slot = cache.insert(k[f]);
+        TEST_ASSERT_NOT_NULL(slot);
+        memset(slot, 'A' + f, 1024);
+    }
+    TEST_ASSERT_EQUAL(3, cache.used());
+    TEST_ASSERT_EQUAL(0, cache.evictions());
+
+    const uint8_t* hit = cache.find(k[0]);          // 0 becomes most recent
+    TEST_ASSERT_NOT_NULL(hit);
+    TEST_ASSERT_EQUAL('A', hit[0]);
+    memset(cache.insert(k[3]), 'D', 1024);          // Evicts 1
+    TEST_ASSERT_EQUAL(1, cache.evictions());
+    TEST_ASSERT_TRUE(cache.find(k[1]) == nullptr);
+    TEST_ASSERT_EQUAL('A', cache.find(k[0])[0]);
+    TEST_ASSERT_EQUAL('C', cache.find(k[2])[0]);
+    TEST_ASSERT_EQUAL('D', cache.find(k[3])[1023]);
+
+    TEST_ASSERT_EQUAL(8, cache.lookups());
+    TEST_ASSERT_EQUAL(4, cache.hits());
+    TEST_ASSERT_EQUAL(4, cache.misses());
+    TEST_ASSERT_EQUAL(50, cache.hitRate());
+    TEST_ASSERT_EQUAL(4 * 1024, (int)cache.bytesSaved());
+
+    cache.invalidateFrame(2);
+    TEST_ASSERT_TRUE(cache.find(k[2]) == nullptr);
+    TEST_ASSERT_EQUAL(2, cache.used());
+
+    Cache none;
+    none.configure(arena, 1000, 1024, 3);           // Budget below one entry
+    TEST_ASSERT_EQUAL(0, none.slots());
+    TEST_ASSERT_TRUE(none.insert(k[0]) == nullptr);
+
+    Cache capped;
+    capped.configure(arena, 1u << 30, 16, 3);       // More than MAX_SLOTS fit
+    TEST_ASSERT_EQUAL(32, capped.slots());
+}
+
+struct ReplayResult {
+    uint32_t changes;
+    uint32_t retints;
+    uint32_t hit_rate;
+    uint32_t evictions;
+    double mb_saved;
+    double ms_cached;
+    double ms_retint;
+    uint32_t mismatches;
+};
+
+/**
+ * 3 minutes at 20 fps: blink loop every 4 s while the published mood
+ * (goblin_mood: 4-unit grid, hysteresis) steps every 1-3 s between nearby
+ * states, including one-step wobbles of a single component
+ */
+static ReplayResult replay(uint32_t budget_frames, const std::vector<uint16_t>& source,
+                           std::vector<uint16_t>& arena, bool check)
+{
+    static const int STATE_COUNT = 6;
+    static const int8_t STATES[STATE_COUNT][COMPONENTS] = {
+        {0, 0, 12, 0, 20, 8, 0, 16, 4},         // Content, curious
+        {0, 0, 12, 0, 24, 8, 0, 16, 4},         // Curiosity wobble
+        {0, 0, 12, 0, 36, 8, 0, 16, 12},        // More curious
+        {0, 0, 24, 0, 28, 16, 0, 20, 16},       // Pleased
+        {8, 12, 4, 0, 24, 0, 8, 8, 8},          // Wary
+        {0, 0, 12, 4, 12, 8, 0, 24, 0},         // Settled
+    };
+    Cache cache;
+    cache.configure((uint8_t*)arena.data(), budget_frames * FRAME_BYTES, FRAME_BYTES, 3);
+    std::vector<uint16_t> front(PIXELS), fresh(PIXELS);
+
+    ReplayResult res = {};
+    srand(7);
+    int state = 0;
+    uint32_t next_publish = 40;
+    int8_t shown_mood[COMPONENTS] = {};
+    uint32_t shown_frame = 0xFFFFFFFF;
+    Cache::Key shown_key = {};
+    bool shown_valid = false;
+
+    for (uint32_t tick = 0; tick < 180 * 20; tick++) {
+        if (tick == next_publish) {
+            int step = 1 + rand() % 2;
+            state = (rand() % 2) ? (state + step) % STATE_COUNT : (state + STATE_COUNT - step) % STATE_COUNT;
+            next_publish = tick + 20 + rand() % 41;
+        }
+        const int8_t* mood = STATES[state];
+        uint32_t frame = (tick % 80) < ANIM_FRAMES * 2 ? (tick % 80) / 2 : 0;   // Blink
+        const uint16_t* src = source.data() + frame * PIXELS;
+
+        // Previous behaviour: retint whenever frame or mood changed
+        bool changed = frame != shown_frame || memcmp(mood, shown_mood, sizeof(shown_mood)) != 0;
+        if (changed) {
+            res.changes++;
+            uint64_t t0 = host_bench::nowNs();
+            tint(front.data(), src, mood);
+            res.ms_retint += (host_bench::nowNs() - t0) * 1e-6;
+            shown_frame = frame;
+            memcpy(shown_mood, mood, sizeof(shown_mood));
+        }
+
+        // goblin_eye: key on the snapped mood, copy from the cache on a hit
+        uint64_t t0 = host_bench::nowNs();
+        Cache::Key key = cache.makeKey(frame, mood, COMPONENTS);
+        bool same = shown_valid && Cache::sameKey(key, shown_key);
+        const uint8_t* tinted = nullptr;
+        if (!same) {
+            tinted = cache.find(key);
+            if (!tinted) {
+                uint8_t* slot = cache.insert(key);
+                tint((uint16_t*)slot, src, key.mood);
+                res.retints++;
+                tinted = slot;
+            }
+            memcpy(front.data(), tinted, FRAME_BYTES);
+            shown_key = key;
+            shown_valid = true;
+        }
+        res.ms_cached += (host_bench::nowNs() - t0) * 1e-6;
+
+        if (check && !same && tick % 7 == 0) {
+            tint(fresh.data(), src, key.mood);
+            if (memcmp(fresh.data(), tinted, FRAME_BYTES) != 0) res.mismatches++;
+        }
+    }
+    res.hit_rate = cache.hitRate();
+    res.evictions = cache.evictions();
+    res.mb_saved = cache.bytesSaved() / (1024.0 * 1024.0);
+    return res;
+}
+
+void test_trace_replay(void) {
+    host_bench::ensureOutputDir();
+    FILE* csv = fopen("test_output/mood_tint_cache.csv", "w");
+    TEST_ASSERT_NOT_NULL(csv);
+    fprintf(csv, "budget_frames,hit_rate,retints,evictions,mb_saved,ms_cached,ms_retint\n");
+
+    std::vector<uint16_t> source(PIXELS * ANIM_FRAMES);
+    static const int LIDS[ANIM_FRAMES] = {0, 40, 90, 120};
+    for (int f = 0; f < ANIM_FRAMES; f++) drawEye(source.data() + f * PIXELS, LIDS[f]);
+    std::vector<uint16_t> arena(PIXELS * 32);
+
+    static const uint32_t BUDGETS[] = {2, 4, 8, 12, 24};
+    ReplayResult at12 = {}, at24 = {};
+    for (uint32_t budget : BUDGETS) {
+        ReplayResult r = replay(budget, source, arena, budget == 24);
+        printf("[REPLAY] %2u frames (%5.2f MB): %u changes, %u retints, %3u%% hits, %u evictions, "
+               "%.0f MB not retinted, %.1f ms vs %.1f ms retinting\n",
+               budget, budget * FRAME_BYTES / (1024.0 * 1024.0), r.changes, r.retints, r.hit_rate,
+               r.evictions, r.mb_saved, r.ms_cached, r.ms_retint);
+        fprintf(csv, "%u,%u,%u,%u,%.1f,%.2f,%.2f\n", budget, r.hit_rate, r.retints, r.evictions,
+                r.mb_saved, r.ms_cached, r.ms_retint);
+        if (budget == 12) at12 = r;
+        if (budget == 24) at24 = r;
+    }
+    fclose(csv);
+
+    // goblin_eye's budget holds the blink loop under every recent mood
+    TEST_ASSERT_EQUAL(0, at24.mismatches);
+    TEST_ASSERT_TRUE(at24.hit_rate >= 80);
+    TEST_ASSERT_TRUE(at24.retints * 5 < at24.changes);
+    TEST_ASSERT_TRUE(at24.ms_cached * 3 < at24.ms_retint);
+    TEST_ASSERT_TRUE(at12.retints < at12.changes);
+}
+
+void test_lookup_cost(void) {
+    static uint8_t arena[32 * 64];
+    Cache cache;
+    cache.configure(arena, sizeof(arena), 64, 3);
+    int8_t mood[COMPONENTS] = {};
+    for (int f = 0; f < 32; f++) cache.insert(cache.makeKey((uint32_t)f, mood, COMPONENTS));
+
+    host_bench::CostStats cost;
+    uint32_t hits = 0;
+    for (int lap = 0; lap < 2000; lap++) {
+        mood[4] = (int8_t)(lap & 7);
+        uint64_t t0 = host_bench::nowNs();
+        Cache::Key key = cache.makeKey((uint32_t)(lap & 31), mood, COMPONENTS);
+        hits += cache.find(key) != nullptr ? 1 : 0;
+        cost.add(host_bench::nowNs() - t0);
+    }
+    cost.print("makeKey + find, 32 slots", 1e9 / 20);
+    TEST_ASSERT_EQUAL(2000, hits);
+    TEST_ASSERT_TRUE(cost.meanNs() < 2000.0);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_keys);
+    RUN_TEST(test_lru_and_budget);
+    RUN_TEST(test_trace_replay);
+    RUN_TEST(test_lookup_cost);
+    return UNITY_END();
+}
@@ -0,0 +1,239 @@
+/**
+ * @file test_main.cpp
+ * @brief Synchronized minimum-jerk neck trajectories (MinJerkTrajectory)
+ *
+ * Setpoints are sampled tick by tick exactly as the neck component streams
+ * them; velocity and acceleration are recovered by finite differences.
+ *
+ * - Coordinated arrival: pan / tilt / roll with very different distances
+ *   all reach their targets on the same tick, exactly, and the slowest
+ *   axis sets the duration
+ * - Profile: from rest the path is 10s^3 - 15s^4 + 6s^5 (half way at
+ *   half time, peak velocity 1.875 D/T), within the axis limits
+ * - Retarget mid-motion: no step in position or velocity, and the
+ *   tick-to-tick acceleration change stays within what the jerk of a
+ *   normal move produces
+ * - GoblinHeadNeckMotor: 30 Hz act() catches up on 100 Hz ticks, angles
+ *   and stepper targets settle on the pose
+ * - Cost: tick() for 3 axes and moveTo()
+ *
+ * Outputs for inspection (test_output/):
+ *   neck_trajectory.csv - t, pan, tilt, roll (retarget at 0.25 s)
+ *
+ * Run: pio test -e host_test -f test_host_neck_trajectory
+ */
+
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "config/components/templates/MinJerkTrajectory.hpp"
+#include "config/components/templates/GoblinHeadNeckMotor.hpp"
+#include "../host_support/host_bench.hpp"
+
+static const uint32_t HZ = 1000;    // Fine tick for clean differences
+
+struct Sample { double p[3]; };
+
+static void configureNeck(MinJerkTrajectory<3>& t, uint32_t hz) {
+    t.configure(hz);
+    t.setLimits(0, 240.0f, 1500.0f);
+    t.setLimits(1, 180.0f, 1200.0f);
+    t.setLimits(2, 120.0f, 900.0f);
+}
+
+static std::vector<Sample> run(MinJerkTrajectory<3>& t, uint32_t max_ticks = 100000) {
+    std::vector<Sample> out;
+    Sample s;
+    for (int i = 0; i < 3; i++) s.p[i] = t.positionQ16(i) / 65536.0;
+    out.push_back(s);
+    while (t.isActive() && out.size() < max_ticks) {
+        t.tick();
+        for (int i = 0; i < 3; i++) s.p[i] = t.positionQ16(i) / 65536.0;
+        out.push_back(s);
+    }
+    return out;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_coordinated_arrival(void) {
+    MinJerkTrajectory<3> t;
+    configureNeck(t, HZ);
+    const float target[3] = {50.0f, -12.0f, 4.0f};
+    float T = t.moveTo(target);
+    std::vector<Sample> s = run(t);
+
+    // Pan alone sets the pace: 50 deg under 240 deg/s and 1500 deg/s^2
+    float t_pan = fmaxf(1.875f * 50.0f / 240.0f, sqrtf(5.774f * 50.0f / 1500.0f));
+    printf("[SYNC] planned %.3f s (pan needs %.3f), %zu ticks\n", T, t_pan, s.size() - 1);
+    TEST_ASSERT_FLOAT_WITHIN(2.0f / HZ, t_pan, T);
+
+    // Every axis is still short of its target 50 ms before the end,
+    // and exactly on it at the end
+    size_t n = s.size();
+    for (int i = 0; i < 3; i++) {
+        float d = fabsf(target[i]);
+        TEST_ASSERT_TRUE(fabs(s[n - 1].p[i] - target[i]) < 1e-4);
+        TEST_ASSERT_TRUE(fabs(s[n - 1 - HZ / 20].p[i] - target[i]) > 1e-4 * d);
+        // Fraction covered is the same on every axis at every tick
+        for (size_t k = 0; k < n; k += 17) {
+            float frac0 = (float)(s[k].p[0] / target[0]);
+            float frac = (float)(s[k].p[i] / target[i]);
+            TEST_ASSERT_FLOAT_WITHIN(2e-4f, frac0, frac);
+        }
+    }
+}
+
+void test_min_jerk_profile_and_limits(void) {
+    MinJerkTrajectory<3> t;
+    configureNeck(t, HZ);
+    const float target[3] = {-40.0f, 30.0f, 20.0f};
+    float T = t.moveTo(target, 0.8f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.8f, T);
+    std::vector<Sample> s = run(t);
+    size_t n = s.size() - 1;
+
+    const float vlim[3] = {240.0f, 180.0f, 120.0f};
+    const float alim[3] = {1500.0f, 1200.0f, 900.0f};
+    for (int i = 0; i < 3; i++) {
+        float D = target[i];
+        // Half way at half time
+        TEST_ASSERT_FLOAT_WITHIN(fabsf(D) * 1e-3f, D * 0.5f, (float)s[n / 2].p[i]);
+        // Classic shape at a quarter: 10/64 - 15/256 + 6/1024
+        float q = 10.0f / 64 - 15.0f / 256 + 6.0f / 1024;
+        TEST_ASSERT_FLOAT_WITHIN(fabsf(D) * 1e-3f, D * q, (float)s[n / 4].p[i]);
+
+        float vpk = 0.0f, apk = 0.0f;
+        for (size_t k = 1; k + 1 < s.size(); k++) {
+            float v = (float)((s[k + 1].p[i] - s[k - 1].p[i]) * HZ * 0.5);
+            float a = (float)((s[k + 1].p[i] - 2.0 * s[k].p[i] + s[k - 1].p[i]) * HZ * HZ);
+            vpk = fmaxf(vpk, fabsf(v));
+            apk = fmaxf(apk, fabsf(a));
+        }
+        printf("[PROFILE] axis %d  v %.1f (1.875D/T %.1f)  a %.0f (5.774D/T^2 %.0f)\n",
+               i, vpk, 1.875f * fabsf(D) / T, apk, 5.774f * fabsf(D) / (T * T));
+        TEST_ASSERT_FLOAT_WITHIN(1.875f * fabsf(D) / T * 0.01f, 1.875f * fabsf(D) / T, vpk);
+        TEST_ASSERT_TRUE(vpk <= vlim[i]);
+        // One Q16 LSB in a second difference at 1 kHz is ~15 deg/s^2
+        TEST_ASSERT_FLOAT_WITHIN(5.774f * fabsf(D) / (T * T) * 0.02f + 50.0f, 5.774f * fabsf(D) / (T * T), apk);
+        TEST_ASSERT_TRUE(apk <= alim[i]);
+    }
+}
+
+void test_retarget_is_smooth(void) {
+    MinJerkTrajectory<3> t;
+    configureNeck(t, HZ);
+    const float first[3] = {45.0f, 0.0f, -10.0f};
+    const float second[3] = {-20.0f, 25.0f, 15.0f};
+    t.moveTo(first, 0.5f);
+
+    std::vector<Sample> s;
+    Sample x;
+    const size_t switch_at = HZ / 4;
+    for (int i = 0; i < 3; i++) x.p[i] = t.positionQ16(i) / 65536.0;
+    s.push_back(x);
+    while (t.isActive() || s.size() <= switch_at) {
+        if (s.size() == switch_at) t.moveTo(second, 0.6f);
+        t.tick();
+        for (int i = 0; i < 3; i++) x.p[i] = t.positionQ16(i) / 65536.0;
+        s.push_back(x);
+    }
+
+    host_bench::ensureOutputDir();
+    FILE* f = fopen("test_output/neck_trajectory.csv", "w");
+    if (f) {
+        fprintf(f, "t,pan,tilt,roll\n");
+        for (size_t k = 0; k < s.size(); k++)
+            fprintf(f, "%.4f,%.4f,%.4f,%.4f\n", (double)k / HZ, s[k].p[0], s[k].p[1], s[k].p[2]);
+        fclose(f);
+    }
+
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, second[i], (float)s.back().p[i]);
+        // Change in acceleration per tick (jerk x dt): across the switch it
+        // must be no bigger than the worst seen anywhere else
+        float worst_elsewhere = 0.0f, at_switch = 0.0f;
+        for (size_t k = 2; k + 1 < s.size(); k++) {
+            float a1 = (float)((s[k + 1].p[i] - 2.0 * s[k].p[i] + s[k - 1].p[i]) * HZ * HZ);
+            float a0 = (float)((s[k].p[i] - 2.0 * s[k - 1].p[i] + s[k - 2].p[i]) * HZ * HZ);
+            float da = fabsf(a1 - a0);
+            if (k >= switch_at - 2 && k <= switch_at + 2) at_switch = fmaxf(at_switch, da);
+            else worst_elsewhere = fmaxf(worst_elsewhere, da);
+        }
+        // Velocity just before and after the switch
+        float v_before = (float)((s[switch_at].p[i] - s[switch_at - 1].p[i]) * HZ);
+        float v_after = (float)((s[switch_at + 1].p[i] - s[switch_at].p[i]) * HZ);
+        printf("[RETARGET] axis %d  da/tick at switch %.1f, elsewhere %.1f;  v %.2f -> %.2f\n",
+               i, at_switch, worst_elsewhere, v_before, v_after);
+        TEST_ASSERT_TRUE(at_switch <= worst_elsewhere * 1.05f + 1.0f);
+        TEST_ASSERT_FLOAT_WITHIN(2.0f, v_before, v_after);
+    }
+}
+
+void test_goblin_neck_integration(void) {
+    GoblinHeadNeckMotor neck;
+    TEST_ASSERT_TRUE(neck.init(38, 39, 41, 42, 44, 45));
+    neck.lookAtPose(GoblinHeadNeckMotor::RIGHT_TURN, 250);
+    const GoblinHeadNeckMotor::State& st = neck.getState();
+    TEST_ASSERT_TRUE(neck.isMoving());
+    printf("[NECK] RIGHT_TURN planned %lu ms\n", (unsigned long)st.motion_duration_ms);
+    TEST_ASSERT_TRUE(st.motion_duration_ms >= 250);
+
+    // act() at ~32 ms, as the goblin head loop runs it
+    uint32_t now = 1000;
+    uint32_t arrival = 0;
+    int16_t last_pan = 0;
+    bool monotonic = true;
+    for (int i = 0; i < 40; i++) {
+        neck.act(now);
+        if (st.pan_angle < last_pan) monotonic = false;
+        last_pan = st.pan_angle;
+        if (!neck.isMoving() && arrival == 0) arrival = now;
+        now += 32;
+    }
+    printf("[NECK] settled after %lu ms\n", (unsigned long)(arrival - 1000));
+    TEST_ASSERT_TRUE(monotonic);
+    TEST_ASSERT_FALSE(neck.isMoving());
+    TEST_ASSERT_TRUE(arrival - 1000 <= st.motion_duration_ms + 64);
+    TEST_ASSERT_EQUAL_INT16(45, st.pan_angle);
+    TEST_ASSERT_EQUAL_INT16(0, st.tilt_angle);
+    TEST_ASSERT_EQUAL_INT16(10, st.roll_angle);
+    TEST_ASSERT_EQUAL_INT32(25, neck.getPanController().getTarget());
+    TEST_ASSERT_EQUAL_INT32(6, neck.getRollController().getTarget());
+}
+
+void test_tick_cost(void) {
+    MinJerkTrajectory<3> t;
+    configureNeck(t, 100);
+    host_bench::CostStats tick_cost, plan_cost;
+    volatile uint32_t sink = 0;
+    for (int rep = 0; rep < 2000; rep++) {
+        float target[3] = {(float)(rep % 120 - 60), (float)(rep % 75 - 30), (float)(rep % 50 - 25)};
+        uint64_t t0 = host_bench::nowNs();
+        t.moveTo(target, 0.2f);
+        plan_cost.add(host_bench::nowNs() - t0);
+        for (int k = 0; k < 10 && t.isActive(); k++) {
+            t0 = host_bench::nowNs();
+            t.tick();
+            sink += (uint32_t)t.positionQ16(0);
+            tick_cost.add(host_bench::nowNs() - t0);
+        }
+    }
+    (void)sink;
+    tick_cost.print("tick() 3 axes", 10000000);
+    plan_cost.print("moveTo() 3 axes", 10000000);
+    TEST_ASSERT_TRUE(tick_cost.meanNs() < 2000.0);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_coordinated_arrival);
+    RUN_TEST(test_min_jerk_profile_and_limits);
+    RUN_TEST(test_retarget_is_smooth);
+    RUN_TEST(test_goblin_neck_integration);
+    RUN_TEST(test_tick_cost);
+    return UNITY_END();
+}
@@ -0,0 +1,291 @@
+/**
+ * @file test_main.cpp
+ * @brief PCA9685 register shadow and burst flush (Pca9685Shadow)
+ *
+ * Flushes run Pca9685Shadow::flush(), the loop pca9685_driver.src runs
+ * (plan, encode, write, re-mark on failure), with the I2C write going to a
+ * counting bus model that keeps a register file per chip.
+ *
+ * - Dirty tracking: rewriting a value marks nothing; power-on state is
+ *   full-off and clean
+ * - Run planning: neighbouring dirty channels form one run, single clean
+ *   gaps are merged, wider gaps split
+ * - Burst encoding: register address and ON/OFF byte order; after random
+ *   updates and flushes the chip registers always equal the shadow
+ * - Failed write: the run is re-queued and lands on the next flush
+ * - Before / after at 50 Hz with the controllers' own addresses: hand
+ *   (0x40, 5 servos) and both arms (0x41 / 0x42, 7 each) sharing one bus,
+ *   torso (0x40, 6) on its own board. One transaction per
+ *   pca9685_set_pwm() call versus shadowed burst flushes - transactions
+ *   and bus time per tick
+ *
+ * Outputs for inspection (test_output/):
+ *   pca9685_bus_load.csv - tick, legacy/burst transactions and bus us
+ *
+ * Run: pio test -e host_test -f test_host_pca9685_burst
+ */
+
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "config/components/templates/Pca9685Shadow.hpp"
+#include "../host_support/i2c_bus_model.hpp"
+#include "../host_support/host_bench.hpp"
+
+// Addresses from include/p32_hand_controller.hpp (PCA9685_ADDRESS),
+// include/p32_arm_controller.hpp (PCA9685_I2C_ADDRESS_LEFT / _RIGHT) and
+// include/p32_torso_controller.hpp (PCA9685_I2C_ADDRESS)
+static const uint8_t HAND_PCA9685 = 0x40;
+static const uint8_t ARM_LEFT_PCA9685 = 0x41;
+static const uint8_t ARM_RIGHT_PCA9685 = 0x42;
+static const uint8_t TORSO_PCA9685 = 0x40;
+
+static host_i2c::BusModel bus;
+
+// The driver's Pca9685ChipBus, with the I2C write going to a bus model
+struct ModelChipBus {
+    host_i2c::BusModel* model;
+    uint8_t address;
+
+    void lock() {}
+    void unlock() {}
+    bool write(const uint8_t* buf, uint8_t len) { return model->write(address, buf, len); }
+};
+
+// pca9685_flush(chip): the shipped per-chip flush
+static int flush(Pca9685Shadow& shadow, uint8_t address, host_i2c::BusModel& model = bus) {
+    uint8_t buf[Pca9685Shadow::MAX_BURST_BYTES];
+    ModelChipBus chip_bus = {&model, address};
+    return shadow.flush(chip_bus, buf).transactions;
+}
+
+// Old path: pca9685_set_pwm() wrote LEDn_ON_L..OFF_H straight away
+static void legacyWrite(host_i2c::BusModel& model, uint8_t address, uint8_t ch, uint16_t off_count) {
+    uint8_t buf[5] = {(uint8_t)(Pca9685Shadow::REG_LED0_ON_L + 4 * ch), 0, 0,
+                      (uint8_t)(off_count & 0xFF), (uint8_t)(off_count >> 8)};
+    model.write(address, buf, sizeof(buf));
+}
+
+static void assertChipMatches(const Pca9685Shadow& shadow, uint8_t address,
+                              const host_i2c::BusModel& model = bus) {
+    for (uint8_t ch = 0; ch < Pca9685Shadow::CHANNELS; ch++) {
+        const uint8_t* r = &model.regs[address][Pca9685Shadow::REG_LED0_ON_L + 4 * ch];
+        TEST_ASSERT_EQUAL_UINT16(shadow.onCount(ch), (uint16_t)(r[0] | (r[1] << 8)));
+        TEST_ASSERT_EQUAL_UINT16(shadow.offCount(ch), (uint16_t)(r[2] | (r[3] << 8)));
+    }
+}
+
+// 1000-2000 us at 50 Hz in PCA9685 counts, as the driver converts it
+static uint16_t usToCounts(float us) {
+    return (uint16_t)lroundf(us * 50.0f * 4096.0f / 1e6f);
+}
+
+void setUp(void) {
+    bus.clear();
+    srand(41);
+}
+
+void tearDown(void) {}
+
+void test_dirty_tracking(void) {
+    Pca9685Shadow s;
+    TEST_ASSERT_EQUAL_UINT16(0, s.dirtyMask());
+    TEST_ASSERT_TRUE(s.isFullOff(5));
+
+    TEST_ASSERT_TRUE(s.set(3, 307));
+    TEST_ASSERT_FALSE(s.set(3, 307));           // Same value: nothing to send
+    TEST_ASSERT_EQUAL_UINT16(1u << 3, s.dirtyMask());
+    TEST_ASSERT_FALSE(s.set(16, 100));          // Out of range ignored
+
+    TEST_ASSERT_EQUAL_INT(1, flush(s, 0x40));
+    TEST_ASSERT_EQUAL_UINT16(0, s.dirtyMask());
+    TEST_ASSERT_EQUAL_INT(0, flush(s, 0x40));   // Clean: no transaction
+    TEST_ASSERT_EQUAL_UINT32(1, bus.transactions);
+
+    TEST_ASSERT_TRUE(s.setFullOff(3));
+    TEST_ASSERT_TRUE(s.isFullOff(3));
+}
+
+void test_run_planning(void) {
+    Pca9685Shadow s;
+    s.configure(1);
+    const uint8_t dirty[] = {0, 1, 2, 4, 8, 9, 15};
+    for (uint8_t ch : dirty) s.set(ch, 300 + ch);
+
+    Pca9685Shadow::Run runs[Pca9685Shadow::MAX_RUNS];
+    uint8_t n = s.plan(runs);
+    TEST_ASSERT_EQUAL_UINT8(3, n);
+    TEST_ASSERT_EQUAL_UINT8(0, runs[0].first);  // 0-2 and 4 merged over 3
+    TEST_ASSERT_EQUAL_UINT8(5, runs[0].count);
+    TEST_ASSERT_EQUAL_UINT8(8, runs[1].first);
+    TEST_ASSERT_EQUAL_UINT8(2, runs[1].count);
+    TEST_ASSERT_EQUAL_UINT8(15, runs[2].first);
+    TEST_ASSERT_EQUAL_UINT8(1, runs[2].count);
+
+    s.configure(0);
+    for (uint8_t ch : dirty) s.set(ch, 300 + ch);
+    TEST_ASSERT_EQUAL_UINT8(4, s.plan(runs));   // No merging: 0-2, 4, 8-9, 15
+
+    // Every other channel: worst case still fits MAX_RUNS
+    s.configure(0);
+    for (uint8_t ch = 0; ch < 16; ch += 2) s.set(ch, 400);
+    TEST_ASSERT_EQUAL_UINT8(8, s.plan(runs));
+    s.configure(1);
+    for (uint8_t ch = 0; ch < 16; ch += 2) s.set(ch, 400);
+    TEST_ASSERT_EQUAL_UINT8(1, s.plan(runs));
+}
+
+void test_burst_encoding(void) {
+    Pca9685Shadow s;
+    s.set(2, 0x0123, 0x0010);
+    s.set(3, 0x0FFF);
+    Pca9685Shadow::Run runs[Pca9685Shadow::MAX_RUNS];
+    TEST_ASSERT_EQUAL_UINT8(1, s.plan(runs));
+    uint8_t buf[Pca9685Shadow::MAX_BURST_BYTES];
+    uint8_t len = s.encode(runs[0], buf);
+    TEST_ASSERT_EQUAL_UINT8(9, len);
+    TEST_ASSERT_EQUAL_UINT8(0x06 + 8, buf[0]);  // LED2_ON_L
+    TEST_ASSERT_EQUAL_UINT8(0x10, buf[1]);
+    TEST_ASSERT_EQUAL_UINT8(0x00, buf[2]);
+    TEST_ASSERT_EQUAL_UINT8(0x23, buf[3]);
+    TEST_ASSERT_EQUAL_UINT8(0x01, buf[4]);
+    TEST_ASSERT_EQUAL_UINT8(0xFF, buf[7]);
+    TEST_ASSERT_EQUAL_UINT8(0x0F, buf[8]);
+    TEST_ASSERT_EQUAL_UINT16(0, s.dirtyMask());
+
+    // Random traffic: the chip always ends up holding the shadow
+    Pca9685Shadow chip;
+    chip.markDirty((uint16_t)0xFFFF);           // Driver start-up: sync all
+    flush(chip, 0x41);
+    assertChipMatches(chip, 0x41);
+    for (int tick = 0; tick < 500; tick++) {
+        int changes = rand() % 6;
+        for (int c = 0; c < changes; c++) {
+            uint8_t ch = rand() % 16;
+            if (rand() % 10 == 0) chip.setFullOff(ch);
+            else chip.set(ch, 205 + rand() % 205);
+        }
+        flush(chip, 0x41);
+        assertChipMatches(chip, 0x41);
+    }
+}
+
+void test_failed_write_requeues(void) {
+    Pca9685Shadow s;
+    s.markDirty((uint16_t)0xFFFF);
+    flush(s, 0x40);
+    s.set(0, 300);
+    s.set(1, 310);
+    bus.fail_next = 1;
+    uint8_t buf[Pca9685Shadow::MAX_BURST_BYTES];
+    ModelChipBus chip_bus = {&bus, 0x40};
+    Pca9685Shadow::FlushResult r = s.flush(chip_bus, buf);
+    TEST_ASSERT_EQUAL_UINT8(1, r.transactions);
+    TEST_ASSERT_EQUAL_UINT8(1, r.errors);
+    TEST_ASSERT_EQUAL_UINT16(0x0003, s.dirtyMask());
+    flush(s, 0x40);
+    TEST_ASSERT_EQUAL_UINT16(0, s.dirtyMask());
+    assertChipMatches(s, 0x40);
+}
+
+void test_bus_load_before_after(void) {
+    struct Controller { const char* name; uint8_t address; uint8_t servos; uint8_t board; };
+    const Controller ctl[4] = {
+        {"arm_left", ARM_LEFT_PCA9685, 7, 0},
+        {"hand", HAND_PCA9685, 5, 0},
+        {"arm_right", ARM_RIGHT_PCA9685, 7, 0},
+        {"torso", TORSO_PCA9685, 6, 1},
+    };
+    const int CHIPS = 4;
+    const int TICKS = 500;                      // 10 s at 50 Hz
+    static host_i2c::BusModel torso_bus;        // Torso board has its own bus
+    torso_bus.clear();
+    host_i2c::BusModel* boards[2] = {&bus, &torso_bus};
+
+    // Chips sharing a bus need distinct addresses
+    for (int a = 0; a < CHIPS; a++)
+        for (int b = a + 1; b < CHIPS; b++)
+            if (ctl[a].board == ctl[b].board) TEST_ASSERT_TRUE(ctl[a].address != ctl[b].address);
+
+    host_bench::ensureOutputDir();
+    FILE* csv = fopen("test_output/pca9685_bus_load.csv", "w");
+    if (csv) fprintf(csv, "tick,legacy_txn,legacy_us,burst_txn,burst_us\n");
+
+    // pca9685_init(): first flush syncs all 16 channels of each chip
+    Pca9685Shadow shadow[CHIPS];
+    for (int c = 0; c < CHIPS; c++) {
+        shadow[c].markDirty((uint16_t)0xFFFF);
+        flush(shadow[c], ctl[c].address, *boards[ctl[c].board]);
+    }
+    bus.resetCounters();
+    torso_bus.resetCounters();
+
+    uint32_t legacy_txn = 0, burst_txn = 0;
+    double legacy_us = 0.0, burst_us = 0.0;
+    uint32_t worst_burst_txn = 0;
+    uint32_t servos = 0;
+    for (int c = 0; c < CHIPS; c++) servos += ctl[c].servos;
+
+    auto txns = [&]() { return bus.transactions + torso_bus.transactions; };
+    auto busUs = [&]() { return bus.bus_us + torso_bus.bus_us; };
+
+    for (int t = 0; t < TICKS; t++) {
+        float time = t / 50.0f;
+        uint32_t lt0 = txns(); double lu0 = busUs();
+
+        // Servo targets: arms moving for the first half, hand gripping now and
+        // then, torso breathing slowly (small changes, often identical counts)
+        uint16_t target[CHIPS][7];
+        for (int c = 0; c < CHIPS; c++) {
+            for (int i = 0; i < ctl[c].servos; i++) {
+                float us = 1500.0f;
+                if (ctl[c].servos == 7 && t < TICKS / 2) us += 300.0f * sinf(time * 2.0f + i + c);
+                if (c == 1 && (t / 100) % 2) us += 400.0f * sinf(time * 4.0f + i);
+                if (c == 3) us += 20.0f * sinf(time * 0.5f + i);
+                target[c][i] = usToCounts(us);
+            }
+        }
+
+        // Legacy: every set_pwm() call is a transaction
+        for (int c = 0; c < CHIPS; c++)
+            for (int i = 0; i < ctl[c].servos; i++)
+                legacyWrite(*boards[ctl[c].board], ctl[c].address, i, target[c][i]);
+        uint32_t lt = txns() - lt0; double lu = busUs() - lu0;
+
+        // Shadowed: stage everything, one flush per chip
+        uint32_t bt0 = txns(); double bu0 = busUs();
+        for (int c = 0; c < CHIPS; c++) {
+            for (int i = 0; i < ctl[c].servos; i++) shadow[c].set(i, target[c][i]);
+            flush(shadow[c], ctl[c].address, *boards[ctl[c].board]);
+            assertChipMatches(shadow[c], ctl[c].address, *boards[ctl[c].board]);
+        }
+        uint32_t bt = txns() - bt0; double bu = busUs() - bu0;
+
+        legacy_txn += lt; legacy_us += lu;
+        burst_txn += bt; burst_us += bu;
+        if (bt > worst_burst_txn) worst_burst_txn = bt;
+        if (csv) fprintf(csv, "%d,%u,%.1f,%u,%.1f\n", t, lt, lu, bt, bu);
+    }
+    if (csv) fclose(csv);
+
+    printf("[BUS] legacy: %.1f transactions/tick, %.0f us/tick\n",
+           (double)legacy_txn / TICKS, legacy_us / TICKS);
+    printf("[BUS] burst:  %.2f transactions/tick (worst %u), %.0f us/tick\n",
+           (double)burst_txn / TICKS, worst_burst_txn, burst_us / TICKS);
+
+    TEST_ASSERT_EQUAL_UINT32(servos * TICKS, legacy_txn);
+    TEST_ASSERT_TRUE(worst_burst_txn <= (uint32_t)CHIPS);  // At most one burst per chip
+    TEST_ASSERT_TRUE(burst_us * 4.0 < legacy_us);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_dirty_tracking);
+    RUN_TEST(test_run_planning);
+    RUN_TEST(test_burst_encoding);
+    RUN_TEST(test_failed_write_requeues);
+    RUN_TEST(test_bus_load_before_after);
+    return UNITY_END();
+}
@@ -0,0 +1,378 @@
+/**
+ * @file test_main.cpp
+ * @brief Battery estimation and power governor for flying_dragon_power_system
+ *
+ * - Oversampling: a noisy 12-bit ADC reading of a fixed pin voltage,
+ *   single samples vs the 100-sample means AdcOversampler hands back
+ *   every 10 ms step
+ * - SoC tracking: a simulated 4S pack (OCV curve, internal resistance the
+ *   estimator gets slightly wrong, current sensor offset, ESC ripple) is
+ *   flown through hover / burst / perched phases starting part charged;
+ *   estimated SoC and mAh must follow the truth
+ * - Governor: noisy SoC around the thresholds must not chatter, and
+ *   climbing back needs the hysteresis margin held for the dwell time
+ * - Dispatch load: the generated app_main loop (hitCount x period_stretch
+ *   for "powerStretch" entries) runs the dragon head's act table in
+ *   simulated time at each power level. Displays pace their own frames
+ *   from esp_timer (the loop is pass-counted, so a stretched hitCount
+ *   alone would just let the loop spin faster) and render every
+ *   frame_divisor-th frame. Frame rate, stretched-entry call rate, busy
+ *   fraction and estimated current are reported per level, then a perched
+ *   discharge is run with and without the governor
+ *
+ * Outputs for inspection (test_output/):
+ *   power_soc_tracking.csv   - t, true/estimated SoC, pack V, current, level
+ *   power_dispatch_load.csv  - level, frames/s, busy %, estimated mA
+ *
+ * Run: pio test -e host_test -f test_host_power_governor
+ */
+
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+#include "config/components/templates/BatteryEstimator.hpp"
+#include "config/components/templates/PowerGovernor.hpp"
+#include "../host_support/host_bench.hpp"
+
+static const float STEP_S = 0.01f;              // POWER_STEP_US
+static const int CELLS = 4;
+static const float CAPACITY_MAH = 5000.0f;
+
+/** True pack: the estimator's OCV curve shifted 10 mV, and 35 mOhm vs the configured 30 */
+struct SimPack {
+    float soc;
+    float consumed_mah = 0.0f;
+
+    explicit SimPack(float start_soc) : soc(start_soc) {}
+
+    static float cellOcv(float s) {
+        static const float OCV[BatteryEstimator::OCV_POINTS] = {
+            3.27f, 3.69f, 3.73f, 3.77f, 3.80f, 3.84f, 3.87f, 3.95f, 4.02f, 4.11f, 4.20f
+        };
+        if (s <= 0.0f) return OCV[0];
+        if (s >= 1.0f) return OCV[BatteryEstimator::OCV_POINTS - 1];
+        float x = s * (BatteryEstimator::OCV_POINTS - 1);
+        int i = (int)x;
+        return OCV[i] + (x - i) * (OCV[i + 1] - OCV[i]) + 0.010f;
+    }
+
+    /** Draw current for dt, return the loaded terminal voltage */
+    float step(float amps, float dt) {
+        float mah = amps * dt * (1000.0f / 3600.0f);
+        consumed_mah += mah;
+        soc -= mah / CAPACITY_MAH;
+        return CELLS * cellOcv(soc) - amps * 0.035f;
+    }
+};
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// ---------------------------------------------------------------------------
+
+void test_oversampling_resolution(void) {
+    std::mt19937 rng(7);
+    std::normal_distribution<float> noise(0.0f, 2.0f);     // ESP32 ADC: ~2 LSB rms at 11 dB
+    const float true_raw = 2.3456f / 3.3f * 4095.0f;
+
+    AdcOversampler over;
+    double single_sq = 0.0, mean_sq = 0.0;
+    const int STEPS = 500, N = 100;
+    for (int s = 0; s < STEPS; s++) {
+        for (int k = 0; k < N; k++) {
+            float r = roundf(true_raw + noise(rng));
+            if (k == 0) single_sq += (r - true_raw) * (r - true_raw);
+            over.add((uint16_t)r);
+        }
+        TEST_ASSERT_EQUAL_UINT32(N, over.count());
+        float m = over.take();
+        mean_sq += (m - true_raw) * (m - true_raw);
+    }
+    TEST_ASSERT_TRUE(std::isnan(over.take()));
+
+    float single_rms = sqrtf((float)(single_sq / STEPS));
+    float mean_rms = sqrtf((float)(mean_sq / STEPS));
+    float extra_bits = log2f(single_rms / mean_rms);
+    printf("[ADC] single sample %.2f LSB rms, 100-sample mean %.3f LSB rms (+%.1f bits)\n",
+           single_rms, mean_rms, extra_bits);
+    TEST_ASSERT_TRUE(mean_rms < 0.35f);
+    TEST_ASSERT_TRUE(extra_bits > 2.5f);
+}
+
+// ---------------------------------------------------------------------------
+
+/** Flight profile: power-on at rest, hover with bursts, perched, second flight */
+static float profileAmps(float t) {
+    if (t < 5.0f) return 1.2f;
+    if (t < 300.0f) {
+        float burst = fmodf(t, 30.0f) < 4.0f ? 18.0f : 0.0f;
+        return 24.0f + burst;
+    }
+    if (t < 420.0f) return 1.2f;        // Perched
+    return 26.0f;                       // Second flight
+}
+
+void test_soc_tracks_discharge(void) {
+    host_bench::ensureOutputDir();
+    FILE* csv = fopen("test_output/power_soc_tracking.csv", "w");
+    TEST_ASSERT_NOT_NULL(csv);
+    fprintf(csv, "t_s,true_soc,est_soc,pack_v,current_a,level\n");
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> ripple(-3.0f, 3.0f);    // ESC ripple left after decimation
+    std::normal_distribution<float> v_noise(0.0f, 0.003f);        // Oversampled pack volts
+
+    SimPack pack(0.80f);
+    BatteryEstimator est;
+    est.configure(CELLS, CAPACITY_MAH, 0.030f);
+    PowerGovernor gov;
+    host_bench::CostStats cost;
+
+    float worst_err = 0.0f, worst_loaded_err = 0.0f;
+    int level_changes = 0;
+    float t = 0.0f;
+    while (pack.soc > 0.08f) {
+        float amps = profileAmps(t) + ripple(rng);
+        float v = pack.step(amps, STEP_S);
+        float sensed_a = amps + 0.2f;                                 // Current sensor offset
+        uint64_t t0 = host_bench::nowNs();
+        est.update(v + v_noise(rng), sensed_a, STEP_S);
+        gov.update(est.soc(), STEP_S);
+        cost.add(host_bench::nowNs() - t0);
+        if (gov.changed()) level_changes++;
+
+        float err = fabsf(est.soc() - pack.soc);
+        if (err > worst_err) worst_err = err;
+        if (amps > 10.0f && err > worst_loaded_err) worst_loaded_err = err;
+        if (((int)(t / STEP_S)) % 100 == 0) {
+            fprintf(csv, "%.1f,%.4f,%.4f,%.3f,%.2f,%d\n", t, pack.soc, est.soc(), est.voltage(), est.current(), gov.level());
+        }
+        t += STEP_S;
+    }
+    fclose(csv);
+
+    float mah_err = fabsf(est.consumedMah() - pack.consumed_mah) / pack.consumed_mah;
+    printf("[SOC] %.0f s from 80%% to 8%%: worst SoC error %.1f%% (%.1f%% under load), mAh error %.2f%%, %d level changes, ends %s\n",
+           t, worst_err * 100.0f, worst_loaded_err * 100.0f, mah_err * 100.0f, level_changes,
+           PowerGovernor::levelName(gov.level()));
+    cost.print("estimator + governor step", 10e6);
+
+    TEST_ASSERT_TRUE(worst_err < 0.05f);
+    TEST_ASSERT_TRUE(mah_err < 0.02f);
+    TEST_ASSERT_EQUAL_INT(PowerGovernor::LEVEL_CRITICAL, gov.level());
+    TEST_ASSERT_EQUAL_INT(3, level_changes);        // FULL -> ECO -> LOW -> CRITICAL, no chatter
+}
+
+void test_soc_seeds_from_ocv(void) {
+    // Part-charged pack at rest: first reading places SoC on the curve
+    BatteryEstimator est;
+    est.configure(CELLS, CAPACITY_MAH, 0.030f);
+    TEST_ASSERT_FALSE(est.valid());
+    est.update(NAN, 0.0f, STEP_S);
+    TEST_ASSERT_FALSE(est.valid());
+    est.update(CELLS * 3.84f, 0.3f, STEP_S);
+    TEST_ASSERT_TRUE(est.valid());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.50f, est.soc());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, BatteryEstimator::socFromCellOcv(3.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.0f, BatteryEstimator::socFromCellOcv(4.25f));
+}
+
+// ---------------------------------------------------------------------------
+
+void test_governor_hysteresis(void) {
+    std::mt19937 rng(3);
+    std::normal_distribution<float> noise(0.0f, 0.01f);
+    PowerGovernor gov;
+
+    // Hover at 50.5% +/- 1%: crosses ECO's entry many times, must switch once
+    int changes = 0;
+    for (int i = 0; i < 3000; i++) {
+        gov.update(0.505f + noise(rng), STEP_S);
+        if (gov.changed()) changes++;
+    }
+    TEST_ASSERT_EQUAL_INT(1, changes);
+    TEST_ASSERT_EQUAL_INT(PowerGovernor::LEVEL_ECO, gov.level());
+
+    // Straight to CRITICAL on a big drop
+    gov.update(0.05f, STEP_S);
+    TEST_ASSERT_EQUAL_INT(PowerGovernor::LEVEL_CRITICAL, gov.level());
+    TEST_ASSERT_EQUAL_INT(8, gov.policy().period_stretch);
+
+    // Charging: inside the margin nothing happens, above it one level per dwell
+    for (int i = 0; i < 1000; i++) gov.update(0.13f, STEP_S);
+    TEST_ASSERT_EQUAL_INT(PowerGovernor::LEVEL_CRITICAL, gov.level());
+    int steps = 0;
+    while (gov.level() == PowerGovernor::LEVEL_CRITICAL && steps < 2000) {
+        gov.update(0.16f, STEP_S);
+        steps++;
+    }
+    TEST_ASSERT_EQUAL_INT(PowerGovernor::LEVEL_LOW, gov.level());
+    TEST_ASSERT_INT_WITHIN(2, 500, steps);      // 5 s dwell
+    TEST_ASSERT_EQUAL_INT(4, gov.policy().period_stretch);
+    TEST_ASSERT_EQUAL_INT(40, gov.policy().display_pct);
+    TEST_ASSERT_EQUAL_INT(2, gov.policy().frame_divisor);
+
+    // A dip below the margin restarts the dwell
+    for (int i = 0; i < 400; i++) gov.update(0.31f, STEP_S);
+    gov.update(0.28f, STEP_S);
+    for (int i = 0; i < 400; i++) gov.update(0.31f, STEP_S);
+    TEST_ASSERT_EQUAL_INT(PowerGovernor::LEVEL_LOW, gov.level());
+    for (int i = 0; i < 101; i++) gov.update(0.31f, STEP_S);
+    TEST_ASSERT_EQUAL_INT(PowerGovernor::LEVEL_ECO, gov.level());
+
+    // NaN keeps the level
+    gov.update(NAN, STEP_S);
+    TEST_ASSERT_EQUAL_INT(PowerGovernor::LEVEL_ECO, gov.level());
+}
+
+// ---------------------------------------------------------------------------
+
+/**
+ * Dragon head act table as the generator emits it. Display entries pace
+ * themselves at 30 fps / frame_divisor and only poll the timer in between;
+ * render_us is the CPU side of one frame (the SPI DMA runs behind it).
+ * Costs and currents are estimates for an ESP32-S3 with three GC9A01s
+ */
+struct SimEntry {
+    const char* name;
+    uint32_t hit;
+    uint8_t stretch;
+    float paced_fps;        // 0: does its work on every call
+    uint32_t work_us;
+    float work_ma;          // Extra draw while working (SPI, LEDs)
+};
+
+static const SimEntry HEAD_TABLE[] = {
+    {"dragon_eye_left", 1, 1, 30.0f, 6000, 45.0f},
+    {"dragon_eye_right", 1, 1, 30.0f, 6000, 45.0f},
+    {"dragon_mouth", 1, 1, 30.0f, 6000, 45.0f},
+    {"dragon_speaker", 1, 0, 0.0f, 15, 20.0f},
+    {"dragon_nostril_left", 10, 1, 0.0f, 40, 10.0f},
+    {"dragon_nostril_right", 10, 1, 0.0f, 40, 10.0f},
+};
+static const size_t HEAD_ENTRIES = sizeof(HEAD_TABLE) / sizeof(HEAD_TABLE[0]);
+
+static const float BASE_MA = 95.0f;                 // CPU spinning the dispatch loop
+static const float BACKLIGHT_MA_PER_DISPLAY = 28.0f;
+static const uint32_t POLL_US = 2;                  // Table walk + "frame due?" check
+
+struct LoadResult {
+    float frames_per_s;     // dragon_eye_left frames rendered per second
+    float stretched_calls;  // dragon_nostril_left calls per second
+    float busy_pct;         // Time in real work (not polling)
+    float current_ma;
+};
+
+/** Run the generated loop for one simulated second at the given policy */
+static LoadResult runDispatch(const PowerGovernor::Policy& policy) {
+    uint64_t t_us = 0;
+    uint32_t loop = 0;
+    uint32_t work[HEAD_ENTRIES] = {};
+    uint32_t calls[HEAD_ENTRIES] = {};
+    double next_frame_us[HEAD_ENTRIES] = {};
+    uint64_t busy_us = 0;
+    double charge_ma_us = 0.0;
+    const uint32_t stretch = policy.period_stretch > 0U ? policy.period_stretch : 1U;
+
+    while (t_us < 1000000) {
+        for (size_t i = 0; i < HEAD_ENTRIES; i++) {
+            const SimEntry& e = HEAD_TABLE[i];
+            const uint32_t hit = e.stretch ? e.hit * stretch : e.hit;
+            t_us += POLL_US;
+            if (hit == 0U || (loop % hit) != 0U) continue;
+            calls[i]++;
+            if (e.paced_fps > 0.0f) {
+                if ((double)t_us < next_frame_us[i]) continue;
+                next_frame_us[i] += 1e6 * policy.frame_divisor / e.paced_fps;
+            }
+            work[i]++;
+            t_us += e.work_us;
+            busy_us += e.work_us;
+            charge_ma_us += (double)e.work_us * e.work_ma;
+        }
+        ++loop;
+    }
+
+    LoadResult r;
+    float seconds = t_us * 1e-6f;
+    r.frames_per_s = work[0] / seconds;
+    r.stretched_calls = calls[4] / seconds;
+    r.busy_pct = 100.0f * busy_us / t_us;
+    r.current_ma = BASE_MA + (float)(charge_ma_us / t_us) + 3.0f * BACKLIGHT_MA_PER_DISPLAY * policy.display_pct / 100.0f;
+    return r;
+}
+
+void test_dispatch_load_per_level(void) {
+    host_bench::ensureOutputDir();
+    FILE* csv = fopen("test_output/power_dispatch_load.csv", "w");
+    TEST_ASSERT_NOT_NULL(csv);
+    fprintf(csv, "level,period_stretch,display_pct,frames_per_s,stretched_calls_per_s,busy_pct,current_ma\n");
+
+    PowerGovernor gov;
+    LoadResult prev = {0, 0, 0, 0};
+    for (int l = 0; l < PowerGovernor::LEVEL_COUNT; l++) {
+        const PowerGovernor::Policy& p = gov.policy((PowerGovernor::Level)l);
+        LoadResult r = runDispatch(p);
+        printf("[LOAD] %-8s stretch x%d: eyes %4.1f fps, nostril act %6.0f/s, busy %4.1f%%, head %5.1f mA\n",
+               PowerGovernor::levelName((PowerGovernor::Level)l), p.period_stretch, r.frames_per_s,
+               r.stretched_calls, r.busy_pct, r.current_ma);
+        fprintf(csv, "%s,%d,%d,%.1f,%.0f,%.1f,%.1f\n", PowerGovernor::levelName((PowerGovernor::Level)l),
+                p.period_stretch, p.display_pct, r.frames_per_s, r.stretched_calls, r.busy_pct, r.current_ma);
+        if (l > 0) {
+            TEST_ASSERT_TRUE(r.frames_per_s <= prev.frames_per_s + 0.5f);
+            TEST_ASSERT_TRUE(r.stretched_calls < prev.stretched_calls);
+            TEST_ASSERT_TRUE(r.current_ma < prev.current_ma);
+        }
+        prev = r;
+    }
+    fclose(csv);
+
+    // CRITICAL still animates, just slowly
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 7.5f, prev.frames_per_s);
+}
+
+void test_perched_runtime_with_governor(void) {
+    // Perched from 40% down to 10%: head electronics plus 0.5 A for the
+    // flight board, radios and idle servos. Compare governed vs fixed FULL
+    PowerGovernor gov;
+    const PowerGovernor::Policy full = gov.policy(PowerGovernor::LEVEL_FULL);
+    LoadResult level_load[PowerGovernor::LEVEL_COUNT];
+    for (int l = 0; l < PowerGovernor::LEVEL_COUNT; l++) {
+        level_load[l] = runDispatch(gov.policy((PowerGovernor::Level)l));
+    }
+
+    float runtime[2];
+    for (int governed = 0; governed < 2; governed++) {
+        SimPack pack(0.40f);
+        BatteryEstimator est;
+        est.configure(CELLS, CAPACITY_MAH, 0.030f);
+        gov.reset();
+        float t = 0.0f;
+        const float dt = 1.0f;
+        while (pack.soc > 0.10f) {
+            float head_ma = governed ? level_load[gov.level()].current_ma : runDispatch(full).current_ma;
+            float amps = 0.5f + head_ma * 0.001f;
+            float v = pack.step(amps, dt);
+            est.update(v, amps, dt);
+            if (governed) gov.update(est.soc(), dt);
+            t += dt;
+        }
+        runtime[governed] = t;
+    }
+    printf("[PERCH] 40%% -> 10%%: %.0f min at FULL, %.0f min governed (+%.1f%%)\n",
+           runtime[0] / 60.0f, runtime[1] / 60.0f, 100.0f * (runtime[1] / runtime[0] - 1.0f));
+    TEST_ASSERT_TRUE(runtime[1] > runtime[0] * 1.05f);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_oversampling_resolution);
+    RUN_TEST(test_soc_tracks_discharge);
+    RUN_TEST(test_soc_seeds_from_ocv);
+    RUN_TEST(test_governor_hysteresis);
+    RUN_TEST(test_dispatch_load_per_level);
+    RUN_TEST(test_perched_runtime_with_governor);
+    return UNITY_END();
+}
@@ -0,0 +1,323 @@
+/**
+ * @file test_main.cpp
+ * @brief Host tests of SensorFusionEngine: trace replay, staleness, queue bounds, cost
+ *
+ * A visitor scenario (empty room, approach, touch + talk, walk away) is
+ * recorded as a sensor trace at the real producer rates - HC-SR04 every
+ * 60 ms, ear blocks every 16 ms, PIR and touch edges - including late
+ * deliveries, then replayed through the engine at the 20 Hz fusion rate.
+ * Set SENSOR_FUSION_TRACE=<csv> to replay a capture from the robot instead.
+ *
+ * Outputs for inspection (test_output/):
+ *   sensor_fusion_trace.csv   - source, t_measured_ms, t_delivered_ms, value, aux, quality
+ *   sensor_fusion_output.csv  - t, presence, attention, proximity, approach, per-source confidence
+ *
+ * Run: pio test -e host_test -f test_host_sensor_fusion
+ */
+
+#include <unity.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "config/components/templates/SensorFusionEngine.hpp"
+#include "../host_support/host_bench.hpp"
+
+typedef SensorFusionEngine<16> Fusion;
+
+static const uint32_t PERIOD_MS = 50;
+
+struct TraceEvent {
+    uint8_t source;
+    uint32_t t_ms;          // Measured
+    uint32_t delivered_ms;  // Posted to the engine
+    int16_t value;
+    int16_t aux;
+    uint8_t quality;
+};
+
+static uint32_t rng_state = 77;
+static float frand() {
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return (float)(rng_state >> 8) / 16777216.0f;
+}
+
+/**
+ * Visitor scenario, 30 s:
+ *   0-5 s    empty room: fan noise on the mic, far wall at 300 cm
+ *   5-10 s   visitor enters (PIR), walks from 200 cm to 25 cm
+ *   10-15 s  stands at 25 cm talking; touches the head at 12-13.5 s
+ *   15-18 s  walks away to 300 cm; PIR goes quiet at 18 s
+ *   18-30 s  empty room again
+ */
+static float visitorDistance(float t) {
+    if (t < 5.0f || t >= 18.0f) return 300.0f;
+    if (t < 10.0f) return 200.0f - 35.0f * (t - 5.0f);
+    if (t < 15.0f) return 25.0f;
+    return 25.0f + 91.7f * (t - 15.0f);
+}
+
+static std::vector<TraceEvent> recordScenario() {
+    std::vector<TraceEvent> trace;
+    for (uint32_t t = 0; t < 30000; t += 60) {
+        float d = visitorDistance(t * 1e-3f);
+        float v = (visitorDistance(t * 1e-3f + 0.06f) - d) / 0.06f;
+        if (frand() < 0.05f) continue;  // Lost echo
+        TraceEvent e = {Fusion::SRC_ULTRASONIC, t, t + 2, (int16_t)(d + 2.0f * (frand() - 0.5f)), (int16_t)v, 230};
+        if (frand() < 0.03f) e.delivered_ms = t + 400;  // Nose task stalled behind a display flush
+        trace.push_back(e);
+    }
+    for (uint32_t t = 0; t < 30000; t += 16) {
+        bool talking = t >= 10500 && t < 15000 && (t / 400) % 3 != 0;
+        int16_t level = talking ? (int16_t)(2500 + 500 * frand()) : (int16_t)(150 + 50 * frand());
+        TraceEvent e = {Fusion::SRC_MIC, t, t + 16, level, (int16_t)(talking ? 50 : 0), (uint8_t)(talking ? 200 : 60)};
+        trace.push_back(e);
+    }
+    // PIR: high on entry, re-triggers every 2 s while someone moves, low when the room empties
+    for (uint32_t t = 5000; t < 18000; t += 2000) {
+        TraceEvent e = {Fusion::SRC_PIR, t, t + 1, 1, 0, 255};
+        trace.push_back(e);
+    }
+    TraceEvent pir_off = {Fusion::SRC_PIR, 18000, 18001, 0, 0, 255};
+    trace.push_back(pir_off);
+    for (uint32_t t = 12000; t < 13500; t += 100) {
+        TraceEvent e = {Fusion::SRC_TOUCH, t, t + 1, 0x3, 0, 255};
+        trace.push_back(e);
+    }
+    TraceEvent release = {Fusion::SRC_TOUCH, 13500, 13501, 0, 0, 255};
+    trace.push_back(release);
+
+    std::stable_sort(trace.begin(), trace.end(),
+                     [](const TraceEvent& a, const TraceEvent& b) { return a.delivered_ms < b.delivered_ms; });
+    return trace;
+}
+
+static bool writeTrace(const char* path, const std::vector<TraceEvent>& trace) {
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+    fprintf(f, "source,t_measured_ms,t_delivered_ms,value,aux,quality\n");
+    for (const TraceEvent& e : trace) {
+        fprintf(f, "%u,%u,%u,%d,%d,%u\n", e.source, e.t_ms, e.delivered_ms, e.value, e.aux, e.quality);
+    }
+    fclose(f);
+    return true;
+}
+
+static std::vector<TraceEvent> readTrace(const char* path) {
+    std::vector<TraceEvent> trace;
+    FILE* f = fopen(path, "r");
+    if (!f) return trace;
+    char line[128];
+    if (!fgets(line, sizeof(line), f)) { fclose(f); return trace; }
+    unsigned src, t, del, q;
+    int value, aux;
+    while (fscanf(f, "%u,%u,%u,%d,%d,%u", &src, &t, &del, &value, &aux, &q) == 6) {
+        TraceEvent e = {(uint8_t)src, t, del, (int16_t)value, (int16_t)aux, (uint8_t)q};
+        trace.push_back(e);
+    }
+    fclose(f);
+    return trace;
+}
+
+struct Frame {
+    Fusion::Output out;
+};
+
+static std::vector<Frame> replay(const std::vector<TraceEvent>& trace, Fusion& fusion, host_bench::CostStats& cost) {
+    std::vector<Frame> frames;
+    size_t next = 0;
+    uint32_t end_ms = trace.empty() ? 0 : trace.back().delivered_ms + 1000;
+    for (uint32_t now = 0; now <= end_ms; now += PERIOD_MS) {
+        while (next < trace.size() && trace[next].delivered_ms <= now) {
+            const TraceEvent& e = trace[next++];
+            Fusion::Sample s = {e.t_ms, e.value, e.aux, e.quality};
+            fusion.post((Fusion::Source)e.source, s);
+        }
+        uint64_t t0 = host_bench::nowNs();
+        Frame f;
+        f.out = fusion.update(now);
+        cost.add(host_bench::nowNs() - t0);
+        frames.push_back(f);
+    }
+    return frames;
+}
+
+static const Fusion::Output& at(const std::vector<Frame>& frames, uint32_t t_ms) {
+    return frames[t_ms / PERIOD_MS].out;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_visitor_trace_replay(void) {
+    host_bench::ensureOutputDir();
+    std::vector<TraceEvent> trace = recordScenario();
+    TEST_ASSERT_TRUE(writeTrace("test_output/sensor_fusion_trace.csv", trace));
+
+    const char* external = getenv("SENSOR_FUSION_TRACE");
+    std::vector<TraceEvent> replayed = readTrace(external ? external : "test_output/sensor_fusion_trace.csv");
+    TEST_ASSERT_TRUE(replayed.size() > 0);
+
+    static Fusion fusion;
+    fusion.configure(30, 150, 2000, 50);
+    host_bench::CostStats cost;
+    std::vector<Frame> frames = replay(replayed, fusion, cost);
+
+    FILE* csv = fopen("test_output/sensor_fusion_output.csv", "w");
+    if (csv) {
+        fprintf(csv, "t_ms,presence,attention,proximity_cm,approach_cm_s,conf_us,conf_pir,conf_touch,conf_mic\n");
+        for (const Frame& f : frames) {
+            fprintf(csv, "%u,%u,%u,%u,%d,%u,%u,%u,%u\n", f.out.t_ms, f.out.presence, f.out.attention,
+                    f.out.proximity_cm, f.out.approach_cm_s, f.out.confidence[0], f.out.confidence[1],
+                    f.out.confidence[2], f.out.confidence[3]);
+        }
+        fclose(csv);
+    }
+
+    const Fusion::Stats& st = fusion.getStats();
+    printf("[FUSION] %zu samples replayed, %u applied, %u stale, max %u per update\n", replayed.size(),
+           st.applied, st.stale, st.max_drained);
+    printf("[FUSION] presence empty %u -> approach %u -> touch %u -> left+3s %u\n", at(frames, 4000).presence,
+           at(frames, 8000).presence, at(frames, 12500).presence, at(frames, 21000).presence);
+    printf("[FUSION] attention empty %u, standing %u, touch %u, talking %u\n", at(frames, 4000).attention,
+           at(frames, 9000).attention, at(frames, 12500).attention, at(frames, 14500).attention);
+    cost.print("SensorFusionEngine::update", PERIOD_MS * 1e6);
+
+    if (external) return;   // Recorded robot traces have no ground truth
+
+    // Empty room: wall and fan noise are not a visitor
+    TEST_ASSERT_LESS_THAN(40, at(frames, 4000).presence);
+    TEST_ASSERT_INT_WITHIN(3, 300, at(frames, 4000).proximity_cm);
+    // Entry: PIR alone flips presence within one update
+    TEST_ASSERT_GREATER_THAN(200, at(frames, 5050).presence);
+    // Approach: proximity tracks the walk, approach speed is reported
+    TEST_ASSERT_INT_WITHIN(10, 60, at(frames, 9000).proximity_cm);
+    TEST_ASSERT_INT_WITHIN(10, 35, at(frames, 9000).approach_cm_s);
+    // Touch dominates attention and proximity
+    TEST_ASSERT_GREATER_THAN(240, at(frames, 12500).attention);
+    TEST_ASSERT_EQUAL_UINT16(0, at(frames, 12500).proximity_cm);
+    // Standing close and talking keeps attention up after the touch decays
+    TEST_ASSERT_GREATER_THAN(160, at(frames, 14500).attention);
+    // Leaving: presence falls within a few seconds of the PIR going quiet
+    TEST_ASSERT_LESS_THAN(64, at(frames, 24000).presence);
+    TEST_ASSERT_LESS_THAN(30, at(frames, 24000).attention);
+    // Stalled nose deliveries arrive behind fresher echoes and are dropped
+    TEST_ASSERT_GREATER_THAN(0, st.stale);
+}
+
+void test_stale_and_future_samples(void) {
+    Fusion fusion;
+    Fusion::Sample fresh = {10000, 40, 0, 255};
+    fusion.post(Fusion::SRC_ULTRASONIC, fresh);
+    Fusion::Output out = fusion.update(10000);
+    TEST_ASSERT_EQUAL_UINT8(255, out.confidence[Fusion::SRC_ULTRASONIC]);
+
+    // A reading measured 2 s ago that shows up now is already 5 half-lives old
+    Fusion fusion2;
+    Fusion::Sample late = {8000, 40, 0, 255};
+    fusion2.post(Fusion::SRC_ULTRASONIC, late);
+    out = fusion2.update(10000);
+    TEST_ASSERT_LESS_THAN(10, out.confidence[Fusion::SRC_ULTRASONIC]);
+    TEST_ASSERT_EQUAL_UINT16(0xFFFF, out.proximity_cm);
+
+    // Older than what the source already reported: ignored entirely
+    Fusion::Sample older = {9900, 200, 0, 255};
+    fusion.post(Fusion::SRC_ULTRASONIC, older);
+    out = fusion.update(10050);
+    TEST_ASSERT_EQUAL_UINT16(40, out.proximity_cm);
+    TEST_ASSERT_EQUAL_UINT32(1, fusion.getStats().stale);
+
+    // Producer clock ahead of ours: treated as "now", decays from there
+    Fusion fusion3;
+    Fusion::Sample future = {20000, 40, 0, 255};
+    fusion3.post(Fusion::SRC_ULTRASONIC, future);
+    fusion3.update(10000);
+    out = fusion3.update(10400);
+    TEST_ASSERT_INT_WITHIN(3, 128, out.confidence[Fusion::SRC_ULTRASONIC]);
+
+    // Half-life approximation stays close to the exponential
+    for (uint32_t age = 0; age < 3000; age += 37) {
+        Fusion f;
+        Fusion::Sample s = {1000, 1, 0, 255};
+        f.post(Fusion::SRC_PIR, s);
+        out = f.update(1000 + age);
+        float exact = 255.0f * powf(0.5f, age / 3000.0f);
+        TEST_ASSERT_FLOAT_WITHIN(0.07f * 255.0f, exact, (float)out.confidence[Fusion::SRC_PIR]);
+    }
+}
+
+void test_queue_bounds_and_concurrent_producers(void) {
+    static Fusion fusion;
+    Fusion::Sample s = {0, 1, 0, 255};
+    for (int i = 0; i < 20; i++) {
+        s.t_ms = (uint32_t)i;
+        fusion.post(Fusion::SRC_PIR, s);
+    }
+    TEST_ASSERT_EQUAL_UINT32(4, fusion.droppedCount(Fusion::SRC_PIR));
+    fusion.update(100);
+    TEST_ASSERT_EQUAL_UINT32(16, fusion.getStats().max_drained);
+
+    // One producer thread per source, consumer at full speed
+    static Fusion shared;
+    const int per_source = 20000;
+    std::vector<std::thread> producers;
+    uint32_t posted[Fusion::SRC_COUNT] = {0, 0, 0, 0};
+    for (int src = 0; src < Fusion::SRC_COUNT; src++) {
+        producers.emplace_back([&, src]() {
+            for (int i = 0; i < per_source; i++) {
+                Fusion::Sample smp = {(uint32_t)i, (int16_t)(i & 0x7FFF), 0, 200};
+                if (shared.post((Fusion::Source)src, smp)) posted[src]++;
+                if (i % 8 == 0) std::this_thread::yield();
+            }
+        });
+    }
+    uint32_t now = 0;
+    bool running = true;
+    while (running) {
+        shared.update(now++);
+        uint32_t accounted = shared.getStats().applied + shared.getStats().stale;
+        uint32_t dropped = 0;
+        for (int src = 0; src < Fusion::SRC_COUNT; src++) dropped += shared.droppedCount((Fusion::Source)src);
+        running = accounted + dropped < (uint32_t)(per_source * Fusion::SRC_COUNT);
+    }
+    for (auto& t : producers) t.join();
+
+    uint32_t total_posted = 0;
+    for (int src = 0; src < Fusion::SRC_COUNT; src++) total_posted += posted[src];
+    printf("[FUSION] concurrent: %u posted, %u applied, %u stale\n", total_posted, shared.getStats().applied,
+           shared.getStats().stale);
+    TEST_ASSERT_EQUAL_UINT32(total_posted, shared.getStats().applied + shared.getStats().stale);
+    // Each producer posts in time order, so nothing it delivers is stale
+    TEST_ASSERT_EQUAL_UINT32(0, shared.getStats().stale);
+    TEST_ASSERT_LESS_OR_EQUAL(16 * Fusion::SRC_COUNT, shared.getStats().max_drained);
+}
+
+void test_worst_case_update_cost(void) {
+    static Fusion fusion;
+    host_bench::CostStats cost;
+    for (int tick = 0; tick < 5000; tick++) {
+        for (int src = 0; src < Fusion::SRC_COUNT; src++) {
+            for (int i = 0; i < 16; i++) {
+                Fusion::Sample s = {(uint32_t)(tick * 50 + i), (int16_t)(40 + i), (int16_t)-i, 200};
+                fusion.post((Fusion::Source)src, s);
+            }
+        }
+        uint64_t t0 = host_bench::nowNs();
+        fusion.update((uint32_t)(tick * 50 + 20));
+        cost.add(host_bench::nowNs() - t0);
+    }
+    cost.print("SensorFusionEngine::update, all queues full", PERIOD_MS * 1e6);
+    TEST_ASSERT_LESS_THAN(0.001 * PERIOD_MS * 1e6, cost.meanNs());
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_visitor_trace_replay);
+    RUN_TEST(test_stale_and_future_samples);
+    RUN_TEST(test_queue_bounds_and_concurrent_producers);
+    RUN_TEST(test_worst_case_update_cost);
+    return UNITY_END();
+}
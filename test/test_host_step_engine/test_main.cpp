@@ -0,0 +1,294 @@
+/**
+ * @file test_main.cpp
+ * @brief Multi-axis timer-ISR step engine for clearpath_motor_driver
+ *
+ * The ISR is simulated by calling MultiAxisStepEngine::tick() once per
+ * timer period; a tick that returns step bits is a STEP pulse on those
+ * axes at that tick's timestamp.
+ *
+ * - Bresenham: every axis ends exactly on target, each pulse count matches,
+ *   no axis strays more than half a step from the straight line, and no
+ *   pulse shares a tick with a DIR change
+ * - Limits: path speed and acceleration recovered from pulse timestamps
+ *   stay within the configured values
+ * - Lookahead: a 72-chord circle fed through the queue keeps moving at
+ *   speed through every junction, versus stopping at each one without
+ *   junction deviation; a 90 degree corner slows to the junction speed
+ *   and no tick-to-tick speed change exceeds the acceleration, including
+ *   segments whose exit is raised while they execute
+ * - Cost: tick() with and without a step event, 8 axes; gives the maximum
+ *   tick rate (and aggregate step rate) the ISR budget allows
+ *
+ * Outputs for inspection (test_output/):
+ *   step_engine_circle.csv - t, path speed with and without lookahead
+ *
+ * Run: pio test -e host_test -f test_host_step_engine
+ */
+
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "config/components/templates/MultiAxisStepEngine.hpp"
+#include "../host_support/host_bench.hpp"
+
+static const uint32_t TICK_HZ = 40000;
+static const float ACCEL = 20000.0f;
+
+struct Pulse {
+    uint32_t tick;
+    uint32_t bits;
+};
+
+/** Run the ISR until idle, feeding `moves` as queue space allows */
+struct Feeder {
+    std::vector<std::vector<int32_t>> moves;
+    float speed = 8000.0f;
+    size_t next = 0;
+
+    void feed(MultiAxisStepEngine& eng) {
+        while (next < moves.size() && !eng.full()) {
+            eng.push(moves[next].data(), speed);
+            next++;
+        }
+    }
+};
+
+static std::vector<Pulse> run(MultiAxisStepEngine& eng, Feeder& feeder,
+                              std::vector<float>* speed_log = nullptr,
+                              uint32_t* dir_violations = nullptr) {
+    std::vector<Pulse> pulses;
+    uint32_t last_dir = eng.dirBits();
+    feeder.feed(eng);
+    for (uint32_t t = 0; t < TICK_HZ * 60; t++) {
+        uint32_t bits = eng.tick();
+        if (dir_violations && bits != 0 && eng.dirBits() != last_dir) (*dir_violations)++;
+        last_dir = eng.dirBits();
+        if (bits) pulses.push_back({ t, bits });
+        if (speed_log) speed_log->push_back(eng.speed());
+        if ((t & 63) == 0) feeder.feed(eng);    // Task side runs far slower than the ISR
+        if (eng.idle() && feeder.next >= feeder.moves.size()) break;
+    }
+    return pulses;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_bresenham_line(void) {
+    MultiAxisStepEngine eng;
+    eng.configure(TICK_HZ, 3, ACCEL, 2.0f);
+    Feeder f;
+    f.moves = { { 1000, -370, 45 }, { -1000, 370, -45 } };
+
+    const int32_t target[2][3] = { { 1000, -370, 45 }, { 0, 0, 0 } };
+    uint32_t dir_bad = 0;
+    std::vector<Pulse> pulses = run(eng, f, nullptr, &dir_bad);
+
+    // Walk the first move and check every intermediate point against the line
+    int32_t p[3] = { 0, 0, 0 };
+    uint32_t counts[3] = { 0, 0, 0 };
+    float worst = 0.0f;
+    for (size_t k = 0; k < pulses.size(); k++) {
+        for (int i = 0; i < 3; i++) {
+            if (pulses[k].bits & (1u << i)) {
+                counts[i]++;
+                p[i] += (counts[0] <= 1000 ? (target[0][i] < 0 ? -1 : 1) : (target[0][i] < 0 ? 1 : -1));
+            }
+        }
+        if (counts[0] <= 1000) {
+            float progress = (float)p[0] / 1000.0f;
+            for (int i = 1; i < 3; i++) {
+                worst = fmaxf(worst, fabsf((float)p[i] - progress * (float)target[0][i]));
+            }
+        }
+    }
+    printf("[LINE] pulses %u/%u/%u  worst off-line %.3f steps  dir violations %u  final %ld,%ld,%ld\n",
+           counts[0], counts[1], counts[2], worst, dir_bad,
+           (long)eng.position(0), (long)eng.position(1), (long)eng.position(2));
+    TEST_ASSERT_EQUAL_UINT32(2000, counts[0]);
+    TEST_ASSERT_EQUAL_UINT32(740, counts[1]);
+    TEST_ASSERT_EQUAL_UINT32(90, counts[2]);
+    TEST_ASSERT_TRUE(worst <= 0.5f + 1e-3f);
+    TEST_ASSERT_EQUAL_UINT32(0, dir_bad);
+    for (int i = 0; i < 3; i++) TEST_ASSERT_EQUAL_INT32(target[1][i], eng.position(i));
+}
+
+void test_speed_and_accel_limits(void) {
+    const float V = 10000.0f;
+    MultiAxisStepEngine eng;
+    eng.configure(TICK_HZ, 1, ACCEL, 2.0f);
+    Feeder f;
+    f.speed = V;
+    f.moves = { { 20000 } };
+    std::vector<Pulse> pulses = run(eng, f);
+    TEST_ASSERT_EQUAL_UINT32(20000, (uint32_t)pulses.size());
+
+    // Windowed speed from pulse ticks. Pulses land on the 25 us tick grid, so
+    // the window has to span ~20 ms before that jitter drops under 2 % in acceleration
+    const int W = 200;
+    std::vector<double> tv, v;
+    for (size_t i = W; i + W < pulses.size(); i += W) {
+        double dt = (double)(pulses[i + W].tick - pulses[i - W].tick) / TICK_HZ;
+        tv.push_back((pulses[i + W].tick + pulses[i - W].tick) * 0.5 / TICK_HZ);
+        v.push_back(2.0 * W / dt);
+    }
+    double v_max = 0.0, a_max = 0.0;
+    for (size_t i = 0; i < v.size(); i++) v_max = fmax(v_max, v[i]);
+    for (size_t i = 1; i + 1 < v.size(); i++) {
+        a_max = fmax(a_max, fabs((v[i + 1] - v[i - 1]) / (tv[i + 1] - tv[i - 1])));
+    }
+    double t_total = (double)pulses.back().tick / TICK_HZ;
+    double ideal = V / ACCEL + 20000.0 / V;
+    printf("[LIMITS] v %.0f/%.0f  a %.0f/%.0f  time %.4f s (ideal %.4f)\n",
+           v_max, V, a_max, ACCEL, t_total, ideal);
+    TEST_ASSERT_TRUE(v_max <= V * 1.01);
+    TEST_ASSERT_TRUE(a_max <= ACCEL * 1.05);
+    TEST_ASSERT_FLOAT_WITHIN(0.01 * ideal, ideal, t_total);
+}
+
+static Feeder circle(float radius, int chords) {
+    Feeder f;
+    int32_t px = (int32_t)lroundf(radius), py = 0;
+    for (int k = 1; k <= chords; k++) {
+        float th = 2.0f * (float)M_PI * k / chords;
+        int32_t x = (int32_t)lroundf(radius * cosf(th)), y = (int32_t)lroundf(radius * sinf(th));
+        f.moves.push_back({ x - px, y - py });
+        px = x;
+        py = y;
+    }
+    return f;
+}
+
+void test_lookahead_blends_circle(void) {
+    host_bench::ensureOutputDir();
+    std::vector<float> blended, stopped;
+    double t_blend = 0.0, t_stop = 0.0;
+    float min_mid = 1e9f, max_dv = 0.0f;
+    for (int mode = 0; mode < 2; mode++) {
+        MultiAxisStepEngine eng;
+        eng.configure(TICK_HZ, 2, ACCEL, mode == 0 ? 2.0f : 0.0f);
+        Feeder f = circle(2000.0f, 72);
+        std::vector<float>& log = mode == 0 ? blended : stopped;
+        std::vector<Pulse> pulses = run(eng, f, &log);
+        (mode == 0 ? t_blend : t_stop) = (double)log.size() / TICK_HZ;
+        TEST_ASSERT_EQUAL_INT32(0, eng.position(0));
+        TEST_ASSERT_EQUAL_INT32(0, eng.position(1));
+        if (mode == 0) {
+            for (size_t i = log.size() / 10; i < log.size() * 9 / 10; i++) min_mid = fminf(min_mid, log[i]);
+            for (size_t i = 1; i < log.size(); i++) {
+                if (log[i] > 0.0f && log[i - 1] > 0.0f) max_dv = fmaxf(max_dv, fabsf(log[i] - log[i - 1]));
+            }
+        }
+    }
+    float dv_limit = ACCEL / TICK_HZ;
+    // 5 degree turns at 2 steps deviation allow ~6500 steps/s; rounding the
+    // chords to whole steps makes a few turns sharper than that
+    printf("[CIRCLE] lookahead %.3f s vs stop-at-junction %.3f s (%.1fx)  min mid speed %.0f  max dv/tick %.2f (limit %.2f)\n",
+           t_blend, t_stop, t_stop / t_blend, min_mid, max_dv, dv_limit);
+    TEST_ASSERT_TRUE(t_stop > 2.0 * t_blend);
+    TEST_ASSERT_TRUE(min_mid > 4000.0f);
+    // Q16 events-per-length rounding shows up as a few steps/s at some chord joins
+    TEST_ASSERT_TRUE(max_dv <= dv_limit * 1.10f + 0.001f * 8000.0f);
+
+    FILE* csv = fopen("test_output/step_engine_circle.csv", "w");
+    TEST_ASSERT_NOT_NULL(csv);
+    fprintf(csv, "t_s,speed_lookahead,speed_stop_each\n");
+    size_t n = blended.size() > stopped.size() ? blended.size() : stopped.size();
+    for (size_t i = 0; i < n; i += 40) {
+        fprintf(csv, "%.4f,%.1f,%.1f\n", (double)i / TICK_HZ,
+                i < blended.size() ? blended[i] : 0.0f, i < stopped.size() ? stopped[i] : 0.0f);
+    }
+    fclose(csv);
+}
+
+void test_corner_junction_speed(void) {
+    MultiAxisStepEngine eng;
+    const float JDEV = 2.0f;
+    eng.configure(TICK_HZ, 2, ACCEL, JDEV);
+    Feeder f;
+    f.moves = { { 4000, 0 }, { 0, 4000 } };
+    std::vector<float> log;
+    run(eng, f, &log);
+    // The corner is where the speed is lowest between the two cruises
+    size_t mid = log.size() / 2;
+    float v_corner = 1e9f;
+    for (size_t i = mid - mid / 2; i < mid + mid / 2; i++) v_corner = fminf(v_corner, log[i]);
+    float sin_half = sqrtf(0.5f);
+    float expected = sqrtf(ACCEL * JDEV * sin_half / (1.0f - sin_half));
+    printf("[CORNER] 90 deg junction speed %.0f (planned %.0f)\n", v_corner, expected);
+    TEST_ASSERT_FLOAT_WITHIN(0.15f * expected, expected, v_corner);
+    TEST_ASSERT_EQUAL_INT32(4000, eng.position(0));
+    TEST_ASSERT_EQUAL_INT32(4000, eng.position(1));
+}
+
+void test_late_segment_raises_exit(void) {
+    // Second segment arrives while the first is already running: no stop in between
+    MultiAxisStepEngine eng;
+    eng.configure(TICK_HZ, 1, ACCEL, 2.0f);
+    int32_t d[1] = { 6000 };
+    eng.push(d, 8000.0f);
+    float min_after = 1e9f, prev = 0.0f, max_dv = 0.0f;
+    bool pushed = false;
+    for (uint32_t t = 0; t < TICK_HZ * 5 && !(pushed && eng.idle()); t++) {
+        eng.tick();
+        if (!pushed && eng.position(0) >= 2000) {
+            eng.push(d, 8000.0f);
+            pushed = true;
+        }
+        float v = eng.speed();
+        if (pushed && eng.position(0) > 5000 && eng.position(0) < 7000) min_after = fminf(min_after, v);
+        if (t > 0 && v > 0.0f && prev > 0.0f) max_dv = fmaxf(max_dv, fabsf(v - prev));
+        prev = v;
+    }
+    printf("[LATE] speed across the junction >= %.0f  max dv/tick %.2f  final %ld\n",
+           min_after, max_dv, (long)eng.position(0));
+    TEST_ASSERT_EQUAL_INT32(12000, eng.position(0));
+    TEST_ASSERT_TRUE(min_after > 7900.0f);
+    TEST_ASSERT_TRUE(max_dv <= ACCEL / TICK_HZ * 1.10f);
+}
+
+void test_isr_cost_and_max_rate(void) {
+    MultiAxisStepEngine eng;
+    eng.configure(TICK_HZ, 8, 1e6f, 2.0f);
+    int32_t d[8] = { 200000, -150000, 120000, -90000, 60000, -30000, 20000, 10000 };
+    eng.push(d, 0.5f * TICK_HZ * 10.0f);        // Clamped to the ISR limit
+
+    host_bench::CostStats idle_tick, event_tick;
+    uint64_t events = 0, steps = 0;
+    for (uint32_t t = 0; t < 400000 && !eng.idle(); t++) {
+        uint64_t t0 = host_bench::nowNs();
+        uint32_t bits = eng.tick();
+        uint64_t dt = host_bench::nowNs() - t0;
+        if (bits) {
+            event_tick.add(dt);
+            events++;
+            steps += (uint64_t)__builtin_popcount(bits);
+        } else {
+            idle_tick.add(dt);
+        }
+    }
+    double budget = 1e9 / TICK_HZ;
+    idle_tick.print("tick() no event, 8 axes", budget);
+    event_tick.print("tick() step event, 8 axes", budget);
+    // One event every other tick at full speed
+    double mean = 0.5 * (idle_tick.meanNs() + event_tick.meanNs());
+    double max_tick_hz = 0.5e9 / mean;          // ISR allowed half the CPU
+    printf("[RATE] events %llu  steps %llu  ->  max tick %.0f kHz (50%% CPU), %.0f k steps/s per axis, %.0f k aggregate (8 axes)\n",
+           (unsigned long long)events, (unsigned long long)steps,
+           max_tick_hz / 1000.0, max_tick_hz / 2000.0, 8.0 * max_tick_hz / 2000.0);
+    TEST_ASSERT_TRUE(events > 0);
+    TEST_ASSERT_TRUE(event_tick.meanNs() < budget * 0.1);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_bresenham_line);
+    RUN_TEST(test_speed_and_accel_limits);
+    RUN_TEST(test_lookahead_blends_circle);
+    RUN_TEST(test_corner_junction_speed);
+    RUN_TEST(test_late_segment_raises_exit);
+    RUN_TEST(test_isr_cost_and_max_rate);
+    return UNITY_END();
+}
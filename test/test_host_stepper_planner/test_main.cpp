@@ -0,0 +1,313 @@
+/**
+ * @file test_main.cpp
+ * @brief Trapezoidal / S-curve step interval tables for StepperController
+ *
+ * Every move is "played" the way the step ISR would: intervals from
+ * nextInterval() are summed into step timestamps. Velocity, acceleration
+ * and jerk are then recovered from those timestamps by central differences
+ * over a window of steps (tick rounding makes single-step differences
+ * meaningless at speed) and checked against the configured limits.
+ *
+ * - Trapezoid (AVR446 recurrence): exact step count, velocity and
+ *   acceleration bounded, move time close to the ideal v/a + D/v
+ * - S-curve: the same plus the jerk bound
+ * - Short moves: peak speed drops so both ramps fit, limits still hold
+ * - Long ramps beyond MAX_RAMP: strided table, timing error bounded
+ * - StepperController: retarget mid-move ramps down, then runs the new
+ *   move, ending exactly on the new target; retargeting to the stop point
+ *   during the ramp-down cancels the queued move
+ * - Cost: plan() per move and nextInterval() per step
+ *
+ * Outputs for inspection (test_output/):
+ *   stepper_profile.csv - profile, t, step, velocity, acceleration, jerk
+ *
+ * Run: pio test -e host_test -f test_host_stepper_planner
+ */
+
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "config/components/hardware/StepperController.hpp"
+#include "../host_support/host_bench.hpp"
+
+static const uint32_t TICK_HZ = 1000000;
+static const int WINDOW = 8;         // Steps per difference; ~4 ms at 2000 steps/s
+
+struct Kinematics {
+    uint32_t steps = 0;
+    double duration_s = 0.0;
+    double v_max = 0.0, a_max = 0.0, j_max = 0.0;
+};
+
+/** Play a planned move; returns the timestamp (s) of each step */
+static std::vector<double> play(StepperMotionPlanner& p) {
+    std::vector<double> t;
+    uint64_t ticks = 0;
+    uint32_t c;
+    while ((c = p.nextInterval()) != 0) {
+        ticks += c;
+        t.push_back((double)ticks / TICK_HZ);
+    }
+    return t;
+}
+
+/**
+ * Windowed central differences on step timestamps.
+ * Step k is at position k+1; velocity is the mean over +-w steps, placed
+ * at the middle of that time span (exact under constant acceleration),
+ * then acceleration and jerk are central differences of the series before.
+ */
+static Kinematics analyse(const std::vector<double>& t, int w, FILE* csv = nullptr, const char* label = "") {
+    Kinematics k;
+    k.steps = (uint32_t)t.size();
+    k.duration_s = t.empty() ? 0.0 : t.back();
+    int n = (int)t.size();
+    std::vector<double> tv, v, ta, a;
+    for (int i = w; i + w < n; i += w) {
+        double dt = t[i + w] - t[i - w];
+        tv.push_back(0.5 * (t[i + w] + t[i - w]));     // Mean speed holds at the mid time
+        v.push_back(2.0 * w / dt);
+    }
+    for (size_t i = 1; i + 1 < v.size(); i++) {
+        ta.push_back(tv[i]);
+        a.push_back((v[i + 1] - v[i - 1]) / (tv[i + 1] - tv[i - 1]));
+    }
+    for (size_t i = 0; i < v.size(); i++) k.v_max = fmax(k.v_max, v[i]);
+    for (size_t i = 0; i < a.size(); i++) k.a_max = fmax(k.a_max, fabs(a[i]));
+    std::vector<double> j(a.size(), 0.0);
+    for (size_t i = 1; i + 1 < a.size(); i++) {
+        j[i] = (a[i + 1] - a[i - 1]) / (ta[i + 1] - ta[i - 1]);
+        k.j_max = fmax(k.j_max, fabs(j[i]));
+    }
+    if (csv) {
+        for (size_t i = 0; i < a.size(); i++) {
+            fprintf(csv, "%s,%.6f,%d,%.1f,%.1f,%.0f\n", label, ta[i], (int)((i + 1) * w),
+                    v[i + 1], a[i], j[i]);
+        }
+    }
+    return k;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_trapezoid_limits(void) {
+    const float V = 2000.0f, A = 8000.0f;
+    StepperMotionPlanner p;
+    p.configure(TICK_HZ, V, A, 0.0f, StepperMotionPlanner::TRAPEZOID);
+    p.plan(3000);
+    TEST_ASSERT_EQUAL_UINT32(250, p.rampSteps());          // v^2 / 2a
+    std::vector<double> t = play(p);
+    Kinematics k = analyse(t, WINDOW);
+    double ideal = V / A + 3000.0 / V;
+    printf("[TRAP] steps %u  v %.0f/%.0f  a %.0f/%.0f  time %.4f s (ideal %.4f)\n",
+           k.steps, k.v_max, V, k.a_max, A, k.duration_s, ideal);
+    TEST_ASSERT_EQUAL_UINT32(3000, k.steps);
+    TEST_ASSERT_TRUE(k.v_max <= V * 1.01);
+    TEST_ASSERT_TRUE(k.a_max <= A * 1.03);
+    TEST_ASSERT_FLOAT_WITHIN(0.02 * ideal, ideal, k.duration_s);
+}
+
+void test_scurve_limits(void) {
+    const float V = 2000.0f, A = 8000.0f, J = 200000.0f;
+    StepperMotionPlanner p;
+    p.configure(TICK_HZ, V, A, J, StepperMotionPlanner::S_CURVE);
+    p.plan(3000);
+    std::vector<double> t = play(p);
+    Kinematics k = analyse(t, WINDOW);
+    // Ramp time v/a + a/j, so the move is longer than the trapezoid by a/j
+    double ideal = V / A + A / J + 3000.0 / V;
+    printf("[SCRV] steps %u  v %.0f/%.0f  a %.0f/%.0f  j %.0f/%.0f  time %.4f s (ideal %.4f)\n",
+           k.steps, k.v_max, V, k.a_max, A, k.j_max, J, k.duration_s, ideal);
+    TEST_ASSERT_EQUAL_UINT32(3000, k.steps);
+    TEST_ASSERT_TRUE(k.v_max <= V * 1.01);
+    TEST_ASSERT_TRUE(k.a_max <= A * 1.02);
+    TEST_ASSERT_TRUE(k.j_max <= J * 1.05);
+    TEST_ASSERT_FLOAT_WITHIN(0.01 * ideal, ideal, k.duration_s);
+}
+
+void test_short_moves_lower_peak(void) {
+    const float V = 2000.0f, A = 8000.0f, J = 200000.0f;
+    const uint32_t distances[] = { 1, 2, 7, 40, 150, 499 };
+    for (int shape = 0; shape < 2; shape++) {
+        for (uint32_t d : distances) {
+            StepperMotionPlanner p;
+            p.configure(TICK_HZ, V, A, J, shape ? StepperMotionPlanner::S_CURVE : StepperMotionPlanner::TRAPEZOID);
+            p.plan(d);
+            TEST_ASSERT_TRUE(p.peakSpeed() < V);
+            std::vector<double> t = play(p);
+            TEST_ASSERT_EQUAL_UINT32(d, (uint32_t)t.size());
+            if (d < 100) continue;              // Too few windows to difference
+            Kinematics k = analyse(t, WINDOW);
+            printf("[SHORT] %s %4u steps  peak %.0f  v %.0f  a %.0f  j %.0f\n",
+                   shape ? "scurve" : "trap  ", d, p.peakSpeed(), k.v_max, k.a_max, k.j_max);
+            TEST_ASSERT_TRUE(k.v_max <= p.peakSpeed() * 1.02);
+            TEST_ASSERT_TRUE(k.a_max <= A * 1.03);
+            if (shape) TEST_ASSERT_TRUE(k.j_max <= J * 1.05);
+        }
+    }
+}
+
+void test_long_ramp_strided(void) {
+    // 16x microstepped NEMA17 at 5 rev/s: a 32000-step ramp in a 512-entry table.
+    // Timer at 10 MHz, as a 1 us tick is already 1.6 % of a 62.5 us interval
+    const uint32_t FAST_HZ = 10000000;
+    const float V = 16000.0f, A = 4000.0f, J = 20000.0f;
+    StepperMotionPlanner p;
+    p.configure(FAST_HZ, V, A, J, StepperMotionPlanner::S_CURVE);
+    p.plan(100000);
+    TEST_ASSERT_TRUE(p.rampStride() > 1);
+    std::vector<double> t;
+    uint64_t ticks = 0;
+    uint32_t c;
+    while ((c = p.nextInterval()) != 0) {
+        ticks += c;
+        t.push_back((double)ticks / FAST_HZ);
+    }
+    double ideal = V / A + A / J + 100000.0 / V;
+    Kinematics k = analyse(t, 256);
+    printf("[LONG] ramp %u steps  stride %u  v %.0f  a %.0f  j %.0f  time %.4f s (ideal %.4f)\n",
+           p.rampSteps(), p.rampStride(), k.v_max, k.a_max, k.j_max, k.duration_s, ideal);
+    TEST_ASSERT_EQUAL_UINT32(100000, (uint32_t)t.size());
+    TEST_ASSERT_TRUE(k.v_max <= V * 1.01);
+    TEST_ASSERT_TRUE(k.a_max <= A * 1.02);
+    TEST_ASSERT_FLOAT_WITHIN(0.01 * ideal, ideal, k.duration_s);
+}
+
+void test_controller_retarget(void) {
+    StepperController ctl(STEPPER_MOTORS[NEMA17_STANDARD]);
+    ctl.setSpeed(300);                          // 1000 steps/s
+    ctl.setAcceleration(5000.0f, 100000.0f);
+    ctl.moveTo(2000);
+
+    std::vector<double> t;
+    std::vector<int32_t> pos;
+    uint64_t ticks = 0;
+    uint32_t c = ctl.nextIntervalUs();
+    bool retargeted = false;
+    int32_t max_pos = 0;
+    while (c != 0) {
+        ticks += c;
+        ctl.step();
+        t.push_back((double)ticks / TICK_HZ);
+        pos.push_back(ctl.getPosition());
+        if (ctl.getPosition() > max_pos) max_pos = ctl.getPosition();
+        if (!retargeted && ctl.getPosition() == 600) {
+            ctl.moveTo(-300);                   // Reverse while cruising
+            retargeted = true;
+        }
+        c = ctl.nextIntervalUs();
+    }
+    printf("[CTL] final %ld  overshoot to %ld  moving %d  time %.3f s\n",
+           (long)ctl.getPosition(), (long)max_pos, ctl.isMoving(), t.back());
+    TEST_ASSERT_EQUAL_INT32(-300, ctl.getPosition());
+    TEST_ASSERT_FALSE(ctl.isMoving());
+    // Ramp-down from 1000 steps/s at 5000 steps/s^2 takes ~100 steps + a/j
+    TEST_ASSERT_TRUE(max_pos > 600 && max_pos < 760);
+
+    // Speed at the reversal must come down to rest, not jump
+    size_t turn = 0;
+    for (size_t i = 0; i < pos.size(); i++) if (pos[i] == max_pos) { turn = i; break; }
+    double last_interval = t[turn] - t[turn - 1];
+    TEST_ASSERT_TRUE(last_interval > 1.0 / 300.0);  // Below 300 steps/s at the turn
+}
+
+/** Run ctl to rest; at position `at`, call moveTo() with each of `targets` */
+static int32_t runWithRetargets(StepperController& ctl, int32_t at, const std::vector<int32_t>& targets,
+                                int32_t* target_seen) {
+    int32_t max_pos = 0;
+    bool retargeted = false;
+    uint32_t c = ctl.nextIntervalUs();
+    while (c != 0) {
+        ctl.step();
+        if (ctl.getPosition() > max_pos) max_pos = ctl.getPosition();
+        if (!retargeted && ctl.getPosition() == at) {
+            for (int32_t target : targets) ctl.moveTo(target);
+            *target_seen = ctl.getTarget();
+            retargeted = true;
+        }
+        c = ctl.nextIntervalUs();
+    }
+    return max_pos;
+}
+
+void test_controller_retarget_to_stop_point(void) {
+    int32_t seen = 0;
+
+    // Where a ramp-down that starts at 600 comes to rest
+    StepperController probe(STEPPER_MOTORS[NEMA17_STANDARD]);
+    probe.setSpeed(300);
+    probe.setAcceleration(5000.0f, 100000.0f);
+    probe.moveTo(2000);
+    int32_t stop_point = runWithRetargets(probe, 600, {-300}, &seen);
+    TEST_ASSERT_EQUAL_INT32(-300, seen);
+
+    // Same ramp-down, then the queued move is replaced by the stop point itself
+    StepperController ctl(STEPPER_MOTORS[NEMA17_STANDARD]);
+    ctl.setSpeed(300);
+    ctl.setAcceleration(5000.0f, 100000.0f);
+    ctl.moveTo(2000);
+    int32_t max_pos = runWithRetargets(ctl, 600, {-300, stop_point}, &seen);
+    printf("[CTL] stop point %ld  target after retarget %ld  final %ld\n",
+           (long)stop_point, (long)seen, (long)ctl.getPosition());
+    TEST_ASSERT_EQUAL_INT32(stop_point, seen);
+    TEST_ASSERT_EQUAL_INT32(stop_point, ctl.getPosition());
+    TEST_ASSERT_EQUAL_INT32(stop_point, ctl.getTarget());
+    TEST_ASSERT_EQUAL_INT32(stop_point, max_pos);
+    TEST_ASSERT_FALSE(ctl.isMoving());
+
+    // Re-sending the queued target during the ramp-down keeps it queued
+    StepperController again(STEPPER_MOTORS[NEMA17_STANDARD]);
+    again.setSpeed(300);
+    again.setAcceleration(5000.0f, 100000.0f);
+    again.moveTo(2000);
+    runWithRetargets(again, 600, {-300, -300}, &seen);
+    TEST_ASSERT_EQUAL_INT32(-300, seen);
+    TEST_ASSERT_EQUAL_INT32(-300, again.getPosition());
+}
+
+void test_profile_csv_and_cost(void) {
+    host_bench::ensureOutputDir();
+    FILE* csv = fopen("test_output/stepper_profile.csv", "w");
+    TEST_ASSERT_NOT_NULL(csv);
+    fprintf(csv, "profile,t_s,step,velocity,accel,jerk\n");
+
+    host_bench::CostStats plan_trap, plan_scurve, next;
+    StepperMotionPlanner p;
+    for (int shape = 0; shape < 2; shape++) {
+        p.configure(TICK_HZ, 2000.0f, 8000.0f, 200000.0f,
+                    shape ? StepperMotionPlanner::S_CURVE : StepperMotionPlanner::TRAPEZOID);
+        for (int rep = 0; rep < 50; rep++) {
+            uint64_t t0 = host_bench::nowNs();
+            p.plan(1500);
+            (shape ? plan_scurve : plan_trap).add(host_bench::nowNs() - t0);
+        }
+        uint64_t t0 = host_bench::nowNs();
+        volatile uint32_t sink = 0;
+        uint32_t c, n = 0;
+        while ((c = p.nextInterval()) != 0) { sink += c; n++; }
+        uint64_t dt = host_bench::nowNs() - t0;
+        for (uint32_t i = 0; i < n; i++) next.add(dt / n);
+
+        p.plan(1500);
+        analyse(play(p), WINDOW, csv, shape ? "scurve" : "trapezoid");
+    }
+    fclose(csv);
+    plan_trap.print("plan() trapezoid, 250-step ramp");
+    plan_scurve.print("plan() S-curve, 260-step ramp");
+    next.print("nextInterval() per step", 500000.0);   // 2000 steps/s
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_trapezoid_limits);
+    RUN_TEST(test_scurve_limits);
+    RUN_TEST(test_short_moves_lower_peak);
+    RUN_TEST(test_long_ramp_strided);
+    RUN_TEST(test_controller_retarget);
+    RUN_TEST(test_controller_retarget_to_stop_point);
+    RUN_TEST(test_profile_csv_and_cost);
+    return UNITY_END();
+}
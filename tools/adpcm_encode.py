@@ -0,0 +1,159 @@
+#!/usr/bin/env python3
+"""
+IMA-ADPCM clip encoder for the speaker block path
+
+Converts 16-bit PCM WAV files into P32A clips (4:1) that
+config/components/templates/ImaAdpcmStream.hpp streams straight into the
+I2S blocks. Stereo input is mixed down to mono.
+
+Usage:
+    python tools/adpcm_encode.py goblin_cackle.wav -o data/sounds/goblin_cackle.p32a
+    python tools/adpcm_encode.py *.wav --out-dir data/sounds --block-bytes 256
+    python tools/adpcm_encode.py clip.wav -o clip.h --c-array   # embed in flash (.rodata)
+
+Clip layout (little endian):
+    "P32A" | u32 sample_rate | u32 sample_count | u16 block_bytes | u8 channels=1 | u8 version=1
+    blocks: i16 predictor | u8 step_index | u8 0 | (block_bytes - 4) bytes of codes, low nibble first
+"""
+
+import argparse
+import os
+import struct
+import sys
+import wave
+
+HEADER_BYTES = 16
+BLOCK_HEADER_BYTES = 4
+FORMAT_VERSION = 1
+
+STEP_TABLE = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+    253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487,
+    12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+]
+INDEX_TABLE = [-1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8]
+
+
+def read_wav_mono(path):
+    """Return (sample_rate, list of int16 samples)"""
+    with wave.open(path, 'rb') as wav:
+        if wav.getsampwidth() != 2:
+            raise ValueError(f"{path}: only 16-bit PCM is supported")
+        channels = wav.getnchannels()
+        rate = wav.getframerate()
+        raw = wav.readframes(wav.getnframes())
+
+    count = len(raw) // 2
+    values = struct.unpack(f'<{count}h', raw[:count * 2])
+    if channels == 1:
+        return rate, list(values)
+    mono = []
+    for i in range(0, len(values) - channels + 1, channels):
+        mono.append(sum(values[i:i + channels]) // channels)
+    return rate, mono
+
+
+def encode_block(pcm, block_bytes, step_index):
+    """Encode up to samples_per_block samples; returns (bytes, new step_index)"""
+    block = bytearray(block_bytes)
+    if not pcm:
+        return bytes(block), step_index
+    pred = pcm[0]
+    struct.pack_into('<hBB', block, 0, pred, step_index, 0)
+
+    for i, sample in enumerate(pcm[1:]):
+        diff = sample - pred
+        stepsize = STEP_TABLE[step_index]
+        code = 0
+        if diff < 0:
+            code = 8
+            diff = -diff
+        delta = stepsize >> 3
+        if diff >= stepsize:
+            code |= 4
+            diff -= stepsize
+            delta += stepsize
+        stepsize >>= 1
+        if diff >= stepsize:
+            code |= 2
+            diff -= stepsize
+            delta += stepsize
+        stepsize >>= 1
+        if diff >= stepsize:
+            code |= 1
+            delta += stepsize
+
+        pred = pred - delta if code & 8 else pred + delta
+        pred = max(-32768, min(32767, pred))
+        step_index = max(0, min(88, step_index + INDEX_TABLE[code]))
+
+        byte = BLOCK_HEADER_BYTES + i // 2
+        block[byte] |= (code << 4) if (i & 1) else code
+    return bytes(block), step_index
+
+
+def encode_clip(rate, pcm, block_bytes):
+    samples_per_block = 1 + 2 * (block_bytes - BLOCK_HEADER_BYTES)
+    out = bytearray(b'P32A')
+    out += struct.pack('<IIHBB', rate, len(pcm), block_bytes, 1, FORMAT_VERSION)
+    step_index = 0
+    for start in range(0, len(pcm), samples_per_block):
+        block, step_index = encode_block(pcm[start:start + samples_per_block], block_bytes, step_index)
+        out += block
+    return bytes(out)
+
+
+def write_c_array(path, name, data):
+    symbol = ''.join(c if c.isalnum() else '_' for c in name)
+    with open(path, 'w', newline='\n') as f:
+        f.write("// Generated by tools/adpcm_encode.py - do not edit\n")
+        f.write("#pragma once\n#include <stdint.h>\n\n")
+        f.write(f"static const uint8_t {symbol}_p32a[{len(data)}] = {{\n")
+        for i in range(0, len(data), 16):
+            f.write("    " + ", ".join(f"0x{b:02x}" for b in data[i:i + 16]) + ",\n")
+        f.write("};\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Encode WAV files to P32A IMA-ADPCM clips")
+    parser.add_argument('inputs', nargs='+', help="16-bit PCM WAV files")
+    parser.add_argument('-o', '--output', help="Output file (single input only)")
+    parser.add_argument('--out-dir', help="Output directory (one .p32a per input)")
+    parser.add_argument('--block-bytes', type=int, default=256,
+                        help="ADPCM block size = decoder read chunk (default 256, max 1024)")
+    parser.add_argument('--c-array', action='store_true', help="Emit a C header instead of a binary clip")
+    args = parser.parse_args()
+
+    if not BLOCK_HEADER_BYTES < args.block_bytes <= 1024:
+        parser.error("--block-bytes must be in 5..1024")
+    if args.output and len(args.inputs) != 1:
+        parser.error("-o only works with one input; use --out-dir")
+
+    for path in args.inputs:
+        rate, pcm = read_wav_mono(path)
+        clip = encode_clip(rate, pcm, args.block_bytes)
+
+        stem = os.path.splitext(os.path.basename(path))[0]
+        if args.output:
+            out_path = args.output
+        else:
+            ext = '.h' if args.c_array else '.p32a'
+            out_path = os.path.join(args.out_dir or os.path.dirname(path) or '.', stem + ext)
+
+        if args.c_array:
+            write_c_array(out_path, stem, clip)
+        else:
+            with open(out_path, 'wb') as f:
+                f.write(clip)
+
+        pcm_bytes = len(pcm) * 2
+        print(f"{path}: {len(pcm)} samples @ {rate} Hz, {pcm_bytes} -> {len(clip)} bytes "
+              f"({pcm_bytes / max(1, len(clip)):.2f}:1) -> {out_path}")
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,216 @@
+#!/usr/bin/env python3
+"""
+Eye animation library encoder for the band-decoded eye displays
+
+Packs RGB565 eye animations into a P32E library that
+config/components/templates/EyeAnimLibrary.hpp decodes one display band at
+a time. Bands identical to one already stored (the parts of the eye a frame
+does not change) are stored once.
+
+Usage:
+    python tools/eye_anim_encode.py eyes/goblin_eye.json -o data/eyes/goblin_eye.p32e
+    python tools/eye_anim_encode.py eyes/goblin_eye.json -o goblin_eye.h --c-array
+
+Manifest (frame paths relative to the manifest; .raw = RGB565 little endian,
+.ppm = binary P6 with maxval 255):
+    {
+        "width": 240, "height": 240, "band_rows": 16,
+        "animations": [
+            {"name": "BLINK", "delay_loops": 30, "frames": ["blink_0.raw", "blink_1.raw"]}
+        ]
+    }
+
+Library layout (little endian):
+    "P32E" | u16 width | u16 height | u16 band_rows | u16 frame_count | u8 animation_count | u8 version=1 | u16 0
+    animations: u16 first_frame | u16 frame_count | u16 delay_loops | u16 0
+    band index: per frame, per band u32 offset | u32 bytes (into the band data)
+    band data: QOI-style ops per band, see EyeAnimLibrary.hpp
+"""
+
+import argparse
+import json
+import os
+import struct
+import sys
+
+FORMAT_VERSION = 1
+OP_INDEX = 0x00
+OP_DIFF = 0x40
+OP_RUN = 0x80
+OP_LONG_RUN = 0xC0
+OP_LITERAL = 0xFF
+MAX_LONG_RUN = (0x3E << 8 | 0xFF) + 65
+
+
+def pixel_hash(p):
+    return ((p >> 11) * 3 + ((p >> 5) & 0x3F) * 5 + (p & 0x1F) * 7) & 63
+
+
+def read_ppm(path):
+    """Return (width, height, list of RGB565) from a binary P6 file"""
+    with open(path, 'rb') as f:
+        data = f.read()
+    tokens = []
+    pos = 0
+    while len(tokens) < 4:
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b'#':
+            pos = data.index(b'\n', pos) + 1
+            continue
+        start = pos
+        while not data[pos:pos + 1].isspace():
+            pos += 1
+        tokens.append(data[start:pos])
+    pos += 1
+    if tokens[0] != b'P6' or int(tokens[3]) != 255:
+        raise ValueError(f"{path}: only binary P6 with maxval 255 is supported")
+    width, height = int(tokens[1]), int(tokens[2])
+    rgb = data[pos:pos + width * height * 3]
+    pixels = [((rgb[i] & 0xF8) << 8) | ((rgb[i + 1] & 0xFC) << 3) | (rgb[i + 2] >> 3)
+              for i in range(0, len(rgb), 3)]
+    return width, height, pixels
+
+
+def read_frame(path, width, height):
+    if path.lower().endswith('.ppm'):
+        w, h, pixels = read_ppm(path)
+        if (w, h) != (width, height):
+            raise ValueError(f"{path}: {w}x{h}, manifest says {width}x{height}")
+        return pixels
+    with open(path, 'rb') as f:
+        raw = f.read()
+    if len(raw) != width * height * 2:
+        raise ValueError(f"{path}: {len(raw)} bytes, expected {width * height * 2}")
+    return list(struct.unpack(f'<{width * height}H', raw))
+
+
+def flush_run(out, run):
+    if run <= 64:
+        out.append(OP_RUN | (run - 1))
+    else:
+        v = run - 65
+        out.append(OP_LONG_RUN | (v >> 8))
+        out.append(v & 0xFF)
+
+
+def encode_band(pixels):
+    cache = [0] * 64
+    prev = 0
+    run = 0
+    out = bytearray()
+    for p in pixels:
+        if p == prev:
+            run += 1
+            if run == MAX_LONG_RUN:
+                flush_run(out, run)
+                run = 0
+            continue
+        if run:
+            flush_run(out, run)
+            run = 0
+
+        h = pixel_hash(p)
+        if cache[h] == p:
+            out.append(OP_INDEX | h)
+        else:
+            dr = (p >> 11) - (prev >> 11)
+            dg = ((p >> 5) & 0x3F) - ((prev >> 5) & 0x3F)
+            db = (p & 0x1F) - (prev & 0x1F)
+            if -2 <= dr <= 1 and -2 <= dg <= 1 and -2 <= db <= 1:
+                out.append(OP_DIFF | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2))
+            else:
+                out.append(OP_LITERAL)
+                out += struct.pack('<H', p)
+            cache[h] = p
+        prev = p
+    if run:
+        flush_run(out, run)
+    return bytes(out)
+
+
+def encode_library(width, height, band_rows, animations):
+    """animations: list of (delay_loops, [frame pixel lists]); returns (bytes, stats)"""
+    frames = [frame for _, anim_frames in animations for frame in anim_frames]
+    band_count = (height + band_rows - 1) // band_rows
+
+    out = bytearray(b'P32E')
+    out += struct.pack('<HHHHBBH', width, height, band_rows, len(frames), len(animations), FORMAT_VERSION, 0)
+    first = 0
+    for delay, anim_frames in animations:
+        out += struct.pack('<HHHH', first, len(anim_frames), delay, 0)
+        first += len(anim_frames)
+
+    index = bytearray()
+    data = bytearray()
+    stored = {}
+    for frame in frames:
+        for b in range(band_count):
+            start = b * band_rows * width
+            stop = min(height, (b + 1) * band_rows) * width
+            band = encode_band(frame[start:stop])
+            if band not in stored:
+                stored[band] = len(data)
+                data += band
+            index += struct.pack('<II', stored[band], len(band))
+    stats = {
+        'frames': len(frames),
+        'bands': len(frames) * band_count,
+        'unique_bands': len(stored),
+        'raw_bytes': len(frames) * width * height * 2,
+    }
+    return bytes(out + index + data), stats
+
+
+def write_c_array(path, name, data):
+    symbol = ''.join(c if c.isalnum() else '_' for c in name)
+    with open(path, 'w', newline='\n') as f:
+        f.write("// Generated by tools/eye_anim_encode.py - do not edit\n")
+        f.write("#pragma once\n#include <stdint.h>\n\n")
+        f.write(f"static const uint8_t {symbol}_p32e[{len(data)}] = {{\n")
+        for i in range(0, len(data), 16):
+            f.write("    " + ", ".join(f"0x{b:02x}" for b in data[i:i + 16]) + ",\n")
+        f.write("};\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Encode RGB565 eye animations into a P32E library")
+    parser.add_argument('manifest', help="JSON manifest listing animations and frame files")
+    parser.add_argument('-o', '--output', required=True, help="Output library (.p32e) or header (--c-array)")
+    parser.add_argument('--band-rows', type=int, help="Rows per band (overrides the manifest, default 16)")
+    parser.add_argument('--c-array', action='store_true', help="Emit a C header instead of a binary library")
+    args = parser.parse_args()
+
+    with open(args.manifest) as f:
+        manifest = json.load(f)
+    width = int(manifest['width'])
+    height = int(manifest['height'])
+    band_rows = args.band_rows or int(manifest.get('band_rows', 16))
+    if not 0 < band_rows <= height:
+        parser.error("band_rows must be in 1..height")
+
+    base = os.path.dirname(os.path.abspath(args.manifest))
+    animations = []
+    for anim in manifest['animations']:
+        frames = [read_frame(os.path.join(base, path), width, height) for path in anim['frames']]
+        if not frames:
+            raise ValueError(f"animation {anim.get('name', len(animations))} has no frames")
+        animations.append((int(anim.get('delay_loops', 1)), frames))
+    if len(animations) > 255:
+        raise ValueError("at most 255 animations")
+
+    library, stats = encode_library(width, height, band_rows, animations)
+    if args.c_array:
+        write_c_array(args.output, os.path.splitext(os.path.basename(args.output))[0], library)
+    else:
+        with open(args.output, 'wb') as f:
+            f.write(library)
+
+    print(f"{args.manifest}: {len(animations)} animations, {stats['frames']} frames {width}x{height}, "
+          f"{stats['unique_bands']}/{stats['bands']} bands stored, {stats['raw_bytes']} -> {len(library)} bytes "
+          f"({stats['raw_bytes'] / max(1, len(library)):.1f}:1) -> {args.output}")
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -121,6 +121,7 @@ class ComponentVisit:
     hit_count: int
     json_path: Optional[Path]
     template_type: Optional[str] = None
+    power_stretch: bool = False
 
 
 
@@ -176,6 +177,7 @@ class SubsystemContext:
             return
         init_func, act_func = resolve_function_names(component_name, data)
         hit_count = resolve_hit_count(data)
+        power_stretch = resolve_power_stretch(data)
 
         # Always record the visit for the dispatch table, which needs duplicates.
         self.visits.append(
@@ -186,6 +188,7 @@ class SubsystemContext:
                 hit_count=hit_count,
                 json_path=json_path,
                 template_type=template_type,
+                power_stretch=power_stretch,
             )
         )
 
@@ -320,6 +323,14 @@ def resolve_hit_count(data: Dict[str, Any]) -> int:
     return 1
 
 
+def resolve_power_stretch(data: Dict[str, Any]) -> bool:
+    """True when timing.powerStretch lets the power governor lengthen this entry's period."""
+    timing = data.get("timing")
+    if isinstance(timing, dict):
+        return timing.get("powerStretch") is True
+    return False
+
+
 def resolve_json_reference(base_path: Path, reference: str) -> Tuple[Path, Optional[str]]:
     """Resolves a JSON reference, parsing out a template type if present.
     
@@ -759,6 +770,11 @@ def render_component_source(context: SubsystemContext, include_shared: bool = Tr
     for include in sorted(interface_includes):
         lines.insert(1, f'#include "{include}"')
 
+    # Compiled behavior tables for components with a "behavior" block
+    for definition in sorted(context.unique_components.values(), key=lambda item: item.name):
+        if has_behavior(definition.data):
+            lines.insert(1, f'#include "subsystems/{context.name}/{behavior_namespace(definition.name)}.hpp"')
+
     # Process each component exactly once - inject assignments for components that use use_fields
     included_srcs: Set[Path] = set()
     for definition in sorted(context.unique_components.values(), key=lambda item: item.name):
@@ -797,6 +813,173 @@ def render_component_source(context: SubsystemContext, include_shared: bool = Tr
     return "\n".join(lines).rstrip() + "\n"
 
 
+BEHAVIOR_OPS: Dict[str, str] = {
+    "<=": "OP_LE",
+    ">=": "OP_GE",
+    "==": "OP_EQ",
+    "!=": "OP_NE",
+    "<": "OP_LT",
+    ">": "OP_GT",
+}
+
+BEHAVIOR_MAX_OUT = 16  # BehaviorMachine::MAX_OUT
+
+
+def has_behavior(data: Dict[str, Any]) -> bool:
+    return isinstance(data.get("behavior"), dict)
+
+
+def behavior_namespace(component_name: str) -> str:
+    return f"{sanitize_identifier(component_name)}_behavior"
+
+
+def parse_behavior_guard(text: str, facts: List[str], where: str) -> Tuple[int, str, int]:
+    """Parses one "fact op value" guard string into (fact index, op enum, value)."""
+    for symbol, op in BEHAVIOR_OPS.items():
+        if symbol in text:
+            left, right = text.split(symbol, 1)
+            fact = left.strip()
+            if fact not in facts:
+                raise ValueError(f"{where}: unknown fact '{fact}' in guard '{text}'")
+            try:
+                value = int(right.strip(), 0)
+            except ValueError as exc:
+                raise ValueError(f"{where}: guard '{text}' needs an integer value") from exc
+            if not -32768 <= value <= 32767:
+                raise ValueError(f"{where}: guard '{text}' value out of int16 range")
+            return facts.index(fact), op, value
+    raise ValueError(f"{where}: guard '{text}' has no comparison operator")
+
+
+def behavior_source(json_path: Optional[Path]) -> str:
+    if json_path is None:
+        return "inline configuration"
+    try:
+        return json_path.resolve().relative_to(PROJECT_ROOT).as_posix()
+    except ValueError:
+        return json_path.as_posix()
+
+
+def render_behavior_header(component_name: str, behavior: Dict[str, Any], source: str) -> str:
+    """Compiles a component's "behavior" block into BehaviorMachine tables.
+
+    States keep their authoring order; each state's transitions form one
+    contiguous slice in authoring order ("from": "*" expands to every other
+    state at its position), and each transition's guards one contiguous
+    slice, so the runtime only indexes.
+    """
+    where = f"behavior of '{component_name}'"
+    facts = [str(name) for name in behavior.get("facts", [])]
+    outputs = [str(name) for name in behavior.get("outputs", [])]
+    states_block = behavior.get("states")
+    if not isinstance(states_block, dict) or not states_block:
+        raise ValueError(f"{where}: 'states' must be a non-empty object")
+    states = list(states_block.keys())
+    initial = behavior.get("initial", states[0])
+    if initial not in states:
+        raise ValueError(f"{where}: unknown initial state '{initial}'")
+    if len(states) > 255 or len(facts) > 255 or len(outputs) > 255:
+        raise ValueError(f"{where}: at most 255 states, facts and outputs")
+
+    per_state: Dict[str, List[Dict[str, Any]]] = {name: [] for name in states}
+    for index, row in enumerate(behavior.get("transitions", [])):
+        row_where = f"{where}, transition {index}"
+        target = row.get("to")
+        if target not in states:
+            raise ValueError(f"{row_where}: unknown target state '{target}'")
+        sources = row.get("from", "*")
+        if sources == "*":
+            sources = [name for name in states if name != target]
+        elif isinstance(sources, str):
+            sources = [sources]
+        guards_text = row.get("when", [])
+        if isinstance(guards_text, str):
+            guards_text = [guards_text]
+        guards = [parse_behavior_guard(str(text), facts, row_where) for text in guards_text]
+        hold_ms = int(row.get("hold_ms", 0))
+        if not 0 <= hold_ms <= 65535:
+            raise ValueError(f"{row_where}: hold_ms must fit in 16 bits")
+        for name in sources:
+            if name not in states:
+                raise ValueError(f"{row_where}: unknown source state '{name}'")
+            per_state[name].append({"to": states.index(target), "guards": guards, "hold_ms": hold_ms})
+
+    state_rows: List[str] = []
+    transition_rows: List[str] = []
+    guard_rows: List[str] = []
+    guard_slices: Dict[Tuple[Tuple[int, str, int], ...], int] = {}  # Identical conjunctions share one slice
+    for name in states:
+        rows = per_state[name]
+        if len(rows) > BEHAVIOR_MAX_OUT:
+            raise ValueError(f"{where}: state '{name}' has {len(rows)} transitions (max {BEHAVIOR_MAX_OUT})")
+        state_rows.append(f"{{{len(transition_rows)}, {len(rows)}}},  // {name}")
+        for row in rows:
+            key = tuple(row["guards"])
+            first_guard = guard_slices.get(key, len(guard_rows)) if key else 0
+            if key and key not in guard_slices:
+                guard_slices[key] = first_guard
+                for fact, op, value in key:
+                    guard_rows.append(f"{{FACT_{facts[fact].upper()}, BehaviorMachine::{op}, {value}}},")
+            transition_rows.append(
+                f"{{{first_guard}, {len(key)}, STATE_{states[row['to']]}, {row['hold_ms']}}},  // {name} -> {states[row['to']]}"
+            )
+
+    output_rows: List[str] = []
+    for name in states:
+        values = states_block.get(name) or {}
+        if not isinstance(values, dict):
+            raise ValueError(f"{where}: outputs of state '{name}' must be an object")
+        unknown = [key for key in values if key not in outputs]
+        if unknown:
+            raise ValueError(f"{where}: state '{name}' sets unknown outputs {unknown}")
+        output_rows.append(", ".join(str(int(values.get(key, 0))) for key in outputs) + f",  // {name}")
+
+    namespace = behavior_namespace(component_name)
+    lines: List[str] = [
+        f"// Auto-generated by tools/generate_tables.py from {source} - do not edit",
+        f"// Behavior tables for {component_name}",
+        "#pragma once",
+        "",
+        "#include <cstdint>",
+        '#include "config/components/templates/BehaviorMachine.hpp"',
+        "",
+        f"namespace {namespace} {{",
+        "",
+        "enum State : uint8_t {",
+    ]
+    lines.extend(f"    STATE_{name} = {index}," for index, name in enumerate(states))
+    lines.extend(["    STATE_COUNT", "};", "", "enum Fact : uint8_t {"])
+    lines.extend(f"    FACT_{name.upper()} = {index}," for index, name in enumerate(facts))
+    lines.extend(["    FACT_COUNT", "};", "", "enum Output : uint8_t {"])
+    lines.extend(f"    OUT_{name.upper()} = {index}," for index, name in enumerate(outputs))
+    lines.extend(["    OUTPUT_COUNT", "};", ""])
+
+    def emit_array(declaration: str, rows: List[str], placeholder: str) -> None:
+        lines.append(f"{declaration} = {{")
+        lines.extend(f"    {row}" for row in (rows or [placeholder]))
+        lines.append("};")
+        lines.append("")
+
+    emit_array("static const BehaviorMachine::Guard guards[]", guard_rows, "{0, BehaviorMachine::OP_EQ, 0},  // unused")
+    emit_array("static const BehaviorMachine::Transition transitions[]", transition_rows, "{0, 0, 0, 0},  // unused")
+    emit_array("static const BehaviorMachine::State states[STATE_COUNT]", state_rows, "")
+    emit_array(
+        "static const int16_t outputs[]",
+        output_rows if outputs else [],
+        "0,  // no outputs",
+    )
+    emit_array("static const char* const state_names[STATE_COUNT]", [f'"{name}",' for name in states], "")
+    lines.extend([
+        "static const BehaviorMachine::Table table = {",
+        "    states, transitions, guards, outputs, state_names,",
+        f"    STATE_COUNT, FACT_COUNT, OUTPUT_COUNT, STATE_{initial}",
+        "};",
+        "",
+        f"}}  // namespace {namespace}",
+    ])
+    return "\n".join(lines) + "\n"
+
+
 def render_dispatch_header(context: SubsystemContext) -> str:
     guard = f"{context.identifier.upper()}_DISPATCH_TABLES_HPP"
     lines = [
@@ -815,6 +998,7 @@ def render_dispatch_header(context: SubsystemContext) -> str:
         f"extern const init_function_t {context.identifier}_init_table[];",
         f"extern const act_function_t {context.identifier}_act_table[];",
         f"extern const uint32_t {context.identifier}_hitcount_table[];",
+        f"extern const uint8_t {context.identifier}_stretch_table[];",
         f"extern const std::size_t {context.identifier}_init_table_size;",
         f"extern const std::size_t {context.identifier}_act_table_size;",
         "",
@@ -843,9 +1027,11 @@ def render_dispatch_source(context: SubsystemContext) -> str:
             act_entries.append(f"&{visit.act_func}")
 
     hit_entries = [visit.hit_count for visit in context.visits]
+    stretch_entries = [1 if visit.power_stretch else 0 for visit in context.visits]
     init_body = ",\n    ".join(init_entries)
     act_body = ",\n    ".join(act_entries)
     hit_body = ",\n    ".join(str(entry) for entry in hit_entries)
+    stretch_body = ",\n    ".join(str(entry) for entry in stretch_entries)
     lines.append(f"const init_function_t {context.identifier}_init_table[] = {{")
     if init_body:
         lines.append(f"    {init_body}")
@@ -861,6 +1047,11 @@ def render_dispatch_source(context: SubsystemContext) -> str:
         lines.append(f"    {hit_body}")
     lines.append("};")
     lines.append("")
+    lines.append(f"const uint8_t {context.identifier}_stretch_table[] = {{")
+    if stretch_body:
+        lines.append(f"    {stretch_body}")
+    lines.append("};")
+    lines.append("")
     lines.append(
         f"const std::size_t {context.identifier}_init_table_size = sizeof({context.identifier}_init_table) / sizeof(init_function_t);"
     )
@@ -900,6 +1091,8 @@ def render_main_source(context: SubsystemContext) -> str:
         "#include <cstddef>",
         "#include <cstdint>",
         "",
+        "#include \"shared/PowerState.hpp\"",
+        "",
         f"// Auto-generated subsystem main loop for {context.name}",
         "",
         "uint32_t g_loopCount = 0;",
@@ -911,10 +1104,16 @@ def render_main_source(context: SubsystemContext) -> str:
         "        }",
         "    }",
         "",
+        "    // Power governor policy, published locally or received over ESP-NOW",
+        "    const PowerState* power = GSM.read<PowerState>();",
+        "",
         "    while (true) {",
+        "        const uint32_t stretch = power->period_stretch > 0U ? power->period_stretch : 1U;",
         f"        for (std::size_t i = 0; i < {context.identifier}_act_table_size; ++i) {{",
         f"            const auto func = {context.identifier}_act_table[i];",
-        f"            const auto hit = {context.identifier}_hitcount_table[i];",
+        f"            const uint32_t hit = {context.identifier}_stretch_table[i]",
+        f"                ? {context.identifier}_hitcount_table[i] * stretch",
+        f"                : {context.identifier}_hitcount_table[i];",
         "            if (func && hit > 0U && (g_loopCount % hit) == 0U) {",
         "                func();",
         "            }",
@@ -1176,6 +1375,12 @@ class TableGenerator:
             subsystem_src_dir / f"{context.name}_main.cpp",
             render_main_source(context),
         )
+        for definition in context.unique_components.values():
+            if has_behavior(definition.data):
+                write_text_file(
+                    subsystem_inc_dir / f"{behavior_namespace(definition.name)}.hpp",
+                    render_behavior_header(definition.name, definition.data["behavior"], behavior_source(definition.json_path)),
+                )
 
 
 def resolve_root_config(argument: str) -> Path:
@@ -1212,9 +1417,21 @@ def parse_arguments() -> argparse.Namespace:
         action="store_true",
         help="Disable automatic inclusion of shared/ and shared_headers/ files",
     )
+    parser.add_argument(
+        "--behavior",
+        action="store_true",
+        help="Only compile the \"behavior\" block of a component JSON; output is the header path",
+    )
     return parser.parse_args()
 
 
+def compile_behavior_only(config: Path, output: Path) -> None:
+    data = JsonLoader().load(config)
+    if not has_behavior(data):
+        raise ValueError(f"{config} has no \"behavior\" block")
+    write_text_file(output, render_behavior_header(str(data.get("name", config.stem)), data["behavior"], behavior_source(config)))
+
+
 def main() -> None:
     args = parse_arguments()
     try:
@@ -1225,6 +1442,14 @@ def main() -> None:
     output_dir = Path(args.output)
     if not output_dir.is_absolute():
         output_dir = PROJECT_ROOT / output_dir
+    if args.behavior:
+        try:
+            compile_behavior_only(root_config, output_dir)
+        except Exception as exc:
+            print(f"ERROR: {exc}", file=sys.stderr)
+            sys.exit(1)
+        print(f"Behavior tables written to {output_dir}")
+        return
     output_dir.mkdir(parents=True, exist_ok=True)
     generator = TableGenerator(root_config, output_dir, include_shared=not args.no_shared_includes)
     try: